@@ -29,11 +29,15 @@
 /// \file
 /// 2D array processing utilities.
 
+#include <vector>
+
 #include "../../Primitives/interface/BasicTypes.h"
 
 namespace Diligent
 {
 
+class IThreadPool;
+
 /// Computes the minimum and the maximum value in a 2D floating-point array
 
 /// \param[in]  pData		   - A pointer to the array data.
@@ -49,4 +53,131 @@ void GetArray2DMinMaxValue(const float* pData,
                            float&       MinValue,
                            float&       MaxValue);
 
+/// Computes the minimum and the maximum value in a 2D floating-point array
+/// using the thread pool to process multiple row bands in parallel.
+
+/// \param[in]  pData		   - A pointer to the array data.
+/// \param[in]  StrideInFloats - Row stride in 32-bit floats.
+/// \param[in]  Width		   - 2D array width.
+/// \param[in]  Height		   - 2D array height.
+/// \param[out] MinValue	   - Minimum value.
+/// \param[out] MaxValue	   - Maximum value.
+/// \param[in]  pThreadPool    - Thread pool to use. If null, the array is processed
+///                              on the calling thread.
+///
+/// \remarks   The function waits until all tasks are complete and must not
+///             be called from a worker thread of the same pool.
+void GetArray2DMinMaxValue(const float* pData,
+                           size_t       StrideInFloats,
+                           Uint32       Width,
+                           Uint32       Height,
+                           float&       MinValue,
+                           float&       MaxValue,
+                           IThreadPool* pThreadPool);
+
+/// Computes the sum of all values in a 2D floating-point array
+
+/// \param[in]  pData		   - A pointer to the array data.
+/// \param[in]  StrideInFloats - Row stride in 32-bit floats.
+/// \param[in]  Width		   - 2D array width.
+/// \param[in]  Height		   - 2D array height.
+/// \param[in]  pThreadPool    - Optional thread pool to process multiple row bands in parallel.
+///
+/// \return     The sum of all values.
+///
+/// \remarks   Values in each row are summed in single precision, and row sums
+///             are accumulated in double precision in row order. The result does
+///             not depend on whether the thread pool is used.
+double GetArray2DSum(const float* pData,
+                     size_t       StrideInFloats,
+                     Uint32       Width,
+                     Uint32       Height,
+                     IThreadPool* pThreadPool = nullptr);
+
+/// Computes the histogram of a 2D floating-point array
+
+/// \param[in]  pData		   - A pointer to the array data.
+/// \param[in]  StrideInFloats - Row stride in 32-bit floats.
+/// \param[in]  Width		   - 2D array width.
+/// \param[in]  Height		   - 2D array height.
+/// \param[in]  MinValue	   - The lower bound of the first bin.
+/// \param[in]  MaxValue	   - The upper bound of the last bin. Must be greater than MinValue.
+/// \param[in]  NumBins        - The number of bins.
+/// \param[out] pBins          - A pointer to the array of NumBins counters.
+///                              The counters are overwritten.
+/// \param[in]  pThreadPool    - Optional thread pool to process multiple row bands in parallel.
+///
+/// \remarks   [MinValue, MaxValue] range is split into NumBins equal bins.
+///             Values outside of the range are counted in the first or the last bin.
+///             NaNs are ignored.
+void ComputeArray2DHistogram(const float* pData,
+                             size_t       StrideInFloats,
+                             Uint32       Width,
+                             Uint32       Height,
+                             float        MinValue,
+                             float        MaxValue,
+                             Uint32       NumBins,
+                             Uint64*      pBins,
+                             IThreadPool* pThreadPool = nullptr);
+
+/// Minimum/maximum value pyramid of a 2D floating-point array
+struct Array2DMinMaxPyramid
+{
+    struct Level
+    {
+        /// Level width, in elements.
+        Uint32 Width = 0;
+
+        /// Level height, in elements.
+        Uint32 Height = 0;
+
+        /// Minimum values, Width x Height elements in row-major order.
+        std::vector<float> MinValues;
+
+        /// Maximum values, Width x Height elements in row-major order.
+        std::vector<float> MaxValues;
+
+        float GetMin(Uint32 x, Uint32 y) const
+        {
+            return MinValues[x + size_t{y} * Width];
+        }
+
+        float GetMax(Uint32 x, Uint32 y) const
+        {
+            return MaxValues[x + size_t{y} * Width];
+        }
+    };
+
+    /// The size of the tile covered by one element of the most detailed level.
+    Uint32 TileSize = 0;
+
+    /// Pyramid levels.
+    ///
+    /// \remarks   Level 0 contains minimum and maximum values of TileSize x TileSize
+    ///             tiles of the array. Every next level contains minimum and maximum
+    ///             values of 2x2 blocks of the previous level. The last level is 1x1.
+    ///             Tiles and blocks at the right and bottom edges may be partial.
+    std::vector<Level> Levels;
+};
+
+/// Computes the minimum/maximum value pyramid of a 2D floating-point array, see Diligent::Array2DMinMaxPyramid.
+
+/// \param[in]  pData		   - A pointer to the array data.
+/// \param[in]  StrideInFloats - Row stride in 32-bit floats.
+/// \param[in]  Width		   - 2D array width.
+/// \param[in]  Height		   - 2D array height.
+/// \param[in]  TileSize       - The size of the tile covered by one element of the most detailed level.
+/// \param[in]  pThreadPool    - Optional thread pool to process multiple rows of tiles in parallel.
+///
+/// \return     Min/max pyramid. If the array is empty, the pyramid contains no levels.
+///
+/// \remarks   The pyramid can be used for hierarchical culling, e.g. to compute
+///             the bounding boxes of terrain quad-tree nodes.
+Array2DMinMaxPyramid ComputeArray2DMinMaxPyramid(const float* pData,
+                                                 size_t       StrideInFloats,
+                                                 Uint32       Width,
+                                                 Uint32       Height,
+                                                 Uint32       TileSize,
+                                                 IThreadPool* pThreadPool = nullptr);
+
 } // namespace Diligent
@@ -27,6 +27,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <vector>
+
 #include "../../Platforms/interface/PlatformDefinitions.h"
 
 #include "BasicMath.hpp"
@@ -245,4 +248,204 @@ DstType FilterTexture2DBilinearClampUC(Uint32         Width,
     return FilterTexture2DBilinear<SrcType, DstType, TEXTURE_ADDRESS_CLAMP, TEXTURE_ADDRESS_CLAMP, false>(Width, Height, pData, Stride, u, v);
 }
 
+/// The number of samples that batched bilinear filtering functions process at once.
+static constexpr size_t BilinearFilterBatchSize = 64;
+
+/// Blends Count 4-tap bilinear samples.
+///
+/// \remarks   The blend uses the same expression as FilterTexture2DBilinear. The taps
+///             and weights are stored in separate arrays so that the compiler can
+///             vectorize the loop.
+template <typename DstType>
+void _BlendBilinearSamples(size_t         Count,
+                           const DstType* S00,
+                           const DstType* S10,
+                           const DstType* S01,
+                           const DstType* S11,
+                           const float*   wu,
+                           const float*   wv,
+                           DstType*       pDst)
+{
+    for (size_t i = 0; i < Count; ++i)
+        pDst[i] = lerp(lerp(S00[i], S10[i], wu[i]), lerp(S01[i], S11[i], wu[i]), wv[i]);
+}
+
+/// Samples 2D texture at multiple locations using bilinear filter.
+///
+/// \tparam SrcType           - Source pixel type.
+/// \tparam DstType           - Destination type.
+/// \tparam AddressModeU      - U coordinate address mode.
+/// \tparam AddressModeV      - V coordinate address mode.
+/// \tparam IsNormalizedCoord - Whether sample coordinates are normalized.
+///
+/// \param [in]  Width        - Texture width.
+/// \param [in]  Height       - Texture height.
+/// \param [in]  pData        - Pointer to the texture data.
+/// \param [in]  Stride       - Data stride, in pixels.
+/// \param [in]  NumSamples   - The number of samples.
+/// \param [in]  pU           - Array of NumSamples u coordinates.
+/// \param [in]  pV           - Array of NumSamples v coordinates.
+/// \param [out] pDst         - Array of NumSamples filtered samples.
+///
+/// \remarks   The results are identical to calling FilterTexture2DBilinear for every sample.
+template <typename SrcType,
+          typename DstType,
+          TEXTURE_ADDRESS_MODE AddressModeU,
+          TEXTURE_ADDRESS_MODE AddressModeV,
+          bool                 IsNormalizedCoord>
+void FilterTexture2DBilinear(Uint32         Width,
+                             Uint32         Height,
+                             const SrcType* pData,
+                             size_t         Stride,
+                             size_t         NumSamples,
+                             const float*   pU,
+                             const float*   pV,
+                             DstType*       pDst)
+{
+    DstType S00[BilinearFilterBatchSize];
+    DstType S10[BilinearFilterBatchSize];
+    DstType S01[BilinearFilterBatchSize];
+    DstType S11[BilinearFilterBatchSize];
+    float   wu[BilinearFilterBatchSize];
+    float   wv[BilinearFilterBatchSize];
+
+    for (size_t Start = 0; Start < NumSamples; Start += BilinearFilterBatchSize)
+    {
+        const auto Count = std::min(BilinearFilterBatchSize, NumSamples - Start);
+        for (size_t i = 0; i < Count; ++i)
+        {
+            const auto u = pU[Start + i];
+            const auto v = pV[Start + i];
+
+            const auto UFilterInfo = GetLinearTexFilterSampleInfo<AddressModeU, IsNormalizedCoord>(Width, u);
+            const auto VFilterInfo = GetLinearTexFilterSampleInfo<AddressModeV, IsNormalizedCoord>(Height, v);
+
+#ifdef DILIGENT_DEBUG
+            {
+                _DbgVerifyFilterInfo<AddressModeU>(UFilterInfo, Width, "horizontal", u);
+                _DbgVerifyFilterInfo<AddressModeV>(VFilterInfo, Height, "vertical", v);
+            }
+#endif
+
+            const auto* pRow0 = pData + VFilterInfo.i0 * Stride;
+            const auto* pRow1 = pData + VFilterInfo.i1 * Stride;
+
+            S00[i] = static_cast<DstType>(pRow0[UFilterInfo.i0]);
+            S10[i] = static_cast<DstType>(pRow0[UFilterInfo.i1]);
+            S01[i] = static_cast<DstType>(pRow1[UFilterInfo.i0]);
+            S11[i] = static_cast<DstType>(pRow1[UFilterInfo.i1]);
+            wu[i]  = UFilterInfo.w;
+            wv[i]  = VFilterInfo.w;
+        }
+
+        _BlendBilinearSamples(Count, S00, S10, S01, S11, wu, wv, pDst + Start);
+    }
+}
+
+/// Samples 2D texture on a regular grid using bilinear filter.
+///
+/// \tparam SrcType           - Source pixel type.
+/// \tparam DstType           - Destination type.
+/// \tparam AddressModeU      - U coordinate address mode.
+/// \tparam AddressModeV      - V coordinate address mode.
+/// \tparam IsNormalizedCoord - Whether sample coordinates are normalized.
+///
+/// \param [in]  Width        - Texture width.
+/// \param [in]  Height       - Texture height.
+/// \param [in]  pData        - Pointer to the texture data.
+/// \param [in]  Stride       - Data stride, in pixels.
+/// \param [in]  u0           - U coordinate of the first grid column.
+/// \param [in]  du           - U coordinate step between grid columns.
+/// \param [in]  NumColumns   - The number of grid columns.
+/// \param [in]  v0           - V coordinate of the first grid row.
+/// \param [in]  dv           - V coordinate step between grid rows.
+/// \param [in]  NumRows      - The number of grid rows.
+/// \param [out] pDst         - Pointer to the destination data.
+/// \param [in]  DstStride    - Destination data stride, in elements.
+///
+/// \remarks   The sample at column i and row j uses coordinates (u0 + i * du, v0 + j * dv),
+///             where the indices are converted to float. The result is written to
+///             pDst[i + j * DstStride] and is identical to the result of FilterTexture2DBilinear.
+///             Horizontal filter info is computed once for all rows.
+template <typename SrcType,
+          typename DstType,
+          TEXTURE_ADDRESS_MODE AddressModeU,
+          TEXTURE_ADDRESS_MODE AddressModeV,
+          bool                 IsNormalizedCoord>
+void FilterTexture2DBilinearGrid(Uint32         Width,
+                                 Uint32         Height,
+                                 const SrcType* pData,
+                                 size_t         Stride,
+                                 float          u0,
+                                 float          du,
+                                 Uint32         NumColumns,
+                                 float          v0,
+                                 float          dv,
+                                 Uint32         NumRows,
+                                 DstType*       pDst,
+                                 size_t         DstStride)
+{
+    std::vector<LinearTexFilterSampleInfo> UFilterInfos(NumColumns);
+    for (Uint32 i = 0; i < NumColumns; ++i)
+    {
+        const auto u    = u0 + static_cast<float>(i) * du;
+        UFilterInfos[i] = GetLinearTexFilterSampleInfo<AddressModeU, IsNormalizedCoord>(Width, u);
+#ifdef DILIGENT_DEBUG
+        _DbgVerifyFilterInfo<AddressModeU>(UFilterInfos[i], Width, "horizontal", u);
+#endif
+    }
+
+    DstType S00[BilinearFilterBatchSize];
+    DstType S10[BilinearFilterBatchSize];
+    DstType S01[BilinearFilterBatchSize];
+    DstType S11[BilinearFilterBatchSize];
+    float   wu[BilinearFilterBatchSize];
+    float   wv[BilinearFilterBatchSize];
+
+    for (Uint32 j = 0; j < NumRows; ++j)
+    {
+        const auto v           = v0 + static_cast<float>(j) * dv;
+        const auto VFilterInfo = GetLinearTexFilterSampleInfo<AddressModeV, IsNormalizedCoord>(Height, v);
+#ifdef DILIGENT_DEBUG
+        _DbgVerifyFilterInfo<AddressModeV>(VFilterInfo, Height, "vertical", v);
+#endif
+
+        const auto* pRow0 = pData + VFilterInfo.i0 * Stride;
+        const auto* pRow1 = pData + VFilterInfo.i1 * Stride;
+        std::fill_n(wv, BilinearFilterBatchSize, VFilterInfo.w);
+
+        for (size_t Start = 0; Start < NumColumns; Start += BilinearFilterBatchSize)
+        {
+            const auto Count = std::min(BilinearFilterBatchSize, NumColumns - Start);
+            for (size_t i = 0; i < Count; ++i)
+            {
+                const auto& UFilterInfo = UFilterInfos[Start + i];
+
+                S00[i] = static_cast<DstType>(pRow0[UFilterInfo.i0]);
+                S10[i] = static_cast<DstType>(pRow0[UFilterInfo.i1]);
+                S01[i] = static_cast<DstType>(pRow1[UFilterInfo.i0]);
+                S11[i] = static_cast<DstType>(pRow1[UFilterInfo.i1]);
+                wu[i]  = UFilterInfo.w;
+            }
+
+            _BlendBilinearSamples(Count, S00, S10, S01, S11, wu, wv, pDst + j * DstStride + Start);
+        }
+    }
+}
+
+/// Specialization of batched FilterTexture2DBilinear function that uses CLAMP texture address mode
+/// and takes normalized texture coordinates.
+template <typename SrcType, typename DstType>
+void FilterTexture2DBilinearClamp(Uint32         Width,
+                                  Uint32         Height,
+                                  const SrcType* pData,
+                                  size_t         Stride,
+                                  size_t         NumSamples,
+                                  const float*   pU,
+                                  const float*   pV,
+                                  DstType*       pDst)
+{
+    FilterTexture2DBilinear<SrcType, DstType, TEXTURE_ADDRESS_CLAMP, TEXTURE_ADDRESS_CLAMP, true>(Width, Height, pData, Stride, NumSamples, pU, pV, pDst);
+}
+
 } // namespace Diligent
@@ -0,0 +1,164 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace Threading
+{
+
+#ifdef _MSC_VER
+#    pragma warning(push)
+#    pragma warning(disable : 4324) //  warning C4324: structure was padded due to alignment specifier
+#endif
+
+/// Bounded multi-producer multi-consumer lock-free queue.
+
+/// The queue uses a fixed-size ring of cells, each with its own sequence number
+/// (see https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue).
+/// Enqueue() and Dequeue() never block and never allocate memory: Enqueue() fails when
+/// the queue is full, and Dequeue() fails when it is empty.
+/// T must be default-constructible and move-assignable.
+template <typename T>
+class LockFreeBoundedQueue
+{
+public:
+    /// Capacity is rounded up to the next power of two.
+    explicit LockFreeBoundedQueue(size_t Capacity)
+    {
+        size_t Size = 2;
+        while (Size < Capacity)
+            Size *= 2;
+        m_Mask  = Size - 1;
+        m_Cells = std::make_unique<Cell[]>(Size);
+        for (size_t i = 0; i < Size; ++i)
+            m_Cells[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // clang-format off
+    LockFreeBoundedQueue             (const LockFreeBoundedQueue&)  = delete;
+    LockFreeBoundedQueue& operator = (const LockFreeBoundedQueue&)  = delete;
+    LockFreeBoundedQueue             (      LockFreeBoundedQueue&&) = delete;
+    LockFreeBoundedQueue& operator = (      LockFreeBoundedQueue&&) = delete;
+    // clang-format on
+
+    /// Adds the item to the end of the queue. Returns false if the queue is full.
+    bool Enqueue(T Item) noexcept
+    {
+        Cell*  pCell = nullptr;
+        size_t Pos   = m_EnqueuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            pCell             = &m_Cells[Pos & m_Mask];
+            const size_t Seq  = pCell->Sequence.load(std::memory_order_acquire);
+            const auto   Diff = static_cast<intptr_t>(Seq) - static_cast<intptr_t>(Pos);
+            if (Diff == 0)
+            {
+                // The cell is free - try to claim it
+                if (m_EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (Diff < 0)
+            {
+                // The cell still holds the item from the previous lap: the queue is full
+                return false;
+            }
+            else
+            {
+                // Another producer claimed the cell
+                Pos = m_EnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        pCell->Data = std::move(Item);
+        pCell->Sequence.store(Pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Removes the item from the front of the queue. Returns false if the queue is empty.
+    bool Dequeue(T& Item) noexcept
+    {
+        Cell*  pCell = nullptr;
+        size_t Pos   = m_DequeuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            pCell             = &m_Cells[Pos & m_Mask];
+            const size_t Seq  = pCell->Sequence.load(std::memory_order_acquire);
+            const auto   Diff = static_cast<intptr_t>(Seq) - static_cast<intptr_t>(Pos + 1);
+            if (Diff == 0)
+            {
+                // The cell holds an item - try to claim it
+                if (m_DequeuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (Diff < 0)
+            {
+                // The producer has not filled the cell yet: the queue is empty
+                return false;
+            }
+            else
+            {
+                // Another consumer claimed the cell
+                Pos = m_DequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        Item = std::move(pCell->Data);
+        // Mark the cell as free for the producer on the next lap
+        pCell->Sequence.store(Pos + m_Mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t GetCapacity() const noexcept
+    {
+        return m_Mask + 1;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> Sequence{0};
+        T                   Data{};
+    };
+
+    // Keep producer and consumer positions on separate cache lines
+    static constexpr size_t CacheLineSize = 64;
+
+    std::unique_ptr<Cell[]> m_Cells;
+    size_t                  m_Mask = 0;
+
+    alignas(CacheLineSize) std::atomic<size_t> m_EnqueuePos{0};
+    alignas(CacheLineSize) std::atomic<size_t> m_DequeuePos{0};
+};
+
+#ifdef _MSC_VER
+#    pragma warning(pop)
+#endif
+
+} // namespace Threading
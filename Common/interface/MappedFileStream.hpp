@@ -0,0 +1,200 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+#pragma once
+
+/// \file
+/// Implementation of the MappedDataBlob and MappedFileStream classes
+
+#include <vector>
+
+#include "../../Primitives/interface/FileStream.h"
+#include "../../Primitives/interface/DataBlob.h"
+#include "ObjectBase.hpp"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// File mapping mode
+enum class EFileMapMode
+{
+    /// The file is mapped read-only. Writing to the memory returned by
+    /// GetDataPtr() results in an access violation.
+    ReadOnly,
+
+    /// The file is mapped copy-on-write. Modifications are private to the
+    /// mapping and are never written back to the file.
+    CopyOnWrite
+};
+
+/// Expected access pattern of the mapped memory, see madvise().
+enum class EFileMapAccessHint
+{
+    /// No special treatment.
+    Normal,
+
+    /// Pages will be accessed in sequential order, so they can be aggressively read ahead
+    /// and freed soon after they are accessed.
+    Sequential,
+
+    /// Pages will be accessed in random order, so read-ahead is not useful.
+    Random,
+
+    /// The whole mapping will be needed soon, so the pages should be read ahead.
+    WillNeed
+};
+
+/// Data blob that references the contents of a memory-mapped file.
+
+/// The blob does not copy the file data: pages are loaded on demand by the OS
+/// when they are first accessed, and the mapping is released when the blob is destroyed.
+/// The blob can be used anywhere IDataBlob is accepted, e.g. IDearchiver::LoadArchive(),
+/// IRenderStateCache::Load() or IBytecodeCache::Load().
+///
+/// \remarks    Memory mapping is implemented on Win32 and on POSIX platforms (Linux, Android,
+///             macOS, iOS and tvOS). On other platforms, the file contents are read into memory.
+///             Access hints are only used on POSIX platforms.
+class MappedDataBlob final : public ObjectBase<IDataBlob>
+{
+public:
+    using TBase = ObjectBase<IDataBlob>;
+
+    /// Maps the file into memory.
+
+    /// \param [in] Path - Path to the file.
+    /// \param [in] Mode - File mapping mode, see Diligent::EFileMapMode.
+    /// \param [in] Hint - Expected memory access pattern, see Diligent::EFileMapAccessHint.
+    ///
+    /// \return     Pointer to the new data blob, or null if the file could not be mapped.
+    static RefCntAutoPtr<MappedDataBlob> Create(const Char*        Path,
+                                                EFileMapMode       Mode = EFileMapMode::ReadOnly,
+                                                EFileMapAccessHint Hint = EFileMapAccessHint::Normal);
+
+    ~MappedDataBlob() override;
+
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override;
+
+    /// Sets the size of the data buffer.
+
+    /// \remarks    Shrinking the blob only reduces its reported size. Growing it beyond the
+    ///             size of the mapping copies the data into a memory buffer and releases the mapping.
+    virtual void DILIGENT_CALL_TYPE Resize(size_t NewSize) override;
+
+    /// Returns the size of the data buffer
+    virtual size_t DILIGENT_CALL_TYPE GetSize() const override;
+
+    /// Returns the pointer to the data buffer.
+
+    /// \note   In EFileMapMode::ReadOnly mode, the memory must not be written to.
+    virtual void* DILIGENT_CALL_TYPE GetDataPtr() override;
+
+    /// Returns const pointer to the data buffer
+    virtual const void* DILIGENT_CALL_TYPE GetConstDataPtr() const override;
+
+    /// Gives the OS a hint about the expected access pattern of the given range.
+
+    /// \param [in] Offset - Offset of the range from the beginning of the blob.
+    /// \param [in] Size   - Size of the range.
+    /// \param [in] Hint   - Expected access pattern.
+    void Advise(size_t Offset, size_t Size, EFileMapAccessHint Hint);
+
+    /// Returns true if the data is memory-mapped, and false if it has been copied into memory.
+    bool IsMapped() const { return m_pMapping != nullptr; }
+
+    EFileMapMode GetMode() const { return m_Mode; }
+
+private:
+    template <typename AllocatorType, typename ObjectType>
+    friend class MakeNewRCObj;
+
+    MappedDataBlob(IReferenceCounters* pRefCounters,
+                   const Char*         Path,
+                   EFileMapMode        Mode,
+                   EFileMapAccessHint  Hint) noexcept(false);
+
+    void Unmap();
+
+private:
+    const EFileMapMode m_Mode;
+
+    // Start and size of the memory-mapped region
+    void*  m_pMapping    = nullptr;
+    size_t m_MappingSize = 0;
+
+    // Data that was copied into memory when the blob was resized or when
+    // memory mapping is not available.
+    std::vector<Uint8> m_DataBuff;
+
+    size_t m_Size = 0;
+};
+
+
+/// File stream that reads data from a memory-mapped file.
+
+/// Read() and ReadBlob() copy the data from the mapping. Use GetDataBlob() to
+/// access the file contents without copying.
+class MappedFileStream : public ObjectBase<IFileStream>
+{
+public:
+    using TBase = ObjectBase<IFileStream>;
+
+    MappedFileStream(IReferenceCounters* pRefCounters,
+                     const Char*         Path,
+                     EFileMapMode        Mode = EFileMapMode::ReadOnly,
+                     EFileMapAccessHint  Hint = EFileMapAccessHint::Sequential);
+
+    static RefCntAutoPtr<MappedFileStream> Create(const Char*        Path,
+                                                  EFileMapMode       Mode = EFileMapMode::ReadOnly,
+                                                  EFileMapAccessHint Hint = EFileMapAccessHint::Sequential);
+
+    virtual void DILIGENT_CALL_TYPE QueryInterface(const INTERFACE_ID& IID, IObject** ppInterface) override;
+
+    /// Reads data from the stream
+    virtual void DILIGENT_CALL_TYPE ReadBlob(IDataBlob* pData) override;
+
+    /// Reads data from the stream
+    virtual bool DILIGENT_CALL_TYPE Read(void* Data, size_t Size) override;
+
+    /// Writes data to the stream.
+
+    /// \remarks    Writing is only allowed in EFileMapMode::CopyOnWrite mode and within
+    ///             the size of the file. The changes are never written back to the file.
+    virtual bool DILIGENT_CALL_TYPE Write(const void* Data, size_t Size) override;
+
+    virtual size_t DILIGENT_CALL_TYPE GetSize() override;
+
+    virtual bool DILIGENT_CALL_TYPE IsValid() override;
+
+    /// Returns the data blob that references the whole mapped file.
+    MappedDataBlob* GetDataBlob() { return m_pDataBlob; }
+
+private:
+    RefCntAutoPtr<MappedDataBlob> m_pDataBlob;
+    size_t                        m_CurrentOffset = 0;
+};
+
+} // namespace Diligent
@@ -31,6 +31,7 @@
 
 #include <cstring>
 #include <sstream>
+#include <string>
 
 #include "../../Primitives/interface/BasicTypes.h"
 #include "../../Platforms/Basic/interface/DebugUtilities.hpp"
@@ -67,6 +68,96 @@ inline bool IsStatementSeparator(Char Symbol) noexcept
 }
 
 
+/// Finds the first new line or null character in the given range.
+
+/// \param[in] Start - start of the range.
+/// \param[in] End   - end of the range.
+///
+/// \return    position of the first new line or null character,
+///            or End if there is no such character.
+///
+/// \remarks   The functions that take character pointers process the string in blocks of
+///            16 or 32 characters using SSE2, AVX2 or NEON instructions, when available.
+///            Versions for other iterator types process one character at a time.
+const Char* FindNewLineOrNull(const Char* Start, const Char* End) noexcept;
+
+/// Finds the first character in the given range that is not a delimiter (see IsDelimiter()).
+const Char* FindNonDelimiter(const Char* Start, const Char* End) noexcept;
+
+/// Finds the first character in the given range that can't be part of an identifier,
+/// i.e. the first character that is not a letter, a digit or an underscore.
+const Char* FindNonIdentifierChar(const Char* Start, const Char* End) noexcept;
+
+/// Finds the first occurrence of the symbol or a null character in the given range.
+const Char* FindSymbolOrNull(const Char* Start, const Char* End, Char Symbol) noexcept;
+
+
+template <typename IteratorType>
+IteratorType FindNewLineOrNull(IteratorType Pos, const IteratorType& End) noexcept
+{
+    while (Pos != End && *Pos != '\0' && !IsNewLine(*Pos))
+        ++Pos;
+    return Pos;
+}
+
+template <typename IteratorType>
+IteratorType FindNonDelimiter(IteratorType Pos, const IteratorType& End) noexcept
+{
+    while (Pos != End && IsDelimiter(*Pos))
+        ++Pos;
+    return Pos;
+}
+
+template <typename IteratorType>
+IteratorType FindNonIdentifierChar(IteratorType Pos, const IteratorType& End) noexcept
+{
+    while (Pos != End && (isalnum(static_cast<unsigned char>(*Pos)) || *Pos == '_'))
+        ++Pos;
+    return Pos;
+}
+
+template <typename IteratorType>
+IteratorType FindSymbolOrNull(IteratorType Pos, const IteratorType& End, Char Symbol) noexcept
+{
+    while (Pos != End && *Pos != '\0' && *Pos != Symbol)
+        ++Pos;
+    return Pos;
+}
+
+// std::string iterators are contiguous, so they can use the pointer versions.
+template <typename FindFuncType>
+std::string::const_iterator FindInString(const std::string::const_iterator& Start,
+                                         const std::string::const_iterator& End,
+                                         FindFuncType&&                     Find) noexcept
+{
+    if (Start == End)
+        return Start;
+
+    const Char* const pStart = &*Start;
+    return Start + (Find(pStart, pStart + (End - Start)) - pStart);
+}
+
+inline std::string::const_iterator FindNewLineOrNull(const std::string::const_iterator& Start, const std::string::const_iterator& End) noexcept
+{
+    return FindInString(Start, End, [](const Char* pStart, const Char* pEnd) { return FindNewLineOrNull(pStart, pEnd); });
+}
+
+inline std::string::const_iterator FindNonDelimiter(const std::string::const_iterator& Start, const std::string::const_iterator& End) noexcept
+{
+    return FindInString(Start, End, [](const Char* pStart, const Char* pEnd) { return FindNonDelimiter(pStart, pEnd); });
+}
+
+inline std::string::const_iterator FindNonIdentifierChar(const std::string::const_iterator& Start, const std::string::const_iterator& End) noexcept
+{
+    return FindInString(Start, End, [](const Char* pStart, const Char* pEnd) { return FindNonIdentifierChar(pStart, pEnd); });
+}
+
+inline std::string::const_iterator FindSymbolOrNull(const std::string::const_iterator& Start, const std::string::const_iterator& End, Char Symbol) noexcept
+{
+    return FindInString(Start, End, [Symbol](const Char* pStart, const Char* pEnd) { return FindSymbolOrNull(pStart, pEnd, Symbol); });
+}
+
+
 /// Skips all characters until the end of the line.
 
 /// \param[inout] Pos          - starting position.
@@ -82,9 +173,7 @@ inline bool IsStatementSeparator(Char Symbol) noexcept
 template <typename InteratorType>
 InteratorType SkipLine(const InteratorType& Start, const InteratorType& End, bool GoToNextLine = false) noexcept
 {
-    auto Pos = Start;
-    while (Pos != End && *Pos != '\0' && !IsNewLine(*Pos))
-        ++Pos;
+    auto Pos = FindNewLineOrNull(Start, End);
     if (GoToNextLine && Pos != End && IsNewLine(*Pos))
     {
         ++Pos;
@@ -151,7 +240,8 @@ InteratorType SkipComment(const InteratorType& Start, const InteratorType& End)
         //    ^
         while (Pos != End && *Pos != '\0')
         {
-            if (*Pos == '*')
+            Pos = FindSymbolOrNull(Pos, End, '*');
+            if (Pos != End && *Pos == '*')
             {
                 //  /* Comment */
                 //             ^
@@ -171,10 +261,6 @@ InteratorType SkipComment(const InteratorType& Start, const InteratorType& End)
                     return Pos;
                 }
             }
-            else
-            {
-                ++Pos;
-            }
         }
 
         throw std::pair<InteratorType, const char*>{Start, "Unable to find the end of the multiline comment."};
@@ -192,10 +278,7 @@ InteratorType SkipComment(const InteratorType& Start, const InteratorType& End)
 template <typename InteratorType>
 InteratorType SkipDelimiters(const InteratorType& Start, const InteratorType& End) noexcept
 {
-    auto Pos = Start;
-    while (Pos != End && IsDelimiter(*Pos))
-        ++Pos;
-    return Pos;
+    return FindNonDelimiter(Start, End);
 }
 
 
@@ -241,15 +324,12 @@ IteratorType SkipIdentifier(const IteratorType& Start, const IteratorType& End)
         return Start;
 
     auto Pos = Start;
-    if (isalpha(*Pos) || *Pos == '_')
+    if (isalpha(static_cast<unsigned char>(*Pos)) || *Pos == '_')
         ++Pos;
     else
         return Pos;
 
-    while (Pos != End && (isalnum(*Pos) || *Pos == '_'))
-        ++Pos;
-
-    return Pos;
+    return FindNonIdentifierChar(Pos, End);
 }
 
 
@@ -460,6 +540,8 @@ std::string GetContext(const IteratorType& Start, const IteratorType& End, Itera
 ///                            be created.
 /// \param [in] GetTokenType - a function that should return the token type
 ///                            for the given literal.
+/// \param [in] Tokens       - an empty container to add the tokens to. This allows
+///                            using containers with stateful allocators.
 /// \return     Tokenized representation of the source string
 ///
 /// \remarks    In case of a parsing error, the function throws std::runtime_error.
@@ -471,11 +553,12 @@ template <typename TokenClass,
 ContainerType Tokenize(const IteratorType&   SourceStart,
                        const IteratorType&   SourceEnd,
                        CreateTokenFuncType   CreateToken,
-                       GetTokenTypeFunctType GetTokenType) noexcept(false)
+                       GetTokenTypeFunctType GetTokenType,
+                       ContainerType         Tokens = {}) noexcept(false)
 {
     using TokenType = typename TokenClass::TokenType;
 
-    ContainerType Tokens;
+    VERIFY(Tokens.empty(), "Token container must be empty");
     // Push empty node in the beginning of the list to facilitate
     // backwards searching
     Tokens.emplace_back(TokenClass{});
@@ -645,8 +728,7 @@ ContainerType Tokenize(const IteratorType&   SourceStart,
                     Type = TokenType::StringConstant;
                     ++LiteralStart;
                     ++Pos;
-                    while (Pos != SourceEnd && *Pos != '\0' && *Pos != '"')
-                        ++Pos;
+                    Pos = FindSymbolOrNull(Pos, SourceEnd, '"');
                     if (Pos == SourceEnd || *Pos != '"')
                         throw std::pair<IteratorType, const char*>{LiteralStart - 1, "Unable to find matching closing quotes."};
 
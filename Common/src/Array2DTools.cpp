@@ -27,10 +27,13 @@
 #include "Array2DTools.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <mutex>
 
 #include "Intrinsics.hpp"
 #include "DebugUtilities.hpp"
 #include "Align.hpp"
+#include "ThreadPool.hpp"
 
 namespace Diligent
 {
@@ -73,10 +76,9 @@ bool GetArray2DMinMaxValueAVX2(const float* pData,
     {
         const float* pRowStart = pData + row * StrideInFloats;
         const float* pRowEnd   = pRowStart + Width;
-        const float* pAVXEnd   = pRowEnd - 8;
 
         const float* Ptr = pRowStart;
-        for (; Ptr < pAVXEnd; Ptr += 8)
+        for (; Ptr + 8 <= pRowEnd; Ptr += 8)
         {
             // NOTE: MSVC generates vmovups when using _mm256_load_ps regardless,
             //       so no reason to bother with aligning the pointer.
@@ -125,8 +127,197 @@ bool GetArray2DMinMaxValueAVX2(const float* pData,
 
     return true;
 }
+#elif DILIGENT_SSE2_ENABLED
+bool GetArray2DMinMaxValueSSE2(const float* pData,
+                               size_t       StrideInFloats,
+                               Uint32       Width,
+                               Uint32       Height,
+                               float&       MinValue,
+                               float&       MaxValue)
+{
+    MinValue  = pData[0];
+    MaxValue  = pData[0];
+    auto mMin = _mm_set1_ps(MinValue);
+    auto mMax = _mm_set1_ps(MaxValue);
+    for (size_t row = 0; row < Height; ++row)
+    {
+        const float* pRowStart = pData + row * StrideInFloats;
+        const float* pRowEnd   = pRowStart + Width;
+
+        const float* Ptr = pRowStart;
+        for (; Ptr + 4 <= pRowEnd; Ptr += 4)
+        {
+            auto mVal = _mm_loadu_ps(Ptr);
+
+            mMin = _mm_min_ps(mMin, mVal);
+            mMax = _mm_max_ps(mMax, mVal);
+        }
+
+        for (; Ptr < pRowEnd; ++Ptr)
+        {
+            MinValue = std::min(MinValue, *Ptr);
+            MaxValue = std::max(MaxValue, *Ptr);
+        }
+    }
+
+    // |  A  |  B  |  C  |  D  |   =>  |  B  |  A  |  D  |  C  |
+    mMin = _mm_min_ps(mMin, _mm_shuffle_ps(mMin, mMin, _MM_SHUFFLE(2, 3, 0, 1)));
+    mMax = _mm_max_ps(mMax, _mm_shuffle_ps(mMax, mMax, _MM_SHUFFLE(2, 3, 0, 1)));
+    // | max(A, B) | max(A, B) | max(C, D) | max(C, D) |  =>  | max(C, D) | max(C, D) | max(A, B) | max(A, B) |
+    mMin = _mm_min_ps(mMin, _mm_shuffle_ps(mMin, mMin, _MM_SHUFFLE(1, 0, 3, 2)));
+    mMax = _mm_max_ps(mMax, _mm_shuffle_ps(mMax, mMax, _MM_SHUFFLE(1, 0, 3, 2)));
+
+    MinValue = std::min(_mm_cvtss_f32(mMin), MinValue);
+    MaxValue = std::max(_mm_cvtss_f32(mMax), MaxValue);
+
+    return true;
+}
+#elif DILIGENT_NEON_ENABLED
+bool GetArray2DMinMaxValueNEON(const float* pData,
+                               size_t       StrideInFloats,
+                               Uint32       Width,
+                               Uint32       Height,
+                               float&       MinValue,
+                               float&       MaxValue)
+{
+    MinValue  = pData[0];
+    MaxValue  = pData[0];
+    auto vMin = vdupq_n_f32(MinValue);
+    auto vMax = vdupq_n_f32(MaxValue);
+    for (size_t row = 0; row < Height; ++row)
+    {
+        const float* pRowStart = pData + row * StrideInFloats;
+        const float* pRowEnd   = pRowStart + Width;
+
+        const float* Ptr = pRowStart;
+        for (; Ptr + 4 <= pRowEnd; Ptr += 4)
+        {
+            auto vVal = vld1q_f32(Ptr);
+
+            vMin = vminq_f32(vMin, vVal);
+            vMax = vmaxq_f32(vMax, vVal);
+        }
+
+        for (; Ptr < pRowEnd; ++Ptr)
+        {
+            MinValue = std::min(MinValue, *Ptr);
+            MaxValue = std::max(MaxValue, *Ptr);
+        }
+    }
+
+    MinValue = std::min(vminvq_f32(vMin), MinValue);
+    MaxValue = std::max(vmaxvq_f32(vMax), MaxValue);
+
+    return true;
+}
+#endif
+
+void GetArray2DMinMaxValueInternal(const float* pData,
+                                   size_t       StrideInFloats,
+                                   Uint32       Width,
+                                   Uint32       Height,
+                                   float&       MinValue,
+                                   float&       MaxValue)
+{
+    MinValue = MaxValue = pData[0];
+#if DILIGENT_AVX2_ENABLED
+    if (GetArray2DMinMaxValueAVX2(pData, StrideInFloats, Width, Height, MinValue, MaxValue))
+        return;
+#elif DILIGENT_SSE2_ENABLED
+    if (GetArray2DMinMaxValueSSE2(pData, StrideInFloats, Width, Height, MinValue, MaxValue))
+        return;
+#elif DILIGENT_NEON_ENABLED
+    if (GetArray2DMinMaxValueNEON(pData, StrideInFloats, Width, Height, MinValue, MaxValue))
+        return;
+#endif
+
+    GetArray2DMinMaxValueGeneric(pData, StrideInFloats, Width, Height, MinValue, MaxValue);
+}
+
+float GetRowSum(const float* pRow, Uint32 Width)
+{
+    const float* Ptr     = pRow;
+    const float* pRowEnd = pRow + Width;
+
+    float Sum = 0;
+#if DILIGENT_AVX2_ENABLED
+    auto mmSum = _mm256_setzero_ps();
+    for (; Ptr + 8 <= pRowEnd; Ptr += 8)
+        mmSum = _mm256_add_ps(mmSum, _mm256_loadu_ps(Ptr));
+
+    auto mSum = _mm_add_ps(_mm256_castps256_ps128(mmSum), _mm256_extractf128_ps(mmSum, 1));
+    mSum      = _mm_add_ps(mSum, _mm_movehl_ps(mSum, mSum));
+    mSum      = _mm_add_ss(mSum, _mm_shuffle_ps(mSum, mSum, _MM_SHUFFLE(1, 1, 1, 1)));
+    Sum       = _mm_cvtss_f32(mSum);
+#elif DILIGENT_SSE2_ENABLED
+    auto mSum = _mm_setzero_ps();
+    for (; Ptr + 4 <= pRowEnd; Ptr += 4)
+        mSum = _mm_add_ps(mSum, _mm_loadu_ps(Ptr));
+
+    mSum = _mm_add_ps(mSum, _mm_movehl_ps(mSum, mSum));
+    mSum = _mm_add_ss(mSum, _mm_shuffle_ps(mSum, mSum, _MM_SHUFFLE(1, 1, 1, 1)));
+    Sum  = _mm_cvtss_f32(mSum);
+#elif DILIGENT_NEON_ENABLED
+    auto vSum = vdupq_n_f32(0);
+    for (; Ptr + 4 <= pRowEnd; Ptr += 4)
+        vSum = vaddq_f32(vSum, vld1q_f32(Ptr));
+
+    Sum = vaddvq_f32(vSum);
 #endif
 
+    for (; Ptr < pRowEnd; ++Ptr)
+        Sum += *Ptr;
+
+    return Sum;
+}
+
+// Rows are processed in bands of at least this many elements
+// to amortize the cost of enqueuing a task.
+constexpr size_t MinElementsPerBand = size_t{1} << 18;
+
+Uint32 GetRowsPerBand(Uint32 Width)
+{
+    return static_cast<Uint32>(std::max(MinElementsPerBand / Width, size_t{1}));
+}
+
+// Calls Handler(BandIdx, FirstRow, NumRows) for every band of RowsPerBand rows,
+// in parallel if the thread pool is not null.
+template <typename HandlerType>
+void ProcessRowBands(IThreadPool* pThreadPool, Uint32 Height, Uint32 RowsPerBand, const HandlerType& Handler)
+{
+    const Uint32 NumBands = (Height + RowsPerBand - 1) / RowsPerBand;
+    if (pThreadPool == nullptr || NumBands == 1)
+    {
+        for (Uint32 Band = 0; Band < NumBands; ++Band)
+            Handler(Band, Band * RowsPerBand, std::min(RowsPerBand, Height - Band * RowsPerBand));
+        return;
+    }
+
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    Tasks.reserve(NumBands);
+    for (Uint32 Band = 0; Band < NumBands; ++Band)
+    {
+        Tasks.emplace_back(EnqueueAsyncWork(pThreadPool,
+                                            [&Handler, Band, Height, RowsPerBand](Uint32) //
+                                            {
+                                                Handler(Band, Band * RowsPerBand, std::min(RowsPerBand, Height - Band * RowsPerBand));
+                                            }));
+    }
+
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+}
+
+void ValidateArray2D(const float* pData,
+                     size_t       StrideInFloats,
+                     Uint32       Width,
+                     Uint32       Height)
+{
+    DEV_CHECK_ERR(pData != nullptr, "Data pointer must not be null");
+    DEV_CHECK_ERR(Height == 1 || StrideInFloats >= Width, "Row stride (", StrideInFloats, ") must be at least ", Width);
+    DEV_CHECK_ERR(AlignDown(pData, alignof(float)) == pData, "Data pointer is not naturally aligned");
+}
+
 } // namespace
 
 void GetArray2DMinMaxValue(const float* pData,
@@ -139,17 +330,186 @@ void GetArray2DMinMaxValue(const float* pData,
     if (Width == 0 || Height == 0)
         return;
 
-    DEV_CHECK_ERR(pData != nullptr, "Data pointer must not be null");
-    DEV_CHECK_ERR(Height == 1 || StrideInFloats >= Width, "Row stride (", StrideInFloats, ") must be at least ", Width);
-    DEV_CHECK_ERR(AlignDown(pData, alignof(float)) == pData, "Data pointer is not naturally aligned");
+    ValidateArray2D(pData, StrideInFloats, Width, Height);
 
-    MinValue = MaxValue = pData[0];
-#if DILIGENT_AVX2_ENABLED
-    if (GetArray2DMinMaxValueAVX2(pData, StrideInFloats, Width, Height, MinValue, MaxValue))
+    GetArray2DMinMaxValueInternal(pData, StrideInFloats, Width, Height, MinValue, MaxValue);
+}
+
+void GetArray2DMinMaxValue(const float* pData,
+                           size_t       StrideInFloats,
+                           Uint32       Width,
+                           Uint32       Height,
+                           float&       MinValue,
+                           float&       MaxValue,
+                           IThreadPool* pThreadPool)
+{
+    if (Width == 0 || Height == 0)
         return;
-#endif
 
-    GetArray2DMinMaxValueGeneric(pData, StrideInFloats, Width, Height, MinValue, MaxValue);
+    ValidateArray2D(pData, StrideInFloats, Width, Height);
+
+    const auto RowsPerBand = GetRowsPerBand(Width);
+
+    std::vector<float> BandMinMax(size_t{(Height + RowsPerBand - 1) / RowsPerBand} * 2);
+    ProcessRowBands(pThreadPool, Height, RowsPerBand,
+                    [&](Uint32 Band, Uint32 FirstRow, Uint32 NumRows) //
+                    {
+                        GetArray2DMinMaxValueInternal(pData + FirstRow * StrideInFloats, StrideInFloats, Width, NumRows,
+                                                      BandMinMax[Band * 2 + 0], BandMinMax[Band * 2 + 1]);
+                    });
+
+    MinValue = BandMinMax[0];
+    MaxValue = BandMinMax[1];
+    for (size_t Band = 1; Band < BandMinMax.size() / 2; ++Band)
+    {
+        MinValue = std::min(MinValue, BandMinMax[Band * 2 + 0]);
+        MaxValue = std::max(MaxValue, BandMinMax[Band * 2 + 1]);
+    }
+}
+
+double GetArray2DSum(const float* pData,
+                     size_t       StrideInFloats,
+                     Uint32       Width,
+                     Uint32       Height,
+                     IThreadPool* pThreadPool)
+{
+    if (Width == 0 || Height == 0)
+        return 0;
+
+    ValidateArray2D(pData, StrideInFloats, Width, Height);
+
+    std::vector<float> RowSums(Height);
+    ProcessRowBands(pThreadPool, Height, GetRowsPerBand(Width),
+                    [&](Uint32, Uint32 FirstRow, Uint32 NumRows) //
+                    {
+                        for (Uint32 row = FirstRow; row < FirstRow + NumRows; ++row)
+                            RowSums[row] = GetRowSum(pData + row * StrideInFloats, Width);
+                    });
+
+    double Sum = 0;
+    for (auto RowSum : RowSums)
+        Sum += RowSum;
+
+    return Sum;
+}
+
+void ComputeArray2DHistogram(const float* pData,
+                             size_t       StrideInFloats,
+                             Uint32       Width,
+                             Uint32       Height,
+                             float        MinValue,
+                             float        MaxValue,
+                             Uint32       NumBins,
+                             Uint64*      pBins,
+                             IThreadPool* pThreadPool)
+{
+    DEV_CHECK_ERR(NumBins > 0, "The number of bins must not be zero");
+    DEV_CHECK_ERR(pBins != nullptr, "Bins pointer must not be null");
+    DEV_CHECK_ERR(MaxValue > MinValue, "Max value (", MaxValue, ") must be greater than min value (", MinValue, ")");
+
+    std::fill(pBins, pBins + NumBins, Uint64{0});
+    if (Width == 0 || Height == 0)
+        return;
+
+    ValidateArray2D(pData, StrideInFloats, Width, Height);
+
+    const float BinScale = static_cast<float>(NumBins) / (MaxValue - MinValue);
+    const float fNumBins = static_cast<float>(NumBins);
+
+    std::mutex BinsMtx;
+    ProcessRowBands(pThreadPool, Height, GetRowsPerBand(Width),
+                    [&](Uint32, Uint32 FirstRow, Uint32 NumRows) //
+                    {
+                        std::vector<Uint64> BandBins(NumBins);
+                        for (Uint32 row = FirstRow; row < FirstRow + NumRows; ++row)
+                        {
+                            const float* pRowStart = pData + row * StrideInFloats;
+                            const float* pRowEnd   = pRowStart + Width;
+                            for (const auto* Ptr = pRowStart; Ptr < pRowEnd; ++Ptr)
+                            {
+                                if (std::isnan(*Ptr))
+                                    continue;
+
+                                const float  fBin = (*Ptr - MinValue) * BinScale;
+                                const Uint32 Bin  = fBin > 0 ? (fBin < fNumBins ? static_cast<Uint32>(fBin) : NumBins - 1) : 0;
+                                ++BandBins[std::min(Bin, NumBins - 1)];
+                            }
+                        }
+
+                        std::lock_guard<std::mutex> Lock{BinsMtx};
+                        for (Uint32 i = 0; i < NumBins; ++i)
+                            pBins[i] += BandBins[i];
+                    });
+}
+
+Array2DMinMaxPyramid ComputeArray2DMinMaxPyramid(const float* pData,
+                                                 size_t       StrideInFloats,
+                                                 Uint32       Width,
+                                                 Uint32       Height,
+                                                 Uint32       TileSize,
+                                                 IThreadPool* pThreadPool)
+{
+    DEV_CHECK_ERR(TileSize > 0, "Tile size must not be zero");
+
+    Array2DMinMaxPyramid Pyramid;
+    Pyramid.TileSize = TileSize;
+    if (Width == 0 || Height == 0)
+        return Pyramid;
+
+    ValidateArray2D(pData, StrideInFloats, Width, Height);
+
+    auto InitLevel = [](Array2DMinMaxPyramid::Level& Level, Uint32 LevelWidth, Uint32 LevelHeight) {
+        Level.Width  = LevelWidth;
+        Level.Height = LevelHeight;
+        Level.MinValues.resize(size_t{LevelWidth} * LevelHeight);
+        Level.MaxValues.resize(size_t{LevelWidth} * LevelHeight);
+    };
+
+    {
+        Pyramid.Levels.emplace_back();
+        auto& Level0 = Pyramid.Levels.back();
+        InitLevel(Level0, (Width + TileSize - 1) / TileSize, (Height + TileSize - 1) / TileSize);
+
+        // Every band is one row of tiles
+        ProcessRowBands(pThreadPool, Height, TileSize,
+                        [&](Uint32 ty, Uint32 FirstRow, Uint32 NumRows) //
+                        {
+                            for (Uint32 tx = 0; tx < Level0.Width; ++tx)
+                            {
+                                const auto FirstCol = tx * TileSize;
+                                const auto Idx      = tx + size_t{ty} * Level0.Width;
+                                GetArray2DMinMaxValueInternal(pData + FirstRow * StrideInFloats + FirstCol, StrideInFloats,
+                                                              std::min(TileSize, Width - FirstCol), NumRows,
+                                                              Level0.MinValues[Idx], Level0.MaxValues[Idx]);
+                            }
+                        });
+    }
+
+    while (Pyramid.Levels.back().Width > 1 || Pyramid.Levels.back().Height > 1)
+    {
+        Pyramid.Levels.emplace_back();
+        const auto& Fine   = Pyramid.Levels[Pyramid.Levels.size() - 2];
+        auto&       Coarse = Pyramid.Levels.back();
+        InitLevel(Coarse, (Fine.Width + 1) / 2, (Fine.Height + 1) / 2);
+
+        for (Uint32 y = 0; y < Coarse.Height; ++y)
+        {
+            const auto y0 = y * 2;
+            const auto y1 = std::min(y0 + 1, Fine.Height - 1);
+            for (Uint32 x = 0; x < Coarse.Width; ++x)
+            {
+                const auto x0 = x * 2;
+                const auto x1 = std::min(x0 + 1, Fine.Width - 1);
+
+                const auto Idx = x + size_t{y} * Coarse.Width;
+
+                Coarse.MinValues[Idx] = std::min(std::min(Fine.GetMin(x0, y0), Fine.GetMin(x1, y0)), std::min(Fine.GetMin(x0, y1), Fine.GetMin(x1, y1)));
+                Coarse.MaxValues[Idx] = std::max(std::max(Fine.GetMax(x0, y0), Fine.GetMax(x1, y0)), std::max(Fine.GetMax(x0, y1), Fine.GetMax(x1, y1)));
+            }
+        }
+    }
+
+    return Pyramid;
 }
 
 } // namespace Diligent
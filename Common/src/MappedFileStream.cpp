@@ -0,0 +1,353 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include "MappedFileStream.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if PLATFORM_LINUX || PLATFORM_ANDROID || PLATFORM_MACOS || PLATFORM_IOS || PLATFORM_TVOS
+#    define FILE_MAPPING_POSIX 1
+#elif PLATFORM_WIN32
+#    define FILE_MAPPING_WIN32 1
+#endif
+
+#if FILE_MAPPING_POSIX
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#elif FILE_MAPPING_WIN32
+#    include "WinHPreface.h"
+#    include <Windows.h>
+#    include "WinHPostface.h"
+#    include "StringTools.hpp"
+#endif
+
+namespace Diligent
+{
+
+#if FILE_MAPPING_POSIX
+static int FileMapAccessHintToMAdvice(EFileMapAccessHint Hint)
+{
+    switch (Hint)
+    {
+        // clang-format off
+        case EFileMapAccessHint::Normal:     return MADV_NORMAL;
+        case EFileMapAccessHint::Sequential: return MADV_SEQUENTIAL;
+        case EFileMapAccessHint::Random:     return MADV_RANDOM;
+        case EFileMapAccessHint::WillNeed:   return MADV_WILLNEED;
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected file map access hint");
+            return MADV_NORMAL;
+    }
+}
+#endif
+
+RefCntAutoPtr<MappedDataBlob> MappedDataBlob::Create(const Char*        Path,
+                                                     EFileMapMode       Mode,
+                                                     EFileMapAccessHint Hint)
+{
+    try
+    {
+        return RefCntAutoPtr<MappedDataBlob>{MakeNewRCObj<MappedDataBlob>()(Path, Mode, Hint)};
+    }
+    catch (const std::runtime_error&)
+    {
+        return {};
+    }
+}
+
+MappedDataBlob::MappedDataBlob(IReferenceCounters* pRefCounters,
+                               const Char*         Path,
+                               EFileMapMode        Mode,
+                               EFileMapAccessHint  Hint) noexcept(false) :
+    TBase{pRefCounters},
+    m_Mode{Mode}
+{
+    if (Path == nullptr)
+        LOG_ERROR_AND_THROW("File path must not be null");
+
+    String CorrectedPath{Path};
+    FileSystem::CorrectSlashes(CorrectedPath);
+
+#if FILE_MAPPING_POSIX
+    const auto fd = open(CorrectedPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        LOG_ERROR_AND_THROW("Failed to open file ", CorrectedPath, "\nThe following error occurred: ", strerror(errno));
+
+    struct stat FileStat;
+    if (fstat(fd, &FileStat) != 0)
+    {
+        const auto Error = errno;
+        close(fd);
+        LOG_ERROR_AND_THROW("Failed to get the size of file ", CorrectedPath, "\nThe following error occurred: ", strerror(Error));
+    }
+
+    const auto FileSize = static_cast<size_t>(FileStat.st_size);
+    // Empty files can't be mapped
+    if (FileSize > 0)
+    {
+        // Copy-on-write mappings are private and writable. Read-only mappings are also private
+        // so that they are not affected by other processes that may have the file mapped shared.
+        const int Prot     = Mode == EFileMapMode::CopyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        void*     pMapping = mmap(nullptr, FileSize, Prot, MAP_PRIVATE, fd, 0);
+        if (pMapping == MAP_FAILED)
+        {
+            const auto Error = errno;
+            close(fd);
+            LOG_ERROR_AND_THROW("Failed to map file ", CorrectedPath, "\nThe following error occurred: ", strerror(Error));
+        }
+
+        m_pMapping    = pMapping;
+        m_MappingSize = FileSize;
+        m_Size        = FileSize;
+    }
+
+    // The mapping remains valid after the file descriptor is closed
+    close(fd);
+
+    if (Hint != EFileMapAccessHint::Normal)
+        Advise(0, m_Size, Hint);
+#elif FILE_MAPPING_WIN32
+    (void)Hint;
+
+    const auto hFile = CreateFileW(WidenString(CorrectedPath).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        LOG_ERROR_AND_THROW("Failed to open file ", CorrectedPath, "\nThe following error occurred: ", GetLastError());
+
+    LARGE_INTEGER FileSize{};
+    if (!GetFileSizeEx(hFile, &FileSize))
+    {
+        const auto Error = GetLastError();
+        CloseHandle(hFile);
+        LOG_ERROR_AND_THROW("Failed to get the size of file ", CorrectedPath, "\nThe following error occurred: ", Error);
+    }
+
+    // Empty files can't be mapped
+    if (FileSize.QuadPart > 0)
+    {
+        // PAGE_WRITECOPY and FILE_MAP_COPY create a private copy-on-write view
+        const auto hMapping = CreateFileMappingW(hFile, nullptr, Mode == EFileMapMode::CopyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+        if (hMapping == nullptr)
+        {
+            const auto Error = GetLastError();
+            CloseHandle(hFile);
+            LOG_ERROR_AND_THROW("Failed to create file mapping for ", CorrectedPath, "\nThe following error occurred: ", Error);
+        }
+
+        void*      pMapping = MapViewOfFile(hMapping, Mode == EFileMapMode::CopyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+        const auto Error    = GetLastError();
+
+        // The view remains valid after the mapping and file handles are closed
+        CloseHandle(hMapping);
+        if (pMapping == nullptr)
+        {
+            CloseHandle(hFile);
+            LOG_ERROR_AND_THROW("Failed to map file ", CorrectedPath, "\nThe following error occurred: ", Error);
+        }
+
+        m_pMapping    = pMapping;
+        m_MappingSize = static_cast<size_t>(FileSize.QuadPart);
+        m_Size        = m_MappingSize;
+    }
+
+    CloseHandle(hFile);
+#else
+    (void)Hint;
+    if (!FileWrapper::ReadWholeFile(CorrectedPath.c_str(), m_DataBuff))
+        LOG_ERROR_AND_THROW("Failed to read file ", CorrectedPath);
+    m_Size = m_DataBuff.size();
+#endif
+}
+
+MappedDataBlob::~MappedDataBlob()
+{
+    Unmap();
+}
+
+IMPLEMENT_QUERY_INTERFACE(MappedDataBlob, IID_DataBlob, TBase)
+
+void MappedDataBlob::Unmap()
+{
+    if (m_pMapping != nullptr)
+    {
+#if FILE_MAPPING_POSIX
+        if (munmap(m_pMapping, m_MappingSize) != 0)
+            LOG_ERROR_MESSAGE("Failed to unmap file: ", strerror(errno));
+#elif FILE_MAPPING_WIN32
+        if (!UnmapViewOfFile(m_pMapping))
+            LOG_ERROR_MESSAGE("Failed to unmap file: ", GetLastError());
+#endif
+    }
+    m_pMapping    = nullptr;
+    m_MappingSize = 0;
+}
+
+void MappedDataBlob::Resize(size_t NewSize)
+{
+    if (m_pMapping != nullptr)
+    {
+        if (NewSize <= m_MappingSize)
+        {
+            m_Size = NewSize;
+            return;
+        }
+
+        // The mapping can't grow - copy the data into the memory buffer
+        m_DataBuff.assign(static_cast<const Uint8*>(m_pMapping), static_cast<const Uint8*>(m_pMapping) + m_Size);
+        Unmap();
+    }
+
+    m_DataBuff.resize(NewSize);
+    m_Size = NewSize;
+}
+
+size_t MappedDataBlob::GetSize() const
+{
+    return m_Size;
+}
+
+void* MappedDataBlob::GetDataPtr()
+{
+    return m_pMapping != nullptr ? m_pMapping : m_DataBuff.data();
+}
+
+const void* MappedDataBlob::GetConstDataPtr() const
+{
+    return m_pMapping != nullptr ? m_pMapping : m_DataBuff.data();
+}
+
+void MappedDataBlob::Advise(size_t Offset, size_t Size, EFileMapAccessHint Hint)
+{
+    DEV_CHECK_ERR(Offset + Size <= m_Size, "The range [", Offset, ", ", Offset + Size, ") is out of the blob bounds (", m_Size, ")");
+#if FILE_MAPPING_POSIX
+    if (m_pMapping == nullptr || Size == 0)
+        return;
+
+    // madvise requires the start address to be page-aligned
+    const auto PageSize      = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const auto AlignedOffset = Offset - Offset % PageSize;
+    if (madvise(static_cast<Uint8*>(m_pMapping) + AlignedOffset, Size + (Offset - AlignedOffset), FileMapAccessHintToMAdvice(Hint)) != 0)
+        LOG_WARNING_MESSAGE("madvise failed: ", strerror(errno));
+#else
+    (void)Offset;
+    (void)Size;
+    (void)Hint;
+#endif
+}
+
+
+RefCntAutoPtr<MappedFileStream> MappedFileStream::Create(const Char*        Path,
+                                                         EFileMapMode       Mode,
+                                                         EFileMapAccessHint Hint)
+{
+    return RefCntAutoPtr<MappedFileStream>{MakeNewRCObj<MappedFileStream>()(Path, Mode, Hint)};
+}
+
+MappedFileStream::MappedFileStream(IReferenceCounters* pRefCounters,
+                                   const Char*         Path,
+                                   EFileMapMode        Mode,
+                                   EFileMapAccessHint  Hint) :
+    TBase{pRefCounters},
+    m_pDataBlob{MappedDataBlob::Create(Path, Mode, Hint)}
+{
+}
+
+IMPLEMENT_QUERY_INTERFACE(MappedFileStream, IID_FileStream, TBase)
+
+bool MappedFileStream::Read(void* Data, size_t Size)
+{
+    if (!m_pDataBlob)
+        return false;
+
+    VERIFY_EXPR(m_CurrentOffset <= m_pDataBlob->GetSize());
+    const auto BytesLeft   = m_pDataBlob->GetSize() - m_CurrentOffset;
+    const auto BytesToRead = std::min(BytesLeft, Size);
+    if (BytesToRead > 0)
+    {
+        const auto* pSrcData = static_cast<const Uint8*>(m_pDataBlob->GetConstDataPtr()) + m_CurrentOffset;
+        memcpy(Data, pSrcData, BytesToRead);
+        m_CurrentOffset += BytesToRead;
+    }
+    return Size == BytesToRead;
+}
+
+void MappedFileStream::ReadBlob(IDataBlob* pData)
+{
+    VERIFY_EXPR(pData != nullptr);
+    if (!m_pDataBlob)
+        return;
+
+    const auto BytesLeft = m_pDataBlob->GetSize() - m_CurrentOffset;
+    pData->Resize(BytesLeft);
+    auto res = Read(pData->GetDataPtr(), pData->GetSize());
+    VERIFY_EXPR(res);
+    (void)res;
+}
+
+bool MappedFileStream::Write(const void* Data, size_t Size)
+{
+    if (!m_pDataBlob)
+        return false;
+
+    if (m_pDataBlob->GetMode() != EFileMapMode::CopyOnWrite)
+    {
+        LOG_ERROR_MESSAGE("Writing to a read-only mapped file stream is not allowed");
+        return false;
+    }
+
+    if (m_CurrentOffset + Size > m_pDataBlob->GetSize())
+    {
+        LOG_ERROR_MESSAGE("Writing past the end of a mapped file stream is not allowed");
+        return false;
+    }
+
+    if (Size > 0)
+    {
+        auto* pDstData = static_cast<Uint8*>(m_pDataBlob->GetDataPtr()) + m_CurrentOffset;
+        memcpy(pDstData, Data, Size);
+        m_CurrentOffset += Size;
+    }
+    return true;
+}
+
+size_t MappedFileStream::GetSize()
+{
+    return m_pDataBlob ? m_pDataBlob->GetSize() : 0;
+}
+
+bool MappedFileStream::IsValid()
+{
+    return !!m_pDataBlob;
+}
+
+} // namespace Diligent
@@ -0,0 +1,204 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+
+#include "ParsingTools.hpp"
+
+#include <cctype>
+
+#include "Intrinsics.hpp"
+#include "PlatformMisc.hpp"
+
+namespace Diligent
+{
+
+namespace Parsing
+{
+
+namespace
+{
+
+// Each scanning function below returns the first position in [Pos, End) where
+// IsStop returns true, or End if there is no such position. The vectorized versions
+// process the bulk of the range in 16 or 32-byte blocks and use the scalar predicate
+// for the remaining characters.
+
+template <typename ScalarPredicateType>
+const Char* ScanGeneric(const Char* Pos, const Char* End, ScalarPredicateType IsStop)
+{
+    while (Pos != End && !IsStop(*Pos))
+        ++Pos;
+    return Pos;
+}
+
+#if DILIGENT_AVX2_ENABLED
+template <typename VectorPredicateType, typename ScalarPredicateType>
+const Char* ScanAVX2(const Char* Pos, const Char* End, VectorPredicateType GetStopMask, ScalarPredicateType IsStop)
+{
+    for (; End - Pos >= 32; Pos += 32)
+    {
+        const auto mmChars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Pos));
+        // One bit for every character, 1 if the character is a stop character
+        const auto StopBits = static_cast<Uint32>(_mm256_movemask_epi8(GetStopMask(mmChars)));
+        if (StopBits != 0)
+            return Pos + PlatformMisc::GetLSB(StopBits);
+    }
+
+    return ScanGeneric(Pos, End, IsStop);
+}
+
+#    define SET1(c)    _mm256_set1_epi8(c)
+#    define EQ(a, b)   _mm256_cmpeq_epi8(a, b)
+#    define GT(a, b)   _mm256_cmpgt_epi8(a, b)
+#    define OR(a, b)   _mm256_or_si256(a, b)
+#    define AND(a, b)  _mm256_and_si256(a, b)
+#    define ZERO()     _mm256_setzero_si256()
+#    define SCAN       ScanAVX2
+#elif DILIGENT_SSE2_ENABLED
+template <typename VectorPredicateType, typename ScalarPredicateType>
+const Char* ScanSSE2(const Char* Pos, const Char* End, VectorPredicateType GetStopMask, ScalarPredicateType IsStop)
+{
+    for (; End - Pos >= 16; Pos += 16)
+    {
+        const auto mChars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Pos));
+        // One bit for every character, 1 if the character is a stop character
+        const auto StopBits = static_cast<Uint32>(_mm_movemask_epi8(GetStopMask(mChars)));
+        if (StopBits != 0)
+            return Pos + PlatformMisc::GetLSB(StopBits);
+    }
+
+    return ScanGeneric(Pos, End, IsStop);
+}
+
+#    define SET1(c)    _mm_set1_epi8(c)
+#    define EQ(a, b)   _mm_cmpeq_epi8(a, b)
+#    define GT(a, b)   _mm_cmpgt_epi8(a, b)
+#    define OR(a, b)   _mm_or_si128(a, b)
+#    define AND(a, b)  _mm_and_si128(a, b)
+#    define ZERO()     _mm_setzero_si128()
+#    define SCAN       ScanSSE2
+#elif DILIGENT_NEON_ENABLED
+template <typename VectorPredicateType, typename ScalarPredicateType>
+const Char* ScanNEON(const Char* Pos, const Char* End, VectorPredicateType GetStopMask, ScalarPredicateType IsStop)
+{
+    for (; End - Pos >= 16; Pos += 16)
+    {
+        const auto Chars = vld1q_s8(reinterpret_cast<const int8_t*>(Pos));
+        // NEON has no movemask instruction. Narrowing shift packs the 16-byte mask
+        // into 64 bits, 4 bits per character.
+        const auto Mask     = vreinterpretq_u16_s8(GetStopMask(Chars));
+        const auto StopBits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(Mask, 4)), 0);
+        if (StopBits != 0)
+            return Pos + PlatformMisc::GetLSB(static_cast<Uint64>(StopBits)) / 4;
+    }
+
+    return ScanGeneric(Pos, End, IsStop);
+}
+
+#    define SET1(c)    vdupq_n_s8(c)
+#    define EQ(a, b)   vreinterpretq_s8_u8(vceqq_s8(a, b))
+#    define GT(a, b)   vreinterpretq_s8_u8(vcgtq_s8(a, b))
+#    define OR(a, b)   vorrq_s8(a, b)
+#    define AND(a, b)  vandq_s8(a, b)
+#    define ZERO()     vdupq_n_s8(0)
+#    define SCAN       ScanNEON
+#endif
+
+} // namespace
+
+// Note that all comparisons below are signed. Characters outside of the ASCII range are
+// negative and are never identifier characters or delimiters, which matches the behavior
+// of the scalar functions in the "C" locale.
+
+const Char* FindNewLineOrNull(const Char* Start, const Char* End) noexcept
+{
+    const auto IsStop = [](Char c) { return c == '\0' || IsNewLine(c); };
+#ifdef SCAN
+    return SCAN(
+        Start, End, [](const auto& v) { return OR(OR(EQ(v, SET1('\n')), EQ(v, SET1('\r'))), EQ(v, ZERO())); }, IsStop);
+#else
+    return ScanGeneric(Start, End, IsStop);
+#endif
+}
+
+const Char* FindNonDelimiter(const Char* Start, const Char* End) noexcept
+{
+    const auto IsStop = [](Char c) { return !IsDelimiter(c); };
+#ifdef SCAN
+    return SCAN(
+        Start, End,
+        [](const auto& v) {
+            const auto IsDelim = OR(OR(EQ(v, SET1(' ')), EQ(v, SET1('\t'))), OR(EQ(v, SET1('\r')), EQ(v, SET1('\n'))));
+            return EQ(IsDelim, ZERO());
+        },
+        IsStop);
+#else
+    return ScanGeneric(Start, End, IsStop);
+#endif
+}
+
+const Char* FindNonIdentifierChar(const Char* Start, const Char* End) noexcept
+{
+    const auto IsStop = [](Char c) { return !(isalnum(static_cast<unsigned char>(c)) || c == '_'); };
+#ifdef SCAN
+    return SCAN(
+        Start, End,
+        [](const auto& v) {
+            // Setting bit 5 maps 'A'-'Z' to 'a'-'z' and does not map any other character into this range
+            const auto Lower     = OR(v, SET1(0x20));
+            const auto IsAlpha   = AND(GT(Lower, SET1('a' - 1)), GT(SET1('z' + 1), Lower));
+            const auto IsDigit   = AND(GT(v, SET1('0' - 1)), GT(SET1('9' + 1), v));
+            const auto IsIdentCh = OR(OR(IsAlpha, IsDigit), EQ(v, SET1('_')));
+            return EQ(IsIdentCh, ZERO());
+        },
+        IsStop);
+#else
+    return ScanGeneric(Start, End, IsStop);
+#endif
+}
+
+const Char* FindSymbolOrNull(const Char* Start, const Char* End, Char Symbol) noexcept
+{
+    const auto IsStop = [Symbol](Char c) { return c == Symbol || c == '\0'; };
+#ifdef SCAN
+    return SCAN(
+        Start, End, [Symbol](const auto& v) { return OR(EQ(v, SET1(Symbol)), EQ(v, ZERO())); }, IsStop);
+#else
+    return ScanGeneric(Start, End, IsStop);
+#endif
+}
+
+#undef SET1
+#undef EQ
+#undef GT
+#undef OR
+#undef AND
+#undef ZERO
+#undef SCAN
+
+} // namespace Parsing
+
+} // namespace Diligent
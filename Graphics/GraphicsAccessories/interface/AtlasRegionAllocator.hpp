@@ -0,0 +1,135 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of the common interface of 2D atlas region allocators
+
+#include "../../../Primitives/interface/BasicTypes.h"
+#include "../../../Common/interface/HashUtils.hpp"
+
+namespace Diligent
+{
+
+/// 2D atlas region
+struct AtlasRegion
+{
+    Uint32 x = 0;
+    Uint32 y = 0;
+
+    Uint32 width  = 0;
+    Uint32 height = 0;
+
+    AtlasRegion() = default;
+
+    // clang-format off
+    AtlasRegion           (const AtlasRegion&)  = default;
+    AtlasRegion           (      AtlasRegion&&) = default;
+    AtlasRegion& operator=(const AtlasRegion&)  = default;
+    AtlasRegion& operator=(      AtlasRegion&&) = default;
+    // clang-format on
+
+    AtlasRegion(Uint32 _x, Uint32 _y, Uint32 _width, Uint32 _height) :
+        // clang-format off
+        x     {_x},
+        y     {_y},
+        width {_width},
+        height{_height}
+    // clang-format on
+    {}
+
+    bool IsEmpty() const
+    {
+        return width == 0 || height == 0;
+    }
+
+    constexpr bool operator==(const AtlasRegion& rhs) const
+    {
+        // clang-format off
+        return x      == rhs.x     &&
+               y      == rhs.y     &&
+               width  == rhs.width &&
+               height == rhs.height;
+        // clang-format on
+    }
+    constexpr bool operator!=(const AtlasRegion& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    struct Hasher
+    {
+        size_t operator()(const AtlasRegion& R) const
+        {
+            return ComputeHash(R.width, R.height, R.x, R.y);
+        }
+    };
+};
+
+
+/// Common interface of 2D atlas region allocators.
+
+/// All allocators manage a Width x Height rectangle and are not thread-safe.
+/// See DynamicAtlasManager, SkylineAtlasManager and ShelfAtlasManager.
+class IAtlasRegionAllocator
+{
+public:
+    using Region = AtlasRegion;
+
+    virtual ~IAtlasRegionAllocator() {}
+
+    /// Allocates a Width x Height region. Returns an empty region if there is not enough space.
+    virtual Region Allocate(Uint32 Width, Uint32 Height) = 0;
+
+    /// Releases the region previously returned by Allocate() and resets R.
+    virtual void Free(Region&& R) = 0;
+
+    /// Returns true if there are no allocated regions.
+    virtual bool IsEmpty() const = 0;
+
+    virtual Uint32 GetWidth() const  = 0;
+    virtual Uint32 GetHeight() const = 0;
+
+    /// Returns the total area that is not occupied by allocated regions.
+    virtual Uint64 GetTotalFreeArea() const = 0;
+
+    /// Returns the number of disjoint free regions tracked by the allocator.
+    virtual Uint32 GetFreeRegionCount() const = 0;
+
+    /// Returns the number of allocated regions.
+    virtual Uint32 GetAllocatedRegionCount() const = 0;
+
+    /// Returns the area of the largest region that can currently be allocated.
+
+    /// \remarks   The ratio between the largest free region area and the total
+    ///             free area is a measure of the free space fragmentation: when
+    ///             it is close to one, most of the free space is contiguous.
+    virtual Uint64 GetLargestFreeRegionArea() const = 0;
+};
+
+} // namespace Diligent
@@ -46,6 +46,29 @@ inline float SRGBToLinear(float x)
 float LinearToSRGB(Uint8 x);
 float SRGBToLinear(Uint8 x);
 
+/// Converts Count 8-bit sRGB values to linear values.
+
+/// \remarks   The results are identical to SRGBToLinear(Uint8).
+void SRGB8ToLinear(const Uint8* pSRGB, float* pLinear, size_t Count);
+
+/// Converts Count linear values to 8-bit sRGB values.
+
+/// \remarks   Input values are clamped to [0, 1], NaNs are converted to 0.
+///             The results are correctly rounded, so that converting any 8-bit
+///             value with SRGB8ToLinear and back produces the original value.
+void LinearToSRGB8(const float* pLinear, Uint8* pSRGB, size_t Count);
+
+/// Converts NumPixels RGBA8 pixels with sRGB-encoded color to linear float4 pixels.
+
+/// \remarks   Alpha is not sRGB-encoded and is converted as A / 255.
+void SRGBA8ToLinearRGBA32F(const Uint8* pSRGBA, float* pLinearRGBA, size_t NumPixels);
+
+/// Converts NumPixels linear float4 pixels to RGBA8 pixels with sRGB-encoded color.
+
+/// \remarks   Color is converted as in LinearToSRGB8. Alpha is clamped to [0, 1]
+///             and converted as round(A * 255).
+void LinearRGBA32FToSRGBA8(const float* pLinearRGBA, Uint8* pSRGBA, size_t NumPixels);
+
 inline float FastLinearToSRGB(float x)
 {
     return x < 0.0031308f ? 12.92f * x : 1.13005f * sqrtf(std::abs(x - 0.00228f)) - 0.13448f * x + 0.005719f;
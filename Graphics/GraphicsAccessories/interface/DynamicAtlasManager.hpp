@@ -33,71 +33,21 @@
 
 #include <map>
 #include <unordered_map>
+#include <memory>
 
-#include "../../../Primitives/interface/BasicTypes.h"
-#include "../../../Common/interface/HashUtils.hpp"
+#include "AtlasRegionAllocator.hpp"
 
 namespace Diligent
 {
 
-/// Dynamic 2D atlas manager
-class DynamicAtlasManager
+/// Dynamic 2D atlas manager.
+
+/// The manager recursively splits free regions into up to three nodes and
+/// merges them back when all children are released. Free regions are kept
+/// in two maps sorted by width and height to find the best-fit region.
+class DynamicAtlasManager final : public IAtlasRegionAllocator
 {
 public:
-    struct Region
-    {
-        Uint32 x = 0;
-        Uint32 y = 0;
-
-        Uint32 width  = 0;
-        Uint32 height = 0;
-
-        Region() = default;
-
-        // clang-format off
-        Region           (const Region&)  = default;
-        Region           (      Region&&) = default;
-        Region& operator=(const Region&)  = default;
-        Region& operator=(      Region&&) = default;
-        // clang-format on
-
-        Region(Uint32 _x, Uint32 _y, Uint32 _width, Uint32 _height) :
-            // clang-format off
-            x     {_x},
-            y     {_y},
-            width {_width},
-            height{_height}
-        // clang-format on
-        {}
-
-        bool IsEmpty() const
-        {
-            return width == 0 || height == 0;
-        }
-
-        constexpr bool operator==(const Region& rhs) const
-        {
-            // clang-format off
-            return x      == rhs.x     &&
-                   y      == rhs.y     &&
-                   width  == rhs.width &&
-                   height == rhs.height;
-            // clang-format on
-        }
-        constexpr bool operator!=(const Region& rhs) const
-        {
-            return !(*this == rhs);
-        }
-
-        struct Hasher
-        {
-            size_t operator()(const Region& R) const
-            {
-                return ComputeHash(R.width, R.height, R.x, R.y);
-            }
-        };
-    };
-
     DynamicAtlasManager(Uint32 Width, Uint32 Height);
     ~DynamicAtlasManager();
 
@@ -108,20 +58,27 @@ public:
     DynamicAtlasManager& operator = (      DynamicAtlasManager&&) = delete;
     // clang-format on
 
-    Region Allocate(Uint32 Width, Uint32 Height);
-    void   Free(Region&& R);
+    virtual Region Allocate(Uint32 Width, Uint32 Height) override final;
+    virtual void   Free(Region&& R) override final;
 
-    Uint32 GetFreeRegionCount() const
+    virtual Uint32 GetFreeRegionCount() const override final
     {
         VERIFY_EXPR(m_FreeRegionsByWidth.size() == m_FreeRegionsByHeight.size());
         return static_cast<Uint32>(m_FreeRegionsByWidth.size());
     }
 
-    Uint32 GetWidth() const { return m_Width; }
-    Uint32 GetHeight() const { return m_Height; }
-    Uint64 GetTotalFreeArea() const { return m_TotalFreeArea; }
+    virtual Uint32 GetWidth() const override final { return m_Width; }
+    virtual Uint32 GetHeight() const override final { return m_Height; }
+    virtual Uint64 GetTotalFreeArea() const override final { return m_TotalFreeArea; }
+
+    virtual Uint32 GetAllocatedRegionCount() const override final
+    {
+        return static_cast<Uint32>(m_AllocatedRegions.size());
+    }
+
+    virtual Uint64 GetLargestFreeRegionArea() const override final;
 
-    bool IsEmpty() const
+    virtual bool IsEmpty() const override final
     {
         VERIFY_EXPR(m_AllocatedRegions.empty() && (m_TotalFreeArea == Uint64{m_Width} * Uint64{m_Height}) ||
                     !m_AllocatedRegions.empty() && (m_TotalFreeArea < Uint64{m_Width} * Uint64{m_Height}));
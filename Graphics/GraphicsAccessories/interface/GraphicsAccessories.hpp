@@ -43,6 +43,8 @@
 namespace Diligent
 {
 
+class IThreadPool;
+
 /// Template structure to convert VALUE_TYPE enumeration into C-type
 template <VALUE_TYPE ValType>
 struct VALUE_TYPE2CType
@@ -675,13 +677,21 @@ BufferToTextureCopyInfo GetBufferToTextureCopyInfo(TEXTURE_FORMAT Format,
 /// \param [in] pDstData       - Pointer to the destination subresource data.
 /// \param [in] DstRowStride   - Destination subresource row stride, in bytes.
 /// \param [in] DstDepthStride - Destination subresource depth stride, in bytes.
+/// \param [in] pThreadPool    - Optional thread pool. If not null, large subresources
+///                              are copied in parallel.
+///
+/// \remarks   Rows and depth slices are merged into a single copy operation only when both
+///            source and destination are tightly packed. Padding bytes in the destination
+///            are never written. Large copies use non-temporal stores where available,
+///            as the destination is typically staging memory that is not read by the CPU.
 void CopyTextureSubresource(const TextureSubResData& SrcSubres,
                             Uint32                   NumRows,
                             Uint32                   NumDepthSlices,
                             Uint64                   RowSize,
                             void*                    pDstData,
                             Uint64                   DstRowStride,
-                            Uint64                   DstDepthStride);
+                            Uint64                   DstDepthStride,
+                            IThreadPool*             pThreadPool = nullptr);
 
 
 inline String GetShaderResourcePrintName(const char* Name, Uint32 ArraySize, Uint32 ArrayIndex)
@@ -0,0 +1,147 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of ShelfAtlasManager class
+
+#include <vector>
+#include <unordered_set>
+
+#include "AtlasRegionAllocator.hpp"
+
+namespace Diligent
+{
+
+/// Shelf 2D atlas manager.
+
+/// The manager splits the atlas into horizontal shelves stacked on top of each other.
+/// The height of a shelf is defined by the first region placed on it. New regions are
+/// placed on the current shelf (next-fit). When the region does not fit or the shelf is
+/// much taller than the region, the manager looks for the shortest existing shelf of a
+/// suitable height, and opens a new shelf on top of the previous one if there is none.
+/// When there is no space for a new shelf, any shelf that has enough space is used.
+///
+/// Released space on a shelf is reused by the regions that are not taller than the shelf.
+/// Empty shelves at the top are removed, and adjacent empty shelves are merged.
+///
+/// Shelf packing is the fastest of all allocators and works well when regions have similar heights.
+class ShelfAtlasManager final : public IAtlasRegionAllocator
+{
+public:
+    ShelfAtlasManager(Uint32 Width, Uint32 Height);
+    ~ShelfAtlasManager();
+
+    // clang-format off
+    ShelfAtlasManager             (const ShelfAtlasManager&)  = delete;
+    ShelfAtlasManager& operator = (const ShelfAtlasManager&)  = delete;
+    ShelfAtlasManager             (      ShelfAtlasManager&&) = default;
+    ShelfAtlasManager& operator = (      ShelfAtlasManager&&) = delete;
+    // clang-format on
+
+    virtual Region Allocate(Uint32 Width, Uint32 Height) override final;
+    virtual void   Free(Region&& R) override final;
+
+    virtual bool IsEmpty() const override final
+    {
+        return m_AllocatedRegions.empty();
+    }
+
+    virtual Uint32 GetWidth() const override final { return m_Width; }
+    virtual Uint32 GetHeight() const override final { return m_Height; }
+
+    virtual Uint64 GetTotalFreeArea() const override final
+    {
+        return Uint64{m_Width} * Uint64{m_Height} - m_AllocatedArea;
+    }
+
+    virtual Uint32 GetFreeRegionCount() const override final;
+
+    virtual Uint32 GetAllocatedRegionCount() const override final
+    {
+        return static_cast<Uint32>(m_AllocatedRegions.size());
+    }
+
+    virtual Uint64 GetLargestFreeRegionArea() const override final;
+
+private:
+    // Free horizontal span [x0, x1) of a shelf
+    struct Span
+    {
+        Uint32 x0;
+        Uint32 x1;
+    };
+
+    struct Shelf
+    {
+        Uint32 y      = 0;
+        Uint32 height = 0;
+
+        // Free spans sorted by x
+        std::vector<Span> FreeSpans;
+
+        Uint32 AllocationCount = 0;
+
+        Shelf(Uint32 _y, Uint32 _height, Uint32 Width) :
+            y{_y},
+            height{_height},
+            FreeSpans{{0, Width}}
+        {}
+    };
+
+    // Allocates Width texels from the shelf and returns the x coordinate of the
+    // allocation, or ~0u if there is no span that is wide enough.
+    static Uint32 AllocateFromShelf(Shelf& S, Uint32 Width);
+
+    // Returns the index of the shortest shelf with the height in the range [Height, MaxHeight]
+    // that has enough space for the region, or the number of shelves if there is no such shelf.
+    size_t FindShelf(Uint32 Width, Uint32 Height, Uint32 MaxHeight) const;
+
+    void RemoveEmptyShelves(size_t ShelfIdx);
+
+#if DILIGENT_DEBUG
+    void DbgVerifyConsistency() const;
+#endif
+
+    const Uint32 m_Width;
+    const Uint32 m_Height;
+
+    // Shelves sorted by y
+    std::vector<Shelf> m_Shelves;
+
+    // The top of the last shelf
+    Uint32 m_Top = 0;
+
+    size_t m_CurrentShelf = 0;
+
+    std::unordered_set<Region, Region::Hasher> m_AllocatedRegions;
+
+    Uint64 m_AllocatedArea = 0;
+};
+
+} // namespace Diligent
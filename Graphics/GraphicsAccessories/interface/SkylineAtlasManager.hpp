@@ -0,0 +1,127 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of SkylineAtlasManager class
+
+#include <vector>
+#include <unordered_set>
+
+#include "AtlasRegionAllocator.hpp"
+
+namespace Diligent
+{
+
+/// Skyline 2D atlas manager.
+
+/// The manager keeps the skyline - the top boundary of the occupied area - as a list of
+/// horizontal segments, and places every new region at the bottom-left-most position where
+/// it fits. Gaps left under the new region are recorded in the waste list and are reused by
+/// subsequent allocations, as are the released regions. When a released region lies directly
+/// under the skyline, the skyline is lowered.
+///
+/// Skyline packing is most efficient for many small regions of similar height, such as glyphs.
+class SkylineAtlasManager final : public IAtlasRegionAllocator
+{
+public:
+    SkylineAtlasManager(Uint32 Width, Uint32 Height);
+    ~SkylineAtlasManager();
+
+    // clang-format off
+    SkylineAtlasManager             (const SkylineAtlasManager&)  = delete;
+    SkylineAtlasManager& operator = (const SkylineAtlasManager&)  = delete;
+    SkylineAtlasManager             (      SkylineAtlasManager&&) = default;
+    SkylineAtlasManager& operator = (      SkylineAtlasManager&&) = delete;
+    // clang-format on
+
+    virtual Region Allocate(Uint32 Width, Uint32 Height) override final;
+    virtual void   Free(Region&& R) override final;
+
+    virtual bool IsEmpty() const override final
+    {
+        return m_AllocatedRegions.empty();
+    }
+
+    virtual Uint32 GetWidth() const override final { return m_Width; }
+    virtual Uint32 GetHeight() const override final { return m_Height; }
+
+    virtual Uint64 GetTotalFreeArea() const override final
+    {
+        return Uint64{m_Width} * Uint64{m_Height} - m_AllocatedArea;
+    }
+
+    virtual Uint32 GetFreeRegionCount() const override final;
+
+    virtual Uint32 GetAllocatedRegionCount() const override final
+    {
+        return static_cast<Uint32>(m_AllocatedRegions.size());
+    }
+
+    virtual Uint64 GetLargestFreeRegionArea() const override final;
+
+private:
+    void Reset();
+
+    Region AllocateFromWaste(Uint32 Width, Uint32 Height);
+    Region AllocateFromSkyline(Uint32 Width, Uint32 Height);
+
+    // Sets the skyline height to Y in the range [X, X + Width)
+    void SetSkylineHeight(Uint32 X, Uint32 Width, Uint32 Y);
+
+    // Returns true if the skyline height is Y everywhere in the range [X, X + Width)
+    bool IsSkylineHeight(Uint32 X, Uint32 Width, Uint32 Y) const;
+
+    void AddWasteRegion(const Region& R);
+
+#if DILIGENT_DEBUG
+    void DbgVerifyConsistency() const;
+#endif
+
+    const Uint32 m_Width;
+    const Uint32 m_Height;
+
+    // Horizontal segment of the skyline
+    struct Segment
+    {
+        Uint32 x;
+        Uint32 y;
+        Uint32 width;
+    };
+    // Segments sorted by x that cover the entire atlas width
+    std::vector<Segment> m_Skyline;
+
+    // Free regions under the skyline
+    std::vector<Region> m_WasteRegions;
+
+    std::unordered_set<Region, Region::Hasher> m_AllocatedRegions;
+
+    Uint64 m_AllocatedArea = 0;
+};
+
+} // namespace Diligent
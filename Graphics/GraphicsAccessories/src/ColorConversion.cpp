@@ -27,7 +27,12 @@
 
 #include <array>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #include "ColorConversion.h"
+#include "Intrinsics.hpp"
+#include "DebugUtilities.hpp"
 
 namespace Diligent
 {
@@ -71,12 +76,282 @@ public:
         return m_ToLinear[x];
     }
 
+    const float* GetData() const
+    {
+        return m_ToLinear.data();
+    }
+
 private:
     std::array<float, 256> m_ToLinear;
 };
 
+class UNORM8ToFloatMap
+{
+public:
+    UNORM8ToFloatMap() noexcept
+    {
+        for (Uint32 i = 0; i < m_ToFloat.size(); ++i)
+        {
+            m_ToFloat[i] = static_cast<float>(i) / 255.f;
+        }
+    }
+
+    float operator[](Uint8 x) const
+    {
+        return m_ToFloat[x];
+    }
+
+    const float* GetData() const
+    {
+        return m_ToFloat.data();
+    }
+
+private:
+    std::array<float, 256> m_ToFloat;
+};
+
+const SRGBToLinearMap& GetSRGBToLinearMap()
+{
+    static const SRGBToLinearMap map;
+    return map;
+}
+
+const UNORM8ToFloatMap& GetUNORM8ToFloatMap()
+{
+    static const UNORM8ToFloatMap map;
+    return map;
+}
+
+// Converts linear values to 8-bit sRGB values.
+//
+// [0, 1] range is split into NumBuckets uniform buckets. The sRGB curve is steepest near zero
+// (12.92 * 255 ~ 3295 codes per unit), so every bucket contains at most one rounding threshold.
+// For every bucket, the table stores the sRGB code at the bucket start and the threshold where
+// the code is incremented:
+//
+//      code = BaseCodes[i] + (x >= Thresholds[i] ? 1 : 0),  where i = floor(x * NumBuckets)
+//
+// The thresholds are computed in double precision and rounded up to the nearest float, so that
+// the comparison with a float value is exact.
+class LinearToSRGB8Map
+{
+public:
+    static constexpr Uint32 NumBuckets = 4096;
+
+    LinearToSRGB8Map() noexcept
+    {
+        // Linear values where the rounded sRGB code changes from k to k + 1
+        std::array<float, 255> CodeThresholds;
+        for (Uint32 k = 0; k < CodeThresholds.size(); ++k)
+        {
+            const double SRGB   = (k + 0.5) / 255.0;
+            const double Linear = SRGB <= 0.04045 ? SRGB / 12.92 : std::pow((SRGB + 0.055) / 1.055, 2.4);
+
+            float Threshold = static_cast<float>(Linear);
+            if (static_cast<double>(Threshold) < Linear)
+                Threshold = std::nextafter(Threshold, 2.f);
+            CodeThresholds[k] = Threshold;
+        }
+
+        Uint32 Code = 0;
+        for (Uint32 i = 0; i <= NumBuckets; ++i)
+        {
+            const float BucketStart = static_cast<float>(i) / static_cast<float>(NumBuckets);
+            while (Code < CodeThresholds.size() && CodeThresholds[Code] <= BucketStart)
+                ++Code;
+
+            m_BaseCodes[i]  = static_cast<Uint8>(Code);
+            m_Thresholds[i] = Code < CodeThresholds.size() ? CodeThresholds[Code] : 2.f;
+            VERIFY(Code + 1 >= CodeThresholds.size() || CodeThresholds[Code + 1] >= static_cast<float>(i + 1) / static_cast<float>(NumBuckets),
+                   "Bucket ", i, " contains more than one threshold");
+        }
+        // Padding for 32-bit gathers
+        m_BaseCodes[NumBuckets + 1] = 0;
+        m_BaseCodes[NumBuckets + 2] = 0;
+        m_BaseCodes[NumBuckets + 3] = 0;
+    }
+
+    Uint8 operator()(float x) const
+    {
+        // Note that NaNs fail the comparison and are converted to 0
+        x = x > 0.f ? x : 0.f;
+        x = x < 1.f ? x : 1.f;
+
+        const auto i = static_cast<Uint32>(x * static_cast<float>(NumBuckets));
+        return static_cast<Uint8>(m_BaseCodes[i] + (x >= m_Thresholds[i] ? 1 : 0));
+    }
+
+    const float* GetThresholds() const
+    {
+        return m_Thresholds.data();
+    }
+
+    const Uint8* GetBaseCodes() const
+    {
+        return m_BaseCodes.data();
+    }
+
+private:
+    std::array<float, NumBuckets + 1> m_Thresholds;
+    std::array<Uint8, NumBuckets + 4> m_BaseCodes;
+};
+
+const LinearToSRGB8Map& GetLinearToSRGB8Map()
+{
+    static const LinearToSRGB8Map map;
+    return map;
+}
+
+Uint8 LinearToUNORM8(float x)
+{
+    x = x > 0.f ? x : 0.f;
+    x = x < 1.f ? x : 1.f;
+    return static_cast<Uint8>(x * 255.f + 0.5f);
+}
+
+#if DILIGENT_AVX2_ENABLED
+
+// Converts 8 linear values to 8-bit sRGB values. Returns codes in 32-bit lanes.
+__m256i LinearToSRGB8AVX2(__m256 x, const LinearToSRGB8Map& Map)
+{
+    // max/min return the second operand if the first one is NaN
+    x = _mm256_max_ps(x, _mm256_setzero_ps());
+    x = _mm256_min_ps(x, _mm256_set1_ps(1.f));
+
+    const __m256i Buckets    = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(static_cast<float>(LinearToSRGB8Map::NumBuckets))));
+    const __m256  Thresholds = _mm256_i32gather_ps(Map.GetThresholds(), Buckets, 4);
+    // Gather 32-bit values at byte offsets and keep the low byte
+    const __m256i BaseCodes = _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int*>(Map.GetBaseCodes()), Buckets, 1), _mm256_set1_epi32(0xFF));
+    // The comparison mask is -1 where the threshold is reached
+    return _mm256_sub_epi32(BaseCodes, _mm256_castps_si256(_mm256_cmp_ps(x, Thresholds, _CMP_GE_OQ)));
+}
+
+// Converts 8 linear values to UNORM8 values. Returns values in 32-bit lanes.
+__m256i LinearToUNORM8AVX2(__m256 x)
+{
+    x = _mm256_max_ps(x, _mm256_setzero_ps());
+    x = _mm256_min_ps(x, _mm256_set1_ps(1.f));
+    return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(255.f)), _mm256_set1_ps(0.5f)));
+}
+
+// Packs 8 values in 32-bit lanes into 8 bytes
+void StoreUint8x8AVX2(__m256i Values, Uint8* pDst)
+{
+    // Each 128-bit lane contains 4 values repeated 4 times
+    const __m256i Packed = _mm256_packus_epi16(_mm256_packus_epi32(Values, Values), _mm256_setzero_si256());
+
+    const int Lo = _mm_cvtsi128_si32(_mm256_castsi256_si128(Packed));
+    const int Hi = _mm_cvtsi128_si32(_mm256_extracti128_si256(Packed, 1));
+    memcpy(pDst, &Lo, 4);
+    memcpy(pDst + 4, &Hi, 4);
+}
+
+#endif
+
 } // namespace
 
+void SRGB8ToLinear(const Uint8* pSRGB, float* pLinear, size_t Count)
+{
+    VERIFY_EXPR(Count == 0 || (pSRGB != nullptr && pLinear != nullptr));
+    const auto& Map = GetSRGBToLinearMap();
+
+    size_t i = 0;
+#if DILIGENT_AVX2_ENABLED
+    for (; i + 8 <= Count; i += 8)
+    {
+        const __m256i Codes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSRGB + i)));
+        _mm256_storeu_ps(pLinear + i, _mm256_i32gather_ps(Map.GetData(), Codes, 4));
+    }
+#endif
+    for (; i < Count; ++i)
+        pLinear[i] = Map[pSRGB[i]];
+}
+
+void LinearToSRGB8(const float* pLinear, Uint8* pSRGB, size_t Count)
+{
+    VERIFY_EXPR(Count == 0 || (pSRGB != nullptr && pLinear != nullptr));
+    const auto& Map = GetLinearToSRGB8Map();
+
+    size_t i = 0;
+#if DILIGENT_AVX2_ENABLED
+    for (; i + 8 <= Count; i += 8)
+        StoreUint8x8AVX2(LinearToSRGB8AVX2(_mm256_loadu_ps(pLinear + i), Map), pSRGB + i);
+#endif
+    for (; i < Count; ++i)
+        pSRGB[i] = Map(pLinear[i]);
+}
+
+void SRGBA8ToLinearRGBA32F(const Uint8* pSRGBA, float* pLinearRGBA, size_t NumPixels)
+{
+    VERIFY_EXPR(NumPixels == 0 || (pSRGBA != nullptr && pLinearRGBA != nullptr));
+    const auto& ColorMap = GetSRGBToLinearMap();
+    const auto& AlphaMap = GetUNORM8ToFloatMap();
+
+    size_t i = 0;
+#if DILIGENT_AVX2_ENABLED
+    // Lanes 3 and 7 contain alpha: use the offset of the alpha table in the combined table
+    const __m256i AlphaOffset = _mm256_setr_epi32(0, 0, 0, 256, 0, 0, 0, 256);
+
+    // Combine color and alpha tables to use a single gather
+    static const auto CombinedMap = []() {
+        const auto& ColorMap = GetSRGBToLinearMap();
+        const auto& AlphaMap = GetUNORM8ToFloatMap();
+
+        std::array<float, 512> Map;
+        for (Uint32 c = 0; c < 256; ++c)
+        {
+            Map[c]       = ColorMap[static_cast<Uint8>(c)];
+            Map[256 + c] = AlphaMap[static_cast<Uint8>(c)];
+        }
+        return Map;
+    }();
+
+    for (; i + 2 <= NumPixels; i += 2)
+    {
+        __m256i Codes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSRGBA + i * 4)));
+        Codes         = _mm256_add_epi32(Codes, AlphaOffset);
+        _mm256_storeu_ps(pLinearRGBA + i * 4, _mm256_i32gather_ps(CombinedMap.data(), Codes, 4));
+    }
+#endif
+    for (; i < NumPixels; ++i)
+    {
+        const Uint8* pSrc = pSRGBA + i * 4;
+        float*       pDst = pLinearRGBA + i * 4;
+
+        pDst[0] = ColorMap[pSrc[0]];
+        pDst[1] = ColorMap[pSrc[1]];
+        pDst[2] = ColorMap[pSrc[2]];
+        pDst[3] = AlphaMap[pSrc[3]];
+    }
+}
+
+void LinearRGBA32FToSRGBA8(const float* pLinearRGBA, Uint8* pSRGBA, size_t NumPixels)
+{
+    VERIFY_EXPR(NumPixels == 0 || (pSRGBA != nullptr && pLinearRGBA != nullptr));
+    const auto& Map = GetLinearToSRGB8Map();
+
+    size_t i = 0;
+#if DILIGENT_AVX2_ENABLED
+    for (; i + 2 <= NumPixels; i += 2)
+    {
+        const __m256 Values = _mm256_loadu_ps(pLinearRGBA + i * 4);
+        // Take alpha (lanes 3 and 7) from the UNORM conversion
+        const __m256i Codes = _mm256_blend_epi32(LinearToSRGB8AVX2(Values, Map), LinearToUNORM8AVX2(Values), 0x88);
+        StoreUint8x8AVX2(Codes, pSRGBA + i * 4);
+    }
+#endif
+    for (; i < NumPixels; ++i)
+    {
+        const float* pSrc = pLinearRGBA + i * 4;
+        Uint8*       pDst = pSRGBA + i * 4;
+
+        pDst[0] = Map(pSrc[0]);
+        pDst[1] = Map(pSrc[1]);
+        pDst[2] = Map(pSrc[2]);
+        pDst[3] = LinearToUNORM8(pSrc[3]);
+    }
+}
+
 float LinearToSRGB(Uint8 x)
 {
     static const LinearToSRGBMap map;
@@ -85,8 +360,7 @@ float LinearToSRGB(Uint8 x)
 
 float SRGBToLinear(Uint8 x)
 {
-    static const SRGBToLinearMap map;
-    return map[x];
+    return GetSRGBToLinearMap()[x];
 }
 
 } // namespace Diligent
@@ -28,6 +28,7 @@
 #include "DynamicAtlasManager.hpp"
 
 #include <climits>
+#include <algorithm>
 
 #include "AdvancedMath.hpp"
 
@@ -369,6 +370,14 @@ void DynamicAtlasManager::Free(Region&& R)
     R = InvalidRegion;
 }
 
+Uint64 DynamicAtlasManager::GetLargestFreeRegionArea() const
+{
+    Uint64 MaxArea = 0;
+    for (const auto& it : m_FreeRegionsByWidth)
+        MaxArea = std::max(MaxArea, Uint64{it.first.width} * Uint64{it.first.height});
+    return MaxArea;
+}
+
 
 #if DILIGENT_DEBUG
 
@@ -26,12 +26,16 @@
  */
 
 #include <algorithm>
+#include <cstring>
+#include <vector>
 
 #include "GraphicsAccessories.hpp"
 #include "DebugUtilities.hpp"
 #include "Align.hpp"
 #include "BasicMath.hpp"
 #include "Cast.hpp"
+#include "Intrinsics.hpp"
+#include "ThreadPool.hpp"
 
 namespace Diligent
 {
@@ -1921,30 +1925,175 @@ BufferToTextureCopyInfo GetBufferToTextureCopyInfo(TEXTURE_FORMAT Format,
 }
 
 
+namespace
+{
+
+// Copies larger than this are unlikely to fit into the cache and use non-temporal stores
+constexpr Uint64 StreamingCopyThreshold = Uint64{8} << 20;
+// Minimum number of bytes copied by a single thread pool task
+constexpr Uint64 MinBytesPerCopyTask = Uint64{1} << 20;
+constexpr Uint32 MaxCopyTasks        = 64;
+
+void CopyBytes(Uint8* pDst, const Uint8* pSrc, size_t Size, bool UseStreamingStores)
+{
+#if DILIGENT_SSE2_ENABLED
+    if (UseStreamingStores && Size >= 128)
+    {
+        // Copy the head with memcpy to align the destination
+        const size_t HeadSize = AlignUp(reinterpret_cast<uintptr_t>(pDst), uintptr_t{16}) - reinterpret_cast<uintptr_t>(pDst);
+        memcpy(pDst, pSrc, HeadSize);
+        pDst += HeadSize;
+        pSrc += HeadSize;
+        Size -= HeadSize;
+
+        const Uint8* const pSrcEnd = pSrc + (Size & ~size_t{63});
+        for (; pSrc < pSrcEnd; pSrc += 64, pDst += 64)
+        {
+            const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc) + 0);
+            const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc) + 1);
+            const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc) + 2);
+            const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc) + 3);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(pDst) + 0, v0);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(pDst) + 1, v1);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(pDst) + 2, v2);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(pDst) + 3, v3);
+        }
+        Size &= 63;
+    }
+#endif
+    memcpy(pDst, pSrc, Size);
+}
+
+struct SubresourceCopyAttribs
+{
+    const Uint8* pSrc;
+    Uint64       SrcRowStride;
+    Uint64       SrcDepthStride;
+    Uint8*       pDst;
+    Uint64       DstRowStride;
+    Uint64       DstDepthStride;
+    Uint64       RowSize;
+    Uint32       NumRows;
+    bool         UseStreamingStores;
+};
+
+// Copies rows [FirstRow, FirstRow + NumRowsToCopy) of the depth slice z
+void CopySubresourceRows(const SubresourceCopyAttribs& Attribs, Uint32 z, Uint32 FirstRow, Uint32 NumRowsToCopy)
+{
+    const auto* pSrc = Attribs.pSrc + Attribs.SrcDepthStride * z + Attribs.SrcRowStride * FirstRow;
+    auto*       pDst = Attribs.pDst + Attribs.DstDepthStride * z + Attribs.DstRowStride * FirstRow;
+    if (Attribs.SrcRowStride == Attribs.RowSize && Attribs.DstRowStride == Attribs.RowSize)
+    {
+        // Rows are tightly packed in both source and destination - copy them at once.
+        // Rows with padding must be copied one by one to keep the destination padding intact.
+        const auto Size = Attribs.RowSize * NumRowsToCopy;
+        CopyBytes(pDst, pSrc, StaticCast<size_t>(Size), Attribs.UseStreamingStores);
+    }
+    else
+    {
+        for (Uint32 y = 0; y < NumRowsToCopy; ++y)
+        {
+            CopyBytes(pDst + Attribs.DstRowStride * y,
+                      pSrc + Attribs.SrcRowStride * y,
+                      StaticCast<size_t>(Attribs.RowSize),
+                      Attribs.UseStreamingStores);
+        }
+    }
+}
+
+// Copies rows [FirstRow, FirstRow + NumRowsToCopy), where rows of all depth slices are enumerated sequentially
+void CopySubresourceRowRange(const SubresourceCopyAttribs& Attribs, Uint64 FirstRow, Uint64 NumRowsToCopy)
+{
+    while (NumRowsToCopy > 0)
+    {
+        const auto z      = static_cast<Uint32>(FirstRow / Attribs.NumRows);
+        const auto y      = static_cast<Uint32>(FirstRow % Attribs.NumRows);
+        const auto NumRow = static_cast<Uint32>(std::min(NumRowsToCopy, Uint64{Attribs.NumRows - y}));
+        CopySubresourceRows(Attribs, z, y, NumRow);
+        FirstRow += NumRow;
+        NumRowsToCopy -= NumRow;
+    }
+}
+
+} // namespace
+
 void CopyTextureSubresource(const TextureSubResData& SrcSubres,
                             Uint32                   NumRows,
                             Uint32                   NumDepthSlices,
                             Uint64                   RowSize,
                             void*                    pDstData,
                             Uint64                   DstRowStride,
-                            Uint64                   DstDepthStride)
+                            Uint64                   DstDepthStride,
+                            IThreadPool*             pThreadPool)
 {
     VERIFY_EXPR(SrcSubres.pSrcBuffer == nullptr && SrcSubres.pData != nullptr);
     VERIFY_EXPR(pDstData != nullptr);
     VERIFY(SrcSubres.Stride >= RowSize, "Source data row stride (", SrcSubres.Stride, ") is smaller than the row size (", RowSize, ")");
     VERIFY(DstRowStride >= RowSize, "Dst data row stride (", DstRowStride, ") is smaller than the row size (", RowSize, ")");
-    for (Uint32 z = 0; z < NumDepthSlices; ++z)
+    if (NumRows == 0 || NumDepthSlices == 0 || RowSize == 0)
+        return;
+
+    const Uint64 TotalSize = RowSize * NumRows * NumDepthSlices;
+
+    SubresourceCopyAttribs Attribs;
+    Attribs.pSrc               = static_cast<const Uint8*>(SrcSubres.pData);
+    Attribs.SrcRowStride       = SrcSubres.Stride;
+    Attribs.SrcDepthStride     = SrcSubres.DepthStride;
+    Attribs.pDst               = static_cast<Uint8*>(pDstData);
+    Attribs.DstRowStride       = DstRowStride;
+    Attribs.DstDepthStride     = DstDepthStride;
+    Attribs.RowSize            = RowSize;
+    Attribs.NumRows            = NumRows;
+    Attribs.UseStreamingStores = TotalSize >= StreamingCopyThreshold;
+
+    const Uint64 TotalRows = Uint64{NumRows} * NumDepthSlices;
+    const Uint32 NumTasks  = pThreadPool != nullptr ?
+        static_cast<Uint32>(std::min(std::min(TotalSize / MinBytesPerCopyTask, Uint64{MaxCopyTasks}), TotalRows)) :
+        1;
+
+    if (NumTasks <= 1)
+    {
+        if (NumDepthSlices > 1 &&
+            SrcSubres.Stride == RowSize && DstRowStride == RowSize &&
+            SrcSubres.DepthStride == RowSize * NumRows && DstDepthStride == RowSize * NumRows)
+        {
+            // The whole subresource is tightly packed in both source and destination - copy it at once
+            const auto Size = TotalSize;
+            CopyBytes(Attribs.pDst, Attribs.pSrc, StaticCast<size_t>(Size), Attribs.UseStreamingStores);
+        }
+        else
+        {
+            CopySubresourceRowRange(Attribs, 0, TotalRows);
+        }
+    }
+    else
     {
-        const auto* pSrcSlice = reinterpret_cast<const Uint8*>(SrcSubres.pData) + SrcSubres.DepthStride * z;
-        auto*       pDstSlice = reinterpret_cast<Uint8*>(pDstData) + DstDepthStride * z;
+        const Uint64 RowsPerTask = (TotalRows + NumTasks - 1) / NumTasks;
 
-        for (Uint32 y = 0; y < NumRows; ++y)
+        std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+        Tasks.reserve(NumTasks);
+        for (Uint64 FirstRow = 0; FirstRow < TotalRows; FirstRow += RowsPerTask)
         {
-            memcpy(pDstSlice + DstRowStride * y,
-                   pSrcSlice + SrcSubres.Stride * y,
-                   StaticCast<size_t>(RowSize));
+            Tasks.emplace_back(EnqueueAsyncWork(pThreadPool,
+                                                [&Attribs, FirstRow, RowsPerTask, TotalRows](Uint32) //
+                                                {
+                                                    CopySubresourceRowRange(Attribs, FirstRow, std::min(RowsPerTask, TotalRows - FirstRow));
+#if DILIGENT_SSE2_ENABLED
+                                                    if (Attribs.UseStreamingStores)
+                                                        _mm_sfence();
+#endif
+                                                }));
         }
+
+        for (auto& pTask : Tasks)
+            pTask->WaitForCompletion();
     }
+
+#if DILIGENT_SSE2_ENABLED
+    // Make non-temporal stores globally visible
+    if (Attribs.UseStreamingStores)
+        _mm_sfence();
+#endif
 }
 
 String GetCommandQueueTypeString(COMMAND_QUEUE_TYPE Type)
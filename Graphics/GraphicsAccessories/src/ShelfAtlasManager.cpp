@@ -0,0 +1,283 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "ShelfAtlasManager.hpp"
+
+#include <algorithm>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+ShelfAtlasManager::ShelfAtlasManager(Uint32 Width, Uint32 Height) :
+    // clang-format off
+    m_Width {Width},
+    m_Height{Height}
+// clang-format on
+{
+}
+
+ShelfAtlasManager::~ShelfAtlasManager()
+{
+    DEV_CHECK_ERR(m_AllocatedRegions.empty(), "There must be no allocated regions");
+}
+
+Uint32 ShelfAtlasManager::AllocateFromShelf(Shelf& S, Uint32 Width)
+{
+    for (auto it = S.FreeSpans.begin(); it != S.FreeSpans.end(); ++it)
+    {
+        if (it->x1 - it->x0 >= Width)
+        {
+            const auto x = it->x0;
+            it->x0 += Width;
+            if (it->x0 == it->x1)
+                S.FreeSpans.erase(it);
+            ++S.AllocationCount;
+            return x;
+        }
+    }
+    return ~0u;
+}
+
+ShelfAtlasManager::Region ShelfAtlasManager::Allocate(Uint32 Width, Uint32 Height)
+{
+    if (Width == 0 || Height == 0 || Width > m_Width || Height > m_Height)
+        return Region{};
+
+    // Do not place regions on shelves that are much taller than the region
+    // unless there is no other option.
+    const Uint32 MaxShelfHeight = Height + Height / 4;
+
+    Region R;
+    // Try the current shelf first (next fit)
+    if (m_CurrentShelf < m_Shelves.size())
+    {
+        auto& S = m_Shelves[m_CurrentShelf];
+        if (Height <= S.height && S.height <= MaxShelfHeight)
+        {
+            const auto x = AllocateFromShelf(S, Width);
+            if (x != ~0u)
+                R = Region{x, S.y, Width, Height};
+        }
+    }
+
+    auto AllocateFromBestShelf = [&](Uint32 MaxHeight) {
+        const auto ShelfIdx = FindShelf(Width, Height, MaxHeight);
+        if (ShelfIdx < m_Shelves.size())
+        {
+            auto&      S = m_Shelves[ShelfIdx];
+            const auto x = AllocateFromShelf(S, Width);
+            VERIFY_EXPR(x != ~0u);
+            R              = Region{x, S.y, Width, Height};
+            m_CurrentShelf = ShelfIdx;
+        }
+    };
+
+    // Try other shelves of a suitable height
+    if (R.IsEmpty())
+        AllocateFromBestShelf(MaxShelfHeight);
+
+    // Open a new shelf
+    if (R.IsEmpty() && m_Top + Height <= m_Height)
+    {
+        m_Shelves.emplace_back(m_Top, Height, m_Width);
+        m_Top += Height;
+        m_CurrentShelf = m_Shelves.size() - 1;
+
+        const auto x = AllocateFromShelf(m_Shelves.back(), Width);
+        VERIFY_EXPR(x == 0);
+        R = Region{x, m_Shelves.back().y, Width, Height};
+    }
+
+    // Fall back to any shelf that has enough space
+    if (R.IsEmpty())
+        AllocateFromBestShelf(m_Height);
+
+    if (R.IsEmpty())
+        return R;
+
+    VERIFY_EXPR(m_AllocatedRegions.find(R) == m_AllocatedRegions.end());
+    m_AllocatedRegions.insert(R);
+    m_AllocatedArea += Uint64{R.width} * Uint64{R.height};
+
+#if DILIGENT_DEBUG
+    DbgVerifyConsistency();
+#endif
+
+    return R;
+}
+
+void ShelfAtlasManager::Free(Region&& R)
+{
+    auto it = m_AllocatedRegions.find(R);
+    if (it == m_AllocatedRegions.end())
+    {
+        UNEXPECTED("Unable to find region [", R.x, ", ", R.x + R.width, ") x [", R.y, ", ", R.y + R.height, ") among allocated regions. Have you ever allocated it?");
+        return;
+    }
+    m_AllocatedRegions.erase(it);
+
+    VERIFY_EXPR(m_AllocatedArea >= Uint64{R.width} * Uint64{R.height});
+    m_AllocatedArea -= Uint64{R.width} * Uint64{R.height};
+
+    auto shelf_it = std::lower_bound(m_Shelves.begin(), m_Shelves.end(), R.y,
+                                     [](const Shelf& S, Uint32 y) { return S.y < y; });
+    VERIFY(shelf_it != m_Shelves.end() && shelf_it->y == R.y, "Unable to find the shelf of the region");
+    auto& S = *shelf_it;
+
+    // Insert the span and merge it with the neighbors
+    auto& Spans   = S.FreeSpans;
+    auto  span_it = std::lower_bound(Spans.begin(), Spans.end(), R.x,
+                                     [](const Span& Sp, Uint32 x) { return Sp.x0 < x; });
+    VERIFY(span_it == Spans.end() || span_it->x0 >= R.x + R.width, "The region overlaps a free span");
+    span_it = Spans.insert(span_it, Span{R.x, R.x + R.width});
+    if (span_it + 1 != Spans.end() && span_it->x1 == (span_it + 1)->x0)
+    {
+        span_it->x1 = (span_it + 1)->x1;
+        Spans.erase(span_it + 1);
+    }
+    if (span_it != Spans.begin() && (span_it - 1)->x1 == span_it->x0)
+    {
+        (span_it - 1)->x1 = span_it->x1;
+        Spans.erase(span_it);
+    }
+
+    VERIFY_EXPR(S.AllocationCount > 0);
+    if (--S.AllocationCount == 0)
+    {
+        VERIFY_EXPR(Spans.size() == 1 && Spans[0].x0 == 0 && Spans[0].x1 == m_Width);
+        RemoveEmptyShelves(static_cast<size_t>(shelf_it - m_Shelves.begin()));
+    }
+
+#if DILIGENT_DEBUG
+    DbgVerifyConsistency();
+#endif
+
+    R = Region{};
+}
+
+size_t ShelfAtlasManager::FindShelf(Uint32 Width, Uint32 Height, Uint32 MaxHeight) const
+{
+    // Find the shortest shelf that has a span wide enough for the region
+    size_t BestIdx = m_Shelves.size();
+    for (size_t i = 0; i < m_Shelves.size(); ++i)
+    {
+        const auto& S = m_Shelves[i];
+        if (S.height < Height || S.height > MaxHeight)
+            continue;
+        if (BestIdx < m_Shelves.size() && m_Shelves[BestIdx].height <= S.height)
+            continue;
+
+        for (const auto& Sp : S.FreeSpans)
+        {
+            if (Sp.x1 - Sp.x0 >= Width)
+            {
+                BestIdx = i;
+                break;
+            }
+        }
+    }
+    return BestIdx;
+}
+
+void ShelfAtlasManager::RemoveEmptyShelves(size_t ShelfIdx)
+{
+    VERIFY_EXPR(m_Shelves[ShelfIdx].AllocationCount == 0);
+
+    // Merge the shelf with the adjacent empty shelves
+    if (ShelfIdx + 1 < m_Shelves.size() && m_Shelves[ShelfIdx + 1].AllocationCount == 0)
+    {
+        m_Shelves[ShelfIdx].height += m_Shelves[ShelfIdx + 1].height;
+        m_Shelves.erase(m_Shelves.begin() + ShelfIdx + 1);
+    }
+    if (ShelfIdx > 0 && m_Shelves[ShelfIdx - 1].AllocationCount == 0)
+    {
+        m_Shelves[ShelfIdx - 1].height += m_Shelves[ShelfIdx].height;
+        m_Shelves.erase(m_Shelves.begin() + ShelfIdx);
+        --ShelfIdx;
+    }
+
+    // Release the empty shelf at the top
+    if (ShelfIdx + 1 == m_Shelves.size())
+    {
+        m_Top = m_Shelves[ShelfIdx].y;
+        m_Shelves.pop_back();
+    }
+
+    // Shelf indices may have changed - continue from the last shelf
+    m_CurrentShelf = !m_Shelves.empty() ? m_Shelves.size() - 1 : 0;
+}
+
+Uint32 ShelfAtlasManager::GetFreeRegionCount() const
+{
+    Uint32 Count = m_Top < m_Height ? 1 : 0;
+    for (const auto& S : m_Shelves)
+        Count += static_cast<Uint32>(S.FreeSpans.size());
+    return Count;
+}
+
+Uint64 ShelfAtlasManager::GetLargestFreeRegionArea() const
+{
+    Uint64 MaxArea = Uint64{m_Width} * Uint64{m_Height - m_Top};
+    for (const auto& S : m_Shelves)
+    {
+        for (const auto& Sp : S.FreeSpans)
+            MaxArea = std::max(MaxArea, Uint64{Sp.x1 - Sp.x0} * Uint64{S.height});
+    }
+    return MaxArea;
+}
+
+#if DILIGENT_DEBUG
+void ShelfAtlasManager::DbgVerifyConsistency() const
+{
+    Uint32 y = 0;
+    for (size_t i = 0; i < m_Shelves.size(); ++i)
+    {
+        const auto& S = m_Shelves[i];
+        VERIFY(S.y == y, "Shelves must be contiguous");
+        VERIFY(S.height > 0, "Shelves must not be empty");
+        VERIFY(i + 1 < m_Shelves.size() || S.AllocationCount > 0, "Empty shelf at the top must be released");
+        VERIFY(i == 0 || S.AllocationCount > 0 || m_Shelves[i - 1].AllocationCount > 0, "Adjacent empty shelves must be merged");
+        y += S.height;
+
+        Uint32 x = 0;
+        for (const auto& Sp : S.FreeSpans)
+        {
+            VERIFY(Sp.x0 < Sp.x1, "Free spans must not be empty");
+            VERIFY(Sp.x0 >= x, "Free spans must be sorted and must not overlap");
+            VERIFY(Sp.x0 > x || x == 0, "Adjacent free spans must be merged");
+            x = Sp.x1;
+        }
+        VERIFY(x <= m_Width, "Free span is out of the atlas bounds");
+    }
+    VERIFY(y == m_Top, "Incorrect top of the last shelf");
+    VERIFY_EXPR(m_Top <= m_Height);
+}
+#endif
+
+} // namespace Diligent
@@ -0,0 +1,397 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "SkylineAtlasManager.hpp"
+
+#include <algorithm>
+#include <climits>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+SkylineAtlasManager::SkylineAtlasManager(Uint32 Width, Uint32 Height) :
+    // clang-format off
+    m_Width {Width},
+    m_Height{Height}
+// clang-format on
+{
+    Reset();
+}
+
+SkylineAtlasManager::~SkylineAtlasManager()
+{
+    DEV_CHECK_ERR(m_AllocatedRegions.empty(), "There must be no allocated regions");
+}
+
+void SkylineAtlasManager::Reset()
+{
+    VERIFY_EXPR(m_AllocatedRegions.empty() && m_AllocatedArea == 0);
+    m_Skyline.clear();
+    m_Skyline.push_back({0, 0, m_Width});
+    m_WasteRegions.clear();
+}
+
+SkylineAtlasManager::Region SkylineAtlasManager::AllocateFromWaste(Uint32 Width, Uint32 Height)
+{
+    // Find the smallest waste region that fits the requested size
+    size_t BestIdx  = m_WasteRegions.size();
+    Uint64 BestArea = ~Uint64{0};
+    for (size_t i = 0; i < m_WasteRegions.size(); ++i)
+    {
+        const auto& W = m_WasteRegions[i];
+        if (W.width < Width || W.height < Height)
+            continue;
+
+        const auto Area = Uint64{W.width} * Uint64{W.height};
+        if (Area < BestArea)
+        {
+            BestArea = Area;
+            BestIdx  = i;
+        }
+    }
+    if (BestIdx == m_WasteRegions.size())
+        return Region{};
+
+    const auto W = m_WasteRegions[BestIdx];
+    m_WasteRegions[BestIdx] = m_WasteRegions.back();
+    m_WasteRegions.pop_back();
+
+    // Split the remaining space along the longer leftover side
+    //
+    //   Horizontal split        Vertical split
+    //    _____________           _____ _______
+    //   |     .       |         |     |       |
+    //   |  T  .       |         |  T  |       |
+    //   |_____._______|         |_____|   A   |
+    //   |     |       |         |     |       |
+    //   |  R  |   A   |         |  R  |       |
+    //   |_____|_______|         |_____|_______|
+    //
+    const Uint32 RightWidth = W.width - Width;
+    const Uint32 TopHeight  = W.height - Height;
+    if (RightWidth > TopHeight)
+    {
+        // Vertical split
+        if (RightWidth > 0)
+            AddWasteRegion(Region{W.x + Width, W.y, RightWidth, W.height});
+        if (TopHeight > 0)
+            AddWasteRegion(Region{W.x, W.y + Height, Width, TopHeight});
+    }
+    else
+    {
+        // Horizontal split
+        if (RightWidth > 0)
+            AddWasteRegion(Region{W.x + Width, W.y, RightWidth, Height});
+        if (TopHeight > 0)
+            AddWasteRegion(Region{W.x, W.y + Height, W.width, TopHeight});
+    }
+
+    return Region{W.x, W.y, Width, Height};
+}
+
+SkylineAtlasManager::Region SkylineAtlasManager::AllocateFromSkyline(Uint32 Width, Uint32 Height)
+{
+    // Find the bottom-left-most position where the region fits
+    size_t BestIdx = m_Skyline.size();
+    Uint32 BestY   = 0;
+    Uint32 BestTop = UINT_MAX;
+    for (size_t i = 0; i < m_Skyline.size(); ++i)
+    {
+        const Uint32 x = m_Skyline[i].x;
+        if (x + Width > m_Width)
+            break;
+
+        // The region rests on the highest segment in the range [x, x + Width)
+        Uint32 y = 0;
+        for (size_t j = i; j < m_Skyline.size() && m_Skyline[j].x < x + Width; ++j)
+            y = std::max(y, m_Skyline[j].y);
+
+        if (y + Height > m_Height)
+            continue;
+
+        if (y + Height < BestTop)
+        {
+            BestIdx = i;
+            BestY   = y;
+            BestTop = y + Height;
+        }
+    }
+    if (BestIdx == m_Skyline.size())
+        return Region{};
+
+    const Region R{m_Skyline[BestIdx].x, BestY, Width, Height};
+
+    // Record gaps between the region and the segments below it
+    for (size_t j = BestIdx; j < m_Skyline.size() && m_Skyline[j].x < R.x + R.width; ++j)
+    {
+        const auto& Seg = m_Skyline[j];
+        if (Seg.y < R.y)
+        {
+            const auto x0 = std::max(Seg.x, R.x);
+            const auto x1 = std::min(Seg.x + Seg.width, R.x + R.width);
+            m_WasteRegions.emplace_back(x0, Seg.y, x1 - x0, R.y - Seg.y);
+        }
+    }
+
+    SetSkylineHeight(R.x, R.width, R.y + R.height);
+
+    return R;
+}
+
+void SkylineAtlasManager::SetSkylineHeight(Uint32 X, Uint32 Width, Uint32 Y)
+{
+    std::vector<Segment> NewSkyline;
+    NewSkyline.reserve(m_Skyline.size() + 2);
+
+    auto AddSegment = [&NewSkyline](Uint32 x, Uint32 y, Uint32 width) {
+        VERIFY_EXPR(width > 0);
+        if (!NewSkyline.empty() && NewSkyline.back().y == y)
+        {
+            VERIFY_EXPR(NewSkyline.back().x + NewSkyline.back().width == x);
+            NewSkyline.back().width += width;
+        }
+        else
+        {
+            NewSkyline.push_back({x, y, width});
+        }
+    };
+
+    bool Inserted = false;
+    for (const auto& Seg : m_Skyline)
+    {
+        const auto SegEnd = Seg.x + Seg.width;
+        // Part of the segment to the left of the range
+        if (Seg.x < X)
+            AddSegment(Seg.x, Seg.y, std::min(SegEnd, X) - Seg.x);
+
+        if (!Inserted && SegEnd > X)
+        {
+            AddSegment(X, Y, Width);
+            Inserted = true;
+        }
+
+        // Part of the segment to the right of the range
+        if (SegEnd > X + Width)
+        {
+            const auto x0 = std::max(Seg.x, X + Width);
+            AddSegment(x0, Seg.y, SegEnd - x0);
+        }
+    }
+    VERIFY_EXPR(Inserted);
+
+    m_Skyline.swap(NewSkyline);
+}
+
+bool SkylineAtlasManager::IsSkylineHeight(Uint32 X, Uint32 Width, Uint32 Y) const
+{
+    for (const auto& Seg : m_Skyline)
+    {
+        if (Seg.x + Seg.width <= X)
+            continue;
+        if (Seg.x >= X + Width)
+            break;
+        if (Seg.y != Y)
+            return false;
+    }
+    return true;
+}
+
+void SkylineAtlasManager::AddWasteRegion(const Region& NewRegion)
+{
+    std::vector<Region> PendingRegions{NewRegion};
+    while (!PendingRegions.empty())
+    {
+        auto R = PendingRegions.back();
+        PendingRegions.pop_back();
+
+        // Merge with the regions that share a full edge
+        for (size_t i = 0; i < m_WasteRegions.size();)
+        {
+            const auto& W = m_WasteRegions[i];
+            if (W.y == R.y && W.height == R.height && (W.x + W.width == R.x || R.x + R.width == W.x))
+            {
+                R = Region{std::min(W.x, R.x), R.y, W.width + R.width, R.height};
+            }
+            else if (W.x == R.x && W.width == R.width && (W.y + W.height == R.y || R.y + R.height == W.y))
+            {
+                R = Region{R.x, std::min(W.y, R.y), R.width, W.height + R.height};
+            }
+            else
+            {
+                ++i;
+                continue;
+            }
+
+            // Restart the search as the merged region may now share an edge with other regions
+            m_WasteRegions[i] = m_WasteRegions.back();
+            m_WasteRegions.pop_back();
+            i = 0;
+        }
+
+        if (IsSkylineHeight(R.x, R.width, R.y + R.height))
+        {
+            // The region lies directly under the skyline - lower the skyline
+            SetSkylineHeight(R.x, R.width, R.y);
+
+            // Lowering the skyline may expose other waste regions
+            for (size_t i = 0; i < m_WasteRegions.size();)
+            {
+                const auto& W = m_WasteRegions[i];
+                if (IsSkylineHeight(W.x, W.width, W.y + W.height))
+                {
+                    PendingRegions.push_back(W);
+                    m_WasteRegions[i] = m_WasteRegions.back();
+                    m_WasteRegions.pop_back();
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+        else
+        {
+            m_WasteRegions.push_back(R);
+        }
+    }
+}
+
+SkylineAtlasManager::Region SkylineAtlasManager::Allocate(Uint32 Width, Uint32 Height)
+{
+    if (Width == 0 || Height == 0 || Width > m_Width || Height > m_Height)
+        return Region{};
+
+    auto R = AllocateFromWaste(Width, Height);
+    if (R.IsEmpty())
+        R = AllocateFromSkyline(Width, Height);
+    if (R.IsEmpty())
+        return R;
+
+    VERIFY_EXPR(m_AllocatedRegions.find(R) == m_AllocatedRegions.end());
+    m_AllocatedRegions.insert(R);
+    m_AllocatedArea += Uint64{R.width} * Uint64{R.height};
+
+#if DILIGENT_DEBUG
+    DbgVerifyConsistency();
+#endif
+
+    return R;
+}
+
+void SkylineAtlasManager::Free(Region&& R)
+{
+    auto it = m_AllocatedRegions.find(R);
+    if (it == m_AllocatedRegions.end())
+    {
+        UNEXPECTED("Unable to find region [", R.x, ", ", R.x + R.width, ") x [", R.y, ", ", R.y + R.height, ") among allocated regions. Have you ever allocated it?");
+        return;
+    }
+    m_AllocatedRegions.erase(it);
+
+    VERIFY_EXPR(m_AllocatedArea >= Uint64{R.width} * Uint64{R.height});
+    m_AllocatedArea -= Uint64{R.width} * Uint64{R.height};
+
+    if (m_AllocatedRegions.empty())
+        Reset();
+    else
+        AddWasteRegion(R);
+
+#if DILIGENT_DEBUG
+    DbgVerifyConsistency();
+#endif
+
+    R = Region{};
+}
+
+Uint32 SkylineAtlasManager::GetFreeRegionCount() const
+{
+    Uint32 Count = static_cast<Uint32>(m_WasteRegions.size());
+    for (const auto& Seg : m_Skyline)
+    {
+        if (Seg.y < m_Height)
+            ++Count;
+    }
+    return Count;
+}
+
+Uint64 SkylineAtlasManager::GetLargestFreeRegionArea() const
+{
+    Uint64 MaxArea = 0;
+    for (const auto& W : m_WasteRegions)
+        MaxArea = std::max(MaxArea, Uint64{W.width} * Uint64{W.height});
+
+    // The largest rectangle above the skyline that rests on segment i
+    for (size_t i = 0; i < m_Skyline.size(); ++i)
+    {
+        const auto y = m_Skyline[i].y;
+
+        size_t First = i;
+        while (First > 0 && m_Skyline[First - 1].y <= y)
+            --First;
+        size_t Last = i;
+        while (Last + 1 < m_Skyline.size() && m_Skyline[Last + 1].y <= y)
+            ++Last;
+
+        const auto Width = m_Skyline[Last].x + m_Skyline[Last].width - m_Skyline[First].x;
+        MaxArea          = std::max(MaxArea, Uint64{Width} * Uint64{m_Height - y});
+    }
+
+    return MaxArea;
+}
+
+#if DILIGENT_DEBUG
+void SkylineAtlasManager::DbgVerifyConsistency() const
+{
+    VERIFY_EXPR(!m_Skyline.empty());
+    Uint32 x        = 0;
+    Uint64 FreeArea = 0;
+    for (size_t i = 0; i < m_Skyline.size(); ++i)
+    {
+        const auto& Seg = m_Skyline[i];
+        VERIFY(Seg.x == x, "Skyline segments must be contiguous");
+        VERIFY(Seg.width > 0, "Skyline segments must not be empty");
+        VERIFY(Seg.y <= m_Height, "Skyline segment is above the atlas top");
+        VERIFY(i == 0 || m_Skyline[i - 1].y != Seg.y, "Adjacent segments with the same height must be merged");
+        x += Seg.width;
+        FreeArea += Uint64{Seg.width} * Uint64{m_Height - Seg.y};
+    }
+    VERIFY(x == m_Width, "Skyline must cover the entire atlas width");
+
+    for (const auto& W : m_WasteRegions)
+    {
+        VERIFY_EXPR(!W.IsEmpty());
+        VERIFY_EXPR(W.x + W.width <= m_Width && W.y + W.height <= m_Height);
+        FreeArea += Uint64{W.width} * Uint64{W.height};
+    }
+
+    VERIFY(FreeArea + m_AllocatedArea == Uint64{m_Width} * Uint64{m_Height}, "Free and allocated regions must cover the entire atlas");
+}
+#endif
+
+} // namespace Diligent
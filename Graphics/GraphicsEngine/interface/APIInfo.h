@@ -30,7 +30,7 @@
 /// \file
 /// Diligent API information
 
-#define DILIGENT_API_VERSION 252009
+#define DILIGENT_API_VERSION 252016
 
 #include "../../../Primitives/interface/BasicTypes.h"
 
@@ -3741,12 +3741,38 @@ struct EngineVkCreateInfo DILIGENT_DERIVE(EngineCreateInfo)
 
     /// Size of the dynamic heap (the buffer that is used to suballocate
     /// memory for dynamic resources) shared by all contexts.
+    /// This is also the maximum size of a single dynamic allocation.
     Uint32 DynamicHeapSize                  DEFAULT_INITIALIZER(8 << 20);
 
+    /// Maximum total size of the dynamic heap.
+    /// When the dynamic heap is exhausted, the engine adds overflow buffers
+    /// of DynamicHeapSize bytes each until the total size reaches this value.
+    /// If this value is not greater than DynamicHeapSize, the heap never grows.
+    Uint32 DynamicHeapMaxSize               DEFAULT_INITIALIZER(128 << 20);
+
+    /// The number of frames an overflow dynamic heap buffer must remain
+    /// unused before it is released.
+    Uint32 DynamicHeapShrinkDelay           DEFAULT_INITIALIZER(120);
+
     /// Size of the memory chunk suballocated by immediate/deferred context from
     /// the global dynamic heap to perform lock-free dynamic suballocations
     Uint32 DynamicHeapPageSize              DEFAULT_INITIALIZER(256 << 10);
 
+    /// The maximum number of framebuffers kept in the cache that is used when
+    /// render targets are bound with IDeviceContext::SetRenderTargets().
+    /// When the limit is exceeded, least recently used framebuffers are released.
+    /// Zero means the cache is unbounded.
+    Uint32 FramebufferCacheSize             DEFAULT_INITIALIZER(1024);
+
+    /// The maximum number of implicit render passes kept in the cache that is used
+    /// by pipeline states and by IDeviceContext::SetRenderTargets().
+    /// Zero means the cache is unbounded.
+    Uint32 ImplicitRenderPassCacheSize      DEFAULT_INITIALIZER(256);
+
+    /// The number of frames a cached framebuffer or implicit render pass must remain
+    /// unused before it can be evicted from its cache. Must be at least 1.
+    Uint32 ObjectCacheEvictionDelay         DEFAULT_INITIALIZER(3);
+
     /// Query pool size for each query type.
     Uint32 QueryPoolSizes[QUERY_TYPE_NUM_TYPES]
 #if DILIGENT_CPP_INTERFACE
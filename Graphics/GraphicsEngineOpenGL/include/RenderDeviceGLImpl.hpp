@@ -40,6 +40,8 @@
 namespace Diligent
 {
 
+class HLSL2GLSLConversionCache;
+
 /// Render device implementation in OpenGL backend.
 // RenderDeviceGLESImpl is inherited from RenderDeviceGLImpl
 class RenderDeviceGLImpl : public RenderDeviceBase<EngineGLImplTraits>
@@ -232,6 +234,10 @@ protected:
 
     std::unique_ptr<TexRegionRender> m_pTexRegionRender;
 
+    // Cache of HLSL to GLSL conversion results, so that shaders that have already been
+    // converted are not converted again. Null if HLSL support is disabled.
+    std::shared_ptr<HLSL2GLSLConversionCache> m_pHLSL2GLSLCache;
+
 private:
     virtual void TestTextureFormat(TEXTURE_FORMAT TexFormat) override final;
     bool         CheckExtension(const Char* ExtensionString) const;
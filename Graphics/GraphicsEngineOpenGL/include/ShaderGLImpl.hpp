@@ -35,6 +35,8 @@
 namespace Diligent
 {
 
+class HLSL2GLSLConversionCache;
+
 /// Shader object implementation in OpenGL backend.
 class ShaderGLImpl final : public ShaderBase<EngineGLImplTraits>
 {
@@ -48,6 +50,9 @@ public:
     {
         const RenderDeviceInfo&    DeviceInfo;
         const GraphicsAdapterInfo& AdapterInfo;
+
+        /// Optional cache of HLSL to GLSL conversion results.
+        HLSL2GLSLConversionCache* pConversionCache = nullptr;
     };
 
     ShaderGLImpl(IReferenceCounters*     pRefCounters,
@@ -53,6 +53,10 @@
 #include "EngineMemory.h"
 #include "StringTools.hpp"
 
+#if !DILIGENT_NO_HLSL
+#    include "HLSL2GLSLConverterImpl.hpp"
+#endif
+
 namespace Diligent
 {
 
@@ -179,6 +183,10 @@ RenderDeviceGLImpl::RenderDeviceGLImpl(IReferenceCounters*       pRefCounters,
 {
     VerifyEngineGLCreateInfo(EngineCI);
 
+#if !DILIGENT_NO_HLSL
+    m_pHLSL2GLSLCache = std::make_shared<HLSL2GLSLConversionCache>();
+#endif
+
     VERIFY(EngineCI.NumDeferredContexts == 0, "EngineCI.NumDeferredContexts > 0 should've been caught by CreateDeviceAndSwapChainGL() or AttachToActiveGLContext()");
 
     GLint NumExtensions = 0;
@@ -307,7 +315,8 @@ void RenderDeviceGLImpl::CreateShader(const ShaderCreateInfo& ShaderCreateInfo,
 {
     const ShaderGLImpl::CreateInfo GLShaderCI{
         GetDeviceInfo(),
-        GetAdapterInfo() //
+        GetAdapterInfo(),
+        m_pHLSL2GLSLCache.get(),
     };
     CreateShaderImpl(ppShader, ShaderCreateInfo, GLShaderCI, bIsDeviceInternal);
 }
@@ -94,7 +94,8 @@ ShaderGLImpl::ShaderGLImpl(IReferenceCounters*     pRefCounters,
         // platform definitions, user-provided shader macros, etc.
         m_GLSLSourceString = BuildGLSLSourceString(
             ShaderCI, DeviceInfo, AdapterInfo, TargetGLSLCompiler::driver,
-            (DeviceInfo.NDC.MinZ >= 0 ? NDCDefine : nullptr));
+            (DeviceInfo.NDC.MinZ >= 0 ? NDCDefine : nullptr),
+            GLShaderCI.pConversionCache);
 
         AppendShaderSourceLanguageDefinition(m_GLSLSourceString, ShaderCI.SourceLanguage);
     }
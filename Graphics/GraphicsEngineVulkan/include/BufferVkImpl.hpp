@@ -92,6 +92,33 @@ public:
     /// Implementation of IBufferVk::GetVkBuffer().
     virtual VkBuffer DILIGENT_CALL_TYPE GetVkBuffer() const override final;
 
+    // Returns the Vulkan buffer that contains the buffer data in the given context.
+    // For dynamic buffers without a backing resource, this is the dynamic heap buffer
+    // that holds the current allocation, which may be an overflow buffer rather than
+    // the primary buffer returned by GetVkBuffer(). The offset returned by GetDynamicOffset()
+    // is relative to the start of this buffer.
+    VkBuffer GetVkBuffer(DeviceContextIndex CtxId) const
+    {
+        if (m_VulkanBuffer != VK_NULL_HANDLE)
+        {
+            return m_VulkanBuffer;
+        }
+        else
+        {
+            VERIFY(m_Desc.Usage == USAGE_DYNAMIC, "Dynamic buffer is expected");
+            VERIFY_EXPR(!m_DynamicData.empty());
+            const auto& DynAlloc = m_DynamicData[CtxId];
+            return DynAlloc.vkBuffer != VK_NULL_HANDLE ? DynAlloc.vkBuffer : GetVkBuffer();
+        }
+    }
+
+    // Returns the dynamic heap chunk that holds the current allocation of a dynamic buffer
+    // without a backing resource in the given context, or null if there is no such allocation.
+    const VulkanDynamicMemoryChunk* GetDynamicChunk(DeviceContextIndex CtxId) const
+    {
+        return m_VulkanBuffer == VK_NULL_HANDLE && !m_DynamicData.empty() ? m_DynamicData[CtxId].pChunk : nullptr;
+    }
+
     /// Implementation of IBuffer::GetNativeHandle() in Vulkan backend.
     virtual Uint64 DILIGENT_CALL_TYPE GetNativeHandle() override final { return BitCast<Uint64>(GetVkBuffer()); }
 
@@ -126,6 +153,20 @@ public:
         return reinterpret_cast<Uint8*>(m_MemoryAllocation.Page->GetCPUMemory()) + m_BufferMemoryAlignedOffset;
     }
 
+    // Relocatable buffers can be moved to other memory by IDeviceContextVk::DefragmentMemory().
+    // These are device buffers used by a single immediate context whose Vulkan handle is never
+    // stored in descriptor sets or views: vertex, index and indirect argument buffers.
+    bool IsRelocatable() const { return m_IsRelocatable; }
+
+    const VulkanUtilities::VulkanMemoryPage* GetMemoryPage() const { return m_MemoryAllocation.Page; }
+    VkDeviceSize                             GetMemoryAllocationSize() const { return m_MemoryAllocation.Size; }
+
+    // Creates a new Vulkan buffer in another memory page, records the command to copy the
+    // contents into CmdBuffer and replaces the buffer handle and memory. The old handle and
+    // memory are moved into the release queue.
+    // Returns false if there is no space for the buffer in other pages.
+    bool Relocate(VulkanUtilities::VulkanCommandBuffer& CmdBuffer);
+
 private:
     friend class DeviceContextVkImpl;
 
@@ -135,6 +176,7 @@ private:
 
     Uint32       m_DynamicOffsetAlignment    = 0;
     VkDeviceSize m_BufferMemoryAlignedOffset = 0;
+    bool         m_IsRelocatable             = false;
 
     // TODO (assiduous): move dynamic allocations to device context.
     static constexpr size_t CacheLineSize = 64;
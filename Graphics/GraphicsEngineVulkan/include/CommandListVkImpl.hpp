@@ -33,6 +33,7 @@
 #include "EngineVkImplTraits.hpp"
 #include "VulkanUtilities/VulkanHeaders.h"
 #include "CommandListBase.hpp"
+#include "VulkanUtilities/VulkanCommandBufferPool.hpp"
 
 namespace Diligent
 {
@@ -43,16 +44,29 @@ class CommandListVkImpl final : public CommandListBase<EngineVkImplTraits>
 public:
     using TCommandListBase = CommandListBase<EngineVkImplTraits>;
 
-    CommandListVkImpl(IReferenceCounters*  pRefCounters,
-                      RenderDeviceVkImpl*  pDevice,
-                      DeviceContextVkImpl* pDeferredCtx,
-                      VkCommandBuffer      vkCmdBuff) :
+    /// Render pass state inherited by a command list recorded into a secondary command buffer
+    struct RenderPassBundleInfo
+    {
+        VkRenderPass  vkRenderPass  = VK_NULL_HANDLE;
+        VkFramebuffer vkFramebuffer = VK_NULL_HANDLE;
+        Uint32        SubpassIndex  = 0;
+    };
+
+    CommandListVkImpl(IReferenceCounters*                       pRefCounters,
+                      RenderDeviceVkImpl*                       pDevice,
+                      DeviceContextVkImpl*                      pDeferredCtx,
+                      VkCommandBuffer                           vkCmdBuff,
+                      VulkanUtilities::VulkanCommandBufferPool* pCmdPool,
+                      const RenderPassBundleInfo&               BundleInfo = {}) :
         // clang-format off
         TCommandListBase {pRefCounters, pDevice, pDeferredCtx},
         m_pDeferredCtx   {pDeferredCtx},
-        m_vkCmdBuff      {vkCmdBuff   }
+        m_vkCmdBuff      {vkCmdBuff   },
+        m_pCmdPool       {pCmdPool    },
+        m_BundleInfo     {BundleInfo  }
     // clang-format on
     {
+        VERIFY_EXPR(m_pCmdPool != nullptr);
     }
 
     ~CommandListVkImpl()
@@ -60,16 +74,30 @@ public:
         VERIFY(m_vkCmdBuff == VK_NULL_HANDLE && !m_pDeferredCtx, "Destroying command list that was never executed");
     }
 
-    void Close(RefCntAutoPtr<IDeviceContext>& outDeferredCtx, VkCommandBuffer& outVkCmdBuff)
+    void Close(RefCntAutoPtr<IDeviceContext>&             outDeferredCtx,
+               VkCommandBuffer&                           outVkCmdBuff,
+               VulkanUtilities::VulkanCommandBufferPool*& outCmdPool)
     {
         outVkCmdBuff   = m_vkCmdBuff;
         outDeferredCtx = std::move(m_pDeferredCtx);
+        outCmdPool     = m_pCmdPool;
         m_vkCmdBuff    = VK_NULL_HANDLE;
     }
 
+    /// Returns true if the command list was recorded into a secondary command buffer
+    /// by IDeviceContextVk::BeginRenderPassBundle().
+    bool IsRenderPassBundle() const { return m_BundleInfo.vkRenderPass != VK_NULL_HANDLE; }
+
+    const RenderPassBundleInfo& GetRenderPassBundleInfo() const { return m_BundleInfo; }
+
 private:
     RefCntAutoPtr<IDeviceContext> m_pDeferredCtx;
     VkCommandBuffer               m_vkCmdBuff;
+
+    // Pool the command buffer must be returned to
+    VulkanUtilities::VulkanCommandBufferPool* const m_pCmdPool;
+
+    const RenderPassBundleInfo m_BundleInfo;
 };
 
 } // namespace Diligent
@@ -37,10 +37,12 @@
 #include "EngineVkImplTraits.hpp"
 #include "ObjectBase.hpp"
 #include "FenceVkImpl.hpp"
+#include "LockFreeBoundedQueue.hpp"
 
 #include "VulkanUtilities/VulkanHeaders.h"
 #include "VulkanUtilities/VulkanLogicalDevice.hpp"
 #include "VulkanUtilities/VulkanSyncObjectManager.hpp"
+#include "VulkanUtilities/VulkanSubmitBatch.hpp"
 
 
 namespace Diligent
@@ -52,11 +54,17 @@ private:
     friend class CommandQueueVkImpl;
     SyncPointVk(SoftwareQueueIndex                        CommandQueueId,
                 Uint32                                    NumContexts,
-                VulkanUtilities::VulkanSyncObjectManager& SyncObjectMngr,
-                VkDevice                                  LogicalDevice,
-                Uint64                                    dbgValue);
+                VulkanUtilities::VulkanSyncObjectManager& SyncObjectMngr);
 
-    void GetSemaphores(std::vector<VkSemaphore>& Semaphores);
+    // Writes non-null semaphores to pSemaphores, which must have space for NumContexts elements,
+    // and returns the number of semaphores written.
+    Uint32 GetSemaphores(VkSemaphore* pSemaphores) const;
+
+    Uint32 GetNumContexts() const { return m_NumSemaphores; }
+
+#ifdef DILIGENT_DEBUG
+    void SetDebugNames(VkDevice LogicalDevice, Uint64 Value);
+#endif
 
     static constexpr size_t SizeOf(Uint32 NumContexts)
     {
@@ -124,6 +132,20 @@ public:
     /// Implementation of ICommandQueueVk::Submit().
     virtual Uint64 DILIGENT_CALL_TYPE Submit(const VkSubmitInfo& SubmitInfo) override final;
 
+    /// Submits the batch or, if DeferSubmission is true, adds it to the pending batches.
+
+    /// Pending batches are submitted by SubmitPendingBatches() or by the next operation that
+    /// submits work to the queue, with a single vkQueueSubmit call and in the order they were added.
+    /// The fence value returned for a pending batch is reserved right away and is signaled
+    /// once the batch has been executed, so fence values keep increasing in submission order.
+    Uint64 Submit(const VkSubmitInfo& SubmitInfo, bool DeferSubmission);
+
+    /// Submits all pending batches, see Submit(const VkSubmitInfo&, bool).
+    void SubmitPendingBatches();
+
+    /// Returns the total number of vkQueueSubmit calls performed by the queue.
+    Uint64 GetSubmitCount() const { return m_SubmitCount.load(); }
+
     /// Implementation of ICommandQueueVk::Present().
     virtual VkResult DILIGENT_CALL_TYPE Present(const VkPresentInfoKHR& PresentInfo) override final;
 
@@ -156,10 +178,59 @@ public:
     }
 
 private:
-    SyncPointVkPtr CreateSyncPoint(Uint64 dbgValue);
+    SyncPointVkPtr CreateSyncPoint();
+
+    // Assigns the fence value to the sync point submitted to the queue and makes it the last sync point.
+    // Must be called while m_QueueMutex is locked.
+    void OnSyncPointSubmitted(Uint64 FenceValue, SyncPointVkPtr&& SyncPoint);
+
+    // Creates the sync point for the pending batches if there are any. Sync point creation
+    // may allocate memory, so it is done before m_QueueMutex is locked.
+    SyncPointVkPtr PreparePendingBatchesSyncPoint();
+
+    // Submits pending batches, if there are any. Must be called while m_QueueMutex is locked.
+    // SyncPoint should be prepared by PreparePendingBatchesSyncPoint(). If it is not used, the
+    // caller releases it after unlocking the mutex.
+    void SubmitPendingBatchesLocked(SyncPointVkPtr& SyncPoint);
 
     void InternalSignalSemaphore(VkSemaphore vkTimelineSemaphore, Uint64 Value);
 
+    // Pre-allocated ring of memory blocks for sync points. Every block also has space for the
+    // shared_ptr control block, so creating a sync point does not allocate memory or take a lock
+    // unless all blocks are in use. The pool is owned by sync points as well as by the queue,
+    // because sync points referenced by fences may outlive the queue.
+    class SyncPointPool
+    {
+    public:
+        SyncPointPool(size_t SyncPointSize, size_t NumBlocks);
+        ~SyncPointPool();
+
+        // clang-format off
+        SyncPointPool             (const SyncPointPool&)  = delete;
+        SyncPointPool& operator = (const SyncPointPool&)  = delete;
+        SyncPointPool             (      SyncPointPool&&) = delete;
+        SyncPointPool& operator = (      SyncPointPool&&) = delete;
+        // clang-format on
+
+        static constexpr size_t ControlBlockSize = 64;
+
+        void* Allocate();
+        void  Free(void* pBlock);
+
+        size_t GetSyncPointSize() const { return m_SyncPointSize; }
+
+    private:
+        const size_t m_SyncPointSize;
+        const size_t m_BlockSize;
+        const size_t m_NumBlocks;
+        Uint8*       m_pMemory = nullptr;
+
+        Threading::LockFreeBoundedQueue<void*> m_FreeBlocks;
+    };
+
+    template <typename T>
+    class SyncPointControlBlockAllocator;
+
     std::shared_ptr<VulkanUtilities::VulkanLogicalDevice> m_LogicalDevice;
 
     const VkQueue            m_VkQueue;
@@ -180,8 +251,16 @@ private:
     // Protects access to the m_VkQueue internal data.
     std::mutex m_QueueMutex;
 
-    // Array used to merge semaphores from SubmitInfo and from SyncPointVk
-    std::vector<VkSemaphore> m_TempSignalSemaphores;
+    // Batches whose submission has been deferred, protected by m_QueueMutex
+    VulkanUtilities::VulkanSubmitBatch m_PendingBatches;
+
+    // The last fence value reserved for a pending batch, or 0 if there are no pending batches.
+    // Empty batches are not stored, but their fence values still need to be signaled.
+    // Only modified while m_QueueMutex is locked, but may be read without locking.
+    std::atomic<Uint64> m_LastPendingFenceValue{0};
+
+    // The number of vkQueueSubmit calls
+    std::atomic<Uint64> m_SubmitCount{0};
 
     // Protects access to the m_LastSyncPoint
     Threading::SpinLock m_LastSyncPointLock;
@@ -190,7 +269,7 @@ private:
     SyncPointVkPtr m_LastSyncPoint;
 
     std::shared_ptr<VulkanUtilities::VulkanSyncObjectManager> m_SyncObjectManager;
-    FixedBlockMemoryAllocator                                 m_SyncPointAllocator;
+    std::shared_ptr<SyncPointPool>                            m_SyncPointPool;
 };
 
 } // namespace Diligent
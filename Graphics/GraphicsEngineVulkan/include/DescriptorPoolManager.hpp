@@ -34,7 +34,10 @@
 #include <deque>
 #include <mutex>
 #include <atomic>
+#include <array>
+#include <unordered_map>
 
+#include "RenderDeviceVk.h"
 #include "VulkanUtilities/VulkanObjectWrappers.hpp"
 
 namespace Diligent
@@ -45,18 +48,21 @@ class RenderDeviceVkImpl;
 
 // This class manages descriptor set allocation.
 // The class destructor calls DescriptorSetAllocator::FreeDescriptorSet() that moves
-// the set into the release queue.
-// sizeof(DescriptorSetAllocation) == 32 (x64)
+// the set into the release queue. Once the GPU is done with the set, it is returned
+// to the allocator's free list for its layout and may be handed out again.
+// sizeof(DescriptorSetAllocation) == 40 (x64)
 class DescriptorSetAllocation
 {
 public:
     // clang-format off
     DescriptorSetAllocation(VkDescriptorSet         _Set,
                             VkDescriptorPool        _Pool,
+                            VkDescriptorSetLayout   _Layout,
                             Uint64                  _CmdQueueMask,
                             DescriptorSetAllocator& _DescrSetAllocator)noexcept :
         Set              {_Set               },
         Pool             {_Pool              },
+        Layout           {_Layout            },
         CmdQueueMask     {_CmdQueueMask      },
         DescrSetAllocator{&_DescrSetAllocator}
     {}
@@ -68,6 +74,7 @@ public:
     DescriptorSetAllocation(DescriptorSetAllocation&& rhs)noexcept :
         Set              {rhs.Set              },
         Pool             {rhs.Pool             },
+        Layout           {rhs.Layout           },
         CmdQueueMask     {rhs.CmdQueueMask     },
         DescrSetAllocator{rhs.DescrSetAllocator}
     {
@@ -82,6 +89,7 @@ public:
         Set               = rhs.Set;
         CmdQueueMask      = rhs.CmdQueueMask;
         Pool              = rhs.Pool;
+        Layout            = rhs.Layout;
         DescrSetAllocator = rhs.DescrSetAllocator;
 
         rhs.Reset();
@@ -98,6 +106,7 @@ public:
     {
         Set               = VK_NULL_HANDLE;
         Pool              = VK_NULL_HANDLE;
+        Layout            = VK_NULL_HANDLE;
         CmdQueueMask      = 0;
         DescrSetAllocator = nullptr;
     }
@@ -114,6 +123,7 @@ public:
 private:
     VkDescriptorSet         Set               = VK_NULL_HANDLE;
     VkDescriptorPool        Pool              = VK_NULL_HANDLE;
+    VkDescriptorSetLayout   Layout            = VK_NULL_HANDLE;
     Uint64                  CmdQueueMask      = 0;
     DescriptorSetAllocator* DescrSetAllocator = nullptr;
 };
@@ -183,7 +193,30 @@ private:
 
 
 // The class allocates descriptor sets from the main descriptor pool.
-// Descriptors sets can be released and returned to the pool
+// Descriptors sets can be released and returned to the pool.
+//
+// Released sets are not freed back to the pool. When the GPU is done with a set,
+// it is added to a free list keyed by its descriptor set layout, and subsequent
+// allocations with the same layout reuse it without touching the pools.
+// Free lists are split into a fixed number of stripes, each protected by its own mutex.
+// Released sets are distributed between the stripes round-robin. Every thread has a home
+// stripe (threads are assigned to stripes in the order of their first allocation, so
+// several threads may share one) that it searches first, waiting for its mutex if needed.
+// Other stripes are only searched if their mutexes are not locked. Threads creating SRBs
+// simultaneously thus mostly lock different stripes and do not contend on the pool mutex.
+//
+//             Allocate()                          FreeDescriptorSet()
+//                 |                                        |
+//                 V                                        V
+//    | Stripe[home] | Stripe[...] |  ...  |       Release queue
+//    | Layout -> {Set, Pool}, ...  |              (after GPU completion)
+//                 |                                        |
+//     free list   | empty                                  |
+//     is empty    V                                        V
+//         | Pool[0] | Pool[1] | ... |            Stripe[round robin]
+//
+// Recycled sets of a layout are freed when the layout itself is released through
+// ReleaseSetLayout(), or when all pools are exhausted.
 class DescriptorSetAllocator : public DescriptorPoolManager
 {
 public:
@@ -213,6 +246,13 @@ public:
 
     DescriptorSetAllocation Allocate(Uint64 CommandQueueMask, VkDescriptorSetLayout SetLayout, const char* DebugName = "");
 
+    // Moves the descriptor set layout into the release queue. When the layout is
+    // destroyed, all recycled descriptor sets with this layout are freed first.
+    // All sets allocated with the layout must be released before this method is called.
+    void ReleaseSetLayout(VulkanUtilities::DescriptorSetLayoutWrapper&& Layout, Uint64 QueueMask);
+
+    void GetStats(DescriptorSetAllocatorStatsVk& Stats) const;
+
 #ifdef DILIGENT_DEVELOPMENT
     Int32 GetAllocatedDescriptorSetCounter() const
     {
@@ -221,7 +261,37 @@ public:
 #endif
 
 private:
-    void FreeDescriptorSet(VkDescriptorSet Set, VkDescriptorPool Pool, Uint64 QueueMask);
+    void FreeDescriptorSet(VkDescriptorSet Set, VkDescriptorPool Pool, VkDescriptorSetLayout Layout, Uint64 QueueMask);
+
+    void RecycleDescriptorSet(VkDescriptorSet Set, VkDescriptorPool Pool, VkDescriptorSetLayout Layout);
+
+    // Frees recycled sets with the given layout, or all recycled sets if Layout is VK_NULL_HANDLE.
+    // Returns the number of freed sets. m_Mutex must be locked by the caller.
+    size_t FreeRecycledSets(VkDescriptorSetLayout Layout);
+
+    struct RecycledSet
+    {
+        VkDescriptorSet  Set;
+        VkDescriptorPool Pool;
+    };
+
+    static constexpr size_t NumStripes = 8;
+    struct FreeListStripe
+    {
+        std::mutex                                                           Mtx;
+        std::unordered_map<VkDescriptorSetLayout, std::vector<RecycledSet>> FreeLists;
+    };
+    std::array<FreeListStripe, NumStripes> m_Stripes;
+
+    std::atomic<Uint32> m_NextRecycleStripe{0};
+
+    std::atomic<Uint64> m_AllocationCount{0};
+    std::atomic<Uint64> m_RecycledCount{0};
+    std::atomic<Uint64> m_PoolAllocationCount{0};
+    std::atomic<Uint64> m_PoolScanCount{0};
+    std::atomic<Uint64> m_NewPoolCount{0};
+    std::atomic<Uint64> m_ContentionCount{0};
+    std::atomic<Uint64> m_CachedSetCount{0};
 
 #ifdef DILIGENT_DEVELOPMENT
     std::atomic<Int32> m_AllocatedSetCounter;
@@ -318,6 +318,30 @@ public:
     /// Implementation of IDeviceContextVk::GetVkCommandBuffer().
     virtual VkCommandBuffer DILIGENT_CALL_TYPE GetVkCommandBuffer() override final;
 
+    /// Implementation of IDeviceContextVk::DefragmentMemory().
+    virtual void DILIGENT_CALL_TYPE DefragmentMemory(const DefragmentMemoryAttribsVk& Attribs, DefragmentMemoryStatsVk* pStats) override final;
+
+    /// Implementation of IDeviceContextVk::BeginRenderPassBundle().
+    virtual void DILIGENT_CALL_TYPE BeginRenderPassBundle(const RenderPassBundleAttribsVk& Attribs) override final;
+
+    /// Implementation of IDeviceContextVk::BeginRenderPassWithBundles().
+    virtual void DILIGENT_CALL_TYPE BeginRenderPassWithBundles(const BeginRenderPassAttribs& Attribs) override final;
+
+    /// Implementation of IDeviceContextVk::NextSubpassWithBundles().
+    virtual void DILIGENT_CALL_TYPE NextSubpassWithBundles() override final;
+
+    /// Implementation of IDeviceContextVk::ExecuteRenderPassBundles().
+    virtual void DILIGENT_CALL_TYPE ExecuteRenderPassBundles(Uint32 NumBundles, ICommandList* const* ppBundles) override final;
+
+    /// Implementation of IDeviceContextVk::EnableSubmitBatching().
+    virtual void DILIGENT_CALL_TYPE EnableSubmitBatching(bool Enable) override final;
+
+    /// Implementation of IDeviceContextVk::SubmitBatchedCommands().
+    virtual void DILIGENT_CALL_TYPE SubmitBatchedCommands() override final;
+
+    /// Implementation of IDeviceContextVk::GetSubmitStats().
+    virtual const SubmitStatsVk& DILIGENT_CALL_TYPE GetSubmitStats() const override final { return m_LastFrameSubmitStats; }
+
     // Transitions BLAS state from OldState to NewState, and optionally updates internal state.
     // If OldState == RESOURCE_STATE_UNKNOWN, internal BLAS state is used as old state.
     void TransitionBLASState(BottomLevelASVkImpl& BLAS,
@@ -451,12 +475,16 @@ private:
         }
     }
 
-    inline void DisposeVkCmdBuffer(SoftwareQueueIndex CmdQueue, VkCommandBuffer vkCmdBuff, Uint64 FenceValue);
+    inline void DisposeVkCmdBuffer(SoftwareQueueIndex                        CmdQueue,
+                                   VkCommandBuffer                           vkCmdBuff,
+                                   VulkanUtilities::VulkanCommandBufferPool& CmdPool,
+                                   Uint64                                    FenceValue);
     inline void DisposeCurrentCmdBuffer(SoftwareQueueIndex CmdQueue, Uint64 FenceValue);
 
     void CopyBufferToTexture(VkBuffer                       vkSrcBuffer,
                              Uint64                         SrcBufferOffset,
                              Uint32                         SrcBufferRowStrideInTexels,
+                             Uint32                         SrcBufferImageHeightInTexels,
                              TextureVkImpl&                 DstTextureVk,
                              const Box&                     DstRegion,
                              Uint32                         DstMipLevel,
@@ -484,6 +512,11 @@ private:
 
     void PrepareCommandPool(SoftwareQueueIndex CommandQueueId);
 
+    VulkanUtilities::VulkanCommandBufferPool& GetSecondaryCommandPool(HardwareQueueIndex QueueFamilyIndex);
+
+    void BeginRenderPass(const BeginRenderPassAttribs& Attribs, VkSubpassContents Contents);
+    void NextSubpass(VkSubpassContents Contents);
+
     void ChooseRenderPassAndFramebuffer();
 
     VulkanUtilities::VulkanCommandBuffer m_CommandBuffer;
@@ -541,6 +574,12 @@ private:
     __forceinline ResourceBindInfo& GetBindInfo(PIPELINE_TYPE Type);
 
     __forceinline void CommitDescriptorSets(ResourceBindInfo& BindInfo, Uint32 CommitSRBMask);
+    // Replaces descriptor sets of the signature SignIdx indicated by OverflowSetMask with the sets
+    // that reference dynamic buffers allocated from the dynamic heap overflow buffers.
+    void CommitOverflowDescriptorSets(Uint32                       SignIdx,
+                                      const ShaderResourceCacheVk& ResourceCache,
+                                      Uint32                       OverflowSetMask,
+                                      VkDescriptorSet*             pSets);
 #ifdef DILIGENT_DEVELOPMENT
     void DvpValidateCommittedShaderResources(ResourceBindInfo& BindInfo);
 #endif
@@ -615,6 +654,32 @@ private:
     // Command pool for the family for which we are recording commands
     VulkanUtilities::VulkanCommandBufferPool* m_CmdPool = nullptr;
 
+    // Secondary command buffer pools for every queue family, allocated when the first render pass bundle is recorded
+    std::unique_ptr<std::unique_ptr<VulkanUtilities::VulkanCommandBufferPool>[]> m_QueueFamilySecondaryCmdPools;
+    // Pool of the secondary command buffer of the render pass bundle being recorded, or null
+    VulkanUtilities::VulkanCommandBufferPool* m_pBundleCmdPool = nullptr;
+
+    // Contents of the current subpass of the active render pass
+    VkSubpassContents m_vkSubpassContents = VK_SUBPASS_CONTENTS_INLINE;
+
+    // Render pass bundles executed by this context that will be disposed by the next Flush()
+    struct PendingRenderPassBundle
+    {
+        RefCntAutoPtr<IDeviceContext>             pDeferredCtx;
+        VkCommandBuffer                           vkCmdBuff = VK_NULL_HANDLE;
+        VulkanUtilities::VulkanCommandBufferPool* pCmdPool  = nullptr;
+    };
+    std::vector<PendingRenderPassBundle> m_PendingRenderPassBundles;
+
+    // Whether Flush() adds command buffers to pending batches of the command queue
+    bool m_SubmitBatchingEnabled = false;
+
+    // Submit statistics of the current and the last finished frames
+    SubmitStatsVk m_SubmitStats;
+    SubmitStatsVk m_LastFrameSubmitStats;
+    // The number of queue submits when the current frame started
+    Uint64 m_FrameStartSubmitCount = 0;
+
     VulkanUploadHeap              m_UploadHeap;
     VulkanDynamicHeap             m_DynamicHeap;
     DynamicDescriptorSetAllocator m_DynamicDescrSetAllocator;
@@ -31,8 +31,12 @@
 /// Declaration of Diligent::FramebufferCache class
 
 #include <unordered_map>
+#include <list>
+#include <array>
+#include <atomic>
 #include <mutex>
 
+#include "RenderDeviceVk.h"
 #include "VulkanUtilities/VulkanObjectWrappers.hpp"
 
 namespace Diligent
@@ -42,9 +46,9 @@ class RenderDeviceVkImpl;
 class FramebufferCache
 {
 public:
-    FramebufferCache(RenderDeviceVkImpl& DeviceVKImpl) :
-        m_DeviceVk{DeviceVKImpl}
-    {}
+    // MaxSize is the maximum total number of framebuffers kept in the cache (0 means unlimited).
+    // A framebuffer can only be evicted when it has not been used for EvictionDelay frames.
+    FramebufferCache(RenderDeviceVkImpl& DeviceVKImpl, Uint32 MaxSize, Uint32 EvictionDelay);
 
     // clang-format off
     FramebufferCache             (const FramebufferCache&) = delete;
@@ -76,9 +80,12 @@ public:
     void          OnDestroyImageView(VkImageView ImgView);
     void          OnDestroyRenderPass(VkRenderPass Pass);
 
-private:
-    RenderDeviceVkImpl& m_DeviceVk;
+    // Called by device contexts when they finish the frame.
+    void OnFrameFinished(Uint64 FrameNumber);
+
+    void GetStats(ObjectCacheStatsVk& Stats) const;
 
+private:
     struct FramebufferCacheKeyHash
     {
         std::size_t operator()(const FramebufferCacheKey& Key) const
@@ -87,11 +94,64 @@ private:
         }
     };
 
-    std::mutex                                                                                            m_Mutex;
-    std::unordered_map<FramebufferCacheKey, VulkanUtilities::FramebufferWrapper, FramebufferCacheKeyHash> m_Cache;
+    struct CacheEntry
+    {
+        VulkanUtilities::FramebufferWrapper Framebuffer;
+
+        Uint64 LastUsedFrame = 0;
+
+        std::list<FramebufferCacheKey>::iterator LRUIt;
+    };
+    using CacheMapType = std::unordered_map<FramebufferCacheKey, CacheEntry, FramebufferCacheKeyHash>;
+
+    // The cache is split into shards selected by the key hash, so that contexts
+    // rendering into different framebuffers rarely contend for the same mutex.
+    struct Shard
+    {
+        mutable std::mutex Mtx;
+
+        CacheMapType Cache;
+
+        // Keys of the least recently used framebuffers are at the back of the list
+        std::list<FramebufferCacheKey> LRUList;
+
+        std::unordered_multimap<VkImageView, FramebufferCacheKey>  ViewToKeyMap;
+        std::unordered_multimap<VkRenderPass, FramebufferCacheKey> RenderPassToKeyMap;
+
+        Uint64 NumHits      = 0;
+        Uint64 NumMisses    = 0;
+        Uint64 NumEvictions = 0;
+    };
+    static constexpr size_t NumShards = 8;
+
+    Shard& GetShard(const FramebufferCacheKey& Key)
+    {
+        // Vulkan handles are aligned, so the low bits of the key hash are poorly
+        // distributed. Mix the hash before selecting the shard.
+        const auto Hash = static_cast<Uint64>(Key.GetHash()) * Uint64{0x9E3779B97F4A7C15};
+        return m_Shards[(Hash >> 32) % NumShards];
+    }
+
+    // Releases the framebuffer and removes all references to its key.
+    // Shard.Mtx must be locked.
+    void RemoveEntry(Shard& Shard, CacheMapType::iterator it);
+
+    // Evicts the least recently used framebuffers of the shard that have not been used
+    // for m_EvictionDelay frames until the total number of entries fits into m_MaxSize.
+    // Shard.Mtx must be locked.
+    void EvictStaleEntries(Shard& Shard);
+
+    RenderDeviceVkImpl& m_DeviceVk;
+
+    const Uint32 m_MaxSize;
+    const Uint32 m_EvictionDelay;
+
+    std::atomic<Uint64> m_CurrentFrame{0};
+
+    // The total number of entries in all shards
+    std::atomic<Uint32> m_NumEntries{0};
 
-    std::unordered_multimap<VkImageView, FramebufferCacheKey>  m_ViewToKeyMap;
-    std::unordered_multimap<VkRenderPass, FramebufferCacheKey> m_RenderPassToKeyMap;
+    std::array<Shard, NumShards> m_Shards;
 };
 
 } // namespace Diligent
@@ -162,6 +162,15 @@ public:
     void CommitDynamicResources(const ShaderResourceCacheVk& ResourceCache,
                                 VkDescriptorSet              vkDynamicDescriptorSet) const;
 
+    // Commits all resources of the descriptor set SetId from ResourceCache to vkDescriptorSet.
+    // Descriptors of dynamic buffers whose allocations in the context CtxId reside in overflow
+    // buffers of DynamicHeap reference these buffers instead of the primary dynamic heap buffer.
+    void CommitOverflowDescriptorSet(const ShaderResourceCacheVk& ResourceCache,
+                                     DESCRIPTOR_SET_ID            SetId,
+                                     VkDescriptorSet              vkDescriptorSet,
+                                     const VulkanDynamicHeap&     DynamicHeap,
+                                     DeviceContextIndex           CtxId) const;
+
 #ifdef DILIGENT_DEVELOPMENT
     /// Verifies committed resource using the SPIRV resource attributes from the PSO.
     bool DvpValidateCommittedResource(const DeviceContextVkImpl*        pDeviceCtx,
@@ -206,6 +215,12 @@ private:
 
     void CreateSetLayouts(bool IsSerialized);
 
+    void WriteDescriptorSet(const ShaderResourceCacheVk& ResourceCache,
+                            DESCRIPTOR_SET_ID            SetId,
+                            VkDescriptorSet              vkDescriptorSet,
+                            const VulkanDynamicHeap*     pDynamicHeap,
+                            DeviceContextIndex           CtxId) const;
+
     static inline CACHE_GROUP       GetResourceCacheGroup(const PipelineResourceDesc& Res);
     static inline DESCRIPTOR_SET_ID VarTypeToDescriptorSetId(SHADER_RESOURCE_VARIABLE_TYPE VarType);
 
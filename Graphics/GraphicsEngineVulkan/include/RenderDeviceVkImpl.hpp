@@ -32,6 +32,9 @@
 #include <memory>
 #include <unordered_map>
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <array>
 
 #include "EngineVkImplTraits.hpp"
 
@@ -199,12 +202,47 @@ public:
                                                                   const FenceDesc& Desc,
                                                                   IFence**         ppFence) override final;
 
+    /// Implementation of IRenderDeviceVk::GetDynamicHeapStats().
+    virtual void DILIGENT_CALL_TYPE GetDynamicHeapStats(DynamicHeapStatsVk& Stats) const override final
+    {
+        m_DynamicMemoryManager.GetStats(Stats);
+    }
+
+    /// Implementation of IRenderDeviceVk::GetMemoryPageStats().
+    virtual void DILIGENT_CALL_TYPE GetMemoryPageStats(Uint32& NumPages, MemoryPageStatsVk* pPageStats) const override final;
+
+    /// Implementation of IRenderDeviceVk::GetMemoryBudget().
+    virtual void DILIGENT_CALL_TYPE GetMemoryBudget(Uint32& NumHeaps, MemoryHeapBudgetVk* pBudgets) const override final;
+
+    /// Implementation of IRenderDeviceVk::SetMemoryPressureCallback().
+    virtual void DILIGENT_CALL_TYPE SetMemoryPressureCallback(const MemoryPressureCallbackAttribsVk& Attribs) override final;
+
+    /// Implementation of IRenderDeviceVk::GetFramebufferCacheStats().
+    virtual void DILIGENT_CALL_TYPE GetFramebufferCacheStats(ObjectCacheStatsVk& Stats) const override final
+    {
+        m_FramebufferCache.GetStats(Stats);
+    }
+
+    /// Implementation of IRenderDeviceVk::GetImplicitRenderPassCacheStats().
+    virtual void DILIGENT_CALL_TYPE GetImplicitRenderPassCacheStats(ObjectCacheStatsVk& Stats) const override final
+    {
+        m_ImplicitRenderPassCache.GetStats(Stats);
+    }
+
+    /// Implementation of IRenderDeviceVk::GetDescriptorSetAllocatorStats().
+    virtual void DILIGENT_CALL_TYPE GetDescriptorSetAllocatorStats(DescriptorSetAllocatorStatsVk& Stats) const override final
+    {
+        m_DescriptorSetAllocator.GetStats(Stats);
+    }
+
     /// Implementation of IRenderDevice::IdleGPU() in Vulkan backend.
     virtual void DILIGENT_CALL_TYPE IdleGPU() override final;
 
     // pImmediateCtx parameter is only used to make sure the command buffer is submitted from the immediate context
     // The method returns fence value associated with the submitted command buffer
-    Uint64 ExecuteCommandBuffer(SoftwareQueueIndex CommandQueueId, const VkSubmitInfo& SubmitInfo, std::vector<std::pair<Uint64, RefCntAutoPtr<FenceVkImpl>>>* pSignalFences);
+    // If DeferSubmission is true, the command buffer is added to the pending batches of the
+    // command queue (see CommandQueueVkImpl::Submit()), and there must be no fences to signal.
+    Uint64 ExecuteCommandBuffer(SoftwareQueueIndex CommandQueueId, const VkSubmitInfo& SubmitInfo, std::vector<std::pair<Uint64, RefCntAutoPtr<FenceVkImpl>>>* pSignalFences, bool DeferSubmission = false);
 
     void AllocateTransientCmdPool(SoftwareQueueIndex                    CommandQueueId,
                                   VulkanUtilities::CommandPoolWrapper&  CmdPool,
@@ -224,6 +262,10 @@ public:
     {
         return m_DescriptorSetAllocator.Allocate(CommandQueueMask, SetLayout, DebugName);
     }
+    void ReleaseDescriptorSetLayout(VulkanUtilities::DescriptorSetLayoutWrapper&& SetLayout, Uint64 CommandQueueMask)
+    {
+        m_DescriptorSetAllocator.ReleaseSetLayout(std::move(SetLayout), CommandQueueMask);
+    }
     DescriptorPoolManager& GetDynamicDescriptorPool() { return m_DynamicDescriptorPool; }
 
     std::shared_ptr<const VulkanUtilities::VulkanInstance> GetVulkanInstance() const { return m_VulkanInstance; }
@@ -249,8 +291,23 @@ public:
 
     VulkanDynamicMemoryManager& GetDynamicMemoryManager() { return m_DynamicMemoryManager; }
 
+    // Relocatable buffers are buffers that IDeviceContextVk::DefragmentMemory() is allowed to move
+    // to other memory pages (see BufferVkImpl::IsRelocatable()).
+    void RegisterRelocatableBuffer(BufferVkImpl& Buffer);
+    void UnregisterRelocatableBuffer(BufferVkImpl& Buffer);
+
+    // Selects the pages to evacuate and returns the buffers that should be moved out of them
+    // by the context CtxId within the budget given by Attribs.
+    std::vector<RefCntAutoPtr<BufferVkImpl>> SelectBuffersForRelocation(DeviceContextIndex               CtxId,
+                                                                        const DefragmentMemoryAttribsVk& Attribs,
+                                                                        DefragmentMemoryStatsVk&         Stats);
+
     void FlushStaleResources(SoftwareQueueIndex CmdQueueIndex);
 
+    // Compares the heap usage with the budget and invokes the memory pressure callback
+    // for the heaps that exceeded the high watermark.
+    void CheckMemoryPressure();
+
     IDXCompiler* GetDxCompiler() const { return m_pDxCompiler.get(); }
 
     struct Properties
@@ -287,7 +344,8 @@ private:
                              const VkSubmitInfo&                                         SubmitInfo,
                              Uint64&                                                     SubmittedCmdBuffNumber,
                              Uint64&                                                     SubmittedFenceValue,
-                             std::vector<std::pair<Uint64, RefCntAutoPtr<FenceVkImpl>>>* pFences);
+                             std::vector<std::pair<Uint64, RefCntAutoPtr<FenceVkImpl>>>* pFences,
+                             bool                                                        DeferSubmission);
 
     std::shared_ptr<VulkanUtilities::VulkanInstance>       m_VulkanInstance;
     std::unique_ptr<VulkanUtilities::VulkanPhysicalDevice> m_PhysicalDevice;
@@ -310,6 +368,20 @@ private:
 
     VulkanDynamicMemoryManager m_DynamicMemoryManager;
 
+    std::mutex                                                   m_RelocatableBuffersMtx;
+    std::unordered_map<BufferVkImpl*, RefCntWeakPtr<BufferVkImpl>> m_RelocatableBuffers;
+
+    // Driver-reported usage also changes when memory is allocated outside of the memory manager,
+    // so when VK_EXT_memory_budget is enabled, the budget is polled every MemoryBudgetPollInterval submits.
+    static constexpr Uint32 MemoryBudgetPollInterval = 16;
+
+    std::mutex                            m_MemoryPressureMtx;
+    MemoryPressureCallbackAttribsVk       m_MemoryPressureAttribs;
+    std::atomic<bool>                     m_MemoryPressureCallbackSet{false};
+    Uint32                                m_LastPageSetVersion      = ~Uint32{0};
+    Uint32                                m_SubmitsSinceBudgetQuery = 0;
+    std::array<bool, VK_MAX_MEMORY_HEAPS> m_HeapAboveHighWatermark  = {};
+
     std::unique_ptr<IDXCompiler> m_pDxCompiler;
 };
 
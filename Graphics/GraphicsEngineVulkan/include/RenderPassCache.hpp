@@ -31,9 +31,13 @@
 /// Declaration of Diligent::RenderPassCache class
 
 #include <unordered_map>
+#include <list>
+#include <array>
+#include <atomic>
 #include <mutex>
 
 #include "GraphicsTypes.h"
+#include "RenderDeviceVk.h"
 #include "Constants.h"
 #include "HashUtils.hpp"
 #include "VulkanUtilities/VulkanObjectWrappers.hpp"
@@ -48,7 +52,10 @@ class RenderPassVkImpl;
 class RenderPassCache
 {
 public:
-    RenderPassCache(RenderDeviceVkImpl& DeviceVk) noexcept;
+    // MaxSize is the maximum total number of render passes kept in the cache (0 means unlimited).
+    // A render pass can only be evicted when it is not referenced by any pipeline state and
+    // has not been used for EvictionDelay frames.
+    RenderPassCache(RenderDeviceVkImpl& DeviceVk, Uint32 MaxSize, Uint32 EvictionDelay) noexcept;
 
     // clang-format off
     RenderPassCache             (const RenderPassCache&) = delete;
@@ -126,6 +133,11 @@ public:
 
     void Destroy();
 
+    // Called by device contexts when they finish the frame.
+    void OnFrameFinished(Uint64 FrameNumber);
+
+    void GetStats(ObjectCacheStatsVk& Stats) const;
+
 private:
     struct RenderPassCacheKeyHash
     {
@@ -135,10 +147,54 @@ private:
         }
     };
 
+    struct CacheEntry
+    {
+        RefCntAutoPtr<RenderPassVkImpl> pRenderPass;
+
+        Uint64 LastUsedFrame = 0;
+
+        std::list<RenderPassCacheKey>::iterator LRUIt;
+    };
+    using CacheMapType = std::unordered_map<RenderPassCacheKey, CacheEntry, RenderPassCacheKeyHash>;
+
+    struct Shard
+    {
+        mutable std::mutex Mtx;
+
+        CacheMapType Cache;
+
+        // Keys of the least recently used render passes are at the back of the list
+        std::list<RenderPassCacheKey> LRUList;
+
+        Uint64 NumHits      = 0;
+        Uint64 NumMisses    = 0;
+        Uint64 NumEvictions = 0;
+    };
+    static constexpr size_t NumShards = 4;
+
+    Shard& GetShard(const RenderPassCacheKey& Key)
+    {
+        // The key is made of small integers, so mix the hash before selecting the shard.
+        const auto Hash = static_cast<Uint64>(Key.GetHash()) * Uint64{0x9E3779B97F4A7C15};
+        return m_Shards[(Hash >> 32) % NumShards];
+    }
+
+    // Evicts the least recently used render passes of the shard that are only referenced
+    // by the cache and have not been used for m_EvictionDelay frames until the total number
+    // of entries fits into m_MaxSize. Shard.Mtx must be locked.
+    void EvictStaleEntries(Shard& Shard);
+
     RenderDeviceVkImpl& m_DeviceVkImpl;
 
-    std::mutex                                                                                      m_Mutex;
-    std::unordered_map<RenderPassCacheKey, RefCntAutoPtr<RenderPassVkImpl>, RenderPassCacheKeyHash> m_Cache;
+    const Uint32 m_MaxSize;
+    const Uint32 m_EvictionDelay;
+
+    std::atomic<Uint64> m_CurrentFrame{0};
+
+    // The total number of entries in all shards
+    std::atomic<Uint32> m_NumEntries{0};
+
+    std::array<Shard, NumShards> m_Shards;
 };
 
 } // namespace Diligent
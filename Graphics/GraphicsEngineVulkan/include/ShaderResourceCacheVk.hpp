@@ -140,7 +140,7 @@ public:
         explicit operator bool() const { return !IsNull(); }
     };
 
-    // sizeof(DescriptorSet) == 48 (x64, msvc, Release)
+    // sizeof(DescriptorSet) == 56 (x64, msvc, Release)
     class DescriptorSet
     {
     public:
@@ -174,7 +174,7 @@ public:
     private:
 /* 8 */ Resource* const m_pResources = nullptr;
 /*16 */ DescriptorSetAllocation m_DescriptorSetAllocation;
-/*48 */ // End of structure
+/*56 */ // End of structure
         // clang-format on
 
     private:
@@ -260,9 +260,16 @@ public:
     template <bool VerifyOnly>
     void TransitionResources(DeviceContextVkImpl* pCtxVkImpl);
 
-    __forceinline Uint32 GetDynamicBufferOffsets(DeviceContextIndex     CtxId,
-                                                 std::vector<uint32_t>& Offsets,
-                                                 Uint32                 StartInd) const;
+    // Writes dynamic offsets of all buffers with dynamic offsets to Offsets starting at StartInd and
+    // returns the number of offsets written.
+    // If pDynamicHeap is not null, OverflowSetMask receives the mask of descriptor sets that contain
+    // dynamic buffers whose allocations reside in overflow buffers of this heap. Such sets can't be bound
+    // as they reference the primary dynamic heap buffer.
+    __forceinline Uint32 GetDynamicBufferOffsets(DeviceContextIndex       CtxId,
+                                                 std::vector<uint32_t>&   Offsets,
+                                                 Uint32                   StartInd,
+                                                 const VulkanDynamicHeap* pDynamicHeap,
+                                                 Uint32&                  OverflowSetMask) const;
 
 private:
     Resource* GetFirstResourcePtr()
@@ -317,9 +324,11 @@ template <>
 __forceinline auto ShaderResourceCacheVk::Resource::GetDescriptorWriteInfo<DescriptorType::AccelerationStructure>() const { return GetAccelerationStructureWriteInfo(); }
 
 
-__forceinline Uint32 ShaderResourceCacheVk::GetDynamicBufferOffsets(DeviceContextIndex     CtxId,
-                                                                    std::vector<uint32_t>& Offsets,
-                                                                    Uint32                 StartInd) const
+__forceinline Uint32 ShaderResourceCacheVk::GetDynamicBufferOffsets(DeviceContextIndex       CtxId,
+                                                                    std::vector<uint32_t>&   Offsets,
+                                                                    Uint32                   StartInd,
+                                                                    const VulkanDynamicHeap* pDynamicHeap,
+                                                                    Uint32&                  OverflowSetMask) const
 {
     // If any of the sets being bound include dynamic uniform or storage buffers, then
     // pDynamicOffsets includes one element for each array element in each dynamic descriptor
@@ -333,6 +342,7 @@ __forceinline Uint32 ShaderResourceCacheVk::GetDynamicBufferOffsets(DeviceContex
     // (DescriptorType::StorageBufferDynamic and DescriptorType::StorageBufferDynamic_ReadOnly) for every shader stage,
     // followed by all other resources.
     Uint32 OffsetInd = StartInd;
+    OverflowSetMask  = 0;
     for (Uint32 set = 0; set < m_NumSets; ++set)
     {
         const auto& DescrSet = GetDescriptorSet(set);
@@ -353,6 +363,8 @@ __forceinline Uint32 ShaderResourceCacheVk::GetDynamicBufferOffsets(DeviceContex
                 // offset taken from pDynamicOffsets, and the base address of the buffer plus base offset in the descriptor set.
                 // The range of the dynamic uniform and storage buffer bindings is the buffer range as specified in the descriptor set.
                 Offsets[OffsetInd++] = StaticCast<Uint32>(Res.BufferDynamicOffset + Offset);
+                if (pDynamicHeap != nullptr && pBufferVk != nullptr && pDynamicHeap->IsOverflowChunk(pBufferVk->GetDynamicChunk(CtxId)))
+                    OverflowSetMask |= 1u << set;
                 ++res;
             }
             else
@@ -375,6 +387,8 @@ __forceinline Uint32 ShaderResourceCacheVk::GetDynamicBufferOffsets(DeviceContex
                 // offset taken from pDynamicOffsets, and the base address of the buffer plus base offset in the descriptor set.
                 // The range of the dynamic uniform and storage buffer bindings is the buffer range as specified in the descriptor set.
                 Offsets[OffsetInd++] = StaticCast<Uint32>(Res.BufferDynamicOffset + Offset);
+                if (pDynamicHeap != nullptr && pBufferVk != nullptr && pDynamicHeap->IsOverflowChunk(pBufferVk->GetDynamicChunk(CtxId)))
+                    OverflowSetMask |= 1u << set;
                 ++res;
             }
             else
@@ -28,11 +28,15 @@
 #pragma once
 
 #include <mutex>
+#include <memory>
+#include <vector>
+#include <atomic>
 #include "VulkanUtilities/VulkanHeaders.h"
 #include "VulkanUtilities/VulkanMemoryManager.hpp"
 #include "VulkanUtilities/VulkanLogicalDevice.hpp"
 #include "VulkanUtilities/VulkanObjectWrappers.hpp"
-#include "DynamicHeap.hpp"
+#include "VariableSizeAllocationsManager.hpp"
+#include "RenderDeviceVk.h"
 
 namespace Diligent
 {
@@ -45,6 +49,7 @@ namespace Diligent
 class RenderDeviceVkImpl;
 class VulkanRingBuffer;
 class VulkanDynamicMemoryManager;
+struct VulkanDynamicMemoryChunk;
 
 // sizeof(VulkanDynamicAllocation) must be at least 16 to avoid false cache line sharing problems
 struct VulkanDynamicAllocation
@@ -52,11 +57,10 @@ struct VulkanDynamicAllocation
     VulkanDynamicAllocation() noexcept {}
 
     // clang-format off
-    VulkanDynamicAllocation(VulkanDynamicMemoryManager& _DynamicMemMgr, size_t _AlignedOffset, size_t _Size) noexcept :
-        pDynamicMemMgr{&_DynamicMemMgr},
-        AlignedOffset {_AlignedOffset },
-        Size          {_Size          }
-    {}
+    VulkanDynamicAllocation(VulkanDynamicMemoryManager&     _DynamicMemMgr,
+                            size_t                          _AlignedOffset,
+                            size_t                          _Size,
+                            const VulkanDynamicMemoryChunk& _Chunk) noexcept;
 
     VulkanDynamicAllocation             (const VulkanDynamicAllocation&) = delete;
     VulkanDynamicAllocation& operator = (const VulkanDynamicAllocation&) = delete;
@@ -64,7 +68,10 @@ struct VulkanDynamicAllocation
     VulkanDynamicAllocation             (VulkanDynamicAllocation&& rhs)noexcept :
         pDynamicMemMgr{rhs.pDynamicMemMgr},
         AlignedOffset {rhs.AlignedOffset },
-        Size          {rhs.Size          }
+        Size          {rhs.Size          },
+        vkBuffer      {rhs.vkBuffer      },
+        CPUAddress    {rhs.CPUAddress    },
+        pChunk        {rhs.pChunk        }
 #ifdef DILIGENT_DEVELOPMENT
         , dvpFrameNumber{rhs.dvpFrameNumber}
 #endif
@@ -72,6 +79,9 @@ struct VulkanDynamicAllocation
         rhs.pDynamicMemMgr = nullptr;
         rhs.AlignedOffset  = 0;
         rhs.Size           = 0;
+        rhs.vkBuffer       = VK_NULL_HANDLE;
+        rhs.CPUAddress     = nullptr;
+        rhs.pChunk         = nullptr;
 #ifdef DILIGENT_DEVELOPMENT
         rhs.dvpFrameNumber = 0;
 #endif
@@ -83,9 +93,15 @@ struct VulkanDynamicAllocation
         pDynamicMemMgr     = rhs.pDynamicMemMgr;
         AlignedOffset      = rhs.AlignedOffset;
         Size               = rhs.Size;
+        vkBuffer           = rhs.vkBuffer;
+        CPUAddress         = rhs.CPUAddress;
+        pChunk             = rhs.pChunk;
         rhs.pDynamicMemMgr = nullptr;
         rhs.AlignedOffset  = 0;
         rhs.Size           = 0;
+        rhs.vkBuffer       = VK_NULL_HANDLE;
+        rhs.CPUAddress     = nullptr;
+        rhs.pChunk         = nullptr;
 #ifdef DILIGENT_DEVELOPMENT
         dvpFrameNumber     = rhs.dvpFrameNumber;
         rhs.dvpFrameNumber = 0;
@@ -93,37 +109,94 @@ struct VulkanDynamicAllocation
         return *this;
     }
 
-    VulkanDynamicMemoryManager* pDynamicMemMgr = nullptr;
-    size_t                      AlignedOffset  = 0; // Offset from the start of the buffer
-    size_t                      Size           = 0; // Reserved size of this allocation
+    VulkanDynamicMemoryManager*     pDynamicMemMgr = nullptr;
+    size_t                          AlignedOffset  = 0;              // Offset from the start of the buffer
+    size_t                          Size           = 0;              // Reserved size of this allocation
+    VkBuffer                        vkBuffer       = VK_NULL_HANDLE; // Dynamic heap buffer that contains this allocation
+    Uint8*                          CPUAddress     = nullptr;        // CPU address of the start of the buffer
+    const VulkanDynamicMemoryChunk* pChunk         = nullptr;        // Dynamic heap chunk that owns the buffer
 #ifdef DILIGENT_DEVELOPMENT
     Uint64 dvpFrameNumber = 0;
 #endif
 };
 
+// A dynamic heap buffer together with its memory and the allocations manager
+struct VulkanDynamicMemoryChunk
+{
+    VulkanDynamicMemoryChunk(IMemoryAllocator& Allocator, VariableSizeAllocationsManager::OffsetType Size, bool _IsOverflow) :
+        AllocationsMgr{Size, Allocator},
+        IsOverflow{_IsOverflow}
+    {}
+
+    VulkanUtilities::BufferWrapper       vkBuffer;
+    VulkanUtilities::DeviceMemoryWrapper vkMemory;
+    Uint8*                               CPUAddress = nullptr;
+    VariableSizeAllocationsManager       AllocationsMgr;
+    Uint64                               LastUsedFrame = 0;
+
+    // Overflow chunks are created when the primary chunk is exhausted and
+    // are released when they are not used for a number of frames.
+    const bool IsOverflow;
+};
+
+inline VulkanDynamicAllocation::VulkanDynamicAllocation(VulkanDynamicMemoryManager&     _DynamicMemMgr,
+                                                        size_t                          _AlignedOffset,
+                                                        size_t                          _Size,
+                                                        const VulkanDynamicMemoryChunk& _Chunk) noexcept :
+    // clang-format off
+    pDynamicMemMgr{&_DynamicMemMgr   },
+    AlignedOffset {_AlignedOffset    },
+    Size          {_Size             },
+    vkBuffer      {_Chunk.vkBuffer   },
+    CPUAddress    {_Chunk.CPUAddress },
+    pChunk        {&_Chunk           }
+// clang-format on
+{}
 
-// VulkanDynamicMemoryManager manages allocation of master blocks from global dynamic buffer
+
+// VulkanDynamicMemoryManager manages allocation of master blocks from global dynamic buffers
 //
 //   _______________________________________________________________________
 //  |                                                                       |
 //  |                      VulkanDynamicMemoryManager                       |
 //  |                                                                       |
-//  |  || - - - - - - - - - - Dynamic Memory Buffer- - - - - - - - - -||    |
+//  |  || - - - - - - - - - - Primary Dynamic Buffer - - - - - - - - -||    |
 //  |  || MasterBlock[0] | MasterBlock[1] |  ...   | MasterBlock[N-1] ||    |
+//  |                                                                       |
+//  |  || - - - - - - - - - - Overflow Dynamic Buffer  - - - - - - - -||    |
+//  |  || MasterBlock[0] | MasterBlock[1] |  ...   | MasterBlock[M-1] ||    |
+//  |                                ...                                    |
 //  |_______________________________________________________________________|
 //
 // We cannot use global memory manager for dynamic resources because they
-// need to use the same Vulkan buffer
-class VulkanDynamicMemoryManager : public DynamicHeap::MasterBlockListBasedManager
+// need to use the same Vulkan buffer.
+// The primary buffer is created at initialization and is never released. Its handle is
+// returned by GetVkBuffer() and is referenced by all descriptor sets that contain dynamic buffers.
+// When the primary buffer is exhausted, the manager creates overflow buffers of the same size,
+// up to the maximum total size. Allocations from overflow buffers are bound by the device context
+// through the buffer handle stored in the allocation. Overflow buffers that stay empty for
+// the specified number of frames are released.
+class VulkanDynamicMemoryManager
 {
 public:
-    using TBase       = DynamicHeap::MasterBlockListBasedManager;
-    using OffsetType  = TBase::OffsetType;
-    using MasterBlock = TBase::MasterBlock;
+    using OffsetType = VariableSizeAllocationsManager::OffsetType;
+
+    using Chunk = VulkanDynamicMemoryChunk;
+
+    struct MasterBlock
+    {
+        OffsetType UnalignedOffset = VariableSizeAllocationsManager::Allocation::InvalidOffset; // Offset from the start of the chunk buffer
+        OffsetType Size            = 0;
+        Chunk*     pChunk          = nullptr;
+
+        bool IsValid() const { return pChunk != nullptr; }
+    };
 
     VulkanDynamicMemoryManager(IMemoryAllocator&         Allocator,
                                class RenderDeviceVkImpl& DeviceVk,
                                Uint32                    Size,
+                               Uint32                    MaxSize,
+                               Uint32                    ShrinkDelay,
                                Uint64                    CommandQueueMask);
     ~VulkanDynamicMemoryManager();
 
@@ -133,8 +206,8 @@ public:
     VulkanDynamicMemoryManager& operator= (const VulkanDynamicMemoryManager&)  = delete;
     VulkanDynamicMemoryManager& operator= (      VulkanDynamicMemoryManager&&) = delete;
 
-    VkBuffer GetVkBuffer()  const{return m_VkBuffer;}
-    Uint8*   GetCPUAddress()const{return m_CPUAddress;}
+    // Returns the primary dynamic buffer
+    VkBuffer GetVkBuffer() const {return m_vkPrimaryBuffer;}
     // clang-format on
 
     void Destroy();
@@ -142,14 +215,61 @@ public:
     static constexpr const Uint32 MasterBlockAlignment = 1024;
     MasterBlock                   AllocateMasterBlock(OffsetType SizeInBytes, OffsetType Alignment);
 
+    // Safely returns master blocks to the manager once the GPU is done with them.
+    // FrameNumber is the number of the frame the blocks were used in and is used to
+    // detect overflow buffers that have not been used for a long time.
+    void ReleaseMasterBlocks(std::vector<MasterBlock>& Blocks, RenderDeviceVkImpl& Device, Uint64 CmdQueueMask, Uint64 FrameNumber);
+
+    OffsetType GetSize() const;
+    OffsetType GetUsedSize() const;
+
+    void GetStats(DynamicHeapStatsVk& Stats) const;
+
+#ifdef DILIGENT_DEVELOPMENT
+    Int32 GetMasterBlockCounter() const
+    {
+        return m_MasterBlockCounter.load();
+    }
+#endif
+
 private:
-    RenderDeviceVkImpl&                  m_DeviceVk;
-    VulkanUtilities::BufferWrapper       m_VkBuffer;
-    VulkanUtilities::DeviceMemoryWrapper m_BufferMemory;
-    Uint8*                               m_CPUAddress;
-    const VkDeviceSize                   m_DefaultAlignment;
-    const Uint64                         m_CommandQueueMask;
-    OffsetType                           m_TotalPeakSize = 0;
+    std::unique_ptr<Chunk> CreateChunk(OffsetType Size, bool IsOverflow, const char* Name);
+
+    MasterBlock AllocateFromChunks(OffsetType SizeInBytes, OffsetType Alignment);
+    MasterBlock AllocateFromNewChunk(OffsetType SizeInBytes, OffsetType Alignment);
+
+    // Moves overflow chunks that have not been used for m_ShrinkDelay frames to IdleChunks.
+    // Must be called while m_ChunksMtx is locked.
+    void RemoveIdleChunks(std::vector<std::unique_ptr<Chunk>>& IdleChunks);
+
+    // Must be called while m_ChunksMtx is NOT locked
+    void ReleaseChunk(Chunk& ChunkToRelease);
+
+    void UpdatePeakStats();
+
+    RenderDeviceVkImpl& m_DeviceVk;
+    IMemoryAllocator&   m_Allocator;
+    const VkDeviceSize  m_DefaultAlignment;
+    const Uint64        m_CommandQueueMask;
+    const OffsetType    m_ChunkSize;
+    const OffsetType    m_MaxSize;
+    const Uint32        m_ShrinkDelay;
+
+    mutable std::mutex                  m_ChunksMtx;
+    std::vector<std::unique_ptr<Chunk>> m_Chunks;
+    VkBuffer                            m_vkPrimaryBuffer = VK_NULL_HANDLE;
+
+    Uint64 m_CurrentFrame = 0;
+
+    OffsetType m_TotalPeakSize  = 0;
+    OffsetType m_PeakBufferSize = 0;
+    Uint32     m_PeakNumBuffers = 0;
+    Uint32     m_GrowCount      = 0;
+    Uint32     m_ShrinkCount    = 0;
+
+#ifdef DILIGENT_DEVELOPMENT
+    std::atomic<Int32> m_MasterBlockCounter{0};
+#endif
 };
 
 
@@ -176,7 +296,7 @@ private:
 //             V                               |                              |
 //                                             |  VulkanDynamicMemoryManager  |
 //                                             |                              |
-//                                             |   |Global dynamic buffer|    |
+//                                             |   |Global dynamic buffers|   |
 //                                             |______________________________|
 //
 class VulkanDynamicHeap
@@ -204,7 +324,24 @@ public:
     // with during the last frame.
     // As global dynamic memory manager is hosted by the render device, the dynamic heap can
     // be destroyed before the blocks are actually returned to the global dynamic memory manager.
-    void ReleaseMasterBlocks(RenderDeviceVkImpl& DeviceVkImpl, Uint64 CmdQueueMask);
+    void ReleaseMasterBlocks(RenderDeviceVkImpl& DeviceVkImpl, Uint64 CmdQueueMask, Uint64 FrameNumber);
+
+    // Returns true if pChunk is an overflow chunk that this heap has allocated
+    // master blocks from in the current frame.
+    bool IsOverflowChunk(const VulkanDynamicMemoryChunk* pChunk) const
+    {
+        if (pChunk == nullptr)
+            return false;
+
+        for (const auto* pOverflowChunk : m_OverflowChunks)
+        {
+            if (pOverflowChunk == pChunk)
+                return true;
+        }
+        return false;
+    }
+
+    bool HasOverflowBuffers() const { return !m_OverflowChunks.empty(); }
 
     using OffsetType  = VulkanDynamicMemoryManager::OffsetType;
     using MasterBlock = VulkanDynamicMemoryManager::MasterBlock;
@@ -214,14 +351,20 @@ public:
     size_t GetAllocatedMasterBlockCount() const { return m_MasterBlocks.size(); }
 
 private:
+    void AddMasterBlock(const MasterBlock& Block);
+
     VulkanDynamicMemoryManager& m_GlobalDynamicMemMgr;
     const std::string           m_HeapName;
 
     std::vector<MasterBlock> m_MasterBlocks;
 
-    OffsetType   m_CurrOffset = InvalidOffset;
-    const Uint32 m_MasterBlockSize;
-    Uint32       m_AvailableSize = 0;
+    // Overflow chunks used by the master blocks of the current frame
+    std::vector<const VulkanDynamicMemoryChunk*> m_OverflowChunks;
+
+    OffsetType                      m_CurrOffset = InvalidOffset;
+    const VulkanDynamicMemoryChunk* m_pCurrChunk = nullptr;
+    const Uint32                    m_MasterBlockSize;
+    Uint32                          m_AvailableSize = 0;
 
     Uint32 m_CurrAlignedSize   = 0;
     Uint32 m_CurrUsedSize      = 0;
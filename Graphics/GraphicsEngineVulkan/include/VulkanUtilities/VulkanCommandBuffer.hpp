@@ -230,7 +230,8 @@ public:
                                        uint32_t            FramebufferWidth,
                                        uint32_t            FramebufferHeight,
                                        uint32_t            ClearValueCount = 0,
-                                       const VkClearValue* pClearValues    = nullptr)
+                                       const VkClearValue* pClearValues    = nullptr,
+                                       VkSubpassContents   Contents        = VK_SUBPASS_CONTENTS_INLINE)
     {
         VERIFY_EXPR(m_VkCmdBuffer != VK_NULL_HANDLE);
         VERIFY(m_State.RenderPass == VK_NULL_HANDLE, "Current pass has not been ended");
@@ -254,11 +255,11 @@ public:
                                                       // corresponding to cleared attachments are used. Other elements of pClearValues are
                                                       // ignored (7.4)
 
-            vkCmdBeginRenderPass(m_VkCmdBuffer, &BeginInfo,
-                                 VK_SUBPASS_CONTENTS_INLINE // the contents of the subpass will be recorded inline in the
-                                                            // primary command buffer, and secondary command buffers must not
-                                                            // be executed within the subpass
-            );
+            // VK_SUBPASS_CONTENTS_INLINE: the contents of the subpass will be recorded inline in the primary command buffer,
+            //                             and secondary command buffers must not be executed within the subpass.
+            // VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS: the contents are recorded in secondary command buffers, and
+            //                             vkCmdExecuteCommands is the only valid command in the subpass (8.4)
+            vkCmdBeginRenderPass(m_VkCmdBuffer, &BeginInfo, Contents);
             m_State.RenderPass        = RenderPass;
             m_State.Framebuffer       = Framebuffer;
             m_State.FramebufferWidth  = FramebufferWidth;
@@ -266,9 +267,27 @@ public:
         }
     }
 
+    // Sets the render pass state for a secondary command buffer that was begun with
+    // VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT. The render pass instance is owned by
+    // the primary command buffer, so it must not be ended in this command buffer.
+    __forceinline void ContinueRenderPass(VkRenderPass  RenderPass,
+                                          VkFramebuffer Framebuffer,
+                                          uint32_t      FramebufferWidth,
+                                          uint32_t      FramebufferHeight)
+    {
+        VERIFY_EXPR(m_VkCmdBuffer != VK_NULL_HANDLE);
+        VERIFY(m_State.RenderPass == VK_NULL_HANDLE, "Current pass has not been ended");
+        m_State.RenderPass          = RenderPass;
+        m_State.Framebuffer         = Framebuffer;
+        m_State.FramebufferWidth    = FramebufferWidth;
+        m_State.FramebufferHeight   = FramebufferHeight;
+        m_State.InheritedRenderPass = true;
+    }
+
     __forceinline void EndRenderPass()
     {
         VERIFY(m_State.RenderPass != VK_NULL_HANDLE, "Render pass has not been started");
+        VERIFY(!m_State.InheritedRenderPass, "Render pass inherited from the primary command buffer can't be ended in a secondary command buffer");
         VERIFY_EXPR(m_VkCmdBuffer != VK_NULL_HANDLE);
         vkCmdEndRenderPass(m_VkCmdBuffer);
         m_State.RenderPass        = VK_NULL_HANDLE;
@@ -284,11 +303,28 @@ public:
         }
     }
 
-    __forceinline void NextSubpass()
+    __forceinline void NextSubpass(VkSubpassContents Contents = VK_SUBPASS_CONTENTS_INLINE)
     {
         VERIFY(m_State.RenderPass != VK_NULL_HANDLE, "Render pass has not been started");
+        VERIFY(!m_State.InheritedRenderPass, "Subpass can't be advanced in a secondary command buffer");
         VERIFY_EXPR(m_VkCmdBuffer != VK_NULL_HANDLE);
-        vkCmdNextSubpass(m_VkCmdBuffer, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdNextSubpass(m_VkCmdBuffer, Contents);
+    }
+
+    __forceinline void ExecuteCommands(uint32_t CommandBufferCount, const VkCommandBuffer* pCommandBuffers)
+    {
+        VERIFY_EXPR(m_VkCmdBuffer != VK_NULL_HANDLE);
+        VERIFY(m_State.RenderPass != VK_NULL_HANDLE, "Secondary command buffers can only be executed inside a render pass");
+        VERIFY_EXPR(CommandBufferCount > 0 && pCommandBuffers != nullptr);
+        vkCmdExecuteCommands(m_VkCmdBuffer, CommandBufferCount, pCommandBuffers);
+
+        // The contents of the command buffer state after vkCmdExecuteCommands are undefined (6.7)
+        m_State.GraphicsPipeline   = VK_NULL_HANDLE;
+        m_State.ComputePipeline    = VK_NULL_HANDLE;
+        m_State.RayTracingPipeline = VK_NULL_HANDLE;
+        m_State.IndexBuffer        = VK_NULL_HANDLE;
+        m_State.IndexBufferOffset  = 0;
+        m_State.IndexType          = VK_INDEX_TYPE_MAX_ENUM;
     }
 
     __forceinline void EndCommandBuffer()
@@ -765,6 +801,9 @@ public:
         uint32_t      FramebufferHeight  = 0;
         uint32_t      InsidePassQueries  = 0;
         uint32_t      OutsidePassQueries = 0;
+
+        // Render pass is inherited from the primary command buffer (secondary command buffers only)
+        bool InheritedRenderPass = false;
     };
 
     const StateCache& GetState() const { return m_State; }
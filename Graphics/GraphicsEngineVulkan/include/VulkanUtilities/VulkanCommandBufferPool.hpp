@@ -43,7 +43,8 @@ class VulkanCommandBufferPool
 public:
     VulkanCommandBufferPool(std::shared_ptr<const VulkanLogicalDevice> LogicalDevice,
                             HardwareQueueIndex                         queueFamilyIndex,
-                            VkCommandPoolCreateFlags                   flags);
+                            VkCommandPoolCreateFlags                   flags,
+                            VkCommandBufferLevel                       level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
 
     // clang-format off
     VulkanCommandBufferPool             (const VulkanCommandBufferPool&)  = delete;
@@ -54,12 +55,15 @@ public:
 
     ~VulkanCommandBufferPool();
 
-    VkCommandBuffer GetCommandBuffer(const char* DebugName = "");
+    // For secondary command buffers, pInheritanceInfo must not be null. If it references a render pass,
+    // the command buffer is begun with VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT.
+    VkCommandBuffer GetCommandBuffer(const char* DebugName = "", const VkCommandBufferInheritanceInfo* pInheritanceInfo = nullptr);
     // The GPU must have finished with the command buffer being returned to the pool
     void RecycleCommandBuffer(VkCommandBuffer&& CmdBuffer);
 
     VkPipelineStageFlags GetSupportedStagesMask() const { return m_SupportedStagesMask; }
     VkAccessFlags        GetSupportedAccessMask() const { return m_SupportedAccessMask; }
+    VkCommandBufferLevel GetLevel() const { return m_Level; }
 
 private:
     // Shared point to logical device must be defined before the command pool
@@ -71,6 +75,7 @@ private:
     std::deque<VkCommandBuffer> m_CmdBuffers;
     const VkPipelineStageFlags  m_SupportedStagesMask;
     const VkAccessFlags         m_SupportedAccessMask;
+    const VkCommandBufferLevel  m_Level;
 
 #ifdef DILIGENT_DEVELOPMENT
     std::atomic<int32_t> m_BuffCounter{0};
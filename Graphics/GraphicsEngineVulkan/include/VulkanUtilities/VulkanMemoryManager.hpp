@@ -32,6 +32,7 @@
 #include <unordered_map>
 #include <atomic>
 #include <string>
+#include <vector>
 #include "MemoryAllocator.h"
 #include "VariableSizeAllocationsManager.hpp"
 #include "VulkanUtilities/VulkanPhysicalDevice.hpp"
@@ -92,6 +93,31 @@ struct VulkanMemoryAllocation
     VkDeviceSize      Size            = 0;       // Reserved size of this allocation
 };
 
+// Memory page occupancy statistics, see VulkanMemoryManager::GetPageStats().
+struct VulkanMemoryPageStats
+{
+    const VulkanMemoryPage* pPage           = nullptr;
+    uint32_t                MemoryTypeIndex = 0;
+    VkMemoryAllocateFlags   AllocateFlags   = 0;
+    bool                    IsHostVisible   = false;
+    bool                    IsEvacuating    = false;
+    VkDeviceSize            Size            = 0;
+    VkDeviceSize            UsedSize        = 0;
+    VkDeviceSize            MaxFreeBlock    = 0;
+    size_t                  NumFreeBlocks   = 0;
+};
+
+// Device memory heap budget, see VulkanMemoryManager::GetHeapBudgets().
+struct VulkanMemoryHeapBudget
+{
+    VkDeviceSize      Size             = 0; // Heap size
+    VkDeviceSize      Budget           = 0; // Amount of memory the process can use without degrading performance
+    VkDeviceSize      Usage            = 0; // Amount of memory currently used by the process
+    VkDeviceSize      AllocatedSize    = 0; // Total size of the pages allocated by the manager from this heap
+    VkMemoryHeapFlags Flags            = 0;
+    bool              IsDriverReported = false; // Budget and Usage are reported by VK_EXT_memory_budget
+};
+
 class VulkanMemoryPage
 {
 public:
@@ -107,7 +133,10 @@ public:
         m_ParentMemoryMgr {rhs.m_ParentMemoryMgr         },
         m_AllocationMgr   {std::move(rhs.m_AllocationMgr)},
         m_VkMemory        {std::move(rhs.m_VkMemory)     },
-        m_CPUMemory       {rhs.m_CPUMemory               }
+        m_CPUMemory       {rhs.m_CPUMemory               },
+        m_MemoryTypeIndex {rhs.m_MemoryTypeIndex         },
+        m_AllocateFlags   {rhs.m_AllocateFlags           },
+        m_IsEvacuating    {rhs.m_IsEvacuating.load()     }
     {
         rhs.m_CPUMemory = nullptr;
     }
@@ -121,8 +150,17 @@ public:
     VkDeviceSize GetPageSize() const { return m_AllocationMgr.GetMaxSize();  }
     VkDeviceSize GetUsedSize() const { return m_AllocationMgr.GetUsedSize(); }
 
+    uint32_t              GetMemoryTypeIndex() const { return m_MemoryTypeIndex; }
+    VkMemoryAllocateFlags GetAllocateFlags()   const { return m_AllocateFlags; }
+
+    // Pages that are being evacuated by the defragmenter are skipped by
+    // VulkanMemoryManager::Allocate() until they become empty.
+    bool IsEvacuating() const { return m_IsEvacuating.load(); }
+
     // clang-format on
 
+    VulkanMemoryPageStats GetStats() const;
+
     VulkanMemoryAllocation Allocate(VkDeviceSize size, VkDeviceSize alignment);
 
     VkDeviceMemory GetVkMemory() const { return m_VkMemory; }
@@ -137,10 +175,15 @@ private:
     void Free(VulkanMemoryAllocation&& Allocation);
 
     VulkanMemoryManager&                     m_ParentMemoryMgr;
-    std::mutex                               m_Mutex;
+    mutable std::mutex                       m_Mutex;
     Diligent::VariableSizeAllocationsManager m_AllocationMgr;
     VulkanUtilities::DeviceMemoryWrapper     m_VkMemory;
     void*                                    m_CPUMemory = nullptr;
+    const uint32_t                           m_MemoryTypeIndex;
+    const VkMemoryAllocateFlags              m_AllocateFlags;
+    std::atomic<bool>                        m_IsEvacuating{false};
+
+    friend class VulkanMemoryManager;
 };
 
 class VulkanMemoryManager
@@ -184,7 +227,9 @@ public:
         //m_CurrUsedSize      {rhs.m_CurrUsedSize},
         m_PeakUsedSize      {rhs.m_PeakUsedSize     },
         m_CurrAllocatedSize {rhs.m_CurrAllocatedSize},
-        m_PeakAllocatedSize {rhs.m_PeakAllocatedSize}
+        m_PeakAllocatedSize {rhs.m_PeakAllocatedSize},
+        m_HeapAllocatedSize {rhs.m_HeapAllocatedSize},
+        m_PageSetVersion    {rhs.m_PageSetVersion.load()}
     {
         // clang-format on
         for (size_t i = 0; i < m_CurrUsedSize.size(); ++i)
@@ -203,6 +248,27 @@ public:
     VulkanMemoryAllocation Allocate(const VkMemoryRequirements& MemReqs, VkMemoryPropertyFlags MemoryProps, VkMemoryAllocateFlags AllocateFlags);
     void                   ShrinkMemory();
 
+    // Allocates memory for the contents of an allocation that is being moved out of SrcPage.
+    // The memory is allocated from a page with the same memory type and allocation flags
+    // that is not being evacuated. New pages are never created; if there is no space
+    // in existing pages, or if MemReqs.memoryTypeBits does not allow the memory type
+    // of SrcPage, an empty allocation is returned.
+    VulkanMemoryAllocation AllocateForRelocation(const VulkanMemoryPage& SrcPage, const VkMemoryRequirements& MemReqs);
+
+    // Marks the page as being evacuated or clears the mark. Does nothing if the page no longer exists.
+    void SetPageEvacuating(const VulkanMemoryPage& Page, bool IsEvacuating);
+
+    // Returns occupancy statistics of all pages.
+    void GetPageStats(std::vector<VulkanMemoryPageStats>& Stats) const;
+
+    // Returns the budget of every memory heap. If VK_EXT_memory_budget extension is enabled,
+    // the budget and usage are reported by the driver. Otherwise, the usage is the total size
+    // of the pages allocated by the manager, and the budget is estimated as 80% of the heap size.
+    void GetHeapBudgets(std::vector<VulkanMemoryHeapBudget>& Budgets) const;
+
+    // Returns a value that changes every time a memory page is created or destroyed.
+    uint32_t GetPageSetVersion() const { return m_PageSetVersion.load(); }
+
 protected:
     friend class VulkanMemoryPage;
 
@@ -216,7 +282,7 @@ protected:
 
     Diligent::IMemoryAllocator& m_Allocator;
 
-    std::mutex m_PagesMtx;
+    mutable std::mutex m_PagesMtx;
     struct MemoryPageIndex
     {
         const uint32_t              MemoryTypeIndex;
@@ -248,7 +314,8 @@ protected:
             }
         };
     };
-    std::unordered_multimap<MemoryPageIndex, VulkanMemoryPage, MemoryPageIndex::Hasher> m_Pages;
+    using PagesMapType = std::unordered_multimap<MemoryPageIndex, VulkanMemoryPage, MemoryPageIndex::Hasher>;
+    PagesMapType m_Pages;
 
     const VkDeviceSize m_DeviceLocalPageSize;
     const VkDeviceSize m_HostVisiblePageSize;
@@ -257,12 +324,30 @@ protected:
 
     void OnFreeAllocation(VkDeviceSize Size, bool IsHostVisible);
 
+    uint32_t GetHeapIndex(uint32_t MemoryTypeIndex) const;
+
+    // The caller must hold m_PagesMtx
+    void QueryHeapBudgets(std::vector<VulkanMemoryHeapBudget>& Budgets) const;
+
+    // Destroys the page and returns the iterator following the erased element.
+    // The caller must hold m_PagesMtx.
+    PagesMapType::iterator DestroyPage(PagesMapType::iterator page_it);
+
+    // Destroys all empty pages allocated from the heap, ignoring the reserve size.
+    // The caller must hold m_PagesMtx.
+    void ReleaseEmptyPages(uint32_t HeapIndex);
+
     // 0 == Device local, 1 == Host-visible
     std::array<std::atomic<int64_t>, 2> m_CurrUsedSize      = {};
     std::array<VkDeviceSize, 2>         m_PeakUsedSize      = {};
     std::array<VkDeviceSize, 2>         m_CurrAllocatedSize = {};
     std::array<VkDeviceSize, 2>         m_PeakAllocatedSize = {};
 
+    // Total size of the pages allocated from every memory heap, protected by m_PagesMtx
+    std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> m_HeapAllocatedSize = {};
+
+    std::atomic<uint32_t> m_PageSetVersion{0};
+
     // If adding new member, do not forget to update move ctor
 };
 
@@ -72,6 +72,7 @@ public:
         bool HasPortabilitySubset = false;
         bool RenderPass2          = false;
         bool DrawIndirectCount    = false;
+        bool MemoryBudget         = false; // VK_EXT_memory_budget
     };
 
     struct ExtensionProperties
@@ -118,6 +119,12 @@ public:
     const ExtensionProperties&                  GetExtProperties() const { return m_ExtProperties; }
     const VkPhysicalDeviceMemoryProperties&     GetMemoryProperties() const { return m_MemoryProperties; }
     VkFormatProperties                          GetPhysicalDeviceFormatProperties(VkFormat imageFormat) const;
+
+    // Queries the current per-heap memory budget and usage.
+    // VK_EXT_memory_budget extension must be enabled by the logical device.
+    // Returns false if the query is not supported.
+    bool GetMemoryBudget(VkPhysicalDeviceMemoryBudgetPropertiesEXT& Budget) const;
+
     const std::vector<VkQueueFamilyProperties>& GetQueueProperties() const { return m_QueueFamilyProperties; }
 
 private:
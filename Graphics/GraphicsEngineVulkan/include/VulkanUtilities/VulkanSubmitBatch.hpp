@@ -0,0 +1,90 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "VulkanHeaders.h"
+
+namespace VulkanUtilities
+{
+
+// Accumulates batches of queue operations so that they can be submitted
+// to the queue with a single vkQueueSubmit call.
+// All arrays referenced by the batches are copied, so the original
+// VkSubmitInfo structures do not need to outlive the call to Add().
+class VulkanSubmitBatch
+{
+public:
+    // Returns true if the batch can be added to VulkanSubmitBatch.
+    // The only structure supported in the pNext chain is VkTimelineSemaphoreSubmitInfo.
+    static bool IsSupported(const VkSubmitInfo& SubmitInfo);
+
+    // Copies the batch. Batches that have no operations are ignored.
+    void Add(const VkSubmitInfo& SubmitInfo);
+
+    // Appends semaphores to the signal operations of the last batch.
+    // If there are no batches, a new batch is created.
+    void AppendSignalSemaphores(const VkSemaphore* pSemaphores, uint32_t Count);
+
+    // Returns the array of GetBatchCount() submit infos that reference the data owned by this object.
+    // The array remains valid until the next call to a non-const method.
+    const VkSubmitInfo* GetSubmitInfos();
+
+    uint32_t GetBatchCount() const { return static_cast<uint32_t>(m_Batches.size()); }
+
+    bool IsEmpty() const { return m_Batches.empty(); }
+
+    // Removes all batches, but keeps the memory allocated
+    void Clear();
+
+private:
+    struct Batch
+    {
+        uint32_t FirstCmdBuffer       = 0;
+        uint32_t NumCmdBuffers        = 0;
+        uint32_t FirstWaitSemaphore   = 0;
+        uint32_t NumWaitSemaphores    = 0;
+        uint32_t FirstSignalSemaphore = 0;
+        uint32_t NumSignalSemaphores  = 0;
+        bool     HasTimelineValues    = false;
+    };
+    std::vector<Batch> m_Batches;
+
+    std::vector<VkCommandBuffer>      m_CmdBuffers;
+    std::vector<VkSemaphore>          m_WaitSemaphores;
+    std::vector<VkPipelineStageFlags> m_WaitDstStageMasks;
+    std::vector<uint64_t>             m_WaitSemaphoreValues;
+    std::vector<VkSemaphore>          m_SignalSemaphores;
+    std::vector<uint64_t>             m_SignalSemaphoreValues;
+
+    std::vector<VkSubmitInfo>                  m_SubmitInfos;
+    std::vector<VkTimelineSemaphoreSubmitInfo> m_TimelineSemaphoreInfos;
+};
+
+} // namespace VulkanUtilities
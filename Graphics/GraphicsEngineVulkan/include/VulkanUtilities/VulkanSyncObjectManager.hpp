@@ -26,11 +26,11 @@
 
 #pragma once
 
-#include <vector>
-#include <mutex>
+#include <memory>
 
 #include "VulkanLogicalDevice.hpp"
 #include "DebugUtilities.hpp"
+#include "LockFreeBoundedQueue.hpp"
 
 namespace VulkanUtilities
 {
@@ -69,11 +69,14 @@ public:
 private:
     VulkanLogicalDevice& m_LogicalDevice;
 
-    std::mutex               m_SemaphorePoolGuard;
-    std::vector<VkSemaphore> m_SemaphorePool;
+    // Pools are lock-free so that threads submitting to different queues or recycling
+    // sync objects from release queues never block each other. Objects that do not fit
+    // into a full pool are destroyed.
+    static constexpr size_t SemaphorePoolSize = 256;
+    static constexpr size_t FencePoolSize     = 128;
 
-    std::mutex           m_FencePoolGuard;
-    std::vector<VkFence> m_FencePool;
+    Threading::LockFreeBoundedQueue<VkSemaphore> m_SemaphorePool{SemaphorePoolSize};
+    Threading::LockFreeBoundedQueue<VkFence>     m_FencePool{FencePoolSize};
 };
 
 using VulkanRecycledSemaphore = VulkanSyncObjectManager::RecycledSyncObject<VkSemaphoreType>;
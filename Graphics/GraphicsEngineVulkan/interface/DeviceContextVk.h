@@ -39,6 +39,72 @@ DILIGENT_BEGIN_NAMESPACE(Diligent)
 static const INTERFACE_ID IID_DeviceContextVk =
     {0x72aeb1ba, 0xc6ad, 0x42ec, {0x88, 0x11, 0x7e, 0xd9, 0xc7, 0x21, 0x76, 0xbb}};
 
+/// Memory defragmentation attributes, see IDeviceContextVk::DefragmentMemory().
+struct DefragmentMemoryAttribsVk
+{
+    /// Memory pages with occupancy (used size divided by page size)
+    /// not greater than this value are considered for evacuation.
+    float MaxPageOccupancy DEFAULT_INITIALIZER(0.25f);
+
+    /// The maximum number of bytes to copy in one call.
+    /// At least one buffer is always moved if there is one to move.
+    Uint64 MaxBytesToMove DEFAULT_INITIALIZER(16 << 20);
+};
+typedef struct DefragmentMemoryAttribsVk DefragmentMemoryAttribsVk;
+
+/// Memory defragmentation statistics, see IDeviceContextVk::DefragmentMemory().
+struct DefragmentMemoryStatsVk
+{
+    /// The number of buffers moved by the call.
+    Uint32 NumMovedBuffers DEFAULT_INITIALIZER(0);
+
+    /// The total size of the buffers moved by the call, in bytes.
+    Uint64 MovedBytes DEFAULT_INITIALIZER(0);
+
+    /// The number of pages that are being evacuated.
+    Uint32 NumEvacuatingPages DEFAULT_INITIALIZER(0);
+
+    /// The number of bytes that remain to be moved out of the evacuating pages.
+    Uint64 RemainingBytes DEFAULT_INITIALIZER(0);
+};
+typedef struct DefragmentMemoryStatsVk DefragmentMemoryStatsVk;
+
+/// Render pass bundle attributes, see IDeviceContextVk::BeginRenderPassBundle().
+struct RenderPassBundleAttribsVk
+{
+    /// Index of the immediate context that will execute the bundle.
+    Uint32 ImmediateContextId DEFAULT_INITIALIZER(0);
+
+    /// Render pass the bundle will be executed in.
+    IRenderPass* pRenderPass DEFAULT_INITIALIZER(nullptr);
+
+    /// Framebuffer the bundle will be executed with.
+    IFramebuffer* pFramebuffer DEFAULT_INITIALIZER(nullptr);
+
+    /// Index of the subpass the bundle will be executed in.
+    Uint32 SubpassIndex DEFAULT_INITIALIZER(0);
+};
+typedef struct RenderPassBundleAttribsVk RenderPassBundleAttribsVk;
+
+
+/// Command submission statistics, see IDeviceContextVk::GetSubmitStats().
+struct SubmitStatsVk
+{
+    /// The number of times the context was flushed, including implicit flushes.
+    Uint32 NumFlushes DEFAULT_INITIALIZER(0);
+
+    /// The number of flushes whose command buffers were batched with other flushes
+    /// instead of being submitted immediately.
+    Uint32 NumBatchedFlushes DEFAULT_INITIALIZER(0);
+
+    /// The number of vkQueueSubmit calls performed by the command queue of the context.
+    /// This includes submissions of transient command buffers used by the render device, e.g. to
+    /// initialize resources.
+    Uint32 NumSubmits DEFAULT_INITIALIZER(0);
+};
+typedef struct SubmitStatsVk SubmitStatsVk;
+
+
 #define DILIGENT_INTERFACE_NAME IDeviceContextVk
 #include "../../../Primitives/interface/DefineInterfaceHelperMacros.h"
 
@@ -84,6 +150,118 @@ DILIGENT_BEGIN_INTERFACE(IDeviceContextVk, IDeviceContext)
     ///           calling IDeviceContext::InvalidateState() and then manually restore all required states via
     ///           appropriate Diligent API calls.
     VIRTUAL VkCommandBuffer METHOD(GetVkCommandBuffer)(THIS) PURE;
+
+    /// Moves buffers out of sparsely used device memory pages to reduce device memory usage
+
+    /// \param [in]  Attribs - Defragmentation attributes, see Diligent::DefragmentMemoryAttribsVk.
+    /// \param [out] pStats  - Optional pointer to the defragmentation statistics, see Diligent::DefragmentMemoryStatsVk.
+    ///
+    /// \remarks The method selects memory pages whose occupancy does not exceed Attribs.MaxPageOccupancy
+    ///          and whose contents can be moved to other pages, and marks them as evacuating. It then
+    ///          copies up to Attribs.MaxBytesToMove bytes of buffer data out of these pages using GPU copies
+    ///          recorded into this context, and replaces the buffers' Vulkan handles. Emptied pages are
+    ///          released when the device releases stale resources. The method is intended to be called
+    ///          once per frame until RemainingBytes in the returned statistics is zero.
+    ///
+    ///          Only buffers that are used by this context exclusively, have USAGE_DEFAULT or USAGE_IMMUTABLE usage
+    ///          and any combination of BIND_VERTEX_BUFFER, BIND_INDEX_BUFFER and BIND_INDIRECT_DRAW_ARGS bind flags
+    ///          are moved, as Vulkan handles of such buffers are not stored in descriptor sets or views.
+    ///          Pages that contain other resources are not evacuated.
+    ///
+    ///          A moved buffer gets a new Vulkan handle. An application must not cache the handles
+    ///          returned by IBufferVk::GetVkBuffer() across calls to this method, and must not call the method
+    ///          while command lists recorded by deferred contexts that reference the buffers are pending execution.
+    ///          The method must only be called from an immediate context outside of a render pass.
+    VIRTUAL void METHOD(DefragmentMemory)(THIS_
+                                          const DefragmentMemoryAttribsVk REF Attribs,
+                                          DefragmentMemoryStatsVk*            pStats DEFAULT_VALUE(nullptr)) PURE;
+
+
+    /// Begins recording a render pass bundle in a deferred context
+
+    /// \param [in] Attribs - Render pass bundle attributes, see Diligent::RenderPassBundleAttribsVk.
+    ///
+    /// \remarks The method must be called for a deferred context instead of IDeviceContext::Begin().
+    ///          Commands are recorded into a Vulkan secondary command buffer that inherits the
+    ///          render pass, subpass and framebuffer given by Attribs. Only commands that are valid
+    ///          inside a render pass (setting states and resources, draws, inside-pass queries) may be
+    ///          recorded, and all resource state transitions must be performed before the render pass begins.
+    ///
+    ///          The recording is finished by IDeviceContext::FinishCommandList(). The resulting command list
+    ///          must be executed by IDeviceContextVk::ExecuteRenderPassBundles() in the same subpass of a render
+    ///          pass begun with IDeviceContextVk::BeginRenderPassWithBundles() or advanced with
+    ///          IDeviceContextVk::NextSubpassWithBundles(), and can't be passed to IDeviceContext::ExecuteCommandLists().
+    VIRTUAL void METHOD(BeginRenderPassBundle)(THIS_
+                                               const RenderPassBundleAttribsVk REF Attribs) PURE;
+
+
+    /// Begins a render pass whose first subpass is recorded by render pass bundles
+
+    /// \param [in] Attribs - The same attributes as for IDeviceContext::BeginRenderPass().
+    ///
+    /// \remarks No draw commands can be recorded in the context until the next subpass begins or the
+    ///          render pass ends. The contents of the subpass must be provided by
+    ///          IDeviceContextVk::ExecuteRenderPassBundles().
+    VIRTUAL void METHOD(BeginRenderPassWithBundles)(THIS_
+                                                    const BeginRenderPassAttribs REF Attribs) PURE;
+
+
+    /// Advances to the next subpass, which is recorded by render pass bundles
+
+    /// \remarks See IDeviceContextVk::BeginRenderPassWithBundles().
+    VIRTUAL void METHOD(NextSubpassWithBundles)(THIS) PURE;
+
+
+    /// Executes render pass bundles in the current subpass
+
+    /// \param [in] NumBundles - The number of bundles to execute.
+    /// \param [in] ppBundles  - Command lists recorded by deferred contexts with IDeviceContextVk::BeginRenderPassBundle().
+    ///
+    /// \remarks Bundles are executed in the order they are given in the array. The method may be called
+    ///          several times in the same subpass. The render pass, subpass and framebuffer of every bundle must
+    ///          match the current ones. Like other command lists, bundles can only be executed once.
+    ///
+    ///          All pipeline and resource bindings of the context are invalidated by the call.
+    VIRTUAL void METHOD(ExecuteRenderPassBundles)(THIS_
+                                                  Uint32               NumBundles,
+                                                  ICommandList* const* ppBundles) PURE;
+
+
+    /// Enables or disables batching of command buffer submissions
+
+    /// \param [in] Enable - Whether to enable submit batching.
+    ///
+    /// \remarks When submit batching is enabled, IDeviceContext::Flush() does not submit the command buffers
+    ///          immediately. Instead, the command buffers together with the semaphore wait and signal operations
+    ///          are added to pending batches of the command queue. All pending batches are submitted with a single
+    ///          vkQueueSubmit call when IDeviceContextVk::SubmitBatchedCommands() or IDeviceContext::FinishFrame()
+    ///          is called, when the swap chain presents an image, when the context is idled, or together with
+    ///          any other work submitted to the same queue.
+    ///
+    ///          Every batched flush is still associated with its own fence value of the command queue, and
+    ///          the values are signaled in the order the flushes were performed. A flush that signals a fence
+    ///          (see IDeviceContext::EnqueueSignal()) is never deferred and submits all pending batches,
+    ///          so fences are signaled as soon as the context is flushed, as without batching.
+    ///          Other results of the batched commands, such as query data, only become available after the
+    ///          batches have been submitted.
+    ///
+    ///          Disabling submit batching submits all pending batches. Submit batching is disabled by default.
+    ///          The method must only be called for an immediate context.
+    VIRTUAL void METHOD(EnableSubmitBatching)(THIS_
+                                              bool Enable) PURE;
+
+
+    /// Submits command buffers of all batched flushes, see IDeviceContextVk::EnableSubmitBatching().
+
+    /// \remarks The method must only be called for an immediate context.
+    VIRTUAL void METHOD(SubmitBatchedCommands)(THIS) PURE;
+
+
+    /// Returns command submission statistics of the last finished frame
+
+    /// \remarks The statistics are collected by an immediate context between two calls
+    ///          to IDeviceContext::FinishFrame().
+    VIRTUAL const SubmitStatsVk REF METHOD(GetSubmitStats)(THIS) CONST PURE;
 };
 DILIGENT_END_INTERFACE
 
@@ -93,8 +271,16 @@ DILIGENT_END_INTERFACE
 
 // clang-format off
 
-#    define IDeviceContextVk_TransitionImageLayout(This, ...) CALL_IFACE_METHOD(DeviceContextVk, TransitionImageLayout, This, __VA_ARGS__)
-#    define IDeviceContextVk_BufferMemoryBarrier(This, ...)   CALL_IFACE_METHOD(DeviceContextVk, BufferMemoryBarrier,   This, __VA_ARGS__)
+#    define IDeviceContextVk_TransitionImageLayout(This, ...)      CALL_IFACE_METHOD(DeviceContextVk, TransitionImageLayout,      This, __VA_ARGS__)
+#    define IDeviceContextVk_BufferMemoryBarrier(This, ...)        CALL_IFACE_METHOD(DeviceContextVk, BufferMemoryBarrier,        This, __VA_ARGS__)
+#    define IDeviceContextVk_DefragmentMemory(This, ...)           CALL_IFACE_METHOD(DeviceContextVk, DefragmentMemory,           This, __VA_ARGS__)
+#    define IDeviceContextVk_BeginRenderPassBundle(This, ...)      CALL_IFACE_METHOD(DeviceContextVk, BeginRenderPassBundle,      This, __VA_ARGS__)
+#    define IDeviceContextVk_BeginRenderPassWithBundles(This, ...) CALL_IFACE_METHOD(DeviceContextVk, BeginRenderPassWithBundles, This, __VA_ARGS__)
+#    define IDeviceContextVk_NextSubpassWithBundles(This)          CALL_IFACE_METHOD(DeviceContextVk, NextSubpassWithBundles,     This)
+#    define IDeviceContextVk_ExecuteRenderPassBundles(This, ...)   CALL_IFACE_METHOD(DeviceContextVk, ExecuteRenderPassBundles,   This, __VA_ARGS__)
+#    define IDeviceContextVk_EnableSubmitBatching(This, ...)       CALL_IFACE_METHOD(DeviceContextVk, EnableSubmitBatching,       This, __VA_ARGS__)
+#    define IDeviceContextVk_SubmitBatchedCommands(This)           CALL_IFACE_METHOD(DeviceContextVk, SubmitBatchedCommands,      This)
+#    define IDeviceContextVk_GetSubmitStats(This)                  CALL_IFACE_METHOD(DeviceContextVk, GetSubmitStats,             This)
 
 // clang-format on
 
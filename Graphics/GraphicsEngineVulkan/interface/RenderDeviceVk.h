@@ -38,6 +38,186 @@ DILIGENT_BEGIN_NAMESPACE(Diligent)
 static const INTERFACE_ID IID_RenderDeviceVk =
     {0xab8cf3a6, 0xd959, 0x41c1, {0xae, 0x0, 0xa5, 0x8a, 0xe9, 0x82, 0xe, 0x6a}};
 
+/// Vulkan dynamic heap usage statistics, see IRenderDeviceVk::GetDynamicHeapStats().
+struct DynamicHeapStatsVk
+{
+    /// Current total size of all dynamic heap buffers, in bytes.
+    Uint64 CurrentSize DEFAULT_INITIALIZER(0);
+
+    /// Peak total size of all dynamic heap buffers, in bytes.
+    Uint64 PeakSize DEFAULT_INITIALIZER(0);
+
+    /// Current size of the dynamic memory allocated by device contexts,
+    /// including memory that is waiting for the GPU to be released, in bytes.
+    Uint64 CurrentUsedSize DEFAULT_INITIALIZER(0);
+
+    /// Peak size of the dynamic memory allocated by device contexts, in bytes.
+    Uint64 PeakUsedSize DEFAULT_INITIALIZER(0);
+
+    /// The current number of dynamic heap buffers, including the primary buffer.
+    Uint32 BufferCount DEFAULT_INITIALIZER(0);
+
+    /// The peak number of dynamic heap buffers.
+    Uint32 PeakBufferCount DEFAULT_INITIALIZER(0);
+
+    /// The number of times an overflow buffer was added to the heap.
+    Uint32 GrowCount DEFAULT_INITIALIZER(0);
+
+    /// The number of times an unused overflow buffer was released.
+    Uint32 ShrinkCount DEFAULT_INITIALIZER(0);
+};
+typedef struct DynamicHeapStatsVk DynamicHeapStatsVk;
+
+
+/// Vulkan object cache statistics, see IRenderDeviceVk::GetFramebufferCacheStats()
+/// and IRenderDeviceVk::GetImplicitRenderPassCacheStats().
+struct ObjectCacheStatsVk
+{
+    /// The number of objects currently kept in the cache.
+    Uint32 NumEntries DEFAULT_INITIALIZER(0);
+
+    /// The maximum number of objects the cache keeps, or zero if the cache is unbounded.
+    Uint32 MaxEntries DEFAULT_INITIALIZER(0);
+
+    /// The number of lookups that found an existing object.
+    Uint64 NumHits DEFAULT_INITIALIZER(0);
+
+    /// The number of lookups that created a new object.
+    Uint64 NumMisses DEFAULT_INITIALIZER(0);
+
+    /// The number of objects evicted from the cache because it exceeded its size limit.
+    Uint64 NumEvictions DEFAULT_INITIALIZER(0);
+};
+typedef struct ObjectCacheStatsVk ObjectCacheStatsVk;
+
+
+/// Descriptor set allocator statistics, see IRenderDeviceVk::GetDescriptorSetAllocatorStats().
+struct DescriptorSetAllocatorStatsVk
+{
+    /// The total number of descriptor sets allocated for shader resource bindings and signatures.
+    Uint64 AllocationCount DEFAULT_INITIALIZER(0);
+
+    /// The number of allocations that reused a released descriptor set with the same layout.
+    Uint64 RecycledCount DEFAULT_INITIALIZER(0);
+
+    /// The number of allocations that required allocating a set from a descriptor pool.
+    Uint64 PoolAllocationCount DEFAULT_INITIALIZER(0);
+
+    /// The total number of descriptor pools tried by the pool allocations.
+    Uint64 PoolScanCount DEFAULT_INITIALIZER(0);
+
+    /// The number of descriptor pools created by the allocator.
+    Uint64 NewPoolCount DEFAULT_INITIALIZER(0);
+
+    /// The number of times a thread had to wait for a mutex locked by another thread.
+    /// Locked free list stripes that a thread skips without waiting are not counted.
+    Uint64 ContentionCount DEFAULT_INITIALIZER(0);
+
+    /// The number of released descriptor sets currently kept for reuse.
+    Uint64 CachedSetCount DEFAULT_INITIALIZER(0);
+};
+typedef struct DescriptorSetAllocatorStatsVk DescriptorSetAllocatorStatsVk;
+
+
+/// Vulkan device memory page statistics, see IRenderDeviceVk::GetMemoryPageStats().
+struct MemoryPageStatsVk
+{
+    /// Vulkan memory type index of the page.
+    Uint32 MemoryTypeIndex DEFAULT_INITIALIZER(0);
+
+    /// Whether the page is host-visible.
+    Bool IsHostVisible DEFAULT_INITIALIZER(False);
+
+    /// Whether the page is being emptied by IDeviceContextVk::DefragmentMemory().
+    /// New allocations are not placed into such pages.
+    Bool IsEvacuating DEFAULT_INITIALIZER(False);
+
+    /// Page size, in bytes.
+    Uint64 Size DEFAULT_INITIALIZER(0);
+
+    /// The total size of all allocations in the page, in bytes.
+    /// Page occupancy is UsedSize / Size.
+    Uint64 UsedSize DEFAULT_INITIALIZER(0);
+
+    /// The size of the largest free block in the page, in bytes.
+    Uint64 MaxFreeBlockSize DEFAULT_INITIALIZER(0);
+
+    /// The number of free blocks in the page.
+    Uint32 NumFreeBlocks DEFAULT_INITIALIZER(0);
+};
+typedef struct MemoryPageStatsVk MemoryPageStatsVk;
+
+
+/// Vulkan memory heap budget, see IRenderDeviceVk::GetMemoryBudget().
+struct MemoryHeapBudgetVk
+{
+    /// Heap size, in bytes.
+    Uint64 Size DEFAULT_INITIALIZER(0);
+
+    /// The amount of memory the process can allocate from the heap without
+    /// allocations failing or causing performance degradation, in bytes.
+    ///
+    /// \remarks If VK_EXT_memory_budget extension is not available, the budget
+    ///          is estimated as 80% of the heap size.
+    Uint64 Budget DEFAULT_INITIALIZER(0);
+
+    /// The amount of memory the process currently uses in the heap, in bytes.
+    ///
+    /// \remarks If VK_EXT_memory_budget extension is not available, this is the
+    ///          same as AllocatedSize and does not include memory allocated outside of
+    ///          the engine's memory manager (e.g. swap chain images or the dynamic heap).
+    Uint64 Usage DEFAULT_INITIALIZER(0);
+
+    /// The total size of the memory pages the engine's memory manager
+    /// has allocated from the heap, in bytes.
+    Uint64 AllocatedSize DEFAULT_INITIALIZER(0);
+
+    /// Whether the heap is device-local.
+    Bool IsDeviceLocal DEFAULT_INITIALIZER(False);
+
+    /// Whether Budget and Usage are reported by the driver through VK_EXT_memory_budget extension.
+    Bool IsDriverReported DEFAULT_INITIALIZER(False);
+};
+typedef struct MemoryHeapBudgetVk MemoryHeapBudgetVk;
+
+
+#if DILIGENT_C_INTERFACE
+#    define REF *
+#else
+#    define REF &
+#endif
+
+/// Memory pressure callback function, see Diligent::MemoryPressureCallbackAttribsVk.
+
+/// \param [in] HeapIndex - Index of the memory heap whose usage has exceeded the high watermark.
+/// \param [in] Budget    - Current budget of the heap.
+/// \param [in] pUserData - User data provided in MemoryPressureCallbackAttribsVk::pUserData.
+typedef void(DILIGENT_CALL_TYPE* MemoryPressureCallbackType)(Uint32                       HeapIndex,
+                                                             const MemoryHeapBudgetVk REF Budget,
+                                                             void*                        pUserData);
+
+#undef REF
+
+/// Memory pressure callback attributes, see IRenderDeviceVk::SetMemoryPressureCallback().
+struct MemoryPressureCallbackAttribsVk
+{
+    /// Callback function that is invoked when the memory usage of a heap
+    /// exceeds Budget * HighWatermark. Set to null to disable the callback.
+    MemoryPressureCallbackType Callback DEFAULT_INITIALIZER(nullptr);
+
+    /// User data that is passed to the callback.
+    void* pUserData DEFAULT_INITIALIZER(nullptr);
+
+    /// The fraction of the heap budget at which the callback is invoked.
+    float HighWatermark DEFAULT_INITIALIZER(0.9f);
+
+    /// After the callback has been invoked for a heap, it is not invoked again
+    /// for the same heap until its usage drops below Budget * LowWatermark.
+    /// Must not be greater than HighWatermark.
+    float LowWatermark DEFAULT_INITIALIZER(0.8f);
+};
+typedef struct MemoryPressureCallbackAttribsVk MemoryPressureCallbackAttribsVk;
+
 #define DILIGENT_INTERFACE_NAME IRenderDeviceVk
 #include "../../../Primitives/interface/DefineInterfaceHelperMacros.h"
 
@@ -157,6 +337,84 @@ DILIGENT_BEGIN_INTERFACE(IRenderDeviceVk, IRenderDevice)
                                                        VkSemaphore         vkTimelineSemaphore,
                                                        const FenceDesc REF Desc,
                                                        IFence**            ppFence) PURE;
+
+    /// Returns the dynamic heap usage statistics
+
+    /// \param [out] Stats - Dynamic heap statistics, see Diligent::DynamicHeapStatsVk.
+    ///
+    /// \remarks The dynamic heap grows by adding overflow buffers when the primary buffer
+    ///          (see EngineVkCreateInfo::DynamicHeapSize) is exhausted, and shrinks back
+    ///          when the overflow buffers are not used for EngineVkCreateInfo::DynamicHeapShrinkDelay frames.
+    VIRTUAL void METHOD(GetDynamicHeapStats)(THIS_
+                                             DynamicHeapStatsVk REF Stats) CONST PURE;
+
+    /// Returns occupancy statistics of the device memory pages used for buffers and textures
+
+    /// \param [in, out] NumPages   - If pPageStats is null, the number of pages is written to this variable.
+    ///                              Otherwise, it must contain the size of the pPageStats array,
+    ///                              and the number of pages actually written is returned.
+    /// \param [out]     pPageStats - Array of page statistics, see Diligent::MemoryPageStatsVk.
+    ///                              May be null.
+    VIRTUAL void METHOD(GetMemoryPageStats)(THIS_
+                                            Uint32 REF         NumPages,
+                                            MemoryPageStatsVk* pPageStats) CONST PURE;
+
+    /// Returns the current budget and usage of every memory heap
+
+    /// \param [in, out] NumHeaps - If pBudgets is null, the number of heaps is written to this variable.
+    ///                            Otherwise, it must contain the size of the pBudgets array,
+    ///                            and the number of heaps actually written is returned.
+    /// \param [out]     pBudgets - Array of heap budgets, see Diligent::MemoryHeapBudgetVk.
+    ///                            May be null.
+    ///
+    /// \remarks The budget is queried from VK_EXT_memory_budget extension when it is supported by the device.
+    ///          Otherwise, the engine's internal counters are used.
+    VIRTUAL void METHOD(GetMemoryBudget)(THIS_
+                                         Uint32 REF          NumHeaps,
+                                         MemoryHeapBudgetVk* pBudgets) CONST PURE;
+
+    /// Sets the callback that is invoked when the memory usage of a heap approaches its budget
+
+    /// \param [in] Attribs - Callback attributes, see Diligent::MemoryPressureCallbackAttribsVk.
+    ///
+    /// \remarks The memory usage is checked when command buffers are submitted, and the callback
+    ///          is executed by the thread that submits the command buffer. Streaming systems can
+    ///          use the callback to evict resources before the heap is oversubscribed.
+    ///          The callback is executed while the device context is flushing, so it
+    ///          may release resources, but it must not flush, finish the frame or submit
+    ///          commands through any device context, and must not call SetMemoryPressureCallback().
+    VIRTUAL void METHOD(SetMemoryPressureCallback)(THIS_
+                                                   const MemoryPressureCallbackAttribsVk REF Attribs) PURE;
+
+    /// Returns the statistics of the framebuffer cache
+
+    /// \param [out] Stats - Framebuffer cache statistics, see Diligent::ObjectCacheStatsVk.
+    ///
+    /// \remarks The cache keeps framebuffers for render targets bound with IDeviceContext::SetRenderTargets().
+    ///          When the cache exceeds EngineVkCreateInfo::FramebufferCacheSize, least recently used
+    ///          framebuffers that have not been used for EngineVkCreateInfo::ObjectCacheEvictionDelay
+    ///          frames are released.
+    VIRTUAL void METHOD(GetFramebufferCacheStats)(THIS_
+                                                  ObjectCacheStatsVk REF Stats) CONST PURE;
+
+    /// Returns the statistics of the implicit render pass cache
+
+    /// \param [out] Stats - Render pass cache statistics, see Diligent::ObjectCacheStatsVk.
+    ///
+    /// \remarks The cache keeps render passes used by pipeline states and render targets bound with
+    ///          IDeviceContext::SetRenderTargets(). Render passes referenced by pipeline states are
+    ///          never evicted, so the cache may exceed EngineVkCreateInfo::ImplicitRenderPassCacheSize.
+    VIRTUAL void METHOD(GetImplicitRenderPassCacheStats)(THIS_
+                                                         ObjectCacheStatsVk REF Stats) CONST PURE;
+
+    /// Returns the statistics of the descriptor set allocator
+
+    /// \param [out] Stats - Descriptor set allocator statistics, see Diligent::DescriptorSetAllocatorStatsVk.
+    ///
+    /// \remarks Descriptor sets of released shader resource bindings are reused for new
+    ///          bindings with the same descriptor set layout once the GPU is done with them.
+    VIRTUAL void METHOD(GetDescriptorSetAllocatorStats)(THIS_
+                                                        DescriptorSetAllocatorStatsVk REF Stats) CONST PURE;
 };
 DILIGENT_END_INTERFACE
 
@@ -166,14 +424,21 @@ DILIGENT_END_INTERFACE
 
 // clang-format off
 
-#    define IRenderDeviceVk_GetVkDevice(This)                         CALL_IFACE_METHOD(RenderDeviceVk, GetVkDevice,                    This)
-#    define IRenderDeviceVk_GetVkPhysicalDevice(This)                 CALL_IFACE_METHOD(RenderDeviceVk, GetVkPhysicalDevice,            This)
-#    define IRenderDeviceVk_GetVkInstance(This)                       CALL_IFACE_METHOD(RenderDeviceVk, GetVkInstance,                  This)
-#    define IRenderDeviceVk_CreateTextureFromVulkanImage(This, ...)   CALL_IFACE_METHOD(RenderDeviceVk, CreateTextureFromVulkanImage,   This, __VA_ARGS__)
-#    define IRenderDeviceVk_CreateBufferFromVulkanResource(This, ...) CALL_IFACE_METHOD(RenderDeviceVk, CreateBufferFromVulkanResource, This, __VA_ARGS__)
-#    define IRenderDeviceVk_CreateBLASFromVulkanResource(This, ...)   CALL_IFACE_METHOD(RenderDeviceVk, CreateBLASFromVulkanResource,   This, __VA_ARGS__)
-#    define IRenderDeviceVk_CreateTLASFromVulkanResource(This, ...)   CALL_IFACE_METHOD(RenderDeviceVk, CreateTLASFromVulkanResource,   This, __VA_ARGS__)
-#    define IRenderDeviceVk_CreateFenceFromVulkanResource(This, ...)  CALL_IFACE_METHOD(RenderDeviceVk, CreateFenceFromVulkanResource,  This, __VA_ARGS__)
+#    define IRenderDeviceVk_GetVkDevice(This)                          CALL_IFACE_METHOD(RenderDeviceVk, GetVkDevice,                     This)
+#    define IRenderDeviceVk_GetVkPhysicalDevice(This)                  CALL_IFACE_METHOD(RenderDeviceVk, GetVkPhysicalDevice,             This)
+#    define IRenderDeviceVk_GetVkInstance(This)                        CALL_IFACE_METHOD(RenderDeviceVk, GetVkInstance,                   This)
+#    define IRenderDeviceVk_CreateTextureFromVulkanImage(This, ...)    CALL_IFACE_METHOD(RenderDeviceVk, CreateTextureFromVulkanImage,    This, __VA_ARGS__)
+#    define IRenderDeviceVk_CreateBufferFromVulkanResource(This, ...)  CALL_IFACE_METHOD(RenderDeviceVk, CreateBufferFromVulkanResource,  This, __VA_ARGS__)
+#    define IRenderDeviceVk_CreateBLASFromVulkanResource(This, ...)    CALL_IFACE_METHOD(RenderDeviceVk, CreateBLASFromVulkanResource,    This, __VA_ARGS__)
+#    define IRenderDeviceVk_CreateTLASFromVulkanResource(This, ...)    CALL_IFACE_METHOD(RenderDeviceVk, CreateTLASFromVulkanResource,    This, __VA_ARGS__)
+#    define IRenderDeviceVk_CreateFenceFromVulkanResource(This, ...)   CALL_IFACE_METHOD(RenderDeviceVk, CreateFenceFromVulkanResource,   This, __VA_ARGS__)
+#    define IRenderDeviceVk_GetDynamicHeapStats(This, ...)             CALL_IFACE_METHOD(RenderDeviceVk, GetDynamicHeapStats,             This, __VA_ARGS__)
+#    define IRenderDeviceVk_GetMemoryPageStats(This, ...)              CALL_IFACE_METHOD(RenderDeviceVk, GetMemoryPageStats,              This, __VA_ARGS__)
+#    define IRenderDeviceVk_GetMemoryBudget(This, ...)                 CALL_IFACE_METHOD(RenderDeviceVk, GetMemoryBudget,                 This, __VA_ARGS__)
+#    define IRenderDeviceVk_SetMemoryPressureCallback(This, ...)       CALL_IFACE_METHOD(RenderDeviceVk, SetMemoryPressureCallback,       This, __VA_ARGS__)
+#    define IRenderDeviceVk_GetFramebufferCacheStats(This, ...)        CALL_IFACE_METHOD(RenderDeviceVk, GetFramebufferCacheStats,        This, __VA_ARGS__)
+#    define IRenderDeviceVk_GetImplicitRenderPassCacheStats(This, ...) CALL_IFACE_METHOD(RenderDeviceVk, GetImplicitRenderPassCacheStats, This, __VA_ARGS__)
+#    define IRenderDeviceVk_GetDescriptorSetAllocatorStats(This, ...)  CALL_IFACE_METHOD(RenderDeviceVk, GetDescriptorSetAllocatorStats,  This, __VA_ARGS__)
 
 // clang-format on
 
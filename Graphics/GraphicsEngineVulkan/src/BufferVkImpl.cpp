@@ -444,9 +444,20 @@ BufferVkImpl::BufferVkImpl(IReferenceCounters*        pRefCounters,
         }
 
         SetState(InitialState);
+
+        constexpr BIND_FLAGS RelocatableBindFlags = BIND_VERTEX_BUFFER | BIND_INDEX_BUFFER | BIND_INDIRECT_DRAW_ARGS;
+
+        m_IsRelocatable =
+            (m_Desc.Usage == USAGE_DEFAULT || m_Desc.Usage == USAGE_IMMUTABLE) &&
+            (m_Desc.BindFlags & ~RelocatableBindFlags) == 0 &&
+            PlatformMisc::CountOneBits(m_Desc.ImmediateContextMask) == 1;
     }
 
     VERIFY_EXPR(IsInKnownState());
+
+    // Register the buffer when nothing can throw anymore, so that it is always unregistered by the destructor
+    if (m_IsRelocatable)
+        pRenderDeviceVk->RegisterRelocatableBuffer(*this);
 }
 
 
@@ -474,6 +485,9 @@ BufferVkImpl::BufferVkImpl(IReferenceCounters*        pRefCounters,
 
 BufferVkImpl::~BufferVkImpl()
 {
+    if (m_IsRelocatable)
+        m_pDevice->UnregisterRelocatableBuffer(*this);
+
     // Vk object can only be destroyed when it is no longer used by the GPU
     if (m_VulkanBuffer != VK_NULL_HANDLE)
         m_pDevice->SafeReleaseDeviceObject(std::move(m_VulkanBuffer), m_Desc.ImmediateContextMask);
@@ -481,6 +495,60 @@ BufferVkImpl::~BufferVkImpl()
         m_pDevice->SafeReleaseDeviceObject(std::move(m_MemoryAllocation), m_Desc.ImmediateContextMask);
 }
 
+bool BufferVkImpl::Relocate(VulkanUtilities::VulkanCommandBuffer& CmdBuffer)
+{
+    VERIFY_EXPR(m_IsRelocatable && m_VulkanBuffer != VK_NULL_HANDLE && m_MemoryAllocation.Page != nullptr);
+
+    const auto& LogicalDevice = m_pDevice->GetLogicalDevice();
+
+    VkBufferCreateInfo VkBuffCI{};
+    VkBuffCI.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    VkBuffCI.size        = m_Desc.Size;
+    VkBuffCI.usage       = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    VkBuffCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (m_Desc.BindFlags & BIND_VERTEX_BUFFER)
+        VkBuffCI.usage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    if (m_Desc.BindFlags & BIND_INDEX_BUFFER)
+        VkBuffCI.usage |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+    if (m_Desc.BindFlags & BIND_INDIRECT_DRAW_ARGS)
+        VkBuffCI.usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+
+    auto NewBuffer = LogicalDevice.CreateBuffer(VkBuffCI, m_Desc.Name);
+    auto MemReqs   = LogicalDevice.GetBufferMemoryRequirements(NewBuffer);
+
+    // The new buffer is placed into a page of the same memory type as the current one,
+    // provided that the type is allowed by the memory requirements of the new buffer.
+    auto NewAllocation = m_pDevice->GetGlobalMemoryManager().AllocateForRelocation(*m_MemoryAllocation.Page, MemReqs);
+    if (NewAllocation.Page == nullptr)
+        return false; // The new buffer has never been used and is destroyed immediately
+
+    const auto AlignedOffset = AlignUp(VkDeviceSize{NewAllocation.UnalignedOffset}, MemReqs.alignment);
+    VERIFY(NewAllocation.Size >= MemReqs.size + (AlignedOffset - NewAllocation.UnalignedOffset), "Size of memory allocation is too small");
+
+    auto err = LogicalDevice.BindBufferMemory(NewBuffer, NewAllocation.Page->GetVkMemory(), AlignedOffset);
+    if (err != VK_SUCCESS)
+    {
+        LOG_ERROR_MESSAGE("Failed to bind memory to the relocated buffer '", m_Desc.Name, '\'');
+        return false;
+    }
+
+    VkBufferCopy CopyRegion{};
+    CopyRegion.srcOffset = 0;
+    CopyRegion.dstOffset = 0;
+    CopyRegion.size      = m_Desc.Size;
+    CmdBuffer.CopyBuffer(m_VulkanBuffer, NewBuffer, 1, &CopyRegion);
+
+    // The old buffer may still be used by the GPU
+    m_pDevice->SafeReleaseDeviceObject(std::move(m_VulkanBuffer), m_Desc.ImmediateContextMask);
+    m_pDevice->SafeReleaseDeviceObject(std::move(m_MemoryAllocation), m_Desc.ImmediateContextMask);
+
+    m_VulkanBuffer              = std::move(NewBuffer);
+    m_MemoryAllocation          = std::move(NewAllocation);
+    m_BufferMemoryAlignedOffset = AlignedOffset;
+
+    return true;
+}
+
 void BufferVkImpl::CreateViewInternal(const BufferViewDesc& OrigViewDesc, IBufferView** ppView, bool bIsDefaultView)
 {
     VERIFY(ppView != nullptr, "Null pointer provided");
@@ -27,10 +27,13 @@
 
 #include "pch.h"
 #include <thread>
+#include <array>
+#include <vector>
 
 #include "CommandQueueVkImpl.hpp"
 #include "RenderDeviceVkImpl.hpp"
 #include "VulkanUtilities/VulkanDebug.hpp"
+#include "Align.hpp"
 
 namespace Diligent
 {
@@ -51,7 +54,7 @@ CommandQueueVkImpl::CommandQueueVkImpl(IReferenceCounters*
     m_NumCommandQueues          {static_cast<Uint8>(m_SupportedTimelineSemaphore ? 1u : NumCommandQueues)},
     m_NextFenceValue            {1},
     m_SyncObjectManager         {std::make_shared<VulkanUtilities::VulkanSyncObjectManager>(*LogicalDevice)},
-    m_SyncPointAllocator        {GetRawAllocator(), SyncPointVk::SizeOf(m_NumCommandQueues), 16}
+    m_SyncPointPool             {std::make_shared<SyncPointPool>(SyncPointVk::SizeOf(m_NumCommandQueues), 64)}
 // clang-format on
 {
     VERIFY(m_CommandQueueId == CommandQueueId, "Not enough bits to store command queue index");
@@ -59,12 +62,12 @@ CommandQueueVkImpl::CommandQueueVkImpl(IReferenceCounters*
 
     if (CreateInfo.Name != nullptr)
         VulkanUtilities::SetQueueName(m_LogicalDevice->GetVkDevice(), m_VkQueue, CreateInfo.Name);
-
-    m_TempSignalSemaphores.reserve(16);
 }
 
 CommandQueueVkImpl::~CommandQueueVkImpl()
 {
+    DEV_CHECK_ERR(m_LastPendingFenceValue.load() == 0, "Destroying command queue that has pending batches. The queue must be idled first.");
+
     // Fence have resources that will be added to release queue.
     // But release queue will be destroyed after command queue and it will not release new resources.
     if (m_pFence)
@@ -80,9 +83,7 @@ CommandQueueVkImpl::~CommandQueueVkImpl()
 
 SyncPointVk::SyncPointVk(SoftwareQueueIndex                        CommandQueueId,
                          Uint32                                    NumContexts,
-                         VulkanUtilities::VulkanSyncObjectManager& SyncObjectMngr,
-                         VkDevice                                  LogicalDevice,
-                         Uint64                                    dbgValue) :
+                         VulkanUtilities::VulkanSyncObjectManager& SyncObjectMngr) :
     m_CommandQueueId{CommandQueueId},
     m_NumSemaphores{static_cast<Uint8>(NumContexts)},
     m_Fence{SyncObjectMngr.CreateFence()}
@@ -102,21 +103,24 @@ SyncPointVk::SyncPointVk(SoftwareQueueIndex                        CommandQueueI
         // Semaphore for the current queue is not used.
         std::swap(m_Semaphores[CommandQueueId], m_Semaphores[NumContexts - 1]);
     }
+}
 
 #ifdef DILIGENT_DEBUG
-    String Name = String{"Queue ("} + std::to_string(CommandQueueId) + ") Value (" + std::to_string(dbgValue) + ")";
+void SyncPointVk::SetDebugNames(VkDevice LogicalDevice, Uint64 Value)
+{
+    String Name = String{"Queue ("} + std::to_string(m_CommandQueueId) + ") Value (" + std::to_string(Value) + ")";
     VulkanUtilities::SetFenceName(LogicalDevice, m_Fence, Name.c_str());
 
     for (Uint32 s = 0; s < m_NumSemaphores; ++s)
     {
         if (m_Semaphores[s])
         {
-            Name = String{"Queue ("} + std::to_string(CommandQueueId) + ") Value (" + std::to_string(dbgValue) + ") Ctx (" + std::to_string(s) + ")";
+            Name = String{"Queue ("} + std::to_string(m_CommandQueueId) + ") Value (" + std::to_string(Value) + ") Ctx (" + std::to_string(s) + ")";
             VulkanUtilities::SetSemaphoreName(LogicalDevice, m_Semaphores[s], Name.c_str());
         }
     }
-#endif
 }
+#endif
 
 SyncPointVk::~SyncPointVk()
 {
@@ -125,81 +129,319 @@ SyncPointVk::~SyncPointVk()
         m_Semaphores[s].~RecycledSyncObject();
 }
 
-__forceinline void SyncPointVk::GetSemaphores(std::vector<VkSemaphore>& Semaphores)
+__forceinline Uint32 SyncPointVk::GetSemaphores(VkSemaphore* pSemaphores) const
 {
+    Uint32 Count = 0;
     for (Uint32 s = 0; s < m_NumSemaphores; ++s)
     {
         if (m_Semaphores[s])
-            Semaphores.push_back(m_Semaphores[s]);
+            pSemaphores[Count++] = m_Semaphores[s];
+    }
+    return Count;
+}
+
+CommandQueueVkImpl::SyncPointPool::SyncPointPool(size_t SyncPointSize, size_t NumBlocks) :
+    m_SyncPointSize{SyncPointSize},
+    // Control block is placed right after the sync point
+    m_BlockSize{AlignUp(SyncPointSize, sizeof(void*) * 2) + ControlBlockSize},
+    m_NumBlocks{NumBlocks},
+    m_FreeBlocks{NumBlocks}
+{
+    m_pMemory = static_cast<Uint8*>(GetRawAllocator().Allocate(m_BlockSize * m_NumBlocks, "Sync point pool", __FILE__, __LINE__));
+    for (size_t i = 0; i < m_NumBlocks; ++i)
+    {
+        const auto Enqueued = m_FreeBlocks.Enqueue(m_pMemory + i * m_BlockSize);
+        VERIFY_EXPR(Enqueued);
+        (void)Enqueued;
+    }
+}
+
+CommandQueueVkImpl::SyncPointPool::~SyncPointPool()
+{
+    GetRawAllocator().Free(m_pMemory);
+}
+
+void* CommandQueueVkImpl::SyncPointPool::Allocate()
+{
+    void* pBlock = nullptr;
+    if (m_FreeBlocks.Dequeue(pBlock))
+        return pBlock;
+
+    // All pre-allocated blocks are in use
+    return GetRawAllocator().Allocate(m_BlockSize, "Sync point", __FILE__, __LINE__);
+}
+
+void CommandQueueVkImpl::SyncPointPool::Free(void* pBlock)
+{
+    const auto* pBytes = static_cast<const Uint8*>(pBlock);
+    if (pBytes >= m_pMemory && pBytes < m_pMemory + m_BlockSize * m_NumBlocks)
+    {
+        const auto Enqueued = m_FreeBlocks.Enqueue(pBlock);
+        VERIFY(Enqueued, "The queue capacity is not less than the number of pre-allocated blocks, so this should never fail");
+        (void)Enqueued;
+    }
+    else
+    {
+        GetRawAllocator().Free(pBlock);
     }
 }
 
-__forceinline SyncPointVkPtr CommandQueueVkImpl::CreateSyncPoint(Uint64 dbgValue)
+// Allocates the shared_ptr control block in the same memory block as the sync point.
+// The control block is released after the sync point has been destroyed, so it returns
+// the whole block to the pool.
+template <typename T>
+class CommandQueueVkImpl::SyncPointControlBlockAllocator
+{
+public:
+    using value_type = T;
+
+    SyncPointControlBlockAllocator(std::shared_ptr<SyncPointPool> pPool, void* pBlock) noexcept :
+        m_pPool{std::move(pPool)},
+        m_pBlock{pBlock}
+    {}
+
+    template <typename U>
+    SyncPointControlBlockAllocator(const SyncPointControlBlockAllocator<U>& Other) noexcept :
+        m_pPool{Other.m_pPool},
+        m_pBlock{Other.m_pBlock}
+    {}
+
+    T* allocate(size_t Count)
+    {
+        const auto Size = sizeof(T) * Count;
+        if (Size <= SyncPointPool::ControlBlockSize)
+        {
+            return reinterpret_cast<T*>(static_cast<Uint8*>(m_pBlock) + AlignUp(m_pPool->GetSyncPointSize(), sizeof(void*) * 2));
+        }
+        else
+        {
+            // Control block does not fit into the reserved space
+            return static_cast<T*>(GetRawAllocator().Allocate(Size, "Sync point control block", __FILE__, __LINE__));
+        }
+    }
+
+    void deallocate(T* p, size_t Count)
+    {
+        if (sizeof(T) * Count > SyncPointPool::ControlBlockSize)
+            GetRawAllocator().Free(p);
+        // Copy the pool pointer as the allocator may be a part of the control block
+        auto pPool = m_pPool;
+        pPool->Free(m_pBlock);
+    }
+
+    template <typename U>
+    bool operator==(const SyncPointControlBlockAllocator<U>& Other) const noexcept { return m_pBlock == Other.m_pBlock; }
+    template <typename U>
+    bool operator!=(const SyncPointControlBlockAllocator<U>& Other) const noexcept { return m_pBlock != Other.m_pBlock; }
+
+private:
+    template <typename U>
+    friend class SyncPointControlBlockAllocator;
+
+    std::shared_ptr<SyncPointPool> m_pPool;
+    void*                          m_pBlock;
+};
+
+__forceinline SyncPointVkPtr CommandQueueVkImpl::CreateSyncPoint()
 {
-    auto* pAllocator = &m_SyncPointAllocator;
-    void* ptr        = pAllocator->Allocate(SyncPointVk::SizeOf(m_NumCommandQueues), "SyncPointVk", __FILE__, __LINE__);
-    auto  Deleter    = [pAllocator](SyncPointVk* ptr) //
+    void* pBlock  = m_SyncPointPool->Allocate();
+    auto  Deleter = [](SyncPointVk* ptr) //
     {
+        // Memory is released with the control block
         ptr->~SyncPointVk();
-        pAllocator->Free(ptr);
     };
 
-    return {new (ptr) SyncPointVk{m_CommandQueueId, m_NumCommandQueues, *m_SyncObjectManager, m_LogicalDevice->GetVkDevice(), dbgValue}, std::move(Deleter)};
+    auto* pSyncPoint = new (pBlock) SyncPointVk{m_CommandQueueId, m_NumCommandQueues, *m_SyncObjectManager};
+    return SyncPointVkPtr{pSyncPoint, std::move(Deleter), SyncPointControlBlockAllocator<SyncPointVk>{m_SyncPointPool, pBlock}};
 }
 
-Uint64 CommandQueueVkImpl::Submit(const VkSubmitInfo& InSubmitInfo)
+void CommandQueueVkImpl::OnSyncPointSubmitted(Uint64 FenceValue, SyncPointVkPtr&& SyncPoint)
 {
-    std::lock_guard<std::mutex> QueueGuard{m_QueueMutex};
+#ifdef DILIGENT_DEBUG
+    SyncPoint->SetDebugNames(m_LogicalDevice->GetVkDevice(), FenceValue);
+#endif
 
-    // Increment the value before submitting the buffer to be overly safe
-    const uint64_t FenceValue = m_NextFenceValue.fetch_add(1);
+    VERIFY(m_pFence != nullptr, "Command queue fence has not been initialized");
+    m_pFence->AddPendingSyncPoint(m_CommandQueueId, FenceValue, SyncPoint);
 
-    auto NewSyncPoint = CreateSyncPoint(FenceValue);
+    // Update the last sync point
+    {
+        Threading::SpinLockGuard SyncPointGuard{m_LastSyncPointLock};
+        m_LastSyncPoint = std::move(SyncPoint);
+    }
+}
 
-    m_TempSignalSemaphores.clear();
-    NewSyncPoint->GetSemaphores(m_TempSignalSemaphores);
+namespace
+{
 
 #ifdef DILIGENT_DEBUG
-    const VkBaseInStructure* pStruct = static_cast<const VkBaseInStructure*>(InSubmitInfo.pNext);
-    for (; pStruct != nullptr;)
+void VerifyNoTimelineSemaphoreInfo(const void* pNext)
+{
+    for (const auto* pStruct = static_cast<const VkBaseInStructure*>(pNext); pStruct != nullptr; pStruct = pStruct->pNext)
+    {
+        VERIFY(pStruct->sType != VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO, "Can not append semaphores when timeline semaphores are used");
+    }
+}
+#endif
+
+// Small array that only allocates memory when the number of elements exceeds the inline capacity
+template <typename T, size_t InlineCapacity>
+class TempArray
+{
+public:
+    explicit TempArray(size_t Size)
     {
-        if (pStruct->sType == VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO)
+        if (Size > InlineCapacity)
         {
-            VERIFY(m_TempSignalSemaphores.empty(), "Can not append semaphores when timeline semaphores are used");
-            break;
+            m_Heap.resize(Size);
+            m_pData = m_Heap.data();
         }
-        pStruct = pStruct->pNext;
     }
-#endif
 
+    T* data() { return m_pData; }
+
+    T& operator[](size_t i) { return m_pData[i]; }
+
+private:
+    std::array<T, InlineCapacity> m_Inline;
+    std::vector<T>                m_Heap;
+    T*                            m_pData = m_Inline.data();
+};
+
+} // namespace
+
+Uint64 CommandQueueVkImpl::Submit(const VkSubmitInfo& InSubmitInfo)
+{
+    // The sync point and signal semaphores do not depend on the fence value,
+    // so prepare them before locking the queue.
+    auto NewSyncPoint = CreateSyncPoint();
+
+    TempArray<VkSemaphore, 16> SignalSemaphores{size_t{NewSyncPoint->GetNumContexts()} + InSubmitInfo.signalSemaphoreCount};
+
+    Uint32 SignalSemaphoreCount = NewSyncPoint->GetSemaphores(SignalSemaphores.data());
+#ifdef DILIGENT_DEBUG
+    if (SignalSemaphoreCount > 0)
+        VerifyNoTimelineSemaphoreInfo(InSubmitInfo.pNext);
+#endif
     for (uint32_t s = 0; s < InSubmitInfo.signalSemaphoreCount; ++s)
-        m_TempSignalSemaphores.push_back(InSubmitInfo.pSignalSemaphores[s]);
+        SignalSemaphores[SignalSemaphoreCount++] = InSubmitInfo.pSignalSemaphores[s];
 
     VkSubmitInfo SubmitInfo         = InSubmitInfo;
-    SubmitInfo.signalSemaphoreCount = static_cast<Uint32>(m_TempSignalSemaphores.size());
-    SubmitInfo.pSignalSemaphores    = m_TempSignalSemaphores.data();
+    SubmitInfo.signalSemaphoreCount = SignalSemaphoreCount;
+    SubmitInfo.pSignalSemaphores    = SignalSemaphores.data();
+
+    const bool IsEmpty =
+        (SubmitInfo.waitSemaphoreCount == 0 &&
+         SubmitInfo.commandBufferCount == 0 &&
+         SubmitInfo.signalSemaphoreCount == 0);
 
-    const uint32_t SubmitCount =
-        (SubmitInfo.waitSemaphoreCount != 0 ||
-         SubmitInfo.commandBufferCount != 0 ||
-         SubmitInfo.signalSemaphoreCount != 0) ?
-        1 :
-        0;
+    // Batches that can't be merged with the pending ones are submitted separately
+    const bool     CanMerge = VulkanUtilities::VulkanSubmitBatch::IsSupported(SubmitInfo);
+    SyncPointVkPtr PendingSyncPoint;
+    if (!CanMerge)
+        PendingSyncPoint = PreparePendingBatchesSyncPoint();
+
+    std::lock_guard<std::mutex> QueueGuard{m_QueueMutex};
 
-    auto err = vkQueueSubmit(m_VkQueue, SubmitCount, &SubmitInfo, NewSyncPoint->GetFence());
+    if (m_LastPendingFenceValue.load() != 0)
+    {
+        if (CanMerge)
+        {
+            // Submit the new batch together with the pending ones
+            m_PendingBatches.Add(SubmitInfo);
+        }
+        else
+        {
+            SubmitPendingBatchesLocked(PendingSyncPoint);
+        }
+    }
+
+    // Increment the value before submitting the buffer to be overly safe
+    const uint64_t FenceValue = m_NextFenceValue.fetch_add(1);
+
+    VkResult err = VK_SUCCESS;
+    if (m_LastPendingFenceValue.load() != 0)
+    {
+        // The new fence value is greater than the values reserved for the pending
+        // batches, so the sync point signals all of them.
+        err = vkQueueSubmit(m_VkQueue, m_PendingBatches.GetBatchCount(), m_PendingBatches.GetSubmitInfos(), NewSyncPoint->GetFence());
+        m_PendingBatches.Clear();
+        m_LastPendingFenceValue.store(0);
+    }
+    else
+    {
+        // Empty submit only signals the fence
+        err = vkQueueSubmit(m_VkQueue, IsEmpty ? 0 : 1, &SubmitInfo, NewSyncPoint->GetFence());
+    }
     DEV_CHECK_ERR(err == VK_SUCCESS, "Failed to submit command buffer to the command queue");
     (void)err;
+    m_SubmitCount.fetch_add(1);
 
-    VERIFY(m_pFence != nullptr, "Command queue fence has not been initialized");
-    m_pFence->AddPendingSyncPoint(m_CommandQueueId, FenceValue, NewSyncPoint);
+    OnSyncPointSubmitted(FenceValue, std::move(NewSyncPoint));
 
-    // Update the last sync point
+    return FenceValue;
+}
+
+Uint64 CommandQueueVkImpl::Submit(const VkSubmitInfo& SubmitInfo, bool DeferSubmission)
+{
+    if (!DeferSubmission || !VulkanUtilities::VulkanSubmitBatch::IsSupported(SubmitInfo))
+        return Submit(SubmitInfo);
+
+    std::lock_guard<std::mutex> QueueGuard{m_QueueMutex};
+
+    m_PendingBatches.Add(SubmitInfo);
+
+    // Reserve the fence value. It will be signaled by the sync point of
+    // the submission that includes the pending batches.
+    const auto FenceValue = m_NextFenceValue.fetch_add(1);
+    m_LastPendingFenceValue.store(FenceValue);
+
+    return FenceValue;
+}
+
+void CommandQueueVkImpl::SubmitPendingBatches()
+{
+    auto PendingSyncPoint = PreparePendingBatchesSyncPoint();
+
+    std::lock_guard<std::mutex> QueueGuard{m_QueueMutex};
+    SubmitPendingBatchesLocked(PendingSyncPoint);
+}
+
+SyncPointVkPtr CommandQueueVkImpl::PreparePendingBatchesSyncPoint()
+{
+    // Another thread may add or submit pending batches before the queue is locked.
+    // SubmitPendingBatchesLocked() handles both cases.
+    return m_LastPendingFenceValue.load() != 0 ? CreateSyncPoint() : SyncPointVkPtr{};
+}
+
+void CommandQueueVkImpl::SubmitPendingBatchesLocked(SyncPointVkPtr& SyncPoint)
+{
+    const auto LastPendingFenceValue = m_LastPendingFenceValue.load();
+    if (LastPendingFenceValue == 0)
     {
-        Threading::SpinLockGuard SyncPointGuard{m_LastSyncPointLock};
-        m_LastSyncPoint = std::move(NewSyncPoint);
+        VERIFY_EXPR(m_PendingBatches.IsEmpty());
+        return;
     }
 
-    return FenceValue;
+    // The sync point is normally prepared before the queue is locked, unless
+    // the batches have been added after PreparePendingBatchesSyncPoint() was called.
+    auto NewSyncPoint = SyncPoint ? std::move(SyncPoint) : CreateSyncPoint();
+
+    TempArray<VkSemaphore, 16> SignalSemaphores{NewSyncPoint->GetNumContexts()};
+
+    const auto SignalSemaphoreCount = NewSyncPoint->GetSemaphores(SignalSemaphores.data());
+    m_PendingBatches.AppendSignalSemaphores(SignalSemaphores.data(), SignalSemaphoreCount);
+
+    auto err = vkQueueSubmit(m_VkQueue, m_PendingBatches.GetBatchCount(), m_PendingBatches.GetSubmitInfos(), NewSyncPoint->GetFence());
+    DEV_CHECK_ERR(err == VK_SUCCESS, "Failed to submit pending batches to the command queue");
+    (void)err;
+    m_SubmitCount.fetch_add(1);
+
+    // All fence values reserved for the pending batches are not greater than the last one
+    OnSyncPointSubmitted(LastPendingFenceValue, std::move(NewSyncPoint));
+
+    m_PendingBatches.Clear();
+    m_LastPendingFenceValue.store(0);
 }
 
 Uint64 CommandQueueVkImpl::SubmitCmdBuffer(VkCommandBuffer cmdBuffer)
@@ -223,8 +465,12 @@ Uint64 CommandQueueVkImpl::SubmitCmdBuffer(VkCommandBuffer cmdBuffer)
 
 Uint64 CommandQueueVkImpl::WaitForIdle()
 {
+    auto PendingSyncPoint = PreparePendingBatchesSyncPoint();
+
     std::lock_guard<std::mutex> QueueGuard{m_QueueMutex};
 
+    SubmitPendingBatchesLocked(PendingSyncPoint);
+
     // Update last completed fence value to unlock all waiting events.
     const auto FenceValue = m_NextFenceValue.fetch_add(1);
 
@@ -245,16 +491,24 @@ void CommandQueueVkImpl::EnqueueSignalFence(VkFence vkFence)
 {
     DEV_CHECK_ERR(vkFence != VK_NULL_HANDLE, "vkFence must not be null");
 
+    auto PendingSyncPoint = PreparePendingBatchesSyncPoint();
+
     std::lock_guard<std::mutex> QueueGuard{m_QueueMutex};
 
+    SubmitPendingBatchesLocked(PendingSyncPoint);
+
     auto err = vkQueueSubmit(m_VkQueue, 0, nullptr, vkFence);
     DEV_CHECK_ERR(err == VK_SUCCESS, "Failed to submit fence signal command to the command queue");
     (void)err;
+    m_SubmitCount.fetch_add(1);
 }
 
 void CommandQueueVkImpl::EnqueueSignal(VkSemaphore vkTimelineSemaphore, Uint64 Value)
 {
+    auto PendingSyncPoint = PreparePendingBatchesSyncPoint();
+
     std::lock_guard<std::mutex> QueueGuard{m_QueueMutex};
+    SubmitPendingBatchesLocked(PendingSyncPoint);
     InternalSignalSemaphore(vkTimelineSemaphore, Value);
 }
 
@@ -282,58 +536,51 @@ void CommandQueueVkImpl::InternalSignalSemaphore(VkSemaphore vkTimelineSemaphore
     auto err = vkQueueSubmit(m_VkQueue, 1, &SubmitInfo, VK_NULL_HANDLE);
     DEV_CHECK_ERR(err == VK_SUCCESS, "Failed to submit timeline semaphore signal command to the command queue");
     (void)err;
+    m_SubmitCount.fetch_add(1);
 }
 
 VkResult CommandQueueVkImpl::Present(const VkPresentInfoKHR& PresentInfo)
 {
+    auto PendingSyncPoint = PreparePendingBatchesSyncPoint();
+
     std::lock_guard<std::mutex> QueueGuard{m_QueueMutex};
+    // Semaphores the presentation waits for may be signaled by pending batches
+    SubmitPendingBatchesLocked(PendingSyncPoint);
     return vkQueuePresentKHR(m_VkQueue, &PresentInfo);
 }
 
 Uint64 CommandQueueVkImpl::BindSparse(const VkBindSparseInfo& InBindInfo)
 {
-    std::lock_guard<std::mutex> QueueGuard{m_QueueMutex};
-
-    // Increment the value before submitting the buffer to be overly safe
-    const uint64_t FenceValue = m_NextFenceValue.fetch_add(1);
-
-    auto NewSyncPoint = CreateSyncPoint(FenceValue);
+    auto NewSyncPoint = CreateSyncPoint();
 
-    m_TempSignalSemaphores.clear();
-    NewSyncPoint->GetSemaphores(m_TempSignalSemaphores);
+    TempArray<VkSemaphore, 16> SignalSemaphores{size_t{NewSyncPoint->GetNumContexts()} + InBindInfo.signalSemaphoreCount};
 
+    Uint32 SignalSemaphoreCount = NewSyncPoint->GetSemaphores(SignalSemaphores.data());
 #ifdef DILIGENT_DEBUG
-    const VkBaseInStructure* pStruct = static_cast<const VkBaseInStructure*>(InBindInfo.pNext);
-    for (; pStruct != nullptr;)
-    {
-        if (pStruct->sType == VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO)
-        {
-            VERIFY(m_TempSignalSemaphores.empty(), "Can not append semaphores when timeline semaphores are used");
-            break;
-        }
-        pStruct = pStruct->pNext;
-    }
+    if (SignalSemaphoreCount > 0)
+        VerifyNoTimelineSemaphoreInfo(InBindInfo.pNext);
 #endif
-
     for (uint32_t s = 0; s < InBindInfo.signalSemaphoreCount; ++s)
-        m_TempSignalSemaphores.push_back(InBindInfo.pSignalSemaphores[s]);
+        SignalSemaphores[SignalSemaphoreCount++] = InBindInfo.pSignalSemaphores[s];
 
     VkBindSparseInfo BindInfo     = InBindInfo;
-    BindInfo.signalSemaphoreCount = static_cast<Uint32>(m_TempSignalSemaphores.size());
-    BindInfo.pSignalSemaphores    = m_TempSignalSemaphores.data();
+    BindInfo.signalSemaphoreCount = SignalSemaphoreCount;
+    BindInfo.pSignalSemaphores    = SignalSemaphores.data();
+
+    auto PendingSyncPoint = PreparePendingBatchesSyncPoint();
+
+    std::lock_guard<std::mutex> QueueGuard{m_QueueMutex};
+
+    SubmitPendingBatchesLocked(PendingSyncPoint);
+
+    // Increment the value before submitting the buffer to be overly safe
+    const uint64_t FenceValue = m_NextFenceValue.fetch_add(1);
 
     auto err = vkQueueBindSparse(m_VkQueue, 1, &BindInfo, NewSyncPoint->GetFence());
     DEV_CHECK_ERR(err == VK_SUCCESS, "Failed to submit sparse bind commands to the command queue");
     (void)err;
 
-    VERIFY(m_pFence != nullptr, "Command queue fence has not been initialized");
-    m_pFence->AddPendingSyncPoint(m_CommandQueueId, FenceValue, NewSyncPoint);
-
-    // Update the last sync point
-    {
-        Threading::SpinLockGuard SyncPointGuard{m_LastSyncPointLock};
-        m_LastSyncPoint = std::move(NewSyncPoint);
-    }
+    OnSyncPointSubmitted(FenceValue, std::move(NewSyncPoint));
 
     return FenceValue;
 }
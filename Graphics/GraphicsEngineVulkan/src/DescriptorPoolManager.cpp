@@ -36,8 +36,8 @@ void DescriptorSetAllocation::Release()
 {
     if (Set != VK_NULL_HANDLE)
     {
-        VERIFY_EXPR(DescrSetAllocator != nullptr && Pool != VK_NULL_HANDLE);
-        DescrSetAllocator->FreeDescriptorSet(Set, Pool, CmdQueueMask);
+        VERIFY_EXPR(DescrSetAllocator != nullptr && Pool != VK_NULL_HANDLE && Layout != VK_NULL_HANDLE);
+        DescrSetAllocator->FreeDescriptorSet(Set, Pool, Layout, CmdQueueMask);
 
         Reset();
     }
@@ -193,51 +193,189 @@ static VkDescriptorSet AllocateDescriptorSet(const VulkanUtilities::VulkanLogica
 DescriptorSetAllocator::~DescriptorSetAllocator()
 {
     DEV_CHECK_ERR(m_AllocatedSetCounter == 0, m_AllocatedSetCounter, " descriptor set(s) have not been returned to the allocator. If there are outstanding references to the sets in release queues, the app will crash when DescriptorSetAllocator::FreeDescriptorSet() is called");
+
+    DescriptorSetAllocatorStatsVk Stats;
+    GetStats(Stats);
+    LOG_INFO_MESSAGE(m_PoolName, " descriptor set stats: ", Stats.AllocationCount, " allocation(s), ",
+                     Stats.RecycledCount, " recycled, ", Stats.NewPoolCount, " new pool(s), ",
+                     Stats.ContentionCount, " contended lock(s)");
+
+    // Recycled sets are implicitly freed when their pools are destroyed
+}
+
+// Returns the index of the calling thread that is used to select its home free list stripe
+static size_t GetThreadIndex()
+{
+    static std::atomic<size_t> NextIndex{0};
+    thread_local const size_t  Index = NextIndex.fetch_add(1);
+    return Index;
 }
 
 DescriptorSetAllocation DescriptorSetAllocator::Allocate(Uint64 CommandQueueMask, VkDescriptorSetLayout SetLayout, const char* DebugName)
 {
-    // Descriptor pools are externally synchronized, meaning that the application must not allocate
-    // and/or free descriptor sets from the same pool in multiple threads simultaneously (13.2.3)
-    std::lock_guard<std::mutex> Lock{m_Mutex};
+    VERIFY_EXPR(SetLayout != VK_NULL_HANDLE);
+    m_AllocationCount.fetch_add(1, std::memory_order_relaxed);
 
     const auto& LogicalDevice = m_DeviceVkImpl.GetLogicalDevice();
-    // Try all pools starting from the frontmost
-    for (auto it = m_Pools.begin(); it != m_Pools.end(); ++it)
+
+    // Try to reuse a set released earlier: start with this thread's home stripe, and only
+    // look into other stripes if they are not locked.
+    if (m_CachedSetCount.load(std::memory_order_relaxed) > 0)
     {
-        auto& Pool = *it;
-        auto  Set  = AllocateDescriptorSet(LogicalDevice, Pool, SetLayout, DebugName);
-        if (Set != VK_NULL_HANDLE)
+        const auto HomeStripe = GetThreadIndex() % NumStripes;
+        for (size_t i = 0; i < NumStripes; ++i)
         {
-            // Move the pool to the front
-            if (it != m_Pools.begin())
+            auto& Stripe = m_Stripes[(HomeStripe + i) % NumStripes];
+
+            std::unique_lock<std::mutex> StripeLock{Stripe.Mtx, std::try_to_lock};
+            if (!StripeLock.owns_lock())
             {
-                std::swap(*it, m_Pools.front());
+                // Skip locked stripes other than the home one
+                if (i != 0)
+                    continue;
+                m_ContentionCount.fetch_add(1, std::memory_order_relaxed);
+                StripeLock.lock();
             }
 
+            auto it = Stripe.FreeLists.find(SetLayout);
+            if (it == Stripe.FreeLists.end() || it->second.empty())
+                continue;
+
+            const auto Recycled = it->second.back();
+            it->second.pop_back();
+            StripeLock.unlock();
+
+            m_CachedSetCount.fetch_sub(1, std::memory_order_relaxed);
+            m_RecycledCount.fetch_add(1, std::memory_order_relaxed);
 #ifdef DILIGENT_DEVELOPMENT
             ++m_AllocatedSetCounter;
 #endif
-            return {Set, Pool, CommandQueueMask, *this};
+            if (DebugName != nullptr && *DebugName != 0)
+                VulkanUtilities::SetDescriptorSetName(LogicalDevice.GetVkDevice(), Recycled.Set, DebugName);
+
+            return {Recycled.Set, Recycled.Pool, SetLayout, CommandQueueMask, *this};
         }
     }
 
-    // Failed to allocate descriptor from existing pools -> create a new one
-    LOG_INFO_MESSAGE("Allocated new descriptor pool");
-    m_Pools.emplace_front(CreateDescriptorPool("Descriptor pool"));
+    // Descriptor pools are externally synchronized, meaning that the application must not allocate
+    // and/or free descriptor sets from the same pool in multiple threads simultaneously (13.2.3)
+    std::unique_lock<std::mutex> Lock{m_Mutex, std::try_to_lock};
+    if (!Lock.owns_lock())
+    {
+        m_ContentionCount.fetch_add(1, std::memory_order_relaxed);
+        Lock.lock();
+    }
 
-    auto& NewPool = m_Pools.front();
-    auto  Set     = AllocateDescriptorSet(LogicalDevice, NewPool, SetLayout, DebugName);
-    DEV_CHECK_ERR(Set != VK_NULL_HANDLE, "Failed to allocate descriptor set");
+    m_PoolAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    // Try all pools starting from the frontmost
+    auto AllocateFromPools = [&]() -> VkDescriptorSet {
+        for (auto it = m_Pools.begin(); it != m_Pools.end(); ++it)
+        {
+            m_PoolScanCount.fetch_add(1, std::memory_order_relaxed);
+
+            auto& Pool = *it;
+            auto  Set  = AllocateDescriptorSet(LogicalDevice, Pool, SetLayout, DebugName);
+            if (Set != VK_NULL_HANDLE)
+            {
+                // Move the pool to the front
+                if (it != m_Pools.begin())
+                {
+                    std::swap(*it, m_Pools.front());
+                }
+                return Set;
+            }
+        }
+        return VK_NULL_HANDLE;
+    };
+
+    auto Set = AllocateFromPools();
+    // If all pools are exhausted, the space may be held by recycled sets with other layouts.
+    // Return them to their pools before creating a new one.
+    if (Set == VK_NULL_HANDLE && m_AllowFreeing && FreeRecycledSets(VK_NULL_HANDLE) > 0)
+        Set = AllocateFromPools();
+
+    if (Set == VK_NULL_HANDLE)
+    {
+        // Failed to allocate descriptor from existing pools -> create a new one
+        LOG_INFO_MESSAGE("Allocated new descriptor pool");
+        m_Pools.emplace_front(CreateDescriptorPool("Descriptor pool"));
+        m_NewPoolCount.fetch_add(1, std::memory_order_relaxed);
+
+        Set = AllocateDescriptorSet(LogicalDevice, m_Pools.front(), SetLayout, DebugName);
+        DEV_CHECK_ERR(Set != VK_NULL_HANDLE, "Failed to allocate descriptor set");
+    }
 
 #ifdef DILIGENT_DEVELOPMENT
     ++m_AllocatedSetCounter;
 #endif
 
-    return {Set, NewPool, CommandQueueMask, *this};
+    return {Set, m_Pools.front(), SetLayout, CommandQueueMask, *this};
+}
+
+void DescriptorSetAllocator::RecycleDescriptorSet(VkDescriptorSet Set, VkDescriptorPool Pool, VkDescriptorSetLayout Layout)
+{
+    // Sets are released by the thread that purges release queues, so distribute them
+    // evenly between the stripes rather than putting all of them into one.
+    auto& Stripe = m_Stripes[m_NextRecycleStripe.fetch_add(1, std::memory_order_relaxed) % NumStripes];
+    {
+        std::unique_lock<std::mutex> StripeLock{Stripe.Mtx, std::try_to_lock};
+        if (!StripeLock.owns_lock())
+        {
+            m_ContentionCount.fetch_add(1, std::memory_order_relaxed);
+            StripeLock.lock();
+        }
+        Stripe.FreeLists[Layout].push_back({Set, Pool});
+    }
+    m_CachedSetCount.fetch_add(1, std::memory_order_relaxed);
+#ifdef DILIGENT_DEVELOPMENT
+    --m_AllocatedSetCounter;
+#endif
 }
 
-void DescriptorSetAllocator::FreeDescriptorSet(VkDescriptorSet Set, VkDescriptorPool Pool, Uint64 QueueMask)
+size_t DescriptorSetAllocator::FreeRecycledSets(VkDescriptorSetLayout Layout)
+{
+    const auto& LogicalDevice = m_DeviceVkImpl.GetLogicalDevice();
+
+    auto FreeSets = [&](std::vector<RecycledSet>& Sets) {
+        if (m_AllowFreeing)
+        {
+            for (const auto& Recycled : Sets)
+                LogicalDevice.FreeDescriptorSet(Recycled.Pool, Recycled.Set);
+        }
+        // Without VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT the sets are
+        // returned to the pool when the pool is destroyed.
+        const auto NumSets = Sets.size();
+        Sets.clear();
+        return NumSets;
+    };
+
+    size_t NumFreedSets = 0;
+    for (auto& Stripe : m_Stripes)
+    {
+        std::lock_guard<std::mutex> StripeLock{Stripe.Mtx};
+        if (Layout != VK_NULL_HANDLE)
+        {
+            auto it = Stripe.FreeLists.find(Layout);
+            if (it != Stripe.FreeLists.end())
+            {
+                NumFreedSets += FreeSets(it->second);
+                Stripe.FreeLists.erase(it);
+            }
+        }
+        else
+        {
+            for (auto& it : Stripe.FreeLists)
+                NumFreedSets += FreeSets(it.second);
+            Stripe.FreeLists.clear();
+        }
+    }
+    m_CachedSetCount.fetch_sub(NumFreedSets, std::memory_order_relaxed);
+
+    return NumFreedSets;
+}
+
+void DescriptorSetAllocator::FreeDescriptorSet(VkDescriptorSet Set, VkDescriptorPool Pool, VkDescriptorSetLayout Layout, Uint64 QueueMask)
 {
     class DescriptorSetDeleter
     {
@@ -245,10 +383,12 @@ void DescriptorSetAllocator::FreeDescriptorSet(VkDescriptorSet Set, VkDescriptor
         // clang-format off
         DescriptorSetDeleter(DescriptorSetAllocator& _Allocator,
                              VkDescriptorSet         _Set,
-                             VkDescriptorPool        _Pool) :
+                             VkDescriptorPool        _Pool,
+                             VkDescriptorSetLayout   _Layout) :
             Allocator {&_Allocator},
             Set       {_Set       },
-            Pool      {_Pool      }
+            Pool      {_Pool      },
+            Layout    {_Layout    }
         {}
 
         DescriptorSetDeleter             (const DescriptorSetDeleter&) = delete;
@@ -258,11 +398,13 @@ void DescriptorSetAllocator::FreeDescriptorSet(VkDescriptorSet Set, VkDescriptor
         DescriptorSetDeleter(DescriptorSetDeleter&& rhs)noexcept :
             Allocator {rhs.Allocator},
             Set       {rhs.Set      },
-            Pool      {rhs.Pool     }
+            Pool      {rhs.Pool     },
+            Layout    {rhs.Layout   }
         {
             rhs.Allocator = nullptr;
             rhs.Set       = VK_NULL_HANDLE;
             rhs.Pool      = VK_NULL_HANDLE;
+            rhs.Layout    = VK_NULL_HANDLE;
         }
         // clang-format on
 
@@ -270,11 +412,8 @@ void DescriptorSetAllocator::FreeDescriptorSet(VkDescriptorSet Set, VkDescriptor
         {
             if (Allocator != nullptr)
             {
-                std::lock_guard<std::mutex> Lock{Allocator->m_Mutex};
-                Allocator->m_DeviceVkImpl.GetLogicalDevice().FreeDescriptorSet(Pool, Set);
-#ifdef DILIGENT_DEVELOPMENT
-                --Allocator->m_AllocatedSetCounter;
-#endif
+                // The GPU is done with the set, so it can be reused directly
+                Allocator->RecycleDescriptorSet(Set, Pool, Layout);
             }
         }
 
@@ -282,8 +421,68 @@ void DescriptorSetAllocator::FreeDescriptorSet(VkDescriptorSet Set, VkDescriptor
         DescriptorSetAllocator* Allocator;
         VkDescriptorSet         Set;
         VkDescriptorPool        Pool;
+        VkDescriptorSetLayout   Layout;
+    };
+    m_DeviceVkImpl.SafeReleaseDeviceObject(DescriptorSetDeleter{*this, Set, Pool, Layout}, QueueMask);
+}
+
+void DescriptorSetAllocator::ReleaseSetLayout(VulkanUtilities::DescriptorSetLayoutWrapper&& Layout, Uint64 QueueMask)
+{
+    // Sets with the layout are released before the layout through the same release queues,
+    // so by the time the deleter is destroyed, all of them have already been recycled.
+    class SetLayoutDeleter
+    {
+    public:
+        // clang-format off
+        SetLayoutDeleter(DescriptorSetAllocator&                       _Allocator,
+                         VulkanUtilities::DescriptorSetLayoutWrapper&& _Layout) noexcept :
+            Allocator {&_Allocator       },
+            Layout    {std::move(_Layout)}
+        {}
+
+        SetLayoutDeleter             (const SetLayoutDeleter&) = delete;
+        SetLayoutDeleter& operator = (const SetLayoutDeleter&) = delete;
+        SetLayoutDeleter& operator = (      SetLayoutDeleter&&)= delete;
+
+        SetLayoutDeleter(SetLayoutDeleter&& rhs)noexcept :
+            Allocator {rhs.Allocator          },
+            Layout    {std::move(rhs.Layout)}
+        {
+            rhs.Allocator = nullptr;
+        }
+        // clang-format on
+
+        ~SetLayoutDeleter()
+        {
+            if (Allocator != nullptr)
+            {
+                // Layout handles may be reused by the driver, so recycled sets must not outlive their layout
+                std::lock_guard<std::mutex> Lock{Allocator->m_Mutex};
+                Allocator->FreeRecycledSets(Layout);
+            }
+            // The layout is destroyed by the wrapper
+        }
+
+    private:
+        DescriptorSetAllocator*                     Allocator;
+        VulkanUtilities::DescriptorSetLayoutWrapper Layout;
     };
-    m_DeviceVkImpl.SafeReleaseDeviceObject(DescriptorSetDeleter{*this, Set, Pool}, QueueMask);
+
+    if (Layout == VK_NULL_HANDLE)
+        return;
+
+    m_DeviceVkImpl.SafeReleaseDeviceObject(SetLayoutDeleter{*this, std::move(Layout)}, QueueMask);
+}
+
+void DescriptorSetAllocator::GetStats(DescriptorSetAllocatorStatsVk& Stats) const
+{
+    Stats.AllocationCount     = m_AllocationCount.load(std::memory_order_relaxed);
+    Stats.RecycledCount       = m_RecycledCount.load(std::memory_order_relaxed);
+    Stats.PoolAllocationCount = m_PoolAllocationCount.load(std::memory_order_relaxed);
+    Stats.PoolScanCount       = m_PoolScanCount.load(std::memory_order_relaxed);
+    Stats.NewPoolCount        = m_NewPoolCount.load(std::memory_order_relaxed);
+    Stats.ContentionCount     = m_ContentionCount.load(std::memory_order_relaxed);
+    Stats.CachedSetCount      = m_CachedSetCount.load(std::memory_order_relaxed);
 }
 
 
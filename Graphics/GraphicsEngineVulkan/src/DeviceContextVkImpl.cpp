@@ -107,6 +107,7 @@ DeviceContextVkImpl::DeviceContextVkImpl(IReferenceCounters*       pRefCounters,
         m_pQueryMgr = &pDeviceVkImpl->GetQueryMgr(GetCommandQueueId());
         EnsureVkCmdBuffer();
         m_State.NumCommands += m_pQueryMgr->ResetStaleQueries(m_pDevice->GetLogicalDevice(), m_CommandBuffer);
+        m_FrameStartSubmitCount = m_pDevice->GetCommandQueue(GetCommandQueueId()).GetSubmitCount();
     }
 
     BufferDesc DummyVBDesc;
@@ -167,6 +168,8 @@ DeviceContextVkImpl::~DeviceContextVkImpl()
     //     when the next command buffer is submitted.
     if (m_QueueFamilyCmdPools)
         m_pDevice->SafeReleaseDeviceObject(std::move(m_QueueFamilyCmdPools), ~Uint64{0});
+    if (m_QueueFamilySecondaryCmdPools)
+        m_pDevice->SafeReleaseDeviceObject(std::move(m_QueueFamilySecondaryCmdPools), ~Uint64{0});
 
     // NB: Upload heap, dynamic heap and dynamic descriptor manager return their resources to
     //     global managers and do not need to wait for GPU to idle.
@@ -201,6 +204,26 @@ void DeviceContextVkImpl::PrepareCommandPool(SoftwareQueueIndex CommandQueueId)
     m_Desc.TextureCopyGranularity[2] = QueueInfo.minImageTransferGranularity.depth;
 }
 
+VulkanUtilities::VulkanCommandBufferPool& DeviceContextVkImpl::GetSecondaryCommandPool(HardwareQueueIndex QueueFamilyIndex)
+{
+    const auto& QueueProps = m_pDevice->GetPhysicalDevice().GetQueueProperties();
+    DEV_CHECK_ERR(QueueFamilyIndex < QueueProps.size(), "QueueFamilyIndex is out of range");
+
+    if (!m_QueueFamilySecondaryCmdPools)
+        m_QueueFamilySecondaryCmdPools.reset(new std::unique_ptr<VulkanUtilities::VulkanCommandBufferPool>[QueueProps.size()]);
+
+    auto& Pool = m_QueueFamilySecondaryCmdPools[QueueFamilyIndex];
+    if (!Pool)
+    {
+        Pool = std::make_unique<VulkanUtilities::VulkanCommandBufferPool>(
+            m_pDevice->GetLogicalDevice().GetSharedPtr(),
+            QueueFamilyIndex,
+            VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+            VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    }
+    return *Pool;
+}
+
 void DeviceContextVkImpl::Begin(Uint32 ImmediateContextId)
 {
     DEV_CHECK_ERR(IsDeferred(), "Begin() should only be called for deferred contexts.");
@@ -212,10 +235,52 @@ void DeviceContextVkImpl::Begin(Uint32 ImmediateContextId)
     m_pQueryMgr = &m_pDevice->GetQueryMgr(CommandQueueId);
 }
 
-void DeviceContextVkImpl::DisposeVkCmdBuffer(SoftwareQueueIndex CmdQueue, VkCommandBuffer vkCmdBuff, Uint64 FenceValue)
+void DeviceContextVkImpl::BeginRenderPassBundle(const RenderPassBundleAttribsVk& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.pRenderPass != nullptr, "Render pass must not be null");
+    DEV_CHECK_ERR(Attribs.pFramebuffer != nullptr, "Framebuffer must not be null");
+    DEV_CHECK_ERR(Attribs.SubpassIndex < Attribs.pRenderPass->GetDesc().SubpassCount,
+                  "Subpass index (", Attribs.SubpassIndex, ") exceeds the number of subpasses (", Attribs.pRenderPass->GetDesc().SubpassCount,
+                  ") in render pass '", Attribs.pRenderPass->GetDesc().Name, "'");
+
+    Begin(Attribs.ImmediateContextId);
+    DEV_CHECK_ERR((m_Desc.QueueType & COMMAND_QUEUE_TYPE_GRAPHICS) == COMMAND_QUEUE_TYPE_GRAPHICS,
+                  "Render pass bundles are not supported in ", GetCommandQueueTypeString(m_Desc.QueueType), " queue.");
+
+    // Render targets are defined by the subpass. Attachment states are managed by the
+    // immediate context that begins the render pass.
+    m_pActiveRenderPass                   = ClassPtrCast<RenderPassVkImpl>(Attribs.pRenderPass);
+    m_pBoundFramebuffer                   = ClassPtrCast<FramebufferVkImpl>(Attribs.pFramebuffer);
+    m_SubpassIndex                        = Attribs.SubpassIndex;
+    m_RenderPassAttachmentsTransitionMode = RESOURCE_STATE_TRANSITION_MODE_NONE;
+    SetSubpassRenderTargets();
+
+    m_vkRenderPass  = m_pActiveRenderPass->GetVkRenderPass();
+    m_vkFramebuffer = m_pBoundFramebuffer->GetVkFramebuffer();
+
+    VkCommandBufferInheritanceInfo InheritanceInfo{};
+    InheritanceInfo.sType                = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    InheritanceInfo.renderPass           = m_vkRenderPass;
+    InheritanceInfo.subpass              = m_SubpassIndex;
+    InheritanceInfo.framebuffer          = m_vkFramebuffer;
+    InheritanceInfo.occlusionQueryEnable = VK_FALSE;
+
+    m_pBundleCmdPool = &GetSecondaryCommandPool(HardwareQueueIndex{m_Desc.QueueId});
+    auto vkCmdBuff   = m_pBundleCmdPool->GetCommandBuffer("", &InheritanceInfo);
+    m_CommandBuffer.SetVkCmdBuffer(vkCmdBuff, m_pBundleCmdPool->GetSupportedStagesMask(), m_pBundleCmdPool->GetSupportedAccessMask());
+    m_CommandBuffer.ContinueRenderPass(m_vkRenderPass, m_vkFramebuffer, m_FramebufferWidth, m_FramebufferHeight);
+    m_State.NumCommands = 1;
+
+    // Viewports and scissor rects are not inherited from the primary command buffer
+    SetViewports(1, nullptr, 0, 0);
+}
+
+void DeviceContextVkImpl::DisposeVkCmdBuffer(SoftwareQueueIndex                        CmdQueue,
+                                             VkCommandBuffer                           vkCmdBuff,
+                                             VulkanUtilities::VulkanCommandBufferPool& CmdPool,
+                                             Uint64                                    FenceValue)
 {
     VERIFY_EXPR(vkCmdBuff != VK_NULL_HANDLE);
-    VERIFY_EXPR(m_CmdPool != nullptr);
     class CmdBufferRecycler
     {
     public:
@@ -257,7 +322,7 @@ void DeviceContextVkImpl::DisposeVkCmdBuffer(SoftwareQueueIndex CmdQueue, VkComm
     // Discard command buffer directly to the release queue since we know exactly which queue it was submitted to
     // as well as the associated FenceValue.
     auto& ReleaseQueue = m_pDevice->GetReleaseQueue(CmdQueue);
-    ReleaseQueue.DiscardResource(CmdBufferRecycler{vkCmdBuff, *m_CmdPool}, FenceValue);
+    ReleaseQueue.DiscardResource(CmdBufferRecycler{vkCmdBuff, CmdPool}, FenceValue);
 }
 
 inline void DeviceContextVkImpl::DisposeCurrentCmdBuffer(SoftwareQueueIndex CmdQueue, Uint64 FenceValue)
@@ -266,7 +331,8 @@ inline void DeviceContextVkImpl::DisposeCurrentCmdBuffer(SoftwareQueueIndex CmdQ
     auto vkCmdBuff = m_CommandBuffer.GetVkCmdBuffer();
     if (vkCmdBuff != VK_NULL_HANDLE)
     {
-        DisposeVkCmdBuffer(CmdQueue, vkCmdBuff, FenceValue);
+        VERIFY_EXPR(m_CmdPool != nullptr);
+        DisposeVkCmdBuffer(CmdQueue, vkCmdBuff, *m_CmdPool, FenceValue);
         m_CommandBuffer.Reset();
     }
 }
@@ -389,6 +455,32 @@ void DeviceContextVkImpl::SetPipelineState(IPipelineState* pPipelineState)
     m_DynamicBufferOffsets.resize(TotalDynamicOffsetCount);
 }
 
+void DeviceContextVkImpl::CommitOverflowDescriptorSets(Uint32                       SignIdx,
+                                                       const ShaderResourceCacheVk& ResourceCache,
+                                                       Uint32                       OverflowSetMask,
+                                                       VkDescriptorSet*             pSets)
+{
+    const auto* pSignature = m_pPipelineState->GetResourceSignature(SignIdx);
+    VERIFY_EXPR(pSignature != nullptr);
+
+    while (OverflowSetMask != 0)
+    {
+        const auto SetIdx = PlatformMisc::GetLSB(OverflowSetMask);
+        OverflowSetMask &= ~(1u << SetIdx);
+
+        const auto SetId = (SetIdx == 0 && pSignature->HasDescriptorSet(PipelineResourceSignatureVkImpl::DESCRIPTOR_SET_ID_STATIC_MUTABLE)) ?
+            PipelineResourceSignatureVkImpl::DESCRIPTOR_SET_ID_STATIC_MUTABLE :
+            PipelineResourceSignatureVkImpl::DESCRIPTOR_SET_ID_DYNAMIC;
+
+        // The cached set references the primary dynamic heap buffer. Write a copy of the set
+        // that references the overflow buffers. The copy is only valid for the current frame.
+        const auto vkLayout   = pSignature->GetVkDescriptorSetLayout(SetId);
+        const auto vkSetToUse = AllocateDynamicDescriptorSet(vkLayout, "Overflow Dynamic Buffer Descriptor Set");
+        pSignature->CommitOverflowDescriptorSet(ResourceCache, SetId, vkSetToUse, m_DynamicHeap, GetContextId());
+        pSets[SetIdx] = vkSetToUse;
+    }
+}
+
 DeviceContextVkImpl::ResourceBindInfo& DeviceContextVkImpl::GetBindInfo(PIPELINE_TYPE Type)
 {
     VERIFY_EXPR(Type != PIPELINE_TYPE_INVALID);
@@ -444,6 +536,7 @@ void DeviceContextVkImpl::CommitDescriptorSets(ResourceBindInfo& BindInfo, Uint3
         const auto* pResourceCache = BindInfo.ResourceCaches[sign];
         DEV_CHECK_ERR(pResourceCache != nullptr, "Resource cache at binding index ", sign, " is null, but corresponding descriptor set is not");
 
+        auto* const pSetsToBind           = &m_DescriptorSets[TotalSetCount];
         m_DescriptorSets[TotalSetCount++] = SetInfo.vkSets[0];
         if (SetInfo.vkSets[1] != VK_NULL_HANDLE)
             m_DescriptorSets[TotalSetCount++] = SetInfo.vkSets[1];
@@ -453,9 +546,15 @@ void DeviceContextVkImpl::CommitDescriptorSets(ResourceBindInfo& BindInfo, Uint3
             VERIFY(m_DynamicBufferOffsets.size() >= size_t{DynamicOffsetCount} + size_t{SetInfo.DynamicOffsetCount},
                    "m_DynamicBufferOffsets must've been resized by SetPipelineState() to have enough space");
 
-            auto NumOffsetsWritten = pResourceCache->GetDynamicBufferOffsets(GetContextId(), m_DynamicBufferOffsets, DynamicOffsetCount);
+            Uint32 OverflowSetMask   = 0;
+            auto   NumOffsetsWritten = pResourceCache->GetDynamicBufferOffsets(GetContextId(), m_DynamicBufferOffsets, DynamicOffsetCount,
+                                                                               m_DynamicHeap.HasOverflowBuffers() ? &m_DynamicHeap : nullptr,
+                                                                               OverflowSetMask);
             VERIFY_EXPR(NumOffsetsWritten == SetInfo.DynamicOffsetCount);
             DynamicOffsetCount += SetInfo.DynamicOffsetCount;
+
+            if (OverflowSetMask != 0)
+                CommitOverflowDescriptorSets(sign, *pResourceCache, OverflowSetMask, pSetsToBind);
         }
 
 #ifdef DILIGENT_DEVELOPMENT
@@ -463,8 +562,9 @@ void DeviceContextVkImpl::CommitDescriptorSets(ResourceBindInfo& BindInfo, Uint3
 #endif
     }
 
-    // Note that there is one global dynamic buffer from which all dynamic resources are suballocated in Vulkan back-end,
-    // and this buffer is not resizable, so the buffer handle can never change.
+    // Note that all descriptor sets reference the primary dynamic buffer, whose handle never changes.
+    // When the dynamic heap grows, dynamic buffers allocated from overflow buffers are bound through
+    // the overflow descriptor sets written by CommitOverflowDescriptorSets().
 
     // vkCmdBindDescriptorSets causes the sets numbered [firstSet .. firstSet+descriptorSetCount-1] to use the
     // bindings stored in pDescriptorSets[0 .. descriptorSetCount-1] for subsequent rendering commands
@@ -647,7 +747,7 @@ void DeviceContextVkImpl::CommitVkVertexBuffers()
 
             // Device context keeps strong references to all vertex buffers.
 
-            vkVertexBuffers[slot] = pBufferVk->GetVkBuffer();
+            vkVertexBuffers[slot] = pBufferVk->GetVkBuffer(GetContextId());
             Offsets[slot]         = CurrStream.Offset + pBufferVk->GetDynamicOffset(GetContextId(), this);
         }
         else
@@ -725,6 +825,8 @@ void DeviceContextVkImpl::PrepareForDraw(DRAW_FLAGS Flags)
     VERIFY(m_vkRenderPass != VK_NULL_HANDLE, "No render pass is active while executing draw command");
     VERIFY(m_vkFramebuffer != VK_NULL_HANDLE, "No framebuffer is bound while executing draw command");
 #endif
+    DEV_CHECK_ERR(m_vkSubpassContents == VK_SUBPASS_CONTENTS_INLINE,
+                  "Draw commands can't be recorded in a subpass whose contents are provided by render pass bundles");
 
     EnsureVkCmdBuffer();
 
@@ -804,7 +906,7 @@ void DeviceContextVkImpl::PrepareForIndexedDraw(DRAW_FLAGS Flags, VALUE_TYPE Ind
 #endif
     DEV_CHECK_ERR(IndexType == VT_UINT16 || IndexType == VT_UINT32, "Unsupported index format. Only R16_UINT and R32_UINT are allowed.");
     VkIndexType vkIndexType = TypeToVkIndexType(IndexType);
-    m_CommandBuffer.BindIndexBuffer(m_pIndexBuffer->GetVkBuffer(), m_IndexDataStartOffset + m_pIndexBuffer->GetDynamicOffset(GetContextId(), this), vkIndexType);
+    m_CommandBuffer.BindIndexBuffer(m_pIndexBuffer->GetVkBuffer(GetContextId()), m_IndexDataStartOffset + m_pIndexBuffer->GetDynamicOffset(GetContextId(), this), vkIndexType);
 }
 
 void DeviceContextVkImpl::Draw(const DrawAttribs& Attribs)
@@ -850,15 +952,15 @@ void DeviceContextVkImpl::DrawIndirect(const DrawIndirectAttribs& Attribs)
     {
         if (Attribs.pCounterBuffer == nullptr)
         {
-            m_CommandBuffer.DrawIndirect(pIndirectDrawAttribsVk->GetVkBuffer(),
+            m_CommandBuffer.DrawIndirect(pIndirectDrawAttribsVk->GetVkBuffer(GetContextId()),
                                          pIndirectDrawAttribsVk->GetDynamicOffset(GetContextId(), this) + Attribs.DrawArgsOffset,
                                          Attribs.DrawCount, Attribs.DrawCount > 1 ? Attribs.DrawArgsStride : 0);
         }
         else
         {
-            m_CommandBuffer.DrawIndirectCount(pIndirectDrawAttribsVk->GetVkBuffer(),
+            m_CommandBuffer.DrawIndirectCount(pIndirectDrawAttribsVk->GetVkBuffer(GetContextId()),
                                               pIndirectDrawAttribsVk->GetDynamicOffset(GetContextId(), this) + Attribs.DrawArgsOffset,
-                                              pCountBufferVk->GetVkBuffer(),
+                                              pCountBufferVk->GetVkBuffer(GetContextId()),
                                               pCountBufferVk->GetDynamicOffset(GetContextId(), this) + Attribs.CounterOffset,
                                               Attribs.DrawCount,
                                               Attribs.DrawArgsStride);
@@ -885,15 +987,15 @@ void DeviceContextVkImpl::DrawIndexedIndirect(const DrawIndexedIndirectAttribs&
     {
         if (Attribs.pCounterBuffer == nullptr)
         {
-            m_CommandBuffer.DrawIndexedIndirect(pIndirectDrawAttribsVk->GetVkBuffer(),
+            m_CommandBuffer.DrawIndexedIndirect(pIndirectDrawAttribsVk->GetVkBuffer(GetContextId()),
                                                 pIndirectDrawAttribsVk->GetDynamicOffset(GetContextId(), this) + Attribs.DrawArgsOffset,
                                                 Attribs.DrawCount, Attribs.DrawCount > 1 ? Attribs.DrawArgsStride : 0);
         }
         else
         {
-            m_CommandBuffer.DrawIndexedIndirectCount(pIndirectDrawAttribsVk->GetVkBuffer(),
+            m_CommandBuffer.DrawIndexedIndirectCount(pIndirectDrawAttribsVk->GetVkBuffer(GetContextId()),
                                                      pIndirectDrawAttribsVk->GetDynamicOffset(GetContextId(), this) + Attribs.DrawArgsOffset,
-                                                     pCountBufferVk->GetVkBuffer(),
+                                                     pCountBufferVk->GetVkBuffer(GetContextId()),
                                                      pCountBufferVk->GetDynamicOffset(GetContextId(), this) + Attribs.CounterOffset,
                                                      Attribs.DrawCount,
                                                      Attribs.DrawArgsStride);
@@ -933,16 +1035,16 @@ void DeviceContextVkImpl::DrawMeshIndirect(const DrawMeshIndirectAttribs& Attrib
     {
         if (Attribs.pCounterBuffer == nullptr)
         {
-            m_CommandBuffer.DrawMeshIndirect(pIndirectDrawAttribsVk->GetVkBuffer(),
+            m_CommandBuffer.DrawMeshIndirect(pIndirectDrawAttribsVk->GetVkBuffer(GetContextId()),
                                              pIndirectDrawAttribsVk->GetDynamicOffset(GetContextId(), this) + Attribs.DrawArgsOffset,
                                              Attribs.CommandCount,
                                              DrawMeshIndirectCommandStride);
         }
         else
         {
-            m_CommandBuffer.DrawMeshIndirectCount(pIndirectDrawAttribsVk->GetVkBuffer(),
+            m_CommandBuffer.DrawMeshIndirectCount(pIndirectDrawAttribsVk->GetVkBuffer(GetContextId()),
                                                   pIndirectDrawAttribsVk->GetDynamicOffset(GetContextId(), this) + Attribs.DrawArgsOffset,
-                                                  pCountBufferVk->GetVkBuffer(),
+                                                  pCountBufferVk->GetVkBuffer(GetContextId()),
                                                   pCountBufferVk->GetDynamicOffset(GetContextId(), this) + Attribs.CounterOffset,
                                                   Attribs.CommandCount,
                                                   DrawMeshIndirectCommandStride);
@@ -1018,7 +1120,7 @@ void DeviceContextVkImpl::DispatchComputeIndirect(const DispatchComputeIndirectA
     TransitionOrVerifyBufferState(*pBufferVk, Attribs.AttribsBufferStateTransitionMode, RESOURCE_STATE_INDIRECT_ARGUMENT,
                                   VK_ACCESS_INDIRECT_COMMAND_READ_BIT, "Indirect dispatch (DeviceContextVkImpl::DispatchCompute)");
 
-    m_CommandBuffer.DispatchIndirect(pBufferVk->GetVkBuffer(), pBufferVk->GetDynamicOffset(GetContextId(), this) + Attribs.DispatchArgsByteOffset);
+    m_CommandBuffer.DispatchIndirect(pBufferVk->GetVkBuffer(GetContextId()), pBufferVk->GetDynamicOffset(GetContextId(), this) + Attribs.DispatchArgsByteOffset);
     ++m_State.NumCommands;
 }
 
@@ -1029,6 +1131,10 @@ void DeviceContextVkImpl::GetTileSize(Uint32& TileSizeX, Uint32& TileSizeY)
 
     if (m_vkRenderPass != VK_NULL_HANDLE)
     {
+        // The implicit render pass may have been evicted from the cache while the render targets stayed bound
+        if (m_pActiveRenderPass == nullptr)
+            ChooseRenderPassAndFramebuffer();
+
         const auto& LogicalDevice = m_pDevice->GetLogicalDevice();
         VkExtent2D  Granularity   = {};
         vkGetRenderAreaGranularity(LogicalDevice.GetVkDevice(), m_vkRenderPass, &Granularity);
@@ -1046,6 +1152,8 @@ void DeviceContextVkImpl::ClearDepthStencil(ITextureView*                  pView
                                             RESOURCE_STATE_TRANSITION_MODE StateTransitionMode)
 {
     TDeviceContextBase::ClearDepthStencil(pView);
+    DEV_CHECK_ERR(m_vkSubpassContents == VK_SUBPASS_CONTENTS_INLINE,
+                  "Attachments can't be cleared in a subpass whose contents are provided by render pass bundles");
 
     auto* pVkDSV = ClassPtrCast<ITextureViewVk>(pView);
 
@@ -1147,6 +1255,8 @@ VkClearColorValue ClearValueToVkClearValue(const float* RGBA, TEXTURE_FORMAT Tex
 void DeviceContextVkImpl::ClearRenderTarget(ITextureView* pView, const float* RGBA, RESOURCE_STATE_TRANSITION_MODE StateTransitionMode)
 {
     TDeviceContextBase::ClearRenderTarget(pView);
+    DEV_CHECK_ERR(m_vkSubpassContents == VK_SUBPASS_CONTENTS_INLINE,
+                  "Attachments can't be cleared in a subpass whose contents are provided by render pass bundles");
 
     auto* pVkRTV = ClassPtrCast<ITextureViewVk>(pView);
 
@@ -1283,6 +1393,18 @@ void DeviceContextVkImpl::FinishFrame()
     if (!m_MappedTextures.empty())
         LOG_ERROR_MESSAGE("There are mapped textures in the device context when finishing the frame. All dynamic resources must be used in the same frame in which they are mapped.");
 
+    if (!IsDeferred())
+    {
+        SubmitBatchedCommands();
+
+        const auto SubmitCount = m_pDevice->GetCommandQueue(GetCommandQueueId()).GetSubmitCount();
+
+        m_SubmitStats.NumSubmits = static_cast<Uint32>(SubmitCount - m_FrameStartSubmitCount);
+        m_LastFrameSubmitStats   = m_SubmitStats;
+        m_SubmitStats            = {};
+        m_FrameStartSubmitCount  = SubmitCount;
+    }
+
     const Uint64 QueueMask = GetSubmittedBuffersCmdQueueMask();
     VERIFY_EXPR(IsDeferred() || QueueMask == (Uint64{1} << GetCommandQueueId()));
 
@@ -1296,13 +1418,18 @@ void DeviceContextVkImpl::FinishFrame()
     // Dynamic heap returns all allocated master blocks to the global dynamic memory manager.
     // Note: as global dynamic memory manager is hosted by the render device, the dynamic heap can
     // be destroyed before the blocks are actually returned to the global dynamic memory manager.
-    m_DynamicHeap.ReleaseMasterBlocks(*m_pDevice, QueueMask);
+    m_DynamicHeap.ReleaseMasterBlocks(*m_pDevice, QueueMask, GetFrameNumber());
 
     // Dynamic descriptor set allocator returns all allocated pools to the global dynamic descriptor pool manager.
     // Note: as global pool manager is hosted by the render device, the allocator can
     // be destroyed before the pools are actually returned to the global pool manager.
     m_DynamicDescrSetAllocator.ReleasePools(QueueMask);
 
+    // Framebuffers and implicit render passes that have not been used for several
+    // frames may be evicted from the caches once they exceed their size limits.
+    m_pDevice->GetFramebufferCache().OnFrameFinished(GetFrameNumber());
+    m_pDevice->GetImplicitRenderPassCache().OnFrameFinished(GetFrameNumber());
+
     EndFrame();
 }
 
@@ -1324,10 +1451,12 @@ void DeviceContextVkImpl::Flush(Uint32               NumCommandLists,
                   "Flushing device context inside an active render pass.");
 
     // TODO: replace with small_vector
-    std::vector<VkCommandBuffer>               vkCmdBuffs;
-    std::vector<RefCntAutoPtr<IDeviceContext>> DeferredCtxs;
+    std::vector<VkCommandBuffer>                           vkCmdBuffs;
+    std::vector<RefCntAutoPtr<IDeviceContext>>             DeferredCtxs;
+    std::vector<VulkanUtilities::VulkanCommandBufferPool*> CmdPools;
     vkCmdBuffs.reserve(size_t{NumCommandLists} + 1);
     DeferredCtxs.reserve(size_t{NumCommandLists} + 1);
+    CmdPools.reserve(NumCommandLists);
 
     auto vkCmdBuff = m_CommandBuffer.GetVkCmdBuffer();
     if (vkCmdBuff != VK_NULL_HANDLE)
@@ -1365,9 +1494,11 @@ void DeviceContextVkImpl::Flush(Uint32               NumCommandLists,
         auto* pCmdListVk = ClassPtrCast<CommandListVkImpl>(ppCommandLists[i]);
         DEV_CHECK_ERR(pCmdListVk != nullptr, "Command list must not be null");
         DEV_CHECK_ERR(pCmdListVk->GetQueueId() == GetDesc().QueueId, "Command list recorded for QueueId ", pCmdListVk->GetQueueId(), ", but executed on QueueId ", GetDesc().QueueId, ".");
+        DEV_CHECK_ERR(!pCmdListVk->IsRenderPassBundle(), "Render pass bundles must be executed by IDeviceContextVk::ExecuteRenderPassBundles()");
         DeferredCtxs.emplace_back();
         vkCmdBuffs.emplace_back();
-        pCmdListVk->Close(DeferredCtxs.back(), vkCmdBuffs.back());
+        CmdPools.emplace_back();
+        pCmdListVk->Close(DeferredCtxs.back(), vkCmdBuffs.back(), CmdPools.back());
         VERIFY(vkCmdBuffs.back() != VK_NULL_HANDLE, "Trying to execute empty command buffer");
         VERIFY_EXPR(DeferredCtxs.back() != nullptr);
     }
@@ -1452,8 +1583,15 @@ void DeviceContextVkImpl::Flush(Uint32               NumCommandLists,
         TimelineSemaphoreSubmitInfo.pSignalSemaphoreValues    = SubmitInfo.signalSemaphoreCount ? m_SignalSemaphoreValues.data() : nullptr;
     }
 
+    // Fences must be signaled when the context is flushed, so the submission is only deferred when there are none.
+    const bool DeferSubmission = m_SubmitBatchingEnabled && m_SignalFences.empty();
+
     // Submit command buffer even if there are no commands to release stale resources.
-    auto SubmittedFenceValue = m_pDevice->ExecuteCommandBuffer(GetCommandQueueId(), SubmitInfo, &m_SignalFences);
+    auto SubmittedFenceValue = m_pDevice->ExecuteCommandBuffer(GetCommandQueueId(), SubmitInfo, &m_SignalFences, DeferSubmission);
+
+    ++m_SubmitStats.NumFlushes;
+    if (DeferSubmission)
+        ++m_SubmitStats.NumBatchedFlushes;
 
     // Recycle semaphores
     {
@@ -1491,10 +1629,19 @@ void DeviceContextVkImpl::Flush(Uint32               NumCommandLists,
         pDeferredCtxVkImpl->UpdateSubmittedBuffersCmdQueueMask(GetCommandQueueId());
         // It is OK to dispose command buffer from another thread. We are not going to
         // record any commands and only need to add the buffer to the queue
-        pDeferredCtxVkImpl->DisposeVkCmdBuffer(GetCommandQueueId(), std::move(vkCmdBuffs[buff_idx]), SubmittedFenceValue);
+        pDeferredCtxVkImpl->DisposeVkCmdBuffer(GetCommandQueueId(), std::move(vkCmdBuffs[buff_idx]), *CmdPools[i], SubmittedFenceValue);
     }
     VERIFY_EXPR(buff_idx == vkCmdBuffs.size());
 
+    // Secondary command buffers executed by the submitted primary command buffer
+    for (auto& Bundle : m_PendingRenderPassBundles)
+    {
+        auto pDeferredCtxVkImpl = Bundle.pDeferredCtx.RawPtr<DeviceContextVkImpl>();
+        pDeferredCtxVkImpl->UpdateSubmittedBuffersCmdQueueMask(GetCommandQueueId());
+        pDeferredCtxVkImpl->DisposeVkCmdBuffer(GetCommandQueueId(), Bundle.vkCmdBuff, *Bundle.pCmdPool, SubmittedFenceValue);
+    }
+    m_PendingRenderPassBundles.clear();
+
     m_State    = {};
     m_BindInfo = {};
     m_CommandBuffer.Reset();
@@ -1687,6 +1834,12 @@ void DeviceContextVkImpl::CommitRenderPassAndFramebuffer(bool VerifyStates)
 
         if (m_vkFramebuffer != VK_NULL_HANDLE)
         {
+            // Implicit render passes and framebuffers are evicted from the caches when they have not
+            // been used for several frames, while the render targets may stay bound for longer.
+            // Look them up again every time the render pass is begun to mark them as used and
+            // to recreate them if they have been evicted.
+            ChooseRenderPassAndFramebuffer();
+
             VERIFY_EXPR(m_vkRenderPass != VK_NULL_HANDLE);
 #ifdef DILIGENT_DEVELOPMENT
             if (VerifyStates)
@@ -1797,6 +1950,17 @@ void DeviceContextVkImpl::ResetRenderTargets()
 }
 
 void DeviceContextVkImpl::BeginRenderPass(const BeginRenderPassAttribs& Attribs)
+{
+    BeginRenderPass(Attribs, VK_SUBPASS_CONTENTS_INLINE);
+}
+
+void DeviceContextVkImpl::BeginRenderPassWithBundles(const BeginRenderPassAttribs& Attribs)
+{
+    DEV_CHECK_ERR(!IsDeferred(), "Render pass bundles can only be executed by immediate contexts");
+    BeginRenderPass(Attribs, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+}
+
+void DeviceContextVkImpl::BeginRenderPass(const BeginRenderPassAttribs& Attribs, VkSubpassContents Contents)
 {
     TDeviceContextBase::BeginRenderPass(Attribs);
 
@@ -1837,23 +2001,41 @@ void DeviceContextVkImpl::BeginRenderPass(const BeginRenderPassAttribs& Attribs)
     }
 
     EnsureVkCmdBuffer();
-    m_CommandBuffer.BeginRenderPass(m_vkRenderPass, m_vkFramebuffer, m_FramebufferWidth, m_FramebufferHeight, Attribs.ClearValueCount, pVkClearValues);
+    m_CommandBuffer.BeginRenderPass(m_vkRenderPass, m_vkFramebuffer, m_FramebufferWidth, m_FramebufferHeight, Attribs.ClearValueCount, pVkClearValues, Contents);
+    m_vkSubpassContents = Contents;
 
-    // Set the viewport to match the framebuffer size
-    SetViewports(1, nullptr, 0, 0);
+    // Set the viewport to match the framebuffer size.
+    // Dynamic states are not inherited by secondary command buffers, so there is no need to set them
+    // in a subpass that is recorded by render pass bundles.
+    if (m_vkSubpassContents == VK_SUBPASS_CONTENTS_INLINE)
+        SetViewports(1, nullptr, 0, 0);
 
     m_State.ShadingRateIsSet = false;
 }
 
 void DeviceContextVkImpl::NextSubpass()
+{
+    NextSubpass(VK_SUBPASS_CONTENTS_INLINE);
+}
+
+void DeviceContextVkImpl::NextSubpassWithBundles()
+{
+    DEV_CHECK_ERR(!IsDeferred(), "Render pass bundles can only be executed by immediate contexts");
+    NextSubpass(VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+}
+
+void DeviceContextVkImpl::NextSubpass(VkSubpassContents Contents)
 {
     TDeviceContextBase::NextSubpass();
     VERIFY_EXPR(m_CommandBuffer.GetVkCmdBuffer() != VK_NULL_HANDLE && m_CommandBuffer.GetState().RenderPass != VK_NULL_HANDLE);
-    m_CommandBuffer.NextSubpass();
+    m_CommandBuffer.NextSubpass(Contents);
+    m_vkSubpassContents = Contents;
 }
 
 void DeviceContextVkImpl::EndRenderPass()
 {
+    DEV_CHECK_ERR(m_pBundleCmdPool == nullptr, "Render pass can't be ended while recording a render pass bundle. Call FinishCommandList() instead.");
+    m_vkSubpassContents = VK_SUBPASS_CONTENTS_INLINE;
     TDeviceContextBase::EndRenderPass();
     // TDeviceContextBase::EndRenderPass calls ResetRenderTargets() that in turn
     // calls m_CommandBuffer.EndRenderPass()
@@ -1929,7 +2111,7 @@ void DeviceContextVkImpl::CopyBuffer(IBuffer*                       pSrcBuffer,
     CopyRegion.size      = Size;
     VERIFY(pDstBuffVk->m_VulkanBuffer != VK_NULL_HANDLE, "Copy destination buffer must not be suballocated");
     VERIFY_EXPR(pDstBuffVk->GetDynamicOffset(GetContextId(), this) == 0);
-    m_CommandBuffer.CopyBuffer(pSrcBuffVk->GetVkBuffer(), pDstBuffVk->GetVkBuffer(), 1, &CopyRegion);
+    m_CommandBuffer.CopyBuffer(pSrcBuffVk->GetVkBuffer(GetContextId()), pDstBuffVk->GetVkBuffer(), 1, &CopyRegion);
     ++m_State.NumCommands;
 }
 
@@ -1965,7 +2147,13 @@ void DeviceContextVkImpl::MapBuffer(IBuffer* pBuffer, MAP_TYPE MapType, MAP_FLAG
                           BuffDesc.Name, "': Vulkan buffer must be mapped for writing with MAP_FLAG_DISCARD or MAP_FLAG_NO_OVERWRITE flag. Context Id: ", GetContextId());
 
             auto& DynAllocation = pBufferVk->m_DynamicData[GetContextId()];
-            if ((MapFlags & MAP_FLAG_DISCARD) != 0 || DynAllocation.pDynamicMemMgr == nullptr)
+            // An allocation from an overflow buffer can only be reused within the frame it was made in,
+            // as the buffer may be released once it is no longer used.
+            const bool IsStaleOverflowAllocation =
+                DynAllocation.pDynamicMemMgr != nullptr &&
+                DynAllocation.vkBuffer != DynAllocation.pDynamicMemMgr->GetVkBuffer() &&
+                !m_DynamicHeap.IsOverflowChunk(DynAllocation.pChunk);
+            if ((MapFlags & MAP_FLAG_DISCARD) != 0 || DynAllocation.pDynamicMemMgr == nullptr || IsStaleOverflowAllocation)
             {
                 DynAllocation = AllocateDynamicSpace(BuffDesc.Size, pBufferVk->m_DynamicOffsetAlignment);
             }
@@ -1987,8 +2175,7 @@ void DeviceContextVkImpl::MapBuffer(IBuffer* pBuffer, MAP_TYPE MapType, MAP_FLAG
 
             if (DynAllocation.pDynamicMemMgr != nullptr)
             {
-                auto* CPUAddress = DynAllocation.pDynamicMemMgr->GetCPUAddress();
-                pMappedData      = CPUAddress + DynAllocation.AlignedOffset;
+                pMappedData = DynAllocation.CPUAddress + DynAllocation.AlignedOffset;
             }
             else
             {
@@ -2040,7 +2227,7 @@ void DeviceContextVkImpl::UnmapBuffer(IBuffer* pBuffer, MAP_TYPE MapType)
             if (pBufferVk->m_VulkanBuffer != VK_NULL_HANDLE)
             {
                 auto& DynAlloc  = pBufferVk->m_DynamicData[GetContextId()];
-                auto  vkSrcBuff = DynAlloc.pDynamicMemMgr->GetVkBuffer();
+                auto  vkSrcBuff = DynAlloc.vkBuffer;
                 UpdateBufferRegion(pBufferVk, 0, BuffDesc.Size, vkSrcBuff, DynAlloc.AlignedOffset, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
             }
         }
@@ -2064,7 +2251,42 @@ void DeviceContextVkImpl::UpdateTexture(ITexture*                      pTexture,
 
     if (SubresData.pSrcBuffer != nullptr)
     {
-        UNSUPPORTED("Copying buffer to texture is not implemented");
+        auto* const pSrcBuffVk = ClassPtrCast<BufferVkImpl>(SubresData.pSrcBuffer);
+        DEV_CHECK_ERR(pSrcBuffVk->GetDesc().Usage != USAGE_DYNAMIC, "Dynamic buffers can't be used as the source of texture update");
+        TransitionOrVerifyBufferState(*pSrcBuffVk, SrcBufferStateTransitionMode, RESOURCE_STATE_COPY_SOURCE, VK_ACCESS_TRANSFER_READ_BIT,
+                                      "Using buffer as copy source (DeviceContextVkImpl::UpdateTexture)");
+
+        const auto& FmtAttribs   = GetTextureFormatAttribs(pTexVk->GetDesc().Format);
+        const auto  IsCompressed = FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED;
+        // Size of the texel block in bytes. For compressed formats, ComponentSize is the size of the whole block.
+        const Uint32 TexelBlockSize = IsCompressed ?
+            Uint32{FmtAttribs.ComponentSize} :
+            Uint32{FmtAttribs.ComponentSize} * Uint32{FmtAttribs.NumComponents};
+        const Uint32 BlockHeight = IsCompressed ? Uint32{FmtAttribs.BlockHeight} : 1u;
+
+        // bufferOffset must be a multiple of 4 and a multiple of the texel block size (18.4)
+        DEV_CHECK_ERR((SubresData.SrcOffset % 4) == 0 && (SubresData.SrcOffset % TexelBlockSize) == 0,
+                      "Source buffer offset (", SubresData.SrcOffset, ") must be a multiple of 4 and of the texel block size (", TexelBlockSize, ")");
+        DEV_CHECK_ERR((SubresData.Stride % TexelBlockSize) == 0,
+                      "Source buffer stride (", SubresData.Stride, ") must be a multiple of the texel block size (", TexelBlockSize, ")");
+
+        // bufferRowLength is specified in texels (18.4)
+        const auto RowStrideInTexels = IsCompressed ?
+            StaticCast<Uint32>(SubresData.Stride / TexelBlockSize * Uint64{FmtAttribs.BlockWidth}) :
+            StaticCast<Uint32>(SubresData.Stride / TexelBlockSize);
+
+        // bufferImageHeight is specified in texels too. The depth stride is only used for 3D regions,
+        // zero means that the slices are tightly packed.
+        Uint32 ImageHeightInTexels = 0;
+        if (DstBox.Depth() > 1 && SubresData.DepthStride != 0)
+        {
+            DEV_CHECK_ERR(SubresData.Stride != 0 && (SubresData.DepthStride % SubresData.Stride) == 0,
+                          "Source buffer depth stride (", SubresData.DepthStride, ") must be a multiple of the row stride (", SubresData.Stride, ")");
+            ImageHeightInTexels = StaticCast<Uint32>(SubresData.DepthStride / SubresData.Stride * BlockHeight);
+        }
+
+        CopyBufferToTexture(pSrcBuffVk->GetVkBuffer(), SubresData.SrcOffset, RowStrideInTexels, ImageHeightInTexels, *pTexVk,
+                            DstBox, MipLevel, Slice, TextureStateTransitionMode);
     }
     else
     {
@@ -2169,6 +2391,7 @@ void DeviceContextVkImpl::CopyTexture(const CopyTextureAttribs& CopyAttribs)
             pSrcTexVk->GetVkStagingBuffer(),
             SrcBufferOffset,
             SrcMipLevelAttribs.StorageWidth, // GetStagingTextureLocationOffset assumes texels are tightly packed
+            0,
             *pDstTexVk,
             DstBox,
             CopyAttribs.DstMipLevel,
@@ -2281,6 +2504,7 @@ void DeviceContextVkImpl::UpdateTextureRegion(const void*                    pSr
     CopyBufferToTexture(Allocation.vkBuffer,
                         Allocation.AlignedOffset,
                         CopyInfo.RowStrideInTexels,
+                        0,
                         TextureVk,
                         CopyInfo.Region,
                         MipLevel,
@@ -2296,6 +2520,7 @@ void DeviceContextVkImpl::GenerateMips(ITextureView* pTexView)
 
 static VkBufferImageCopy GetBufferImageCopyInfo(Uint64             BufferOffset,
                                                 Uint32             BufferRowStrideInTexels,
+                                                Uint32             BufferImageHeightInTexels,
                                                 const TextureDesc& TexDesc,
                                                 const Box&         Region,
                                                 Uint32             MipLevel,
@@ -2309,7 +2534,7 @@ static VkBufferImageCopy GetBufferImageCopyInfo(Uint64             BufferOffset,
     // three-dimensional image, and control the addressing calculations of data in buffer memory. If either of these
     // values is zero, that aspect of the buffer memory is considered to be tightly packed according to the imageExtent (18.4).
     CopyRegion.bufferRowLength   = BufferRowStrideInTexels;
-    CopyRegion.bufferImageHeight = 0;
+    CopyRegion.bufferImageHeight = BufferImageHeightInTexels;
 
     const auto& FmtAttribs = GetTextureFormatAttribs(TexDesc.Format);
     // The aspectMask member of imageSubresource must only have a single bit set (18.4)
@@ -2357,6 +2582,7 @@ static VkBufferImageCopy GetBufferImageCopyInfo(Uint64             BufferOffset,
 void DeviceContextVkImpl::CopyBufferToTexture(VkBuffer                       vkSrcBuffer,
                                               Uint64                         SrcBufferOffset,
                                               Uint32                         SrcBufferRowStrideInTexels,
+                                              Uint32                         SrcBufferImageHeightInTexels,
                                               TextureVkImpl&                 DstTextureVk,
                                               const Box&                     DstRegion,
                                               Uint32                         DstMipLevel,
@@ -2368,7 +2594,7 @@ void DeviceContextVkImpl::CopyBufferToTexture(VkBuffer                       vkS
                                    "Using texture as copy destination (DeviceContextVkImpl::CopyBufferToTexture)");
 
     const auto&       TexDesc     = DstTextureVk.GetDesc();
-    VkBufferImageCopy BuffImgCopy = GetBufferImageCopyInfo(SrcBufferOffset, SrcBufferRowStrideInTexels, TexDesc, DstRegion, DstMipLevel, DstArraySlice);
+    VkBufferImageCopy BuffImgCopy = GetBufferImageCopyInfo(SrcBufferOffset, SrcBufferRowStrideInTexels, SrcBufferImageHeightInTexels, TexDesc, DstRegion, DstMipLevel, DstArraySlice);
 
     m_CommandBuffer.CopyBufferToImage(
         vkSrcBuffer,
@@ -2392,7 +2618,7 @@ void DeviceContextVkImpl::CopyTextureToBuffer(TextureVkImpl&                 Src
                                    "Using texture as source destination (DeviceContextVkImpl::CopyTextureToBuffer)");
 
     const auto&       TexDesc     = SrcTextureVk.GetDesc();
-    VkBufferImageCopy BuffImgCopy = GetBufferImageCopyInfo(DstBufferOffset, DstBufferRowStrideInTexels, TexDesc, SrcRegion, SrcMipLevel, SrcArraySlice);
+    VkBufferImageCopy BuffImgCopy = GetBufferImageCopyInfo(DstBufferOffset, DstBufferRowStrideInTexels, 0, TexDesc, SrcRegion, SrcMipLevel, SrcArraySlice);
 
     m_CommandBuffer.CopyImageToBuffer(
         SrcTextureVk.GetVkImage(),
@@ -2451,7 +2677,7 @@ void DeviceContextVkImpl::MapTextureSubresource(ITexture*                 pTextu
         }
         auto Allocation = AllocateDynamicSpace(CopyInfo.MemorySize, static_cast<Uint32>(Alignment));
 
-        MappedData.pData       = reinterpret_cast<Uint8*>(Allocation.pDynamicMemMgr->GetCPUAddress()) + Allocation.AlignedOffset;
+        MappedData.pData       = Allocation.CPUAddress + Allocation.AlignedOffset;
         MappedData.Stride      = CopyInfo.RowStride;
         MappedData.DepthStride = CopyInfo.DepthStride;
 
@@ -2523,9 +2749,10 @@ void DeviceContextVkImpl::UnmapTextureSubresource(ITexture* pTexture,
         if (UploadSpaceIt != m_MappedTextures.end())
         {
             auto& MappedTex = UploadSpaceIt->second;
-            CopyBufferToTexture(MappedTex.Allocation.pDynamicMemMgr->GetVkBuffer(),
+            CopyBufferToTexture(MappedTex.Allocation.vkBuffer,
                                 MappedTex.Allocation.AlignedOffset,
                                 MappedTex.CopyInfo.RowStrideInTexels,
+                                0,
                                 TextureVk,
                                 MappedTex.CopyInfo.Region,
                                 MipLevel,
@@ -2559,11 +2786,27 @@ void DeviceContextVkImpl::UnmapTextureSubresource(ITexture* pTexture,
 void DeviceContextVkImpl::FinishCommandList(ICommandList** ppCommandList)
 {
     DEV_CHECK_ERR(IsDeferred(), "Only deferred context can record command list");
-    DEV_CHECK_ERR(m_pActiveRenderPass == nullptr, "Finishing command list inside an active render pass.");
 
-    if (m_CommandBuffer.GetState().RenderPass != VK_NULL_HANDLE)
+    CommandListVkImpl::RenderPassBundleInfo BundleInfo;
+    auto*                                   pCmdPool = m_CmdPool;
+    if (m_pBundleCmdPool != nullptr)
     {
-        m_CommandBuffer.EndRenderPass();
+        // The render pass is owned by the primary command buffer that will execute the bundle
+        VERIFY_EXPR(m_CommandBuffer.GetState().InheritedRenderPass);
+        VERIFY_EXPR(m_pActiveRenderPass != nullptr);
+        BundleInfo.vkRenderPass  = m_vkRenderPass;
+        BundleInfo.vkFramebuffer = m_vkFramebuffer;
+        BundleInfo.SubpassIndex  = m_SubpassIndex;
+        pCmdPool                 = m_pBundleCmdPool;
+    }
+    else
+    {
+        DEV_CHECK_ERR(m_pActiveRenderPass == nullptr, "Finishing command list inside an active render pass.");
+
+        if (m_CommandBuffer.GetState().RenderPass != VK_NULL_HANDLE)
+        {
+            m_CommandBuffer.EndRenderPass();
+        }
     }
 
     auto vkCmdBuff = m_CommandBuffer.GetVkCmdBuffer();
@@ -2571,10 +2814,17 @@ void DeviceContextVkImpl::FinishCommandList(ICommandList** ppCommandList)
     DEV_CHECK_ERR(err == VK_SUCCESS, "Failed to end command buffer");
     (void)err;
 
-    CommandListVkImpl* pCmdListVk{NEW_RC_OBJ(m_CmdListAllocator, "CommandListVkImpl instance", CommandListVkImpl)(m_pDevice, this, vkCmdBuff)};
+    CommandListVkImpl* pCmdListVk{NEW_RC_OBJ(m_CmdListAllocator, "CommandListVkImpl instance", CommandListVkImpl)(m_pDevice, this, vkCmdBuff, pCmdPool, BundleInfo)};
     pCmdListVk->QueryInterface(IID_CommandList, reinterpret_cast<IObject**>(ppCommandList));
 
     m_CommandBuffer.Reset();
+    if (m_pBundleCmdPool != nullptr)
+    {
+        m_pActiveRenderPass.Release();
+        m_pBoundFramebuffer.Release();
+        m_SubpassIndex   = 0;
+        m_pBundleCmdPool = nullptr;
+    }
     m_State          = ContextState{};
     m_pPipelineState = nullptr;
     m_pQueryMgr      = nullptr;
@@ -2598,6 +2848,79 @@ void DeviceContextVkImpl::ExecuteCommandLists(Uint32               NumCommandLis
     InvalidateState();
 }
 
+void DeviceContextVkImpl::ExecuteRenderPassBundles(Uint32               NumBundles,
+                                                   ICommandList* const* ppBundles)
+{
+    DEV_CHECK_ERR(!IsDeferred(), "Only immediate context can execute render pass bundles");
+    DEV_CHECK_ERR(m_pActiveRenderPass != nullptr, "Render pass bundles must be executed inside an active render pass");
+    DEV_CHECK_ERR(m_vkSubpassContents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS,
+                  "Render pass bundles can only be executed in a subpass begun by BeginRenderPassWithBundles() or NextSubpassWithBundles()");
+
+    if (NumBundles == 0)
+        return;
+    DEV_CHECK_ERR(ppBundles != nullptr, "ppBundles must not be null when NumBundles is not zero");
+
+    std::vector<VkCommandBuffer> vkCmdBuffs;
+    vkCmdBuffs.reserve(NumBundles);
+    for (Uint32 i = 0; i < NumBundles; ++i)
+    {
+        auto* pCmdListVk = ClassPtrCast<CommandListVkImpl>(ppBundles[i]);
+        DEV_CHECK_ERR(pCmdListVk != nullptr, "Render pass bundle must not be null");
+        DEV_CHECK_ERR(pCmdListVk->IsRenderPassBundle(), "Command list #", i, " was not recorded by BeginRenderPassBundle()");
+        DEV_CHECK_ERR(pCmdListVk->GetQueueId() == GetDesc().QueueId, "Render pass bundle recorded for QueueId ", pCmdListVk->GetQueueId(), ", but executed on QueueId ", GetDesc().QueueId, ".");
+#ifdef DILIGENT_DEVELOPMENT
+        {
+            const auto& BundleInfo = pCmdListVk->GetRenderPassBundleInfo();
+            DEV_CHECK_ERR(BundleInfo.vkRenderPass == m_vkRenderPass, "Render pass bundle #", i, " was recorded for a different render pass");
+            DEV_CHECK_ERR(BundleInfo.vkFramebuffer == m_vkFramebuffer, "Render pass bundle #", i, " was recorded for a different framebuffer");
+            DEV_CHECK_ERR(BundleInfo.SubpassIndex == m_SubpassIndex, "Render pass bundle #", i, " was recorded for subpass ",
+                          BundleInfo.SubpassIndex, ", but is executed in subpass ", m_SubpassIndex);
+        }
+#endif
+
+        PendingRenderPassBundle Bundle;
+        pCmdListVk->Close(Bundle.pDeferredCtx, Bundle.vkCmdBuff, Bundle.pCmdPool);
+        VERIFY(Bundle.vkCmdBuff != VK_NULL_HANDLE, "Trying to execute empty render pass bundle");
+        vkCmdBuffs.push_back(Bundle.vkCmdBuff);
+        m_PendingRenderPassBundles.emplace_back(std::move(Bundle));
+    }
+
+    EnsureVkCmdBuffer();
+    m_CommandBuffer.ExecuteCommands(static_cast<uint32_t>(vkCmdBuffs.size()), vkCmdBuffs.data());
+    ++m_State.NumCommands;
+
+    // Pipeline, vertex and index buffers and descriptor sets bound in the
+    // primary command buffer are undefined after vkCmdExecuteCommands.
+    m_State.CommittedVBsUpToDate = false;
+    m_State.CommittedIBUpToDate  = false;
+    m_State.ShadingRateIsSet     = false;
+    m_State.vkPipelineBindPoint  = VK_PIPELINE_BIND_POINT_MAX_ENUM;
+    m_BindInfo                   = {};
+    m_pPipelineState             = nullptr;
+}
+
+void DeviceContextVkImpl::EnableSubmitBatching(bool Enable)
+{
+    DEV_CHECK_ERR(!IsDeferred(), "Submit batching can only be enabled for immediate contexts");
+
+    if (m_SubmitBatchingEnabled && !Enable)
+        SubmitBatchedCommands();
+
+    m_SubmitBatchingEnabled = Enable;
+}
+
+void DeviceContextVkImpl::SubmitBatchedCommands()
+{
+    DEV_CHECK_ERR(!IsDeferred(), "Only immediate contexts can submit commands");
+
+    m_pDevice->LockCmdQueueAndRun(GetCommandQueueId(),
+                                  [](CommandQueueVkImpl* pCmdQueueVk) //
+                                  {
+                                      pCmdQueueVk->SubmitPendingBatches();
+                                  } //
+    );
+}
+
 void DeviceContextVkImpl::EnqueueSignal(IFence* pFence, Uint64 Value)
 {
     TDeviceContextBase::EnqueueSignal(pFence, Value, 0);
@@ -2875,6 +3198,65 @@ VkCommandBuffer DeviceContextVkImpl::GetVkCommandBuffer()
     return m_CommandBuffer.GetVkCmdBuffer();
 }
 
+void DeviceContextVkImpl::DefragmentMemory(const DefragmentMemoryAttribsVk& Attribs, DefragmentMemoryStatsVk* pStats)
+{
+    DefragmentMemoryStatsVk Stats;
+    if (pStats == nullptr)
+        pStats = &Stats;
+    *pStats = {};
+
+    DEV_CHECK_ERR(!IsDeferred(), "Memory defragmentation is only allowed in immediate contexts");
+    DEV_CHECK_ERR(m_pActiveRenderPass == nullptr, "Memory defragmentation is not allowed inside a render pass");
+    DEV_CHECK_ERR(Attribs.MaxPageOccupancy >= 0 && Attribs.MaxPageOccupancy <= 1, "MaxPageOccupancy (", Attribs.MaxPageOccupancy, ") must be in [0, 1] range");
+
+    auto Buffers = m_pDevice->SelectBuffersForRelocation(GetContextId(), Attribs, *pStats);
+    if (Buffers.empty())
+        return;
+
+    EnsureVkCmdBuffer();
+
+    // Relocatable buffers may only be written by transfer operations.
+    // Make all previous writes visible to the copy commands.
+    m_CommandBuffer.MemoryBarrier(VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    for (auto& pBuffer : Buffers)
+    {
+        const auto AllocationSize = pBuffer->GetMemoryAllocationSize();
+        if (!pBuffer->Relocate(m_CommandBuffer))
+        {
+            // There is no space left in other pages, so the page can't be evacuated now
+            m_pDevice->GetGlobalMemoryManager().SetPageEvacuating(*pBuffer->GetMemoryPage(), false);
+            continue;
+        }
+
+        ++pStats->NumMovedBuffers;
+        pStats->MovedBytes += pBuffer->GetDesc().Size;
+        pStats->RemainingBytes -= std::min(pStats->RemainingBytes, Uint64{AllocationSize});
+
+        // Vulkan handles of committed vertex and index buffers must be updated
+        for (Uint32 slot = 0; slot < m_NumVertexStreams; ++slot)
+        {
+            if (m_VertexStreams[slot].pBuffer.RawPtr() == pBuffer.RawPtr())
+                m_State.CommittedVBsUpToDate = false;
+        }
+        if (m_pIndexBuffer.RawPtr() == pBuffer.RawPtr())
+            m_State.CommittedIBUpToDate = false;
+    }
+
+    if (pStats->NumMovedBuffers == 0)
+        return;
+
+    // Buffer states are not changed: the new buffers have the same contents, and
+    // the barrier makes them available to all stages that can read them.
+    m_CommandBuffer.MemoryBarrier(VK_ACCESS_TRANSFER_WRITE_BIT,
+                                  VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT |
+                                      VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                                  VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                  VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    m_State.NumCommands += pStats->NumMovedBuffers;
+}
+
 void DeviceContextVkImpl::TransitionBufferState(BufferVkImpl& BufferVk, RESOURCE_STATE OldState, RESOURCE_STATE NewState, bool UpdateBufferState)
 {
     VERIFY(m_pActiveRenderPass == nullptr, "State transitions are not allowed inside a render pass");
@@ -29,6 +29,8 @@
 #include "FramebufferCache.hpp"
 
 #include <array>
+#include <vector>
+#include <algorithm>
 
 #include "RenderDeviceVkImpl.hpp"
 #include "HashUtils.hpp"
@@ -36,6 +38,32 @@
 namespace Diligent
 {
 
+namespace
+{
+
+template <typename MapType, typename HandleType>
+void EraseKeyReference(MapType& Map, HandleType Handle, const FramebufferCache::FramebufferCacheKey& Key)
+{
+    auto equal_range = Map.equal_range(Handle);
+    for (auto it = equal_range.first; it != equal_range.second;)
+    {
+        if (it->second == Key)
+            it = Map.erase(it);
+        else
+            ++it;
+    }
+}
+
+} // namespace
+
+FramebufferCache::FramebufferCache(RenderDeviceVkImpl& DeviceVKImpl, Uint32 MaxSize, Uint32 EvictionDelay) :
+    // clang-format off
+    m_DeviceVk     {DeviceVKImpl},
+    m_MaxSize      {MaxSize != 0 ? MaxSize : ~Uint32{0}},
+    m_EvictionDelay{std::max(EvictionDelay, 1u)}
+// clang-format on
+{
+}
 
 bool FramebufferCache::FramebufferCacheKey::operator==(const FramebufferCacheKey& rhs) const
 {
@@ -71,15 +99,24 @@ size_t FramebufferCache::FramebufferCacheKey::GetHash() const
 
 VkFramebuffer FramebufferCache::GetFramebuffer(const FramebufferCacheKey& Key, uint32_t width, uint32_t height, uint32_t layers)
 {
-    std::lock_guard<std::mutex> Lock{m_Mutex};
+    auto& Shard = GetShard(Key);
+
+    std::lock_guard<std::mutex> Lock{Shard.Mtx};
 
-    auto it = m_Cache.find(Key);
-    if (it != m_Cache.end())
+    const auto CurrentFrame = m_CurrentFrame.load();
+
+    auto it = Shard.Cache.find(Key);
+    if (it != Shard.Cache.end())
     {
-        return it->second;
+        ++Shard.NumHits;
+        it->second.LastUsedFrame = CurrentFrame;
+        Shard.LRUList.splice(Shard.LRUList.begin(), Shard.LRUList, it->second.LRUIt);
+        return it->second.Framebuffer;
     }
     else
     {
+        ++Shard.NumMisses;
+
         VkFramebufferCreateInfo FramebufferCI{};
         FramebufferCI.sType      = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         FramebufferCI.pNext      = nullptr;
@@ -108,18 +145,21 @@ VkFramebuffer FramebufferCache::GetFramebuffer(const FramebufferCacheKey& Key, u
         auto          Framebuffer  = m_DeviceVk.GetLogicalDevice().CreateFramebuffer(FramebufferCI);
         VkFramebuffer fb           = Framebuffer;
 
-        auto new_it = m_Cache.insert(std::make_pair(Key, std::move(Framebuffer)));
+        auto new_it = Shard.Cache.emplace(Key, CacheEntry{std::move(Framebuffer), CurrentFrame, {}});
         VERIFY(new_it.second, "New framebuffer must be inserted into the map");
-        (void)new_it;
+        new_it.first->second.LRUIt = Shard.LRUList.insert(Shard.LRUList.begin(), Key);
+        m_NumEntries.fetch_add(1);
 
-        m_RenderPassToKeyMap.emplace(Key.Pass, Key);
+        Shard.RenderPassToKeyMap.emplace(Key.Pass, Key);
         if (Key.DSV != VK_NULL_HANDLE)
-            m_ViewToKeyMap.emplace(Key.DSV, Key);
+            Shard.ViewToKeyMap.emplace(Key.DSV, Key);
         if (Key.ShadingRate != VK_NULL_HANDLE)
-            m_ViewToKeyMap.emplace(Key.ShadingRate, Key);
+            Shard.ViewToKeyMap.emplace(Key.ShadingRate, Key);
         for (Uint32 rt = 0; rt < Key.NumRenderTargets; ++rt)
             if (Key.RTVs[rt] != VK_NULL_HANDLE)
-                m_ViewToKeyMap.emplace(Key.RTVs[rt], Key);
+                Shard.ViewToKeyMap.emplace(Key.RTVs[rt], Key);
+
+        EvictStaleEntries(Shard);
 
         return fb;
     }
@@ -127,54 +167,133 @@ VkFramebuffer FramebufferCache::GetFramebuffer(const FramebufferCacheKey& Key, u
 
 FramebufferCache::~FramebufferCache()
 {
-    VERIFY(m_Cache.empty(), "All framebuffers must be released");
-    VERIFY(m_ViewToKeyMap.empty(), "All image views must be released and the cache must be notified");
-    VERIFY(m_RenderPassToKeyMap.empty(), "All render passes must be released and the cache must be notified");
+    for (const auto& Shard : m_Shards)
+    {
+        VERIFY(Shard.Cache.empty(), "All framebuffers must be released");
+        VERIFY(Shard.LRUList.empty(), "LRU list must be empty when the cache is empty");
+        VERIFY(Shard.ViewToKeyMap.empty(), "All image views must be released and the cache must be notified");
+        VERIFY(Shard.RenderPassToKeyMap.empty(), "All render passes must be released and the cache must be notified");
+    }
 }
 
-void FramebufferCache::OnDestroyImageView(VkImageView ImgView)
+void FramebufferCache::RemoveEntry(Shard& Shard, CacheMapType::iterator it)
+{
+    // Copy the key as the entry is about to be erased
+    const auto Key = it->first;
+
+    // The framebuffer may still be referenced by command buffers that have not been
+    // executed yet, so it is released through the release queue.
+    m_DeviceVk.SafeReleaseDeviceObject(std::move(it->second.Framebuffer), Key.CommandQueueMask);
+    Shard.LRUList.erase(it->second.LRUIt);
+    Shard.Cache.erase(it);
+    m_NumEntries.fetch_sub(1);
+
+    // Multiple image views and the render pass refer to the same key.
+    // Remove all references so that the maps do not grow with stale keys.
+    EraseKeyReference(Shard.RenderPassToKeyMap, Key.Pass, Key);
+    if (Key.DSV != VK_NULL_HANDLE)
+        EraseKeyReference(Shard.ViewToKeyMap, Key.DSV, Key);
+    if (Key.ShadingRate != VK_NULL_HANDLE)
+        EraseKeyReference(Shard.ViewToKeyMap, Key.ShadingRate, Key);
+    for (Uint32 rt = 0; rt < Key.NumRenderTargets; ++rt)
+        if (Key.RTVs[rt] != VK_NULL_HANDLE)
+            EraseKeyReference(Shard.ViewToKeyMap, Key.RTVs[rt], Key);
+}
+
+void FramebufferCache::EvictStaleEntries(Shard& Shard)
 {
-    // TODO: when a render pass is released, we need to also destroy
-    // all entries in the m_ViewToKeyMap that refer to all keys with
-    // that render pass
+    // The limit applies to the total number of entries. Only the shard being modified is
+    // trimmed, which keeps the lock scope local; with a skewed key distribution the shards
+    // that receive new entries evict their own least recently used ones.
+    const auto CurrentFrame = m_CurrentFrame.load();
+    while (m_NumEntries.load() > m_MaxSize && !Shard.LRUList.empty())
+    {
+        auto it = Shard.Cache.find(Shard.LRUList.back());
+        VERIFY_EXPR(it != Shard.Cache.end());
+        // Entries are ordered by the last used frame: if the least recently used
+        // framebuffer may still be in use by a context, so may all the others.
+        // The cache is allowed to temporarily exceed the limit in this case.
+        if (CurrentFrame < it->second.LastUsedFrame + m_EvictionDelay)
+            break;
 
-    std::lock_guard<std::mutex> Lock{m_Mutex};
+        RemoveEntry(Shard, it);
+        ++Shard.NumEvictions;
+    }
+}
 
-    auto equal_range = m_ViewToKeyMap.equal_range(ImgView);
-    for (auto it = equal_range.first; it != equal_range.second; ++it)
+void FramebufferCache::OnDestroyImageView(VkImageView ImgView)
+{
+    for (auto& Shard : m_Shards)
     {
-        auto fb_it = m_Cache.find(it->second);
+        std::lock_guard<std::mutex> Lock{Shard.Mtx};
+
+        auto equal_range = Shard.ViewToKeyMap.equal_range(ImgView);
+        if (equal_range.first == equal_range.second)
+            continue;
+
         // Multiple image views may be associated with the same key.
-        // The framebuffer is deleted whenever any of the image views is deleted
-        if (fb_it != m_Cache.end())
+        // The framebuffer is deleted whenever any of the image views is deleted.
+        // RemoveEntry() modifies the map, so copy the keys first.
+        std::vector<FramebufferCacheKey> Keys;
+        for (auto it = equal_range.first; it != equal_range.second; ++it)
+            Keys.emplace_back(it->second);
+
+        for (const auto& Key : Keys)
         {
-            m_DeviceVk.SafeReleaseDeviceObject(std::move(fb_it->second), it->second.CommandQueueMask);
-            m_Cache.erase(fb_it);
+            auto fb_it = Shard.Cache.find(Key);
+            if (fb_it != Shard.Cache.end())
+                RemoveEntry(Shard, fb_it);
         }
+        VERIFY_EXPR(Shard.ViewToKeyMap.count(ImgView) == 0);
     }
-    m_ViewToKeyMap.erase(equal_range.first, equal_range.second);
 }
 
 void FramebufferCache::OnDestroyRenderPass(VkRenderPass Pass)
 {
-    // TODO: when an image view is released, we need to also destroy
-    // all entries in the m_RenderPassToKeyMap that refer to the keys
-    // with the same image view
-    std::lock_guard<std::mutex> Lock{m_Mutex};
-
-    auto equal_range = m_RenderPassToKeyMap.equal_range(Pass);
-    for (auto it = equal_range.first; it != equal_range.second; ++it)
+    for (auto& Shard : m_Shards)
     {
-        auto fb_it = m_Cache.find(it->second);
-        // Multiple image views may be associated with the same key.
+        std::lock_guard<std::mutex> Lock{Shard.Mtx};
+
+        auto equal_range = Shard.RenderPassToKeyMap.equal_range(Pass);
+        if (equal_range.first == equal_range.second)
+            continue;
+
         // The framebuffer is deleted whenever any of the image views or render pass is destroyed
-        if (fb_it != m_Cache.end())
+        std::vector<FramebufferCacheKey> Keys;
+        for (auto it = equal_range.first; it != equal_range.second; ++it)
+            Keys.emplace_back(it->second);
+
+        for (const auto& Key : Keys)
         {
-            m_DeviceVk.SafeReleaseDeviceObject(std::move(fb_it->second), it->second.CommandQueueMask);
-            m_Cache.erase(fb_it);
+            auto fb_it = Shard.Cache.find(Key);
+            if (fb_it != Shard.Cache.end())
+                RemoveEntry(Shard, fb_it);
         }
+        VERIFY_EXPR(Shard.RenderPassToKeyMap.count(Pass) == 0);
+    }
+}
+
+void FramebufferCache::OnFrameFinished(Uint64 FrameNumber)
+{
+    // Multiple contexts may finish frames concurrently; the cache tracks the latest one
+    auto CurrentFrame = m_CurrentFrame.load();
+    while (CurrentFrame < FrameNumber && !m_CurrentFrame.compare_exchange_weak(CurrentFrame, FrameNumber))
+    {
+    }
+}
+
+void FramebufferCache::GetStats(ObjectCacheStatsVk& Stats) const
+{
+    Stats            = {};
+    Stats.MaxEntries = m_MaxSize != ~Uint32{0} ? m_MaxSize : 0;
+    for (const auto& Shard : m_Shards)
+    {
+        std::lock_guard<std::mutex> Lock{Shard.Mtx};
+        Stats.NumEntries += static_cast<Uint32>(Shard.Cache.size());
+        Stats.NumHits += Shard.NumHits;
+        Stats.NumMisses += Shard.NumMisses;
+        Stats.NumEvictions += Shard.NumEvictions;
     }
-    m_RenderPassToKeyMap.erase(equal_range.first, equal_range.second);
 }
 
 } // namespace Diligent
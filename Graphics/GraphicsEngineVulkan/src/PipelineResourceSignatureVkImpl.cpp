@@ -501,7 +501,10 @@ void PipelineResourceSignatureVkImpl::Destruct()
     for (auto& Layout : m_VkDescrSetLayouts)
     {
         if (Layout)
-            GetDevice()->SafeReleaseDeviceObject(std::move(Layout), ~0ull);
+        {
+            // Recycled descriptor sets with this layout must be freed before the layout is destroyed
+            GetDevice()->ReleaseDescriptorSetLayout(std::move(Layout), ~0ull);
+        }
     }
 
     if (m_ImmutableSamplers != nullptr)
@@ -636,7 +639,59 @@ void PipelineResourceSignatureVkImpl::CommitDynamicResources(const ShaderResourc
                                                              VkDescriptorSet              vkDynamicDescriptorSet) const
 {
     VERIFY(HasDescriptorSet(DESCRIPTOR_SET_ID_DYNAMIC), "This signature does not contain dynamic resources");
-    VERIFY_EXPR(vkDynamicDescriptorSet != VK_NULL_HANDLE);
+    WriteDescriptorSet(ResourceCache, DESCRIPTOR_SET_ID_DYNAMIC, vkDynamicDescriptorSet, nullptr, DeviceContextIndex{});
+}
+
+void PipelineResourceSignatureVkImpl::CommitOverflowDescriptorSet(const ShaderResourceCacheVk& ResourceCache,
+                                                                  DESCRIPTOR_SET_ID            SetId,
+                                                                  VkDescriptorSet              vkDescriptorSet,
+                                                                  const VulkanDynamicHeap&     DynamicHeap,
+                                                                  DeviceContextIndex           CtxId) const
+{
+    VERIFY(HasDescriptorSet(SetId), "This signature does not contain descriptor set ", static_cast<Uint32>(SetId));
+    VERIFY(DynamicHeap.HasOverflowBuffers(), "There are no overflow buffers in the dynamic heap. Cached descriptor sets should be used.");
+    WriteDescriptorSet(ResourceCache, SetId, vkDescriptorSet, &DynamicHeap, CtxId);
+}
+
+template <typename DescriptorInfoType>
+static void RepointDynamicBuffer(const ShaderResourceCacheVk::Resource&, DescriptorInfoType&, const VulkanDynamicHeap&, DeviceContextIndex)
+{
+}
+
+static void RepointDynamicBuffer(const ShaderResourceCacheVk::Resource& CachedRes,
+                                 VkDescriptorBufferInfo&                DescrBuffInfo,
+                                 const VulkanDynamicHeap&               DynamicHeap,
+                                 DeviceContextIndex                     CtxId)
+{
+    const BufferVkImpl* pBufferVk = nullptr;
+    if (CachedRes.Type == DescriptorType::UniformBufferDynamic)
+    {
+        pBufferVk = CachedRes.pObject.RawPtr<const BufferVkImpl>();
+    }
+    else if (CachedRes.Type == DescriptorType::StorageBufferDynamic ||
+             CachedRes.Type == DescriptorType::StorageBufferDynamic_ReadOnly)
+    {
+        const auto* pBuffViewVk = CachedRes.pObject.RawPtr<const BufferViewVkImpl>();
+        pBufferVk               = pBuffViewVk->GetBuffer<const BufferVkImpl>();
+    }
+
+    if (pBufferVk != nullptr)
+    {
+        // The descriptor in the cached set references the primary dynamic heap buffer.
+        // If the current allocation resides in an overflow buffer, point the descriptor to this buffer.
+        // The dynamic offset is relative to the start of the buffer that contains the allocation.
+        if (DynamicHeap.IsOverflowChunk(pBufferVk->GetDynamicChunk(CtxId)))
+            DescrBuffInfo.buffer = pBufferVk->GetVkBuffer(CtxId);
+    }
+}
+
+void PipelineResourceSignatureVkImpl::WriteDescriptorSet(const ShaderResourceCacheVk& ResourceCache,
+                                                         DESCRIPTOR_SET_ID            SetId,
+                                                         VkDescriptorSet              vkDescriptorSet,
+                                                         const VulkanDynamicHeap*     pDynamicHeap,
+                                                         DeviceContextIndex           CtxId) const
+{
+    VERIFY_EXPR(vkDescriptorSet != VK_NULL_HANDLE);
     VERIFY_EXPR(ResourceCache.GetContentType() == ResourceCacheContentType::SRB);
 
 #ifdef DILIGENT_DEBUG
@@ -666,14 +721,21 @@ void PipelineResourceSignatureVkImpl::CommitDynamicResources(const ShaderResourc
     auto AccelStructIt   = DescrAccelStructArr.begin();
     auto WriteDescrSetIt = WriteDescrSetArr.begin();
 
-    const auto  DynamicSetIdx  = GetDescriptorSetIndex<DESCRIPTOR_SET_ID_DYNAMIC>();
-    const auto& SetResources   = ResourceCache.GetDescriptorSet(DynamicSetIdx);
-    const auto& LogicalDevice  = GetDevice()->GetLogicalDevice();
-    const auto  DynResIdxRange = GetResourceIndexRange(SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC);
+    const auto SetIdx = SetId == DESCRIPTOR_SET_ID_STATIC_MUTABLE ?
+        GetDescriptorSetIndex<DESCRIPTOR_SET_ID_STATIC_MUTABLE>() :
+        GetDescriptorSetIndex<DESCRIPTOR_SET_ID_DYNAMIC>();
+    const auto& SetResources  = ResourceCache.GetDescriptorSet(SetIdx);
+    const auto& LogicalDevice = GetDevice()->GetLogicalDevice();
+    // Resources are sorted by variable type, so static and mutable resources are adjacent
+    const auto ResIdxRange = SetId == DESCRIPTOR_SET_ID_STATIC_MUTABLE ?
+        std::make_pair(GetResourceIndexRange(SHADER_RESOURCE_VARIABLE_TYPE_STATIC).first, GetResourceIndexRange(SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE).second) :
+        GetResourceIndexRange(SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC);
+    VERIFY(SetId == DESCRIPTOR_SET_ID_STATIC_MUTABLE || SetResources.GetVkDescriptorSet() == VK_NULL_HANDLE,
+           "Dynamic descriptor set must not be assigned to the resource cache");
 
     constexpr auto CacheType = ResourceCacheContentType::SRB;
 
-    for (Uint32 ResIdx = DynResIdxRange.first, ArrElem = 0; ResIdx < DynResIdxRange.second;)
+    for (Uint32 ResIdx = ResIdxRange.first, ArrElem = 0; ResIdx < ResIdxRange.second;)
     {
         const auto& Attr        = GetResourceAttribs(ResIdx);
         const auto  CacheOffset = Attr.CacheOffset(CacheType);
@@ -684,14 +746,13 @@ void PipelineResourceSignatureVkImpl::CommitDynamicResources(const ShaderResourc
         {
             const auto& Res = GetResourceDesc(ResIdx);
             VERIFY_EXPR(ArraySize == GetResourceDesc(ResIdx).ArraySize);
-            VERIFY_EXPR(Res.VarType == SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC);
+            VERIFY_EXPR(VarTypeToDescriptorSetId(Res.VarType) == SetId);
         }
 #endif
 
-        WriteDescrSetIt->sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        WriteDescrSetIt->pNext = nullptr;
-        VERIFY(SetResources.GetVkDescriptorSet() == VK_NULL_HANDLE, "Dynamic descriptor set must not be assigned to the resource cache");
-        WriteDescrSetIt->dstSet = vkDynamicDescriptorSet;
+        WriteDescrSetIt->sType  = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        WriteDescrSetIt->pNext  = nullptr;
+        WriteDescrSetIt->dstSet = vkDescriptorSet;
         VERIFY(WriteDescrSetIt->dstSet != VK_NULL_HANDLE, "Vulkan descriptor set must not be null");
         WriteDescrSetIt->dstBinding      = Attr.BindingIndex;
         WriteDescrSetIt->dstArrayElement = ArrElem;
@@ -707,6 +768,8 @@ void PipelineResourceSignatureVkImpl::CommitDynamicResources(const ShaderResourc
                 if (const auto& CachedRes = SetResources.GetResource(CacheOffset + (ArrElem++)))
                 {
                     *DescrIt = CachedRes.GetDescriptorWriteInfo<DescrType>();
+                    if (pDynamicHeap != nullptr)
+                        RepointDynamicBuffer(CachedRes, *DescrIt, *pDynamicHeap, CtxId);
                     ++DescrIt;
                     ++WriteDescrSetIt->descriptorCount;
                 }
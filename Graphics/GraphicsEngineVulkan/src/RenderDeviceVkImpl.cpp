@@ -55,6 +55,9 @@
 namespace Diligent
 {
 
+// Set while the current thread executes the memory pressure callback
+static thread_local bool g_InMemoryPressureCallback = false;
+
 RenderDeviceVkImpl::RenderDeviceVkImpl(IReferenceCounters*                                    pRefCounters,
                                        IMemoryAllocator&                                      RawMemAllocator,
                                        IEngineFactory*                                        pEngineFactory,
@@ -79,8 +82,8 @@ RenderDeviceVkImpl::RenderDeviceVkImpl(IReferenceCounters*
     m_VulkanInstance         {Instance                 },
     m_PhysicalDevice         {std::move(PhysicalDevice)},
     m_LogicalVkDevice        {std::move(LogicalDevice) },
-    m_FramebufferCache       {*this                    },
-    m_ImplicitRenderPassCache{*this                    },
+    m_FramebufferCache       {*this, EngineCI.FramebufferCacheSize,        EngineCI.ObjectCacheEvictionDelay},
+    m_ImplicitRenderPassCache{*this, EngineCI.ImplicitRenderPassCacheSize, EngineCI.ObjectCacheEvictionDelay},
     m_DescriptorSetAllocator
     {
         *this,
@@ -141,6 +144,8 @@ RenderDeviceVkImpl::RenderDeviceVkImpl(IReferenceCounters*
         GetRawAllocator(),
         *this,
         EngineCI.DynamicHeapSize,
+        EngineCI.DynamicHeapMaxSize,
+        EngineCI.DynamicHeapShrinkDelay,
         ~Uint64{0}
     },
     m_pDxCompiler{CreateDXCompiler(DXCompilerTarget::Vulkan, m_PhysicalDevice->GetVkVersion(), EngineCI.pDxCompilerPath)}
@@ -388,11 +393,15 @@ void RenderDeviceVkImpl::SubmitCommandBuffer(SoftwareQueueIndex
                                              const VkSubmitInfo&                                         SubmitInfo,
                                              Uint64&                                                     SubmittedCmdBuffNumber, // Number of the submitted command buffer
                                              Uint64&                                                     SubmittedFenceValue,    // Fence value associated with the submitted command buffer
-                                             std::vector<std::pair<Uint64, RefCntAutoPtr<FenceVkImpl>>>* pSignalFences           // List of fences to signal
+                                             std::vector<std::pair<Uint64, RefCntAutoPtr<FenceVkImpl>>>* pSignalFences,          // List of fences to signal
+                                             bool                                                        DeferSubmission         // Whether to add the command buffer to pending batches
 )
 {
+    // Fences can only be signaled by the sync point of an actual submission
+    VERIFY(!DeferSubmission || pSignalFences == nullptr || pSignalFences->empty(), "Submission can't be deferred when there are fences to signal");
+
     // Submit the command list to the queue
-    auto CmbBuffInfo       = TRenderDeviceBase::SubmitCommandBuffer(CommandQueueId, true, SubmitInfo);
+    auto CmbBuffInfo       = TRenderDeviceBase::SubmitCommandBuffer(CommandQueueId, true, SubmitInfo, DeferSubmission);
     SubmittedFenceValue    = CmbBuffInfo.FenceValue;
     SubmittedCmdBuffNumber = CmbBuffInfo.CmdBufferNumber;
 
@@ -410,13 +419,18 @@ void RenderDeviceVkImpl::SubmitCommandBuffer(SoftwareQueueIndex
     }
 }
 
-Uint64 RenderDeviceVkImpl::ExecuteCommandBuffer(SoftwareQueueIndex CommandQueueId, const VkSubmitInfo& SubmitInfo, std::vector<std::pair<Uint64, RefCntAutoPtr<FenceVkImpl>>>* pSignalFences)
+Uint64 RenderDeviceVkImpl::ExecuteCommandBuffer(SoftwareQueueIndex CommandQueueId, const VkSubmitInfo& SubmitInfo, std::vector<std::pair<Uint64, RefCntAutoPtr<FenceVkImpl>>>* pSignalFences, bool DeferSubmission)
 {
+    // The callback is executed by the thread that submits the command buffer, in the middle of
+    // the context's flush. Submitting more work from it would re-enter the context and the queue.
+    DEV_CHECK_ERR(!g_InMemoryPressureCallback, "Command buffers must not be submitted from the memory pressure callback");
+
     Uint64 SubmittedFenceValue    = 0;
     Uint64 SubmittedCmdBuffNumber = 0;
-    SubmitCommandBuffer(CommandQueueId, SubmitInfo, SubmittedCmdBuffNumber, SubmittedFenceValue, pSignalFences);
+    SubmitCommandBuffer(CommandQueueId, SubmitInfo, SubmittedCmdBuffNumber, SubmittedFenceValue, pSignalFences, DeferSubmission);
 
     m_MemoryMgr.ShrinkMemory();
+    CheckMemoryPressure();
     PurgeReleaseQueue(CommandQueueId);
 
     return SubmittedFenceValue;
@@ -439,6 +453,280 @@ void RenderDeviceVkImpl::FlushStaleResources(SoftwareQueueIndex CmdQueueIndex)
     TRenderDeviceBase::SubmitCommandBuffer(CmdQueueIndex, true, DummySubmitInfo);
 }
 
+void RenderDeviceVkImpl::GetMemoryPageStats(Uint32& NumPages, MemoryPageStatsVk* pPageStats) const
+{
+    std::vector<VulkanUtilities::VulkanMemoryPageStats> Stats;
+    m_MemoryMgr.GetPageStats(Stats);
+    if (pPageStats == nullptr)
+    {
+        NumPages = static_cast<Uint32>(Stats.size());
+        return;
+    }
+
+    NumPages = std::min(NumPages, static_cast<Uint32>(Stats.size()));
+    for (Uint32 i = 0; i < NumPages; ++i)
+    {
+        const auto& Src = Stats[i];
+        auto&       Dst = pPageStats[i];
+
+        Dst.MemoryTypeIndex  = Src.MemoryTypeIndex;
+        Dst.IsHostVisible    = Src.IsHostVisible;
+        Dst.IsEvacuating     = Src.IsEvacuating;
+        Dst.Size             = Src.Size;
+        Dst.UsedSize         = Src.UsedSize;
+        Dst.MaxFreeBlockSize = Src.MaxFreeBlock;
+        Dst.NumFreeBlocks    = static_cast<Uint32>(Src.NumFreeBlocks);
+    }
+}
+
+static MemoryHeapBudgetVk VkHeapBudgetToMemoryHeapBudgetVk(const VulkanUtilities::VulkanMemoryHeapBudget& Src)
+{
+    MemoryHeapBudgetVk Dst;
+    Dst.Size             = Src.Size;
+    Dst.Budget           = Src.Budget;
+    Dst.Usage            = Src.Usage;
+    Dst.AllocatedSize    = Src.AllocatedSize;
+    Dst.IsDeviceLocal    = (Src.Flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+    Dst.IsDriverReported = Src.IsDriverReported;
+    return Dst;
+}
+
+void RenderDeviceVkImpl::GetMemoryBudget(Uint32& NumHeaps, MemoryHeapBudgetVk* pBudgets) const
+{
+    std::vector<VulkanUtilities::VulkanMemoryHeapBudget> Budgets;
+    m_MemoryMgr.GetHeapBudgets(Budgets);
+    if (pBudgets == nullptr)
+    {
+        NumHeaps = static_cast<Uint32>(Budgets.size());
+        return;
+    }
+
+    NumHeaps = std::min(NumHeaps, static_cast<Uint32>(Budgets.size()));
+    for (Uint32 i = 0; i < NumHeaps; ++i)
+        pBudgets[i] = VkHeapBudgetToMemoryHeapBudgetVk(Budgets[i]);
+}
+
+void RenderDeviceVkImpl::SetMemoryPressureCallback(const MemoryPressureCallbackAttribsVk& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.Callback == nullptr || (Attribs.HighWatermark > 0 && Attribs.LowWatermark <= Attribs.HighWatermark),
+                  "Memory pressure callback watermarks are invalid: high watermark must be positive and not less than the low watermark");
+
+    std::lock_guard<std::mutex> Lock{m_MemoryPressureMtx};
+    m_MemoryPressureAttribs = Attribs;
+    // Re-evaluate all heaps at the next submit
+    m_HeapAboveHighWatermark = {};
+    m_LastPageSetVersion     = ~Uint32{0};
+    m_MemoryPressureCallbackSet.store(Attribs.Callback != nullptr);
+}
+
+void RenderDeviceVkImpl::CheckMemoryPressure()
+{
+    if (!m_MemoryPressureCallbackSet.load())
+        return;
+
+    // Skip the check if it is being performed by another thread
+    std::unique_lock<std::mutex> Lock{m_MemoryPressureMtx, std::try_to_lock};
+    if (!Lock.owns_lock() || m_MemoryPressureAttribs.Callback == nullptr)
+        return;
+
+    // Without VK_EXT_memory_budget, the usage only changes when the memory manager creates or destroys a page
+    const auto PageSetVersion = m_MemoryMgr.GetPageSetVersion();
+    if (PageSetVersion == m_LastPageSetVersion)
+    {
+        if (!m_LogicalVkDevice->GetEnabledExtFeatures().MemoryBudget || ++m_SubmitsSinceBudgetQuery < MemoryBudgetPollInterval)
+            return;
+    }
+    m_LastPageSetVersion      = PageSetVersion;
+    m_SubmitsSinceBudgetQuery = 0;
+
+    std::vector<VulkanUtilities::VulkanMemoryHeapBudget> Budgets;
+    m_MemoryMgr.GetHeapBudgets(Budgets);
+
+    const auto Attribs = m_MemoryPressureAttribs;
+
+    std::vector<std::pair<Uint32, MemoryHeapBudgetVk>> PressuredHeaps;
+    for (Uint32 HeapIdx = 0; HeapIdx < Budgets.size(); ++HeapIdx)
+    {
+        const auto& Budget = Budgets[HeapIdx];
+        const auto  Usage  = static_cast<double>(Budget.Usage);
+        if (!m_HeapAboveHighWatermark[HeapIdx])
+        {
+            if (Usage > static_cast<double>(Budget.Budget) * Attribs.HighWatermark)
+            {
+                m_HeapAboveHighWatermark[HeapIdx] = true;
+                PressuredHeaps.emplace_back(HeapIdx, VkHeapBudgetToMemoryHeapBudgetVk(Budget));
+            }
+        }
+        else if (Usage < static_cast<double>(Budget.Budget) * Attribs.LowWatermark)
+        {
+            m_HeapAboveHighWatermark[HeapIdx] = false;
+        }
+    }
+
+    // The callback may release or create resources, so it must not be called while holding the lock
+    Lock.unlock();
+
+    g_InMemoryPressureCallback = true;
+    for (const auto& Heap : PressuredHeaps)
+        Attribs.Callback(Heap.first, Heap.second, Attribs.pUserData);
+    g_InMemoryPressureCallback = false;
+}
+
+void RenderDeviceVkImpl::RegisterRelocatableBuffer(BufferVkImpl& Buffer)
+{
+    std::lock_guard<std::mutex> Lock{m_RelocatableBuffersMtx};
+    m_RelocatableBuffers.emplace(&Buffer, RefCntWeakPtr<BufferVkImpl>{&Buffer});
+}
+
+void RenderDeviceVkImpl::UnregisterRelocatableBuffer(BufferVkImpl& Buffer)
+{
+    std::lock_guard<std::mutex> Lock{m_RelocatableBuffersMtx};
+    m_RelocatableBuffers.erase(&Buffer);
+}
+
+std::vector<RefCntAutoPtr<BufferVkImpl>> RenderDeviceVkImpl::SelectBuffersForRelocation(DeviceContextIndex               CtxId,
+                                                                                        const DefragmentMemoryAttribsVk& Attribs,
+                                                                                        DefragmentMemoryStatsVk&         Stats)
+{
+    using PageStats = VulkanUtilities::VulkanMemoryPageStats;
+
+    struct PageInfo
+    {
+        const PageStats* pStats = nullptr;
+
+        // Relocatable buffers in the page and their total allocation size
+        std::vector<RefCntAutoPtr<BufferVkImpl>> Buffers;
+        VkDeviceSize                             RelocatableSize = 0;
+
+        bool Evacuate = false;
+    };
+
+    std::vector<PageStats> AllPageStats;
+    m_MemoryMgr.GetPageStats(AllPageStats);
+
+    std::unordered_map<const VulkanUtilities::VulkanMemoryPage*, PageInfo> Pages;
+    for (const auto& Page : AllPageStats)
+        Pages[Page.pPage].pStats = &Page;
+
+    std::vector<RefCntAutoPtr<BufferVkImpl>> RelocatableBuffers;
+    {
+        std::lock_guard<std::mutex> Lock{m_RelocatableBuffersMtx};
+        RelocatableBuffers.reserve(m_RelocatableBuffers.size());
+        for (auto& it : m_RelocatableBuffers)
+        {
+            // Lock a copy as Lock() releases the weak pointer if the object is not alive,
+            // which is also the case while the buffer is still being constructed.
+            if (auto pBuffer = RefCntWeakPtr<BufferVkImpl>{it.second}.Lock())
+                RelocatableBuffers.emplace_back(std::move(pBuffer));
+        }
+    }
+    // Strong references must not be released while m_RelocatableBuffersMtx is locked:
+    // if the reference is the last one, the destructor will try to unregister the buffer.
+
+    const Uint64 CtxMask = Uint64{1} << Uint64{CtxId};
+    for (auto& pBuffer : RelocatableBuffers)
+    {
+        if (pBuffer->GetDesc().ImmediateContextMask != CtxMask)
+            continue;
+
+        auto page_it = Pages.find(pBuffer->GetMemoryPage());
+        if (page_it == Pages.end())
+            continue;
+
+        page_it->second.RelocatableSize += pBuffer->GetMemoryAllocationSize();
+        page_it->second.Buffers.emplace_back(std::move(pBuffer));
+    }
+
+    // Group pages by memory type, allocation flags and host visibility as allocations can only be moved within a group
+    std::unordered_map<Uint64, std::vector<PageInfo*>> PageGroups;
+    for (auto& it : Pages)
+    {
+        const auto& Page = *it.second.pStats;
+
+        const Uint64 GroupKey = (Uint64{Page.AllocateFlags} << Uint64{33}) | (Uint64{Page.MemoryTypeIndex} << Uint64{1}) | (Page.IsHostVisible ? 1 : 0);
+        PageGroups[GroupKey].push_back(&it.second);
+    }
+
+    std::vector<PageInfo*> EvacuatingPages;
+    for (auto& Group : PageGroups)
+    {
+        auto& GroupPages = Group.second;
+
+        VkDeviceSize TotalFreeSize = 0;
+        for (const auto* pPage : GroupPages)
+            TotalFreeSize += pPage->pStats->Size - pPage->pStats->UsedSize;
+
+        // Pages whose allocations all belong to relocatable buffers are candidates.
+        // Start with the sparsest ones.
+        std::vector<PageInfo*> Candidates;
+        for (auto* pPage : GroupPages)
+        {
+            const auto& Page = *pPage->pStats;
+            if (Page.UsedSize == 0 || pPage->RelocatableSize != Page.UsedSize)
+                continue;
+
+            if (Page.IsEvacuating || static_cast<float>(Page.UsedSize) <= Attribs.MaxPageOccupancy * static_cast<float>(Page.Size))
+                Candidates.push_back(pPage);
+        }
+        std::sort(Candidates.begin(), Candidates.end(),
+                  [](const PageInfo* lhs, const PageInfo* rhs) {
+                      // Continue evacuating pages that were selected before
+                      if (lhs->pStats->IsEvacuating != rhs->pStats->IsEvacuating)
+                          return lhs->pStats->IsEvacuating;
+                      return lhs->pStats->UsedSize < rhs->pStats->UsedSize;
+                  });
+
+        // Evacuate pages while the remaining pages have enough free space to hold the
+        // evacuated data. Leave some slack as the free space may be fragmented.
+        VkDeviceSize EvacuatedSize = 0;
+        for (auto* pPage : Candidates)
+        {
+            const auto& Page          = *pPage->pStats;
+            const auto  RemainingFree = TotalFreeSize - (Page.Size - Page.UsedSize);
+            if ((EvacuatedSize + Page.UsedSize) * 4 > RemainingFree * 3)
+                break;
+
+            EvacuatedSize += Page.UsedSize;
+            TotalFreeSize = RemainingFree;
+            pPage->Evacuate = true;
+            EvacuatingPages.push_back(pPage);
+        }
+
+        for (auto* pPage : GroupPages)
+        {
+            if (pPage->pStats->IsEvacuating != pPage->Evacuate)
+                m_MemoryMgr.SetPageEvacuating(*pPage->pStats->pPage, pPage->Evacuate);
+        }
+    }
+
+    std::vector<RefCntAutoPtr<BufferVkImpl>> Buffers;
+
+    Uint64 BytesToMove = 0;
+    bool   BudgetExceeded = false;
+    for (auto* pPage : EvacuatingPages)
+    {
+        Stats.RemainingBytes += pPage->RelocatableSize;
+        for (auto& pBuffer : pPage->Buffers)
+        {
+            if (BudgetExceeded)
+                break;
+
+            // Always move at least one buffer to make progress
+            if (!Buffers.empty() && BytesToMove + pBuffer->GetDesc().Size > Attribs.MaxBytesToMove)
+            {
+                BudgetExceeded = true;
+                break;
+            }
+
+            BytesToMove += pBuffer->GetDesc().Size;
+            Buffers.emplace_back(std::move(pBuffer));
+        }
+    }
+    Stats.NumEvacuatingPages = static_cast<Uint32>(EvacuatingPages.size());
+
+    return Buffers;
+}
+
 void RenderDeviceVkImpl::ReleaseStaleResources(bool ForceRelease)
 {
     m_MemoryMgr.ShrinkMemory();
@@ -30,6 +30,7 @@
 #include "RenderPassCache.hpp"
 
 #include <sstream>
+#include <algorithm>
 
 #include "RenderDeviceVkImpl.hpp"
 #include "PipelineStateVkImpl.hpp"
@@ -38,8 +39,12 @@
 namespace Diligent
 {
 
-RenderPassCache::RenderPassCache(RenderDeviceVkImpl& DeviceVk) noexcept :
-    m_DeviceVkImpl{DeviceVk}
+RenderPassCache::RenderPassCache(RenderDeviceVkImpl& DeviceVk, Uint32 MaxSize, Uint32 EvictionDelay) noexcept :
+    // clang-format off
+    m_DeviceVkImpl {DeviceVk},
+    m_MaxSize      {MaxSize != 0 ? MaxSize : ~Uint32{0}},
+    m_EvictionDelay{std::max(EvictionDelay, 1u)}
+// clang-format on
 {}
 
 
@@ -48,17 +53,76 @@ RenderPassCache::~RenderPassCache()
     // Render pass cache is part of the render device, so we can't release
     // render pass objects from here as their destructors will attempt to
     // call SafeReleaseDeviceObject.
-    VERIFY(m_Cache.empty(), "Render pass cache is not empty. Did you call Destroy?");
+    for (const auto& Shard : m_Shards)
+        VERIFY(Shard.Cache.empty(), "Render pass cache is not empty. Did you call Destroy?");
 }
 
 void RenderPassCache::Destroy()
 {
     auto& FBCache = m_DeviceVkImpl.GetFramebufferCache();
-    for (auto it = m_Cache.begin(); it != m_Cache.end(); ++it)
+    for (auto& Shard : m_Shards)
+    {
+        std::lock_guard<std::mutex> Lock{Shard.Mtx};
+        for (auto it = Shard.Cache.begin(); it != Shard.Cache.end(); ++it)
+        {
+            FBCache.OnDestroyRenderPass(it->second.pRenderPass->GetVkRenderPass());
+        }
+        m_NumEntries.fetch_sub(static_cast<Uint32>(Shard.Cache.size()));
+        Shard.Cache.clear();
+        Shard.LRUList.clear();
+    }
+}
+
+void RenderPassCache::EvictStaleEntries(Shard& Shard)
+{
+    auto&      FBCache      = m_DeviceVkImpl.GetFramebufferCache();
+    const auto CurrentFrame = m_CurrentFrame.load();
+    for (auto lru_it = Shard.LRUList.end(); m_NumEntries.load() > m_MaxSize && lru_it != Shard.LRUList.begin();)
+    {
+        --lru_it;
+        auto it = Shard.Cache.find(*lru_it);
+        VERIFY_EXPR(it != Shard.Cache.end());
+
+        // Entries are ordered by the last used frame, so all remaining render passes
+        // may still be in use by device contexts.
+        if (CurrentFrame < it->second.LastUsedFrame + m_EvictionDelay)
+            break;
+
+        // Render passes referenced by pipeline states can't be evicted as contexts
+        // compare the pipeline's render pass with the one from the cache.
+        if (it->second.pRenderPass->GetReferenceCounters()->GetNumStrongRefs() > 1)
+            continue;
+
+        // Framebuffers that use the render pass must be released first.
+        // The render pass itself is released through the release queue by its destructor.
+        FBCache.OnDestroyRenderPass(it->second.pRenderPass->GetVkRenderPass());
+        lru_it = Shard.LRUList.erase(lru_it);
+        Shard.Cache.erase(it);
+        m_NumEntries.fetch_sub(1);
+        ++Shard.NumEvictions;
+    }
+}
+
+void RenderPassCache::OnFrameFinished(Uint64 FrameNumber)
+{
+    auto CurrentFrame = m_CurrentFrame.load();
+    while (CurrentFrame < FrameNumber && !m_CurrentFrame.compare_exchange_weak(CurrentFrame, FrameNumber))
     {
-        FBCache.OnDestroyRenderPass(it->second->GetVkRenderPass());
     }
-    m_Cache.clear();
+}
+
+void RenderPassCache::GetStats(ObjectCacheStatsVk& Stats) const
+{
+    Stats            = {};
+    Stats.MaxEntries = m_MaxSize != ~Uint32{0} ? m_MaxSize : 0;
+    for (const auto& Shard : m_Shards)
+    {
+        std::lock_guard<std::mutex> Lock{Shard.Mtx};
+        Stats.NumEntries += static_cast<Uint32>(Shard.Cache.size());
+        Stats.NumHits += Shard.NumHits;
+        Stats.NumMisses += Shard.NumMisses;
+        Stats.NumEvictions += Shard.NumEvictions;
+    }
 }
 
 static RenderPassDesc GetImplicitRenderPassDesc(
@@ -182,10 +246,23 @@ static RenderPassDesc GetImplicitRenderPassDesc(
 
 RenderPassVkImpl* RenderPassCache::GetRenderPass(const RenderPassCacheKey& Key)
 {
-    std::lock_guard<std::mutex> Lock{m_Mutex};
-    auto                        it = m_Cache.find(Key);
-    if (it == m_Cache.end())
+    auto& Shard = GetShard(Key);
+
+    std::lock_guard<std::mutex> Lock{Shard.Mtx};
+
+    const auto CurrentFrame = m_CurrentFrame.load();
+
+    auto it = Shard.Cache.find(Key);
+    if (it != Shard.Cache.end())
+    {
+        ++Shard.NumHits;
+        it->second.LastUsedFrame = CurrentFrame;
+        Shard.LRUList.splice(Shard.LRUList.begin(), Shard.LRUList, it->second.LRUIt);
+    }
+    else
     {
+        ++Shard.NumMisses;
+
         // Do not zero-initialize arrays
         std::array<RenderPassAttachmentDesc, MAX_RENDER_TARGETS + 2> Attachments;
         std::array<AttachmentReference, MAX_RENDER_TARGETS + 2>      AttachmentReferences;
@@ -235,10 +312,18 @@ RenderPassVkImpl* RenderPassCache::GetRenderPass(const RenderPassCacheKey& Key)
             UNEXPECTED("Failed to create render pass");
             return nullptr;
         }
-        it = m_Cache.emplace(Key, std::move(pRenderPass)).first;
+        it = Shard.Cache.emplace(Key, CacheEntry{std::move(pRenderPass), CurrentFrame, {}}).first;
+
+        it->second.LRUIt = Shard.LRUList.insert(Shard.LRUList.begin(), Key);
+        m_NumEntries.fetch_add(1);
+
+        // The new render pass is at the front of the LRU list and will not be evicted
+        RenderPassVkImpl* pNewRenderPass = it->second.pRenderPass;
+        EvictStaleEntries(Shard);
+        return pNewRenderPass;
     }
 
-    return it->second;
+    return it->second.pRenderPass;
 }
 
 } // namespace Diligent
@@ -47,16 +47,40 @@ static VkDeviceSize GetDefaultAlignment(const VulkanUtilities::VulkanPhysicalDev
 VulkanDynamicMemoryManager::VulkanDynamicMemoryManager(IMemoryAllocator&   Allocator,
                                                        RenderDeviceVkImpl& DeviceVk,
                                                        Uint32              Size,
+                                                       Uint32              MaxSize,
+                                                       Uint32              ShrinkDelay,
                                                        Uint64              CommandQueueMask) :
     // clang-format off
-    TBase             {Allocator, Size},
     m_DeviceVk        {DeviceVk},
+    m_Allocator       {Allocator},
     m_DefaultAlignment{GetDefaultAlignment(DeviceVk.GetPhysicalDevice())},
-    m_CommandQueueMask{CommandQueueMask}
+    m_CommandQueueMask{CommandQueueMask},
+    m_ChunkSize       {Size},
+    m_MaxSize         {std::max(MaxSize, Size)},
+    m_ShrinkDelay     {ShrinkDelay}
 // clang-format on
 {
     VERIFY((Size & (MasterBlockAlignment - 1)) == 0, "Heap size (", Size, " is not aligned by the master block alignment (", Uint32{MasterBlockAlignment}, ")");
 
+    m_Chunks.emplace_back(CreateChunk(Size, false, "Dynamic heap buffer"));
+    m_vkPrimaryBuffer = m_Chunks[0]->vkBuffer;
+    UpdatePeakStats();
+
+    if (m_MaxSize > m_ChunkSize)
+    {
+        LOG_INFO_MESSAGE("GPU dynamic heap created. Initial buffer size: ", FormatMemorySize(Size, 2),
+                         ". Max size: ", FormatMemorySize(m_MaxSize, 2));
+    }
+    else
+    {
+        LOG_INFO_MESSAGE("GPU dynamic heap created. Total buffer size: ", FormatMemorySize(Size, 2));
+    }
+}
+
+std::unique_ptr<VulkanDynamicMemoryManager::Chunk> VulkanDynamicMemoryManager::CreateChunk(OffsetType Size, bool IsOverflow, const char* Name)
+{
+    std::unique_ptr<Chunk> pChunk{new Chunk{m_Allocator, Size, IsOverflow}};
+
     VkBufferCreateInfo VkBuffCI{};
     VkBuffCI.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     VkBuffCI.pNext = nullptr;
@@ -73,11 +97,11 @@ VulkanDynamicMemoryManager::VulkanDynamicMemoryManager(IMemoryAllocator&   Alloc
     VkBuffCI.queueFamilyIndexCount = 0;
     VkBuffCI.pQueueFamilyIndices   = nullptr;
 
-    const auto& LogicalDevice    = DeviceVk.GetLogicalDevice();
-    m_VkBuffer                   = LogicalDevice.CreateBuffer(VkBuffCI, "Dynamic heap buffer");
-    VkMemoryRequirements MemReqs = LogicalDevice.GetBufferMemoryRequirements(m_VkBuffer);
+    const auto& LogicalDevice    = m_DeviceVk.GetLogicalDevice();
+    pChunk->vkBuffer             = LogicalDevice.CreateBuffer(VkBuffCI, Name);
+    VkMemoryRequirements MemReqs = LogicalDevice.GetBufferMemoryRequirements(pChunk->vkBuffer);
 
-    const auto& PhysicalDevice = DeviceVk.GetPhysicalDevice();
+    const auto& PhysicalDevice = m_DeviceVk.GetPhysicalDevice();
 
     VkMemoryAllocateInfo MemAlloc{};
     MemAlloc.pNext          = nullptr;
@@ -95,66 +119,195 @@ VulkanDynamicMemoryManager::VulkanDynamicMemoryManager(IMemoryAllocator&   Alloc
            "corresponding to a VkMemoryType with a propertyFlags that has both the VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT bit "
            "and the VK_MEMORY_PROPERTY_HOST_COHERENT_BIT bit set(11.6)");
 
-    m_BufferMemory = LogicalDevice.AllocateDeviceMemory(MemAlloc, "Host-visible memory for upload buffer");
+    pChunk->vkMemory = LogicalDevice.AllocateDeviceMemory(MemAlloc, "Host-visible memory for dynamic heap buffer");
 
     void* Data = nullptr;
 
     auto err = LogicalDevice.MapMemory(
-        m_BufferMemory,
+        pChunk->vkMemory,
         0, // offset
         MemAlloc.allocationSize,
         0, // flags, reserved for future use
         &Data);
-    m_CPUAddress = reinterpret_cast<Uint8*>(Data);
+    pChunk->CPUAddress = reinterpret_cast<Uint8*>(Data);
     CHECK_VK_ERROR_AND_THROW(err, "Failed to map  memory");
 
-    err = LogicalDevice.BindBufferMemory(m_VkBuffer, m_BufferMemory, 0 /*offset*/);
+    err = LogicalDevice.BindBufferMemory(pChunk->vkBuffer, pChunk->vkMemory, 0 /*offset*/);
     CHECK_VK_ERROR_AND_THROW(err, "Failed to bind buffer memory");
 
-    LOG_INFO_MESSAGE("GPU dynamic heap created. Total buffer size: ", FormatMemorySize(Size, 2));
+    pChunk->LastUsedFrame = m_CurrentFrame;
+
+    return pChunk;
 }
 
-void VulkanDynamicMemoryManager::Destroy()
+void VulkanDynamicMemoryManager::ReleaseChunk(Chunk& ChunkToRelease)
 {
-    if (m_VkBuffer)
+    if (ChunkToRelease.vkBuffer)
     {
-        m_DeviceVk.GetLogicalDevice().UnmapMemory(m_BufferMemory);
-        m_DeviceVk.SafeReleaseDeviceObject(std::move(m_VkBuffer), m_CommandQueueMask);
-        m_DeviceVk.SafeReleaseDeviceObject(std::move(m_BufferMemory), m_CommandQueueMask);
+        m_DeviceVk.GetLogicalDevice().UnmapMemory(ChunkToRelease.vkMemory);
+        m_DeviceVk.SafeReleaseDeviceObject(std::move(ChunkToRelease.vkBuffer), m_CommandQueueMask);
+        m_DeviceVk.SafeReleaseDeviceObject(std::move(ChunkToRelease.vkMemory), m_CommandQueueMask);
     }
-    m_CPUAddress = nullptr;
+    ChunkToRelease.CPUAddress = nullptr;
+}
+
+void VulkanDynamicMemoryManager::Destroy()
+{
+    // Stale master blocks lock the chunks mutex while the release queue is locked,
+    // so objects must not be added to the release queue while the chunks mutex is locked.
+    for (auto& pChunk : m_Chunks)
+        ReleaseChunk(*pChunk);
+    m_vkPrimaryBuffer = VK_NULL_HANDLE;
 }
 
 VulkanDynamicMemoryManager::~VulkanDynamicMemoryManager()
 {
-    VERIFY(m_BufferMemory == VK_NULL_HANDLE && m_VkBuffer == VK_NULL_HANDLE, "Vulkan resources must be explicitly released with Destroy()");
-    auto Size = GetSize();
+#ifdef DILIGENT_DEBUG
+    for (const auto& pChunk : m_Chunks)
+        VERIFY(pChunk->vkMemory == VK_NULL_HANDLE && pChunk->vkBuffer == VK_NULL_HANDLE, "Vulkan resources must be explicitly released with Destroy()");
+#endif
+    DEV_CHECK_ERR(m_MasterBlockCounter == 0, m_MasterBlockCounter, " master block(s) have not been returned to the manager");
+
     LOG_INFO_MESSAGE("Dynamic memory manager usage stats:\n"
-                     "                       Total size: ",
-                     FormatMemorySize(Size, 2),
-                     ". Peak allocated size: ", FormatMemorySize(m_TotalPeakSize, 2, Size),
+                     "                       Initial size: ",
+                     FormatMemorySize(m_ChunkSize, 2),
+                     ". Peak size: ", FormatMemorySize(m_PeakBufferSize, 2),
+                     " (", m_PeakNumBuffers, (m_PeakNumBuffers == 1 ? " buffer)" : " buffers)"),
+                     ". Peak allocated size: ", FormatMemorySize(m_TotalPeakSize, 2, m_PeakBufferSize),
                      ". Peak utilization: ",
-                     std::fixed, std::setprecision(1), static_cast<double>(m_TotalPeakSize) / static_cast<double>(std::max(Size, size_t{1})) * 100.0, '%');
+                     std::fixed, std::setprecision(1), static_cast<double>(m_TotalPeakSize) / static_cast<double>(std::max(m_PeakBufferSize, size_t{1})) * 100.0, '%',
+                     ". Grow/shrink count: ", m_GrowCount, " / ", m_ShrinkCount);
+}
+
+VulkanDynamicMemoryManager::OffsetType VulkanDynamicMemoryManager::GetSize() const
+{
+    std::lock_guard<std::mutex> Lock{m_ChunksMtx};
+    return m_Chunks.size() * m_ChunkSize;
+}
+
+VulkanDynamicMemoryManager::OffsetType VulkanDynamicMemoryManager::GetUsedSize() const
+{
+    std::lock_guard<std::mutex> Lock{m_ChunksMtx};
+
+    OffsetType UsedSize = 0;
+    for (const auto& pChunk : m_Chunks)
+        UsedSize += pChunk->AllocationsMgr.GetUsedSize();
+    return UsedSize;
+}
+
+void VulkanDynamicMemoryManager::GetStats(DynamicHeapStatsVk& Stats) const
+{
+    std::lock_guard<std::mutex> Lock{m_ChunksMtx};
+
+    Stats                 = {};
+    Stats.CurrentSize     = m_Chunks.size() * m_ChunkSize;
+    Stats.PeakSize        = m_PeakBufferSize;
+    Stats.PeakUsedSize    = m_TotalPeakSize;
+    Stats.BufferCount     = static_cast<Uint32>(m_Chunks.size());
+    Stats.PeakBufferCount = m_PeakNumBuffers;
+    Stats.GrowCount       = m_GrowCount;
+    Stats.ShrinkCount     = m_ShrinkCount;
+    for (const auto& pChunk : m_Chunks)
+        Stats.CurrentUsedSize += pChunk->AllocationsMgr.GetUsedSize();
 }
 
+void VulkanDynamicMemoryManager::UpdatePeakStats()
+{
+    OffsetType UsedSize = 0;
+    for (const auto& pChunk : m_Chunks)
+        UsedSize += pChunk->AllocationsMgr.GetUsedSize();
+
+    m_TotalPeakSize  = std::max(m_TotalPeakSize, UsedSize);
+    m_PeakBufferSize = std::max(m_PeakBufferSize, m_Chunks.size() * m_ChunkSize);
+    m_PeakNumBuffers = std::max(m_PeakNumBuffers, static_cast<Uint32>(m_Chunks.size()));
+}
+
+VulkanDynamicMemoryManager::MasterBlock VulkanDynamicMemoryManager::AllocateFromChunks(OffsetType SizeInBytes, OffsetType Alignment)
+{
+    std::lock_guard<std::mutex> Lock{m_ChunksMtx};
+
+    // Always try the primary buffer first so that overflow buffers stay empty when the load is low
+    for (auto& pChunk : m_Chunks)
+    {
+        auto Allocation = pChunk->AllocationsMgr.Allocate(SizeInBytes, Alignment);
+        if (Allocation.IsValid())
+        {
+            pChunk->LastUsedFrame = m_CurrentFrame;
+#ifdef DILIGENT_DEVELOPMENT
+            ++m_MasterBlockCounter;
+#endif
+            UpdatePeakStats();
+            return MasterBlock{Allocation.UnalignedOffset, Allocation.Size, pChunk.get()};
+        }
+    }
+
+    return MasterBlock{};
+}
+
+VulkanDynamicMemoryManager::MasterBlock VulkanDynamicMemoryManager::AllocateFromNewChunk(OffsetType SizeInBytes, OffsetType Alignment)
+{
+    std::lock_guard<std::mutex> Lock{m_ChunksMtx};
+
+    if ((m_Chunks.size() + 1) * m_ChunkSize > m_MaxSize)
+        return MasterBlock{};
+
+    std::unique_ptr<Chunk> pChunk;
+    try
+    {
+        pChunk = CreateChunk(m_ChunkSize, true, "Dynamic heap overflow buffer");
+    }
+    catch (...)
+    {
+        LOG_ERROR_MESSAGE("Failed to create dynamic heap overflow buffer");
+        return MasterBlock{};
+    }
+
+    auto Allocation = pChunk->AllocationsMgr.Allocate(SizeInBytes, Alignment);
+    VERIFY(Allocation.IsValid(), "Allocation from an empty chunk must never fail as the size has been checked by AllocateMasterBlock()");
+
+    MasterBlock Block{Allocation.UnalignedOffset, Allocation.Size, pChunk.get()};
+    m_Chunks.emplace_back(std::move(pChunk));
+    ++m_GrowCount;
+#ifdef DILIGENT_DEVELOPMENT
+    ++m_MasterBlockCounter;
+#endif
+    UpdatePeakStats();
+
+    LOG_INFO_MESSAGE("Dynamic heap is exhausted. Added overflow buffer #", m_Chunks.size() - 1,
+                     ". Total dynamic heap size: ", FormatMemorySize(m_Chunks.size() * m_ChunkSize, 2));
+
+    return Block;
+}
 
 VulkanDynamicMemoryManager::MasterBlock VulkanDynamicMemoryManager::AllocateMasterBlock(OffsetType SizeInBytes, OffsetType Alignment)
 {
     if (Alignment == 0)
         Alignment = MasterBlockAlignment;
 
-    if (SizeInBytes > GetSize())
+    if (SizeInBytes > m_ChunkSize)
     {
         LOG_ERROR("Requested dynamic allocation size ", SizeInBytes,
-                  " exceeds maximum dynamic memory size ", GetSize(),
+                  " exceeds maximum dynamic memory size ", m_ChunkSize,
                   ". The app should increase dynamic heap size.");
         return MasterBlock{};
     }
 
-    auto Block = TBase::AllocateMasterBlock(SizeInBytes, Alignment);
+    auto Block = AllocateFromChunks(SizeInBytes, Alignment);
+    if (!Block.IsValid())
+    {
+        // Release the blocks the GPU is already done with before growing the heap
+        m_DeviceVk.PurgeReleaseQueues();
+        Block = AllocateFromChunks(SizeInBytes, Alignment);
+    }
+
+    if (!Block.IsValid())
+    {
+        Block = AllocateFromNewChunk(SizeInBytes, Alignment);
+    }
+
     if (!Block.IsValid())
     {
-        // Allocation failed. Try to wait for GPU to finish pending frames to release some space
+        // Allocation failed and the heap has reached its maximum size. Try to wait for GPU to finish pending frames to release some space
         auto                          StartIdleTime   = std::chrono::high_resolution_clock::now();
         static constexpr const auto   SleepPeriod     = std::chrono::milliseconds(1);
         static constexpr const auto   MaxIdleDuration = std::chrono::duration<double>{60.0 / 1000.0}; // 60 ms
@@ -163,7 +316,7 @@ VulkanDynamicMemoryManager::MasterBlock VulkanDynamicMemoryManager::AllocateMast
         while (!Block.IsValid() && IdleDuration < MaxIdleDuration)
         {
             m_DeviceVk.PurgeReleaseQueues();
-            Block = TBase::AllocateMasterBlock(SizeInBytes, Alignment);
+            Block = AllocateFromChunks(SizeInBytes, Alignment);
             if (!Block.IsValid())
             {
                 std::this_thread::sleep_for(SleepPeriod);
@@ -178,55 +331,128 @@ VulkanDynamicMemoryManager::MasterBlock VulkanDynamicMemoryManager::AllocateMast
         {
             // Last resort - idle GPU (there seems to have been a driver bug at some point: vkQueueWaitIdle() would deadlock and never return)
             m_DeviceVk.IdleGPU();
-            Block = TBase::AllocateMasterBlock(SizeInBytes, Alignment);
+            Block = AllocateFromChunks(SizeInBytes, Alignment);
             if (!Block.IsValid())
             {
                 LOG_ERROR_MESSAGE("Space in dynamic heap is exhausted! After idling for ",
                                   std::fixed, std::setprecision(1), IdleDuration.count() * 1000.0,
-                                  " ms still no space is available. Increase the size of the heap by setting "
-                                  "EngineVkCreateInfo::DynamicHeapSize to a greater value or optimize dynamic resource usage");
+                                  " ms still no space is available. Increase the maximum size of the heap by setting "
+                                  "EngineVkCreateInfo::DynamicHeapMaxSize to a greater value or optimize dynamic resource usage");
             }
             else
             {
                 LOG_WARNING_MESSAGE("Space in dynamic heap is almost exhausted. Allocation forced idling the GPU. "
-                                    "Increase the size of the heap by setting EngineVkCreateInfo::DynamicHeapSize to a "
+                                    "Increase the maximum size of the heap by setting EngineVkCreateInfo::DynamicHeapMaxSize to a "
                                     "greater value or optimize dynamic resource usage");
             }
         }
         else
         {
-            if (SleepIterations == 0)
-            {
-                LOG_WARNING_MESSAGE("Space in dynamic heap is almost exhausted forcing mid-frame shrinkage. "
-                                    "Increase the size of the heap buffer by setting EngineVkCreateInfo::DynamicHeapSize to a "
-                                    "greater value or optimize dynamic resource usage");
-            }
-            else
+            LOG_WARNING_MESSAGE("Space in dynamic heap is almost exhausted. Allocation forced wait time of ",
+                                std::fixed, std::setprecision(1), IdleDuration.count() * 1000.0,
+                                " ms. Increase the maximum size of the heap by setting EngineVkCreateInfo::DynamicHeapMaxSize "
+                                "to a greater value or optimize dynamic resource usage");
+        }
+    }
+
+    return Block;
+}
+
+void VulkanDynamicMemoryManager::ReleaseMasterBlocks(std::vector<MasterBlock>& Blocks, RenderDeviceVkImpl& Device, Uint64 CmdQueueMask, Uint64 FrameNumber)
+{
+    struct StaleMasterBlock
+    {
+        MasterBlock                 Block;
+        VulkanDynamicMemoryManager* Mgr;
+
+        // clang-format off
+        StaleMasterBlock(const MasterBlock& _Block, VulkanDynamicMemoryManager* _Mgr)noexcept :
+            Block {_Block},
+            Mgr   {_Mgr  }
+        {
+        }
+
+        StaleMasterBlock            (const StaleMasterBlock&)  = delete;
+        StaleMasterBlock& operator= (const StaleMasterBlock&)  = delete;
+        StaleMasterBlock& operator= (      StaleMasterBlock&&) = delete;
+
+        StaleMasterBlock(StaleMasterBlock&& rhs)noexcept :
+            Block {rhs.Block},
+            Mgr   {rhs.Mgr  }
+        {
+            rhs.Block = MasterBlock{};
+            rhs.Mgr   = nullptr;
+        }
+        // clang-format on
+
+        ~StaleMasterBlock()
+        {
+            if (Mgr != nullptr)
             {
-                LOG_WARNING_MESSAGE("Space in dynamic heap is almost exhausted. Allocation forced wait time of ",
-                                    std::fixed, std::setprecision(1), IdleDuration.count() * 1000.0,
-                                    " ms. Increase the size of the heap by setting EngineVkCreateInfo::DynamicHeapSize "
-                                    "to a greater value or optimize dynamic resource usage");
+                std::lock_guard<std::mutex> Lock{Mgr->m_ChunksMtx};
+#ifdef DILIGENT_DEVELOPMENT
+                --Mgr->m_MasterBlockCounter;
+#endif
+                // Chunks are only released when they are empty, so the chunk must still be alive
+                Block.pChunk->AllocationsMgr.Free(Block.UnalignedOffset, Block.Size);
             }
         }
+    };
+
+    for (auto& Block : Blocks)
+    {
+        DEV_CHECK_ERR(Block.IsValid(), "Attempting to release invalid master block");
+        Device.SafeReleaseDeviceObject(StaleMasterBlock{Block, this}, CmdQueueMask);
     }
 
-    if (Block.IsValid())
+    std::vector<std::unique_ptr<Chunk>> IdleChunks;
     {
-        m_TotalPeakSize = std::max(m_TotalPeakSize, GetUsedSize());
+        std::lock_guard<std::mutex> Lock{m_ChunksMtx};
+        m_CurrentFrame = std::max(m_CurrentFrame, FrameNumber);
+        RemoveIdleChunks(IdleChunks);
     }
 
-    return Block;
+    for (auto& pChunk : IdleChunks)
+    {
+        LOG_INFO_MESSAGE("Releasing dynamic heap overflow buffer that has not been used for ", m_ShrinkDelay, " frames.");
+        ReleaseChunk(*pChunk);
+    }
+}
+
+void VulkanDynamicMemoryManager::RemoveIdleChunks(std::vector<std::unique_ptr<Chunk>>& IdleChunks)
+{
+    // Never release the primary buffer as its handle is referenced by descriptor sets
+    for (size_t i = m_Chunks.size(); i > 1; --i)
+    {
+        auto& pChunk = m_Chunks[i - 1];
+        if (!pChunk->AllocationsMgr.IsEmpty() || m_CurrentFrame < pChunk->LastUsedFrame + m_ShrinkDelay)
+            continue;
+
+        IdleChunks.emplace_back(std::move(pChunk));
+        m_Chunks.erase(m_Chunks.begin() + (i - 1));
+        ++m_ShrinkCount;
+    }
 }
 
 
+void VulkanDynamicHeap::AddMasterBlock(const MasterBlock& Block)
+{
+    VERIFY_EXPR(Block.IsValid());
+    m_CurrAllocatedSize += static_cast<Uint32>(Block.Size);
+    m_MasterBlocks.emplace_back(Block);
+
+    if (Block.pChunk->IsOverflow && !IsOverflowChunk(Block.pChunk))
+        m_OverflowChunks.push_back(Block.pChunk);
+}
+
 VulkanDynamicAllocation VulkanDynamicHeap::Allocate(Uint32 SizeInBytes, Uint32 Alignment)
 {
     VERIFY_EXPR(Alignment > 0);
     VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") must be power of 2");
 
-    auto       AlignedOffset = InvalidOffset;
-    OffsetType AlignedSize   = 0;
+    auto                            AlignedOffset = InvalidOffset;
+    OffsetType                      AlignedSize   = 0;
+    const VulkanDynamicMemoryChunk* pChunk        = nullptr;
     if (SizeInBytes > m_MasterBlockSize / 2)
     {
         // Allocate directly from the memory manager
@@ -235,9 +461,9 @@ VulkanDynamicAllocation VulkanDynamicHeap::Allocate(Uint32 SizeInBytes, Uint32 A
         {
             AlignedOffset = AlignUp(MasterBlock.UnalignedOffset, size_t{Alignment});
             AlignedSize   = MasterBlock.Size;
+            pChunk        = MasterBlock.pChunk;
             VERIFY_EXPR(MasterBlock.Size >= SizeInBytes + (AlignedOffset - MasterBlock.UnalignedOffset));
-            m_CurrAllocatedSize += static_cast<Uint32>(MasterBlock.Size);
-            m_MasterBlocks.emplace_back(MasterBlock);
+            AddMasterBlock(MasterBlock);
         }
     }
     else
@@ -247,10 +473,10 @@ VulkanDynamicAllocation VulkanDynamicHeap::Allocate(Uint32 SizeInBytes, Uint32 A
             auto MasterBlock = m_GlobalDynamicMemMgr.AllocateMasterBlock(m_MasterBlockSize, 0);
             if (MasterBlock.IsValid())
             {
-                m_CurrOffset = MasterBlock.UnalignedOffset;
-                m_CurrAllocatedSize += static_cast<Uint32>(MasterBlock.Size);
+                m_CurrOffset    = MasterBlock.UnalignedOffset;
+                m_pCurrChunk    = MasterBlock.pChunk;
                 m_AvailableSize = static_cast<Uint32>(MasterBlock.Size);
-                m_MasterBlocks.emplace_back(MasterBlock);
+                AddMasterBlock(MasterBlock);
             }
         }
 
@@ -262,6 +488,7 @@ VulkanDynamicAllocation VulkanDynamicHeap::Allocate(Uint32 SizeInBytes, Uint32 A
             {
                 m_AvailableSize -= static_cast<Uint32>(AlignedSize);
                 m_CurrOffset += static_cast<Uint32>(AlignedSize);
+                pChunk = m_pCurrChunk;
             }
             else
                 AlignedOffset = InvalidOffset;
@@ -277,19 +504,21 @@ VulkanDynamicAllocation VulkanDynamicHeap::Allocate(Uint32 SizeInBytes, Uint32 A
         m_PeakUsedSize      = std::max(m_PeakUsedSize, m_CurrUsedSize);
         m_PeakAllocatedSize = std::max(m_PeakAllocatedSize, m_CurrAllocatedSize);
 
-        VERIFY_EXPR((AlignedOffset & (Alignment - 1)) == 0);
-        return VulkanDynamicAllocation{m_GlobalDynamicMemMgr, AlignedOffset, SizeInBytes};
+        VERIFY_EXPR((AlignedOffset & (Alignment - 1)) == 0 && pChunk != nullptr);
+        return VulkanDynamicAllocation{m_GlobalDynamicMemMgr, AlignedOffset, SizeInBytes, *pChunk};
     }
     else
         return VulkanDynamicAllocation{};
 }
 
-void VulkanDynamicHeap::ReleaseMasterBlocks(RenderDeviceVkImpl& DeviceVkImpl, Uint64 CmdQueueMask)
+void VulkanDynamicHeap::ReleaseMasterBlocks(RenderDeviceVkImpl& DeviceVkImpl, Uint64 CmdQueueMask, Uint64 FrameNumber)
 {
-    m_GlobalDynamicMemMgr.ReleaseMasterBlocks(m_MasterBlocks, DeviceVkImpl, CmdQueueMask);
+    m_GlobalDynamicMemMgr.ReleaseMasterBlocks(m_MasterBlocks, DeviceVkImpl, CmdQueueMask, FrameNumber);
     m_MasterBlocks.clear();
+    m_OverflowChunks.clear();
 
     m_CurrOffset    = InvalidOffset;
+    m_pCurrChunk    = nullptr;
     m_AvailableSize = 0;
 
     m_CurrUsedSize      = 0;
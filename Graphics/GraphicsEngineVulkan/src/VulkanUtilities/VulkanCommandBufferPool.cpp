@@ -37,10 +37,12 @@ namespace VulkanUtilities
 
 VulkanCommandBufferPool::VulkanCommandBufferPool(std::shared_ptr<const VulkanLogicalDevice> LogicalDevice,
                                                  HardwareQueueIndex                         queueFamilyIndex,
-                                                 VkCommandPoolCreateFlags                   flags) :
+                                                 VkCommandPoolCreateFlags                   flags,
+                                                 VkCommandBufferLevel                       level) :
     m_LogicalDevice{std::move(LogicalDevice)},
     m_SupportedStagesMask{m_LogicalDevice->GetSupportedStagesMask(queueFamilyIndex)},
-    m_SupportedAccessMask{m_LogicalDevice->GetSupportedAccessMask(queueFamilyIndex)}
+    m_SupportedAccessMask{m_LogicalDevice->GetSupportedAccessMask(queueFamilyIndex)},
+    m_Level{level}
 {
     VkCommandPoolCreateInfo CmdPoolCI{};
     CmdPoolCI.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -64,8 +66,11 @@ VulkanCommandBufferPool::~VulkanCommandBufferPool()
     m_CmdPool.Release();
 }
 
-VkCommandBuffer VulkanCommandBufferPool::GetCommandBuffer(const char* DebugName)
+VkCommandBuffer VulkanCommandBufferPool::GetCommandBuffer(const char* DebugName, const VkCommandBufferInheritanceInfo* pInheritanceInfo)
 {
+    VERIFY(m_Level == VK_COMMAND_BUFFER_LEVEL_PRIMARY || pInheritanceInfo != nullptr,
+           "Inheritance info must be provided for secondary command buffers");
+
     VkCommandBuffer CmdBuffer = VK_NULL_HANDLE;
 
     {
@@ -93,7 +98,7 @@ VkCommandBuffer VulkanCommandBufferPool::GetCommandBuffer(const char* DebugName)
         BuffAllocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         BuffAllocInfo.pNext              = nullptr;
         BuffAllocInfo.commandPool        = m_CmdPool;
-        BuffAllocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        BuffAllocInfo.level              = m_Level;
         BuffAllocInfo.commandBufferCount = 1;
 
         CmdBuffer = m_LogicalDevice->AllocateVkCommandBuffer(BuffAllocInfo);
@@ -108,6 +113,14 @@ VkCommandBuffer VulkanCommandBufferPool::GetCommandBuffer(const char* DebugName)
                                                                           // submitted once, and the command buffer will be reset
                                                                           // and recorded again between each submission.
     CmdBuffBeginInfo.pInheritanceInfo = nullptr;                          // Ignored for a primary command buffer
+    if (m_Level == VK_COMMAND_BUFFER_LEVEL_SECONDARY)
+    {
+        CmdBuffBeginInfo.pInheritanceInfo = pInheritanceInfo;
+        // The secondary command buffer will be executed entirely inside the render pass
+        // it inherits from the primary command buffer.
+        if (pInheritanceInfo->renderPass != VK_NULL_HANDLE)
+            CmdBuffBeginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    }
 
     auto err = vkBeginCommandBuffer(CmdBuffer, &CmdBuffBeginInfo);
     DEV_CHECK_ERR(err == VK_SUCCESS, "Failed to begin command buffer");
@@ -47,7 +47,9 @@ VulkanMemoryPage::VulkanMemoryPage(VulkanMemoryManager&  ParentMemoryMgr,
                                    VkMemoryAllocateFlags AllocateFlags) :
     // clang-format off
     m_ParentMemoryMgr{ParentMemoryMgr},
-    m_AllocationMgr  {static_cast<AllocationsMgrOffsetType>(PageSize), ParentMemoryMgr.m_Allocator}
+    m_AllocationMgr  {static_cast<AllocationsMgrOffsetType>(PageSize), ParentMemoryMgr.m_Allocator},
+    m_MemoryTypeIndex{MemoryTypeIndex},
+    m_AllocateFlags  {AllocateFlags  }
 // clang-format on
 {
     VERIFY(PageSize <= std::numeric_limits<AllocationsMgrOffsetType>::max(),
@@ -116,6 +118,23 @@ VulkanMemoryAllocation VulkanMemoryPage::Allocate(VkDeviceSize size, VkDeviceSiz
     }
 }
 
+VulkanMemoryPageStats VulkanMemoryPage::GetStats() const
+{
+    VulkanMemoryPageStats Stats;
+    Stats.pPage           = this;
+    Stats.MemoryTypeIndex = m_MemoryTypeIndex;
+    Stats.AllocateFlags   = m_AllocateFlags;
+    Stats.IsHostVisible   = m_CPUMemory != nullptr;
+    Stats.IsEvacuating    = m_IsEvacuating.load();
+
+    std::lock_guard<std::mutex> Lock{m_Mutex};
+    Stats.Size          = m_AllocationMgr.GetMaxSize();
+    Stats.UsedSize      = m_AllocationMgr.GetUsedSize();
+    Stats.MaxFreeBlock  = m_AllocationMgr.GetMaxFreeBlockSize();
+    Stats.NumFreeBlocks = m_AllocationMgr.GetNumFreeBlocks();
+    return Stats;
+}
+
 void VulkanMemoryPage::Free(VulkanMemoryAllocation&& Allocation)
 {
     m_ParentMemoryMgr.OnFreeAllocation(Allocation.Size, m_CPUMemory != nullptr);
@@ -175,7 +194,16 @@ VulkanMemoryAllocation VulkanMemoryManager::Allocate(VkDeviceSize Size, VkDevice
     auto range = m_Pages.equal_range(PageIdx);
     for (auto page_it = range.first; page_it != range.second; ++page_it)
     {
-        Allocation = page_it->second.Allocate(Size, Alignment);
+        auto& Page = page_it->second;
+        if (Page.IsEvacuating())
+        {
+            // Do not put new allocations into pages that are being emptied by the defragmenter
+            if (!Page.IsEmpty())
+                continue;
+            Page.m_IsEvacuating.store(false);
+        }
+
+        Allocation = Page.Allocate(Size, Alignment);
         if (Allocation.Page != nullptr)
             break;
     }
@@ -187,8 +215,30 @@ VulkanMemoryAllocation VulkanMemoryManager::Allocate(VkDeviceSize Size, VkDevice
         while (PageSize < Size)
             PageSize *= 2;
 
+        const auto HeapIndex = GetHeapIndex(MemoryTypeIndex);
+        {
+            std::vector<VulkanMemoryHeapBudget> Budgets;
+            QueryHeapBudgets(Budgets);
+            if (Budgets[HeapIndex].Usage + PageSize > Budgets[HeapIndex].Budget)
+            {
+                // Empty pages kept as reserve are the cheapest memory to give back
+                // before oversubscribing the heap.
+                ReleaseEmptyPages(HeapIndex);
+                QueryHeapBudgets(Budgets);
+                if (Budgets[HeapIndex].Usage + PageSize > Budgets[HeapIndex].Budget)
+                {
+                    LOG_WARNING_MESSAGE("VulkanMemoryManager '", m_MgrName, "': allocating new ", Diligent::FormatMemorySize(PageSize, 2),
+                                        " page exceeds the budget of memory heap ", HeapIndex, " (usage: ",
+                                        Diligent::FormatMemorySize(Budgets[HeapIndex].Usage, 2), ", budget: ",
+                                        Diligent::FormatMemorySize(Budgets[HeapIndex].Budget, 2), ")");
+                }
+            }
+        }
+
         m_CurrAllocatedSize[stat_ind] += PageSize;
         m_PeakAllocatedSize[stat_ind] = std::max(m_PeakAllocatedSize[stat_ind], m_CurrAllocatedSize[stat_ind]);
+        m_HeapAllocatedSize[HeapIndex] += PageSize;
+        m_PageSetVersion.fetch_add(1);
 
         auto it = m_Pages.emplace(PageIdx, VulkanMemoryPage{*this, PageSize, MemoryTypeIndex, HostVisible, AllocateFlags});
         LOG_INFO_MESSAGE("VulkanMemoryManager '", m_MgrName, "': created new ", (HostVisible ? "host-visible" : "device-local"),
@@ -210,6 +260,142 @@ VulkanMemoryAllocation VulkanMemoryManager::Allocate(VkDeviceSize Size, VkDevice
     return Allocation;
 }
 
+VulkanMemoryAllocation VulkanMemoryManager::AllocateForRelocation(const VulkanMemoryPage& SrcPage, const VkMemoryRequirements& MemReqs)
+{
+    VulkanMemoryAllocation Allocation;
+
+    // The memory requirements of the new resource may differ from those of the
+    // resource being moved, so the memory type of the source page may not be allowed.
+    const auto MemoryTypeIndex = SrcPage.GetMemoryTypeIndex();
+    if ((MemReqs.memoryTypeBits & (1u << MemoryTypeIndex)) == 0)
+        return Allocation;
+
+    const bool      HostVisible = SrcPage.GetCPUMemory() != nullptr;
+    MemoryPageIndex PageIdx{MemoryTypeIndex, HostVisible, SrcPage.GetAllocateFlags()};
+
+    std::lock_guard<std::mutex> Lock{m_PagesMtx};
+
+    auto range = m_Pages.equal_range(PageIdx);
+    for (auto page_it = range.first; page_it != range.second; ++page_it)
+    {
+        auto& Page = page_it->second;
+        if (&Page == &SrcPage || Page.IsEvacuating())
+            continue;
+
+        Allocation = Page.Allocate(MemReqs.size, MemReqs.alignment);
+        if (Allocation.Page != nullptr)
+            break;
+    }
+
+    if (Allocation.Page != nullptr)
+    {
+        const size_t stat_ind = HostVisible ? 1 : 0;
+        m_CurrUsedSize[stat_ind].fetch_add(Allocation.Size);
+        m_PeakUsedSize[stat_ind] = std::max(m_PeakUsedSize[stat_ind], static_cast<VkDeviceSize>(m_CurrUsedSize[stat_ind].load()));
+    }
+
+    return Allocation;
+}
+
+void VulkanMemoryManager::SetPageEvacuating(const VulkanMemoryPage& Page, bool IsEvacuating)
+{
+    std::lock_guard<std::mutex> Lock{m_PagesMtx};
+    // The page may have been destroyed by ShrinkMemory() since its address was obtained,
+    // so only use it as a key.
+    for (auto& it : m_Pages)
+    {
+        if (&it.second == &Page)
+        {
+            it.second.m_IsEvacuating.store(IsEvacuating);
+            break;
+        }
+    }
+}
+
+void VulkanMemoryManager::GetPageStats(std::vector<VulkanMemoryPageStats>& Stats) const
+{
+    std::lock_guard<std::mutex> Lock{m_PagesMtx};
+    Stats.clear();
+    Stats.reserve(m_Pages.size());
+    for (const auto& it : m_Pages)
+        Stats.emplace_back(it.second.GetStats());
+}
+
+uint32_t VulkanMemoryManager::GetHeapIndex(uint32_t MemoryTypeIndex) const
+{
+    const auto& MemoryProps = m_PhysicalDevice.GetMemoryProperties();
+    VERIFY_EXPR(MemoryTypeIndex < MemoryProps.memoryTypeCount);
+    return MemoryProps.memoryTypes[MemoryTypeIndex].heapIndex;
+}
+
+void VulkanMemoryManager::QueryHeapBudgets(std::vector<VulkanMemoryHeapBudget>& Budgets) const
+{
+    const auto& MemoryProps = m_PhysicalDevice.GetMemoryProperties();
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT DriverBudget{};
+    const bool                                IsDriverReported =
+        m_LogicalDevice.GetEnabledExtFeatures().MemoryBudget && m_PhysicalDevice.GetMemoryBudget(DriverBudget);
+
+    Budgets.resize(MemoryProps.memoryHeapCount);
+    for (uint32_t HeapIdx = 0; HeapIdx < MemoryProps.memoryHeapCount; ++HeapIdx)
+    {
+        auto& Budget         = Budgets[HeapIdx];
+        Budget.Size          = MemoryProps.memoryHeaps[HeapIdx].size;
+        Budget.Flags         = MemoryProps.memoryHeaps[HeapIdx].flags;
+        Budget.AllocatedSize = m_HeapAllocatedSize[HeapIdx];
+        // Some drivers report zero budget for heaps that are not used by the process
+        Budget.IsDriverReported = IsDriverReported && DriverBudget.heapBudget[HeapIdx] != 0;
+        if (Budget.IsDriverReported)
+        {
+            Budget.Budget = DriverBudget.heapBudget[HeapIdx];
+            Budget.Usage  = DriverBudget.heapUsage[HeapIdx];
+        }
+        else
+        {
+            // Without the extension, assume that 80% of the heap is available to the process,
+            // which is what most drivers report on desktop platforms.
+            Budget.Budget = Budget.Size / 5 * 4;
+            Budget.Usage  = Budget.AllocatedSize;
+        }
+    }
+}
+
+void VulkanMemoryManager::GetHeapBudgets(std::vector<VulkanMemoryHeapBudget>& Budgets) const
+{
+    std::lock_guard<std::mutex> Lock{m_PagesMtx};
+    QueryHeapBudgets(Budgets);
+}
+
+VulkanMemoryManager::PagesMapType::iterator VulkanMemoryManager::DestroyPage(PagesMapType::iterator page_it)
+{
+    auto&      Page          = page_it->second;
+    const bool IsHostVisible = Page.GetCPUMemory() != nullptr;
+    const auto PageSize      = Page.GetPageSize();
+    VERIFY_EXPR(Page.IsEmpty());
+
+    m_CurrAllocatedSize[IsHostVisible ? 1 : 0] -= PageSize;
+    m_HeapAllocatedSize[GetHeapIndex(Page.GetMemoryTypeIndex())] -= PageSize;
+    m_PageSetVersion.fetch_add(1);
+    LOG_INFO_MESSAGE("VulkanMemoryManager '", m_MgrName, "': destroying ", (IsHostVisible ? "host-visible" : "device-local"),
+                     " page (", Diligent::FormatMemorySize(PageSize, 2),
+                     "). Current allocated size: ",
+                     Diligent::FormatMemorySize(m_CurrAllocatedSize[IsHostVisible ? 1 : 0], 2));
+    OnPageDestroy(Page);
+    return m_Pages.erase(page_it);
+}
+
+void VulkanMemoryManager::ReleaseEmptyPages(uint32_t HeapIndex)
+{
+    auto it = m_Pages.begin();
+    while (it != m_Pages.end())
+    {
+        if (it->second.IsEmpty() && GetHeapIndex(it->second.GetMemoryTypeIndex()) == HeapIndex)
+            it = DestroyPage(it);
+        else
+            ++it;
+    }
+}
+
 void VulkanMemoryManager::ShrinkMemory()
 {
     std::lock_guard<std::mutex> Lock{m_PagesMtx};
@@ -219,22 +405,13 @@ void VulkanMemoryManager::ShrinkMemory()
     auto it = m_Pages.begin();
     while (it != m_Pages.end())
     {
-        auto curr_it = it;
-        ++it;
-        auto& Page          = curr_it->second;
+        auto& Page          = it->second;
         bool  IsHostVisible = Page.GetCPUMemory() != nullptr;
         auto  ReserveSize   = IsHostVisible ? m_HostVisibleReserveSize : m_DeviceLocalReserveSize;
         if (Page.IsEmpty() && m_CurrAllocatedSize[IsHostVisible ? 1 : 0] > ReserveSize)
-        {
-            auto PageSize = Page.GetPageSize();
-            m_CurrAllocatedSize[IsHostVisible ? 1 : 0] -= PageSize;
-            LOG_INFO_MESSAGE("VulkanMemoryManager '", m_MgrName, "': destroying ", (IsHostVisible ? "host-visible" : "device-local"),
-                             " page (", Diligent::FormatMemorySize(PageSize, 2),
-                             "). Current allocated size: ",
-                             Diligent::FormatMemorySize(m_CurrAllocatedSize[IsHostVisible ? 1 : 0], 2));
-            OnPageDestroy(Page);
-            m_Pages.erase(curr_it);
-        }
+            it = DestroyPage(it);
+        else
+            ++it;
     }
 }
 
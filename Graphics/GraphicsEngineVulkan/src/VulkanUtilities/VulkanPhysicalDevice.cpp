@@ -310,6 +310,11 @@ VulkanPhysicalDevice::VulkanPhysicalDevice(const CreateInfo& CI) :
             m_ExtFeatures.DrawIndirectCount = true;
         }
 
+        if (IsExtensionSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+        {
+            m_ExtFeatures.MemoryBudget = true;
+        }
+
         if (IsExtensionSupported(VK_KHR_MAINTENANCE3_EXTENSION_NAME))
         {
             *NextProp = &m_ExtProperties.Maintenance3;
@@ -498,4 +503,25 @@ VkFormatProperties VulkanPhysicalDevice::GetPhysicalDeviceFormatProperties(VkFor
     return formatProperties;
 }
 
+bool VulkanPhysicalDevice::GetMemoryBudget(VkPhysicalDeviceMemoryBudgetPropertiesEXT& Budget) const
+{
+#if DILIGENT_USE_VOLK
+    if (!m_ExtFeatures.MemoryBudget || vkGetPhysicalDeviceMemoryProperties2KHR == nullptr)
+        return false;
+
+    Budget       = {};
+    Budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+    VkPhysicalDeviceMemoryProperties2 MemProps2{};
+    MemProps2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    MemProps2.pNext = &Budget;
+    vkGetPhysicalDeviceMemoryProperties2KHR(m_VkDevice, &MemProps2);
+    Budget.pNext = nullptr;
+    return true;
+#else
+    (void)Budget;
+    return false;
+#endif
+}
+
 } // namespace VulkanUtilities
@@ -0,0 +1,169 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include "VulkanUtilities/VulkanSubmitBatch.hpp"
+#include "DebugUtilities.hpp"
+
+namespace VulkanUtilities
+{
+
+namespace
+{
+
+const VkTimelineSemaphoreSubmitInfo* FindTimelineSemaphoreInfo(const VkSubmitInfo& SubmitInfo)
+{
+    for (const auto* pStruct = static_cast<const VkBaseInStructure*>(SubmitInfo.pNext); pStruct != nullptr; pStruct = pStruct->pNext)
+    {
+        if (pStruct->sType == VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO)
+            return reinterpret_cast<const VkTimelineSemaphoreSubmitInfo*>(pStruct);
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool VulkanSubmitBatch::IsSupported(const VkSubmitInfo& SubmitInfo)
+{
+    for (const auto* pStruct = static_cast<const VkBaseInStructure*>(SubmitInfo.pNext); pStruct != nullptr; pStruct = pStruct->pNext)
+    {
+        if (pStruct->sType != VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO)
+            return false;
+    }
+    return true;
+}
+
+void VulkanSubmitBatch::Add(const VkSubmitInfo& SubmitInfo)
+{
+    VERIFY(IsSupported(SubmitInfo), "Only VkTimelineSemaphoreSubmitInfo is supported in the pNext chain");
+
+    if (SubmitInfo.commandBufferCount == 0 && SubmitInfo.waitSemaphoreCount == 0 && SubmitInfo.signalSemaphoreCount == 0)
+        return;
+
+    const auto* pTimelineInfo = FindTimelineSemaphoreInfo(SubmitInfo);
+
+    Batch NewBatch;
+    NewBatch.HasTimelineValues = pTimelineInfo != nullptr;
+
+    NewBatch.FirstCmdBuffer = static_cast<uint32_t>(m_CmdBuffers.size());
+    NewBatch.NumCmdBuffers  = SubmitInfo.commandBufferCount;
+    m_CmdBuffers.insert(m_CmdBuffers.end(), SubmitInfo.pCommandBuffers, SubmitInfo.pCommandBuffers + SubmitInfo.commandBufferCount);
+
+    NewBatch.FirstWaitSemaphore = static_cast<uint32_t>(m_WaitSemaphores.size());
+    NewBatch.NumWaitSemaphores  = SubmitInfo.waitSemaphoreCount;
+    for (uint32_t i = 0; i < SubmitInfo.waitSemaphoreCount; ++i)
+    {
+        m_WaitSemaphores.push_back(SubmitInfo.pWaitSemaphores[i]);
+        m_WaitDstStageMasks.push_back(SubmitInfo.pWaitDstStageMask[i]);
+        m_WaitSemaphoreValues.push_back(pTimelineInfo != nullptr && i < pTimelineInfo->waitSemaphoreValueCount ? pTimelineInfo->pWaitSemaphoreValues[i] : 0);
+    }
+
+    NewBatch.FirstSignalSemaphore = static_cast<uint32_t>(m_SignalSemaphores.size());
+    NewBatch.NumSignalSemaphores  = SubmitInfo.signalSemaphoreCount;
+    for (uint32_t i = 0; i < SubmitInfo.signalSemaphoreCount; ++i)
+    {
+        m_SignalSemaphores.push_back(SubmitInfo.pSignalSemaphores[i]);
+        m_SignalSemaphoreValues.push_back(pTimelineInfo != nullptr && i < pTimelineInfo->signalSemaphoreValueCount ? pTimelineInfo->pSignalSemaphoreValues[i] : 0);
+    }
+
+    m_Batches.push_back(NewBatch);
+}
+
+void VulkanSubmitBatch::AppendSignalSemaphores(const VkSemaphore* pSemaphores, uint32_t Count)
+{
+    if (Count == 0)
+        return;
+
+    if (m_Batches.empty())
+    {
+        Batch NewBatch;
+        NewBatch.FirstCmdBuffer       = static_cast<uint32_t>(m_CmdBuffers.size());
+        NewBatch.FirstWaitSemaphore   = static_cast<uint32_t>(m_WaitSemaphores.size());
+        NewBatch.FirstSignalSemaphore = static_cast<uint32_t>(m_SignalSemaphores.size());
+        m_Batches.push_back(NewBatch);
+    }
+
+    // Signal semaphores of the last batch are at the end of the array
+    auto& LastBatch = m_Batches.back();
+    VERIFY_EXPR(LastBatch.FirstSignalSemaphore + LastBatch.NumSignalSemaphores == m_SignalSemaphores.size());
+    DEV_CHECK_ERR(!LastBatch.HasTimelineValues, "Can not append semaphores when timeline semaphores are used");
+    m_SignalSemaphores.insert(m_SignalSemaphores.end(), pSemaphores, pSemaphores + Count);
+    m_SignalSemaphoreValues.resize(m_SignalSemaphores.size(), 0);
+    LastBatch.NumSignalSemaphores += Count;
+}
+
+const VkSubmitInfo* VulkanSubmitBatch::GetSubmitInfos()
+{
+    // Both arrays are resized before taking any pointers to their elements
+    m_SubmitInfos.resize(m_Batches.size());
+    m_TimelineSemaphoreInfos.resize(m_Batches.size());
+
+    for (size_t i = 0; i < m_Batches.size(); ++i)
+    {
+        const auto& Src = m_Batches[i];
+
+        auto& SubmitInfo = m_SubmitInfos[i];
+
+        SubmitInfo                      = {};
+        SubmitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        SubmitInfo.commandBufferCount   = Src.NumCmdBuffers;
+        SubmitInfo.pCommandBuffers      = Src.NumCmdBuffers != 0 ? &m_CmdBuffers[Src.FirstCmdBuffer] : nullptr;
+        SubmitInfo.waitSemaphoreCount   = Src.NumWaitSemaphores;
+        SubmitInfo.pWaitSemaphores      = Src.NumWaitSemaphores != 0 ? &m_WaitSemaphores[Src.FirstWaitSemaphore] : nullptr;
+        SubmitInfo.pWaitDstStageMask    = Src.NumWaitSemaphores != 0 ? &m_WaitDstStageMasks[Src.FirstWaitSemaphore] : nullptr;
+        SubmitInfo.signalSemaphoreCount = Src.NumSignalSemaphores;
+        SubmitInfo.pSignalSemaphores    = Src.NumSignalSemaphores != 0 ? &m_SignalSemaphores[Src.FirstSignalSemaphore] : nullptr;
+
+        if (Src.HasTimelineValues)
+        {
+            auto& TimelineInfo = m_TimelineSemaphoreInfos[i];
+
+            TimelineInfo                           = {};
+            TimelineInfo.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            TimelineInfo.waitSemaphoreValueCount   = Src.NumWaitSemaphores;
+            TimelineInfo.pWaitSemaphoreValues      = Src.NumWaitSemaphores != 0 ? &m_WaitSemaphoreValues[Src.FirstWaitSemaphore] : nullptr;
+            TimelineInfo.signalSemaphoreValueCount = Src.NumSignalSemaphores;
+            TimelineInfo.pSignalSemaphoreValues    = Src.NumSignalSemaphores != 0 ? &m_SignalSemaphoreValues[Src.FirstSignalSemaphore] : nullptr;
+
+            SubmitInfo.pNext = &TimelineInfo;
+        }
+    }
+
+    return m_SubmitInfos.data();
+}
+
+void VulkanSubmitBatch::Clear()
+{
+    m_Batches.clear();
+    m_CmdBuffers.clear();
+    m_WaitSemaphores.clear();
+    m_WaitDstStageMasks.clear();
+    m_WaitSemaphoreValues.clear();
+    m_SignalSemaphores.clear();
+    m_SignalSemaphoreValues.clear();
+}
+
+} // namespace VulkanUtilities
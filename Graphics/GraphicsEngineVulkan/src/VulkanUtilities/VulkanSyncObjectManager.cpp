@@ -32,40 +32,29 @@ namespace VulkanUtilities
 VulkanSyncObjectManager::VulkanSyncObjectManager(VulkanLogicalDevice& LogicalDevice) :
     m_LogicalDevice{LogicalDevice}
 {
-    m_SemaphorePool.reserve(64);
-    m_FencePool.reserve(32);
 }
 
 VulkanSyncObjectManager::~VulkanSyncObjectManager()
 {
+    VkSemaphore vkSem = VK_NULL_HANDLE;
+    while (m_SemaphorePool.Dequeue(vkSem))
     {
-        std::lock_guard<std::mutex> Lock{m_SemaphorePoolGuard};
-
-        for (auto vkSem : m_SemaphorePool)
-        {
-            vkDestroySemaphore(m_LogicalDevice.GetVkDevice(), vkSem, nullptr);
-        }
+        vkDestroySemaphore(m_LogicalDevice.GetVkDevice(), vkSem, nullptr);
     }
-    {
-        std::lock_guard<std::mutex> Lock{m_FencePoolGuard};
 
-        for (auto vkFence : m_FencePool)
-        {
-            vkDestroyFence(m_LogicalDevice.GetVkDevice(), vkFence, nullptr);
-        }
+    VkFence vkFence = VK_NULL_HANDLE;
+    while (m_FencePool.Dequeue(vkFence))
+    {
+        vkDestroyFence(m_LogicalDevice.GetVkDevice(), vkFence, nullptr);
     }
 }
 
 void VulkanSyncObjectManager::CreateSemaphores(VulkanRecycledSemaphore* pSemaphores, uint32_t Count)
 {
     uint32_t SemIdx = 0;
+    for (VkSemaphore vkSem = VK_NULL_HANDLE; SemIdx < Count && m_SemaphorePool.Dequeue(vkSem); ++SemIdx)
     {
-        std::lock_guard<std::mutex> Lock{m_SemaphorePoolGuard};
-        for (; SemIdx < Count && !m_SemaphorePool.empty(); ++SemIdx)
-        {
-            pSemaphores[SemIdx] = VulkanRecycledSemaphore{shared_from_this(), m_SemaphorePool.back()};
-            m_SemaphorePool.pop_back();
-        }
+        pSemaphores[SemIdx] = VulkanRecycledSemaphore{shared_from_this(), vkSem};
     }
 
     // Create new semaphores.
@@ -82,19 +71,11 @@ void VulkanSyncObjectManager::CreateSemaphores(VulkanRecycledSemaphore* pSemapho
 
 VulkanRecycledFence VulkanSyncObjectManager::CreateFence()
 {
-    {
-        std::lock_guard<std::mutex> Lock{m_FencePoolGuard};
-
-        if (!m_FencePool.empty())
-        {
-            auto vkFence = m_FencePool.back();
-            m_FencePool.pop_back();
-            return {shared_from_this(), vkFence};
-        }
-    }
+    VkFence vkFence = VK_NULL_HANDLE;
+    if (m_FencePool.Dequeue(vkFence))
+        return {shared_from_this(), vkFence};
 
     VkFenceCreateInfo FenceCI = {};
-    VkFence           vkFence = VK_NULL_HANDLE;
 
     FenceCI.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     vkCreateFence(m_LogicalDevice.GetVkDevice(), &FenceCI, nullptr, &vkFence);
@@ -111,8 +92,11 @@ void VulkanSyncObjectManager::Recycle(VkSemaphoreType vkSem, bool IsUnsignaled)
         return;
     }
 
-    std::lock_guard<std::mutex> Lock{m_SemaphorePoolGuard};
-    m_SemaphorePool.push_back(vkSem.Value);
+    if (!m_SemaphorePool.Enqueue(vkSem.Value))
+    {
+        // The pool is full
+        vkDestroySemaphore(m_LogicalDevice.GetVkDevice(), vkSem.Value, nullptr);
+    }
 }
 
 void VulkanSyncObjectManager::Recycle(VkFenceType vkFence, bool IsUnsignaled)
@@ -123,8 +107,11 @@ void VulkanSyncObjectManager::Recycle(VkFenceType vkFence, bool IsUnsignaled)
         vkResetFences(m_LogicalDevice.GetVkDevice(), 1, &vkFence.Value);
     }
 
-    std::lock_guard<std::mutex> Lock{m_FencePoolGuard};
-    m_FencePool.push_back(vkFence.Value);
+    if (!m_FencePool.Enqueue(vkFence.Value))
+    {
+        // The pool is full
+        vkDestroyFence(m_LogicalDevice.GetVkDevice(), vkFence.Value, nullptr);
+    }
 }
 
 } // namespace VulkanUtilities
@@ -68,6 +68,20 @@ struct ITextureAtlasSuballocation : public IObject
     /// Returns the pointer to the parent texture atlas.
     virtual IDynamicTextureAtlas* GetAtlas() = 0;
 
+    /// Returns the suballocation version.
+
+    /// The version is incremented every time the suballocation is moved to a new
+    /// location by IDynamicTextureAtlas::Defragment(). An application may compare
+    /// the version with the value it cached to detect that the origin, the slice
+    /// and the texture coordinate scale and bias need to be updated.
+    ///
+    /// \note  The default implementation returns zero, which is correct for suballocations
+    ///        that are never moved.
+    virtual Uint32 GetVersion() const
+    {
+        return 0;
+    }
+
     /// Stores a pointer to the user-provided data object, which
     /// may later be retrieved through GetUserData().
     ///
@@ -108,6 +122,73 @@ struct DynamicTextureAtlasUsageStats
     /// Used area is always equal to or larger than the
     /// allocated area due to alignment requirements.
     Uint64 UsedArea = 0;
+
+    /// The number of slices that contain at least one allocation.
+    Uint32 CommittedSliceCount = 0;
+
+    /// The total number of free regions in all committed slices.
+    Uint32 FreeRegionCount = 0;
+
+    /// The total free area in all committed slices, in texels.
+    Uint64 CommittedFreeArea = 0;
+
+    /// The area of the largest free region in any committed slice, in texels.
+    Uint64 LargestFreeRegionArea = 0;
+
+    /// Free space fragmentation of the committed slices, in [0, 1] range.
+
+    /// Fragmentation is computed as one minus the ratio between the sum
+    /// of the largest free region areas of all committed slices and
+    /// CommittedFreeArea. Zero means that the free space in every slice
+    /// is a single contiguous region.
+    float Fragmentation = 0;
+
+    /// The number of suballocations that are scheduled to be moved by
+    /// IDynamicTextureAtlas::Defragment().
+    Uint32 PendingRelocationCount = 0;
+
+    /// The total number of suballocations moved by IDynamicTextureAtlas::Defragment().
+    Uint64 RelocationCount = 0;
+};
+
+
+/// Callback that is called by IDynamicTextureAtlas::Defragment() when a suballocation is moved.
+
+/// \param[in] pSuballocation - Suballocation that was moved. The suballocation already
+///                             reports its new origin, slice and version.
+/// \param[in] OldSlice       - The slice the suballocation was located in before the move.
+/// \param[in] OldOrigin      - The origin of the suballocation before the move.
+/// \param[in] pUserData      - User data pointer from DynamicTextureAtlasDefragmentAttribs.
+typedef void(DILIGENT_CALL_TYPE* TextureAtlasRelocationCallbackType)(ITextureAtlasSuballocation* pSuballocation,
+                                                                     Uint32                      OldSlice,
+                                                                     const uint2&                OldOrigin,
+                                                                     void*                       pUserData);
+
+/// Dynamic texture atlas defragmentation attributes.
+struct DynamicTextureAtlasDefragmentAttribs
+{
+    /// Maximum slice occupancy, in [0, 1] range.
+
+    /// Slices whose used area is less than or equal to this fraction of the
+    /// slice area are considered sparse and are candidates for evacuation.
+    float MaxSliceOccupancy = 0.25f;
+
+    /// Maximum number of suballocations to move in one call to Defragment().
+    /// Zero means no limit.
+    Uint32 MaxRelocations = 16;
+
+    /// Maximum number of texels (at mip level 0) to copy in one call to Defragment().
+    /// Zero means no limit.
+    ///
+    /// \note  At least one suballocation is moved in every call, even if its
+    ///        size exceeds the budget.
+    Uint64 MaxTexelsToCopy = 0;
+
+    /// An optional callback that is called for every moved suballocation.
+    TextureAtlasRelocationCallbackType RelocationCallback = nullptr;
+
+    /// User data pointer that is passed to RelocationCallback.
+    void* pRelocationCallbackUserData = nullptr;
 };
 
 
@@ -156,7 +237,73 @@ struct IDynamicTextureAtlas : public IObject
 
     /// Returns the usage stats, see Diligent::DynamicTextureAtlasUsageStats.
     virtual void GetUsageStats(DynamicTextureAtlasUsageStats& Stats) const = 0;
+
+
+    /// Performs an incremental defragmentation step.
+
+    /// \param[in]  pDevice  - Pointer to the render device, see GetTexture().
+    /// \param[in]  pContext - Pointer to the device context that will be used to
+    ///                        copy suballocation contents to their new locations.
+    /// \param[in]  Attribs  - Defragmentation attributes, see Diligent::DynamicTextureAtlasDefragmentAttribs.
+    ///
+    /// \return     The number of suballocations moved by this call. Zero indicates that
+    ///             there is nothing to defragment or that no more suballocations can be moved.
+    ///
+    /// \remarks    When there are no pending relocations, the method finds sparse slices
+    ///             (see DynamicTextureAtlasDefragmentAttribs::MaxSliceOccupancy) whose
+    ///             contents fit into the free space of the other slices, and schedules
+    ///             all their suballocations to be moved. Every call then moves at most
+    ///             the number of suballocations allowed by the budget, so that the work
+    ///             can be spread over several frames. Once all suballocations are moved
+    ///             out of a slice, the slice is released and may be reused.
+    ///
+    ///             Only slices that already contain allocations are used as destinations,
+    ///             so defragmentation never grows the texture array.
+    ///
+    ///             Suballocation contents are moved with IDeviceContext::CopyTexture() using
+    ///             pContext. The old location may be reused by another allocation right
+    ///             away, so an application must update the new allocations through the same
+    ///             context or otherwise make sure the copy is executed first.
+    ///
+    ///             Moved suballocations increment their version (see ITextureAtlasSuballocation::GetVersion())
+    ///             and are reported through DynamicTextureAtlasDefragmentAttribs::RelocationCallback.
+    ///
+    ///             The method is not thread safe. An application must externally synchronize
+    ///             it with GetTexture() and with any access to the origin, the slice and the
+    ///             texture coordinates of the suballocations. Allocate() and releasing
+    ///             suballocations may run in parallel with this method.
+    ///
+    ///             Texture 2D atlases have a single slice and are never defragmented.
+    ///             Atlases that were created without DynamicTextureAtlasCreateInfo::EnableDefragmentation
+    ///             are not defragmented either.
+    virtual Uint32 Defragment(IRenderDevice*                              pDevice,
+                              IDeviceContext*                             pContext,
+                              const DynamicTextureAtlasDefragmentAttribs& Attribs) = 0;
+};
+
+
+// clang-format off
+
+/// Dynamic texture atlas packing mode.
+DILIGENT_TYPED_ENUM(DYNAMIC_TEXTURE_ATLAS_PACKING_MODE, Uint8)
+{
+    /// Recursive node splitting (see Diligent::DynamicAtlasManager).
+    /// Works well for regions of arbitrary sizes and keeps free space
+    /// compact when regions are frequently released.
+    DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_NODE_SPLIT = 0,
+
+    /// Skyline bottom-left packing (see Diligent::SkylineAtlasManager).
+    /// Provides the best packing efficiency for many small regions of similar
+    /// height, such as glyphs.
+    DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_SKYLINE,
+
+    /// Shelf next-fit packing (see Diligent::ShelfAtlasManager).
+    /// The fastest mode that works well when regions have similar heights.
+    DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_SHELF,
+
+    DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_COUNT
 };
+// clang-format on
 
 
 /// Dynamic texture atlas create information.
@@ -223,6 +370,30 @@ struct DynamicTextureAtlasCreateInfo
 
     /// Silence allocation errors.
     bool Silent = false;
+
+    /// Enable scalable multithreaded allocation.
+
+    /// By default, every allocation searches slices in the order of their indices, and
+    /// waits for the slices that are being accessed by other threads. This results in
+    /// the most compact packing, but serializes threads that allocate at the same time.
+    ///
+    /// When scalable allocation is enabled, every thread starts the search from its
+    /// preferred slice (the slice it last allocated from), and skips slices that are
+    /// locked by other threads. Only when no slice can be locked without waiting, the
+    /// atlas falls back to the default search. This reduces contention when many threads
+    /// allocate at the same time (e.g. glyphs and UI images), at the cost of potentially
+    /// less compact packing.
+    bool ScalableAllocation = false;
+
+    /// Enable defragmentation, see IDynamicTextureAtlas::Defragment().
+    ///
+    /// To be able to move suballocations, the atlas keeps track of all live suballocation
+    /// objects, which adds a small overhead to every allocation and release.
+    /// When defragmentation is disabled, Defragment() does nothing.
+    bool EnableDefragmentation = false;
+
+    /// Region packing mode, see Diligent::DYNAMIC_TEXTURE_ATLAS_PACKING_MODE.
+    DYNAMIC_TEXTURE_ATLAS_PACKING_MODE PackingMode = DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_NODE_SPLIT;
 };
 
 /// Creates a new dynamic texture atlas.
@@ -137,10 +137,89 @@ struct ComputeMipLevelAttribs
 #endif
 };
 typedef struct ComputeMipLevelAttribs ComputeMipLevelAttribs;
+
+
+/// ComputeMipChain function attributes
+struct ComputeMipChainAttribs
+{
+    /// Texture format.
+    TEXTURE_FORMAT Format         DEFAULT_INITIALIZER(TEX_FORMAT_UNKNOWN);
+
+    /// Width of the most detailed mip level.
+    Uint32 Width                  DEFAULT_INITIALIZER(0);
+
+    /// Height of the most detailed mip level.
+    Uint32 Height                 DEFAULT_INITIALIZER(0);
+
+    /// The number of mip levels in the chain, including the most detailed level.
+    Uint32 MipLevels              DEFAULT_INITIALIZER(0);
+
+    /// An array of MipLevels pointers to the mip level data.
+    ///
+    /// \remarks   The first element points to the most detailed level that is used as
+    ///             the source. All other levels are computed by the function.
+    void* const* ppMipData        DEFAULT_INITIALIZER(nullptr);
+
+    /// An array of MipLevels mip level strides, in bytes.
+    const size_t* pMipStrides     DEFAULT_INITIALIZER(nullptr);
+
+    /// Filter type, see ComputeMipLevelAttribs::FilterType.
+    MIP_FILTER_TYPE FilterType    DEFAULT_INITIALIZER(MIP_FILTER_TYPE_DEFAULT);
+
+    /// Alpha cutoff value, see ComputeMipLevelAttribs::AlphaCutoff.
+    float AlphaCutoff             DEFAULT_INITIALIZER(0);
+
+#if DILIGENT_CPP_INTERFACE
+    constexpr ComputeMipChainAttribs() noexcept {}
+
+    constexpr ComputeMipChainAttribs(TEXTURE_FORMAT   _Format,
+                                     Uint32           _Width,
+                                     Uint32           _Height,
+                                     Uint32           _MipLevels,
+                                     void* const*     _ppMipData,
+                                     const size_t*    _pMipStrides,
+                                     MIP_FILTER_TYPE _FilterType  = ComputeMipChainAttribs{}.FilterType,
+                                     float            _AlphaCutoff = ComputeMipChainAttribs{}.AlphaCutoff) noexcept :
+        Format      {_Format},
+        Width       {_Width},
+        Height      {_Height},
+        MipLevels   {_MipLevels},
+        ppMipData   {_ppMipData},
+        pMipStrides {_pMipStrides},
+        FilterType  {_FilterType},
+        AlphaCutoff {_AlphaCutoff}
+    {}
+#endif
+};
+typedef struct ComputeMipChainAttribs ComputeMipChainAttribs;
 // clang-format on
 
 void DILIGENT_GLOBAL_FUNCTION(ComputeMipLevel)(const ComputeMipLevelAttribs REF Attribs);
 
+/// Computes all coarse levels of the mip chain.
+
+/// \param [in] Attribs - Mip chain attributes, see Diligent::ComputeMipChainAttribs.
+///
+/// \remarks   The results are identical to calling ComputeMipLevel for every level
+///             in turn, but the levels are computed in horizontal bands so that
+///             the data produced for one level is consumed by the next level
+///             while it is still in the cache.
+void DILIGENT_GLOBAL_FUNCTION(ComputeMipChain)(const ComputeMipChainAttribs REF Attribs);
+
+#if DILIGENT_CPP_INTERFACE
+class IThreadPool;
+
+/// Computes all coarse levels of the mip chain using the thread pool to process
+/// horizontal bands in parallel.
+
+/// \param [in] Attribs     - Mip chain attributes, see Diligent::ComputeMipChainAttribs.
+/// \param [in] pThreadPool - Thread pool to use. If null, the chain is computed on the calling thread.
+///
+/// \remarks   The function waits until all tasks are complete and must not be called
+///             from a worker thread of the same pool.
+void ComputeMipChain(const ComputeMipChainAttribs& Attribs, IThreadPool* pThreadPool);
+#endif
+
 /// For a Direct3D12 render device, returns the maximum supported shader version. For any other device type, returns 0.
 
 /// \param [in]  pDevice - a pointer to the render device object.
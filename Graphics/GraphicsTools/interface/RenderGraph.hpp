@@ -0,0 +1,327 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::RenderGraph class
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <memory>
+
+#include "../../GraphicsEngine/interface/RenderDevice.h"
+#include "../../GraphicsEngine/interface/DeviceContext.h"
+#include "../../GraphicsEngine/interface/Texture.h"
+#include "../../GraphicsEngine/interface/Buffer.h"
+#include "../../GraphicsEngine/interface/Fence.h"
+#include "../../../Common/interface/RefCntAutoPtr.hpp"
+#include "TransientResourceAllocator.hpp"
+
+namespace Diligent
+{
+
+/// Render graph create information.
+struct RenderGraphCreateInfo
+{
+    /// Render graph name that is used to name the internal objects.
+    const char* Name = nullptr;
+};
+
+/// Render graph statistics, see Diligent::RenderGraph::GetStats().
+struct RenderGraphStats
+{
+    /// The total number of declared passes.
+    Uint32 NumPasses = 0;
+
+    /// The number of passes that were culled because they do not contribute to any output.
+    Uint32 NumCulledPasses = 0;
+
+    /// The number of state transitions recorded by the graph, not including the first-use
+    /// transitions that are resolved at execution time against the current resource state.
+    Uint32 NumBarriers = 0;
+
+    /// The number of barriers that were split into begin and end parts.
+    Uint32 NumSplitBarriers = 0;
+
+    /// The number of buffer read states that were merged into a preceding barrier
+    /// instead of requiring a new one.
+    Uint32 NumMergedBarriers = 0;
+
+    /// The number of accesses that did not require a barrier because the resource was
+    /// already in the required state.
+    Uint32 NumSkippedBarriers = 0;
+
+    /// The number of cross-context fence waits.
+    Uint32 NumCrossContextWaits = 0;
+};
+
+/// Render graph.
+
+/// The render graph defers resource state management until all passes of a frame are known.
+/// An application declares the resources and the passes, and for every pass, the resources the pass
+/// reads and writes together with the required states. Compile() then
+/// - culls the passes that do not contribute to any output resource,
+/// - computes the minimal set of state transitions between the passes: transitions to states
+///   the resource is already in are skipped, buffer read states are merged into a single transition,
+///   and transitions between passes that are separated by other work on the same context are split
+///   into begin and end parts,
+/// - computes the fence synchronization between the passes that run in different immediate
+///   contexts (command queues) and access the same resources.
+///
+/// Execute() issues all transitions of a pass with a single IDeviceContext::TransitionResourceStates()
+/// call and then invokes the pass callback. Since all resources are in the required states, the callback
+/// must record its commands with RESOURCE_STATE_TRANSITION_MODE_NONE (or RESOURCE_STATE_TRANSITION_MODE_VERIFY).
+///
+/// The passes are executed in the order they were declared, so a pass may only read the data written
+/// by the passes declared before it. A pass that does not fully overwrite a resource it writes to
+/// (e.g. blends into a render target) must also declare a read of the resource.
+///
+/// Transient textures declared with CreateTexture() are created by Diligent::TransientResourceAllocator
+/// and share memory if their lifetimes in the compiled schedule do not overlap.
+class RenderGraph
+{
+public:
+    using PassCallbackType = std::function<void(IDeviceContext* pContext)>;
+
+    explicit RenderGraph(const RenderGraphCreateInfo& CreateInfo);
+    ~RenderGraph();
+
+    // clang-format off
+    RenderGraph           (const RenderGraph&)  = delete;
+    RenderGraph& operator=(const RenderGraph&)  = delete;
+    RenderGraph           (      RenderGraph&&) = delete;
+    RenderGraph& operator=(      RenderGraph&&) = delete;
+    // clang-format on
+
+    /// Adds an existing texture to the graph and returns its resource handle.
+
+    /// \remarks    The texture state must be known (see ITexture::GetState()) when the graph is executed.
+    Uint32 ImportTexture(ITexture* pTexture);
+
+    /// Adds an existing buffer to the graph and returns its resource handle.
+
+    /// \remarks    The buffer state must be known (see IBuffer::GetState()) when the graph is executed.
+    Uint32 ImportBuffer(IBuffer* pBuffer);
+
+    /// Declares a transient texture that is created by the graph and returns its resource handle.
+
+    /// \remarks    The contents of a transient texture are undefined at the beginning of the first pass
+    ///             that uses it, and all passes that use transient textures must run in the same context.
+    Uint32 CreateTexture(const TextureDesc& Desc);
+
+    /// Marks the resource as an output of the graph.
+
+    /// \param[in] Resource   - Resource handle.
+    /// \param[in] FinalState - The state the resource is transitioned to at the end of Execute(),
+    ///                         or RESOURCE_STATE_UNKNOWN to leave it in the state of the last access.
+    ///
+    /// \remarks    The passes that write to the resource, and all passes they depend on, are never culled.
+    void MarkOutput(Uint32 Resource, RESOURCE_STATE FinalState = RESOURCE_STATE_UNKNOWN);
+
+    /// Adds a pass to the graph and returns its handle.
+
+    /// \param[in] Name         - Pass name.
+    /// \param[in] ContextIndex - The index of the context in the ppContexts array given to
+    ///                           Compile() and Execute() that executes the pass.
+    /// \param[in] Callback     - The function that records the pass commands.
+    /// \param[in] NeverCull    - Whether the pass has side effects that are not expressed
+    ///                           by its writes (e.g. it reads data back to the CPU) and must not be culled.
+    Uint32 AddPass(const char* Name, Uint32 ContextIndex, PassCallbackType Callback, bool NeverCull = false);
+
+    /// Declares that the pass reads the resource in the given state.
+
+    /// \remarks    Texture states must consist of a single state flag.
+    ///             Buffers may be read in a combination of read-only states.
+    void Read(Uint32 Pass, Uint32 Resource, RESOURCE_STATE State);
+
+    /// Declares that the pass writes to the resource in the given state.
+
+    /// \remarks    The state must be a writable state, e.g. RESOURCE_STATE_RENDER_TARGET,
+    ///             RESOURCE_STATE_DEPTH_WRITE, RESOURCE_STATE_UNORDERED_ACCESS or RESOURCE_STATE_COPY_DEST.
+    void Write(Uint32 Pass, Uint32 Resource, RESOURCE_STATE State);
+
+    /// Culls unused passes, computes the state transitions and cross-context synchronization,
+    /// and creates the transient textures.
+
+    /// \param[in] pDevice     - Render device.
+    /// \param[in] ppContexts  - An array of NumContexts immediate contexts, indexed by the
+    ///                          pass context indices. Transient textures are bound to memory in the
+    ///                          context that uses them, which must support sparse binding operations
+    ///                          if the device supports sparse resources.
+    /// \param[in] NumContexts - The number of contexts.
+    ///
+    /// \remarks    All resources and passes must be declared before the graph is compiled.
+    ///             The compiled graph may be executed any number of times.
+    void Compile(IRenderDevice* pDevice, IDeviceContext* const* ppContexts, Uint32 NumContexts);
+
+    /// Executes the compiled graph.
+
+    /// \param[in] ppContexts  - The same contexts that were given to Compile().
+    /// \param[in] NumContexts - The number of contexts.
+    ///
+    /// \remarks    When passes run in different contexts, the contexts are flushed after
+    ///             the passes whose results are used by other contexts.
+    ///             Consecutive executions are synchronized as well: if the last access to a resource
+    ///             in one execution and the first access in the next execution are performed by
+    ///             different contexts, the latter waits for the fence signaled by the former at the
+    ///             end of the previous execution.
+    void Execute(IDeviceContext* const* ppContexts, Uint32 NumContexts);
+
+    /// Returns the texture with the given resource handle.
+
+    /// \remarks    For transient textures, the graph must be compiled, and null is returned
+    ///             if the texture is only used by culled passes.
+    ITexture* GetTexture(Uint32 Resource) const;
+
+    /// Returns the buffer with the given resource handle.
+    IBuffer* GetBuffer(Uint32 Resource) const;
+
+    /// Returns true if the pass was culled. The graph must be compiled.
+    bool IsPassCulled(Uint32 Pass) const;
+
+    /// Returns the graph statistics. The graph must be compiled.
+    const RenderGraphStats& GetStats() const { return m_Stats; }
+
+    /// Releases all resources and removes all declarations.
+    void Reset();
+
+private:
+    struct ResourceInfo
+    {
+        RefCntAutoPtr<ITexture> pTexture;
+        RefCntAutoPtr<IBuffer>  pBuffer;
+
+        bool        IsTexture   = false;
+        bool        IsTransient = false;
+        TextureDesc TransientDesc;
+        std::string TransientName;
+        // Handle of the transient texture in the transient resource allocator
+        Uint32      TransientHandle = ~0u;
+
+        bool           IsOutput   = false;
+        RESOURCE_STATE FinalState = RESOURCE_STATE_UNKNOWN;
+
+        // The context of the last access in the compiled graph
+        Uint32 LastContext = 0;
+
+        // The context of the first access in the compiled graph and whether it is a write
+        Uint32 FirstContext       = ~0u;
+        bool   FirstAccessIsWrite = false;
+
+        // The contexts that access the resource after its last write in the compiled graph,
+        // including the writer, and the context of the last write.
+        Uint64 TrailingContextMask = 0;
+        Uint32 LastWriteContext    = ~0u;
+
+        // For every context, the fence value signaled after the last access to the resource
+        // in the previous execution, or zero if there is no such access. The first pass that uses
+        // the resource in the next execution waits for these values.
+        std::vector<Uint64> PrevExecFenceValues;
+    };
+
+    struct ResourceAccess
+    {
+        Uint32         Resource = 0;
+        RESOURCE_STATE State    = RESOURCE_STATE_UNKNOWN;
+        bool           IsRead   = false;
+        bool           IsWrite  = false;
+    };
+
+    struct Barrier
+    {
+        Uint32                Resource       = 0;
+        RESOURCE_STATE        OldState       = RESOURCE_STATE_UNKNOWN;
+        RESOURCE_STATE        NewState       = RESOURCE_STATE_UNKNOWN;
+        STATE_TRANSITION_TYPE TransitionType = STATE_TRANSITION_TYPE_IMMEDIATE;
+    };
+
+    struct PassInfo
+    {
+        std::string      Name;
+        Uint32           ContextIndex = 0;
+        PassCallbackType Callback;
+        bool             NeverCull = false;
+
+        std::vector<ResourceAccess> Accesses;
+
+        bool IsCulled = false;
+
+        // Transitions of the resources that are first used by this pass. They are resolved
+        // against the current resource states at execution time, OldState is not used.
+        std::vector<Barrier> FirstUseBarriers;
+        // Transitions issued before the pass
+        std::vector<Barrier> PreBarriers;
+        // Transitions issued after the pass: begin parts of split barriers and transitions
+        // that must be performed in this context before another context uses the resource
+        std::vector<Barrier> PostBarriers;
+
+        // Passes in other contexts that must complete before this pass starts
+        std::vector<Uint32> WaitPasses;
+
+        // Whether the context must signal its fence after the pass
+        bool   SignalFence = false;
+        Uint64 FenceValue  = 0;
+    };
+
+    void AddAccess(Uint32 Pass, Uint32 Resource, RESOURCE_STATE State, bool IsWrite);
+    void CullPasses();
+    void ComputeBarriers(const std::vector<COMMAND_QUEUE_TYPE>& QueueTypes);
+    void CreateTransientTextures(IRenderDevice* pDevice, IDeviceContext* const* ppContexts);
+    void AppendTransition(std::vector<StateTransitionDesc>& Transitions, const Barrier& B) const;
+    bool NeedFirstUseTransition(const Barrier& B) const;
+    void AppendFirstUseTransition(std::vector<StateTransitionDesc>& Transitions, const Barrier& B) const;
+    void WaitForFence(IDeviceContext* pContext, Uint32 Ctx, Uint32 SignalCtx, Uint64 Value);
+
+    const std::string m_Name;
+
+    // The allocator is declared first so that the transient textures are released before their memory
+    std::unique_ptr<TransientResourceAllocator> m_pTransientAllocator;
+    Uint32                                      m_TransientContext = ~0u;
+
+    std::vector<ResourceInfo> m_Resources;
+    std::vector<PassInfo>     m_Passes;
+
+    // Indices of the passes that were not culled, in execution order
+    std::vector<Uint32> m_Schedule;
+
+    std::vector<RefCntAutoPtr<IFence>> m_Fences;
+    std::vector<Uint64>                m_FenceValues;
+    // The last fence value of every context that every other context waited for, NumContexts x NumContexts
+    std::vector<Uint64> m_WaitedFenceValues;
+
+    // Passes in other contexts that must complete before the final transitions in every context
+    std::vector<std::vector<Uint32>> m_FinalWaitPasses;
+    // Whether the context must signal its fence at the end of Execute() because other
+    // contexts use the resources it accessed last at the beginning of the next execution
+    std::vector<bool> m_SignalAfterExecution;
+
+    RenderGraphStats m_Stats;
+    bool             m_IsCompiled = false;
+};
+
+} // namespace Diligent
@@ -0,0 +1,197 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::ShaderVariantManager class
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../GraphicsEngine/interface/RenderDevice.h"
+#include "../../GraphicsEngine/interface/Shader.h"
+#include "../../../Common/interface/RefCntAutoPtr.hpp"
+#include "../../../Common/interface/ThreadPool.hpp"
+#include "BytecodeCache.h"
+#include "RenderStateCache.h"
+#include "XXH128Hasher.hpp"
+
+namespace Diligent
+{
+
+/// Shader variant manager create information.
+struct ShaderVariantManagerCreateInfo
+{
+    /// Render device that will be used to create shaders.
+
+    /// \remarks    The device may be null, in which case variants can only
+    ///             be added and deduplicated, but not compiled.
+    IRenderDevice* pDevice = nullptr;
+
+    /// An optional bytecode cache.
+
+    /// \remarks    Before compiling a unique variant, the manager looks up its bytecode
+    ///             in the cache. Bytecode of the newly compiled variants is added to the cache.
+    ///             The cache is only used by the backends that support shader bytecode
+    ///             (Direct3D11, Direct3D12, Vulkan) and is ignored if pStateCache is not null.
+    IBytecodeCache* pBytecodeCache = nullptr;
+
+    /// An optional render state cache.
+
+    /// \remarks    If not null, all shaders are created through the render state cache.
+    IRenderStateCache* pStateCache = nullptr;
+
+    /// An optional thread pool that will be used to compile unique variants in parallel.
+    /// If null, all variants are compiled in the calling thread.
+    IThreadPool* pThreadPool = nullptr;
+};
+
+
+/// Shader variant manager statistics.
+struct ShaderVariantManagerStats
+{
+    /// The total number of variants added to the manager.
+    Uint32 NumVariants = 0;
+
+    /// The number of unique variants after deduplication.
+    Uint32 NumUniqueVariants = 0;
+
+    /// The number of variants that were compiled from source.
+    Uint32 NumCompiledVariants = 0;
+
+    /// The number of variants that were created from the bytecode cache.
+    Uint32 NumBytecodeCacheHits = 0;
+
+    /// The number of variants that failed to compile.
+    Uint32 NumFailedVariants = 0;
+};
+
+
+/// Manages shader permutations and collapses equivalent ones.
+
+/// Every variant added to the manager is preprocessed once: shader includes are unrolled,
+/// comments and white spaces are normalized, and macros that are never referenced by the
+/// source (directly or through other used macros) are removed. The normalized token stream,
+/// remaining macros and compilation attributes are then hashed, and variants with equal
+/// hashes share a single shader object. Only unique variants ever reach the compiler.
+///
+/// \note   If the source uses the token-pasting operator (##), macro names may be generated
+///         by the preprocessor, and unused macro pruning is disabled for this source.
+///
+/// \warning    The class is not thread-safe: AddVariant() and CompileVariants() must not be
+///             called simultaneously from different threads.
+class ShaderVariantManager
+{
+public:
+    explicit ShaderVariantManager(const ShaderVariantManagerCreateInfo& CreateInfo);
+    ~ShaderVariantManager();
+
+    // clang-format off
+    ShaderVariantManager           (const ShaderVariantManager&)  = delete;
+    ShaderVariantManager& operator=(const ShaderVariantManager&)  = delete;
+    ShaderVariantManager           (      ShaderVariantManager&&) = delete;
+    ShaderVariantManager& operator=(      ShaderVariantManager&&) = delete;
+    // clang-format on
+
+    /// Adds a shader variant.
+
+    /// \param[in] ShaderCI - Shader create info of the variant. The manager makes a copy
+    ///                       of all data referenced by the create info.
+    ///
+    /// \return     Index of the variant that should be used with GetShader().
+    ///
+    /// \remarks    The method preprocesses the source and may throw an exception if the
+    ///             source or one of its includes can't be loaded or parsed.
+    Uint32 AddVariant(const ShaderCreateInfo& ShaderCI) noexcept(false);
+
+    /// Compiles all unique variants that have not been compiled yet.
+
+    /// \remarks    If the thread pool was provided at initialization, the variants
+    ///             are compiled in parallel. The method blocks until all variants are ready.
+    void CompileVariants();
+
+    /// Returns the shader for the given variant, or null if the variant has not been
+    /// compiled yet or its compilation failed.
+    IShader* GetShader(Uint32 VariantIndex) const;
+
+    /// Returns the index of the unique variant that the given variant was collapsed into.
+    Uint32 GetUniqueVariantIndex(Uint32 VariantIndex) const;
+
+    /// Returns the total number of variants.
+    Uint32 GetVariantCount() const
+    {
+        return static_cast<Uint32>(m_Variants.size());
+    }
+
+    /// Returns the number of unique variants.
+    Uint32 GetUniqueVariantCount() const
+    {
+        return static_cast<Uint32>(m_UniqueVariants.size());
+    }
+
+    /// Returns the manager statistics, see Diligent::ShaderVariantManagerStats.
+    ShaderVariantManagerStats GetStats() const;
+
+    /// Releases all variants and shaders.
+    void Clear();
+
+private:
+    struct PreprocessedSource;
+    struct UniqueVariant;
+
+    const PreprocessedSource& PreprocessSource(const ShaderCreateInfo& ShaderCI) noexcept(false);
+
+    void CompileVariant(UniqueVariant& Variant);
+
+private:
+    RefCntAutoPtr<IRenderDevice>     m_pDevice;
+    RefCntAutoPtr<IBytecodeCache>    m_pBytecodeCache;
+    RefCntAutoPtr<IRenderStateCache> m_pStateCache;
+    RefCntAutoPtr<IThreadPool>       m_pThreadPool;
+
+    // Bytecode cache is not thread-safe
+    std::mutex m_BytecodeCacheMtx;
+
+    // Preprocessed sources, keyed by the source stream factory and the source identity (file path or source hash)
+    std::unordered_map<std::string, std::unique_ptr<PreprocessedSource>> m_Sources;
+
+    std::vector<std::unique_ptr<UniqueVariant>> m_UniqueVariants;
+    std::unordered_map<XXH128Hash, Uint32>      m_HashToUniqueVariant;
+
+    // Index of the unique variant for every added variant
+    std::vector<Uint32> m_Variants;
+
+    std::atomic<Uint32> m_NumCompiledVariants{0};
+    std::atomic<Uint32> m_NumBytecodeCacheHits{0};
+    std::atomic<Uint32> m_NumFailedVariants{0};
+};
+
+} // namespace Diligent
@@ -0,0 +1,186 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::TextureUploadPipeline class
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+#include "TextureUploader.hpp"
+#include "../../../Primitives/interface/DataBlob.h"
+#include "../../../Common/interface/RefCntAutoPtr.hpp"
+#include "../../../Common/interface/ThreadPool.hpp"
+
+namespace Diligent
+{
+
+/// Texture payload decoder.
+
+/// \param [in] pPayload      - Encoded texture payload.
+/// \param [in] pUploadBuffer - Upload buffer to write decoded texels to. The decoder
+///                             must write all subresources using the pointers and strides
+///                             returned by IUploadBuffer::GetMappedData().
+///
+/// \return     true if the payload was decoded successfully, and false otherwise.
+///
+/// \remarks    The decoder is called by the thread pool threads and must be thread-safe.
+using TextureDecoderType = std::function<bool(IDataBlob* pPayload, IUploadBuffer* pUploadBuffer)>;
+
+
+/// Texture upload request.
+struct TextureUploadRequest
+{
+    /// Upload buffer description.
+    UploadBufferDesc BufferDesc;
+
+    /// Destination texture.
+    ITexture* pDstTexture = nullptr;
+
+    /// Destination array slice of the first slice in the upload buffer.
+    Uint32 DstSlice = 0;
+
+    /// Destination mip level of the first mip level in the upload buffer.
+    Uint32 DstMip = 0;
+
+    /// Encoded payload, e.g. compressed texels read from a file.
+    /// The pipeline keeps a strong reference to the payload until it is decoded.
+    IDataBlob* pPayload = nullptr;
+
+    /// Payload decoder. If null, the payload must contain raw texels of all
+    /// subresources in the upload buffer, see CopyRawTexelsToUploadBuffer().
+    TextureDecoderType Decoder;
+};
+
+
+/// Texture upload pipeline create information.
+struct TextureUploadPipelineCreateInfo
+{
+    /// Texture uploader that allocates upload buffers and schedules GPU copies.
+    ITextureUploader* pUploader = nullptr;
+
+    /// Thread pool that decodes the payloads.
+    IThreadPool* pThreadPool = nullptr;
+
+    /// The maximum number of uploads that can be in flight at the same time.
+
+    /// An upload is in flight from the moment it is enqueued until its GPU copy
+    /// has been scheduled. This limits the amount of staging memory and the number
+    /// of thread pool threads that may be blocked waiting for the render thread.
+    Uint32 MaxUploadsInFlight = 8;
+};
+
+
+/// Texture upload pipeline statistics.
+struct TextureUploadPipelineStats
+{
+    /// The number of uploads that are currently in flight.
+    Uint32 NumUploadsInFlight = 0;
+
+    /// The total number of uploads whose GPU copies have been scheduled.
+    Uint32 NumUploadsCompleted = 0;
+
+    /// The number of uploads that failed because the payload could not
+    /// be decoded or the upload buffer could not be allocated.
+    Uint32 NumFailedUploads = 0;
+
+    /// The number of times EnqueueUpload() had to wait for a free slot.
+    Uint32 NumBackPressureWaits = 0;
+};
+
+
+/// Overlaps payload decoding with GPU copies.
+
+/// Every enqueued upload is processed by a thread pool thread that allocates an upload buffer,
+/// decodes the payload directly into the mapped staging memory and schedules the GPU copy.
+/// Since the uploader is used from worker threads, the render thread must keep calling
+/// ITextureUploader::RenderThreadUpdate() while uploads are in flight.
+///
+/// The number of uploads in flight is limited by TextureUploadPipelineCreateInfo::MaxUploadsInFlight,
+/// which provides back-pressure to the producer (e.g. a streaming loader that reads files).
+class TextureUploadPipeline
+{
+public:
+    explicit TextureUploadPipeline(const TextureUploadPipelineCreateInfo& CreateInfo) noexcept(false);
+
+    /// Waits until all uploads in flight are complete.
+    ~TextureUploadPipeline();
+
+    // clang-format off
+    TextureUploadPipeline           (const TextureUploadPipeline&)  = delete;
+    TextureUploadPipeline& operator=(const TextureUploadPipeline&)  = delete;
+    TextureUploadPipeline           (      TextureUploadPipeline&&) = delete;
+    TextureUploadPipeline& operator=(      TextureUploadPipeline&&) = delete;
+    // clang-format on
+
+    /// Enqueues a texture upload.
+
+    /// \param [in] Request     - Upload request, see Diligent::TextureUploadRequest.
+    /// \param [in] WaitForSlot - Whether to wait for a free slot when the number of uploads
+    ///                           in flight has reached the limit.
+    ///
+    /// \return     true if the upload was enqueued, and false if there were no free slots
+    ///             and WaitForSlot is false.
+    ///
+    /// \warning    Never wait for a slot in the render thread: the slots are only released
+    ///             after the render thread has scheduled the copies.
+    bool EnqueueUpload(const TextureUploadRequest& Request, bool WaitForSlot = true);
+
+    /// Returns the pipeline statistics, see Diligent::TextureUploadPipelineStats.
+    TextureUploadPipelineStats GetStats() const;
+
+private:
+    void ProcessUpload(const TextureUploadRequest& Request, ITexture* pDstTexture, IDataBlob* pPayload);
+
+    RefCntAutoPtr<ITextureUploader> m_pUploader;
+    RefCntAutoPtr<IThreadPool>      m_pThreadPool;
+    const Uint32                    m_MaxUploadsInFlight;
+
+    mutable std::mutex      m_SlotsMtx;
+    std::condition_variable m_SlotReleasedCV;
+    Uint32                  m_NumUploadsInFlight = 0;
+
+    std::atomic<Uint32> m_NumUploadsCompleted{0};
+    std::atomic<Uint32> m_NumFailedUploads{0};
+    std::atomic<Uint32> m_NumBackPressureWaits{0};
+};
+
+
+/// Copies raw texels from the payload to the upload buffer.
+
+/// The payload must contain all subresources of the upload buffer ordered by array
+/// slice and then by mip level. Rows of every subresource must be tightly packed.
+/// For compressed formats, a row is a row of compressed blocks.
+///
+/// \return     true if the payload is large enough, and false otherwise.
+bool CopyRawTexelsToUploadBuffer(IDataBlob* pPayload, IUploadBuffer* pUploadBuffer);
+
+} // namespace Diligent
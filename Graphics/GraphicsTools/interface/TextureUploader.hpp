@@ -45,6 +45,11 @@ struct UploadBufferDesc
     Uint32         ArraySize   = 1;
     TEXTURE_FORMAT Format      = TEX_FORMAT_UNKNOWN;
 
+    /// Copy priority. When the uploader uses a staging ring with a frame budget,
+    /// pending copies with higher priority are executed first.
+    /// Priority is not taken into account when comparing descriptions.
+    Int32          Priority    = 0;
+
     bool operator == (const UploadBufferDesc &rhs) const
     {
         return Width  == rhs.Width  &&
@@ -66,13 +71,48 @@ public:
 /// Texture uploader description.
 struct TextureUploaderDesc
 {
+    /// Size of the staging ring buffer, in bytes.
+
+    /// When zero (default), the uploader creates a dedicated staging texture
+    /// for every upload buffer and caches these textures by description.
+    /// When non-zero, upload buffers are suballocated from a single persistently
+    /// mapped staging buffer and copied to textures using buffer-to-texture copies.
+    /// The staging ring is only supported in Direct3D12 and Vulkan backends.
+    Uint64 StagingRingSize = 0;
+
+    /// Maximum number of bytes copied to textures by one RenderThreadUpdate() call.
+
+    /// Copies that do not fit into the budget remain in the queue until the next update.
+    /// A copy that is larger than the budget is executed alone. Zero means no limit.
+    /// The budget is only used by the staging ring.
+    Uint64 FrameBudget = 0;
 };
 
 
 /// Texture uploader statistics.
 struct TextureUploaderStats
 {
+    /// The number of operations waiting in the queue.
     Uint32 NumPendingOperations = 0;
+
+    /// Staging memory, in bytes, that is used by upload buffers that
+    /// have not been released yet.
+    Uint64 BytesInFlight = 0;
+
+    /// The number of bytes copied by the last RenderThreadUpdate() call.
+    Uint64 BytesCopiedLastUpdate = 0;
+
+    /// The number of times an upload buffer allocation had to wait
+    /// for space in the staging ring.
+    Uint32 NumStalls = 0;
+
+    /// Average time, in seconds, between the copy being scheduled and
+    /// recorded into the device context.
+    double AvgQueueLatency = 0;
+
+    /// Maximum time, in seconds, between the copy being scheduled and
+    /// recorded into the device context.
+    double MaxQueueLatency = 0;
 };
 
 /// Asynchronous texture uploader
@@ -0,0 +1,224 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of TransientMemoryPlanner and TransientResourceAllocator classes
+
+#include <vector>
+#include <string>
+
+#include "../../GraphicsEngine/interface/RenderDevice.h"
+#include "../../GraphicsEngine/interface/DeviceContext.h"
+#include "../../GraphicsEngine/interface/Texture.h"
+#include "../../GraphicsEngine/interface/DeviceMemory.h"
+#include "../../../Common/interface/RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+/// Memory requirements and lifetime of a transient resource, see Diligent::TransientMemoryPlanner.
+struct TransientResourceLifetime
+{
+    /// The size of the memory required by the resource, in bytes.
+    Uint64 Size = 0;
+
+    /// Required memory alignment. Must be a power of two.
+    Uint64 Alignment = 1;
+
+    /// The index of the first pass that uses the resource.
+    Uint32 FirstUse = 0;
+
+    /// The index of the last pass that uses the resource (inclusive).
+    Uint32 LastUse = 0;
+};
+
+/// Computes the memory aliasing plan for a set of transient resources.
+
+/// Resources whose lifetimes do not overlap may share the same memory.
+/// The planner processes the resources in the order of decreasing size and
+/// places every resource at the lowest offset that does not intersect the memory
+/// of any already placed resource whose lifetime overlaps (first-fit interval packing).
+class TransientMemoryPlanner
+{
+public:
+    /// Computes the plan for the given resources.
+
+    /// \param[in] pResources   - An array of NumResources resource lifetimes.
+    /// \param[in] NumResources - The number of resources.
+    void Plan(const TransientResourceLifetime* pResources, Uint32 NumResources);
+
+    /// Returns the memory offset of the resource with the given index.
+    Uint64 GetOffset(Uint32 ResIndex) const;
+
+    /// Returns the indices of the resources that share memory with the given resource.
+
+    /// \remarks As the resources are reused every frame, an aliasing barrier must be issued
+    ///          between each of these resources and the given resource before its first use,
+    ///          including resources whose lifetimes start later in the frame: they have used the
+    ///          memory in the previous frame.
+    const std::vector<Uint32>& GetAliasedResources(Uint32 ResIndex) const;
+
+    /// Returns the total memory size required by the plan.
+    Uint64 GetMemorySize() const { return m_MemorySize; }
+
+    /// Returns the total size of all resources, which is the memory size required without aliasing.
+    Uint64 GetUnaliasedMemorySize() const { return m_UnaliasedMemorySize; }
+
+    /// Returns the maximum total size of the resources that are alive at the same time.
+    /// This is the lower bound of the memory size required by any aliasing plan.
+    Uint64 GetPeakWorkingSetSize() const { return m_PeakWorkingSetSize; }
+
+private:
+    std::vector<Uint64>              m_Offsets;
+    std::vector<std::vector<Uint32>> m_AliasedResources;
+
+    Uint64 m_MemorySize          = 0;
+    Uint64 m_UnaliasedMemorySize = 0;
+    Uint64 m_PeakWorkingSetSize  = 0;
+};
+
+
+/// Transient resource allocator create information.
+struct TransientResourceAllocatorCreateInfo
+{
+    /// Allocator name that is used to name the device memory objects.
+    const char* Name = nullptr;
+
+    /// Immediate context mask of the transient resources and their memory,
+    /// see Diligent::DeviceObjectAttribs and Diligent::DeviceMemoryDesc::ImmediateContextMask.
+    Uint64 ImmediateContextMask = 1;
+};
+
+/// Allocates per-frame intermediate textures whose lifetimes do not overlap in aliased memory.
+
+/// An application declares the textures and the range of passes that use each of them with
+/// AddTexture(), and then calls Commit(). The allocator creates sparse textures with
+/// MISC_TEXTURE_FLAG_SPARSE_ALIASING flag, computes the aliasing plan with Diligent::TransientMemoryPlanner,
+/// and binds all textures to a single memory object, so that the peak memory usage tracks the working set
+/// rather than the sum of all texture sizes.
+///
+/// Before recording each pass, the application must call BeginPass() that issues the aliasing barriers
+/// for the textures whose lifetime starts in this pass. The contents of such textures are undefined,
+/// and they must be fully overwritten (e.g. cleared) before they are read.
+///
+/// Textures that can't be created as aliased sparse textures on the device (e.g. because
+/// sparse aliasing or the texture format are not supported) are created as regular USAGE_DEFAULT
+/// textures with dedicated memory.
+class TransientResourceAllocator
+{
+public:
+    explicit TransientResourceAllocator(const TransientResourceAllocatorCreateInfo& CreateInfo);
+
+    // clang-format off
+    TransientResourceAllocator           (const TransientResourceAllocator&)  = delete;
+    TransientResourceAllocator& operator=(const TransientResourceAllocator&)  = delete;
+    TransientResourceAllocator           (      TransientResourceAllocator&&) = delete;
+    TransientResourceAllocator& operator=(      TransientResourceAllocator&&) = delete;
+    // clang-format on
+
+    /// Declares a transient texture.
+
+    /// \param[in] Desc     - Texture description. Desc.Usage is ignored.
+    /// \param[in] FirstUse - The index of the first pass that uses the texture.
+    /// \param[in] LastUse  - The index of the last pass that uses the texture (inclusive).
+    ///
+    /// \return     The texture handle that can be passed to GetTexture().
+    ///
+    /// \remarks    All textures must be declared before Commit() is called.
+    Uint32 AddTexture(const TextureDesc& Desc, Uint32 FirstUse, Uint32 LastUse);
+
+    /// Creates the textures and memory objects and binds the memory according to the aliasing plan.
+
+    /// \param[in] pDevice  - Render device that will be used to create the textures and memory.
+    /// \param[in] pContext - Device context that will be used to bind sparse memory.
+    ///                       The context must support sparse binding operations.
+    void Commit(IRenderDevice* pDevice, IDeviceContext* pContext);
+
+    /// Issues aliasing barriers for the textures whose lifetime starts in the given pass,
+    /// and sets their state to RESOURCE_STATE_UNDEFINED.
+    void BeginPass(IDeviceContext* pContext, Uint32 PassIndex);
+
+    /// Returns the texture with the given handle.
+    /// Commit() must have been called.
+    ITexture* GetTexture(Uint32 Handle) const;
+
+    /// Returns true if the texture with the given handle uses aliased memory.
+    bool IsAliased(Uint32 Handle) const;
+
+    /// Returns the total size of the memory objects used by the aliased textures, in bytes.
+    Uint64 GetMemorySize() const;
+
+    /// Returns the total size of the aliased textures, which is the memory size
+    /// that would be required without aliasing, in bytes.
+    Uint64 GetUnaliasedMemorySize() const;
+
+    /// Releases all textures and memory objects and removes all texture declarations.
+    void Reset();
+
+private:
+    struct TextureInfo
+    {
+        TextureDesc Desc;
+        std::string Name;
+        Uint32      FirstUse = 0;
+        Uint32      LastUse  = 0;
+
+        RefCntAutoPtr<ITexture> pTexture;
+
+        // Index of the memory heap the texture is bound to, or ~0u if the texture is not aliased
+        Uint32 HeapIndex  = ~0u;
+        Uint64 MemorySize = 0;
+
+        // Textures that share memory with this texture
+        std::vector<Uint32> AliasedTextures;
+    };
+
+    // Textures in one heap share a single memory object and are planned together.
+    struct MemoryHeap
+    {
+        std::vector<Uint32>          Textures;
+        RefCntAutoPtr<IDeviceMemory> pMemory;
+        Uint64                       MemorySize          = 0;
+        Uint64                       UnaliasedMemorySize = 0;
+    };
+
+    bool CreateSparseTexture(IRenderDevice* pDevice, TextureInfo& TexInfo);
+    void BindHeapMemory(IDeviceContext* pContext, const MemoryHeap& Heap, const TransientMemoryPlanner& Plan);
+
+    const std::string m_Name;
+    const Uint64      m_ImmediateContextMask;
+
+    // Heaps are declared first so that the textures are destroyed before the memory they are bound to
+    std::vector<MemoryHeap>  m_Heaps;
+    std::vector<TextureInfo> m_Textures;
+
+    RENDER_DEVICE_TYPE m_DeviceType  = RENDER_DEVICE_TYPE_UNDEFINED;
+    bool               m_IsCommitted = false;
+};
+
+} // namespace Diligent
@@ -90,7 +90,8 @@ public:
             return false;
         }
 
-        Serializer<SerializerMode::Read> Stream{SerializedData{pDataBlob->GetDataPtr(), pDataBlob->GetSize()}};
+        // Use the const pointer so that the data blob may reference read-only memory (e.g. MappedDataBlob).
+        Serializer<SerializerMode::Read> Stream{SerializedData{const_cast<void*>(pDataBlob->GetConstDataPtr()), pDataBlob->GetSize()}};
 
         BytecodeCacheHeader Header;
         Header.Serialize(Stream);
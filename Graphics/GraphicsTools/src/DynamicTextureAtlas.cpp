@@ -28,13 +28,18 @@
 #include "DynamicTextureAtlas.h"
 
 #include <mutex>
+#include <thread>
 #include <algorithm>
 #include <atomic>
 #include <unordered_map>
-#include <map>
+#include <array>
 #include <set>
+#include <deque>
+#include <vector>
 
 #include "DynamicAtlasManager.hpp"
+#include "SkylineAtlasManager.hpp"
+#include "ShelfAtlasManager.hpp"
 #include "DynamicTextureArray.hpp"
 #include "ObjectBase.hpp"
 #include "RefCntAutoPtr.hpp"
@@ -42,6 +47,7 @@
 #include "DefaultRawMemoryAllocator.hpp"
 #include "GraphicsAccessories.hpp"
 #include "Align.hpp"
+#include "PlatformMisc.hpp"
 
 namespace Diligent
 {
@@ -110,6 +116,11 @@ public:
 
     virtual IDynamicTextureAtlas* GetAtlas() override final;
 
+    virtual Uint32 GetVersion() const override final
+    {
+        return m_Version.load();
+    }
+
     virtual void SetUserData(IObject* pUserData) override final
     {
         m_pUserData = pUserData;
@@ -120,15 +131,39 @@ public:
         return m_pUserData.RawPtr<IObject>();
     }
 
+    const DynamicAtlasManager::Region& GetSubregion() const
+    {
+        return m_Subregion;
+    }
+
+    Uint32 GetAlignment() const
+    {
+        return m_Alignment;
+    }
+
+    // Moves the suballocation to the new location. Slice and Subregion
+    // receive the previous location that must be released by the caller.
+    void Relocate(Uint32& Slice, DynamicAtlasManager::Region& Subregion)
+    {
+        VERIFY_EXPR(!Subregion.IsEmpty());
+        VERIFY_EXPR(Subregion.width == m_Subregion.width && Subregion.height == m_Subregion.height);
+        std::swap(m_Slice, Slice);
+        std::swap(m_Subregion, Subregion);
+        m_Version.fetch_add(1);
+    }
+
 private:
     RefCntAutoPtr<DynamicTextureAtlasImpl> m_pParentAtlas;
 
+    // Subregion and slice are only modified by DynamicTextureAtlasImpl::Defragment()
     DynamicAtlasManager::Region m_Subregion;
+    Uint32                      m_Slice;
 
-    const Uint32 m_Slice;
     const Uint32 m_Alignment;
     const uint2  m_Size;
 
+    std::atomic<Uint32> m_Version{0};
+
     RefCntAutoPtr<IObject> m_pUserData;
 };
 
@@ -138,8 +173,8 @@ namespace
 class ThreadSafeAtlasManager
 {
 public:
-    ThreadSafeAtlasManager(const uint2& Dim) noexcept :
-        Mgr{Dim.x, Dim.y}
+    ThreadSafeAtlasManager(const uint2& Dim, DYNAMIC_TEXTURE_ATLAS_PACKING_MODE PackingMode) :
+        Mgr{CreateAllocator(Dim, PackingMode)}
     {}
 
     // clang-format off
@@ -167,6 +202,7 @@ public:
 
         ManagerGuard& operator=(ManagerGuard&& Other) noexcept
         {
+            Release();
             pAtlasMgr       = Other.pAtlasMgr;
             Other.pAtlasMgr = nullptr;
             return *this;
@@ -198,57 +234,139 @@ public:
             VERIFY_EXPR(pAtlasMgr != nullptr);
             VERIFY_EXPR(pAtlasMgr->UseCount > 0);
             std::lock_guard<std::mutex> Guard{pAtlasMgr->Mtx};
-            return pAtlasMgr->Mgr.Allocate(Width, Height);
+            return pAtlasMgr->Mgr->Allocate(Width, Height);
         }
 
-        // Frees a region and returns true if the atlas is empty
-        bool Free(DynamicAtlasManager::Region&& R)
+        // Tries to allocate the region without blocking.
+        // Returns false if the manager is locked by another thread.
+        bool TryAllocate(Uint32 Width, Uint32 Height, DynamicAtlasManager::Region& R)
         {
             VERIFY_EXPR(pAtlasMgr != nullptr);
             VERIFY_EXPR(pAtlasMgr->UseCount > 0);
-            std::lock_guard<std::mutex> Guard{pAtlasMgr->Mtx};
-            pAtlasMgr->Mgr.Free(std::move(R));
-            return pAtlasMgr->Mgr.IsEmpty();
+            std::unique_lock<std::mutex> Guard{pAtlasMgr->Mtx, std::try_to_lock};
+            if (!Guard.owns_lock())
+                return false;
+            R = pAtlasMgr->Mgr->Allocate(Width, Height);
+            return true;
         }
 
-        bool IsEmpty()
+        // Frees a region and returns true if the atlas is empty
+        bool Free(DynamicAtlasManager::Region&& R)
         {
             VERIFY_EXPR(pAtlasMgr != nullptr);
             VERIFY_EXPR(pAtlasMgr->UseCount > 0);
             std::lock_guard<std::mutex> Guard{pAtlasMgr->Mtx};
-            return pAtlasMgr->Mgr.IsEmpty();
+            pAtlasMgr->Mgr->Free(std::move(R));
+            return pAtlasMgr->Mgr->IsEmpty();
         }
 
     private:
         friend class ThreadSafeAtlasManager;
 
-        explicit ManagerGuard(ThreadSafeAtlasManager& AtlasMg) :
+        explicit ManagerGuard(ThreadSafeAtlasManager& AtlasMg) noexcept :
             pAtlasMgr{&AtlasMg}
         {
-            AtlasMg.AddUse();
         }
 
         ThreadSafeAtlasManager* pAtlasMgr = nullptr;
     };
 
-    ManagerGuard Lock()
+    // Atomically increments the use count if the manager is active.
+    // Returns an empty guard if the manager is inactive.
+    ManagerGuard TryLock()
+    {
+        auto Uses = UseCount.load();
+        while (Uses >= 0 || Uses == Deactivating)
+        {
+            if (Uses == Deactivating)
+            {
+                // Another thread is checking if the manager is empty. This only takes a
+                // short time, after which the manager becomes either active or inactive.
+                std::this_thread::yield();
+                Uses = UseCount.load();
+            }
+            else if (UseCount.compare_exchange_weak(Uses, Uses + 1))
+            {
+                return ManagerGuard{*this};
+            }
+        }
+        return {};
+    }
+
+    // Activates the manager and returns the guard that holds the first use.
+    // Only the thread that owns the slice index may call this method.
+    ManagerGuard Activate()
     {
+        VERIFY(UseCount.load() == Inactive, "The manager is already active");
+        VERIFY(IsEmpty(), "Inactive manager must be empty");
+        UseCount.store(1);
         return ManagerGuard{*this};
     }
 
-    int GetUseCount() const
+    // Deactivates the manager if it is empty and is not used by any thread.
+    bool TryDeactivate()
+    {
+        int Uses = 0;
+        // Only transition from zero uses. Once the state is Deactivating, TryLock() waits
+        // until the check is complete, so no other thread may start using the manager
+        // while we check if it is empty.
+        if (!UseCount.compare_exchange_strong(Uses, Deactivating))
+            return false;
+
+        // Check that the manager is empty. It is very important to check this only
+        // after we blocked new uses.
+        // If the manager is empty, but the use count is not zero, another thread may
+        // allocate from this manager after we checked if it is empty.
+        if (!IsEmpty())
+        {
+            UseCount.store(0);
+            return false;
+        }
+
+        UseCount.store(Inactive);
+        return true;
+    }
+
+    bool IsActive() const
     {
-        return UseCount.load();
+        return UseCount.load() >= 0;
+    }
+
+    // Calls Handler(const IAtlasRegionAllocator&) while holding the manager mutex.
+    template <typename HandlerType>
+    void Inspect(HandlerType&& Handler) const
+    {
+        std::lock_guard<std::mutex> Guard{Mtx};
+        Handler(*Mgr);
     }
 
 private:
     friend ManagerGuard;
 
-    int AddUse()
+    bool IsEmpty() const
     {
-        auto Uses = UseCount.fetch_add(1) + 1;
-        VERIFY_EXPR(Uses > 0);
-        return Uses;
+        std::lock_guard<std::mutex> Guard{Mtx};
+        return Mgr->IsEmpty();
+    }
+
+    static std::unique_ptr<IAtlasRegionAllocator> CreateAllocator(const uint2& Dim, DYNAMIC_TEXTURE_ATLAS_PACKING_MODE PackingMode)
+    {
+        static_assert(DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_COUNT == 3, "Please handle the new packing mode below");
+        switch (PackingMode)
+        {
+            case DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_NODE_SPLIT:
+                return std::unique_ptr<IAtlasRegionAllocator>{new DynamicAtlasManager{Dim.x, Dim.y}};
+
+            case DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_SKYLINE:
+                return std::unique_ptr<IAtlasRegionAllocator>{new SkylineAtlasManager{Dim.x, Dim.y}};
+
+            case DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_SHELF:
+                return std::unique_ptr<IAtlasRegionAllocator>{new ShelfAtlasManager{Dim.x, Dim.y}};
+
+            default:
+                UNEXPECTED("Unexpected packing mode");
+                return std::unique_ptr<IAtlasRegionAllocator>{new DynamicAtlasManager{Dim.x, Dim.y}};
+        }
     }
 
     int ReleaseUse()
@@ -259,22 +377,48 @@ private:
     }
 
 private:
-    std::mutex          Mtx;
-    DynamicAtlasManager Mgr;
+    // Non-negative values indicate the number of uses of an active manager.
+    static constexpr int Inactive     = -1;
+    static constexpr int Deactivating = -2;
 
-    std::atomic_int UseCount{0};
+    mutable std::mutex                     Mtx;
+    std::unique_ptr<IAtlasRegionAllocator> Mgr;
+
+    std::atomic_int UseCount{Inactive};
 };
 
 
+// Lock-free directory of slice managers that use the same alignment.
+//
+// Every slice index may only be owned by one batch at a time (see DynamicTextureAtlasImpl::GetNextAvailableSlice),
+// and only the owner of the index activates the slice in the directory. Managers are never destroyed
+// while the batch is alive: when a slice is purged, its manager is deactivated and may later be reused
+// if the same slice index is added to this batch again. This allows threads to access the directory
+// without locking.
 struct SliceBatch
 {
-    SliceBatch(const uint2 AtlasDim) noexcept :
-        m_AtlasDim{AtlasDim}
-    {}
+    SliceBatch(const uint2 AtlasDim, Uint32 MaxSliceCount, DYNAMIC_TEXTURE_ATLAS_PACKING_MODE PackingMode) :
+        m_AtlasDim{AtlasDim},
+        m_PackingMode{PackingMode},
+        m_MaxSliceCount{MaxSliceCount},
+        m_Slices{new std::atomic<ThreadSafeAtlasManager*>[MaxSliceCount]}
+    {
+        for (Uint32 i = 0; i < m_MaxSliceCount; ++i)
+            m_Slices[i].store(nullptr);
+        for (auto& PreferredSlice : m_PreferredSlices)
+            PreferredSlice.store(0);
+    }
 
     ~SliceBatch()
     {
-        VERIFY(m_Slices.empty(), "Not all slice managers have been released.");
+        for (Uint32 i = 0; i < m_MaxSliceCount; ++i)
+        {
+            if (auto* pMgr = m_Slices[i].load())
+            {
+                VERIFY(!pMgr->IsActive(), "Not all slice managers have been released.");
+                delete pMgr;
+            }
+        }
     }
 
     // clang-format off
@@ -286,23 +430,18 @@ struct SliceBatch
 
     ThreadSafeAtlasManager::ManagerGuard LockSlice(Uint32 Slice)
     {
-        std::lock_guard<std::mutex> Guard{m_Mtx};
-
-        auto it = m_Slices.find(Slice);
-        // NB: Lock() atomically increases the use count of the slice while we hold the mutex.
-        return it != m_Slices.end() ? it->second.Lock() : ThreadSafeAtlasManager::ManagerGuard{};
+        auto* pMgr = Slice < m_MaxSliceCount ? m_Slices[Slice].load() : nullptr;
+        return pMgr != nullptr ? pMgr->TryLock() : ThreadSafeAtlasManager::ManagerGuard{};
     }
 
+    // Locks the first active slice with index >= Slice.
     ThreadSafeAtlasManager::ManagerGuard LockSliceAfter(Uint32& Slice)
     {
-        std::lock_guard<std::mutex> Guard{m_Mtx};
-
-        auto it = m_Slices.lower_bound(Slice);
-        if (it != m_Slices.end())
+        const auto SliceRangeEnd = m_SliceRangeEnd.load();
+        for (; Slice < SliceRangeEnd; ++Slice)
         {
-            Slice = it->first;
-            // NB: Lock() atomically increases the use count of the slice while we hold the mutex.
-            return it->second.Lock();
+            if (auto SliceMgr = LockSlice(Slice))
+                return SliceMgr;
         }
 
         return {};
@@ -310,49 +449,72 @@ struct SliceBatch
 
     ThreadSafeAtlasManager::ManagerGuard AddSlice(Uint32 Slice)
     {
-        std::lock_guard<std::mutex> Guard{m_Mtx};
+        VERIFY_EXPR(Slice < m_MaxSliceCount);
 
-        VERIFY(m_Slices.find(Slice) == m_Slices.end(), "Slice ", Slice, " already present in the batch.");
-        auto it = m_Slices.emplace(Slice, m_AtlasDim).first;
-        // NB: Lock() atomically increases the use count of the slice while we hold the mutex.
-        return it->second.Lock();
+        auto* pMgr = m_Slices[Slice].load();
+        if (pMgr == nullptr)
+        {
+            // No other thread may write to this slot as this thread owns the slice index.
+            pMgr = new ThreadSafeAtlasManager{m_AtlasDim, m_PackingMode};
+            m_Slices[Slice].store(pMgr);
+        }
+
+        auto SliceRangeEnd = m_SliceRangeEnd.load();
+        while (SliceRangeEnd <= Slice && !m_SliceRangeEnd.compare_exchange_weak(SliceRangeEnd, Slice + 1))
+        {
+        }
+
+        return pMgr->Activate();
     }
 
     bool Purge(Uint32 Slice)
     {
-        std::lock_guard<std::mutex> Guard{m_Mtx};
-
-        auto it = m_Slices.find(Slice);
-        if (it == m_Slices.end())
-            return false;
-
-        // Use count may only be incremented under the mutex. If the count is zero,
-        // no other thread may be accessing this slice since we hold the mutex.
-        if (it->second.GetUseCount() != 0)
-            return false;
+        auto* pMgr = Slice < m_MaxSliceCount ? m_Slices[Slice].load() : nullptr;
+        // Use count may only be incremented while the manager is active. TryDeactivate()
+        // atomically checks that there are no uses and blocks new ones, so no other thread
+        // may be accessing this slice when it checks if the slice is empty.
+        return pMgr != nullptr && pMgr->TryDeactivate();
+    }
 
-        // Check that the slice is empty. It is very important to check this only
-        // after we checked the use count.
-        // If the slice is empty, but the use count is not zero, another thread may
-        // allocate from this slice after we checked if it is empty.
-        auto SliceMgr = it->second.Lock();
-        VERIFY_EXPR(SliceMgr);
-        if (!SliceMgr.IsEmpty())
-            return false;
+    // Calls Handler(Uint32 Slice, const IAtlasRegionAllocator&) for every active slice in the batch.
+    template <typename HandlerType>
+    void InspectSlices(HandlerType&& Handler)
+    {
+        const auto SliceRangeEnd = m_SliceRangeEnd.load();
+        for (Uint32 Slice = 0; Slice < SliceRangeEnd; ++Slice)
+        {
+            if (auto SliceMgr = LockSlice(Slice))
+                m_Slices[Slice].load()->Inspect([&](const IAtlasRegionAllocator& Mgr) { Handler(Slice, Mgr); });
+        }
+    }
 
-        const auto UseCnt = SliceMgr.Release();
-        VERIFY(UseCnt == 0, "There must be no other uses of this slice since we checked the use count already.");
-        m_Slices.erase(it);
+    Uint32 GetSliceRangeEnd() const
+    {
+        return m_SliceRangeEnd.load();
+    }
 
-        return true;
+    // Every thread is assigned one of the preferred slice slots, where the batch
+    // keeps the slice that was last used by the threads in that slot.
+    std::atomic<Uint32>& GetPreferredSlice()
+    {
+        static std::atomic<Uint32> NextThreadId{0};
+        static thread_local const Uint32 ThreadId = NextThreadId.fetch_add(1);
+        return m_PreferredSlices[ThreadId % NumPreferredSlices];
     }
 
 private:
-    const uint2 m_AtlasDim;
+    const uint2                              m_AtlasDim;
+    const DYNAMIC_TEXTURE_ATLAS_PACKING_MODE m_PackingMode;
+    const Uint32                             m_MaxSliceCount;
+
+    // Slice index -> slice manager
+    std::unique_ptr<std::atomic<ThreadSafeAtlasManager*>[]> m_Slices;
+
+    // One past the largest slice index that has ever been added to the batch
+    std::atomic<Uint32> m_SliceRangeEnd{0};
 
-    std::mutex m_Mtx;
-    // For every alignment, we keep a list of slice managers sorted by the slice index.
-    std::map<Uint32, ThreadSafeAtlasManager> m_Slices;
+    static constexpr Uint32 NumPreferredSlices = 32;
+    std::atomic<Uint32>     m_PreferredSlices[NumPreferredSlices];
 };
 
 } // namespace
@@ -377,10 +539,13 @@ public:
             }(CreateInfo.Desc) //
         },
         // clang-format off
-        m_MinAlignment    {CreateInfo.MinAlignment},
-        m_ExtraSliceCount {CreateInfo.ExtraSliceCount},
-        m_MaxSliceCount   {CreateInfo.Desc.Type == RESOURCE_DIM_TEX_2D_ARRAY ? std::min(CreateInfo.MaxSliceCount, Uint32{2048}) : 1},
-        m_Silent          {CreateInfo.Silent},
+        m_MinAlignment         {CreateInfo.MinAlignment},
+        m_ExtraSliceCount      {CreateInfo.ExtraSliceCount},
+        m_MaxSliceCount        {CreateInfo.Desc.Type == RESOURCE_DIM_TEX_2D_ARRAY ? std::min(CreateInfo.MaxSliceCount, Uint32{2048}) : 1},
+        m_Silent               {CreateInfo.Silent},
+        m_ScalableAllocation   {CreateInfo.ScalableAllocation},
+        m_EnableDefragmentation{CreateInfo.EnableDefragmentation},
+        m_PackingMode          {CreateInfo.PackingMode},
         m_SuballocationsAllocator
         {
             DefaultRawMemoryAllocator::GetAllocator(),
@@ -413,9 +578,15 @@ public:
                 LOG_ERROR_AND_THROW("Texture height (", m_Desc.Height, ") is not a multiple of minimum alignment (", m_MinAlignment, ")");
         }
 
+        if (m_PackingMode >= DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_COUNT)
+            LOG_ERROR_AND_THROW("Invalid packing mode (", Uint32{m_PackingMode}, ")");
+
         for (Uint32 i = 0; i < m_MaxSliceCount; ++i)
             m_AvailableSlices.insert(i);
 
+        for (auto& Batch : m_SliceBatches)
+            Batch.store(nullptr);
+
         m_TexArraySize.store(m_Desc.ArraySize);
         if (m_Desc.Type == RESOURCE_DIM_TEX_2D)
         {
@@ -440,6 +611,13 @@ public:
         VERIFY_EXPR(m_UsedArea.load() == 0);
         VERIFY_EXPR(m_AllocationCount.load() == 0);
         VERIFY_EXPR(m_AvailableSlices.size() == m_MaxSliceCount);
+#ifdef DILIGENT_DEBUG
+        for (const auto& Shard : m_SuballocationShards)
+            VERIFY_EXPR(Shard.Suballocations.empty());
+#endif
+
+        for (auto& Batch : m_SliceBatches)
+            delete Batch.load();
     }
 
     IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_DynamicTextureAtlas, TBase)
@@ -502,42 +680,12 @@ public:
         auto* pBatch = GetSliceBatch(Alignment, m_Desc.Width / Alignment, m_Desc.Height / Alignment);
         VERIFY_EXPR(pBatch != nullptr);
 
+        Uint32                      Slice = 0;
         DynamicAtlasManager::Region Subregion;
-
-        Uint32 Slice = 0;
-        while (Slice < m_MaxSliceCount)
-        {
-            // Lock the first available slice with index >= Slice
-            auto SliceMgr = pBatch->LockSliceAfter(Slice);
-            if (!SliceMgr)
-            {
-                const auto NewSlice = GetNextAvailableSlice();
-                if (NewSlice != ~Uint32{0})
-                {
-                    Slice    = NewSlice;
-                    SliceMgr = pBatch->AddSlice(Slice);
-                    VERIFY_EXPR(SliceMgr);
-                }
-                else
-                {
-                    // It is possible that another thread added a new slice while this thread failed
-                    SliceMgr = pBatch->LockSliceAfter(Slice);
-                    if (!SliceMgr)
-                        break;
-                }
-            }
-
-            if (SliceMgr)
-            {
-                Subregion = SliceMgr.Allocate(AlignedWidth / Alignment, AlignedHeight / Alignment);
-                if (!Subregion.IsEmpty())
-                    break;
-            }
-
-            // Failed to allocate the region - try the next slice
-            ++Slice;
-        }
-
+        if (m_ScalableAllocation)
+            Subregion = TryAllocateRegionNoWait(*pBatch, AlignedWidth / Alignment, AlignedHeight / Alignment, Slice);
+        if (Subregion.IsEmpty())
+            Subregion = AllocateRegion(*pBatch, AlignedWidth / Alignment, AlignedHeight / Alignment, Slice);
         if (Subregion.IsEmpty())
         {
             if (!m_Silent)
@@ -565,13 +713,38 @@ public:
         // clang-format on
 
         pSuballocation->QueryInterface(IID_TextureAtlasSuballocation, reinterpret_cast<IObject**>(ppSuballocation));
+
+        if (m_EnableDefragmentation)
+        {
+            auto&                       Shard = GetSuballocationShard(pSuballocation);
+            std::lock_guard<std::mutex> Guard{Shard.Mtx};
+            Shard.Suballocations.emplace(pSuballocation, RefCntWeakPtr<TextureAtlasSuballocationImpl>{pSuballocation});
+        }
     }
 
-    void Free(Uint32 Slice, Uint32 Alignment, DynamicAtlasManager::Region&& Subregion, Uint32 Width, Uint32 Height)
+    void Free(TextureAtlasSuballocationImpl* pSuballocation, Uint32 Slice, Uint32 Alignment, DynamicAtlasManager::Region&& Subregion, Uint32 Width, Uint32 Height)
     {
+        if (m_EnableDefragmentation)
+        {
+            auto&                       Shard = GetSuballocationShard(pSuballocation);
+            std::lock_guard<std::mutex> Guard{Shard.Mtx};
+            // NB: the object is being destroyed, so this may release the last weak
+            //     reference and destroy the reference counters, which is allowed.
+            Shard.Suballocations.erase(pSuballocation);
+        }
+
         const auto AllocatedArea = Int64{Width} * Int64{Height};
         const auto UsedArea      = (Int64{Subregion.width} * Int64{Alignment}) * (Int64{Subregion.height} * Int64{Alignment});
 
+        FreeRegion(Slice, Alignment, std::move(Subregion));
+
+        m_AllocatedArea.fetch_add(-AllocatedArea);
+        m_UsedArea.fetch_add(-UsedArea);
+        m_AllocationCount.fetch_add(-1);
+    }
+
+    void FreeRegion(Uint32 Slice, Uint32 Alignment, DynamicAtlasManager::Region&& Subregion)
+    {
         auto* pBatch = GetSliceBatch(Alignment);
         if (pBatch == nullptr)
         {
@@ -622,10 +795,6 @@ public:
         {
             RecycleSlice(Slice);
         }
-
-        m_AllocatedArea.fetch_add(-AllocatedArea);
-        m_UsedArea.fetch_add(-UsedArea);
-        m_AllocationCount.fetch_add(-1);
     }
 
     virtual const TextureDesc& GetAtlasDesc() const override final
@@ -663,9 +832,393 @@ public:
         Stats.AllocationCount = m_AllocationCount.load();
         Stats.AllocatedArea   = m_AllocatedArea.load();
         Stats.UsedArea        = m_UsedArea.load();
+
+        Stats.CommittedSliceCount   = 0;
+        Stats.FreeRegionCount       = 0;
+        Stats.CommittedFreeArea     = 0;
+        Stats.LargestFreeRegionArea = 0;
+
+        Uint64 SumLargestFreeRegionArea = 0;
+        for (const auto& Batch : GetSliceBatches())
+        {
+            const Uint64 TexelsPerUnit = Uint64{Batch.first} * Uint64{Batch.first};
+            Batch.second->InspectSlices(
+                [&](Uint32, const IAtlasRegionAllocator& Mgr) //
+                {
+                    if (Mgr.IsEmpty())
+                        return;
+
+                    const auto LargestFreeRegionArea = Mgr.GetLargestFreeRegionArea() * TexelsPerUnit;
+
+                    Stats.CommittedSliceCount += 1;
+                    Stats.FreeRegionCount += Mgr.GetFreeRegionCount();
+                    Stats.CommittedFreeArea += Mgr.GetTotalFreeArea() * TexelsPerUnit;
+                    Stats.LargestFreeRegionArea = std::max(Stats.LargestFreeRegionArea, LargestFreeRegionArea);
+                    SumLargestFreeRegionArea += LargestFreeRegionArea;
+                });
+        }
+        Stats.Fragmentation = Stats.CommittedFreeArea != 0 ?
+            1.f - static_cast<float>(static_cast<double>(SumLargestFreeRegionArea) / static_cast<double>(Stats.CommittedFreeArea)) :
+            0.f;
+
+        Stats.PendingRelocationCount = m_PendingRelocationCount.load();
+        Stats.RelocationCount        = m_RelocationCount.load();
+    }
+
+    virtual Uint32 Defragment(IRenderDevice*                              pDevice,
+                              IDeviceContext*                             pContext,
+                              const DynamicTextureAtlasDefragmentAttribs& Attribs) override final
+    {
+        if (!m_DynamicTexArray)
+        {
+            // Texture 2D atlas has a single slice
+            return 0;
+        }
+
+        if (!m_EnableDefragmentation)
+        {
+            // Suballocations are not tracked, so they can't be moved
+            return 0;
+        }
+
+        DEV_CHECK_ERR(Attribs.MaxSliceOccupancy >= 0 && Attribs.MaxSliceOccupancy <= 1,
+                      "Max slice occupancy (", Attribs.MaxSliceOccupancy, ") must be in [0, 1] range");
+
+        if (m_PendingRelocations.empty())
+            PlanRelocations(Attribs.MaxSliceOccupancy);
+
+        if (m_PendingRelocations.empty())
+            return 0;
+
+        DEV_CHECK_ERR(pContext != nullptr, "Device context must not be null");
+        auto* pTexture = GetTexture(pDevice, pContext);
+        if (pTexture == nullptr)
+        {
+            UNEXPECTED("Failed to get the atlas texture");
+            return 0;
+        }
+
+        Uint32 NumRelocations = 0;
+        Uint64 NumTexelsCopied = 0;
+        while (!m_PendingRelocations.empty())
+        {
+            if (Attribs.MaxRelocations != 0 && NumRelocations >= Attribs.MaxRelocations)
+                break;
+
+            auto pSuballoc = m_PendingRelocations.front().Lock();
+            if (!pSuballoc)
+            {
+                // The suballocation has been released
+                m_PendingRelocations.pop_front();
+                continue;
+            }
+
+            const auto SrcSlice  = pSuballoc->GetSlice();
+            const auto Alignment = pSuballoc->GetAlignment();
+            const auto SrcRegion = pSuballoc->GetSubregion();
+            if (m_EvacuatedSlices.find(SrcSlice) == m_EvacuatedSlices.end())
+            {
+                // Evacuation of this slice has been abandoned
+                m_PendingRelocations.pop_front();
+                continue;
+            }
+
+            const auto NumTexels = Uint64{SrcRegion.width * Alignment} * Uint64{SrcRegion.height * Alignment};
+            if (Attribs.MaxTexelsToCopy != 0 && NumRelocations > 0 && NumTexelsCopied + NumTexels > Attribs.MaxTexelsToCopy)
+                break;
+
+            m_PendingRelocations.pop_front();
+
+            auto* pBatch = GetSliceBatch(Alignment);
+            VERIFY_EXPR(pBatch != nullptr);
+
+            Uint32 DstSlice  = 0;
+            auto   DstRegion = AllocateRegion(*pBatch, SrcRegion.width, SrcRegion.height, DstSlice, &m_EvacuatedSlices);
+            if (DstRegion.IsEmpty())
+            {
+                // There is not enough contiguous space in other slices - keep the remaining
+                // allocations in this slice.
+                m_EvacuatedSlices.erase(SrcSlice);
+                continue;
+            }
+            VERIFY_EXPR(DstSlice != SrcSlice);
+
+            CopyRegion(pTexture, pContext, Alignment, SrcSlice, SrcRegion, DstSlice, DstRegion);
+
+            const auto OldOrigin = pSuballoc->GetOrigin();
+            // Relocate() swaps the locations, so DstSlice and DstRegion now refer to the old location.
+            pSuballoc->Relocate(DstSlice, DstRegion);
+            VERIFY_EXPR(DstSlice == SrcSlice && DstRegion == SrcRegion);
+            FreeRegion(DstSlice, Alignment, std::move(DstRegion));
+
+            if (Attribs.RelocationCallback != nullptr)
+                Attribs.RelocationCallback(pSuballoc, SrcSlice, OldOrigin, Attribs.pRelocationCallbackUserData);
+
+            ++NumRelocations;
+            NumTexelsCopied += NumTexels;
+        }
+
+        m_PendingRelocationCount.store(static_cast<Uint32>(m_PendingRelocations.size()));
+        m_RelocationCount.fetch_add(NumRelocations);
+
+        return NumRelocations;
     }
 
 private:
+    // Allocates the region from the first slice in the batch that has enough space, starting with
+    // Slice. If pExcludedSlices is null, new slices are added to the batch when necessary. Otherwise,
+    // only existing slices that are not in the excluded set are used.
+    DynamicAtlasManager::Region AllocateRegion(SliceBatch&             Batch,
+                                               Uint32                  Width,
+                                               Uint32                  Height,
+                                               Uint32&                 Slice,
+                                               const std::set<Uint32>* pExcludedSlices = nullptr)
+    {
+        DynamicAtlasManager::Region Subregion;
+
+        while (Slice < m_MaxSliceCount)
+        {
+            // Lock the first available slice with index >= Slice
+            auto SliceMgr = Batch.LockSliceAfter(Slice);
+            if (!SliceMgr)
+            {
+                if (pExcludedSlices != nullptr)
+                    break;
+
+                const auto NewSlice = GetNextAvailableSlice();
+                if (NewSlice != ~Uint32{0})
+                {
+                    Slice    = NewSlice;
+                    SliceMgr = Batch.AddSlice(Slice);
+                    VERIFY_EXPR(SliceMgr);
+                }
+                else
+                {
+                    // It is possible that another thread added a new slice while this thread failed
+                    SliceMgr = Batch.LockSliceAfter(Slice);
+                    if (!SliceMgr)
+                        break;
+                }
+            }
+
+            if (SliceMgr && (pExcludedSlices == nullptr || pExcludedSlices->find(Slice) == pExcludedSlices->end()))
+            {
+                Subregion = SliceMgr.Allocate(Width, Height);
+                if (!Subregion.IsEmpty())
+                    break;
+            }
+
+            // Failed to allocate the region - try the next slice
+            ++Slice;
+        }
+
+        return Subregion;
+    }
+
+    struct SuballocationShard
+    {
+        std::mutex                                                                                        Mtx;
+        std::unordered_map<TextureAtlasSuballocationImpl*, RefCntWeakPtr<TextureAtlasSuballocationImpl>> Suballocations;
+    };
+    static constexpr size_t NumSuballocationShards = 16;
+
+    SuballocationShard& GetSuballocationShard(const TextureAtlasSuballocationImpl* pSuballocation)
+    {
+        // Suballocations are allocated from the fixed block allocator, so consecutive
+        // objects are sizeof(TextureAtlasSuballocationImpl) bytes apart.
+        const auto Idx = reinterpret_cast<size_t>(pSuballocation) / sizeof(TextureAtlasSuballocationImpl);
+        return m_SuballocationShards[Idx % NumSuballocationShards];
+    }
+
+    // Tries to allocate the region from the existing slices without waiting for the slices locked by
+    // other threads, starting with the preferred slice of this thread. If all slices have been checked
+    // and none of them has enough space, Slice is set to the end of the slice range, so that
+    // AllocateRegion() proceeds with adding a new slice. Otherwise, Slice is set to zero.
+    DynamicAtlasManager::Region TryAllocateRegionNoWait(SliceBatch& Batch,
+                                                        Uint32      Width,
+                                                        Uint32      Height,
+                                                        Uint32&     Slice)
+    {
+        auto&        PreferredSlice = Batch.GetPreferredSlice();
+        const Uint32 SliceRangeEnd  = Batch.GetSliceRangeEnd();
+        const Uint32 FirstSlice     = std::min(PreferredSlice.load(std::memory_order_relaxed), SliceRangeEnd);
+
+        bool Contended = false;
+        for (Uint32 i = 0; i < SliceRangeEnd; ++i)
+        {
+            Slice = (FirstSlice + i) % SliceRangeEnd;
+            if (auto SliceMgr = Batch.LockSlice(Slice))
+            {
+                DynamicAtlasManager::Region Subregion;
+                if (!SliceMgr.TryAllocate(Width, Height, Subregion))
+                {
+                    // The slice is locked by another thread - try the next one
+                    Contended = true;
+                    continue;
+                }
+
+                if (!Subregion.IsEmpty())
+                {
+                    PreferredSlice.store(Slice, std::memory_order_relaxed);
+                    return Subregion;
+                }
+            }
+        }
+
+        Slice = Contended ? 0 : SliceRangeEnd;
+        return {};
+    }
+
+    // Returns (alignment, batch) pairs for all existing slice batches
+    std::vector<std::pair<Uint32, SliceBatch*>> GetSliceBatches() const
+    {
+        // NB: batches are never removed while the atlas is alive.
+        std::vector<std::pair<Uint32, SliceBatch*>> Batches;
+        for (size_t i = 0; i < m_SliceBatches.size(); ++i)
+        {
+            if (auto* pBatch = m_SliceBatches[i].load())
+                Batches.emplace_back(1u << i, pBatch);
+        }
+        return Batches;
+    }
+
+    // Finds sparse slices whose allocations fit into the free space of other
+    // slices with the same alignment and schedules their suballocations for relocation.
+    void PlanRelocations(float MaxSliceOccupancy)
+    {
+        VERIFY_EXPR(m_PendingRelocations.empty());
+        m_EvacuatedSlices.clear();
+
+        struct SliceInfo
+        {
+            Uint32 Slice;
+            Uint64 UsedArea;
+            Uint64 FreeArea;
+        };
+        std::vector<SliceInfo> Slices;
+        for (const auto& Batch : GetSliceBatches())
+        {
+            Slices.clear();
+            Uint64 TotalFreeArea = 0;
+            Batch.second->InspectSlices(
+                [&](Uint32 Slice, const IAtlasRegionAllocator& Mgr) //
+                {
+                    const auto SliceArea = Uint64{Mgr.GetWidth()} * Uint64{Mgr.GetHeight()};
+                    const auto FreeArea  = Mgr.GetTotalFreeArea();
+                    Slices.push_back({Slice, SliceArea - FreeArea, FreeArea});
+                    TotalFreeArea += FreeArea;
+                });
+            if (Slices.size() < 2)
+                continue;
+
+            std::sort(Slices.begin(), Slices.end(),
+                      [](const SliceInfo& S0, const SliceInfo& S1) {
+                          return S0.UsedArea < S1.UsedArea;
+                      });
+
+            // Evacuate the sparsest slices as long as their contents fit into the free space of the remaining ones.
+            Uint64 EvacuatedArea = 0;
+            Uint64 DstFreeArea   = TotalFreeArea;
+            for (size_t i = 0; i + 1 < Slices.size(); ++i)
+            {
+                const auto& Slice = Slices[i];
+                if (Slice.UsedArea == 0)
+                    continue;
+
+                const auto SliceArea = Slice.UsedArea + Slice.FreeArea;
+                if (static_cast<double>(Slice.UsedArea) > static_cast<double>(SliceArea) * MaxSliceOccupancy)
+                    break;
+
+                if (EvacuatedArea + Slice.UsedArea > DstFreeArea - Slice.FreeArea)
+                    break;
+
+                EvacuatedArea += Slice.UsedArea;
+                DstFreeArea -= Slice.FreeArea;
+                m_EvacuatedSlices.insert(Slice.Slice);
+            }
+        }
+
+        if (m_EvacuatedSlices.empty())
+            return;
+
+        std::vector<std::pair<Uint64, RefCntWeakPtr<TextureAtlasSuballocationImpl>>> Relocations;
+        for (auto& Shard : m_SuballocationShards)
+        {
+            std::lock_guard<std::mutex> Guard{Shard.Mtx};
+            for (const auto& it : Shard.Suballocations)
+            {
+                // NB: the object may be in the process of destruction, but its memory is valid while
+                //     it is in the map. Slice and subregion are only modified by Defragment().
+                const auto* pSuballoc = it.first;
+                if (m_EvacuatedSlices.find(pSuballoc->GetSlice()) != m_EvacuatedSlices.end())
+                {
+                    const auto& R         = pSuballoc->GetSubregion();
+                    const auto  Alignment = Uint64{pSuballoc->GetAlignment()};
+                    Relocations.emplace_back(Uint64{R.width} * Uint64{R.height} * Alignment * Alignment, it.second);
+                }
+            }
+        }
+
+        // Move large allocations first to reduce fragmentation of the destination slices
+        std::stable_sort(Relocations.begin(), Relocations.end(),
+                         [](const std::pair<Uint64, RefCntWeakPtr<TextureAtlasSuballocationImpl>>& R0,
+                            const std::pair<Uint64, RefCntWeakPtr<TextureAtlasSuballocationImpl>>& R1) {
+                             return R0.first > R1.first;
+                         });
+        for (auto& Relocation : Relocations)
+            m_PendingRelocations.emplace_back(std::move(Relocation.second));
+
+        m_PendingRelocationCount.store(static_cast<Uint32>(m_PendingRelocations.size()));
+    }
+
+    // Copies all mip levels of the source region to the destination region
+    static void CopyRegion(ITexture*                          pTexture,
+                           IDeviceContext*                    pContext,
+                           Uint32                             Alignment,
+                           Uint32                             SrcSlice,
+                           const DynamicAtlasManager::Region& SrcRegion,
+                           Uint32                             DstSlice,
+                           const DynamicAtlasManager::Region& DstRegion)
+    {
+        const auto& Desc       = pTexture->GetDesc();
+        const auto& FmtAttribs = GetTextureFormatAttribs(Desc.Format);
+
+        const Uint32 BlockWidth  = FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED ? FmtAttribs.BlockWidth : 1;
+        const Uint32 BlockHeight = FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED ? FmtAttribs.BlockHeight : 1;
+
+        const Uint32 Width  = SrcRegion.width * Alignment;
+        const Uint32 Height = SrcRegion.height * Alignment;
+
+        CopyTextureAttribs CopyAttribs{pTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+        CopyAttribs.SrcSlice = SrcSlice;
+        CopyAttribs.DstSlice = DstSlice;
+        for (Uint32 mip = 0; mip < Desc.MipLevels; ++mip)
+        {
+            const auto MipProps = GetMipLevelProperties(Desc, mip);
+
+            // Regions are aligned by Alignment, so their placement in coarse mip levels is exact as long as
+            // the region is larger than one texel. Coarser levels may share texels with neighboring regions.
+            const Uint32 SrcX = AlignDown((SrcRegion.x * Alignment) >> mip, BlockWidth);
+            const Uint32 SrcY = AlignDown((SrcRegion.y * Alignment) >> mip, BlockHeight);
+            const Uint32 DstX = AlignDown((DstRegion.x * Alignment) >> mip, BlockWidth);
+            const Uint32 DstY = AlignDown((DstRegion.y * Alignment) >> mip, BlockHeight);
+
+            Uint32 MipWidth  = AlignUp(std::max((Width + (1u << mip) - 1) >> mip, 1u), BlockWidth);
+            Uint32 MipHeight = AlignUp(std::max((Height + (1u << mip) - 1) >> mip, 1u), BlockHeight);
+            MipWidth         = std::min(MipWidth, MipProps.LogicalWidth - std::max(SrcX, DstX));
+            MipHeight        = std::min(MipHeight, MipProps.LogicalHeight - std::max(SrcY, DstY));
+
+            Box SrcBox{SrcX, SrcX + MipWidth, SrcY, SrcY + MipHeight};
+
+            CopyAttribs.SrcMipLevel = mip;
+            CopyAttribs.DstMipLevel = mip;
+            CopyAttribs.pSrcBox     = &SrcBox;
+            CopyAttribs.DstX        = DstX;
+            CopyAttribs.DstY        = DstY;
+            pContext->CopyTexture(CopyAttribs);
+        }
+    }
+
     Uint32 GetNextAvailableSlice()
     {
         std::lock_guard<std::mutex> Guard{m_AvailableSlicesMtx};
@@ -697,14 +1250,19 @@ private:
 
     SliceBatch* GetSliceBatch(Uint32 Alignment, Uint32 AtlasWidth = 0, Uint32 AtlasHeight = 0)
     {
-        std::lock_guard<std::mutex> Guard{m_SliceBatchesByAlignmentMtx};
+        VERIFY_EXPR(IsPowerOfTwo(Alignment));
+        auto& BatchSlot = m_SliceBatches[PlatformMisc::GetLSB(Alignment)];
 
-        // Get the list of slices for this alignment
-        auto BatchIt = m_SliceBatchesByAlignment.find(Alignment);
-        if (BatchIt == m_SliceBatchesByAlignment.end() && AtlasWidth != 0 && AtlasHeight != 0)
-            BatchIt = m_SliceBatchesByAlignment.emplace(Alignment, uint2{AtlasWidth, AtlasHeight}).first;
+        auto* pBatch = BatchSlot.load();
+        if (pBatch == nullptr && AtlasWidth != 0 && AtlasHeight != 0)
+        {
+            std::unique_ptr<SliceBatch> pNewBatch{new SliceBatch{uint2{AtlasWidth, AtlasHeight}, m_MaxSliceCount, m_PackingMode}};
+            if (BatchSlot.compare_exchange_strong(pBatch, pNewBatch.get()))
+                pBatch = pNewBatch.release();
+            // Otherwise, another thread has created the batch, and pBatch now points to it.
+        }
 
-        return BatchIt != m_SliceBatchesByAlignment.end() ? &BatchIt->second : nullptr;
+        return pBatch;
     }
 
 private:
@@ -715,6 +1273,10 @@ private:
     const Uint32 m_ExtraSliceCount;
     const Uint32 m_MaxSliceCount;
     const bool   m_Silent;
+    const bool   m_ScalableAllocation;
+    const bool   m_EnableDefragmentation;
+
+    const DYNAMIC_TEXTURE_ATLAS_PACKING_MODE m_PackingMode;
 
     std::unique_ptr<DynamicTextureArray> m_DynamicTexArray;
     RefCntAutoPtr<ITexture>              m_pTexture;
@@ -728,19 +1290,30 @@ private:
     std::atomic<Int64> m_AllocatedArea{0};
     std::atomic<Int64> m_UsedArea{0};
 
-    std::mutex m_SliceBatchesByAlignmentMtx;
-    // Alignment -> slice batch
-    std::unordered_map<Uint32, SliceBatch> m_SliceBatchesByAlignment;
+    // log2(Alignment) -> slice batch
+    std::array<std::atomic<SliceBatch*>, 32> m_SliceBatches;
 
     // Keep available slice indices sorted.
     std::mutex       m_AvailableSlicesMtx;
     std::set<Uint32> m_AvailableSlices;
+
+    // All live suballocations, only tracked when defragmentation is enabled. Weak references are
+    // used because a suballocation may be released by another thread while it is being scheduled for relocation.
+    // The registry is split into shards to avoid serializing threads that allocate in parallel.
+    std::array<SuballocationShard, NumSuballocationShards> m_SuballocationShards;
+
+    // Defragmentation state. Only accessed by Defragment().
+    std::set<Uint32>                                          m_EvacuatedSlices;
+    std::deque<RefCntWeakPtr<TextureAtlasSuballocationImpl>> m_PendingRelocations;
+
+    std::atomic<Uint32> m_PendingRelocationCount{0};
+    std::atomic<Uint64> m_RelocationCount{0};
 };
 
 
 TextureAtlasSuballocationImpl::~TextureAtlasSuballocationImpl()
 {
-    m_pParentAtlas->Free(m_Slice, m_Alignment, std::move(m_Subregion), m_Size.x, m_Size.y);
+    m_pParentAtlas->Free(this, m_Slice, m_Alignment, std::move(m_Subregion), m_Size.x, m_Size.y);
 }
 
 IDynamicTextureAtlas* TextureAtlasSuballocationImpl::GetAtlas()
@@ -26,13 +26,17 @@
  */
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <limits>
+#include <vector>
 
 #include "GraphicsUtilities.h"
 #include "DebugUtilities.hpp"
 #include "GraphicsAccessories.hpp"
 #include "ColorConversion.h"
+#include "ThreadPool.hpp"
+#include "Intrinsics.hpp"
 
 #define PI_F 3.1415926f
 
@@ -282,29 +286,403 @@ ChannelType MostFrequentSelector(ChannelType c0, ChannelType c1, ChannelType c2,
     }
 }
 
+// Row kernels compute the beginning of a coarse mip level row using SIMD instructions and return the
+// number of texels processed. The remaining texels are processed by the generic filter.
+// Kernels are only used when the fine level is at least two texels wide, in which case no column
+// clamping is necessary. The results are bit-identical to the generic filters.
+using FilterMipRowKernelType = Uint32 (*)(const void* pSrcRow0, const void* pSrcRow1, void* pDstRow, Uint32 CoarseMipWidth);
+
+#if DILIGENT_SSE2_ENABLED
+
+// Lo and Hi contain 16-bit channel values of 16/NumChannels adjacent texels. Returns sums of even and odd texels.
+template <Uint32 NumChannels>
+__m128i AddAdjacentTexelsSSE2(__m128i Lo, __m128i Hi)
+{
+    static_assert(NumChannels == 1 || NumChannels == 2 || NumChannels == 4, "Unexpected number of channels");
+    if (NumChannels == 4)
+    {
+        return _mm_add_epi16(_mm_unpacklo_epi64(Lo, Hi), _mm_unpackhi_epi64(Lo, Hi));
+    }
+    else if (NumChannels == 2)
+    {
+        const __m128 LoPS = _mm_castsi128_ps(Lo);
+        const __m128 HiPS = _mm_castsi128_ps(Hi);
+        return _mm_add_epi16(_mm_castps_si128(_mm_shuffle_ps(LoPS, HiPS, _MM_SHUFFLE(2, 0, 2, 0))),
+                             _mm_castps_si128(_mm_shuffle_ps(LoPS, HiPS, _MM_SHUFFLE(3, 1, 3, 1))));
+    }
+    else
+    {
+        // Sums do not exceed 510, so signed saturation is harmless
+        const __m128i Mask = _mm_set1_epi32(0xFFFF);
+        return _mm_add_epi16(_mm_packs_epi32(_mm_and_si128(Lo, Mask), _mm_and_si128(Hi, Mask)),
+                             _mm_packs_epi32(_mm_srli_epi32(Lo, 16), _mm_srli_epi32(Hi, 16)));
+    }
+}
+
+template <Uint32 NumChannels>
+Uint32 BoxAverageRowUint8SSE2(const Uint8* pSrcRow0, const Uint8* pSrcRow1, Uint8* pDstRow, Uint32 CoarseMipWidth, Uint32 col)
+{
+    // 16 fine bytes produce 8 coarse bytes
+    constexpr Uint32 TexelsPerIter = 8 / NumChannels;
+
+    const __m128i Zero = _mm_setzero_si128();
+    for (; col + TexelsPerIter <= CoarseMipWidth; col += TexelsPerIter)
+    {
+        const __m128i Row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrcRow0 + col * 2 * NumChannels));
+        const __m128i Row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrcRow1 + col * 2 * NumChannels));
+
+        const __m128i Lo  = _mm_add_epi16(_mm_unpacklo_epi8(Row0, Zero), _mm_unpacklo_epi8(Row1, Zero));
+        const __m128i Hi  = _mm_add_epi16(_mm_unpackhi_epi8(Row0, Zero), _mm_unpackhi_epi8(Row1, Zero));
+        const __m128i Avg = _mm_srli_epi16(AddAdjacentTexelsSSE2<NumChannels>(Lo, Hi), 2);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pDstRow + col * NumChannels), _mm_packus_epi16(Avg, Avg));
+    }
+    return col;
+}
+
+template <Uint32 NumChannels>
+Uint32 BoxAverageRowFloatSSE2(const float* pSrcRow0, const float* pSrcRow1, float* pDstRow, Uint32 CoarseMipWidth)
+{
+    // 8 fine values produce 4 coarse values
+    constexpr Uint32 TexelsPerIter = 4 / NumChannels;
+
+    const auto LoadEvenOdd = [](const float* pSrc, __m128& Even, __m128& Odd) {
+        const __m128 a = _mm_loadu_ps(pSrc);
+        const __m128 b = _mm_loadu_ps(pSrc + 4);
+        if (NumChannels == 4)
+        {
+            Even = a;
+            Odd  = b;
+        }
+        else if (NumChannels == 2)
+        {
+            Even = _mm_movelh_ps(a, b);
+            Odd  = _mm_movehl_ps(b, a);
+        }
+        else
+        {
+            Even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            Odd  = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        }
+    };
+
+    const __m128 Quarter = _mm_set1_ps(0.25f);
+
+    Uint32 col = 0;
+    for (; col + TexelsPerIter <= CoarseMipWidth; col += TexelsPerIter)
+    {
+        __m128 Even0, Odd0, Even1, Odd1;
+        LoadEvenOdd(pSrcRow0 + col * 2 * NumChannels, Even0, Odd0);
+        LoadEvenOdd(pSrcRow1 + col * 2 * NumChannels, Even1, Odd1);
+        // Keep the same order of operations as LinearAverage<float>
+        const __m128 Sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(Even0, Odd0), Even1), Odd1);
+        _mm_storeu_ps(pDstRow + col * NumChannels, _mm_mul_ps(Sum, Quarter));
+    }
+    return col;
+}
+
+#endif // DILIGENT_SSE2_ENABLED
+
+#if DILIGENT_AVX2_ENABLED
+
+template <Uint32 NumChannels>
+__m256i AddAdjacentTexelsAVX2(__m256i Lo, __m256i Hi)
+{
+    // All operations work within 128-bit lanes, see AddAdjacentTexelsSSE2
+    if (NumChannels == 4)
+    {
+        return _mm256_add_epi16(_mm256_unpacklo_epi64(Lo, Hi), _mm256_unpackhi_epi64(Lo, Hi));
+    }
+    else if (NumChannels == 2)
+    {
+        const __m256 LoPS = _mm256_castsi256_ps(Lo);
+        const __m256 HiPS = _mm256_castsi256_ps(Hi);
+        return _mm256_add_epi16(_mm256_castps_si256(_mm256_shuffle_ps(LoPS, HiPS, _MM_SHUFFLE(2, 0, 2, 0))),
+                                _mm256_castps_si256(_mm256_shuffle_ps(LoPS, HiPS, _MM_SHUFFLE(3, 1, 3, 1))));
+    }
+    else
+    {
+        const __m256i Mask = _mm256_set1_epi32(0xFFFF);
+        return _mm256_add_epi16(_mm256_packs_epi32(_mm256_and_si256(Lo, Mask), _mm256_and_si256(Hi, Mask)),
+                                _mm256_packs_epi32(_mm256_srli_epi32(Lo, 16), _mm256_srli_epi32(Hi, 16)));
+    }
+}
+
+template <Uint32 NumChannels>
+Uint32 BoxAverageRowUint8(const void* pSrcRow0, const void* pSrcRow1, void* pDstRow, Uint32 CoarseMipWidth)
+{
+    const Uint8* pSrc0 = static_cast<const Uint8*>(pSrcRow0);
+    const Uint8* pSrc1 = static_cast<const Uint8*>(pSrcRow1);
+    Uint8*       pDst  = static_cast<Uint8*>(pDstRow);
+
+    // 32 fine bytes produce 16 coarse bytes
+    constexpr Uint32 TexelsPerIter = 16 / NumChannels;
+
+    const __m256i Zero = _mm256_setzero_si256();
+
+    Uint32 col = 0;
+    for (; col + TexelsPerIter <= CoarseMipWidth; col += TexelsPerIter)
+    {
+        const __m256i Row0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc0 + col * 2 * NumChannels));
+        const __m256i Row1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc1 + col * 2 * NumChannels));
+
+        const __m256i Lo  = _mm256_add_epi16(_mm256_unpacklo_epi8(Row0, Zero), _mm256_unpacklo_epi8(Row1, Zero));
+        const __m256i Hi  = _mm256_add_epi16(_mm256_unpackhi_epi8(Row0, Zero), _mm256_unpackhi_epi8(Row1, Zero));
+        const __m256i Avg = _mm256_srli_epi16(AddAdjacentTexelsAVX2<NumChannels>(Lo, Hi), 2);
+        // Each lane contains its 8 results twice: gather the first copies in the lower 128 bits
+        const __m256i Res = _mm256_permute4x64_epi64(_mm256_packus_epi16(Avg, Avg), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + col * NumChannels), _mm256_castsi256_si128(Res));
+    }
+
+    return BoxAverageRowUint8SSE2<NumChannels>(pSrc0, pSrc1, pDst, CoarseMipWidth, col);
+}
+
+#elif DILIGENT_SSE2_ENABLED
+
+template <Uint32 NumChannels>
+Uint32 BoxAverageRowUint8(const void* pSrcRow0, const void* pSrcRow1, void* pDstRow, Uint32 CoarseMipWidth)
+{
+    return BoxAverageRowUint8SSE2<NumChannels>(static_cast<const Uint8*>(pSrcRow0), static_cast<const Uint8*>(pSrcRow1), static_cast<Uint8*>(pDstRow), CoarseMipWidth, 0);
+}
+
+#elif DILIGENT_NEON_ENABLED
+
+template <Uint32 NumChannels>
+uint8x16x2_t LoadEvenOddTexelsNEON(const Uint8* pSrc)
+{
+    uint8x16x2_t EvenOdd;
+    if (NumChannels == 4)
+    {
+        const uint32x4x2_t v = vld2q_u32(reinterpret_cast<const uint32_t*>(pSrc));
+        EvenOdd.val[0]       = vreinterpretq_u8_u32(v.val[0]);
+        EvenOdd.val[1]       = vreinterpretq_u8_u32(v.val[1]);
+    }
+    else if (NumChannels == 2)
+    {
+        const uint16x8x2_t v = vld2q_u16(reinterpret_cast<const uint16_t*>(pSrc));
+        EvenOdd.val[0]       = vreinterpretq_u8_u16(v.val[0]);
+        EvenOdd.val[1]       = vreinterpretq_u8_u16(v.val[1]);
+    }
+    else
+    {
+        EvenOdd = vld2q_u8(pSrc);
+    }
+    return EvenOdd;
+}
+
+template <Uint32 NumChannels>
+Uint32 BoxAverageRowUint8(const void* pSrcRow0, const void* pSrcRow1, void* pDstRow, Uint32 CoarseMipWidth)
+{
+    const Uint8* pSrc0 = static_cast<const Uint8*>(pSrcRow0);
+    const Uint8* pSrc1 = static_cast<const Uint8*>(pSrcRow1);
+    Uint8*       pDst  = static_cast<Uint8*>(pDstRow);
+
+    // 32 fine bytes produce 16 coarse bytes
+    constexpr Uint32 TexelsPerIter = 16 / NumChannels;
+
+    Uint32 col = 0;
+    for (; col + TexelsPerIter <= CoarseMipWidth; col += TexelsPerIter)
+    {
+        const uint8x16x2_t Row0 = LoadEvenOddTexelsNEON<NumChannels>(pSrc0 + col * 2 * NumChannels);
+        const uint8x16x2_t Row1 = LoadEvenOddTexelsNEON<NumChannels>(pSrc1 + col * 2 * NumChannels);
+
+        const uint16x8_t Lo = vaddq_u16(vaddl_u8(vget_low_u8(Row0.val[0]), vget_low_u8(Row0.val[1])),
+                                        vaddl_u8(vget_low_u8(Row1.val[0]), vget_low_u8(Row1.val[1])));
+        const uint16x8_t Hi = vaddq_u16(vaddl_u8(vget_high_u8(Row0.val[0]), vget_high_u8(Row0.val[1])),
+                                        vaddl_u8(vget_high_u8(Row1.val[0]), vget_high_u8(Row1.val[1])));
+        vst1q_u8(pDst + col * NumChannels, vcombine_u8(vshrn_n_u16(Lo, 2), vshrn_n_u16(Hi, 2)));
+    }
+    return col;
+}
+
+template <Uint32 NumChannels>
+void LoadEvenOddTexelsNEON(const float* pSrc, float32x4_t& Even, float32x4_t& Odd)
+{
+    if (NumChannels == 4)
+    {
+        Even = vld1q_f32(pSrc);
+        Odd  = vld1q_f32(pSrc + 4);
+    }
+    else if (NumChannels == 2)
+    {
+        const float32x4_t a = vld1q_f32(pSrc);
+        const float32x4_t b = vld1q_f32(pSrc + 4);
+        Even                = vcombine_f32(vget_low_f32(a), vget_low_f32(b));
+        Odd                 = vcombine_f32(vget_high_f32(a), vget_high_f32(b));
+    }
+    else
+    {
+        const float32x4x2_t v = vld2q_f32(pSrc);
+        Even                  = v.val[0];
+        Odd                   = v.val[1];
+    }
+}
+
+#endif
+
+template <Uint32 NumChannels>
+Uint32 BoxAverageRowFloat(const void* pSrcRow0, const void* pSrcRow1, void* pDstRow, Uint32 CoarseMipWidth)
+{
+    const float* pSrc0 = static_cast<const float*>(pSrcRow0);
+    const float* pSrc1 = static_cast<const float*>(pSrcRow1);
+    float*       pDst  = static_cast<float*>(pDstRow);
+#if DILIGENT_SSE2_ENABLED
+    return BoxAverageRowFloatSSE2<NumChannels>(pSrc0, pSrc1, pDst, CoarseMipWidth);
+#elif DILIGENT_NEON_ENABLED
+    // 8 fine values produce 4 coarse values
+    constexpr Uint32 TexelsPerIter = 4 / NumChannels;
+
+    Uint32 col = 0;
+    for (; col + TexelsPerIter <= CoarseMipWidth; col += TexelsPerIter)
+    {
+        float32x4_t Even0, Odd0, Even1, Odd1;
+        LoadEvenOddTexelsNEON<NumChannels>(pSrc0 + col * 2 * NumChannels, Even0, Odd0);
+        LoadEvenOddTexelsNEON<NumChannels>(pSrc1 + col * 2 * NumChannels, Even1, Odd1);
+        // Keep the same order of operations as LinearAverage<float>
+        const float32x4_t Sum = vaddq_f32(vaddq_f32(vaddq_f32(Even0, Odd0), Even1), Odd1);
+        vst1q_f32(pDst + col * NumChannels, vmulq_n_f32(Sum, 0.25f));
+    }
+    return col;
+#else
+    (void)pSrc0;
+    (void)pSrc1;
+    (void)pDst;
+    (void)CoarseMipWidth;
+    return 0;
+#endif
+}
+
+// Averages 8-bit sRGB texels using a lookup table for the sRGB-to-linear conversion.
+// The table is populated with the same values that SRGBAverage<Uint8> computes.
+Uint32 SRGBAverageRowUint8(const void* pSrcRow0, const void* pSrcRow1, void* pDstRow, Uint32 CoarseMipWidth, Uint32 NumChannels)
+{
+    static constexpr float MaxVal    = 255.f;
+    static constexpr float MaxValInv = 1.f / MaxVal;
+
+    static const auto SRGBToLinearLUT = []() {
+        std::array<float, 256> LUT{};
+        for (Uint32 i = 0; i < LUT.size(); ++i)
+            LUT[i] = FastSRGBToLinear(static_cast<float>(i) * MaxValInv);
+        return LUT;
+    }();
+
+    const Uint8* pSrc0 = static_cast<const Uint8*>(pSrcRow0);
+    const Uint8* pSrc1 = static_cast<const Uint8*>(pSrcRow1);
+    Uint8*       pDst  = static_cast<Uint8*>(pDstRow);
+    for (Uint32 col = 0; col < CoarseMipWidth; ++col)
+    {
+        for (Uint32 c = 0; c < NumChannels; ++c)
+        {
+            const float fLinearAverage = (SRGBToLinearLUT[pSrc0[(col * 2 + 0) * NumChannels + c]] +
+                                          SRGBToLinearLUT[pSrc0[(col * 2 + 1) * NumChannels + c]] +
+                                          SRGBToLinearLUT[pSrc1[(col * 2 + 0) * NumChannels + c]] +
+                                          SRGBToLinearLUT[pSrc1[(col * 2 + 1) * NumChannels + c]]) *
+                0.25f;
+
+            float fSRGBAverage = FastLinearToSRGB(fLinearAverage) * MaxVal;
+            fSRGBAverage       = std::max(fSRGBAverage, 0.f);
+            fSRGBAverage       = std::min(fSRGBAverage, MaxVal);
+
+            pDst[col * NumChannels + c] = static_cast<Uint8>(fSRGBAverage);
+        }
+    }
+    return CoarseMipWidth;
+}
+
+template <Uint32 NumChannels>
+Uint32 SRGBAverageRowUint8(const void* pSrcRow0, const void* pSrcRow1, void* pDstRow, Uint32 CoarseMipWidth)
+{
+    return SRGBAverageRowUint8(pSrcRow0, pSrcRow1, pDstRow, CoarseMipWidth, NumChannels);
+}
+
+template <typename ChannelType>
+FilterMipRowKernelType GetBoxAverageRowKernel(Uint32 /*NumChannels*/)
+{
+    return nullptr;
+}
+
+template <>
+FilterMipRowKernelType GetBoxAverageRowKernel<Uint8>(Uint32 NumChannels)
+{
+#if DILIGENT_SSE2_ENABLED || DILIGENT_NEON_ENABLED
+    switch (NumChannels)
+    {
+        case 1: return BoxAverageRowUint8<1>;
+        case 2: return BoxAverageRowUint8<2>;
+        case 4: return BoxAverageRowUint8<4>;
+        default: return nullptr;
+    }
+#else
+    (void)NumChannels;
+    return nullptr;
+#endif
+}
+
+template <>
+FilterMipRowKernelType GetBoxAverageRowKernel<Float32>(Uint32 NumChannels)
+{
+#if DILIGENT_SSE2_ENABLED || DILIGENT_NEON_ENABLED
+    switch (NumChannels)
+    {
+        case 1: return BoxAverageRowFloat<1>;
+        case 2: return BoxAverageRowFloat<2>;
+        case 4: return BoxAverageRowFloat<4>;
+        default: return nullptr;
+    }
+#else
+    (void)NumChannels;
+    return nullptr;
+#endif
+}
+
+FilterMipRowKernelType GetSRGBAverageRowKernel(Uint32 NumChannels)
+{
+    switch (NumChannels)
+    {
+        case 1: return SRGBAverageRowUint8<1>;
+        case 2: return SRGBAverageRowUint8<2>;
+        case 3: return SRGBAverageRowUint8<3>;
+        case 4: return SRGBAverageRowUint8<4>;
+        default: return nullptr;
+    }
+}
+
+Uint32 GetCoarseMipDimension(Uint32 FineMipDim)
+{
+    return std::max(FineMipDim / Uint32{2}, Uint32{1});
+}
+
+// Filters coarse mip level rows [RowStart, RowEnd)
 template <typename ChannelType,
           typename FilterType>
 void FilterMipLevel(const ComputeMipLevelAttribs& Attribs,
                     Uint32                        NumChannels,
-                    FilterType                    Filter)
+                    FilterType                    Filter,
+                    Uint32                        RowStart,
+                    Uint32                        RowEnd,
+                    FilterMipRowKernelType        RowKernel = nullptr)
 {
     VERIFY_EXPR(Attribs.FineMipWidth > 0 && Attribs.FineMipHeight > 0);
     DEV_CHECK_ERR(Attribs.FineMipHeight == 1 || Attribs.FineMipStride >= Attribs.FineMipWidth * sizeof(ChannelType) * NumChannels, "Fine mip level stride is too small");
 
-    const auto CoarseMipWidth  = std::max(Attribs.FineMipWidth / Uint32{2}, Uint32{1});
-    const auto CoarseMipHeight = std::max(Attribs.FineMipHeight / Uint32{2}, Uint32{1});
+    const auto CoarseMipWidth = GetCoarseMipDimension(Attribs.FineMipWidth);
+
+    VERIFY(GetCoarseMipDimension(Attribs.FineMipHeight) == 1 || Attribs.CoarseMipStride >= CoarseMipWidth * sizeof(ChannelType) * NumChannels, "Coarse mip level stride is too small");
+    VERIFY_EXPR(RowStart <= RowEnd && RowEnd <= GetCoarseMipDimension(Attribs.FineMipHeight));
 
-    VERIFY(CoarseMipHeight == 1 || Attribs.CoarseMipStride >= CoarseMipWidth * sizeof(ChannelType) * NumChannels, "Coarse mip level stride is too small");
+    if (Attribs.FineMipWidth < 2)
+        RowKernel = nullptr;
 
-    for (Uint32 row = 0; row < CoarseMipHeight; ++row)
+    for (Uint32 row = RowStart; row < RowEnd; ++row)
     {
         auto src_row0 = row * 2;
         auto src_row1 = std::min(row * 2 + 1, Attribs.FineMipHeight - 1);
 
         auto pSrcRow0 = reinterpret_cast<const ChannelType*>(reinterpret_cast<const Uint8*>(Attribs.pFineMipData) + src_row0 * Attribs.FineMipStride);
         auto pSrcRow1 = reinterpret_cast<const ChannelType*>(reinterpret_cast<const Uint8*>(Attribs.pFineMipData) + src_row1 * Attribs.FineMipStride);
+        auto pDstRow  = reinterpret_cast<ChannelType*>(reinterpret_cast<Uint8*>(Attribs.pCoarseMipData) + row * Attribs.CoarseMipStride);
 
-        for (Uint32 col = 0; col < CoarseMipWidth; ++col)
+        Uint32 col = RowKernel != nullptr ? RowKernel(pSrcRow0, pSrcRow1, pDstRow, CoarseMipWidth) : 0;
+        for (; col < CoarseMipWidth; ++col)
         {
             auto src_col0 = col * 2;
             auto src_col1 = std::min(col * 2 + 1, Attribs.FineMipWidth - 1);
@@ -316,9 +694,7 @@ void FilterMipLevel(const ComputeMipLevelAttribs& Attribs,
                 const auto Chnl01 = pSrcRow1[src_col0 * NumChannels + c];
                 const auto Chnl11 = pSrcRow1[src_col1 * NumChannels + c];
 
-                auto& DstCol = reinterpret_cast<ChannelType*>(reinterpret_cast<Uint8*>(Attribs.pCoarseMipData) + row * Attribs.CoarseMipStride)[col * NumChannels + c];
-
-                DstCol = Filter(Chnl00, Chnl10, Chnl01, Chnl11, col, row);
+                pDstRow[col * NumChannels + c] = Filter(Chnl00, Chnl10, Chnl01, Chnl11, col, row);
             }
         }
     }
@@ -326,11 +702,12 @@ void FilterMipLevel(const ComputeMipLevelAttribs& Attribs,
 
 void RemapAlpha(const ComputeMipLevelAttribs& Attribs,
                 Uint32                        NumChannels,
-                Uint32                        AlphaChannelInd)
+                Uint32                        AlphaChannelInd,
+                Uint32                        RowStart,
+                Uint32                        RowEnd)
 {
-    const auto CoarseMipWidth  = std::max(Attribs.FineMipWidth / Uint32{2}, Uint32{1});
-    const auto CoarseMipHeight = std::max(Attribs.FineMipHeight / Uint32{2}, Uint32{1});
-    for (Uint32 row = 0; row < CoarseMipHeight; ++row)
+    const auto CoarseMipWidth = GetCoarseMipDimension(Attribs.FineMipWidth);
+    for (Uint32 row = RowStart; row < RowEnd; ++row)
     {
         for (Uint32 col = 0; col < CoarseMipWidth; ++col)
         {
@@ -351,7 +728,9 @@ void RemapAlpha(const ComputeMipLevelAttribs& Attribs,
 
 template <typename ChannelType>
 void ComputeMipLevelInternal(const ComputeMipLevelAttribs& Attribs,
-                             const TextureFormatAttribs&   FmtAttribs)
+                             const TextureFormatAttribs&   FmtAttribs,
+                             Uint32                        RowStart,
+                             Uint32                        RowEnd)
 {
     auto FilterType = Attribs.FilterType;
     if (FilterType == MIP_FILTER_TYPE_DEFAULT)
@@ -361,37 +740,34 @@ void ComputeMipLevelInternal(const ComputeMipLevelAttribs& Attribs,
             MIP_FILTER_TYPE_BOX_AVERAGE;
     }
 
-    FilterMipLevel<ChannelType>(Attribs, FmtAttribs.NumComponents,
-                                FilterType == MIP_FILTER_TYPE_BOX_AVERAGE ?
-                                    LinearAverage<ChannelType> :
-                                    MostFrequentSelector<ChannelType>);
+    if (FilterType == MIP_FILTER_TYPE_BOX_AVERAGE)
+    {
+        FilterMipLevel<ChannelType>(Attribs, FmtAttribs.NumComponents, LinearAverage<ChannelType>, RowStart, RowEnd,
+                                    GetBoxAverageRowKernel<ChannelType>(FmtAttribs.NumComponents));
+    }
+    else
+    {
+        FilterMipLevel<ChannelType>(Attribs, FmtAttribs.NumComponents, MostFrequentSelector<ChannelType>, RowStart, RowEnd);
+    }
 }
 
-void ComputeMipLevel(const ComputeMipLevelAttribs& Attribs)
+// Computes coarse mip level rows [RowStart, RowEnd)
+void ComputeMipLevelRows(const ComputeMipLevelAttribs& Attribs,
+                         const TextureFormatAttribs&   FmtAttribs,
+                         Uint32                        RowStart,
+                         Uint32                        RowEnd)
 {
-    DEV_CHECK_ERR(Attribs.Format != TEX_FORMAT_UNKNOWN, "Format must not be unknown");
-    DEV_CHECK_ERR(Attribs.FineMipWidth != 0, "Fine mip width must not be zero");
-    DEV_CHECK_ERR(Attribs.FineMipHeight != 0, "Fine mip height must not be zero");
-    DEV_CHECK_ERR(Attribs.pFineMipData != nullptr, "Fine level data must not be null");
-    DEV_CHECK_ERR(Attribs.pCoarseMipData != nullptr, "Coarse level data must not be null");
-
-    const auto& FmtAttribs = GetTextureFormatAttribs(Attribs.Format);
-
-    VERIFY_EXPR(Attribs.AlphaCutoff >= 0 && Attribs.AlphaCutoff <= 1);
-    VERIFY(Attribs.AlphaCutoff == 0 || FmtAttribs.NumComponents == 4 && FmtAttribs.ComponentSize == 1,
-           "Alpha remapping is only supported for 4-channel 8-bit textures");
-
     switch (FmtAttribs.ComponentType)
     {
         case COMPONENT_TYPE_UNORM_SRGB:
             VERIFY(FmtAttribs.ComponentSize == 1, "Only 8-bit sRGB formats are expected");
-            FilterMipLevel<Uint8>(Attribs, FmtAttribs.NumComponents,
-                                  Attribs.FilterType == MIP_FILTER_TYPE_MOST_FREQUENT ?
-                                      MostFrequentSelector<Uint8> :
-                                      SRGBAverage<Uint8>);
+            if (Attribs.FilterType == MIP_FILTER_TYPE_MOST_FREQUENT)
+                FilterMipLevel<Uint8>(Attribs, FmtAttribs.NumComponents, MostFrequentSelector<Uint8>, RowStart, RowEnd);
+            else
+                FilterMipLevel<Uint8>(Attribs, FmtAttribs.NumComponents, SRGBAverage<Uint8>, RowStart, RowEnd, GetSRGBAverageRowKernel(FmtAttribs.NumComponents));
             if (Attribs.AlphaCutoff > 0)
             {
-                RemapAlpha(Attribs, FmtAttribs.NumComponents, FmtAttribs.NumComponents - 1);
+                RemapAlpha(Attribs, FmtAttribs.NumComponents, FmtAttribs.NumComponents - 1, RowStart, RowEnd);
             }
             break;
 
@@ -400,19 +776,19 @@ void ComputeMipLevel(const ComputeMipLevelAttribs& Attribs)
             switch (FmtAttribs.ComponentSize)
             {
                 case 1:
-                    ComputeMipLevelInternal<Uint8>(Attribs, FmtAttribs);
+                    ComputeMipLevelInternal<Uint8>(Attribs, FmtAttribs, RowStart, RowEnd);
                     if (Attribs.AlphaCutoff > 0)
                     {
-                        RemapAlpha(Attribs, FmtAttribs.NumComponents, FmtAttribs.NumComponents - 1);
+                        RemapAlpha(Attribs, FmtAttribs.NumComponents, FmtAttribs.NumComponents - 1, RowStart, RowEnd);
                     }
                     break;
 
                 case 2:
-                    ComputeMipLevelInternal<Uint16>(Attribs, FmtAttribs);
+                    ComputeMipLevelInternal<Uint16>(Attribs, FmtAttribs, RowStart, RowEnd);
                     break;
 
                 case 4:
-                    ComputeMipLevelInternal<Uint32>(Attribs, FmtAttribs);
+                    ComputeMipLevelInternal<Uint32>(Attribs, FmtAttribs, RowStart, RowEnd);
                     break;
 
                 default:
@@ -425,15 +801,15 @@ void ComputeMipLevel(const ComputeMipLevelAttribs& Attribs)
             switch (FmtAttribs.ComponentSize)
             {
                 case 1:
-                    ComputeMipLevelInternal<Int8>(Attribs, FmtAttribs);
+                    ComputeMipLevelInternal<Int8>(Attribs, FmtAttribs, RowStart, RowEnd);
                     break;
 
                 case 2:
-                    ComputeMipLevelInternal<Int16>(Attribs, FmtAttribs);
+                    ComputeMipLevelInternal<Int16>(Attribs, FmtAttribs, RowStart, RowEnd);
                     break;
 
                 case 4:
-                    ComputeMipLevelInternal<Int32>(Attribs, FmtAttribs);
+                    ComputeMipLevelInternal<Int32>(Attribs, FmtAttribs, RowStart, RowEnd);
                     break;
 
                 default:
@@ -443,7 +819,7 @@ void ComputeMipLevel(const ComputeMipLevelAttribs& Attribs)
 
         case COMPONENT_TYPE_FLOAT:
             VERIFY(FmtAttribs.ComponentSize == 4, "Only 32-bit float formats are currently supported");
-            ComputeMipLevelInternal<Float32>(Attribs, FmtAttribs);
+            ComputeMipLevelInternal<Float32>(Attribs, FmtAttribs, RowStart, RowEnd);
             break;
 
         default:
@@ -451,6 +827,121 @@ void ComputeMipLevel(const ComputeMipLevelAttribs& Attribs)
     }
 }
 
+void ComputeMipLevel(const ComputeMipLevelAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.Format != TEX_FORMAT_UNKNOWN, "Format must not be unknown");
+    DEV_CHECK_ERR(Attribs.FineMipWidth != 0, "Fine mip width must not be zero");
+    DEV_CHECK_ERR(Attribs.FineMipHeight != 0, "Fine mip height must not be zero");
+    DEV_CHECK_ERR(Attribs.pFineMipData != nullptr, "Fine level data must not be null");
+    DEV_CHECK_ERR(Attribs.pCoarseMipData != nullptr, "Coarse level data must not be null");
+
+    const auto& FmtAttribs = GetTextureFormatAttribs(Attribs.Format);
+
+    VERIFY_EXPR(Attribs.AlphaCutoff >= 0 && Attribs.AlphaCutoff <= 1);
+    VERIFY(Attribs.AlphaCutoff == 0 || (FmtAttribs.NumComponents == 4 && FmtAttribs.ComponentSize == 1),
+           "Alpha remapping is only supported for 4-channel 8-bit textures");
+
+    ComputeMipLevelRows(Attribs, FmtAttribs, 0, GetCoarseMipDimension(Attribs.FineMipHeight));
+}
+
+void ComputeMipChain(const ComputeMipChainAttribs& Attribs, IThreadPool* pThreadPool)
+{
+    DEV_CHECK_ERR(Attribs.Format != TEX_FORMAT_UNKNOWN, "Format must not be unknown");
+    DEV_CHECK_ERR(Attribs.Width != 0, "Width must not be zero");
+    DEV_CHECK_ERR(Attribs.Height != 0, "Height must not be zero");
+    DEV_CHECK_ERR(Attribs.MipLevels != 0, "The number of mip levels must not be zero");
+    DEV_CHECK_ERR(Attribs.ppMipData != nullptr, "Mip data pointers must not be null");
+    DEV_CHECK_ERR(Attribs.pMipStrides != nullptr, "Mip strides must not be null");
+    if (Attribs.MipLevels < 2)
+        return;
+
+    const auto& FmtAttribs = GetTextureFormatAttribs(Attribs.Format);
+
+    VERIFY_EXPR(Attribs.AlphaCutoff >= 0 && Attribs.AlphaCutoff <= 1);
+    VERIFY(Attribs.AlphaCutoff == 0 || (FmtAttribs.NumComponents == 4 && FmtAttribs.ComponentSize == 1),
+           "Alpha remapping is only supported for 4-channel 8-bit textures");
+
+    std::vector<Uint32> MipHeights(Attribs.MipLevels);
+    std::vector<Uint32> MipWidths(Attribs.MipLevels);
+    MipWidths[0]  = Attribs.Width;
+    MipHeights[0] = Attribs.Height;
+    for (Uint32 mip = 0; mip < Attribs.MipLevels; ++mip)
+    {
+        DEV_CHECK_ERR(Attribs.ppMipData[mip] != nullptr, "Data pointer for mip level ", mip, " must not be null");
+        if (mip > 0)
+        {
+            MipWidths[mip]  = GetCoarseMipDimension(MipWidths[mip - 1]);
+            MipHeights[mip] = GetCoarseMipDimension(MipHeights[mip - 1]);
+        }
+    }
+
+    // Levels are processed in groups of up to MaxBandLevels levels. Every group is split into
+    // horizontal bands, where each band covers one row of the last level in the group and
+    // the rows of the finer levels that this row depends on. The band computes all levels
+    // of the group top to bottom, so the data of one level is still in the cache when
+    // the next level consumes it. The bands are independent and are processed in parallel.
+    // The last band also includes the rows of finer levels that are not referenced by the
+    // last level in the group (this happens when the level height is odd).
+    constexpr Uint32 MaxBandLevels = 4;
+
+    const auto ProcessBand = [&](Uint32 BaseMip, Uint32 NumBandLevels, Uint32 Band) {
+        const auto LastMip = BaseMip + NumBandLevels;
+        const bool IsLast  = Band + 1 == MipHeights[LastMip];
+        for (Uint32 mip = BaseMip + 1; mip <= LastMip; ++mip)
+        {
+            const auto Shift    = LastMip - mip;
+            const auto RowStart = Band << Shift;
+            const auto RowEnd   = IsLast ? MipHeights[mip] : (Band + 1) << Shift;
+
+            ComputeMipLevelAttribs LevelAttribs;
+            LevelAttribs.Format          = Attribs.Format;
+            LevelAttribs.FineMipWidth    = MipWidths[mip - 1];
+            LevelAttribs.FineMipHeight   = MipHeights[mip - 1];
+            LevelAttribs.pFineMipData    = Attribs.ppMipData[mip - 1];
+            LevelAttribs.FineMipStride   = Attribs.pMipStrides[mip - 1];
+            LevelAttribs.pCoarseMipData  = Attribs.ppMipData[mip];
+            LevelAttribs.CoarseMipStride = Attribs.pMipStrides[mip];
+            LevelAttribs.FilterType      = Attribs.FilterType;
+            LevelAttribs.AlphaCutoff     = Attribs.AlphaCutoff;
+            ComputeMipLevelRows(LevelAttribs, FmtAttribs, RowStart, RowEnd);
+        }
+    };
+
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    for (Uint32 BaseMip = 0; BaseMip + 1 < Attribs.MipLevels;)
+    {
+        const auto NumBandLevels = std::min(Attribs.MipLevels - 1 - BaseMip, MaxBandLevels);
+        const auto NumBands      = MipHeights[BaseMip + NumBandLevels];
+        if (pThreadPool != nullptr && NumBands > 1)
+        {
+            Tasks.reserve(NumBands);
+            for (Uint32 Band = 0; Band < NumBands; ++Band)
+            {
+                Tasks.emplace_back(EnqueueAsyncWork(pThreadPool,
+                                                    [&ProcessBand, BaseMip, NumBandLevels, Band](Uint32) //
+                                                    {
+                                                        ProcessBand(BaseMip, NumBandLevels, Band);
+                                                    }));
+            }
+
+            for (auto& pTask : Tasks)
+                pTask->WaitForCompletion();
+            Tasks.clear();
+        }
+        else
+        {
+            for (Uint32 Band = 0; Band < NumBands; ++Band)
+                ProcessBand(BaseMip, NumBandLevels, Band);
+        }
+        BaseMip += NumBandLevels;
+    }
+}
+
+void ComputeMipChain(const ComputeMipChainAttribs& Attribs)
+{
+    ComputeMipChain(Attribs, nullptr);
+}
+
 } // namespace Diligent
 
 
@@ -483,4 +974,9 @@ extern "C"
     {
         Diligent::ComputeMipLevel(Attribs);
     }
+
+    void Diligent_ComputeMipChain(const Diligent::ComputeMipChainAttribs& Attribs)
+    {
+        Diligent::ComputeMipChain(Attribs);
+    }
 }
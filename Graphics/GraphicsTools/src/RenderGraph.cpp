@@ -0,0 +1,885 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "RenderGraph.hpp"
+
+#include <algorithm>
+
+#include "DebugUtilities.hpp"
+#include "GraphicsAccessories.hpp"
+#include "Align.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+constexpr RESOURCE_STATE WritableStates =
+    RESOURCE_STATE_RENDER_TARGET |
+    RESOURCE_STATE_UNORDERED_ACCESS |
+    RESOURCE_STATE_DEPTH_WRITE |
+    RESOURCE_STATE_STREAM_OUT |
+    RESOURCE_STATE_COPY_DEST |
+    RESOURCE_STATE_RESOLVE_DEST |
+    RESOURCE_STATE_BUILD_AS_WRITE;
+
+bool IsReadOnlyState(RESOURCE_STATE State)
+{
+    return (State & WritableStates) == 0;
+}
+
+// Returns true if the state can be used in a context of the given type.
+// Must be consistent with VerifyResourceState() in DeviceContextBase.cpp.
+bool IsStateSupportedByQueue(RESOURCE_STATE State, COMMAND_QUEUE_TYPE QueueType)
+{
+    constexpr RESOURCE_STATE TransferStates =
+        RESOURCE_STATE_UNDEFINED |
+        RESOURCE_STATE_COPY_DEST |
+        RESOURCE_STATE_COPY_SOURCE |
+        RESOURCE_STATE_COMMON;
+
+    constexpr RESOURCE_STATE ComputeStates =
+        TransferStates |
+        RESOURCE_STATE_CONSTANT_BUFFER |
+        RESOURCE_STATE_UNORDERED_ACCESS |
+        RESOURCE_STATE_SHADER_RESOURCE |
+        RESOURCE_STATE_INDIRECT_ARGUMENT |
+        RESOURCE_STATE_BUILD_AS_READ |
+        RESOURCE_STATE_BUILD_AS_WRITE |
+        RESOURCE_STATE_RAY_TRACING;
+
+    QueueType &= COMMAND_QUEUE_TYPE_PRIMARY_MASK;
+    if ((QueueType & COMMAND_QUEUE_TYPE_GRAPHICS) == COMMAND_QUEUE_TYPE_GRAPHICS)
+        return true;
+    else if ((QueueType & COMMAND_QUEUE_TYPE_COMPUTE) == COMMAND_QUEUE_TYPE_COMPUTE)
+        return (State & ~ComputeStates) == 0;
+    else if ((QueueType & COMMAND_QUEUE_TYPE_TRANSFER) == COMMAND_QUEUE_TYPE_TRANSFER)
+        return (State & ~TransferStates) == 0;
+    else
+        return false;
+}
+
+} // namespace
+
+RenderGraph::RenderGraph(const RenderGraphCreateInfo& CreateInfo) :
+    m_Name{CreateInfo.Name != nullptr ? CreateInfo.Name : "Render graph"}
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+}
+
+Uint32 RenderGraph::ImportTexture(ITexture* pTexture)
+{
+    DEV_CHECK_ERR(pTexture != nullptr, "Texture must not be null");
+    DEV_CHECK_ERR(!m_IsCompiled, "Resources can't be added to a compiled render graph");
+
+    ResourceInfo Res;
+    Res.pTexture  = pTexture;
+    Res.IsTexture = true;
+    m_Resources.emplace_back(std::move(Res));
+    return static_cast<Uint32>(m_Resources.size() - 1);
+}
+
+Uint32 RenderGraph::ImportBuffer(IBuffer* pBuffer)
+{
+    DEV_CHECK_ERR(pBuffer != nullptr, "Buffer must not be null");
+    DEV_CHECK_ERR(!m_IsCompiled, "Resources can't be added to a compiled render graph");
+
+    ResourceInfo Res;
+    Res.pBuffer = pBuffer;
+    m_Resources.emplace_back(std::move(Res));
+    return static_cast<Uint32>(m_Resources.size() - 1);
+}
+
+Uint32 RenderGraph::CreateTexture(const TextureDesc& Desc)
+{
+    DEV_CHECK_ERR(!m_IsCompiled, "Resources can't be added to a compiled render graph");
+
+    ResourceInfo Res;
+    Res.IsTexture     = true;
+    Res.IsTransient   = true;
+    Res.TransientDesc = Desc;
+    Res.TransientName = Desc.Name != nullptr ?
+        Desc.Name :
+        m_Name + " - transient texture " + std::to_string(m_Resources.size());
+    // The name is set when the texture is created as the string may be moved
+    Res.TransientDesc.Name = nullptr;
+    m_Resources.emplace_back(std::move(Res));
+    return static_cast<Uint32>(m_Resources.size() - 1);
+}
+
+void RenderGraph::MarkOutput(Uint32 Resource, RESOURCE_STATE FinalState)
+{
+    DEV_CHECK_ERR(Resource < m_Resources.size(), "Resource handle ", Resource, " is out of range");
+    DEV_CHECK_ERR(!m_IsCompiled, "Outputs can't be added to a compiled render graph");
+    DEV_CHECK_ERR(FinalState != RESOURCE_STATE_UNDEFINED, "Final state must not be RESOURCE_STATE_UNDEFINED");
+
+    auto& Res      = m_Resources[Resource];
+    Res.IsOutput   = true;
+    Res.FinalState = FinalState;
+}
+
+Uint32 RenderGraph::AddPass(const char* Name, Uint32 ContextIndex, PassCallbackType Callback, bool NeverCull)
+{
+    DEV_CHECK_ERR(!m_IsCompiled, "Passes can't be added to a compiled render graph");
+
+    PassInfo Pass;
+    Pass.Name         = Name != nullptr ? Name : "Pass " + std::to_string(m_Passes.size());
+    Pass.ContextIndex = ContextIndex;
+    Pass.Callback     = std::move(Callback);
+    Pass.NeverCull    = NeverCull;
+    m_Passes.emplace_back(std::move(Pass));
+    return static_cast<Uint32>(m_Passes.size() - 1);
+}
+
+void RenderGraph::Read(Uint32 Pass, Uint32 Resource, RESOURCE_STATE State)
+{
+    AddAccess(Pass, Resource, State, false);
+}
+
+void RenderGraph::Write(Uint32 Pass, Uint32 Resource, RESOURCE_STATE State)
+{
+    AddAccess(Pass, Resource, State, true);
+}
+
+void RenderGraph::AddAccess(Uint32 Pass, Uint32 Resource, RESOURCE_STATE State, bool IsWrite)
+{
+    DEV_CHECK_ERR(!m_IsCompiled, "Resource accesses can't be added to a compiled render graph");
+    DEV_CHECK_ERR(Pass < m_Passes.size(), "Pass handle ", Pass, " is out of range");
+    DEV_CHECK_ERR(Resource < m_Resources.size(), "Resource handle ", Resource, " is out of range");
+    DEV_CHECK_ERR(State != RESOURCE_STATE_UNKNOWN && State != RESOURCE_STATE_UNDEFINED, "Access state must not be UNKNOWN or UNDEFINED");
+
+    const auto& Res = m_Resources[Resource];
+    (void)Res;
+    DEV_CHECK_ERR(!Res.IsTexture || IsPowerOfTwo(static_cast<Uint32>(State)),
+                  "Texture state ", GetResourceStateString(State), " declared by pass '", m_Passes[Pass].Name, "' must consist of a single flag");
+    DEV_CHECK_ERR(!IsWrite || (IsPowerOfTwo(static_cast<Uint32>(State)) && !IsReadOnlyState(State)),
+                  "State ", GetResourceStateString(State), " declared as a write by pass '", m_Passes[Pass].Name, "' is not a writable state");
+    DEV_CHECK_ERR(IsWrite || IsPowerOfTwo(static_cast<Uint32>(State)) || IsReadOnlyState(State),
+                  "State ", GetResourceStateString(State), " declared by pass '", m_Passes[Pass].Name, "' combines read and write states");
+
+    auto& Accesses = m_Passes[Pass].Accesses;
+
+    auto it = std::find_if(Accesses.begin(), Accesses.end(), [Resource](const ResourceAccess& Access) { return Access.Resource == Resource; });
+    if (it == Accesses.end())
+    {
+        Accesses.emplace_back();
+        auto& Access    = Accesses.back();
+        Access.Resource = Resource;
+        Access.State    = State;
+        Access.IsRead   = !IsWrite;
+        Access.IsWrite  = IsWrite;
+        return;
+    }
+
+    if (it->State != State)
+    {
+        // A single barrier is issued for every resource used by the pass, so
+        // different states can only be combined for buffers that are read
+        DEV_CHECK_ERR(!Res.IsTexture, "Pass '", m_Passes[Pass].Name, "' accesses the same texture in different states");
+        DEV_CHECK_ERR(!IsWrite && !it->IsWrite, "Pass '", m_Passes[Pass].Name, "' writes to the buffer and accesses it in a different state");
+        it->State |= State;
+    }
+    it->IsRead  = it->IsRead || !IsWrite;
+    it->IsWrite = it->IsWrite || IsWrite;
+}
+
+void RenderGraph::CullPasses()
+{
+    // Walk the passes backwards and keep a pass alive if it writes a resource version
+    // that is read by a live pass or is an output of the graph.
+    std::vector<bool> IsNeeded(m_Resources.size());
+    for (size_t i = 0; i < m_Resources.size(); ++i)
+        IsNeeded[i] = m_Resources[i].IsOutput;
+
+    for (size_t p = m_Passes.size(); p > 0; --p)
+    {
+        auto& Pass = m_Passes[p - 1];
+
+        Pass.IsCulled = !Pass.NeverCull;
+        for (const auto& Access : Pass.Accesses)
+        {
+            if (Access.IsWrite && IsNeeded[Access.Resource])
+                Pass.IsCulled = false;
+        }
+        if (Pass.IsCulled)
+            continue;
+
+        // The pass produces the version of the resource that the later passes need,
+        // so earlier writes are only needed if this pass reads the resource.
+        for (const auto& Access : Pass.Accesses)
+        {
+            if (Access.IsWrite)
+                IsNeeded[Access.Resource] = false;
+        }
+        for (const auto& Access : Pass.Accesses)
+        {
+            if (Access.IsRead)
+                IsNeeded[Access.Resource] = true;
+        }
+    }
+
+    m_Schedule.clear();
+    for (Uint32 p = 0; p < m_Passes.size(); ++p)
+    {
+        if (!m_Passes[p].IsCulled)
+            m_Schedule.push_back(p);
+        else
+            ++m_Stats.NumCulledPasses;
+    }
+}
+
+void RenderGraph::ComputeBarriers(const std::vector<COMMAND_QUEUE_TYPE>& QueueTypes)
+{
+    const auto NumContexts = static_cast<Uint32>(QueueTypes.size());
+
+    struct ResourceTracker
+    {
+        // The state of the resource after the last access
+        RESOURCE_STATE State = RESOURCE_STATE_UNKNOWN;
+
+        bool   IsUsed            = false;
+        bool   LastAccessIsWrite = false;
+        Uint32 LastPass          = ~0u;
+        Uint32 LastWritePass     = ~0u;
+
+        // The last pass in every context that accessed the resource since the last write
+        std::vector<Uint32> LastContextAccess;
+
+        // The barrier that transitioned the resource to the current state, and the context
+        // it is executed in. Read states of buffers are merged into this barrier.
+        std::vector<Barrier>* pTransitionList     = nullptr;
+        size_t                TransitionIdx       = 0;
+        Uint32                TransitionContext   = ~0u;
+        bool                  UsedByOtherContexts = false;
+    };
+
+    std::vector<ResourceTracker> Trackers(m_Resources.size());
+    for (auto& Tracker : Trackers)
+        Tracker.LastContextAccess.resize(NumContexts, ~0u);
+
+    // The index of every live pass among the live passes of its context
+    std::vector<Uint32> ContextPassIdx(m_Passes.size());
+    std::vector<Uint32> NumContextPasses(NumContexts);
+
+    for (auto PassIdx : m_Schedule)
+    {
+        auto&      Pass      = m_Passes[PassIdx];
+        const auto Ctx       = Pass.ContextIndex;
+        const auto QueueType = QueueTypes[Ctx];
+
+        ContextPassIdx[PassIdx] = NumContextPasses[Ctx]++;
+
+        auto AddWait = [&](Uint32 OtherPassIdx) {
+            if (OtherPassIdx == ~0u || m_Passes[OtherPassIdx].ContextIndex == Ctx)
+                return;
+            if (std::find(Pass.WaitPasses.begin(), Pass.WaitPasses.end(), OtherPassIdx) == Pass.WaitPasses.end())
+                Pass.WaitPasses.push_back(OtherPassIdx);
+        };
+
+        for (const auto& Access : Pass.Accesses)
+        {
+            const auto ResIdx = Access.Resource;
+            auto&      Res    = m_Resources[ResIdx];
+            auto&      T      = Trackers[ResIdx];
+
+            Res.LastContext = Ctx;
+
+            if (!T.IsUsed)
+            {
+                // The state of the resource at the beginning of the graph is only known at execution time
+                Pass.FirstUseBarriers.push_back({ResIdx, RESOURCE_STATE_UNKNOWN, Access.State});
+                Res.FirstContext       = Ctx;
+                Res.FirstAccessIsWrite = Access.IsWrite;
+
+                T.IsUsed              = true;
+                T.State               = Access.State;
+                T.LastAccessIsWrite   = Access.IsWrite;
+                T.LastPass            = PassIdx;
+                T.LastWritePass       = Access.IsWrite ? PassIdx : ~0u;
+                T.pTransitionList     = &Pass.FirstUseBarriers;
+                T.TransitionIdx       = Pass.FirstUseBarriers.size() - 1;
+                T.TransitionContext   = Ctx;
+                T.UsedByOtherContexts = false;
+
+                T.LastContextAccess[Ctx] = PassIdx;
+                continue;
+            }
+
+            const auto LastCtx = m_Passes[T.LastPass].ContextIndex;
+
+            bool OtherContextsUsed = false;
+            for (Uint32 c = 0; c < NumContexts; ++c)
+            {
+                if (c != Ctx && T.LastContextAccess[c] != ~0u)
+                    OtherContextsUsed = true;
+            }
+
+            // Buffers that are only read may be in a combination of read states
+            const bool IsBufferRead =
+                !Res.IsTexture &&
+                !Access.IsWrite &&
+                !T.LastAccessIsWrite &&
+                IsReadOnlyState(T.State) &&
+                IsReadOnlyState(Access.State);
+
+            bool NeedTransition = false;
+            bool NeedUAVBarrier = false;
+            auto NewState       = Access.State;
+            if (T.State == Access.State || (IsBufferRead && (T.State & Access.State) == Access.State))
+            {
+                // Accesses to UAVs in the same context must be separated by a UAV barrier if either of them
+                // is a write. Waiting for a fence already makes the writes in other contexts visible.
+                NewState       = T.State;
+                NeedUAVBarrier = NewState == RESOURCE_STATE_UNORDERED_ACCESS && (T.LastAccessIsWrite || Access.IsWrite) && LastCtx == Ctx;
+                if (!NeedUAVBarrier)
+                    ++m_Stats.NumSkippedBarriers;
+            }
+            else if (IsBufferRead &&
+                     T.TransitionContext == Ctx &&
+                     !T.UsedByOtherContexts &&
+                     (*T.pTransitionList)[T.TransitionIdx].TransitionType == STATE_TRANSITION_TYPE_IMMEDIATE)
+            {
+                // All accesses since the last transition are reads in this context, so the transition
+                // can move the buffer directly to the combined read state
+                auto& LastTransition = (*T.pTransitionList)[T.TransitionIdx];
+                LastTransition.NewState |= Access.State;
+                NewState = LastTransition.NewState;
+                ++m_Stats.NumMergedBarriers;
+            }
+            else
+            {
+                NeedTransition = true;
+            }
+
+            // Transitions and writes must wait for all accesses in other contexts,
+            // reads only need to wait for the last write.
+            if (NeedTransition || Access.IsWrite)
+            {
+                for (Uint32 c = 0; c < NumContexts; ++c)
+                    AddWait(T.LastContextAccess[c]);
+            }
+            else
+            {
+                AddWait(T.LastWritePass);
+            }
+
+            if (NeedTransition || NeedUAVBarrier)
+            {
+                Barrier NewBarrier{ResIdx, T.State, NewState};
+
+                std::vector<Barrier>* pTransitionList   = &Pass.PreBarriers;
+                Uint32                TransitionContext = Ctx;
+                if (LastCtx != Ctx)
+                {
+                    // The resource was last used in another context. The transition is performed in
+                    // this context after waiting for the fence, unless this context does not support
+                    // the previous state (e.g. a compute context can't transition a render target).
+                    // In this case, the transition is performed by the last pass that used the resource,
+                    // which is only possible if no other context has used the resource since the last write.
+                    if (!IsStateSupportedByQueue(T.State, QueueType))
+                    {
+#ifdef DILIGENT_DEVELOPMENT
+                        bool IsSingleContext = true;
+                        for (Uint32 c = 0; c < NumContexts; ++c)
+                        {
+                            if (c != LastCtx && T.LastContextAccess[c] != ~0u)
+                                IsSingleContext = false;
+                        }
+
+                        DEV_CHECK_ERR(IsSingleContext && IsStateSupportedByQueue(NewState, QueueTypes[LastCtx]),
+                                      "Render graph '", m_Name, "' is unable to find a context that can transition resource ", ResIdx,
+                                      " from state ", GetResourceStateString(T.State), " to ", GetResourceStateString(NewState),
+                                      " for pass '", Pass.Name, "'");
+#endif
+
+                        pTransitionList   = &m_Passes[T.LastPass].PostBarriers;
+                        TransitionContext = LastCtx;
+                    }
+                }
+                else if (NeedTransition && !OtherContextsUsed && ContextPassIdx[PassIdx] > ContextPassIdx[T.LastPass] + 1)
+                {
+                    // There is other work in this context between the last use of the resource and this pass,
+                    // so begin the transition right after the last use and end it before this pass.
+                    Barrier BeginBarrier        = NewBarrier;
+                    BeginBarrier.TransitionType = STATE_TRANSITION_TYPE_BEGIN;
+                    m_Passes[T.LastPass].PostBarriers.push_back(BeginBarrier);
+
+                    NewBarrier.TransitionType = STATE_TRANSITION_TYPE_END;
+                    ++m_Stats.NumSplitBarriers;
+                }
+
+                pTransitionList->push_back(NewBarrier);
+                ++m_Stats.NumBarriers;
+
+                T.pTransitionList     = pTransitionList;
+                T.TransitionIdx       = pTransitionList->size() - 1;
+                T.TransitionContext   = TransitionContext;
+                T.UsedByOtherContexts = false;
+            }
+            else if (Ctx != T.TransitionContext)
+            {
+                T.UsedByOtherContexts = true;
+            }
+
+            T.State             = NewState;
+            T.LastAccessIsWrite = Access.IsWrite;
+            T.LastPass          = PassIdx;
+            if (Access.IsWrite)
+            {
+                T.LastWritePass = PassIdx;
+                std::fill(T.LastContextAccess.begin(), T.LastContextAccess.end(), ~0u);
+            }
+            T.LastContextAccess[Ctx] = PassIdx;
+        }
+    }
+
+    // Remove the waits that are implied by the earlier waits in the same context: fence values
+    // increase monotonically, so waiting for a pass also waits for all earlier passes in its context.
+    std::vector<Uint32> LastWaitedPass(NumContexts * NumContexts, ~0u);
+    for (auto PassIdx : m_Schedule)
+    {
+        auto& Pass = m_Passes[PassIdx];
+
+        std::vector<Uint32> LatestWaits(NumContexts, ~0u);
+        for (auto WaitPassIdx : Pass.WaitPasses)
+        {
+            auto& Latest = LatestWaits[m_Passes[WaitPassIdx].ContextIndex];
+            if (Latest == ~0u || WaitPassIdx > Latest)
+                Latest = WaitPassIdx;
+        }
+
+        Pass.WaitPasses.clear();
+        for (Uint32 c = 0; c < NumContexts; ++c)
+        {
+            auto& LastWaited = LastWaitedPass[Pass.ContextIndex * NumContexts + c];
+            if (LatestWaits[c] == ~0u || (LastWaited != ~0u && LatestWaits[c] <= LastWaited))
+                continue;
+
+            LastWaited = LatestWaits[c];
+            Pass.WaitPasses.push_back(LatestWaits[c]);
+            m_Passes[LatestWaits[c]].SignalFence = true;
+            ++m_Stats.NumCrossContextWaits;
+        }
+    }
+
+    // Compute the synchronization of the final transitions and of consecutive executions
+    m_FinalWaitPasses.assign(NumContexts, {});
+    m_SignalAfterExecution.assign(NumContexts, false);
+    for (Uint32 r = 0; r < m_Resources.size(); ++r)
+    {
+        auto&       Res = m_Resources[r];
+        const auto& T   = Trackers[r];
+        if (!T.IsUsed)
+            continue;
+
+        Res.TrailingContextMask = 0;
+        for (Uint32 c = 0; c < NumContexts; ++c)
+        {
+            if (T.LastContextAccess[c] != ~0u)
+                Res.TrailingContextMask |= Uint64{1} << c;
+        }
+        Res.LastWriteContext = T.LastWritePass != ~0u ? m_Passes[T.LastWritePass].ContextIndex : ~0u;
+
+        if (Res.IsOutput && Res.FinalState != RESOURCE_STATE_UNKNOWN)
+        {
+            // The final transition is performed in the last context and must wait for
+            // the accesses in other contexts. It then acts as the last write.
+            for (Uint32 c = 0; c < NumContexts; ++c)
+            {
+                if (c == Res.LastContext || T.LastContextAccess[c] == ~0u)
+                    continue;
+
+                auto& FinalWaits = m_FinalWaitPasses[Res.LastContext];
+                auto  it         = std::find_if(FinalWaits.begin(), FinalWaits.end(), [&](Uint32 PassIdx) { return m_Passes[PassIdx].ContextIndex == c; });
+                if (it == FinalWaits.end())
+                {
+                    FinalWaits.push_back(T.LastContextAccess[c]);
+                    ++m_Stats.NumCrossContextWaits;
+                }
+                else
+                {
+                    *it = std::max(*it, T.LastContextAccess[c]);
+                }
+                m_Passes[T.LastContextAccess[c]].SignalFence = true;
+            }
+            Res.TrailingContextMask |= Uint64{1} << Res.LastContext;
+            Res.LastWriteContext = Res.LastContext;
+        }
+
+        for (Uint32 c = 0; c < NumContexts; ++c)
+        {
+            if (c != Res.FirstContext && (Res.TrailingContextMask & (Uint64{1} << c)) != 0)
+                m_SignalAfterExecution[c] = true;
+        }
+    }
+}
+
+void RenderGraph::CreateTransientTextures(IRenderDevice* pDevice, IDeviceContext* const* ppContexts)
+{
+    // Lifetimes of the transient textures in the compiled schedule
+    std::vector<Uint32> FirstUse(m_Resources.size(), ~0u);
+    std::vector<Uint32> LastUse(m_Resources.size(), ~0u);
+    for (Uint32 s = 0; s < m_Schedule.size(); ++s)
+    {
+        const auto& Pass = m_Passes[m_Schedule[s]];
+        for (const auto& Access : Pass.Accesses)
+        {
+            if (!m_Resources[Access.Resource].IsTransient)
+                continue;
+
+            DEV_CHECK_ERR(m_TransientContext == ~0u || m_TransientContext == Pass.ContextIndex,
+                          "Pass '", Pass.Name, "' uses a transient texture in a different context than other passes. "
+                                                "All passes that use transient textures must run in the same context.");
+            m_TransientContext = Pass.ContextIndex;
+
+            if (FirstUse[Access.Resource] == ~0u)
+                FirstUse[Access.Resource] = s;
+            LastUse[Access.Resource] = s;
+        }
+    }
+
+    if (m_TransientContext == ~0u)
+        return;
+
+    auto* pContext = ppContexts[m_TransientContext];
+
+    TransientResourceAllocatorCreateInfo AllocatorCI;
+    AllocatorCI.Name                 = m_Name.c_str();
+    AllocatorCI.ImmediateContextMask = Uint64{1} << Uint64{pContext->GetDesc().ContextId};
+    m_pTransientAllocator.reset(new TransientResourceAllocator{AllocatorCI});
+
+    for (Uint32 r = 0; r < m_Resources.size(); ++r)
+    {
+        auto& Res = m_Resources[r];
+        if (!Res.IsTransient || FirstUse[r] == ~0u)
+            continue;
+
+        auto Desc           = Res.TransientDesc;
+        Desc.Name           = Res.TransientName.c_str();
+        Res.TransientHandle = m_pTransientAllocator->AddTexture(Desc, FirstUse[r], LastUse[r]);
+    }
+
+    m_pTransientAllocator->Commit(pDevice, pContext);
+
+    for (auto& Res : m_Resources)
+    {
+        if (Res.TransientHandle != ~0u)
+            Res.pTexture = m_pTransientAllocator->GetTexture(Res.TransientHandle);
+    }
+}
+
+void RenderGraph::Compile(IRenderDevice* pDevice, IDeviceContext* const* ppContexts, Uint32 NumContexts)
+{
+    DEV_CHECK_ERR(!m_IsCompiled, "Render graph '", m_Name, "' has already been compiled");
+    DEV_CHECK_ERR(pDevice != nullptr, "Render device must not be null");
+    DEV_CHECK_ERR(ppContexts != nullptr && NumContexts > 0, "At least one context is required");
+    DEV_CHECK_ERR(NumContexts <= 64, "Render graph supports at most 64 contexts");
+
+    std::vector<COMMAND_QUEUE_TYPE> QueueTypes(NumContexts);
+    for (Uint32 c = 0; c < NumContexts; ++c)
+    {
+        DEV_CHECK_ERR(ppContexts[c] != nullptr && !ppContexts[c]->GetDesc().IsDeferred,
+                      "Context ", c, " must be a non-null immediate context");
+        QueueTypes[c] = ppContexts[c]->GetDesc().QueueType;
+    }
+
+#ifdef DILIGENT_DEVELOPMENT
+    for (const auto& Pass : m_Passes)
+    {
+        DEV_CHECK_ERR(Pass.ContextIndex < NumContexts, "Context index ", Pass.ContextIndex, " of pass '", Pass.Name,
+                      "' is out of range: only ", NumContexts, " context(s) are given");
+        for (const auto& Access : Pass.Accesses)
+        {
+            DEV_CHECK_ERR(IsStateSupportedByQueue(Access.State, QueueTypes[Pass.ContextIndex]),
+                          "State ", GetResourceStateString(Access.State), " used by pass '", Pass.Name, "' is not supported by ",
+                          GetCommandQueueTypeString(QueueTypes[Pass.ContextIndex]), " context");
+        }
+    }
+#endif
+
+    m_Stats           = {};
+    m_Stats.NumPasses = static_cast<Uint32>(m_Passes.size());
+
+    CullPasses();
+    ComputeBarriers(QueueTypes);
+    CreateTransientTextures(pDevice, ppContexts);
+
+    for (auto& Res : m_Resources)
+        Res.PrevExecFenceValues.assign(NumContexts, 0);
+
+    std::vector<bool> NeedFence = m_SignalAfterExecution;
+    for (auto PassIdx : m_Schedule)
+    {
+        const auto& Pass = m_Passes[PassIdx];
+        if (Pass.SignalFence)
+            NeedFence[Pass.ContextIndex] = true;
+    }
+
+    m_Fences.clear();
+    m_Fences.resize(NumContexts);
+    m_FenceValues.assign(NumContexts, 0);
+    m_WaitedFenceValues.assign(size_t{NumContexts} * NumContexts, 0);
+    for (Uint32 c = 0; c < NumContexts; ++c)
+    {
+        if (!NeedFence[c])
+            continue;
+
+        const auto FenceName = m_Name + " - fence " + std::to_string(c);
+
+        FenceDesc Desc;
+        Desc.Name = FenceName.c_str();
+        Desc.Type = FENCE_TYPE_GENERAL;
+        pDevice->CreateFence(Desc, &m_Fences[c]);
+        if (!m_Fences[c])
+            LOG_ERROR_AND_THROW("Render graph '", m_Name, "' failed to create a fence for context ", c);
+    }
+
+    m_IsCompiled = true;
+}
+
+void RenderGraph::AppendTransition(std::vector<StateTransitionDesc>& Transitions, const Barrier& B) const
+{
+    const auto& Res = m_Resources[B.Resource];
+
+    // All transitions use the state tracked by the engine as the old state. It is the same as the state
+    // computed at compile time, except that the engine may know a more accurate combination of read states
+    // of a buffer. The begin part of a split barrier does not update the state.
+    const auto Flags = B.TransitionType == STATE_TRANSITION_TYPE_BEGIN ? STATE_TRANSITION_FLAG_NONE : STATE_TRANSITION_FLAG_UPDATE_STATE;
+    if (Res.pTexture)
+    {
+        Transitions.emplace_back(Res.pTexture.RawPtr<ITexture>(), RESOURCE_STATE_UNKNOWN, B.NewState,
+                                 0, REMAINING_MIP_LEVELS, 0, REMAINING_ARRAY_SLICES, B.TransitionType, Flags);
+    }
+    else
+    {
+        VERIFY_EXPR(Res.pBuffer);
+        Transitions.emplace_back(Res.pBuffer.RawPtr<IBuffer>(), RESOURCE_STATE_UNKNOWN, B.NewState, Flags);
+        Transitions.back().TransitionType = B.TransitionType;
+    }
+}
+
+bool RenderGraph::NeedFirstUseTransition(const Barrier& B) const
+{
+    const auto& Res = m_Resources[B.Resource];
+    if (!Res.pTexture && !Res.pBuffer)
+        return false;
+
+    const auto CurrState = Res.pTexture ? Res.pTexture->GetState() : Res.pBuffer->GetState();
+    if (CurrState == RESOURCE_STATE_UNKNOWN)
+    {
+        DEV_ERROR("The state of resource ", B.Resource, " used by render graph '", m_Name, "' is unknown");
+        return false;
+    }
+
+    if (CurrState == B.NewState || (Res.pBuffer && IsReadOnlyState(CurrState) && (CurrState & B.NewState) == B.NewState))
+    {
+        // The last access in the previous frame may have been a UAV write
+        return CurrState == RESOURCE_STATE_UNORDERED_ACCESS;
+    }
+
+    return true;
+}
+
+void RenderGraph::AppendFirstUseTransition(std::vector<StateTransitionDesc>& Transitions, const Barrier& B) const
+{
+    if (NeedFirstUseTransition(B))
+        AppendTransition(Transitions, B);
+}
+
+void RenderGraph::WaitForFence(IDeviceContext* pContext, Uint32 Ctx, Uint32 SignalCtx, Uint64 Value)
+{
+    if (SignalCtx == Ctx || Value == 0)
+        return;
+
+    // Fence values increase monotonically, so there is no need to wait for a value
+    // that is not greater than the one the context has already waited for
+    auto& WaitedValue = m_WaitedFenceValues[size_t{Ctx} * m_FenceValues.size() + SignalCtx];
+    if (Value <= WaitedValue)
+        return;
+
+    VERIFY_EXPR(m_Fences[SignalCtx]);
+    pContext->DeviceWaitForFence(m_Fences[SignalCtx], Value);
+    WaitedValue = Value;
+}
+
+void RenderGraph::Execute(IDeviceContext* const* ppContexts, Uint32 NumContexts)
+{
+    DEV_CHECK_ERR(m_IsCompiled, "Render graph '", m_Name, "' must be compiled before it is executed");
+    DEV_CHECK_ERR(ppContexts != nullptr && NumContexts == m_FenceValues.size(),
+                  "The number of contexts (", NumContexts, ") does not match the number of contexts the graph was compiled with (", m_FenceValues.size(), ")");
+
+    std::vector<StateTransitionDesc> Transitions;
+    for (Uint32 s = 0; s < m_Schedule.size(); ++s)
+    {
+        auto&      Pass     = m_Passes[m_Schedule[s]];
+        const auto Ctx      = Pass.ContextIndex;
+        auto*      pContext = ppContexts[Ctx];
+
+        for (auto WaitPassIdx : Pass.WaitPasses)
+        {
+            const auto& WaitPass = m_Passes[WaitPassIdx];
+            WaitForFence(pContext, Ctx, WaitPass.ContextIndex, WaitPass.FenceValue);
+        }
+
+        // Wait for the accesses in other contexts at the end of the previous execution.
+        // Transitions and writes must wait for all of them, reads only need to wait for the last write.
+        for (const auto& B : Pass.FirstUseBarriers)
+        {
+            const auto& Res = m_Resources[B.Resource];
+            if (Res.FirstAccessIsWrite || NeedFirstUseTransition(B))
+            {
+                for (Uint32 c = 0; c < NumContexts; ++c)
+                    WaitForFence(pContext, Ctx, c, Res.PrevExecFenceValues[c]);
+            }
+            else if (Res.LastWriteContext != ~0u)
+            {
+                WaitForFence(pContext, Ctx, Res.LastWriteContext, Res.PrevExecFenceValues[Res.LastWriteContext]);
+            }
+        }
+
+        if (m_pTransientAllocator && Ctx == m_TransientContext)
+            m_pTransientAllocator->BeginPass(pContext, s);
+
+        Transitions.clear();
+        for (const auto& B : Pass.FirstUseBarriers)
+            AppendFirstUseTransition(Transitions, B);
+        for (const auto& B : Pass.PreBarriers)
+            AppendTransition(Transitions, B);
+        if (!Transitions.empty())
+            pContext->TransitionResourceStates(static_cast<Uint32>(Transitions.size()), Transitions.data());
+
+        if (Pass.Callback)
+            Pass.Callback(pContext);
+
+        Transitions.clear();
+        for (const auto& B : Pass.PostBarriers)
+            AppendTransition(Transitions, B);
+        if (!Transitions.empty())
+            pContext->TransitionResourceStates(static_cast<Uint32>(Transitions.size()), Transitions.data());
+
+        if (Pass.SignalFence)
+        {
+            Pass.FenceValue = ++m_FenceValues[Ctx];
+            pContext->EnqueueSignal(m_Fences[Ctx], Pass.FenceValue);
+            // The value must be pending before other contexts can wait for it
+            pContext->Flush();
+        }
+    }
+
+    // Transition the outputs to their final states in the context that used them last
+    for (Uint32 c = 0; c < NumContexts; ++c)
+    {
+        for (auto WaitPassIdx : m_FinalWaitPasses[c])
+        {
+            const auto& WaitPass = m_Passes[WaitPassIdx];
+            WaitForFence(ppContexts[c], c, WaitPass.ContextIndex, WaitPass.FenceValue);
+        }
+    }
+
+    std::vector<std::vector<StateTransitionDesc>> FinalTransitions(NumContexts);
+    for (Uint32 r = 0; r < m_Resources.size(); ++r)
+    {
+        const auto& Res = m_Resources[r];
+        if (!Res.IsOutput || Res.FinalState == RESOURCE_STATE_UNKNOWN || (!Res.pTexture && !Res.pBuffer))
+            continue;
+
+        const auto CurrState = Res.pTexture ? Res.pTexture->GetState() : Res.pBuffer->GetState();
+        if (CurrState != Res.FinalState)
+            AppendFirstUseTransition(FinalTransitions[Res.LastContext], Barrier{r, RESOURCE_STATE_UNKNOWN, Res.FinalState});
+    }
+    for (Uint32 c = 0; c < NumContexts; ++c)
+    {
+        if (!FinalTransitions[c].empty())
+            ppContexts[c]->TransitionResourceStates(static_cast<Uint32>(FinalTransitions[c].size()), FinalTransitions[c].data());
+    }
+
+    // Signal the fences that the first passes of the next execution wait for
+    for (Uint32 c = 0; c < NumContexts; ++c)
+    {
+        if (!m_SignalAfterExecution[c])
+            continue;
+
+        ppContexts[c]->EnqueueSignal(m_Fences[c], ++m_FenceValues[c]);
+        ppContexts[c]->Flush();
+    }
+
+    for (auto& Res : m_Resources)
+    {
+        if (Res.FirstContext == ~0u)
+            continue;
+
+        for (Uint32 c = 0; c < NumContexts; ++c)
+        {
+            const bool IsTrailing = (Res.TrailingContextMask & (Uint64{1} << c)) != 0;
+            Res.PrevExecFenceValues[c] = IsTrailing && m_SignalAfterExecution[c] ? m_FenceValues[c] : 0;
+        }
+    }
+}
+
+ITexture* RenderGraph::GetTexture(Uint32 Resource) const
+{
+    DEV_CHECK_ERR(Resource < m_Resources.size(), "Resource handle ", Resource, " is out of range");
+    DEV_CHECK_ERR(m_Resources[Resource].IsTexture, "Resource ", Resource, " is not a texture");
+    DEV_CHECK_ERR(!m_Resources[Resource].IsTransient || m_IsCompiled, "Render graph must be compiled before transient textures can be accessed");
+    return m_Resources[Resource].pTexture.RawPtr<ITexture>();
+}
+
+IBuffer* RenderGraph::GetBuffer(Uint32 Resource) const
+{
+    DEV_CHECK_ERR(Resource < m_Resources.size(), "Resource handle ", Resource, " is out of range");
+    DEV_CHECK_ERR(!m_Resources[Resource].IsTexture, "Resource ", Resource, " is not a buffer");
+    return m_Resources[Resource].pBuffer.RawPtr<IBuffer>();
+}
+
+bool RenderGraph::IsPassCulled(Uint32 Pass) const
+{
+    DEV_CHECK_ERR(Pass < m_Passes.size(), "Pass handle ", Pass, " is out of range");
+    DEV_CHECK_ERR(m_IsCompiled, "Render graph must be compiled");
+    return m_Passes[Pass].IsCulled;
+}
+
+void RenderGraph::Reset()
+{
+    m_Passes.clear();
+    m_Schedule.clear();
+    // Release the transient textures before their memory
+    m_Resources.clear();
+    m_pTransientAllocator.reset();
+    m_TransientContext = ~0u;
+    m_Fences.clear();
+    m_FenceValues.clear();
+    m_WaitedFenceValues.clear();
+    m_FinalWaitPasses.clear();
+    m_SignalAfterExecution.clear();
+    m_Stats      = {};
+    m_IsCompiled = false;
+}
+
+} // namespace Diligent
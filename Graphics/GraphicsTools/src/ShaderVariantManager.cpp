@@ -0,0 +1,473 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "ShaderVariantManager.hpp"
+
+#include <algorithm>
+#include <map>
+#include <unordered_set>
+
+#include "DebugUtilities.hpp"
+#include "DataBlobImpl.hpp"
+#include "ParsingTools.hpp"
+#include "ShaderBase.hpp"
+#include "ShaderToolsCommon.hpp"
+
+namespace Diligent
+{
+
+struct ShaderVariantManager::PreprocessedSource
+{
+    // Hash of the normalized token stream
+    XXH128Hash TokensHash;
+
+    // All identifiers found in the source
+    std::unordered_set<std::string> Identifiers;
+
+    // Whether the source uses the token-pasting operator
+    bool HasTokenPasting = false;
+
+    // The factory is a part of the source key. Keep it alive so that its address
+    // can't be reused by another factory while the source is cached.
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pSourceFactory;
+};
+
+struct ShaderVariantManager::UniqueVariant
+{
+    UniqueVariant(const ShaderCreateInfo& ShaderCI) :
+        CI{ShaderCI, GetRawAllocator()}
+    {}
+
+    // Create info with the reduced macro set
+    ShaderCreateInfoWrapper CI;
+
+    RefCntAutoPtr<IShader> pShader;
+
+    bool IsProcessed = false;
+};
+
+namespace
+{
+
+// Calls the handler for every token in the source and returns the
+// normalized delimiter that precedes it:
+//  - 0    if there is no delimiter
+//  - '\n' if the delimiter contains a new line
+//  - ' '  otherwise
+//
+// Comments are treated as delimiters.
+template <typename HandlerType>
+void EnumerateTokens(const char* Start, const char* End, HandlerType&& Handler) noexcept(false)
+{
+    auto Pos = Start;
+    while (Pos != End)
+    {
+        const auto DelimStart = Pos;
+
+        Pos = Parsing::SkipDelimitersAndComments(Pos, End);
+
+        char Delimiter = 0;
+        if (Pos != DelimStart)
+            Delimiter = std::find_if(DelimStart, Pos, Parsing::IsNewLine) != Pos ? '\n' : ' ';
+
+        if (Pos == End)
+            break;
+
+        auto TokenEnd = Parsing::SkipIdentifier(Pos, End);
+        const auto IsIdentifier = TokenEnd != Pos;
+        if (!IsIdentifier)
+        {
+            if (*Pos == '"')
+            {
+                TokenEnd = std::find(Pos + 1, End, '"');
+                if (TokenEnd == End)
+                    throw std::pair<const char*, const char*>{Pos, "Unable to find matching closing quotes."};
+            }
+            ++TokenEnd;
+        }
+
+        Handler(Delimiter, Pos, TokenEnd, IsIdentifier);
+        Pos = TokenEnd;
+    }
+}
+
+void HashString(XXH128State& Hasher, const char* Str)
+{
+    const size_t Len = Str != nullptr ? strlen(Str) : 0;
+    Hasher.Update(Len);
+    if (Len > 0)
+        Hasher.UpdateRaw(Str, Len);
+}
+
+bool IsBytecodeSupported(RENDER_DEVICE_TYPE DeviceType)
+{
+    return (DeviceType == RENDER_DEVICE_TYPE_D3D11 ||
+            DeviceType == RENDER_DEVICE_TYPE_D3D12 ||
+            DeviceType == RENDER_DEVICE_TYPE_VULKAN);
+}
+
+} // namespace
+
+ShaderVariantManager::ShaderVariantManager(const ShaderVariantManagerCreateInfo& CreateInfo) :
+    m_pDevice{CreateInfo.pDevice},
+    m_pBytecodeCache{CreateInfo.pBytecodeCache},
+    m_pStateCache{CreateInfo.pStateCache},
+    m_pThreadPool{CreateInfo.pThreadPool}
+{
+    if (m_pBytecodeCache && m_pStateCache)
+    {
+        LOG_WARNING_MESSAGE("Both bytecode cache and render state cache are provided to the shader variant manager. Bytecode cache will be ignored.");
+        m_pBytecodeCache.Release();
+    }
+
+    if (m_pBytecodeCache && m_pDevice && !IsBytecodeSupported(m_pDevice->GetDeviceInfo().Type))
+    {
+        // Bytecode is not available in OpenGL and Metal
+        m_pBytecodeCache.Release();
+    }
+}
+
+ShaderVariantManager::~ShaderVariantManager()
+{
+}
+
+const ShaderVariantManager::PreprocessedSource& ShaderVariantManager::PreprocessSource(const ShaderCreateInfo& ShaderCI) noexcept(false)
+{
+    // Includes are resolved through the source stream factory, so the same source
+    // text may expand differently with different factories.
+    const auto FactoryKey = std::to_string(reinterpret_cast<size_t>(ShaderCI.pShaderSourceStreamFactory));
+
+    std::string SourceKey;
+    if (ShaderCI.Source != nullptr)
+    {
+        const auto SourceLength = ShaderCI.SourceLength != 0 ? ShaderCI.SourceLength : strlen(ShaderCI.Source);
+
+        XXH128State Hasher;
+        Hasher.UpdateStr(ShaderCI.Source, SourceLength);
+        const auto Hash = Hasher.Digest();
+        SourceKey       = "src:" + FactoryKey + ':' + std::to_string(Hash.LowPart) + ':' + std::to_string(Hash.HighPart);
+    }
+    else
+    {
+        VERIFY_EXPR(ShaderCI.FilePath != nullptr);
+        SourceKey = "file:" + FactoryKey + ':' + ShaderCI.FilePath;
+    }
+
+    auto it = m_Sources.find(SourceKey);
+    if (it != m_Sources.end())
+        return *it->second;
+
+    const auto Source = UnrollShaderIncludes(ShaderCI);
+
+    std::unique_ptr<PreprocessedSource> pPreprocessed{new PreprocessedSource{}};
+    pPreprocessed->pSourceFactory = ShaderCI.pShaderSourceStreamFactory;
+
+    XXH128State Hasher;
+    try
+    {
+        EnumerateTokens(Source.data(), Source.data() + Source.length(),
+                        [&](char Delimiter, const char* TokenStart, const char* TokenEnd, bool IsIdentifier) //
+                        {
+                            if (Delimiter != 0)
+                                Hasher.Update(Delimiter);
+                            Hasher.UpdateRaw(TokenStart, TokenEnd - TokenStart);
+
+                            if (IsIdentifier)
+                                pPreprocessed->Identifiers.emplace(TokenStart, TokenEnd);
+                            else if (*TokenStart == '#' && Delimiter == 0 && TokenStart > Source.data() && TokenStart[-1] == '#')
+                                pPreprocessed->HasTokenPasting = true;
+                        });
+    }
+    catch (const std::pair<const char*, const char*>& ErrInfo)
+    {
+        LOG_ERROR_AND_THROW("Failed to preprocess shader '", (ShaderCI.Desc.Name != nullptr ? ShaderCI.Desc.Name : ""), "': ", ErrInfo.second, "\n",
+                            Parsing::GetContext(Source.data(), Source.data() + Source.length(), ErrInfo.first, 2));
+    }
+    pPreprocessed->TokensHash = Hasher.Digest();
+
+    return *m_Sources.emplace(std::move(SourceKey), std::move(pPreprocessed)).first->second;
+}
+
+Uint32 ShaderVariantManager::AddVariant(const ShaderCreateInfo& ShaderCI) noexcept(false)
+{
+    XXH128State Hasher;
+
+    Hasher.Update(ShaderCI.Desc.ShaderType,
+                  ShaderCI.Desc.UseCombinedTextureSamplers,
+                  ShaderCI.SourceLanguage,
+                  ShaderCI.ShaderCompiler,
+                  ShaderCI.HLSLVersion,
+                  ShaderCI.GLSLVersion,
+                  ShaderCI.GLESSLVersion,
+                  ShaderCI.MSLVersion,
+                  ShaderCI.CompileFlags);
+    HashString(Hasher, ShaderCI.EntryPoint);
+    HashString(Hasher, ShaderCI.Desc.CombinedSamplerSuffix);
+
+    // Last definition of every macro, sorted by name
+    std::map<std::string, const ShaderMacro*> AllMacros;
+    if (ShaderCI.Macros != nullptr)
+    {
+        for (const auto* Macro = ShaderCI.Macros; Macro->Name != nullptr && Macro->Definition != nullptr; ++Macro)
+            AllMacros[Macro->Name] = Macro;
+    }
+
+    std::vector<ShaderMacro> UsedMacros;
+    if (ShaderCI.ByteCode != nullptr && ShaderCI.ByteCodeSize != 0)
+    {
+        Hasher.UpdateRaw(ShaderCI.ByteCode, ShaderCI.ByteCodeSize);
+        for (const auto& it : AllMacros)
+            UsedMacros.push_back(*it.second);
+    }
+    else
+    {
+        const auto& Source = PreprocessSource(ShaderCI);
+        Hasher.Update(Source.TokensHash.LowPart, Source.TokensHash.HighPart);
+
+        if (Source.HasTokenPasting)
+        {
+            for (const auto& it : AllMacros)
+                UsedMacros.push_back(*it.second);
+        }
+        else
+        {
+            // Find all macros referenced by the source and, recursively, by definitions of other used macros
+            std::unordered_set<std::string> UsedNames;
+            std::vector<const ShaderMacro*> PendingMacros;
+            for (const auto& it : AllMacros)
+            {
+                if (Source.Identifiers.find(it.first) != Source.Identifiers.end())
+                {
+                    UsedNames.emplace(it.first);
+                    PendingMacros.push_back(it.second);
+                }
+            }
+
+            while (!PendingMacros.empty())
+            {
+                const auto* pMacro = PendingMacros.back();
+                PendingMacros.pop_back();
+
+                const auto* DefStart = pMacro->Definition;
+                const auto* DefEnd   = DefStart + strlen(DefStart);
+                try
+                {
+                    EnumerateTokens(DefStart, DefEnd,
+                                    [&](char, const char* TokenStart, const char* TokenEnd, bool IsIdentifier) //
+                                    {
+                                        if (!IsIdentifier)
+                                            return;
+
+                                        std::string Name{TokenStart, TokenEnd};
+
+                                        auto macro_it = AllMacros.find(Name);
+                                        if (macro_it != AllMacros.end() && UsedNames.emplace(std::move(Name)).second)
+                                            PendingMacros.push_back(macro_it->second);
+                                    });
+                }
+                catch (const std::pair<const char*, const char*>& ErrInfo)
+                {
+                    LOG_ERROR_AND_THROW("Failed to parse definition of macro '", pMacro->Name, "': ", ErrInfo.second);
+                }
+            }
+
+            for (const auto& it : AllMacros)
+            {
+                if (UsedNames.find(it.first) != UsedNames.end())
+                    UsedMacros.push_back(*it.second);
+            }
+        }
+    }
+
+    for (const auto& Macro : UsedMacros)
+    {
+        HashString(Hasher, Macro.Name);
+        HashString(Hasher, Macro.Definition);
+    }
+
+    const auto Hash = Hasher.Digest();
+
+    auto it = m_HashToUniqueVariant.find(Hash);
+    if (it == m_HashToUniqueVariant.end())
+    {
+        ShaderCreateInfo VariantCI{ShaderCI};
+        if (!UsedMacros.empty())
+        {
+            UsedMacros.emplace_back();
+            VariantCI.Macros = UsedMacros.data();
+        }
+        else
+        {
+            VariantCI.Macros = nullptr;
+        }
+
+        m_UniqueVariants.emplace_back(new UniqueVariant{VariantCI});
+        it = m_HashToUniqueVariant.emplace(Hash, static_cast<Uint32>(m_UniqueVariants.size() - 1)).first;
+    }
+
+    m_Variants.push_back(it->second);
+    return static_cast<Uint32>(m_Variants.size() - 1);
+}
+
+void ShaderVariantManager::CompileVariant(UniqueVariant& Variant)
+{
+    const ShaderCreateInfo& ShaderCI = Variant.CI;
+
+    RefCntAutoPtr<IShader> pShader;
+    if (m_pStateCache)
+    {
+        m_pStateCache->CreateShader(ShaderCI, &pShader);
+    }
+    else
+    {
+        const bool UseBytecodeCache = m_pBytecodeCache && ShaderCI.ByteCode == nullptr;
+        if (UseBytecodeCache)
+        {
+            RefCntAutoPtr<IDataBlob> pBytecode;
+            {
+                std::lock_guard<std::mutex> Lock{m_BytecodeCacheMtx};
+                m_pBytecodeCache->GetBytecode(ShaderCI, &pBytecode);
+            }
+
+            if (pBytecode)
+            {
+                ShaderCreateInfo BytecodeCI{ShaderCI};
+                BytecodeCI.FilePath     = nullptr;
+                BytecodeCI.Source       = nullptr;
+                BytecodeCI.Macros       = nullptr;
+                BytecodeCI.ByteCode     = pBytecode->GetConstDataPtr();
+                BytecodeCI.ByteCodeSize = pBytecode->GetSize();
+                m_pDevice->CreateShader(BytecodeCI, &pShader);
+                if (pShader)
+                    m_NumBytecodeCacheHits.fetch_add(1);
+            }
+        }
+
+        if (!pShader)
+        {
+            m_pDevice->CreateShader(ShaderCI, &pShader);
+            if (pShader)
+            {
+                m_NumCompiledVariants.fetch_add(1);
+
+                if (UseBytecodeCache)
+                {
+                    const void* pBytecode    = nullptr;
+                    Uint64      BytecodeSize = 0;
+                    pShader->GetBytecode(&pBytecode, BytecodeSize);
+                    if (pBytecode != nullptr && BytecodeSize != 0)
+                    {
+                        auto pBytecodeBlob = DataBlobImpl::Create(static_cast<size_t>(BytecodeSize), pBytecode);
+
+                        std::lock_guard<std::mutex> Lock{m_BytecodeCacheMtx};
+                        m_pBytecodeCache->AddBytecode(ShaderCI, pBytecodeBlob);
+                    }
+                }
+            }
+        }
+    }
+
+    if (!pShader)
+    {
+        LOG_ERROR_MESSAGE("Failed to create shader variant '", (ShaderCI.Desc.Name != nullptr ? ShaderCI.Desc.Name : ""), "'");
+        m_NumFailedVariants.fetch_add(1);
+    }
+
+    Variant.pShader = std::move(pShader);
+}
+
+void ShaderVariantManager::CompileVariants()
+{
+    if (!m_pDevice && !m_pStateCache)
+    {
+        DEV_ERROR("Render device or render state cache is required to compile shader variants");
+        return;
+    }
+
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    for (auto& pVariant : m_UniqueVariants)
+    {
+        if (pVariant->IsProcessed)
+            continue;
+
+        pVariant->IsProcessed = true;
+        if (m_pThreadPool)
+        {
+            Tasks.emplace_back(EnqueueAsyncWork(m_pThreadPool,
+                                                [this, &Variant = *pVariant](Uint32) //
+                                                {
+                                                    CompileVariant(Variant);
+                                                }));
+        }
+        else
+        {
+            CompileVariant(*pVariant);
+        }
+    }
+
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+}
+
+IShader* ShaderVariantManager::GetShader(Uint32 VariantIndex) const
+{
+    const auto UniqueIdx = GetUniqueVariantIndex(VariantIndex);
+    return UniqueIdx < m_UniqueVariants.size() ? m_UniqueVariants[UniqueIdx]->pShader.RawPtr() : nullptr;
+}
+
+Uint32 ShaderVariantManager::GetUniqueVariantIndex(Uint32 VariantIndex) const
+{
+    if (VariantIndex >= m_Variants.size())
+    {
+        DEV_ERROR("Variant index (", VariantIndex, ") is out of range: the manager contains ", m_Variants.size(), " variants");
+        return ~0u;
+    }
+    return m_Variants[VariantIndex];
+}
+
+ShaderVariantManagerStats ShaderVariantManager::GetStats() const
+{
+    ShaderVariantManagerStats Stats;
+    Stats.NumVariants          = GetVariantCount();
+    Stats.NumUniqueVariants    = GetUniqueVariantCount();
+    Stats.NumCompiledVariants  = m_NumCompiledVariants.load();
+    Stats.NumBytecodeCacheHits = m_NumBytecodeCacheHits.load();
+    Stats.NumFailedVariants    = m_NumFailedVariants.load();
+    return Stats;
+}
+
+void ShaderVariantManager::Clear()
+{
+    m_Sources.clear();
+    m_UniqueVariants.clear();
+    m_HashToUniqueVariant.clear();
+    m_Variants.clear();
+    m_NumCompiledVariants.store(0);
+    m_NumBytecodeCacheHits.store(0);
+    m_NumFailedVariants.store(0);
+}
+
+} // namespace Diligent
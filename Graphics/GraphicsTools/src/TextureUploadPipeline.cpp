@@ -0,0 +1,186 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "TextureUploadPipeline.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "GraphicsAccessories.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+TextureUploadPipeline::TextureUploadPipeline(const TextureUploadPipelineCreateInfo& CreateInfo) noexcept(false) :
+    m_pUploader{CreateInfo.pUploader},
+    m_pThreadPool{CreateInfo.pThreadPool},
+    m_MaxUploadsInFlight{CreateInfo.MaxUploadsInFlight}
+{
+    if (m_pUploader == nullptr)
+        LOG_ERROR_AND_THROW("Texture uploader must not be null");
+    if (m_pThreadPool == nullptr)
+        LOG_ERROR_AND_THROW("Thread pool must not be null");
+    if (m_MaxUploadsInFlight == 0)
+        LOG_ERROR_AND_THROW("The maximum number of uploads in flight must not be zero");
+}
+
+TextureUploadPipeline::~TextureUploadPipeline()
+{
+    std::unique_lock<std::mutex> Lock{m_SlotsMtx};
+    if (m_NumUploadsInFlight != 0)
+    {
+        LOG_WARNING_MESSAGE("TextureUploadPipeline::~TextureUploadPipeline(): waiting for ", m_NumUploadsInFlight,
+                            " upload(s) in flight. If the render thread does not update the texture uploader, this will deadlock.");
+        m_SlotReleasedCV.wait(Lock, [this]() { return m_NumUploadsInFlight == 0; });
+    }
+}
+
+bool TextureUploadPipeline::EnqueueUpload(const TextureUploadRequest& Request, bool WaitForSlot)
+{
+    DEV_CHECK_ERR(Request.pDstTexture != nullptr, "Destination texture must not be null");
+    DEV_CHECK_ERR(Request.pPayload != nullptr, "Payload must not be null");
+
+    {
+        std::unique_lock<std::mutex> Lock{m_SlotsMtx};
+        if (m_NumUploadsInFlight >= m_MaxUploadsInFlight)
+        {
+            if (!WaitForSlot)
+                return false;
+
+            m_NumBackPressureWaits.fetch_add(1);
+            m_SlotReleasedCV.wait(Lock, [this]() { return m_NumUploadsInFlight < m_MaxUploadsInFlight; });
+        }
+        ++m_NumUploadsInFlight;
+    }
+
+    // Keep strong references to the texture and the payload until the upload is processed
+    RefCntAutoPtr<ITexture>  pDstTexture{Request.pDstTexture};
+    RefCntAutoPtr<IDataBlob> pPayload{Request.pPayload};
+    EnqueueAsyncWork(m_pThreadPool,
+                     [this, Request, pDstTexture, pPayload](Uint32 ThreadId) mutable {
+                         ProcessUpload(Request, pDstTexture, pPayload);
+
+                         std::lock_guard<std::mutex> Lock{m_SlotsMtx};
+                         VERIFY_EXPR(m_NumUploadsInFlight > 0);
+                         --m_NumUploadsInFlight;
+                         m_SlotReleasedCV.notify_all();
+                     });
+
+    return true;
+}
+
+void TextureUploadPipeline::ProcessUpload(const TextureUploadRequest& Request, ITexture* pDstTexture, IDataBlob* pPayload)
+{
+    // Allocation from a worker thread blocks until the render thread maps the buffer
+    RefCntAutoPtr<IUploadBuffer> pUploadBuffer;
+    m_pUploader->AllocateUploadBuffer(nullptr, Request.BufferDesc, &pUploadBuffer);
+    if (!pUploadBuffer)
+    {
+        LOG_ERROR_MESSAGE("Failed to allocate upload buffer");
+        m_NumFailedUploads.fetch_add(1);
+        return;
+    }
+
+    const bool Decoded = Request.Decoder ?
+        Request.Decoder(pPayload, pUploadBuffer) :
+        CopyRawTexelsToUploadBuffer(pPayload, pUploadBuffer);
+    if (!Decoded)
+    {
+        // The copy is still scheduled so that the buffer can be recycled.
+        // Contents of the destination subresources are undefined in this case.
+        LOG_ERROR_MESSAGE("Failed to decode texture payload");
+        m_NumFailedUploads.fetch_add(1);
+    }
+
+    m_pUploader->ScheduleGPUCopy(nullptr, pDstTexture, Request.DstSlice, Request.DstMip, pUploadBuffer);
+    pUploadBuffer->WaitForCopyScheduled();
+    m_pUploader->RecycleBuffer(pUploadBuffer);
+
+    m_NumUploadsCompleted.fetch_add(1);
+}
+
+TextureUploadPipelineStats TextureUploadPipeline::GetStats() const
+{
+    TextureUploadPipelineStats Stats;
+    {
+        std::lock_guard<std::mutex> Lock{m_SlotsMtx};
+        Stats.NumUploadsInFlight = m_NumUploadsInFlight;
+    }
+    Stats.NumUploadsCompleted  = m_NumUploadsCompleted.load();
+    Stats.NumFailedUploads     = m_NumFailedUploads.load();
+    Stats.NumBackPressureWaits = m_NumBackPressureWaits.load();
+    return Stats;
+}
+
+bool CopyRawTexelsToUploadBuffer(IDataBlob* pPayload, IUploadBuffer* pUploadBuffer)
+{
+    DEV_CHECK_ERR(pPayload != nullptr && pUploadBuffer != nullptr, "Payload and upload buffer must not be null");
+
+    const auto&  Desc        = pUploadBuffer->GetDesc();
+    const auto*  pSrc        = static_cast<const Uint8*>(pPayload->GetConstDataPtr());
+    const size_t PayloadSize = pPayload->GetSize();
+
+    size_t SrcOffset = 0;
+    for (Uint32 Slice = 0; Slice < Desc.ArraySize; ++Slice)
+    {
+        for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+        {
+            const Box Region //
+                {
+                    0, std::max(Desc.Width >> Mip, 1u),
+                    0, std::max(Desc.Height >> Mip, 1u),
+                    0, std::max(Desc.Depth >> Mip, 1u) //
+                };
+            // Row stride alignment of 1 gives tightly packed rows
+            const auto CopyInfo = GetBufferToTextureCopyInfo(Desc.Format, Region, 1);
+            if (SrcOffset + CopyInfo.MemorySize > PayloadSize)
+            {
+                LOG_ERROR_MESSAGE("Payload size (", PayloadSize, ") is not large enough to contain mip level ", Mip, " of slice ", Slice);
+                return false;
+            }
+
+            const auto MappedData = pUploadBuffer->GetMappedData(Mip, Slice);
+            for (Uint32 z = 0; z < Region.Depth(); ++z)
+            {
+                for (Uint32 row = 0; row < CopyInfo.RowCount; ++row)
+                {
+                    // clang-format off
+                    const auto* pSrcRow = pSrc + SrcOffset + z * CopyInfo.DepthStride + row * CopyInfo.RowStride;
+                    auto*       pDstRow = static_cast<Uint8*>(MappedData.pData) + z * MappedData.DepthStride + row * MappedData.Stride;
+                    // clang-format on
+                    std::memcpy(pDstRow, pSrcRow, static_cast<size_t>(CopyInfo.RowSize));
+                }
+            }
+            SrcOffset += static_cast<size_t>(CopyInfo.MemorySize);
+        }
+    }
+
+    return true;
+}
+
+} // namespace Diligent
@@ -34,6 +34,7 @@
 
 #if DILIGENT_D3D12_SUPPORTED || DILIGENT_VULKAN_SUPPORTED
 #    include "TextureUploaderD3D12_Vk.hpp"
+#    include "TextureUploaderStagingRing.hpp"
 #endif
 
 #if DILIGENT_GL_SUPPORTED || DILIGENT_GLES_SUPPORTED
@@ -46,7 +47,14 @@ namespace Diligent
 void CreateTextureUploader(IRenderDevice* pDevice, const TextureUploaderDesc& Desc, ITextureUploader** ppUploader)
 {
     *ppUploader = nullptr;
-    switch (pDevice->GetDeviceInfo().Type)
+
+    const auto DeviceType = pDevice->GetDeviceInfo().Type;
+    if (Desc.StagingRingSize != 0 && DeviceType != RENDER_DEVICE_TYPE_D3D12 && DeviceType != RENDER_DEVICE_TYPE_VULKAN)
+    {
+        LOG_WARNING_MESSAGE("Staging ring is only supported in Direct3D12 and Vulkan backends. StagingRingSize will be ignored.");
+    }
+
+    switch (DeviceType)
     {
 #if DILIGENT_D3D11_SUPPORTED
         case RENDER_DEVICE_TYPE_D3D11:
@@ -57,7 +65,10 @@ void CreateTextureUploader(IRenderDevice* pDevice, const TextureUploaderDesc& De
 #if DILIGENT_D3D12_SUPPORTED || DILIGENT_VULKAN_SUPPORTED
         case RENDER_DEVICE_TYPE_D3D12:
         case RENDER_DEVICE_TYPE_VULKAN:
-            *ppUploader = MakeNewRCObj<TextureUploaderD3D12_Vk>()(pDevice, Desc);
+            if (Desc.StagingRingSize != 0)
+                *ppUploader = MakeNewRCObj<TextureUploaderStagingRing>()(pDevice, Desc);
+            else
+                *ppUploader = MakeNewRCObj<TextureUploaderD3D12_Vk>()(pDevice, Desc);
             break;
 #endif
 
@@ -0,0 +1,629 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+#include "TextureUploaderStagingRing.hpp"
+#include "ThreadSignal.hpp"
+#include "GraphicsAccessories.hpp"
+#include "Align.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Direct3D12 requires buffer row pitch to be a multiple of 256 (D3D12_TEXTURE_DATA_PITCH_ALIGNMENT)
+// and buffer offset to be a multiple of 512 (D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT).
+// Both values also satisfy Vulkan buffer-to-image copy requirements.
+constexpr Uint32 StagingRowStrideAlignment    = 256;
+constexpr Uint32 StagingSubresOffsetAlignment = 512;
+
+class RingUploadBuffer : public UploadBufferBase
+{
+public:
+    // Fence value of a copy that has been scheduled, but not recorded into the context yet
+    static constexpr Uint64 PendingCopyFenceValue = ~Uint64{0};
+
+    struct SubresourceLayout
+    {
+        Uint64 Offset      = 0;
+        Uint64 Stride      = 0;
+        Uint64 DepthStride = 0;
+        Box    Region;
+    };
+
+    RingUploadBuffer(IReferenceCounters* pRefCounters, const UploadBufferDesc& Desc) :
+        // clang-format off
+        UploadBufferBase{pRefCounters, Desc},
+        m_Layout        (size_t{Desc.ArraySize} * size_t{Desc.MipLevels})
+    // clang-format on
+    {
+        Uint64 Offset = 0;
+        for (Uint32 Slice = 0; Slice < Desc.ArraySize; ++Slice)
+        {
+            for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+            {
+                const Box Region //
+                    {
+                        0, std::max(Desc.Width >> Mip, 1u),
+                        0, std::max(Desc.Height >> Mip, 1u),
+                        0, std::max(Desc.Depth >> Mip, 1u) //
+                    };
+                const auto CopyInfo = GetBufferToTextureCopyInfo(Desc.Format, Region, StagingRowStrideAlignment);
+
+                auto& Layout       = m_Layout[size_t{Desc.MipLevels} * size_t{Slice} + size_t{Mip}];
+                Layout.Offset      = AlignUp(Offset, Uint64{StagingSubresOffsetAlignment});
+                Layout.Stride      = CopyInfo.RowStride;
+                Layout.DepthStride = CopyInfo.DepthStride;
+                Layout.Region      = Region;
+
+                Offset = Layout.Offset + CopyInfo.MemorySize;
+            }
+        }
+        m_Size = AlignUp(Offset, Uint64{StagingSubresOffsetAlignment});
+    }
+
+    ~RingUploadBuffer()
+    {
+        DEV_CHECK_ERR(m_CopyFenceValue != PendingCopyFenceValue, "Releasing upload buffer with pending copy");
+    }
+
+    virtual void WaitForCopyScheduled() override final
+    {
+        m_CopyScheduledSignal.Wait();
+    }
+
+    void SignalCopyScheduled()
+    {
+        m_CopyScheduledSignal.Trigger(true);
+    }
+
+    bool DbgIsCopyScheduled() const
+    {
+        return m_CopyScheduledSignal.IsTriggered();
+    }
+
+    // Binds the buffer to the ring memory starting at the given offset
+    void Bind(Uint8* pRingData, Uint64 RingOffset)
+    {
+        m_RingOffset = RingOffset;
+        for (Uint32 Slice = 0; Slice < m_Desc.ArraySize; ++Slice)
+        {
+            for (Uint32 Mip = 0; Mip < m_Desc.MipLevels; ++Mip)
+            {
+                const auto& Layout = GetLayout(Mip, Slice);
+                SetMappedData(Mip, Slice, MappedTextureSubresource{pRingData + RingOffset + Layout.Offset, Layout.Stride, Layout.DepthStride});
+            }
+        }
+    }
+
+    const SubresourceLayout& GetLayout(Uint32 Mip, Uint32 Slice) const
+    {
+        VERIFY_EXPR(Mip < m_Desc.MipLevels && Slice < m_Desc.ArraySize);
+        return m_Layout[size_t{m_Desc.MipLevels} * size_t{Slice} + size_t{Mip}];
+    }
+
+    Uint64 GetSize() const { return m_Size; }
+    Uint64 GetRingOffset() const { return m_RingOffset; }
+
+    // The following members are protected by the uploader's ring mutex
+
+    // Fence value that is signaled when the GPU finishes the copy,
+    // zero if the copy has never been scheduled.
+    Uint64 m_CopyFenceValue = 0;
+    bool   m_IsRecycled     = false;
+
+private:
+    Threading::Signal m_CopyScheduledSignal;
+
+    std::vector<SubresourceLayout> m_Layout;
+
+    Uint64 m_Size       = 0;
+    Uint64 m_RingOffset = 0;
+};
+
+} // namespace
+
+struct TextureUploaderStagingRing::InternalData
+{
+    using ClockType = std::chrono::steady_clock;
+
+    struct PendingCopy
+    {
+        RefCntAutoPtr<RingUploadBuffer> pUploadBuffer;
+        RefCntAutoPtr<ITexture>         pDstTexture;
+        Uint32                          DstSlice = 0;
+        Uint32                          DstMip   = 0;
+        ClockType::time_point           ScheduleTime;
+
+        // clang-format off
+        PendingCopy(RingUploadBuffer* pUploadBuff, ITexture* pDstTex, Uint32 dstSlice, Uint32 dstMip) :
+            pUploadBuffer{pUploadBuff      },
+            pDstTexture  {pDstTex          },
+            DstSlice     {dstSlice         },
+            DstMip       {dstMip           },
+            ScheduleTime {ClockType::now() }
+        {}
+        // clang-format on
+    };
+
+    struct RingAllocation
+    {
+        RefCntAutoPtr<RingUploadBuffer> pUploadBuffer;
+
+        // Ring offset right after the end of the allocation
+        Uint64 End = 0;
+        // The size of the allocation, including the padding at the end of the ring
+        Uint64 Size = 0;
+    };
+
+    InternalData(IRenderDevice* pDevice, const TextureUploaderDesc& Desc) :
+        m_RingSize{AlignDown(Desc.StagingRingSize, Uint64{StagingSubresOffsetAlignment})},
+        m_FrameBudget{Desc.FrameBudget}
+    {
+        if (m_RingSize == 0)
+            LOG_ERROR_AND_THROW("Staging ring size (", Desc.StagingRingSize, ") must be at least ", StagingSubresOffsetAlignment, " bytes");
+
+        BufferDesc RingDesc;
+        RingDesc.Name           = "Texture uploader staging ring";
+        RingDesc.Size           = m_RingSize;
+        RingDesc.Usage          = USAGE_STAGING;
+        RingDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
+        pDevice->CreateBuffer(RingDesc, nullptr, &m_pRingBuffer);
+        if (!m_pRingBuffer)
+            LOG_ERROR_AND_THROW("Failed to create the staging ring buffer");
+
+        m_IsRingCoherent = (m_pRingBuffer->GetMemoryProperties() & MEMORY_PROPERTY_HOST_COHERENT) != 0;
+
+        FenceDesc fenceDesc;
+        fenceDesc.Name = "Texture uploader staging ring fence";
+        pDevice->CreateFence(fenceDesc, &m_pFence);
+    }
+
+    ~InternalData()
+    {
+        if (m_pMapContext)
+            m_pMapContext->UnmapBuffer(m_pRingBuffer, MAP_WRITE);
+    }
+
+    // Must be called by the render thread
+    void MapRing(IDeviceContext* pContext)
+    {
+        if (m_pRingData != nullptr)
+            return;
+
+        PVoid pData = nullptr;
+        pContext->MapBuffer(m_pRingBuffer, MAP_WRITE, MAP_FLAG_NONE, pData);
+        if (pData == nullptr)
+        {
+            LOG_ERROR_MESSAGE("Failed to map the staging ring buffer");
+            return;
+        }
+        // The buffer stays mapped until the uploader is destroyed
+        m_pRingData   = static_cast<Uint8*>(pData);
+        m_pMapContext = pContext;
+        m_RingMappedSignal.Trigger(true);
+    }
+
+    Uint8* WaitForRingMapped()
+    {
+        m_RingMappedSignal.Wait();
+        return m_pRingData;
+    }
+
+    // Must be called with the ring mutex locked
+    bool TryAllocateLocked(RingUploadBuffer* pUploadBuffer, Uint64& Offset)
+    {
+        const auto Size = pUploadBuffer->GetSize();
+        VERIFY_EXPR(Size > 0 && (Size % StagingSubresOffsetAlignment) == 0);
+        if (m_UsedSize + Size > m_RingSize)
+            return false;
+
+        Uint64 AllocSize = 0;
+        if (m_Head >= m_Tail)
+        {
+            //                     Tail          Head            RingSize
+            //                     |                |            |
+            //  [                  xxxxxxxxxxxxxxxxx             ]
+            //
+            if (m_Head + Size <= m_RingSize)
+            {
+                Offset    = m_Head;
+                AllocSize = Size;
+            }
+            else if (Size <= m_Tail)
+            {
+                // Allocate from the beginning of the ring and
+                // add the unused space at the end to the allocation
+                Offset    = 0;
+                AllocSize = (m_RingSize - m_Head) + Size;
+            }
+        }
+        else if (m_Head + Size <= m_Tail)
+        {
+            //    Head          Tail
+            //       |          |
+            //  [xxxx           xxxxxxxxxxxxxxxxxxxxxxxxxx]
+            //
+            Offset    = m_Head;
+            AllocSize = Size;
+        }
+
+        if (AllocSize == 0)
+            return false;
+
+        m_Head = Offset + Size;
+        m_UsedSize += AllocSize;
+        m_Allocations.push_back(RingAllocation{RefCntAutoPtr<RingUploadBuffer>{pUploadBuffer}, m_Head, AllocSize});
+        return true;
+    }
+
+    // Must be called with the ring mutex locked
+    void ReleaseCompletedAllocationsLocked()
+    {
+        bool Released = false;
+        // Allocations are released in order. An allocation can be released after it
+        // has been recycled by the application and the GPU has finished the copy.
+        while (!m_Allocations.empty())
+        {
+            const auto& Allocation = m_Allocations.front();
+            const auto& UploadBuff = *Allocation.pUploadBuffer;
+            if (!UploadBuff.m_IsRecycled || UploadBuff.m_CopyFenceValue > m_CompletedFenceValue)
+                break;
+
+            VERIFY_EXPR(m_UsedSize >= Allocation.Size);
+            m_UsedSize -= Allocation.Size;
+            m_Tail = Allocation.End;
+            m_Allocations.pop_front();
+            Released = true;
+        }
+
+        if (m_UsedSize == 0)
+        {
+            VERIFY_EXPR(m_Allocations.empty());
+            m_Head = m_Tail = 0;
+        }
+
+        if (Released)
+            m_RingSpaceCV.notify_all();
+    }
+
+    void EnqueueCopy(RingUploadBuffer* pUploadBuffer, ITexture* pDstTex, Uint32 DstSlice, Uint32 DstMip)
+    {
+        {
+            std::lock_guard<std::mutex> RingLock{m_RingMtx};
+            DEV_CHECK_ERR(pUploadBuffer->m_CopyFenceValue == 0, "Copy from this upload buffer has already been scheduled");
+            pUploadBuffer->m_CopyFenceValue = RingUploadBuffer::PendingCopyFenceValue;
+        }
+
+        std::lock_guard<std::mutex> QueueLock{m_PendingCopiesMtx};
+        m_PendingCopies.emplace_back(pUploadBuffer, pDstTex, DstSlice, DstMip);
+    }
+
+    // Must be called by the render thread
+    void ExecutePendingCopies(IDeviceContext* pContext, bool IgnoreBudget);
+
+    // Must be called by the render thread
+    void UpdateCompletedFenceValue()
+    {
+        // Fences can't be accessed from multiple threads simultaneously even
+        // when protected by mutex
+        const auto CompletedFenceValue = m_pFence->GetCompletedValue();
+
+        std::lock_guard<std::mutex> RingLock{m_RingMtx};
+        m_CompletedFenceValue = CompletedFenceValue;
+        ReleaseCompletedAllocationsLocked();
+    }
+
+    // Must be called by the render thread
+    void WaitForGPU(IDeviceContext* pContext)
+    {
+        if (m_NextFenceValue > 1)
+        {
+            pContext->Flush();
+            m_pFence->Wait(m_NextFenceValue - 1);
+        }
+        UpdateCompletedFenceValue();
+    }
+
+    Uint32 GetNumPendingOperations()
+    {
+        std::lock_guard<std::mutex> QueueLock{m_PendingCopiesMtx};
+        return static_cast<Uint32>(m_PendingCopies.size()) + m_NumDeferredCopies.load();
+    }
+
+    const Uint64 m_RingSize;
+    const Uint64 m_FrameBudget;
+
+    std::mutex                 m_RingMtx;
+    std::condition_variable    m_RingSpaceCV;
+    std::deque<RingAllocation> m_Allocations;
+    Uint64                     m_Head                = 0;
+    Uint64                     m_Tail                = 0;
+    Uint64                     m_UsedSize            = 0;
+    Uint64                     m_CompletedFenceValue = 0;
+
+    // Statistics, protected by the ring mutex
+    Uint32 m_NumStalls             = 0;
+    Uint64 m_BytesCopiedLastUpdate = 0;
+    Uint64 m_NumCopies             = 0;
+    double m_TotalQueueLatency     = 0;
+    double m_MaxQueueLatency       = 0;
+
+    std::mutex               m_PendingCopiesMtx;
+    std::vector<PendingCopy> m_PendingCopies;
+
+    // Copies that did not fit into the frame budget.
+    // Only accessed by the render thread.
+    std::vector<PendingCopy> m_DeferredCopies;
+    std::atomic<Uint32>      m_NumDeferredCopies{0};
+    Uint64                   m_BytesCopiedThisUpdate = 0;
+
+    RefCntAutoPtr<IBuffer>        m_pRingBuffer;
+    RefCntAutoPtr<IDeviceContext> m_pMapContext;
+    Uint8*                        m_pRingData = nullptr;
+    Threading::Signal             m_RingMappedSignal;
+    bool                          m_IsRingCoherent = false;
+
+    RefCntAutoPtr<IFence> m_pFence;
+    Uint64                m_NextFenceValue = 1;
+};
+
+void TextureUploaderStagingRing::InternalData::ExecutePendingCopies(IDeviceContext* pContext, bool IgnoreBudget)
+{
+    {
+        std::lock_guard<std::mutex> QueueLock{m_PendingCopiesMtx};
+        for (auto& Copy : m_PendingCopies)
+            m_DeferredCopies.emplace_back(std::move(Copy));
+        m_PendingCopies.clear();
+        // Update the counter under the lock so that GetNumPendingOperations() does not
+        // miss the moved copies, even if none of them fits into the frame budget below.
+        m_NumDeferredCopies.store(static_cast<Uint32>(m_DeferredCopies.size()));
+    }
+    if (m_DeferredCopies.empty())
+        return;
+
+    // Stable sort preserves the submission order of copies with the same priority
+    std::stable_sort(m_DeferredCopies.begin(), m_DeferredCopies.end(),
+                     [](const PendingCopy& lhs, const PendingCopy& rhs) {
+                         return lhs.pUploadBuffer->GetDesc().Priority > rhs.pUploadBuffer->GetDesc().Priority;
+                     });
+
+    const auto CurrTime = ClockType::now();
+
+    double TotalLatency = 0;
+    double MaxLatency   = 0;
+    size_t NumExecuted  = 0;
+    for (; NumExecuted < m_DeferredCopies.size(); ++NumExecuted)
+    {
+        auto&       Copy       = m_DeferredCopies[NumExecuted];
+        auto&       UploadBuff = *Copy.pUploadBuffer;
+        const auto  CopySize   = UploadBuff.GetSize();
+        // Always execute at least one copy to make progress
+        if (!IgnoreBudget && m_FrameBudget != 0 && m_BytesCopiedThisUpdate != 0 && m_BytesCopiedThisUpdate + CopySize > m_FrameBudget)
+            break;
+
+        if (!m_IsRingCoherent)
+            m_pRingBuffer->FlushMappedRange(UploadBuff.GetRingOffset(), CopySize);
+
+        const auto& BuffDesc = UploadBuff.GetDesc();
+        for (Uint32 Slice = 0; Slice < BuffDesc.ArraySize; ++Slice)
+        {
+            for (Uint32 Mip = 0; Mip < BuffDesc.MipLevels; ++Mip)
+            {
+                const auto&             Layout = UploadBuff.GetLayout(Mip, Slice);
+                const TextureSubResData SubresData{m_pRingBuffer, UploadBuff.GetRingOffset() + Layout.Offset, Layout.Stride, Layout.DepthStride};
+                pContext->UpdateTexture(Copy.pDstTexture, Copy.DstMip + Mip, Copy.DstSlice + Slice, Layout.Region, SubresData,
+                                        RESOURCE_STATE_TRANSITION_MODE_TRANSITION, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+            }
+        }
+        m_BytesCopiedThisUpdate += CopySize;
+
+        const double Latency = std::chrono::duration<double>(CurrTime - Copy.ScheduleTime).count();
+        TotalLatency += Latency;
+        MaxLatency = std::max(MaxLatency, Latency);
+    }
+
+    if (NumExecuted == 0)
+        return;
+
+    // The buffer may be recycled immediately after the copy scheduled is signaled,
+    // so we must signal the fence first.
+    const auto FenceValue = m_NextFenceValue++;
+    pContext->EnqueueSignal(m_pFence, FenceValue);
+
+    {
+        std::lock_guard<std::mutex> RingLock{m_RingMtx};
+        for (size_t i = 0; i < NumExecuted; ++i)
+            m_DeferredCopies[i].pUploadBuffer->m_CopyFenceValue = FenceValue;
+
+        m_NumCopies += NumExecuted;
+        m_TotalQueueLatency += TotalLatency;
+        m_MaxQueueLatency = std::max(m_MaxQueueLatency, MaxLatency);
+    }
+
+    for (size_t i = 0; i < NumExecuted; ++i)
+        m_DeferredCopies[i].pUploadBuffer->SignalCopyScheduled();
+
+    m_DeferredCopies.erase(m_DeferredCopies.begin(), m_DeferredCopies.begin() + NumExecuted);
+    m_NumDeferredCopies.store(static_cast<Uint32>(m_DeferredCopies.size()));
+}
+
+TextureUploaderStagingRing::TextureUploaderStagingRing(IReferenceCounters* pRefCounters, IRenderDevice* pDevice, const TextureUploaderDesc Desc) :
+    TextureUploaderBase{pRefCounters, pDevice, Desc},
+    m_pInternalData{new InternalData{pDevice, Desc}}
+{
+}
+
+TextureUploaderStagingRing::~TextureUploaderStagingRing()
+{
+    auto NumPendingOperations = m_pInternalData->GetNumPendingOperations();
+    if (NumPendingOperations != 0)
+    {
+        LOG_WARNING_MESSAGE("TextureUploaderStagingRing::~TextureUploaderStagingRing(): there ", (NumPendingOperations > 1 ? "are " : "is "),
+                            NumPendingOperations, (NumPendingOperations > 1 ? " pending operations" : " pending operation"),
+                            " in the queue. If other threads wait for ", (NumPendingOperations > 1 ? "these operations" : "this operation"),
+                            ", they may deadlock.");
+    }
+}
+
+void TextureUploaderStagingRing::RenderThreadUpdate(IDeviceContext* pContext)
+{
+    m_pInternalData->MapRing(pContext);
+
+    m_pInternalData->m_BytesCopiedThisUpdate = 0;
+    m_pInternalData->ExecutePendingCopies(pContext, false);
+    {
+        std::lock_guard<std::mutex> RingLock{m_pInternalData->m_RingMtx};
+        m_pInternalData->m_BytesCopiedLastUpdate = m_pInternalData->m_BytesCopiedThisUpdate;
+    }
+
+    // This must be called by the same thread that signals the fence
+    m_pInternalData->UpdateCompletedFenceValue();
+}
+
+void TextureUploaderStagingRing::AllocateUploadBuffer(IDeviceContext*         pContext,
+                                                      const UploadBufferDesc& Desc,
+                                                      IUploadBuffer**         ppBuffer)
+{
+    DEV_CHECK_ERR(ppBuffer != nullptr, "ppBuffer must not be null");
+    *ppBuffer = nullptr;
+
+    RefCntAutoPtr<RingUploadBuffer> pUploadBuffer{MakeNewRCObj<RingUploadBuffer>()(Desc)};
+    if (pUploadBuffer->GetSize() > m_pInternalData->m_RingSize)
+    {
+        LOG_ERROR_MESSAGE("The size of the ", Desc.Width, 'x', Desc.Height, 'x', Desc.Depth, ' ', Desc.MipLevels, "-mip ",
+                          Desc.ArraySize, "-slice ", GetTextureFormatAttribs(Desc.Format).Name, " upload buffer (", pUploadBuffer->GetSize(),
+                          " bytes) exceeds the staging ring size (", m_pInternalData->m_RingSize, " bytes)");
+        return;
+    }
+
+    Uint64 Offset = 0;
+    if (pContext != nullptr)
+    {
+        // Render thread
+        m_pInternalData->MapRing(pContext);
+
+        bool Allocated = false;
+        {
+            std::lock_guard<std::mutex> RingLock{m_pInternalData->m_RingMtx};
+            Allocated = m_pInternalData->TryAllocateLocked(pUploadBuffer, Offset);
+            if (!Allocated)
+                ++m_pInternalData->m_NumStalls;
+        }
+
+        if (!Allocated)
+        {
+            // Record all pending copies regardless of the budget and wait
+            // until the GPU finishes them to free space in the ring
+            m_pInternalData->ExecutePendingCopies(pContext, true);
+            m_pInternalData->WaitForGPU(pContext);
+
+            std::lock_guard<std::mutex> RingLock{m_pInternalData->m_RingMtx};
+            Allocated = m_pInternalData->TryAllocateLocked(pUploadBuffer, Offset);
+        }
+
+        if (!Allocated)
+        {
+            LOG_ERROR_MESSAGE("Failed to allocate ", pUploadBuffer->GetSize(), " bytes in the staging ring. "
+                              "Make sure that upload buffers are recycled after the copies have been scheduled.");
+            return;
+        }
+    }
+    else
+    {
+        // Worker thread. The render thread maps the ring in RenderThreadUpdate().
+        m_pInternalData->WaitForRingMapped();
+
+        std::unique_lock<std::mutex> RingLock{m_pInternalData->m_RingMtx};
+        if (!m_pInternalData->TryAllocateLocked(pUploadBuffer, Offset))
+        {
+            ++m_pInternalData->m_NumStalls;
+            // Space is released by the render thread in RenderThreadUpdate() or when buffers are recycled
+            m_pInternalData->m_RingSpaceCV.wait(RingLock, [&]() {
+                return m_pInternalData->TryAllocateLocked(pUploadBuffer, Offset);
+            });
+        }
+    }
+
+    pUploadBuffer->Bind(m_pInternalData->m_pRingData, Offset);
+    *ppBuffer = pUploadBuffer.Detach();
+}
+
+void TextureUploaderStagingRing::ScheduleGPUCopy(IDeviceContext* pContext,
+                                                 ITexture*       pDstTexture,
+                                                 Uint32          ArraySlice,
+                                                 Uint32          MipLevel,
+                                                 IUploadBuffer*  pUploadBuffer)
+{
+    auto* pRingUploadBuffer = ClassPtrCast<RingUploadBuffer>(pUploadBuffer);
+    m_pInternalData->EnqueueCopy(pRingUploadBuffer, pDstTexture, ArraySlice, MipLevel);
+    if (pContext != nullptr)
+    {
+        // Render thread. The copy may be deferred if it does not fit into the budget.
+        m_pInternalData->ExecutePendingCopies(pContext, false);
+        // This must be called by the same thread that signals the fence
+        m_pInternalData->UpdateCompletedFenceValue();
+    }
+}
+
+void TextureUploaderStagingRing::RecycleBuffer(IUploadBuffer* pUploadBuffer)
+{
+    auto* pRingUploadBuffer = ClassPtrCast<RingUploadBuffer>(pUploadBuffer);
+
+    // Unlike staging textures, ring memory can be recycled before the copy has been scheduled.
+    // It is released once the GPU finishes the copy.
+    std::lock_guard<std::mutex> RingLock{m_pInternalData->m_RingMtx};
+    DEV_CHECK_ERR(!pRingUploadBuffer->m_IsRecycled, "This upload buffer has already been recycled");
+    pRingUploadBuffer->m_IsRecycled = true;
+    m_pInternalData->ReleaseCompletedAllocationsLocked();
+}
+
+TextureUploaderStats TextureUploaderStagingRing::GetStats()
+{
+    TextureUploaderStats Stats;
+    Stats.NumPendingOperations = m_pInternalData->GetNumPendingOperations();
+
+    std::lock_guard<std::mutex> RingLock{m_pInternalData->m_RingMtx};
+    Stats.BytesInFlight         = m_pInternalData->m_UsedSize;
+    Stats.BytesCopiedLastUpdate = m_pInternalData->m_BytesCopiedLastUpdate;
+    Stats.NumStalls             = m_pInternalData->m_NumStalls;
+    Stats.MaxQueueLatency       = m_pInternalData->m_MaxQueueLatency;
+    if (m_pInternalData->m_NumCopies > 0)
+        Stats.AvgQueueLatency = m_pInternalData->m_TotalQueueLatency / static_cast<double>(m_pInternalData->m_NumCopies);
+    return Stats;
+}
+
+} // namespace Diligent
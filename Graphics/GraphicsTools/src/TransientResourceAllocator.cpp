@@ -0,0 +1,486 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "TransientResourceAllocator.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "DebugUtilities.hpp"
+#include "GraphicsAccessories.hpp"
+#include "Align.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+bool LifetimesOverlap(const TransientResourceLifetime& Res0, const TransientResourceLifetime& Res1)
+{
+    return Res0.FirstUse <= Res1.LastUse && Res1.FirstUse <= Res0.LastUse;
+}
+
+} // namespace
+
+void TransientMemoryPlanner::Plan(const TransientResourceLifetime* pResources, Uint32 NumResources)
+{
+    m_Offsets.assign(NumResources, 0);
+    m_AliasedResources.clear();
+    m_AliasedResources.resize(NumResources);
+    m_MemorySize          = 0;
+    m_UnaliasedMemorySize = 0;
+    m_PeakWorkingSetSize  = 0;
+
+    if (NumResources == 0)
+        return;
+
+    DEV_CHECK_ERR(pResources != nullptr, "pResources must not be null");
+#ifdef DILIGENT_DEVELOPMENT
+    for (Uint32 i = 0; i < NumResources; ++i)
+    {
+        const auto& Res = pResources[i];
+        DEV_CHECK_ERR(IsPowerOfTwo(Res.Alignment), "Alignment of resource ", i, " (", Res.Alignment, ") is not a power of two");
+        DEV_CHECK_ERR(Res.FirstUse <= Res.LastUse, "First use (", Res.FirstUse, ") of resource ", i, " is greater than its last use (", Res.LastUse, ")");
+    }
+#endif
+
+    // Placing large resources first reduces fragmentation
+    std::vector<Uint32> Order(NumResources);
+    std::iota(Order.begin(), Order.end(), 0u);
+    std::sort(Order.begin(), Order.end(),
+              [pResources](Uint32 i0, Uint32 i1) {
+                  const auto& Res0 = pResources[i0];
+                  const auto& Res1 = pResources[i1];
+                  if (Res0.Size != Res1.Size)
+                      return Res0.Size > Res1.Size;
+                  if (Res0.FirstUse != Res1.FirstUse)
+                      return Res0.FirstUse < Res1.FirstUse;
+                  return i0 < i1;
+              });
+
+    std::vector<Uint32>                     Placed;
+    std::vector<std::pair<Uint64, Uint64>> BusyRanges;
+    Placed.reserve(NumResources);
+    for (auto ResIdx : Order)
+    {
+        const auto& Res = pResources[ResIdx];
+
+        // Memory ranges that can't be used by this resource because they are occupied
+        // by resources that are alive at the same time.
+        BusyRanges.clear();
+        for (auto PlacedIdx : Placed)
+        {
+            if (LifetimesOverlap(Res, pResources[PlacedIdx]))
+                BusyRanges.emplace_back(m_Offsets[PlacedIdx], m_Offsets[PlacedIdx] + pResources[PlacedIdx].Size);
+        }
+        std::sort(BusyRanges.begin(), BusyRanges.end());
+
+        // Find the first gap large enough to fit the resource
+        Uint64 Offset = 0;
+        for (const auto& Range : BusyRanges)
+        {
+            Offset = AlignUp(Offset, std::max(Res.Alignment, Uint64{1}));
+            if (Offset + Res.Size <= Range.first)
+                break;
+            Offset = std::max(Offset, Range.second);
+        }
+        Offset = AlignUp(Offset, std::max(Res.Alignment, Uint64{1}));
+
+        m_Offsets[ResIdx] = Offset;
+        m_MemorySize      = std::max(m_MemorySize, Offset + Res.Size);
+        Placed.push_back(ResIdx);
+    }
+
+    for (Uint32 i = 0; i < NumResources; ++i)
+    {
+        const auto& Res0 = pResources[i];
+        m_UnaliasedMemorySize += Res0.Size;
+
+        Uint64 WorkingSetSize = 0;
+        for (Uint32 j = 0; j < NumResources; ++j)
+        {
+            const auto& Res1 = pResources[j];
+            // The working set reaches its maximum at the first use of one of the resources
+            if (Res1.FirstUse <= Res0.FirstUse && Res0.FirstUse <= Res1.LastUse)
+                WorkingSetSize += Res1.Size;
+
+            if (i != j && m_Offsets[i] < m_Offsets[j] + Res1.Size && m_Offsets[j] < m_Offsets[i] + Res0.Size)
+            {
+                VERIFY(!LifetimesOverlap(Res0, Res1), "Resources ", i, " and ", j, " are alive at the same time and must not share memory");
+                m_AliasedResources[i].push_back(j);
+            }
+        }
+        m_PeakWorkingSetSize = std::max(m_PeakWorkingSetSize, WorkingSetSize);
+    }
+}
+
+Uint64 TransientMemoryPlanner::GetOffset(Uint32 ResIndex) const
+{
+    VERIFY_EXPR(ResIndex < m_Offsets.size());
+    return m_Offsets[ResIndex];
+}
+
+const std::vector<Uint32>& TransientMemoryPlanner::GetAliasedResources(Uint32 ResIndex) const
+{
+    VERIFY_EXPR(ResIndex < m_AliasedResources.size());
+    return m_AliasedResources[ResIndex];
+}
+
+
+namespace
+{
+
+bool IsSparseAliasingSupported(IRenderDevice* pDevice, const TextureDesc& Desc)
+{
+    const auto& Features = pDevice->GetDeviceInfo().Features;
+    if (!Features.SparseResources)
+        return false;
+
+    const auto& SparseRes = pDevice->GetAdapterInfo().SparseResources;
+    if ((SparseRes.CapFlags & SPARSE_RESOURCE_CAP_FLAG_ALIASED) == 0)
+        return false;
+
+    if (Desc.Type != RESOURCE_DIM_TEX_2D && Desc.Type != RESOURCE_DIM_TEX_2D_ARRAY)
+        return false;
+
+    if ((SparseRes.CapFlags & SPARSE_RESOURCE_CAP_FLAG_TEXTURE_2D) == 0)
+        return false;
+
+    if (Desc.Type == RESOURCE_DIM_TEX_2D_ARRAY && (SparseRes.CapFlags & SPARSE_RESOURCE_CAP_FLAG_TEXTURE_2D_ARRAY_MIP_TAIL) == 0)
+    {
+        // Without the mip tail capability, every mip level of a texture array must be at least one tile in size
+        // (see ValidateTextureDesc())
+        const auto   Props    = GetStandardSparseTextureProperties(Desc);
+        const Uint32 LastMipW = std::max(1u, Desc.Width >> Desc.MipLevels);
+        const Uint32 LastMipH = std::max(1u, Desc.Height >> Desc.MipLevels);
+        if (LastMipW < Props.TileSize[0] || LastMipH < Props.TileSize[1])
+            return false;
+    }
+
+    if (Desc.SampleCount > 1)
+    {
+        const auto SampleCap =
+            Desc.SampleCount == 2 ? SPARSE_RESOURCE_CAP_FLAG_TEXTURE_2_SAMPLES :
+            Desc.SampleCount == 4 ? SPARSE_RESOURCE_CAP_FLAG_TEXTURE_4_SAMPLES :
+            Desc.SampleCount == 8 ? SPARSE_RESOURCE_CAP_FLAG_TEXTURE_8_SAMPLES :
+                                    SPARSE_RESOURCE_CAP_FLAG_TEXTURE_16_SAMPLES;
+        if ((SparseRes.CapFlags & SampleCap) == 0)
+            return false;
+    }
+
+    const auto& SparseInfo = pDevice->GetSparseTextureFormatInfo(Desc.Format, Desc.Type, Desc.SampleCount);
+    return (SparseInfo.BindFlags & Desc.BindFlags) == Desc.BindFlags;
+}
+
+// Appends the memory ranges that cover the entire sparse texture and returns the total memory size.
+// The ranges are bound to pMemory starting at BaseOffset.
+Uint64 GetSparseTextureRanges(const TextureDesc&                         Desc,
+                              const SparseTextureProperties&             Props,
+                              IDeviceMemory*                             pMemory,
+                              Uint64                                     BaseOffset,
+                              std::vector<SparseTextureMemoryBindRange>& Ranges)
+{
+    const auto NumNormalMips = std::min(Desc.MipLevels, Props.FirstMipInTail);
+    const auto HasMipTail    = Desc.MipLevels > Props.FirstMipInTail;
+    const auto SingleMipTail = (Props.FirstMipInTail != ~0u) && (Props.Flags & SPARSE_TEXTURE_FLAG_SINGLE_MIPTAIL) != 0;
+    const auto NumSlices     = Desc.IsArray() ? Desc.ArraySize : 1u;
+
+    Uint64 Offset = 0;
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+    {
+        for (Uint32 Mip = 0; Mip < NumNormalMips; ++Mip)
+        {
+            const auto MipProps = GetMipLevelProperties(Desc, Mip);
+
+            SparseTextureMemoryBindRange Range;
+            Range.ArraySlice = Slice;
+            Range.MipLevel   = Mip;
+            Range.Region     = Box{0, MipProps.StorageWidth, 0, MipProps.StorageHeight, 0, MipProps.Depth};
+
+            const auto NumTiles = GetNumSparseTilesInBox(Range.Region, Props.TileSize);
+            Range.MemorySize    = Uint64{NumTiles.x} * NumTiles.y * NumTiles.z * Props.BlockSize;
+            Range.MemoryOffset  = BaseOffset + Offset;
+            Range.pMemory       = pMemory;
+            Ranges.push_back(Range);
+
+            Offset += Range.MemorySize;
+        }
+
+        if (HasMipTail && (!SingleMipTail || Slice == 0))
+        {
+            SparseTextureMemoryBindRange Range;
+            Range.ArraySlice   = Slice;
+            Range.MipLevel     = Props.FirstMipInTail;
+            Range.MemorySize   = Props.MipTailSize;
+            Range.MemoryOffset = BaseOffset + Offset;
+            Range.pMemory      = pMemory;
+            Ranges.push_back(Range);
+
+            Offset += Range.MemorySize;
+        }
+    }
+
+    return Offset;
+}
+
+} // namespace
+
+TransientResourceAllocator::TransientResourceAllocator(const TransientResourceAllocatorCreateInfo& CreateInfo) :
+    m_Name{CreateInfo.Name != nullptr ? CreateInfo.Name : "Transient resource allocator"},
+    m_ImmediateContextMask{CreateInfo.ImmediateContextMask}
+{
+}
+
+Uint32 TransientResourceAllocator::AddTexture(const TextureDesc& Desc, Uint32 FirstUse, Uint32 LastUse)
+{
+    DEV_CHECK_ERR(!m_IsCommitted, "Textures can't be added after the allocator has been committed. Call Reset() first.");
+    DEV_CHECK_ERR(FirstUse <= LastUse, "First use (", FirstUse, ") of texture '", (Desc.Name != nullptr ? Desc.Name : ""),
+                  "' is greater than its last use (", LastUse, ")");
+
+    m_Textures.emplace_back();
+    auto& TexInfo    = m_Textures.back();
+    TexInfo.Name     = Desc.Name != nullptr ? Desc.Name : "Transient texture";
+    TexInfo.Desc     = Desc;
+    TexInfo.FirstUse = FirstUse;
+    TexInfo.LastUse  = std::max(FirstUse, LastUse);
+    if (TexInfo.Desc.MipLevels == 0)
+        TexInfo.Desc.MipLevels = ComputeMipLevelsCount(Desc.GetWidth(), Desc.GetHeight());
+
+    return static_cast<Uint32>(m_Textures.size() - 1);
+}
+
+bool TransientResourceAllocator::CreateSparseTexture(IRenderDevice* pDevice, TextureInfo& TexInfo)
+{
+    if (!IsSparseAliasingSupported(pDevice, TexInfo.Desc))
+        return false;
+
+    auto Desc                 = TexInfo.Desc;
+    Desc.Name                 = TexInfo.Name.c_str();
+    Desc.Usage                = USAGE_SPARSE;
+    Desc.MiscFlags            = Desc.MiscFlags | MISC_TEXTURE_FLAG_SPARSE_ALIASING;
+    Desc.ImmediateContextMask = m_ImmediateContextMask;
+
+    pDevice->CreateTexture(Desc, nullptr, &TexInfo.pTexture);
+    if (!TexInfo.pTexture)
+        return false;
+
+    std::vector<SparseTextureMemoryBindRange> Ranges;
+    TexInfo.MemorySize = GetSparseTextureRanges(TexInfo.Desc, TexInfo.pTexture->GetSparseProperties(), nullptr, 0, Ranges);
+    return true;
+}
+
+void TransientResourceAllocator::Commit(IRenderDevice* pDevice, IDeviceContext* pContext)
+{
+    DEV_CHECK_ERR(!m_IsCommitted, "The allocator has already been committed");
+    DEV_CHECK_ERR(pDevice != nullptr && pContext != nullptr, "pDevice and pContext must not be null");
+    m_IsCommitted = true;
+    m_DeviceType  = pDevice->GetDeviceInfo().Type;
+
+    // Without mixed resource type support, render targets and depth buffers can't share
+    // memory with other textures, so they are placed into a separate heap.
+    const bool MixedResourceTypes = (pDevice->GetAdapterInfo().SparseResources.CapFlags & SPARSE_RESOURCE_CAP_FLAG_MIXED_RESOURCE_TYPE_SUPPORT) != 0;
+    m_Heaps.resize(MixedResourceTypes ? 1 : 2);
+
+    for (Uint32 TexIdx = 0; TexIdx < m_Textures.size(); ++TexIdx)
+    {
+        auto& TexInfo = m_Textures[TexIdx];
+        if (CreateSparseTexture(pDevice, TexInfo))
+        {
+            TexInfo.HeapIndex = (!MixedResourceTypes && (TexInfo.Desc.BindFlags & (BIND_RENDER_TARGET | BIND_DEPTH_STENCIL)) != 0) ? 1 : 0;
+            m_Heaps[TexInfo.HeapIndex].Textures.push_back(TexIdx);
+        }
+    }
+
+    for (auto& Heap : m_Heaps)
+    {
+        if (Heap.Textures.empty())
+            continue;
+
+        std::vector<TransientResourceLifetime> Lifetimes(Heap.Textures.size());
+        std::vector<IDeviceObject*>            CompatibleResources(Heap.Textures.size());
+        for (size_t i = 0; i < Heap.Textures.size(); ++i)
+        {
+            const auto& TexInfo = m_Textures[Heap.Textures[i]];
+
+            auto& Lifetime     = Lifetimes[i];
+            Lifetime.Size      = TexInfo.MemorySize;
+            Lifetime.Alignment = TexInfo.pTexture->GetSparseProperties().BlockSize;
+            Lifetime.FirstUse  = TexInfo.FirstUse;
+            Lifetime.LastUse   = TexInfo.LastUse;
+
+            CompatibleResources[i] = TexInfo.pTexture.RawPtr<ITexture>();
+        }
+
+        TransientMemoryPlanner Plan;
+        Plan.Plan(Lifetimes.data(), static_cast<Uint32>(Lifetimes.size()));
+
+        Heap.MemorySize          = Plan.GetMemorySize();
+        Heap.UnaliasedMemorySize = Plan.GetUnaliasedMemorySize();
+
+        const auto MemoryName = m_Name + " memory";
+
+        DeviceMemoryCreateInfo MemCI;
+        MemCI.Desc.Name                 = MemoryName.c_str();
+        MemCI.Desc.Type                 = DEVICE_MEMORY_TYPE_SPARSE;
+        MemCI.Desc.PageSize             = Heap.MemorySize;
+        MemCI.Desc.ImmediateContextMask = m_ImmediateContextMask;
+        MemCI.InitialSize               = Heap.MemorySize;
+        MemCI.ppCompatibleResources     = CompatibleResources.data();
+        MemCI.NumResources              = static_cast<Uint32>(CompatibleResources.size());
+        pDevice->CreateDeviceMemory(MemCI, &Heap.pMemory);
+        if (!Heap.pMemory)
+        {
+            LOG_ERROR_MESSAGE("Failed to create memory for transient textures of allocator '", m_Name, "'. Dedicated textures will be used instead.");
+            for (auto TexIdx : Heap.Textures)
+            {
+                m_Textures[TexIdx].pTexture.Release();
+                m_Textures[TexIdx].HeapIndex = ~0u;
+            }
+            Heap.Textures.clear();
+            Heap.MemorySize          = 0;
+            Heap.UnaliasedMemorySize = 0;
+            continue;
+        }
+
+        for (size_t i = 0; i < Heap.Textures.size(); ++i)
+        {
+            auto& TexInfo = m_Textures[Heap.Textures[i]];
+            for (auto AliasedIdx : Plan.GetAliasedResources(static_cast<Uint32>(i)))
+                TexInfo.AliasedTextures.push_back(Heap.Textures[AliasedIdx]);
+        }
+
+        BindHeapMemory(pContext, Heap, Plan);
+    }
+
+    // Create dedicated textures for everything that could not be aliased
+    for (auto& TexInfo : m_Textures)
+    {
+        if (TexInfo.pTexture)
+            continue;
+
+        auto Desc                 = TexInfo.Desc;
+        Desc.Name                 = TexInfo.Name.c_str();
+        Desc.Usage                = USAGE_DEFAULT;
+        Desc.ImmediateContextMask = m_ImmediateContextMask;
+        pDevice->CreateTexture(Desc, nullptr, &TexInfo.pTexture);
+        DEV_CHECK_ERR(TexInfo.pTexture, "Failed to create transient texture '", TexInfo.Name, "'");
+    }
+}
+
+void TransientResourceAllocator::BindHeapMemory(IDeviceContext* pContext, const MemoryHeap& Heap, const TransientMemoryPlanner& Plan)
+{
+    std::vector<SparseTextureMemoryBindRange> Ranges;
+    std::vector<size_t>                       FirstRange(Heap.Textures.size() + 1);
+    for (size_t i = 0; i < Heap.Textures.size(); ++i)
+    {
+        const auto& TexInfo = m_Textures[Heap.Textures[i]];
+
+        FirstRange[i] = Ranges.size();
+
+        const auto Size = GetSparseTextureRanges(TexInfo.Desc, TexInfo.pTexture->GetSparseProperties(), Heap.pMemory.RawPtr<IDeviceMemory>(), Plan.GetOffset(static_cast<Uint32>(i)), Ranges);
+        VERIFY_EXPR(Size == TexInfo.MemorySize);
+        (void)Size;
+    }
+    FirstRange.back() = Ranges.size();
+
+    // Ranges must not be reallocated after the bind infos are initialized
+    std::vector<SparseTextureMemoryBindInfo> TexBinds(Heap.Textures.size());
+    for (size_t i = 0; i < Heap.Textures.size(); ++i)
+    {
+        TexBinds[i].pTexture  = m_Textures[Heap.Textures[i]].pTexture;
+        TexBinds[i].pRanges   = Ranges.data() + FirstRange[i];
+        TexBinds[i].NumRanges = static_cast<Uint32>(FirstRange[i + 1] - FirstRange[i]);
+    }
+
+    BindSparseResourceMemoryAttribs BindMemAttribs;
+    BindMemAttribs.NumTextureBinds = static_cast<Uint32>(TexBinds.size());
+    BindMemAttribs.pTextureBinds   = TexBinds.data();
+    pContext->BindSparseResourceMemory(BindMemAttribs);
+}
+
+void TransientResourceAllocator::BeginPass(IDeviceContext* pContext, Uint32 PassIndex)
+{
+    DEV_CHECK_ERR(m_IsCommitted, "The allocator must be committed before the first pass");
+
+    std::vector<StateTransitionDesc> Barriers;
+    for (auto& TexInfo : m_Textures)
+    {
+        if (TexInfo.FirstUse != PassIndex || TexInfo.HeapIndex == ~0u)
+            continue;
+
+        for (auto AliasedIdx : TexInfo.AliasedTextures)
+            Barriers.emplace_back(static_cast<IDeviceObject*>(m_Textures[AliasedIdx].pTexture), static_cast<IDeviceObject*>(TexInfo.pTexture));
+
+        // In Vulkan, the layout of an image becomes undefined when its memory is written through
+        // an aliased image, so the next transition must start from the undefined layout.
+        // Other backends keep tracking the state of the resource across aliasing barriers.
+        if (m_DeviceType == RENDER_DEVICE_TYPE_VULKAN)
+            TexInfo.pTexture->SetState(RESOURCE_STATE_UNDEFINED);
+    }
+
+    if (!Barriers.empty())
+        pContext->TransitionResourceStates(static_cast<Uint32>(Barriers.size()), Barriers.data());
+}
+
+ITexture* TransientResourceAllocator::GetTexture(Uint32 Handle) const
+{
+    DEV_CHECK_ERR(Handle < m_Textures.size(), "Texture handle ", Handle, " is out of range");
+    DEV_CHECK_ERR(m_IsCommitted, "The allocator must be committed before textures can be accessed");
+    return m_Textures[Handle].pTexture.RawPtr<ITexture>();
+}
+
+bool TransientResourceAllocator::IsAliased(Uint32 Handle) const
+{
+    DEV_CHECK_ERR(Handle < m_Textures.size(), "Texture handle ", Handle, " is out of range");
+    return m_Textures[Handle].HeapIndex != ~0u;
+}
+
+Uint64 TransientResourceAllocator::GetMemorySize() const
+{
+    Uint64 Size = 0;
+    for (const auto& Heap : m_Heaps)
+        Size += Heap.MemorySize;
+    return Size;
+}
+
+Uint64 TransientResourceAllocator::GetUnaliasedMemorySize() const
+{
+    Uint64 Size = 0;
+    for (const auto& Heap : m_Heaps)
+        Size += Heap.UnaliasedMemorySize;
+    return Size;
+}
+
+void TransientResourceAllocator::Reset()
+{
+    // Release textures before the memory they are bound to
+    m_Textures.clear();
+    m_Heaps.clear();
+    m_IsCommitted = false;
+}
+
+} // namespace Diligent
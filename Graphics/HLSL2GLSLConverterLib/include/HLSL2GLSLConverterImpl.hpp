@@ -32,11 +32,14 @@
 #include <unordered_map>
 #include <vector>
 #include <array>
+#include <cstddef>
+#include <mutex>
 
 #include "HLSL2GLSLConverter.h"
 #include "ObjectBase.hpp"
 #include "Shader.h"
 #include "HashUtils.hpp"
+#include "STDAllocator.hpp"
 #include "HLSLKeywords.h"
 #include "Constants.h"
 
@@ -88,6 +91,103 @@ struct FunctionStubHashKey
     };
 };
 
+class IThreadPool;
+
+/// Thread-safe cache of HLSL to GLSL conversion results.
+
+/// The cache is keyed by the hash of the HLSL source (with all includes inserted), the entry point,
+/// the shader type and the conversion options, so that the same shader is only converted once.
+/// The number of entries is limited; when the limit is reached, the least recently used entry is evicted.
+class HLSL2GLSLConversionCache
+{
+public:
+    static constexpr size_t DefaultMaxEntries = 1024;
+
+    /// \param [in] MaxEntries - The maximum number of cached entries. If this value is 0,
+    ///                          no entries are stored, but the statistics are still collected.
+    explicit HLSL2GLSLConversionCache(size_t MaxEntries = DefaultMaxEntries) noexcept :
+        m_MaxEntries{MaxEntries}
+    {}
+
+    /// Cache statistics
+    struct Stats
+    {
+        /// The number of lookups that found the entry in the cache.
+        Uint64 NumHits = 0;
+
+        /// The number of lookups that did not find the entry in the cache.
+        Uint64 NumMisses = 0;
+
+        /// The number of entries evicted to keep the cache within its limit.
+        Uint64 NumEvictions = 0;
+    };
+
+    /// 128-bit hash
+    struct HashType
+    {
+        Uint64 LowPart  = 0;
+        Uint64 HighPart = 0;
+
+        constexpr bool operator==(const HashType& RHS) const noexcept
+        {
+            return LowPart == RHS.LowPart && HighPart == RHS.HighPart;
+        }
+
+        struct Hasher
+        {
+            size_t operator()(const HashType& Hash) const noexcept
+            {
+                return static_cast<size_t>(Hash.LowPart);
+            }
+        };
+    };
+
+    /// Computes the hash of the HLSL source.
+    static HashType ComputeSourceHash(const String& Source);
+
+    /// Computes the cache key for the given source hash and entry point conversion attributes.
+    static HashType ComputeKey(const HashType&                   SourceHash,
+                               const HLSL2GLSLEntryPointAttribs& EntryPoint);
+
+    /// Looks up the converted source for the given key.
+
+    /// \param [in]  Key  - Cache key, see ComputeKey().
+    /// \param [out] GLSL - Converted source (without GLSL definitions).
+    /// \return      true if the source was found in the cache, and false otherwise.
+    ///
+    /// \remarks     The entry that is found becomes the most recently used one.
+    bool Find(const HashType& Key, String& GLSL);
+
+    /// Adds the converted source (without GLSL definitions) to the cache.
+    void Add(const HashType& Key, const String& GLSL);
+
+    /// Returns the number of cached entries.
+    size_t GetEntryCount() const;
+
+    /// Returns the cache statistics.
+    Stats GetStats() const;
+
+    /// Removes all entries from the cache. The statistics are not reset.
+    void Clear();
+
+private:
+    struct Entry
+    {
+        String                        GLSL;
+        std::list<HashType>::iterator LRUIt;
+    };
+
+    const size_t m_MaxEntries;
+
+    mutable std::mutex m_Mtx;
+
+    // Keys of all entries, most recently used first
+    std::list<HashType>                                   m_LRUList;
+    std::unordered_map<HashType, Entry, HashType::Hasher> m_Entries;
+
+    Stats m_Stats;
+};
+
 /// HLSL to GLSL shader source code converter implementation
 class HLSL2GLSLConverterImpl
 {
@@ -134,6 +234,10 @@ public:
         /// This requires separate shader objects extension:
         /// https://www.khronos.org/registry/OpenGL/extensions/ARB/ARB_separate_shader_objects.txt
         bool                                UseInOutLocationQualifiers = true;
+
+        /// Optional conversion cache. If the shader has already been converted with the same
+        /// attributes, the cached result is returned and the conversion is skipped.
+        HLSL2GLSLConversionCache*           pCache                     = nullptr;
     };
 
     // clang-format on
@@ -346,7 +450,61 @@ private:
             return os;
         }
     };
-    typedef std::list<TokenInfo> TokenListType;
+
+    /// Memory arena that backs the token lists of a conversion stream.
+
+    /// A typical effect produces tens of thousands of tokens, and every conversion copies
+    /// the token list and then inserts and erases tokens in place. To avoid hitting the
+    /// general-purpose heap for every list node, blocks are carved out of large pages and
+    /// released blocks are kept in free lists and reused by subsequent allocations, so that
+    /// repeated conversions of the same stream do not grow the arena.
+    /// Blocks are grouped into size classes, so list nodes as well as any auxiliary objects
+    /// allocated by the STL implementation (e.g. container proxies of debug builds) are
+    /// served by the arena.
+    /// The arena is not thread-safe and is only used by the stream that owns it.
+    class TokenArena final : public IMemoryAllocator
+    {
+    public:
+        TokenArena() noexcept {}
+        ~TokenArena();
+
+        // clang-format off
+        TokenArena           (const TokenArena&)  = delete;
+        TokenArena           (      TokenArena&&) = delete;
+        TokenArena& operator=(const TokenArena&)  = delete;
+        TokenArena& operator=(      TokenArena&&) = delete;
+        // clang-format on
+
+        virtual void* Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber) override final;
+        virtual void  Free(void* Ptr) override final;
+
+    private:
+        static constexpr size_t BlockGranularity = alignof(std::max_align_t);
+        static constexpr size_t NumSizeClasses   = 32;
+        static constexpr size_t MaxBlockSize     = BlockGranularity * NumSizeClasses;
+        static constexpr size_t PageSize         = size_t{64} << 10;
+
+        // Every block is preceded by a header that stores its size class. Allocations
+        // larger than MaxBlockSize go to the raw allocator and are marked with RawAllocationClass.
+        static constexpr size_t HeaderSize         = alignof(std::max_align_t);
+        static constexpr Uint32 RawAllocationClass = ~Uint32{0};
+        static_assert(HeaderSize >= sizeof(Uint32), "Header is too small to hold the size class");
+        static_assert(BlockGranularity >= sizeof(void*), "Blocks must be able to hold the free list pointer");
+
+        std::vector<void*> m_Pages;
+
+        Uint8* m_pCurrBlock = nullptr;
+        Uint8* m_pPageEnd   = nullptr;
+
+        // Singly-linked lists of released blocks, one per size class
+        std::array<void*, NumSizeClasses> m_FreeBlocks = {};
+
+#ifdef DILIGENT_DEBUG
+        size_t m_dbgNumAllocatedBlocks = 0;
+#endif
+    };
+
+    using TokenListType = std::list<TokenInfo, STDAllocator<TokenInfo, TokenArena>>;
 
 
     class ConversionStream : public ObjectBase<IHLSL2GLSLConversionStream>
@@ -369,6 +527,10 @@ private:
         /// \param [in] NumSymbols    - Number of symbols in the HLSLSource string
         /// \param [in] bPreserveTokens - Whether to preserve original tokens. This must be set to true if the stream
         ///                               will be used for multiple conversions.
+        ///
+        /// \remarks   If bPreserveTokens is true, the source is tokenized by the constructor. Otherwise, tokenization
+        ///            is deferred until the first conversion, so that it is skipped entirely if the conversion result
+        ///            is found in the cache.
         ConversionStream(IReferenceCounters*              pRefCounters,
                          const HLSL2GLSLConverterImpl&    Converter,
                          const char*                      InputFileName,
@@ -377,11 +539,12 @@ private:
                          size_t                           NumSymbols,
                          bool                             bPreserveTokens);
 
-        String Convert(const Char* EntryPoint,
-                       SHADER_TYPE ShaderType,
-                       bool        IncludeDefintions,
-                       const char* SamplerSuffix,
-                       bool        UseInOutLocationQualifiers);
+        String Convert(const Char*               EntryPoint,
+                       SHADER_TYPE               ShaderType,
+                       bool                      IncludeDefintions,
+                       const char*               SamplerSuffix,
+                       bool                      UseInOutLocationQualifiers,
+                       HLSL2GLSLConversionCache* pCache = nullptr);
 
         virtual void DILIGENT_CALL_TYPE Convert(const Char* EntryPoint,
                                                 SHADER_TYPE ShaderType,
@@ -390,13 +553,37 @@ private:
                                                 bool        UseInOutLocationQualifiers,
                                                 IDataBlob** ppGLSLSource) override final;
 
+        /// Converts multiple entry points, see IHLSL2GLSLConversionStream::ConvertEntryPoints().
+
+        /// \return    Converted sources, one for every entry point. If conversion of an entry point fails,
+        ///            the corresponding string is empty.
+        std::vector<String> ConvertEntryPoints(const HLSL2GLSLEntryPointAttribs* pEntryPoints,
+                                               Uint32                            NumEntryPoints,
+                                               IThreadPool*                      pThreadPool,
+                                               HLSL2GLSLConversionCache*         pCache = nullptr);
+
+        virtual void DILIGENT_CALL_TYPE ConvertEntryPoints(const HLSL2GLSLEntryPointAttribs* pEntryPoints,
+                                                           Uint32                            NumEntryPoints,
+                                                           IObject*                          pThreadPool,
+                                                           IDataBlob**                       ppGLSLSources) override final;
+
         IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_HLSL2GLSLConversionStream, TBase)
 
         const String& GetInputFileName() const { return m_InputFileName; }
 
     private:
+        // Creates a stream that converts from a private copy of the Src tokens.
+        ConversionStream(IReferenceCounters* pRefCounters, const ConversionStream& Src);
+
+        String ConvertEntryPoint(const HLSL2GLSLEntryPointAttribs& Attribs,
+                                 HLSL2GLSLConversionCache*         pCache,
+                                 bool                              bConvertCopy);
+
+        String ConvertTokens(const HLSL2GLSLEntryPointAttribs& Attribs);
+
         void InsertIncludes(String& GLSLSource, IShaderSourceInputStreamFactory* pSourceStreamFactory);
         void Tokenize(const String& Source);
+        void EnsureTokenized();
 
         typedef std::unordered_map<String, bool> SamplerHashType;
 
@@ -577,7 +764,10 @@ private:
                                           const String&            OutStreamName,
                                           const char*              EntryPoint);
 
-        String BuildGLSLSource();
+        String BuildGLSLSource(size_t PrefixSize);
+
+        // Memory arena for the tokens. Must be declared before m_Tokens.
+        TokenArena m_TokenArena;
 
         // Tokenized source code
         TokenListType m_Tokens;
@@ -601,6 +791,12 @@ private:
         // This member is only used to compare input name
         // when subsequent shaders are converted from already tokenized source
         const String m_InputFileName;
+
+        // Source code with all includes inserted. It is only kept until the source is tokenized.
+        String m_Source;
+
+        // Hash of the source code with all includes inserted
+        HLSL2GLSLConversionCache::HashType m_SourceHash;
     };
 
     // HLSL keyword->token info hash map
@@ -35,6 +35,26 @@
 
 DILIGENT_BEGIN_NAMESPACE(Diligent)
 
+/// Attributes of a single entry point conversion, see IHLSL2GLSLConversionStream::ConvertEntryPoints().
+struct HLSL2GLSLEntryPointAttribs
+{
+    /// Shader entry point.
+    const Char* EntryPoint DEFAULT_INITIALIZER(nullptr);
+
+    /// Shader type. See Diligent::SHADER_TYPE.
+    SHADER_TYPE ShaderType DEFAULT_INITIALIZER(SHADER_TYPE_UNKNOWN);
+
+    /// Whether to include GLSL definitions supporting HLSL->GLSL conversion.
+    Bool IncludeDefinitions DEFAULT_INITIALIZER(False);
+
+    /// Combined texture sampler suffix.
+    const Char* SamplerSuffix DEFAULT_INITIALIZER("_sampler");
+
+    /// Whether to use in-out location qualifiers.
+    Bool UseInOutLocationQualifiers DEFAULT_INITIALIZER(True);
+};
+typedef struct HLSL2GLSLEntryPointAttribs HLSL2GLSLEntryPointAttribs;
+
 // {1FDE020A-9C73-4A76-8AEF-C2C6C2CF0EA5}
 static const INTERFACE_ID IID_HLSL2GLSLConversionStream =
     {0x1fde020a, 0x9c73, 0x4a76, {0x8a, 0xef, 0xc2, 0xc6, 0xc2, 0xcf, 0xe, 0xa5}};
@@ -58,6 +78,30 @@ DILIGENT_BEGIN_INTERFACE(IHLSL2GLSLConversionStream, IObject)
                                  const char* SamplerSuffix,
                                  bool        UseInOutLocationQualifiers,
                                  IDataBlob** ppGLSLSource) PURE;
+
+    /// Converts multiple entry points of the stream source.
+
+    /// \param [in]  pEntryPoints   - Array of NumEntryPoints entry point attributes.
+    /// \param [in]  NumEntryPoints - The number of entry points to convert.
+    /// \param [in]  pThreadPool    - Optional thread pool (an object that implements Diligent::IThreadPool)
+    ///                               to convert the entry points in parallel. If null, all entry points
+    ///                               are converted by the calling thread.
+    /// \param [out] ppGLSLSources  - Array of NumEntryPoints pointers to write the converted
+    ///                               sources to. If conversion of an entry point fails,
+    ///                               null will be written to the corresponding element.
+    ///
+    /// \remarks   The source is tokenized at most once per stream: if the stream has not been
+    ///            tokenized yet, this happens on the calling thread before the conversion starts.
+    ///            Every entry point is then converted from a private copy of the tokens, so the
+    ///            entry points are independent of each other and may be converted in parallel.
+    ///
+    ///            The method waits until all entry points are converted and must not be called
+    ///            from a worker thread of the same pool.
+    VIRTUAL void METHOD(ConvertEntryPoints)(THIS_
+                                            const HLSL2GLSLEntryPointAttribs* pEntryPoints,
+                                            Uint32                            NumEntryPoints,
+                                            IObject*                          pThreadPool,
+                                            IDataBlob**                       ppGLSLSources) PURE;
 };
 DILIGENT_END_INTERFACE
 
@@ -67,7 +111,8 @@ DILIGENT_END_INTERFACE
 
 // clang-format off
 
-#    define IHLSL2GLSLConversionStream_Convert(This, ...) CALL_IFACE_METHOD(HLSL2GLSLConversionStream, Convert, This, __VA_ARGS__)
+#    define IHLSL2GLSLConversionStream_Convert(This, ...)            CALL_IFACE_METHOD(HLSL2GLSLConversionStream, Convert,            This, __VA_ARGS__)
+#    define IHLSL2GLSLConversionStream_ConvertEntryPoints(This, ...) CALL_IFACE_METHOD(HLSL2GLSLConversionStream, ConvertEntryPoints, This, __VA_ARGS__)
 
 // clang-format on
 
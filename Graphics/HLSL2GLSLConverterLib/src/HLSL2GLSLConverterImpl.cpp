@@ -364,6 +364,10 @@
 #include "StringTools.hpp"
 #include "ParsingTools.hpp"
 #include "EngineMemory.h"
+#include "Align.hpp"
+#include "ThreadPool.hpp"
+
+#include "xxhash.h"
 
 using namespace std;
 
@@ -801,21 +805,250 @@ void HLSL2GLSLConverterImpl::ConversionStream::InsertIncludes(String& GLSLSource
     }
 }
 
+namespace
+{
+
+class XXH128Accumulator
+{
+public:
+    XXH128Accumulator() :
+        m_State{XXH3_createState()}
+    {
+        XXH3_128bits_reset(m_State);
+    }
+
+    ~XXH128Accumulator()
+    {
+        XXH3_freeState(m_State);
+    }
+
+    // clang-format off
+    XXH128Accumulator           (const XXH128Accumulator&) = delete;
+    XXH128Accumulator& operator=(const XXH128Accumulator&) = delete;
+    // clang-format on
+
+    void Update(const void* pData, size_t Size)
+    {
+        if (Size != 0)
+            XXH3_128bits_update(m_State, pData, Size);
+    }
+
+    template <typename T>
+    void Update(const T& Val)
+    {
+        static_assert(std::is_fundamental<T>::value || std::is_enum<T>::value, "Only fundamental and enum types are allowed");
+        Update(&Val, sizeof(Val));
+    }
+
+    void UpdateStr(const char* Str)
+    {
+        // Hash the terminating zero as well to distinguish between adjacent strings
+        if (Str == nullptr)
+            Str = "";
+        Update(Str, strlen(Str) + 1);
+    }
+
+    HLSL2GLSLConversionCache::HashType Digest()
+    {
+        const auto Hash = XXH3_128bits_digest(m_State);
+
+        HLSL2GLSLConversionCache::HashType Res;
+        Res.LowPart  = Hash.low64;
+        Res.HighPart = Hash.high64;
+        return Res;
+    }
+
+private:
+    XXH3_state_t* m_State = nullptr;
+};
+
+} // namespace
+
+HLSL2GLSLConversionCache::HashType HLSL2GLSLConversionCache::ComputeSourceHash(const String& Source)
+{
+    XXH128Accumulator Hasher;
+    Hasher.Update(Source.data(), Source.size());
+    return Hasher.Digest();
+}
+
+HLSL2GLSLConversionCache::HashType HLSL2GLSLConversionCache::ComputeKey(const HashType&                   SourceHash,
+                                                                        const HLSL2GLSLEntryPointAttribs& EntryPoint)
+{
+    // Note that IncludeDefinitions is not a part of the key: the cache stores
+    // sources without the definitions.
+    XXH128Accumulator Hasher;
+    Hasher.Update(SourceHash.LowPart);
+    Hasher.Update(SourceHash.HighPart);
+    Hasher.UpdateStr(EntryPoint.EntryPoint);
+    Hasher.Update(EntryPoint.ShaderType);
+    Hasher.UpdateStr(EntryPoint.SamplerSuffix);
+    Hasher.Update(EntryPoint.UseInOutLocationQualifiers);
+    return Hasher.Digest();
+}
+
+bool HLSL2GLSLConversionCache::Find(const HashType& Key, String& GLSL)
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+
+    auto It = m_Entries.find(Key);
+    if (It == m_Entries.end())
+    {
+        ++m_Stats.NumMisses;
+        return false;
+    }
+
+    m_LRUList.splice(m_LRUList.begin(), m_LRUList, It->second.LRUIt);
+    ++m_Stats.NumHits;
+
+    GLSL = It->second.GLSL;
+    return true;
+}
+
+void HLSL2GLSLConversionCache::Add(const HashType& Key, const String& GLSL)
+{
+    if (m_MaxEntries == 0)
+        return;
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+
+    // The same source may have been converted by another thread
+    auto It = m_Entries.find(Key);
+    if (It != m_Entries.end())
+    {
+        m_LRUList.splice(m_LRUList.begin(), m_LRUList, It->second.LRUIt);
+        return;
+    }
+
+    while (m_Entries.size() >= m_MaxEntries)
+    {
+        m_Entries.erase(m_LRUList.back());
+        m_LRUList.pop_back();
+        ++m_Stats.NumEvictions;
+    }
+
+    m_LRUList.push_front(Key);
+    m_Entries.emplace(Key, Entry{GLSL, m_LRUList.begin()});
+}
+
+size_t HLSL2GLSLConversionCache::GetEntryCount() const
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    return m_Entries.size();
+}
+
+HLSL2GLSLConversionCache::Stats HLSL2GLSLConversionCache::GetStats() const
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    return m_Stats;
+}
+
+void HLSL2GLSLConversionCache::Clear()
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    m_Entries.clear();
+    m_LRUList.clear();
+}
+
+HLSL2GLSLConverterImpl::TokenArena::~TokenArena()
+{
+    VERIFY(m_dbgNumAllocatedBlocks == 0, "Not all token list nodes have been released");
+
+    auto& RawAllocator = GetRawAllocator();
+    for (auto* pPage : m_Pages)
+        RawAllocator.Free(pPage);
+}
+
+void* HLSL2GLSLConverterImpl::TokenArena::Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber)
+{
+    VERIFY_EXPR(Size > 0);
+    if (Size > MaxBlockSize)
+    {
+        auto* pBlock = static_cast<Uint8*>(GetRawAllocator().Allocate(HeaderSize + Size, dbgDescription, dbgFileName, dbgLineNumber));
+
+        *reinterpret_cast<Uint32*>(pBlock) = RawAllocationClass;
+        return pBlock + HeaderSize;
+    }
+
+#ifdef DILIGENT_DEBUG
+    ++m_dbgNumAllocatedBlocks;
+#endif
+
+    const size_t SizeClass  = (Size - 1) / BlockGranularity;
+    auto&        pFreeBlock = m_FreeBlocks[SizeClass];
+    if (pFreeBlock != nullptr)
+    {
+        auto* Ptr  = pFreeBlock;
+        pFreeBlock = *reinterpret_cast<void**>(Ptr);
+        return Ptr;
+    }
+
+    const size_t BlockSize = HeaderSize + (SizeClass + 1) * BlockGranularity;
+    if (static_cast<size_t>(m_pPageEnd - m_pCurrBlock) < BlockSize)
+    {
+        // The rest of the current page, which is smaller than the largest block, is not used
+        auto* pPage = GetRawAllocator().Allocate(PageSize, "Token arena page", __FILE__, __LINE__);
+        m_Pages.emplace_back(pPage);
+        m_pCurrBlock = reinterpret_cast<Uint8*>(pPage);
+        m_pPageEnd   = m_pCurrBlock + PageSize;
+    }
+
+    *reinterpret_cast<Uint32*>(m_pCurrBlock) = static_cast<Uint32>(SizeClass);
+
+    auto* Ptr = m_pCurrBlock + HeaderSize;
+    m_pCurrBlock += BlockSize;
+    return Ptr;
+}
+
+void HLSL2GLSLConverterImpl::TokenArena::Free(void* Ptr)
+{
+    if (Ptr == nullptr)
+        return;
+
+    auto*        pBlock    = static_cast<Uint8*>(Ptr) - HeaderSize;
+    const Uint32 SizeClass = *reinterpret_cast<const Uint32*>(pBlock);
+    if (SizeClass == RawAllocationClass)
+    {
+        GetRawAllocator().Free(pBlock);
+        return;
+    }
+
+    VERIFY(SizeClass < NumSizeClasses, "Invalid size class. The block has not been allocated by this arena.");
+#ifdef DILIGENT_DEBUG
+    VERIFY(m_dbgNumAllocatedBlocks > 0, "Releasing a block that has not been allocated by this arena");
+    --m_dbgNumAllocatedBlocks;
+#endif
+
+    *reinterpret_cast<void**>(Ptr) = m_FreeBlocks[SizeClass];
+    m_FreeBlocks[SizeClass]        = Ptr;
+}
+
 // The function converts source code into a token list
 void HLSL2GLSLConverterImpl::ConversionStream::Tokenize(const String& Source)
 {
-    m_Tokens = Parsing::Tokenize<TokenInfo, decltype(m_Tokens)>(
+    m_Tokens = Parsing::Tokenize<TokenInfo, TokenListType>(
         Source.begin(), Source.end(), TokenInfo::Create,
         [&](const std::string::const_iterator& Start, const std::string::const_iterator& End) //
         {
-            auto KeywordIt = m_Converter.m_HLSLKeywords.find(HashMapStringKey{std::string{Start, End}});
+            // Copy the identifier into a local null-terminated buffer to look it up
+            // in the keyword map without allocating a temporary string.
+            // Identifiers that do not fit into the buffer can't be keywords.
+            char         Identifier[64];
+            const size_t Len = End - Start;
+            if (Len >= _countof(Identifier))
+                return TokenType::Identifier;
+
+            std::copy(Start, End, Identifier);
+            Identifier[Len] = '\0';
+
+            auto KeywordIt = m_Converter.m_HLSLKeywords.find(Identifier);
             if (KeywordIt != m_Converter.m_HLSLKeywords.end())
             {
                 VERIFY(std::string(Start, End) == KeywordIt->second.Literal, "Inconsistent literal");
                 return KeywordIt->second.Type;
             }
             return TokenType::Identifier;
-        });
+        },
+        TokenListType{m_Tokens.get_allocator()});
 }
 
 
@@ -1563,9 +1796,11 @@ void HLSL2GLSLConverterImpl::ConversionStream::ProcessTextureDeclaration(TokenLi
 // Finds an HLSL object with the given name in object stack
 const HLSL2GLSLConverterImpl::HLSLObjectInfo* HLSL2GLSLConverterImpl::ConversionStream::FindHLSLObject(const String& Name)
 {
+    // Hash the name once for all scopes
+    const HashMapStringKey Key{Name.c_str()};
     for (auto ScopeIt = m_Objects.rbegin(); ScopeIt != m_Objects.rend(); ++ScopeIt)
     {
-        auto It = ScopeIt->m.find(Name.c_str());
+        auto It = ScopeIt->m.find(Key);
         if (It != ScopeIt->m.end())
             return &It->second;
     }
@@ -4254,16 +4489,28 @@ void HLSL2GLSLConverterImpl::ConversionStream::RemoveSpecialShaderAttributes()
     );
 }
 
-String HLSL2GLSLConverterImpl::ConversionStream::BuildGLSLSource()
+String HLSL2GLSLConverterImpl::ConversionStream::BuildGLSLSource(size_t PrefixSize)
 {
+    auto IsInterpolationQualifier = [](const TokenInfo& Token) {
+        return (Token.Type == TokenType::kw_linear ||
+                Token.Type == TokenType::kw_nointerpolation ||
+                Token.Type == TokenType::kw_noperspective ||
+                Token.Type == TokenType::kw_centroid ||
+                Token.Type == TokenType::kw_sample);
+    };
+
+    size_t OutputSize = PrefixSize;
+    for (const auto& Token : m_Tokens)
+    {
+        if (!IsInterpolationQualifier(Token))
+            OutputSize += Token.Delimiter.length() + Token.Literal.length();
+    }
+
     String Output;
+    Output.reserve(OutputSize);
     for (const auto& Token : m_Tokens)
     {
-        if ((Token.Type == TokenType::kw_linear ||
-             Token.Type == TokenType::kw_nointerpolation ||
-             Token.Type == TokenType::kw_noperspective ||
-             Token.Type == TokenType::kw_centroid ||
-             Token.Type == TokenType::kw_sample))
+        if (IsInterpolationQualifier(Token))
         {
             // Skip interpolation qualifiers.
             // We may get here if there are multiple shader functions in the same file.
@@ -4285,6 +4532,7 @@ HLSL2GLSLConverterImpl::ConversionStream::ConversionStream(IReferenceCounters*
                                                            bool                             bPreserveTokens) :
     // clang-format off
     TBase            {pRefCounters   },
+    m_Tokens         {STD_ALLOCATOR(TokenInfo, TokenArena, m_TokenArena, "Allocator for TokenListType")},
     m_bPreserveTokens{bPreserveTokens},
     m_Converter      {Converter      },
     m_InputFileName  {InputFileName != nullptr ? InputFileName : "<Unknown>"}
@@ -4310,11 +4558,38 @@ HLSL2GLSLConverterImpl::ConversionStream::ConversionStream(IReferenceCounters*
         NumSymbols = pFileData->GetSize();
     }
 
-    String Source(HLSLSource, NumSymbols);
+    m_Source.assign(HLSLSource, NumSymbols);
+
+    InsertIncludes(m_Source, pInputStreamFactory);
 
-    InsertIncludes(Source, pInputStreamFactory);
+    m_SourceHash = HLSL2GLSLConversionCache::ComputeSourceHash(m_Source);
 
-    Tokenize(Source);
+    if (m_bPreserveTokens)
+        EnsureTokenized();
+}
+
+HLSL2GLSLConverterImpl::ConversionStream::ConversionStream(IReferenceCounters* pRefCounters, const ConversionStream& Src) :
+    // clang-format off
+    TBase            {pRefCounters     },
+    m_Tokens         {Src.m_Tokens, STD_ALLOCATOR(TokenInfo, TokenArena, m_TokenArena, "Allocator for TokenListType")},
+    m_bPreserveTokens{false            },
+    m_Converter      {Src.m_Converter  },
+    m_InputFileName  {Src.m_InputFileName},
+    m_SourceHash     {Src.m_SourceHash }
+// clang-format on
+{
+    VERIFY(!Src.m_Tokens.empty(), "Source stream has not been tokenized");
+}
+
+void HLSL2GLSLConverterImpl::ConversionStream::EnsureTokenized()
+{
+    if (!m_Tokens.empty())
+        return;
+
+    Tokenize(m_Source);
+
+    m_Source.clear();
+    m_Source.shrink_to_fit();
 }
 
 
@@ -4325,7 +4600,7 @@ String HLSL2GLSLConverterImpl::Convert(ConversionAttribs& Attribs) const
         try
         {
             ConversionStream Stream(nullptr, *this, Attribs.InputFileName, Attribs.pSourceStreamFactory, Attribs.HLSLSource, Attribs.NumSymbols, false);
-            return Stream.Convert(Attribs.EntryPoint, Attribs.ShaderType, Attribs.IncludeDefinitions, Attribs.SamplerSuffix, Attribs.UseInOutLocationQualifiers);
+            return Stream.Convert(Attribs.EntryPoint, Attribs.ShaderType, Attribs.IncludeDefinitions, Attribs.SamplerSuffix, Attribs.UseInOutLocationQualifiers, Attribs.pCache);
         }
         catch (std::runtime_error&)
         {
@@ -4354,7 +4629,7 @@ String HLSL2GLSLConverterImpl::Convert(ConversionAttribs& Attribs) const
             pStream = ClassPtrCast<ConversionStream>(*Attribs.ppConversionStream);
         }
 
-        return pStream->Convert(Attribs.EntryPoint, Attribs.ShaderType, Attribs.IncludeDefinitions, Attribs.SamplerSuffix, Attribs.UseInOutLocationQualifiers);
+        return pStream->Convert(Attribs.EntryPoint, Attribs.ShaderType, Attribs.IncludeDefinitions, Attribs.SamplerSuffix, Attribs.UseInOutLocationQualifiers, Attribs.pCache);
     }
 }
 
@@ -4394,14 +4669,148 @@ void HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
     }
 }
 
-String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
-                                                         SHADER_TYPE ShaderType,
-                                                         bool        IncludeDefintions,
-                                                         const char* SamplerSuffix,
-                                                         bool        UseInOutLocationQualifiers)
+void HLSL2GLSLConverterImpl::ConversionStream::ConvertEntryPoints(const HLSL2GLSLEntryPointAttribs* pEntryPoints,
+                                                                  Uint32                            NumEntryPoints,
+                                                                  IObject*                          pThreadPool,
+                                                                  IDataBlob**                       ppGLSLSources)
+{
+    if (NumEntryPoints == 0)
+        return;
+
+    DEV_CHECK_ERR(pEntryPoints != nullptr, "pEntryPoints must not be null");
+    DEV_CHECK_ERR(ppGLSLSources != nullptr, "ppGLSLSources must not be null");
+
+    RefCntAutoPtr<IThreadPool> pPool{pThreadPool, IID_ThreadPool};
+    DEV_CHECK_ERR(pThreadPool == nullptr || pPool, "pThreadPool does not implement IThreadPool interface");
+
+    auto GLSLSources = ConvertEntryPoints(pEntryPoints, NumEntryPoints, pPool);
+    for (Uint32 i = 0; i < NumEntryPoints; ++i)
+    {
+        ppGLSLSources[i] = nullptr;
+        if (GLSLSources[i].empty())
+            continue;
+
+        StringDataBlobImpl* pDataBlob = MakeNewRCObj<StringDataBlobImpl>()(std::move(GLSLSources[i]));
+        pDataBlob->QueryInterface(IID_DataBlob, reinterpret_cast<IObject**>(&ppGLSLSources[i]));
+    }
+}
+
+std::vector<String> HLSL2GLSLConverterImpl::ConversionStream::ConvertEntryPoints(const HLSL2GLSLEntryPointAttribs* pEntryPoints,
+                                                                                 Uint32                            NumEntryPoints,
+                                                                                 IThreadPool*                      pThreadPool,
+                                                                                 HLSL2GLSLConversionCache*         pCache)
+{
+    std::vector<String> GLSLSources(NumEntryPoints);
+    if (NumEntryPoints == 0)
+        return GLSLSources;
+
+    try
+    {
+        // Tokenize the source before starting the tasks: the tokens of this stream
+        // are only read by the tasks, and every entry point is converted from a copy.
+        EnsureTokenized();
+    }
+    catch (std::runtime_error&)
+    {
+        return GLSLSources;
+    }
+
+    auto ConvertEntryPointNoThrow = [&](Uint32 i) {
+        try
+        {
+            GLSLSources[i] = ConvertEntryPoint(pEntryPoints[i], pCache, /*bConvertCopy = */ true);
+        }
+        catch (std::runtime_error&)
+        {
+            // Conversion errors have been logged
+        }
+    };
+
+    if (pThreadPool == nullptr || NumEntryPoints == 1)
+    {
+        for (Uint32 i = 0; i < NumEntryPoints; ++i)
+            ConvertEntryPointNoThrow(i);
+        return GLSLSources;
+    }
+
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    Tasks.reserve(NumEntryPoints);
+    for (Uint32 i = 0; i < NumEntryPoints; ++i)
+    {
+        Tasks.emplace_back(EnqueueAsyncWork(pThreadPool,
+                                            [&ConvertEntryPointNoThrow, i](Uint32) //
+                                            {
+                                                ConvertEntryPointNoThrow(i);
+                                            }));
+    }
+
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+
+    return GLSLSources;
+}
+
+String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char*               EntryPoint,
+                                                         SHADER_TYPE               ShaderType,
+                                                         bool                      IncludeDefintions,
+                                                         const char*               SamplerSuffix,
+                                                         bool                      UseInOutLocationQualifiers,
+                                                         HLSL2GLSLConversionCache* pCache)
 {
-    m_bUseInOutLocationQualifiers = UseInOutLocationQualifiers;
-    TokenListType TokensCopy(m_bPreserveTokens ? m_Tokens : TokenListType());
+    HLSL2GLSLEntryPointAttribs Attribs;
+    Attribs.EntryPoint                 = EntryPoint;
+    Attribs.ShaderType                 = ShaderType;
+    Attribs.IncludeDefinitions         = IncludeDefintions;
+    Attribs.SamplerSuffix              = SamplerSuffix;
+    Attribs.UseInOutLocationQualifiers = UseInOutLocationQualifiers;
+    return ConvertEntryPoint(Attribs, pCache, /*bConvertCopy = */ false);
+}
+
+String HLSL2GLSLConverterImpl::ConversionStream::ConvertEntryPoint(const HLSL2GLSLEntryPointAttribs& Attribs,
+                                                                   HLSL2GLSLConversionCache*         pCache,
+                                                                   bool                              bConvertCopy)
+{
+    HLSL2GLSLConversionCache::HashType CacheKey;
+
+    String GLSLSource;
+    bool   bFoundInCache = false;
+    if (pCache != nullptr)
+    {
+        CacheKey      = HLSL2GLSLConversionCache::ComputeKey(m_SourceHash, Attribs);
+        bFoundInCache = pCache->Find(CacheKey, GLSLSource);
+    }
+
+    if (!bFoundInCache)
+    {
+        if (bConvertCopy)
+        {
+            ConversionStream StreamCopy{nullptr, *this};
+            GLSLSource = StreamCopy.ConvertTokens(Attribs);
+        }
+        else
+        {
+            EnsureTokenized();
+            GLSLSource = ConvertTokens(Attribs);
+        }
+
+        if (pCache != nullptr)
+            pCache->Add(CacheKey, GLSLSource);
+    }
+
+    if (Attribs.IncludeDefinitions)
+        GLSLSource.insert(0, g_GLSLDefinitions);
+
+    return GLSLSource;
+}
+
+String HLSL2GLSLConverterImpl::ConversionStream::ConvertTokens(const HLSL2GLSLEntryPointAttribs& Attribs)
+{
+    const auto* const EntryPoint    = Attribs.EntryPoint;
+    const auto        ShaderType    = Attribs.ShaderType;
+    const auto* const SamplerSuffix = Attribs.SamplerSuffix;
+
+    m_bUseInOutLocationQualifiers = Attribs.UseInOutLocationQualifiers;
+    TokenListType TokensCopy(m_bPreserveTokens ? m_Tokens : TokenListType{m_Tokens.get_allocator()});
 
     Uint32 ShaderStorageBlockBinding = 0;
     Uint32 ImageBinding              = 0;
@@ -4630,7 +5039,8 @@ String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
 
     RemoveSpecialShaderAttributes();
 
-    auto GLSLSource = BuildGLSLSource();
+    // Reserve space for the definitions so that inserting them does not reallocate the string
+    auto GLSLSource = BuildGLSLSource(Attribs.IncludeDefinitions ? strlen(g_GLSLDefinitions) : 0);
 
     if (m_bPreserveTokens)
     {
@@ -4639,9 +5049,6 @@ String HLSL2GLSLConverterImpl::ConversionStream::Convert(const Char* EntryPoint,
         m_Objects.clear();
     }
 
-    if (IncludeDefintions)
-        GLSLSource.insert(0, g_GLSLDefinitions);
-
     return GLSLSource;
 }
 
@@ -34,16 +34,23 @@
 namespace Diligent
 {
 
+class HLSL2GLSLConversionCache;
+
 enum class TargetGLSLCompiler
 {
     glslang,
     driver
 };
 
+/// Builds the full GLSL source string for the shader.
+
+/// \param [in] pConversionCache - Optional cache of HLSL to GLSL conversion results
+///                                that is used when the shader source language is HLSL.
 String BuildGLSLSourceString(const ShaderCreateInfo&    ShaderCI,
                              const RenderDeviceInfo&    DeviceInfo,
                              const GraphicsAdapterInfo& AdapterInfo,
                              TargetGLSLCompiler         TargetCompiler,
-                             const char*                ExtraDefinitions = nullptr) noexcept(false);
+                             const char*                ExtraDefinitions = nullptr,
+                             HLSL2GLSLConversionCache*  pConversionCache = nullptr) noexcept(false);
 
 } // namespace Diligent
@@ -44,7 +44,8 @@ String BuildGLSLSourceString(const ShaderCreateInfo&    ShaderCI,
                              const RenderDeviceInfo&    DeviceInfo,
                              const GraphicsAdapterInfo& AdapterInfo,
                              TargetGLSLCompiler         TargetCompiler,
-                             const char*                ExtraDefinitions) noexcept(false)
+                             const char*                ExtraDefinitions,
+                             HLSL2GLSLConversionCache*  pConversionCache) noexcept(false)
 {
     // clang-format off
     VERIFY(ShaderCI.SourceLanguage == SHADER_SOURCE_LANGUAGE_DEFAULT ||
@@ -302,6 +303,7 @@ String BuildGLSLSourceString(const ShaderCreateInfo&    ShaderCI,
         // https://www.khronos.org/registry/OpenGL/extensions/ARB/ARB_separate_shader_objects.txt
         // (search for "Input Layout Qualifiers" and "Output Layout Qualifiers").
         Attribs.UseInOutLocationQualifiers = DeviceInfo.Features.SeparablePrograms;
+        Attribs.pCache                     = pConversionCache;
         auto ConvertedSource               = Converter.Convert(Attribs);
 
         GLSLSource.append(ConvertedSource);
@@ -34,3 +34,14 @@
 #if DILIGENT_AVX2_SUPPORTED && defined(__AVX2__)
 #    define DILIGENT_AVX2_ENABLED 1
 #endif
+
+// SSE2 is always available on x64 and is enabled by default by all major compilers on x86
+#if DILIGENT_AVX2_SUPPORTED && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#    define DILIGENT_SSE2_ENABLED 1
+#endif
+
+// NEON is always available on AArch64
+#if defined(__aarch64__) || defined(_M_ARM64)
+#    include <arm_neon.h>
+#    define DILIGENT_NEON_ENABLED 1
+#endif
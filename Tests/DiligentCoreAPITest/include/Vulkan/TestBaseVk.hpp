@@ -0,0 +1,78 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include "RenderDeviceVk.h"
+#include "DeviceContextVk.h"
+#include "GPUTestingEnvironment.hpp"
+
+#include "gtest/gtest.h"
+
+namespace Diligent
+{
+
+namespace Testing
+{
+
+/// Base fixture for tests of Vulkan-specific functionality.
+/// Skips the test on other backends and queries the Vulkan interfaces
+/// of the device and the main immediate context.
+class TestBaseVk : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        pEnv     = GPUTestingEnvironment::GetInstance();
+        pDevice  = pEnv->GetDevice();
+        pContext = pEnv->GetDeviceContext();
+
+        if (pDevice->GetDeviceInfo().Type != RENDER_DEVICE_TYPE_VULKAN)
+            GTEST_SKIP() << "This test is Vulkan-specific";
+
+        pDeviceVk  = RefCntAutoPtr<IRenderDeviceVk>{pDevice, IID_RenderDeviceVk};
+        pContextVk = RefCntAutoPtr<IDeviceContextVk>{pContext, IID_DeviceContextVk};
+        ASSERT_NE(pDeviceVk, nullptr);
+        ASSERT_NE(pContextVk, nullptr);
+    }
+
+    void TearDown() override
+    {
+        pContextVk.Release();
+        pDeviceVk.Release();
+    }
+
+    GPUTestingEnvironment* pEnv     = nullptr;
+    IRenderDevice*         pDevice  = nullptr;
+    IDeviceContext*        pContext = nullptr;
+
+    RefCntAutoPtr<IRenderDeviceVk>  pDeviceVk;
+    RefCntAutoPtr<IDeviceContextVk> pContextVk;
+};
+
+} // namespace Testing
+
+} // namespace Diligent
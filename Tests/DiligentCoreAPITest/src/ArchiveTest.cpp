@@ -35,6 +35,10 @@
 #include "SerializedPipelineState.h"
 #include "SerializedShader.h"
 #include "ShaderMacroHelper.hpp"
+#include "MappedFileStream.hpp"
+#include "FileWrapper.hpp"
+#include "FileSystem.hpp"
+#include "TempDirectory.hpp"
 
 #include "ResourceLayoutTestCommon.hpp"
 #include "gtest/gtest.h"
@@ -260,6 +264,35 @@ TEST(ArchiveTest, ResourceSignature)
 }
 
 
+// Verifies that the archive can be loaded directly from a memory-mapped file.
+TEST(ArchiveTest, MappedArchive)
+{
+    constexpr char PRS1Name[] = "ArchiveTest.MappedArchive - PRS 1";
+    constexpr char PRS2Name[] = "ArchiveTest.MappedArchive - PRS 2";
+
+    RefCntAutoPtr<IDataBlob>                  pArchive;
+    RefCntAutoPtr<IPipelineResourceSignature> pRefPRS_1;
+    RefCntAutoPtr<IPipelineResourceSignature> pRefPRS_2;
+    ArchivePRS(pArchive, PRS1Name, PRS2Name, pRefPRS_1, pRefPRS_2, GetDeviceBits());
+    ASSERT_NE(pArchive, nullptr);
+
+    TempDirectory TmpDir;
+
+    const auto FilePath = TmpDir.Get() + FileSystem::SlashSymbol + "MappedArchive.bin";
+    {
+        FileWrapper File{FilePath.c_str(), EFileAccessMode::Overwrite};
+        ASSERT_TRUE(File);
+        ASSERT_TRUE(File->Write(pArchive->GetConstDataPtr(), pArchive->GetSize()));
+    }
+
+    auto pMappedArchive = MappedDataBlob::Create(FilePath.c_str(), EFileMapMode::ReadOnly, EFileMapAccessHint::Random);
+    ASSERT_NE(pMappedArchive, nullptr);
+    ASSERT_EQ(pMappedArchive->GetSize(), pArchive->GetSize());
+
+    UnpackPRS(pMappedArchive, PRS1Name, PRS2Name, pRefPRS_1, pRefPRS_2);
+}
+
+
 TEST(ArchiveTest, RemoveDeviceData)
 {
     auto* pEnv             = GPUTestingEnvironment::GetInstance();
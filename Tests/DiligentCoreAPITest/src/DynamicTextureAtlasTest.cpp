@@ -28,6 +28,7 @@
 #include "DynamicTextureAtlas.h"
 
 #include <thread>
+#include <vector>
 
 #include "GPUTestingEnvironment.hpp"
 #include "gtest/gtest.h"
@@ -522,4 +523,230 @@ TEST(DynamicTextureAtlas, AllocFreeRace)
     }
 }
 
+TEST(DynamicTextureAtlas, Defragment)
+{
+    auto* const pEnv     = GPUTestingEnvironment::GetInstance();
+    auto* const pDevice  = pEnv->GetDevice();
+    auto* const pContext = pEnv->GetDeviceContext();
+
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    constexpr Uint32 AtlasDim            = 256;
+    constexpr Uint32 AllocDim            = 64;
+    constexpr Uint32 AllocationsPerSlice = (AtlasDim / AllocDim) * (AtlasDim / AllocDim);
+    constexpr Uint32 SliceCount          = 4;
+
+    DynamicTextureAtlasCreateInfo CI;
+    CI.ExtraSliceCount = 1;
+    CI.MinAlignment    = AllocDim;
+    CI.Desc.Format     = TEX_FORMAT_RGBA8_UNORM;
+    CI.Desc.Name       = "Dynamic Texture Atlas Defragmentation Test";
+    CI.Desc.Type       = RESOURCE_DIM_TEX_2D_ARRAY;
+    CI.Desc.BindFlags  = BIND_SHADER_RESOURCE;
+    CI.Desc.Width      = AtlasDim;
+    CI.Desc.Height     = AtlasDim;
+    CI.Desc.MipLevels  = 4;
+    CI.Desc.ArraySize  = 1;
+
+    CI.EnableDefragmentation = true;
+
+    RefCntAutoPtr<IDynamicTextureAtlas> pAtlas;
+    CreateDynamicTextureAtlas(pDevice, CI, &pAtlas);
+    ASSERT_TRUE(pAtlas);
+
+    std::vector<RefCntAutoPtr<ITextureAtlasSuballocation>> pAllocations(AllocationsPerSlice * SliceCount);
+    for (auto& pAlloc : pAllocations)
+    {
+        pAtlas->Allocate(AllocDim, AllocDim, &pAlloc);
+        ASSERT_TRUE(pAlloc);
+    }
+    ITexture* pAtlasTex = pAtlas->GetTexture(pDevice, pContext);
+    ASSERT_NE(pAtlasTex, nullptr);
+
+    DynamicTextureAtlasUsageStats Stats;
+    pAtlas->GetUsageStats(Stats);
+    EXPECT_EQ(Stats.CommittedSliceCount, SliceCount);
+    EXPECT_EQ(Stats.CommittedFreeArea, 0u);
+    EXPECT_EQ(Stats.Fragmentation, 0.f);
+
+    // Keep a quarter of the first slice and a single allocation in every other slice
+    std::vector<RefCntAutoPtr<ITextureAtlasSuballocation>> pSparseAllocations;
+    std::vector<Uint32>                                    SliceAllocCount(SliceCount);
+    for (auto& pAlloc : pAllocations)
+    {
+        const auto Slice = pAlloc->GetSlice();
+        ASSERT_LT(Slice, SliceCount);
+        const Uint32 MaxAllocCount = Slice == 0 ? AllocationsPerSlice / 4 : 1;
+        if (SliceAllocCount[Slice] < MaxAllocCount)
+        {
+            if (Slice != 0)
+                pSparseAllocations.push_back(std::move(pAlloc));
+            ++SliceAllocCount[Slice];
+        }
+        else
+        {
+            pAlloc.Release();
+        }
+    }
+    ASSERT_EQ(pSparseAllocations.size(), size_t{SliceCount - 1});
+
+    // Fill every mip level of the allocations that will be moved with a unique color
+    auto GetAllocColor = [](size_t AllocIdx) {
+        return Uint32{0xFF000000u} | static_cast<Uint32>((AllocIdx + 1) * 0x402010u);
+    };
+    for (size_t i = 0; i < pSparseAllocations.size(); ++i)
+    {
+        const auto& pAlloc = pSparseAllocations[i];
+        const auto  Origin = pAlloc->GetOrigin();
+        for (Uint32 mip = 0; mip < CI.Desc.MipLevels; ++mip)
+        {
+            const Uint32              MipDim = AllocDim >> mip;
+            const std::vector<Uint32> Data(size_t{MipDim} * MipDim, GetAllocColor(i));
+
+            const Box         DstBox{Origin.x >> mip, (Origin.x >> mip) + MipDim, Origin.y >> mip, (Origin.y >> mip) + MipDim};
+            TextureSubResData SubresData{Data.data(), MipDim * 4};
+            pContext->UpdateTexture(pAtlasTex, mip, pAlloc->GetSlice(), DstBox, SubresData,
+                                    RESOURCE_STATE_TRANSITION_MODE_TRANSITION, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        }
+    }
+
+    pAtlas->GetUsageStats(Stats);
+    EXPECT_EQ(Stats.AllocationCount, AllocationsPerSlice / 4 + SliceCount - 1);
+    EXPECT_EQ(Stats.CommittedSliceCount, SliceCount);
+    EXPECT_EQ(Stats.CommittedFreeArea, Stats.TotalArea - Stats.UsedArea);
+    EXPECT_GT(Stats.Fragmentation, 0.f);
+    EXPECT_LE(Stats.Fragmentation, 1.f);
+
+    std::vector<Uint32> Versions;
+    for (auto& pAlloc : pSparseAllocations)
+        Versions.push_back(pAlloc->GetVersion());
+
+    std::vector<Uint32> Colors;
+    for (size_t i = 0; i < pSparseAllocations.size(); ++i)
+        Colors.push_back(GetAllocColor(i));
+
+    struct CallbackData
+    {
+        Uint32 NumCalls = 0;
+        bool   OK       = true;
+    } CbData;
+
+    DynamicTextureAtlasDefragmentAttribs Attribs;
+    Attribs.MaxRelocations              = 1;
+    Attribs.pRelocationCallbackUserData = &CbData;
+    Attribs.RelocationCallback          = [](ITextureAtlasSuballocation* pSuballocation, Uint32 OldSlice, const uint2& OldOrigin, void* pUserData) {
+        auto& Data = *static_cast<CallbackData*>(pUserData);
+        ++Data.NumCalls;
+        if (pSuballocation == nullptr || pSuballocation->GetSlice() != 0 || OldSlice == 0)
+            Data.OK = false;
+    };
+
+    Uint32 NumRelocations = pAtlas->Defragment(pDevice, pContext, Attribs);
+    EXPECT_EQ(NumRelocations, 1u);
+
+    pAtlas->GetUsageStats(Stats);
+    EXPECT_EQ(Stats.PendingRelocationCount, SliceCount - 2);
+
+    // Release one of the allocations that are scheduled to be moved
+    for (size_t i = 0; i < pSparseAllocations.size(); ++i)
+    {
+        if (pSparseAllocations[i]->GetSlice() != 0)
+        {
+            pSparseAllocations.erase(pSparseAllocations.begin() + i);
+            Versions.erase(Versions.begin() + i);
+            Colors.erase(Colors.begin() + i);
+            break;
+        }
+    }
+
+    // Every call must move at most one allocation
+    for (Uint32 i = 0; i < SliceCount * 2; ++i)
+    {
+        const auto NumMoved = pAtlas->Defragment(pDevice, pContext, Attribs);
+        EXPECT_LE(NumMoved, 1u);
+        NumRelocations += NumMoved;
+    }
+    EXPECT_EQ(NumRelocations, SliceCount - 2);
+    EXPECT_EQ(CbData.NumCalls, SliceCount - 2);
+    EXPECT_TRUE(CbData.OK);
+
+    for (size_t i = 0; i < pSparseAllocations.size(); ++i)
+    {
+        const auto& pAlloc = pSparseAllocations[i];
+        EXPECT_EQ(pAlloc->GetSlice(), 0u);
+        EXPECT_EQ(pAlloc->GetSize(), uint2(AllocDim, AllocDim));
+        EXPECT_GT(pAlloc->GetVersion(), Versions[i]);
+    }
+
+    // Read back the first slice and check that every mip level of the moved allocations
+    // has been copied to the new location
+    {
+        TextureDesc StagingDesc    = CI.Desc;
+        StagingDesc.Name           = "Dynamic Texture Atlas Defragmentation Test staging texture";
+        StagingDesc.Type           = RESOURCE_DIM_TEX_2D;
+        StagingDesc.ArraySize      = 1;
+        StagingDesc.Usage          = USAGE_STAGING;
+        StagingDesc.BindFlags      = BIND_NONE;
+        StagingDesc.CPUAccessFlags = CPU_ACCESS_READ;
+
+        RefCntAutoPtr<ITexture> pStagingTex;
+        pDevice->CreateTexture(StagingDesc, nullptr, &pStagingTex);
+        ASSERT_NE(pStagingTex, nullptr);
+
+        pAtlasTex = pAtlas->GetTexture(pDevice, pContext);
+        ASSERT_NE(pAtlasTex, nullptr);
+        for (Uint32 mip = 0; mip < CI.Desc.MipLevels; ++mip)
+        {
+            CopyTextureAttribs CopyAttribs{pAtlasTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                           pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+            CopyAttribs.SrcMipLevel = mip;
+            CopyAttribs.DstMipLevel = mip;
+            pContext->CopyTexture(CopyAttribs);
+        }
+        pContext->WaitForIdle();
+
+        for (Uint32 mip = 0; mip < CI.Desc.MipLevels; ++mip)
+        {
+            MappedTextureSubresource MappedData;
+            pContext->MapTextureSubresource(pStagingTex, mip, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+            ASSERT_NE(MappedData.pData, nullptr);
+
+            const Uint32 MipDim = AllocDim >> mip;
+            for (size_t i = 0; i < pSparseAllocations.size(); ++i)
+            {
+                const auto Origin = pSparseAllocations[i]->GetOrigin();
+
+                Uint32 NumMismatches = 0;
+                for (Uint32 y = 0; y < MipDim; ++y)
+                {
+                    const auto* pRow = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(MappedData.pData) + MappedData.Stride * ((Origin.y >> mip) + y));
+                    for (Uint32 x = 0; x < MipDim; ++x)
+                    {
+                        if (pRow[(Origin.x >> mip) + x] != Colors[i])
+                            ++NumMismatches;
+                    }
+                }
+                EXPECT_EQ(NumMismatches, 0u) << "allocation " << i << ", mip " << mip;
+            }
+            pContext->UnmapTextureSubresource(pStagingTex, mip, 0);
+        }
+    }
+
+    pAtlas->GetUsageStats(Stats);
+    EXPECT_EQ(Stats.AllocationCount, AllocationsPerSlice / 4 + SliceCount - 2);
+    EXPECT_EQ(Stats.CommittedSliceCount, 1u);
+    EXPECT_EQ(Stats.PendingRelocationCount, 0u);
+    EXPECT_EQ(Stats.RelocationCount, Uint64{SliceCount - 2});
+
+    // Nothing left to defragment
+    EXPECT_EQ(pAtlas->Defragment(pDevice, pContext, Attribs), 0u);
+
+    pAllocations.clear();
+    pSparseAllocations.clear();
+    pAtlas->GetUsageStats(Stats);
+    EXPECT_EQ(Stats.AllocationCount, 0u);
+    EXPECT_EQ(Stats.CommittedSliceCount, 0u);
+    EXPECT_EQ(Stats.Fragmentation, 0.f);
+}
+
 } // namespace
@@ -27,6 +27,8 @@
 
 #include "GPUTestingEnvironment.hpp"
 #include "HLSL2GLSLConverter.h"
+#include "HLSL2GLSLConverterImpl.hpp"
+#include "ThreadPool.hpp"
 
 #include "gtest/gtest.h"
 
@@ -146,4 +148,202 @@ TEST(HLSL2GLSLConverterTest, GS)
     EXPECT_NE(pGS, nullptr);
 }
 
+// Verifies that a conversion stream that is reused for multiple conversions
+// produces the same output as a fresh stream.
+TEST(HLSL2GLSLConverterTest, StreamReuseMatchesFreshStream)
+{
+    auto* pEnv    = GPUTestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pShaderSourceFactory);
+    ASSERT_NE(pShaderSourceFactory, nullptr);
+
+    RefCntAutoPtr<IHLSL2GLSLConverter> pConverter;
+    CreateHLSL2GLSLConverter(&pConverter);
+    ASSERT_NE(pConverter, nullptr);
+
+    struct ShaderInfo
+    {
+        const char* FileName;
+        const char* EntryPoint;
+        SHADER_TYPE ShaderType;
+    };
+    // clang-format off
+    static constexpr ShaderInfo Shaders[] =
+    {
+        {"VS_PS.hlsl",        "TestVS", SHADER_TYPE_VERTEX},
+        {"VS_PS.hlsl",        "TestPS", SHADER_TYPE_PIXEL},
+        {"CS_RWBuff.hlsl",    "TestCS", SHADER_TYPE_COMPUTE},
+        {"CS_RWTex1D.hlsl",   "TestCS", SHADER_TYPE_COMPUTE},
+        {"CS_RWTex2D_1.hlsl", "TestCS", SHADER_TYPE_COMPUTE},
+        {"CS_RWTex2D_2.hlsl", "TestCS", SHADER_TYPE_COMPUTE},
+        {"GS.hlsl",           "main",   SHADER_TYPE_GEOMETRY},
+    };
+    // clang-format on
+
+    auto Convert = [&](const ShaderInfo& Shader, RefCntAutoPtr<IHLSL2GLSLConversionStream>& pStream) {
+        if (!pStream)
+        {
+            pConverter->CreateStream(Shader.FileName, pShaderSourceFactory, nullptr, 0, &pStream);
+            if (!pStream)
+                return std::string{};
+        }
+
+        RefCntAutoPtr<IDataBlob> pGLSLSource;
+        pStream->Convert(Shader.EntryPoint, Shader.ShaderType, false, "_sampler", true, &pGLSLSource);
+        if (!pGLSLSource)
+            return std::string{};
+
+        return std::string{static_cast<const char*>(pGLSLSource->GetConstDataPtr()), pGLSLSource->GetSize()};
+    };
+
+    std::vector<std::string> RefGLSL;
+    for (const auto& Shader : Shaders)
+    {
+        RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
+        RefGLSL.emplace_back(Convert(Shader, pStream));
+        EXPECT_FALSE(RefGLSL.back().empty()) << Shader.FileName << ": " << Shader.EntryPoint;
+    }
+
+    // Reuse the stream for all entry points in the same file, and convert every
+    // entry point twice to make sure that a conversion does not affect the next one.
+    RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
+    for (size_t s = 0; s < _countof(Shaders); ++s)
+    {
+        const auto& Shader = Shaders[s];
+        if (s > 0 && strcmp(Shaders[s - 1].FileName, Shader.FileName) != 0)
+            pStream.Release();
+
+        for (Uint32 i = 0; i < 2; ++i)
+            EXPECT_EQ(Convert(Shader, pStream), RefGLSL[s]) << Shader.FileName << ": " << Shader.EntryPoint;
+    }
+}
+
+
+// Verifies that entry points converted in parallel match the ones converted one by one.
+TEST(HLSL2GLSLConverterTest, ConvertEntryPoints)
+{
+    auto* pEnv    = GPUTestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pShaderSourceFactory);
+    ASSERT_NE(pShaderSourceFactory, nullptr);
+
+    RefCntAutoPtr<IHLSL2GLSLConverter> pConverter;
+    CreateHLSL2GLSLConverter(&pConverter);
+    ASSERT_NE(pConverter, nullptr);
+
+    RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
+    pConverter->CreateStream("VS_PS.hlsl", pShaderSourceFactory, nullptr, 0, &pStream);
+    ASSERT_NE(pStream, nullptr);
+
+    HLSL2GLSLEntryPointAttribs EntryPoints[3];
+    EntryPoints[0].EntryPoint = "TestVS";
+    EntryPoints[0].ShaderType = SHADER_TYPE_VERTEX;
+    EntryPoints[1].EntryPoint = "TestPS";
+    EntryPoints[1].ShaderType = SHADER_TYPE_PIXEL;
+    EntryPoints[2].EntryPoint = "TestPS";
+    EntryPoints[2].ShaderType = SHADER_TYPE_PIXEL;
+
+    EntryPoints[2].IncludeDefinitions = true;
+
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_NE(pThreadPool, nullptr);
+
+    for (IThreadPool* pPool : {static_cast<IThreadPool*>(nullptr), pThreadPool.RawPtr()})
+    {
+        IDataBlob* pSources[_countof(EntryPoints)] = {};
+        pStream->ConvertEntryPoints(EntryPoints, _countof(EntryPoints), pPool, pSources);
+
+        for (size_t i = 0; i < _countof(EntryPoints); ++i)
+        {
+            const auto& EP = EntryPoints[i];
+
+            RefCntAutoPtr<IDataBlob> pSource;
+            pSource.Attach(pSources[i]);
+            ASSERT_NE(pSource, nullptr) << EP.EntryPoint;
+
+            RefCntAutoPtr<IHLSL2GLSLConversionStream> pRefStream;
+            pConverter->CreateStream("VS_PS.hlsl", pShaderSourceFactory, nullptr, 0, &pRefStream);
+            ASSERT_NE(pRefStream, nullptr);
+
+            RefCntAutoPtr<IDataBlob> pRefSource;
+            pRefStream->Convert(EP.EntryPoint, EP.ShaderType, EP.IncludeDefinitions, EP.SamplerSuffix, EP.UseInOutLocationQualifiers, &pRefSource);
+            ASSERT_NE(pRefSource, nullptr) << EP.EntryPoint;
+
+            EXPECT_EQ(std::string(static_cast<const char*>(pSource->GetConstDataPtr()), pSource->GetSize()),
+                      std::string(static_cast<const char*>(pRefSource->GetConstDataPtr()), pRefSource->GetSize()))
+                << EP.EntryPoint;
+        }
+    }
+}
+
+// Verifies cache hits, misses and LRU eviction.
+TEST(HLSL2GLSLConverterTest, ConversionCache)
+{
+    auto* pEnv    = GPUTestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/HLSL2GLSLConverter", &pShaderSourceFactory);
+    ASSERT_NE(pShaderSourceFactory, nullptr);
+
+    const auto& Converter = HLSL2GLSLConverterImpl::GetInstance();
+
+    HLSL2GLSLConversionCache Cache{2};
+
+    auto Convert = [&](const char* EntryPoint, SHADER_TYPE ShaderType, bool IncludeDefinitions, bool UseInOutLocationQualifiers = true) {
+        HLSL2GLSLConverterImpl::ConversionAttribs Attribs;
+        Attribs.pSourceStreamFactory       = pShaderSourceFactory;
+        Attribs.InputFileName              = "VS_PS.hlsl";
+        Attribs.EntryPoint                 = EntryPoint;
+        Attribs.ShaderType                 = ShaderType;
+        Attribs.IncludeDefinitions         = IncludeDefinitions;
+        Attribs.UseInOutLocationQualifiers = UseInOutLocationQualifiers;
+        Attribs.pCache                     = &Cache;
+        return Converter.Convert(Attribs);
+    };
+
+    auto CheckStats = [&](Uint64 NumHits, Uint64 NumMisses, Uint64 NumEvictions, size_t NumEntries) {
+        const auto Stats = Cache.GetStats();
+        EXPECT_EQ(Stats.NumHits, NumHits);
+        EXPECT_EQ(Stats.NumMisses, NumMisses);
+        EXPECT_EQ(Stats.NumEvictions, NumEvictions);
+        EXPECT_EQ(Cache.GetEntryCount(), NumEntries);
+    };
+
+    const auto RefVS = Convert("TestVS", SHADER_TYPE_VERTEX, false);
+    ASSERT_FALSE(RefVS.empty());
+    CheckStats(0, 1, 0, 1);
+
+    const auto RefPS = Convert("TestPS", SHADER_TYPE_PIXEL, false);
+    ASSERT_FALSE(RefPS.empty());
+    CheckStats(0, 2, 0, 2);
+
+    // Sources with and without the definitions share the entry
+    const auto PSWithDefinitions = Convert("TestPS", SHADER_TYPE_PIXEL, true);
+    EXPECT_GT(PSWithDefinitions.length(), RefPS.length());
+    EXPECT_EQ(PSWithDefinitions.substr(PSWithDefinitions.length() - RefPS.length()), RefPS);
+    CheckStats(1, 2, 0, 2);
+
+    EXPECT_EQ(Convert("TestVS", SHADER_TYPE_VERTEX, false), RefVS);
+    CheckStats(2, 2, 0, 2);
+
+    // The same entry point converted with different options is a different entry.
+    // It evicts the least recently used entry, which is TestPS.
+    EXPECT_FALSE(Convert("TestVS", SHADER_TYPE_VERTEX, false, /*UseInOutLocationQualifiers = */ false).empty());
+    CheckStats(2, 3, 1, 2);
+
+    EXPECT_EQ(Convert("TestVS", SHADER_TYPE_VERTEX, false), RefVS);
+    CheckStats(3, 3, 1, 2);
+
+    EXPECT_EQ(Convert("TestPS", SHADER_TYPE_PIXEL, false), RefPS);
+    CheckStats(3, 4, 2, 2);
+
+    Cache.Clear();
+    EXPECT_EQ(Convert("TestVS", SHADER_TYPE_VERTEX, false), RefVS);
+    CheckStats(3, 5, 2, 1);
+}
 } // namespace
@@ -0,0 +1,591 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include <vector>
+
+#include "RenderGraph.hpp"
+#include "GPUTestingEnvironment.hpp"
+#include "TransientResourceTestCommon.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+TEST(RenderGraphTest, CullAndExecute)
+{
+    auto* pEnv     = GPUTestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    if (const auto* SkipReason = GetTransientResourcesSkipReason(pDevice, pContext))
+        GTEST_SKIP() << SkipReason;
+
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Render graph test texture";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.Width     = 256;
+    TexDesc.Height    = 256;
+    TexDesc.MipLevels = 1;
+    TexDesc.BindFlags = BIND_RENDER_TARGET | BIND_SHADER_RESOURCE;
+
+    RefCntAutoPtr<ITexture> pOutputTex;
+    pDevice->CreateTexture(TexDesc, nullptr, &pOutputTex);
+    ASSERT_NE(pOutputTex, nullptr);
+
+    RefCntAutoPtr<ITexture> pUnusedTex;
+    pDevice->CreateTexture(TexDesc, nullptr, &pUnusedTex);
+    ASSERT_NE(pUnusedTex, nullptr);
+
+    TextureDesc StagingDesc    = TexDesc;
+    StagingDesc.Name           = "Render graph test staging texture";
+    StagingDesc.Usage          = USAGE_STAGING;
+    StagingDesc.BindFlags      = BIND_NONE;
+    StagingDesc.CPUAccessFlags = CPU_ACCESS_READ;
+
+    RefCntAutoPtr<ITexture> pStagingTex;
+    pDevice->CreateTexture(StagingDesc, nullptr, &pStagingTex);
+    ASSERT_NE(pStagingTex, nullptr);
+
+    RenderGraphCreateInfo GraphCI;
+    GraphCI.Name = "Render graph test";
+    RenderGraph Graph{GraphCI};
+
+    const auto Output    = Graph.ImportTexture(pOutputTex);
+    const auto Unused    = Graph.ImportTexture(pUnusedTex);
+    const auto Transient = Graph.CreateTexture(TexDesc);
+    Graph.MarkOutput(Output, RESOURCE_STATE_SHADER_RESOURCE);
+
+    constexpr float ClearColor[] = {0.25f, 0.5f, 0.75f, 1.f};
+
+    const auto ClearPass = Graph.AddPass("Clear", 0, [&](IDeviceContext* pCtx) {
+        auto* pRTV = Graph.GetTexture(Transient)->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+        pCtx->SetRenderTargets(1, &pRTV, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+        pCtx->ClearRenderTarget(pRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_NONE);
+        pCtx->SetRenderTargets(0, nullptr, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+    });
+    Graph.Write(ClearPass, Transient, RESOURCE_STATE_RENDER_TARGET);
+
+    bool       UnusedPassExecuted = false;
+    const auto UnusedPass         = Graph.AddPass("Unused", 0, [&](IDeviceContext*) {
+        UnusedPassExecuted = true;
+    });
+    Graph.Read(UnusedPass, Transient, RESOURCE_STATE_SHADER_RESOURCE);
+    Graph.Write(UnusedPass, Unused, RESOURCE_STATE_RENDER_TARGET);
+
+    const auto CopyPass = Graph.AddPass("Copy", 0, [&](IDeviceContext* pCtx) {
+        CopyTextureAttribs CopyAttribs{Graph.GetTexture(Transient), RESOURCE_STATE_TRANSITION_MODE_NONE,
+                                       pOutputTex, RESOURCE_STATE_TRANSITION_MODE_NONE};
+        pCtx->CopyTexture(CopyAttribs);
+    });
+    Graph.Read(CopyPass, Transient, RESOURCE_STATE_COPY_SOURCE);
+    Graph.Write(CopyPass, Output, RESOURCE_STATE_COPY_DEST);
+
+    // The readback pass has no declared outputs and must not be culled
+    const auto ReadbackPass = Graph.AddPass(
+        "Readback", 0, [&](IDeviceContext* pCtx) {
+            CopyTextureAttribs CopyAttribs{pOutputTex, RESOURCE_STATE_TRANSITION_MODE_NONE,
+                                           pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+            pCtx->CopyTexture(CopyAttribs);
+        },
+        true);
+    Graph.Read(ReadbackPass, Output, RESOURCE_STATE_COPY_SOURCE);
+
+    Graph.Compile(pDevice, &pContext, 1);
+
+    EXPECT_FALSE(Graph.IsPassCulled(ClearPass));
+    EXPECT_TRUE(Graph.IsPassCulled(UnusedPass));
+    EXPECT_FALSE(Graph.IsPassCulled(CopyPass));
+    EXPECT_FALSE(Graph.IsPassCulled(ReadbackPass));
+
+    const auto& Stats = Graph.GetStats();
+    EXPECT_EQ(Stats.NumPasses, 4u);
+    EXPECT_EQ(Stats.NumCulledPasses, 1u);
+    // Transient: RENDER_TARGET -> COPY_SOURCE, Output: COPY_DEST -> COPY_SOURCE
+    EXPECT_EQ(Stats.NumBarriers, 2u);
+    EXPECT_EQ(Stats.NumCrossContextWaits, 0u);
+
+    for (Uint32 frame = 0; frame < 2; ++frame)
+    {
+        Graph.Execute(&pContext, 1);
+        EXPECT_FALSE(UnusedPassExecuted);
+        EXPECT_EQ(pOutputTex->GetState(), RESOURCE_STATE_SHADER_RESOURCE);
+
+        pContext->WaitForIdle();
+
+        MappedTextureSubresource MappedData;
+        pContext->MapTextureSubresource(pStagingTex, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+        const auto* pTexel = static_cast<const Uint8*>(MappedData.pData);
+        EXPECT_NEAR(pTexel[0], ClearColor[0] * 255.f, 1.f) << "frame " << frame;
+        EXPECT_NEAR(pTexel[1], ClearColor[1] * 255.f, 1.f) << "frame " << frame;
+        EXPECT_NEAR(pTexel[2], ClearColor[2] * 255.f, 1.f) << "frame " << frame;
+        pContext->UnmapTextureSubresource(pStagingTex, 0, 0);
+    }
+}
+
+RefCntAutoPtr<IBuffer> CreateTestBuffer(IRenderDevice* pDevice, const char* Name, Uint64 Size, BIND_FLAGS BindFlags, Uint64 ImmediateContextMask = 1)
+{
+    BufferDesc BuffDesc;
+    BuffDesc.Name                 = Name;
+    BuffDesc.Size                 = Size;
+    BuffDesc.BindFlags            = BindFlags;
+    BuffDesc.ImmediateContextMask = ImmediateContextMask;
+    if (BindFlags & BIND_UNORDERED_ACCESS)
+    {
+        BuffDesc.Mode              = BUFFER_MODE_STRUCTURED;
+        BuffDesc.ElementByteStride = 16;
+    }
+
+    RefCntAutoPtr<IBuffer> pBuffer;
+    pDevice->CreateBuffer(BuffDesc, nullptr, &pBuffer);
+    return pBuffer;
+}
+
+RefCntAutoPtr<IBuffer> CreateStagingBuffer(IRenderDevice* pDevice, const char* Name, Uint64 Size, Uint64 ImmediateContextMask = 1)
+{
+    BufferDesc BuffDesc;
+    BuffDesc.Name                 = Name;
+    BuffDesc.Size                 = Size;
+    BuffDesc.Usage                = USAGE_STAGING;
+    BuffDesc.CPUAccessFlags       = CPU_ACCESS_READ;
+    BuffDesc.ImmediateContextMask = ImmediateContextMask;
+
+    RefCntAutoPtr<IBuffer> pBuffer;
+    pDevice->CreateBuffer(BuffDesc, nullptr, &pBuffer);
+    return pBuffer;
+}
+
+void CheckBufferData(IDeviceContext* pContext, IBuffer* pStagingBuffer, Uint32 ExpectedValue, Uint32 Frame)
+{
+    void* pData = nullptr;
+    pContext->MapBuffer(pStagingBuffer, MAP_READ, MAP_FLAG_DO_NOT_WAIT, pData);
+    ASSERT_NE(pData, nullptr);
+    EXPECT_EQ(*static_cast<const Uint32*>(pData), ExpectedValue) << "frame " << Frame;
+    pContext->UnmapBuffer(pStagingBuffer, MAP_READ);
+}
+
+// Returns the index of an immediate context with the given queue type that is different from the main context
+Uint32 FindImmediateContext(COMMAND_QUEUE_TYPE QueueType)
+{
+    auto* pEnv = GPUTestingEnvironment::GetInstance();
+    for (Uint32 i = 1; i < pEnv->GetNumImmediateContexts(); ++i)
+    {
+        const auto CtxQueueType = pEnv->GetDeviceContext(i)->GetDesc().QueueType & COMMAND_QUEUE_TYPE_PRIMARY_MASK;
+        if ((CtxQueueType & QueueType) == QueueType && (QueueType == COMMAND_QUEUE_TYPE_GRAPHICS || (CtxQueueType & COMMAND_QUEUE_TYPE_GRAPHICS) != COMMAND_QUEUE_TYPE_GRAPHICS))
+            return i;
+    }
+    return ~0u;
+}
+
+TEST(RenderGraphTest, MergeBufferReadStates)
+{
+    auto* pEnv     = GPUTestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    auto pBuffer = CreateTestBuffer(pDevice, "Render graph test buffer", 16, BIND_VERTEX_BUFFER);
+    ASSERT_NE(pBuffer, nullptr);
+    auto pStagingBuffer = CreateStagingBuffer(pDevice, "Render graph test staging buffer", 16);
+    ASSERT_NE(pStagingBuffer, nullptr);
+
+    RenderGraphCreateInfo GraphCI;
+    GraphCI.Name = "Render graph read state merging test";
+    RenderGraph Graph{GraphCI};
+
+    const auto Buffer = Graph.ImportBuffer(pBuffer);
+
+    Uint32     Value      = 0;
+    const auto UpdatePass = Graph.AddPass("Update", 0, [&](IDeviceContext* pCtx) {
+        pCtx->UpdateBuffer(pBuffer, 0, sizeof(Value), &Value, RESOURCE_STATE_TRANSITION_MODE_NONE);
+    });
+    Graph.Write(UpdatePass, Buffer, RESOURCE_STATE_COPY_DEST);
+
+    const auto VertexPass = Graph.AddPass(
+        "Bind vertex buffer", 0, [&](IDeviceContext* pCtx) {
+            // The buffer is transitioned directly to the combined state
+            EXPECT_EQ(pBuffer->GetState(), RESOURCE_STATE_VERTEX_BUFFER | RESOURCE_STATE_COPY_SOURCE);
+            IBuffer* ppBuffers[] = {pBuffer};
+            pCtx->SetVertexBuffers(0, 1, ppBuffers, nullptr, RESOURCE_STATE_TRANSITION_MODE_VERIFY, SET_VERTEX_BUFFERS_FLAG_RESET);
+        },
+        true);
+    Graph.Read(VertexPass, Buffer, RESOURCE_STATE_VERTEX_BUFFER);
+
+    const auto ReadbackPass = Graph.AddPass(
+        "Readback", 0, [&](IDeviceContext* pCtx) {
+            EXPECT_EQ(pBuffer->GetState(), RESOURCE_STATE_VERTEX_BUFFER | RESOURCE_STATE_COPY_SOURCE);
+            pCtx->CopyBuffer(pBuffer, 0, RESOURCE_STATE_TRANSITION_MODE_VERIFY,
+                             pStagingBuffer, 0, sizeof(Value), RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        },
+        true);
+    Graph.Read(ReadbackPass, Buffer, RESOURCE_STATE_COPY_SOURCE);
+
+    Graph.Compile(pDevice, &pContext, 1);
+
+    const auto& Stats = Graph.GetStats();
+    EXPECT_EQ(Stats.NumCulledPasses, 0u);
+    // COPY_DEST -> VERTEX_BUFFER | COPY_SOURCE
+    EXPECT_EQ(Stats.NumBarriers, 1u);
+    EXPECT_EQ(Stats.NumMergedBarriers, 1u);
+    EXPECT_EQ(Stats.NumSplitBarriers, 0u);
+
+    for (Uint32 frame = 0; frame < 2; ++frame)
+    {
+        Value = 0x1234 + frame;
+        Graph.Execute(&pContext, 1);
+        pContext->WaitForIdle();
+        CheckBufferData(pContext, pStagingBuffer, Value, frame);
+    }
+}
+
+TEST(RenderGraphTest, SplitBarriers)
+{
+    auto* pEnv     = GPUTestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Render graph split barrier test texture";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.Width     = 64;
+    TexDesc.Height    = 64;
+    TexDesc.MipLevels = 1;
+    TexDesc.BindFlags = BIND_RENDER_TARGET;
+
+    RefCntAutoPtr<ITexture> pTex;
+    pDevice->CreateTexture(TexDesc, nullptr, &pTex);
+    ASSERT_NE(pTex, nullptr);
+
+    RefCntAutoPtr<ITexture> pOtherTex;
+    pDevice->CreateTexture(TexDesc, nullptr, &pOtherTex);
+    ASSERT_NE(pOtherTex, nullptr);
+
+    TextureDesc StagingDesc    = TexDesc;
+    StagingDesc.Usage          = USAGE_STAGING;
+    StagingDesc.BindFlags      = BIND_NONE;
+    StagingDesc.CPUAccessFlags = CPU_ACCESS_READ;
+
+    RefCntAutoPtr<ITexture> pStagingTex;
+    pDevice->CreateTexture(StagingDesc, nullptr, &pStagingTex);
+    ASSERT_NE(pStagingTex, nullptr);
+
+    RenderGraphCreateInfo GraphCI;
+    GraphCI.Name = "Render graph split barrier test";
+    RenderGraph Graph{GraphCI};
+
+    const auto Tex      = Graph.ImportTexture(pTex);
+    const auto OtherTex = Graph.ImportTexture(pOtherTex);
+    Graph.MarkOutput(OtherTex);
+
+    constexpr float ClearColor[]      = {0.25f, 0.5f, 0.75f, 1.f};
+    constexpr float OtherClearColor[] = {1.f, 0.f, 0.f, 1.f};
+
+    auto ClearRT = [](IDeviceContext* pCtx, ITexture* pTexture, const float* Color) {
+        auto* pRTV = pTexture->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+        pCtx->SetRenderTargets(1, &pRTV, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+        pCtx->ClearRenderTarget(pRTV, Color, RESOURCE_STATE_TRANSITION_MODE_NONE);
+        pCtx->SetRenderTargets(0, nullptr, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+    };
+
+    const auto ClearPass = Graph.AddPass("Clear", 0, [&](IDeviceContext* pCtx) {
+        ClearRT(pCtx, pTex, ClearColor);
+    });
+    Graph.Write(ClearPass, Tex, RESOURCE_STATE_RENDER_TARGET);
+
+    const auto OtherPass = Graph.AddPass("Other work", 0, [&](IDeviceContext* pCtx) {
+        // The begin part of the split barrier does not update the state
+        EXPECT_EQ(pTex->GetState(), RESOURCE_STATE_RENDER_TARGET);
+        ClearRT(pCtx, pOtherTex, OtherClearColor);
+    });
+    Graph.Write(OtherPass, OtherTex, RESOURCE_STATE_RENDER_TARGET);
+
+    const auto ReadbackPass = Graph.AddPass(
+        "Readback", 0, [&](IDeviceContext* pCtx) {
+            EXPECT_EQ(pTex->GetState(), RESOURCE_STATE_COPY_SOURCE);
+            CopyTextureAttribs CopyAttribs{pTex, RESOURCE_STATE_TRANSITION_MODE_VERIFY,
+                                           pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+            pCtx->CopyTexture(CopyAttribs);
+        },
+        true);
+    Graph.Read(ReadbackPass, Tex, RESOURCE_STATE_COPY_SOURCE);
+
+    Graph.Compile(pDevice, &pContext, 1);
+
+    const auto& Stats = Graph.GetStats();
+    EXPECT_EQ(Stats.NumCulledPasses, 0u);
+    // Tex: RENDER_TARGET -> COPY_SOURCE, split around the other pass
+    EXPECT_EQ(Stats.NumBarriers, 1u);
+    EXPECT_EQ(Stats.NumSplitBarriers, 1u);
+
+    for (Uint32 frame = 0; frame < 2; ++frame)
+    {
+        Graph.Execute(&pContext, 1);
+        pContext->WaitForIdle();
+
+        MappedTextureSubresource MappedData;
+        pContext->MapTextureSubresource(pStagingTex, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+        const auto* pTexel = static_cast<const Uint8*>(MappedData.pData);
+        EXPECT_NEAR(pTexel[0], ClearColor[0] * 255.f, 1.f) << "frame " << frame;
+        EXPECT_NEAR(pTexel[1], ClearColor[1] * 255.f, 1.f) << "frame " << frame;
+        EXPECT_NEAR(pTexel[2], ClearColor[2] * 255.f, 1.f) << "frame " << frame;
+        pContext->UnmapTextureSubresource(pStagingTex, 0, 0);
+    }
+}
+
+TEST(RenderGraphTest, UAVBarriers)
+{
+    auto* pEnv     = GPUTestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    if (!pDevice->GetDeviceInfo().Features.ComputeShaders)
+        GTEST_SKIP() << "Compute shaders are not supported by this device";
+
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    auto pBuffer = CreateTestBuffer(pDevice, "Render graph UAV test buffer", 256, BIND_UNORDERED_ACCESS);
+    ASSERT_NE(pBuffer, nullptr);
+
+    RenderGraphCreateInfo GraphCI;
+    GraphCI.Name = "Render graph UAV barrier test";
+    RenderGraph Graph{GraphCI};
+
+    const auto Buffer = Graph.ImportBuffer(pBuffer);
+    Graph.MarkOutput(Buffer);
+
+    Uint32 NumExecutedPasses = 0;
+    auto   AddPass           = [&](const char* Name, bool IsRead, bool IsWrite) {
+        // Passes that only read the buffer have no outputs
+        const auto Pass = Graph.AddPass(
+            Name, 0, [&](IDeviceContext*) { ++NumExecutedPasses; }, !IsWrite);
+        if (IsRead)
+            Graph.Read(Pass, Buffer, RESOURCE_STATE_UNORDERED_ACCESS);
+        if (IsWrite)
+            Graph.Write(Pass, Buffer, RESOURCE_STATE_UNORDERED_ACCESS);
+    };
+
+    AddPass("Write", false, true);
+    AddPass("Modify", true, true);     // UAV barrier: write after write
+    AddPass("Read 0", true, false);    // UAV barrier: read after write
+    AddPass("Read 1", true, false);    // No barrier: read after read
+    AddPass("Overwrite", false, true); // UAV barrier: write after read
+
+    Graph.Compile(pDevice, &pContext, 1);
+
+    const auto& Stats = Graph.GetStats();
+    EXPECT_EQ(Stats.NumCulledPasses, 0u);
+    EXPECT_EQ(Stats.NumBarriers, 3u);
+    EXPECT_EQ(Stats.NumSkippedBarriers, 1u);
+    EXPECT_EQ(Stats.NumMergedBarriers, 0u);
+    EXPECT_EQ(Stats.NumSplitBarriers, 0u);
+
+    Graph.Execute(&pContext, 1);
+    EXPECT_EQ(NumExecutedPasses, 5u);
+    EXPECT_EQ(pBuffer->GetState(), RESOURCE_STATE_UNORDERED_ACCESS);
+    pContext->WaitForIdle();
+}
+
+TEST(RenderGraphTest, PruneCrossContextWaits)
+{
+    auto* pEnv     = GPUTestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    if (pEnv->GetNumImmediateContexts() < 2)
+        GTEST_SKIP() << "This test requires multiple immediate contexts";
+
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    IDeviceContext* ppContexts[] = {pContext, pEnv->GetDeviceContext(1)};
+
+    const Uint64 ContextMask = (Uint64{1} << ppContexts[0]->GetDesc().ContextId) | (Uint64{1} << ppContexts[1]->GetDesc().ContextId);
+
+    RefCntAutoPtr<IBuffer> pBuffers[2];
+    RefCntAutoPtr<IBuffer> pStagingBuffers[2];
+    for (Uint32 i = 0; i < 2; ++i)
+    {
+        pBuffers[i] = CreateTestBuffer(pDevice, "Render graph cross-context test buffer", 16, BIND_NONE, ContextMask);
+        ASSERT_NE(pBuffers[i], nullptr);
+        pStagingBuffers[i] = CreateStagingBuffer(pDevice, "Render graph cross-context test staging buffer", 16, ContextMask);
+        ASSERT_NE(pStagingBuffers[i], nullptr);
+    }
+
+    RenderGraphCreateInfo GraphCI;
+    GraphCI.Name = "Render graph cross-context wait test";
+    RenderGraph Graph{GraphCI};
+
+    const Uint32 Buffers[] = {Graph.ImportBuffer(pBuffers[0]), Graph.ImportBuffer(pBuffers[1])};
+
+    Uint32 Values[2] = {};
+    for (Uint32 i = 0; i < 2; ++i)
+    {
+        const auto Pass = Graph.AddPass("Update", 0, [&, i](IDeviceContext* pCtx) {
+            pCtx->UpdateBuffer(pBuffers[i], 0, sizeof(Values[i]), &Values[i], RESOURCE_STATE_TRANSITION_MODE_NONE);
+        });
+        Graph.Write(Pass, Buffers[i], RESOURCE_STATE_COPY_DEST);
+    }
+
+    // Read the buffers in the reverse order: waiting for the second update
+    // also waits for the first one, so the second wait is redundant.
+    for (Uint32 i = 0; i < 2; ++i)
+    {
+        const auto Idx  = 1 - i;
+        const auto Pass = Graph.AddPass(
+            "Readback", 1, [&, Idx](IDeviceContext* pCtx) {
+                pCtx->CopyBuffer(pBuffers[Idx], 0, RESOURCE_STATE_TRANSITION_MODE_VERIFY,
+                                 pStagingBuffers[Idx], 0, sizeof(Values[Idx]), RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+            },
+            true);
+        Graph.Read(Pass, Buffers[Idx], RESOURCE_STATE_COPY_SOURCE);
+    }
+
+    Graph.Compile(pDevice, ppContexts, 2);
+
+    const auto& Stats = Graph.GetStats();
+    EXPECT_EQ(Stats.NumCulledPasses, 0u);
+    EXPECT_EQ(Stats.NumCrossContextWaits, 1u);
+
+    // The update passes of the next execution must wait for the readback passes of the previous one
+    for (Uint32 frame = 0; frame < 3; ++frame)
+    {
+        Values[0] = 0x100 + frame;
+        Values[1] = 0x200 + frame;
+        Graph.Execute(ppContexts, 2);
+    }
+    ppContexts[0]->WaitForIdle();
+    ppContexts[1]->WaitForIdle();
+    for (Uint32 i = 0; i < 2; ++i)
+        CheckBufferData(ppContexts[1], pStagingBuffers[i], Values[i], 2);
+}
+
+TEST(RenderGraphTest, ProducerSideTransition)
+{
+    auto* pEnv     = GPUTestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    if ((pContext->GetDesc().QueueType & COMMAND_QUEUE_TYPE_GRAPHICS) != COMMAND_QUEUE_TYPE_GRAPHICS)
+        GTEST_SKIP() << "The main context is not a graphics context";
+
+    const auto ComputeCtxIdx = FindImmediateContext(COMMAND_QUEUE_TYPE_COMPUTE);
+    if (ComputeCtxIdx == ~0u)
+        GTEST_SKIP() << "This test requires a compute-only immediate context";
+
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    IDeviceContext* ppContexts[] = {pContext, pEnv->GetDeviceContext(ComputeCtxIdx)};
+
+    const Uint64 ContextMask = (Uint64{1} << ppContexts[0]->GetDesc().ContextId) | (Uint64{1} << ppContexts[1]->GetDesc().ContextId);
+
+    TextureDesc TexDesc;
+    TexDesc.Name                 = "Render graph producer-side transition test texture";
+    TexDesc.Type                 = RESOURCE_DIM_TEX_2D;
+    TexDesc.Format               = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.Width                = 64;
+    TexDesc.Height               = 64;
+    TexDesc.MipLevels            = 1;
+    TexDesc.BindFlags            = BIND_RENDER_TARGET;
+    TexDesc.ImmediateContextMask = ContextMask;
+
+    RefCntAutoPtr<ITexture> pTex;
+    pDevice->CreateTexture(TexDesc, nullptr, &pTex);
+    ASSERT_NE(pTex, nullptr);
+
+    TextureDesc StagingDesc    = TexDesc;
+    StagingDesc.Usage          = USAGE_STAGING;
+    StagingDesc.BindFlags      = BIND_NONE;
+    StagingDesc.CPUAccessFlags = CPU_ACCESS_READ;
+
+    RefCntAutoPtr<ITexture> pStagingTex;
+    pDevice->CreateTexture(StagingDesc, nullptr, &pStagingTex);
+    ASSERT_NE(pStagingTex, nullptr);
+
+    RenderGraphCreateInfo GraphCI;
+    GraphCI.Name = "Render graph producer-side transition test";
+    RenderGraph Graph{GraphCI};
+
+    const auto Tex = Graph.ImportTexture(pTex);
+
+    float ClearColor[] = {0, 0.5f, 0.75f, 1.f};
+
+    const auto ClearPass = Graph.AddPass("Clear", 0, [&](IDeviceContext* pCtx) {
+        auto* pRTV = pTex->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+        pCtx->SetRenderTargets(1, &pRTV, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+        pCtx->ClearRenderTarget(pRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_NONE);
+        pCtx->SetRenderTargets(0, nullptr, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+    });
+    Graph.Write(ClearPass, Tex, RESOURCE_STATE_RENDER_TARGET);
+
+    // The compute context can't transition the texture from the render target state,
+    // so the transition must be performed by the graphics context after the clear pass.
+    const auto ReadbackPass = Graph.AddPass(
+        "Readback", 1, [&](IDeviceContext* pCtx) {
+            EXPECT_EQ(pTex->GetState(), RESOURCE_STATE_COPY_SOURCE);
+            CopyTextureAttribs CopyAttribs{pTex, RESOURCE_STATE_TRANSITION_MODE_VERIFY,
+                                           pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+            pCtx->CopyTexture(CopyAttribs);
+        },
+        true);
+    Graph.Read(ReadbackPass, Tex, RESOURCE_STATE_COPY_SOURCE);
+
+    Graph.Compile(pDevice, ppContexts, 2);
+
+    const auto& Stats = Graph.GetStats();
+    EXPECT_EQ(Stats.NumBarriers, 1u);
+    EXPECT_EQ(Stats.NumCrossContextWaits, 1u);
+
+    for (Uint32 frame = 0; frame < 2; ++frame)
+    {
+        ClearColor[0] = frame == 0 ? 0.25f : 1.f;
+        Graph.Execute(ppContexts, 2);
+        ppContexts[1]->WaitForIdle();
+
+        MappedTextureSubresource MappedData;
+        ppContexts[1]->MapTextureSubresource(pStagingTex, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+        const auto* pTexel = static_cast<const Uint8*>(MappedData.pData);
+        EXPECT_NEAR(pTexel[0], ClearColor[0] * 255.f, 1.f) << "frame " << frame;
+        EXPECT_NEAR(pTexel[1], ClearColor[1] * 255.f, 1.f) << "frame " << frame;
+        EXPECT_NEAR(pTexel[2], ClearColor[2] * 255.f, 1.f) << "frame " << frame;
+        ppContexts[1]->UnmapTextureSubresource(pStagingTex, 0, 0);
+    }
+    ppContexts[0]->WaitForIdle();
+}
+
+} // namespace
@@ -34,6 +34,10 @@
 #include "GraphicsTypesX.hpp"
 #include "CallbackWrapper.hpp"
 #include "ResourceLayoutTestCommon.hpp"
+#include "MappedFileStream.hpp"
+#include "FileWrapper.hpp"
+#include "FileSystem.hpp"
+#include "TempDirectory.hpp"
 
 #include "InlineShaders/RayTracingTestHLSL.h"
 
@@ -375,6 +379,58 @@ TEST(RenderStateCacheTest, CreateShader)
     }
 }
 
+// Verifies that the cache can be loaded directly from a memory-mapped file.
+TEST(RenderStateCacheTest, LoadFromMappedFile)
+{
+    auto* pEnv    = GPUTestingEnvironment::GetInstance();
+    auto* pDevice = pEnv->GetDevice();
+
+    GPUTestingEnvironment::ScopedReset AutoReset;
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
+    pDevice->GetEngineFactory()->CreateDefaultShaderSourceStreamFactory("shaders/RenderStateCache", &pShaderSourceFactory);
+    ASSERT_TRUE(pShaderSourceFactory);
+
+    TempDirectory TmpDir;
+
+    const auto FilePath = TmpDir.Get() + FileSystem::SlashSymbol + "RenderStateCache.bin";
+    {
+        auto pCache = CreateCache(pDevice, /*HotReload = */ false);
+        ASSERT_TRUE(pCache);
+
+        RefCntAutoPtr<IShader> pVS, pPS;
+        CreateGraphicsShaders(pCache, pShaderSourceFactory, pVS, pPS, false);
+        ASSERT_NE(pVS, nullptr);
+        ASSERT_NE(pPS, nullptr);
+
+        RefCntAutoPtr<IDataBlob> pData;
+        pCache->WriteToBlob(&pData);
+        ASSERT_NE(pData, nullptr);
+
+        FileWrapper File{FilePath.c_str(), EFileAccessMode::Overwrite};
+        ASSERT_TRUE(File);
+        ASSERT_TRUE(File->Write(pData->GetConstDataPtr(), pData->GetSize()));
+    }
+
+    auto pMappedData = MappedDataBlob::Create(FilePath.c_str(), EFileMapMode::ReadOnly, EFileMapAccessHint::Random);
+    ASSERT_NE(pMappedData, nullptr);
+
+    auto pCache = CreateCache(pDevice, /*HotReload = */ false, pMappedData);
+    ASSERT_TRUE(pCache);
+
+    // The cache keeps a reference to the mapped data
+    pMappedData.Release();
+
+    auto pTexSRV = CreateWhiteTexture();
+
+    RefCntAutoPtr<IShader> pVS, pPS;
+    CreateGraphicsShaders(pCache, pShaderSourceFactory, pVS, pPS, true);
+    ASSERT_NE(pVS, nullptr);
+    ASSERT_NE(pPS, nullptr);
+
+    VerifyGraphicsShaders(pVS, pPS, pTexSRV);
+}
+
 TEST(RenderStateCacheTest, BrokenShader)
 {
     auto* pEnv    = GPUTestingEnvironment::GetInstance();
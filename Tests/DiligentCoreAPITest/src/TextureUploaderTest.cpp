@@ -26,12 +26,16 @@
  */
 
 #include "TextureUploader.hpp"
+#include "TextureUploadPipeline.hpp"
+#include "DataBlobImpl.hpp"
+#include "ThreadPool.hpp"
 #include "GPUTestingEnvironment.hpp"
 
 #include "gtest/gtest.h"
 
 #include <atomic>
 #include <thread>
+#include <vector>
 
 using namespace Diligent;
 using namespace Diligent::Testing;
@@ -89,7 +93,13 @@ Uint32 WriteOrVerifyRGBAData(MappedTextureSubresource& MappedData,
     return NumInvalidPixels;
 }
 
-void TextureUploaderTest(bool IsRenderThread)
+bool IsStagingRingSupported(IRenderDevice* pDevice)
+{
+    const auto DeviceType = pDevice->GetDeviceInfo().Type;
+    return DeviceType == RENDER_DEVICE_TYPE_D3D12 || DeviceType == RENDER_DEVICE_TYPE_VULKAN;
+}
+
+void TextureUploaderTest(bool IsRenderThread, const TextureUploaderDesc& UploaderDesc = {}, TextureUploaderStats* pStats = nullptr)
 {
     auto* pEnv     = GPUTestingEnvironment::GetInstance();
     auto* pDevice  = pEnv->GetDevice();
@@ -100,9 +110,13 @@ void TextureUploaderTest(bool IsRenderThread)
         GTEST_SKIP() << "Texture uploader is not currently implemented in Metal";
     }
 
+    if (UploaderDesc.StagingRingSize != 0 && !IsStagingRingSupported(pDevice))
+    {
+        GTEST_SKIP() << "Staging ring is only supported in Direct3D12 and Vulkan";
+    }
+
     GPUTestingEnvironment::ScopedReset EnvironmentAutoReset;
 
-    TextureUploaderDesc             UploaderDesc;
     RefCntAutoPtr<ITextureUploader> pTexUploader;
     CreateTextureUploader(pDevice, UploaderDesc, &pTexUploader);
     ASSERT_TRUE(pTexUploader);
@@ -208,6 +222,9 @@ void TextureUploaderTest(bool IsRenderThread)
             }
         }
     }
+
+    if (pStats != nullptr)
+        *pStats = pTexUploader->GetStats();
 }
 
 TEST(TextureUploaderTest, RenderThread)
@@ -220,4 +237,283 @@ TEST(TextureUploaderTest, WorkerThread)
     TextureUploaderTest(false);
 }
 
+TEST(TextureUploaderTest, StagingRing_RenderThread)
+{
+    TextureUploaderDesc UploaderDesc;
+    UploaderDesc.StagingRingSize = 1 << 20;
+    TextureUploaderTest(true, UploaderDesc);
+}
+
+TEST(TextureUploaderTest, StagingRing_WorkerThread)
+{
+    TextureUploaderDesc UploaderDesc;
+    UploaderDesc.StagingRingSize = 1 << 20;
+    TextureUploaderTest(false, UploaderDesc);
+}
+
+// Small ring that can't hold all buffers at once
+TEST(TextureUploaderTest, StagingRing_Stall)
+{
+    TextureUploaderDesc UploaderDesc;
+    UploaderDesc.StagingRingSize = 200 << 10;
+
+    TextureUploaderStats Stats;
+    TextureUploaderTest(true, UploaderDesc, &Stats);
+    if (IsSkipped() || HasFatalFailure())
+        return;
+
+    // Every upload buffer takes most of the ring, so the allocations of the later
+    // iterations must wait for the GPU to finish the copies of the earlier ones.
+    EXPECT_GT(Stats.NumStalls, 0u);
+}
+
+TEST(TextureUploaderTest, StagingRing_FrameBudget)
+{
+    auto* pEnv     = GPUTestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    if (!IsStagingRingSupported(pDevice))
+    {
+        GTEST_SKIP() << "Staging ring is only supported in Direct3D12 and Vulkan";
+    }
+
+    GPUTestingEnvironment::ScopedReset EnvironmentAutoReset;
+
+    // Budget of one byte only allows one copy per update
+    TextureUploaderDesc UploaderDesc;
+    UploaderDesc.StagingRingSize = 1 << 20;
+    UploaderDesc.FrameBudget     = 1;
+
+    RefCntAutoPtr<ITextureUploader> pTexUploader;
+    CreateTextureUploader(pDevice, UploaderDesc, &pTexUploader);
+    ASSERT_TRUE(pTexUploader);
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Texture uploader budget test dst texture";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Width     = 64;
+    TexDesc.Height    = 64;
+    TexDesc.BindFlags = BIND_SHADER_RESOURCE;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    RefCntAutoPtr<ITexture> pDstTexture;
+    pDevice->CreateTexture(TexDesc, nullptr, &pDstTexture);
+    ASSERT_TRUE(pDstTexture);
+
+    TexDesc.Name           = "Texture uploader budget test staging texture";
+    TexDesc.Usage          = USAGE_STAGING;
+    TexDesc.CPUAccessFlags = CPU_ACCESS_READ;
+    TexDesc.BindFlags      = BIND_NONE;
+    RefCntAutoPtr<ITexture> pStagingTexture;
+    pDevice->CreateTexture(TexDesc, nullptr, &pStagingTexture);
+    ASSERT_TRUE(pStagingTexture);
+
+    UploadBufferDesc UploadBuffDesc;
+    UploadBuffDesc.Width  = TexDesc.Width;
+    UploadBuffDesc.Height = TexDesc.Height;
+    UploadBuffDesc.Format = TexDesc.Format;
+
+    // All buffers are copied to the same subresource in the order of decreasing priority.
+    // The buffer with the lowest priority is scheduled first, but must be copied last.
+    constexpr Uint32 NumBuffers = 4;
+    Uint32           cnt        = 0;
+    Uint32           ref_cnt    = 0;
+    for (Uint32 i = 0; i < NumBuffers; ++i)
+    {
+        UploadBuffDesc.Priority = static_cast<Int32>(i);
+        if (i == 0)
+            ref_cnt = cnt;
+
+        RefCntAutoPtr<IUploadBuffer> pUploadBuffer;
+        pTexUploader->AllocateUploadBuffer(pContext, UploadBuffDesc, &pUploadBuffer);
+        ASSERT_TRUE(pUploadBuffer);
+        auto MappedData = pUploadBuffer->GetMappedData(0, 0);
+        WriteOrVerifyRGBAData(MappedData, UploadBuffDesc, 0, 0, cnt, false);
+
+        pTexUploader->ScheduleGPUCopy(nullptr, pDstTexture, 0, 0, pUploadBuffer);
+        pTexUploader->RecycleBuffer(pUploadBuffer);
+    }
+    EXPECT_EQ(pTexUploader->GetStats().NumPendingOperations, NumBuffers);
+
+    for (Uint32 i = 0; i < NumBuffers; ++i)
+    {
+        pTexUploader->RenderThreadUpdate(pContext);
+        const auto Stats = pTexUploader->GetStats();
+        EXPECT_EQ(Stats.NumPendingOperations, NumBuffers - i - 1);
+        EXPECT_GE(Stats.BytesCopiedLastUpdate, Uint64{UploadBuffDesc.Width} * UploadBuffDesc.Height * 4);
+    }
+
+    CopyTextureAttribs CopyAttribs{pDstTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pStagingTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+    pContext->CopyTexture(CopyAttribs);
+    pContext->WaitForIdle();
+
+    MappedTextureSubresource MappedData;
+    pContext->MapTextureSubresource(pStagingTexture, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+    WriteOrVerifyRGBAData(MappedData, UploadBuffDesc, 0, 0, ref_cnt, true);
+    pContext->UnmapTextureSubresource(pStagingTexture, 0, 0);
+
+    // All ring memory must be released once the GPU is idle
+    pTexUploader->RenderThreadUpdate(pContext);
+    EXPECT_EQ(pTexUploader->GetStats().BytesInFlight, Uint64{0});
+
+    // Copies scheduled from the render thread are executed immediately while the budget allows.
+    // Once the budget is used up, they are deferred and must be reported as pending.
+    for (Uint32 i = 0; i < 2; ++i)
+    {
+        RefCntAutoPtr<IUploadBuffer> pUploadBuffer;
+        pTexUploader->AllocateUploadBuffer(pContext, UploadBuffDesc, &pUploadBuffer);
+        ASSERT_TRUE(pUploadBuffer);
+        pTexUploader->ScheduleGPUCopy(pContext, pDstTexture, 0, 0, pUploadBuffer);
+        pTexUploader->RecycleBuffer(pUploadBuffer);
+        EXPECT_EQ(pTexUploader->GetStats().NumPendingOperations, i);
+    }
+
+    pTexUploader->RenderThreadUpdate(pContext);
+    EXPECT_EQ(pTexUploader->GetStats().NumPendingOperations, 0u);
+
+    pContext->WaitForIdle();
+    pTexUploader->RenderThreadUpdate(pContext);
+    EXPECT_EQ(pTexUploader->GetStats().BytesInFlight, Uint64{0});
+}
+
+TEST(TextureUploaderTest, UploadPipeline)
+{
+    auto* pEnv     = GPUTestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    if (pDevice->GetDeviceInfo().IsMetalDevice())
+    {
+        GTEST_SKIP() << "Texture uploader is not currently implemented in Metal";
+    }
+
+    GPUTestingEnvironment::ScopedReset EnvironmentAutoReset;
+
+    RefCntAutoPtr<ITextureUploader> pTexUploader;
+    CreateTextureUploader(pDevice, TextureUploaderDesc{}, &pTexUploader);
+    ASSERT_TRUE(pTexUploader);
+
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{2});
+    ASSERT_TRUE(pThreadPool);
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Texture upload pipeline dst texture";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D_ARRAY;
+    TexDesc.Width     = 64;
+    TexDesc.Height    = 64;
+    TexDesc.MipLevels = 2;
+    TexDesc.ArraySize = 8;
+    TexDesc.BindFlags = BIND_SHADER_RESOURCE;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    RefCntAutoPtr<ITexture> pDstTexture;
+    pDevice->CreateTexture(TexDesc, nullptr, &pDstTexture);
+    ASSERT_TRUE(pDstTexture);
+
+    TexDesc.Name           = "Texture upload pipeline staging texture";
+    TexDesc.Usage          = USAGE_STAGING;
+    TexDesc.CPUAccessFlags = CPU_ACCESS_READ;
+    TexDesc.BindFlags      = BIND_NONE;
+    RefCntAutoPtr<ITexture> pStagingTexture;
+    pDevice->CreateTexture(TexDesc, nullptr, &pStagingTexture);
+    ASSERT_TRUE(pStagingTexture);
+
+    UploadBufferDesc UploadBuffDesc;
+    UploadBuffDesc.Width     = TexDesc.Width;
+    UploadBuffDesc.Height    = TexDesc.Height;
+    UploadBuffDesc.Format    = TexDesc.Format;
+    UploadBuffDesc.MipLevels = TexDesc.MipLevels;
+
+    // Odd slices are "encoded" by XOR-ing the texels with a constant
+    constexpr Uint8 XorKey  = 0x5A;
+    auto            Decoder = [](IDataBlob* pPayload, IUploadBuffer* pUploadBuffer) {
+        auto pDecoded = DataBlobImpl::Create(pPayload->GetSize(), pPayload->GetConstDataPtr());
+        for (size_t i = 0; i < pDecoded->GetSize(); ++i)
+            pDecoded->GetDataPtr<Uint8>()[i] ^= XorKey;
+        return CopyRawTexelsToUploadBuffer(pDecoded, pUploadBuffer);
+    };
+
+    std::vector<RefCntAutoPtr<IDataBlob>> Payloads(TexDesc.ArraySize);
+    {
+        Uint32 cnt = 0;
+        for (Uint32 slice = 0; slice < TexDesc.ArraySize; ++slice)
+        {
+            const size_t Mip0Size = size_t{UploadBuffDesc.Width} * UploadBuffDesc.Height * 4;
+            auto         pPayload = DataBlobImpl::Create(Mip0Size + Mip0Size / 4);
+            for (Uint32 mip = 0, Offset = 0; mip < UploadBuffDesc.MipLevels; ++mip)
+            {
+                MappedTextureSubresource MappedData{pPayload->GetDataPtr<Uint8>() + Offset, Uint64{UploadBuffDesc.Width >> mip} * 4};
+                WriteOrVerifyRGBAData(MappedData, UploadBuffDesc, mip, slice, cnt, false);
+                Offset += static_cast<Uint32>(MappedData.Stride * (UploadBuffDesc.Height >> mip));
+            }
+            if (slice % 2 == 1)
+            {
+                for (size_t i = 0; i < pPayload->GetSize(); ++i)
+                    pPayload->GetDataPtr<Uint8>()[i] ^= XorKey;
+            }
+            Payloads[slice] = pPayload;
+        }
+    }
+
+    {
+        TextureUploadPipelineCreateInfo PipelineCI;
+        PipelineCI.pUploader          = pTexUploader;
+        PipelineCI.pThreadPool        = pThreadPool;
+        PipelineCI.MaxUploadsInFlight = 2;
+        TextureUploadPipeline Pipeline{PipelineCI};
+
+        // The loader thread is blocked by the pipeline when too many uploads are in flight
+        std::atomic_bool AllEnqueued{false};
+        std::thread      LoaderThread{[&]() {
+            for (Uint32 slice = 0; slice < TexDesc.ArraySize; ++slice)
+            {
+                TextureUploadRequest Request;
+                Request.BufferDesc  = UploadBuffDesc;
+                Request.pDstTexture = pDstTexture;
+                Request.DstSlice    = slice;
+                Request.pPayload    = Payloads[slice];
+                if (slice % 2 == 1)
+                    Request.Decoder = Decoder;
+                Pipeline.EnqueueUpload(Request);
+            }
+            AllEnqueued.store(true);
+        }};
+
+        while (!AllEnqueued || Pipeline.GetStats().NumUploadsInFlight != 0)
+        {
+            pTexUploader->RenderThreadUpdate(pContext);
+        }
+        LoaderThread.join();
+
+        const auto Stats = Pipeline.GetStats();
+        EXPECT_EQ(Stats.NumUploadsCompleted, TexDesc.ArraySize);
+        EXPECT_EQ(Stats.NumFailedUploads, 0u);
+    }
+
+    for (Uint32 slice = 0; slice < TexDesc.ArraySize; ++slice)
+    {
+        for (Uint32 mip = 0; mip < TexDesc.MipLevels; ++mip)
+        {
+            CopyTextureAttribs CopyAttribs{pDstTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pStagingTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+            CopyAttribs.SrcMipLevel = mip;
+            CopyAttribs.SrcSlice    = slice;
+            CopyAttribs.DstMipLevel = mip;
+            CopyAttribs.DstSlice    = slice;
+            pContext->CopyTexture(CopyAttribs);
+        }
+    }
+    pContext->WaitForIdle();
+
+    Uint32 ref_cnt = 0;
+    for (Uint32 slice = 0; slice < TexDesc.ArraySize; ++slice)
+    {
+        for (Uint32 mip = 0; mip < TexDesc.MipLevels; ++mip)
+        {
+            MappedTextureSubresource MappedData;
+            pContext->MapTextureSubresource(pStagingTexture, mip, slice, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+            WriteOrVerifyRGBAData(MappedData, UploadBuffDesc, mip, slice, ref_cnt, true);
+            pContext->UnmapTextureSubresource(pStagingTexture, mip, slice);
+        }
+    }
+}
+
 } // namespace
@@ -0,0 +1,138 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include "TransientResourceAllocator.hpp"
+#include "GPUTestingEnvironment.hpp"
+#include "TransientResourceTestCommon.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+TEST(TransientResourceAllocatorTest, RenderTargetChain)
+{
+    auto* pEnv     = GPUTestingEnvironment::GetInstance();
+    auto* pDevice  = pEnv->GetDevice();
+    auto* pContext = pEnv->GetDeviceContext();
+
+    if (const auto* SkipReason = GetTransientResourcesSkipReason(pDevice, pContext))
+        GTEST_SKIP() << SkipReason;
+
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    // Pass i writes texture i and reads texture i-1, so only two textures are alive at a time
+    constexpr Uint32 NumPasses = 6;
+
+    TransientResourceAllocatorCreateInfo AllocatorCI;
+    AllocatorCI.Name = "Transient resource allocator test";
+    TransientResourceAllocator Allocator{AllocatorCI};
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Transient render target";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.Width     = 512;
+    TexDesc.Height    = 512;
+    TexDesc.MipLevels = 1;
+    TexDesc.BindFlags = BIND_RENDER_TARGET | BIND_SHADER_RESOURCE;
+
+    Uint32 Handles[NumPasses] = {};
+    for (Uint32 i = 0; i < NumPasses; ++i)
+        Handles[i] = Allocator.AddTexture(TexDesc, i, i + 1);
+
+    Allocator.Commit(pDevice, pContext);
+
+    bool IsAliased = true;
+    for (Uint32 i = 0; i < NumPasses; ++i)
+    {
+        ASSERT_NE(Allocator.GetTexture(Handles[i]), nullptr);
+        IsAliased = IsAliased && Allocator.IsAliased(Handles[i]);
+    }
+    if (IsAliased)
+    {
+        EXPECT_LT(Allocator.GetMemorySize(), Allocator.GetUnaliasedMemorySize());
+        EXPECT_LE(Allocator.GetMemorySize(), Allocator.GetUnaliasedMemorySize() * 2 / NumPasses);
+    }
+
+    TextureDesc StagingDesc    = TexDesc;
+    StagingDesc.Name           = "Transient resource allocator test staging texture";
+    StagingDesc.Usage          = USAGE_STAGING;
+    StagingDesc.BindFlags      = BIND_NONE;
+    StagingDesc.CPUAccessFlags = CPU_ACCESS_READ;
+
+    RefCntAutoPtr<ITexture> pStagingTex;
+    pDevice->CreateTexture(StagingDesc, nullptr, &pStagingTex);
+    ASSERT_NE(pStagingTex, nullptr);
+
+    auto GetClearColor = [](Uint32 Pass, float* Color) {
+        Color[0] = static_cast<float>(Pass + 1) / 16.f;
+        Color[1] = 0;
+        Color[2] = 0;
+        Color[3] = 1;
+    };
+
+    for (Uint32 frame = 0; frame < 2; ++frame)
+    {
+        for (Uint32 pass = 0; pass < NumPasses; ++pass)
+        {
+            Allocator.BeginPass(pContext, pass);
+
+            float ClearColor[4];
+            GetClearColor(pass, ClearColor);
+            auto* pRTV = Allocator.GetTexture(Handles[pass])->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+            pContext->SetRenderTargets(1, &pRTV, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+            pContext->ClearRenderTarget(pRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+            pContext->SetRenderTargets(0, nullptr, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+
+            if (pass == 0)
+                continue;
+
+            // The texture written by the previous pass must not have been overwritten
+            CopyTextureAttribs CopyAttribs{Allocator.GetTexture(Handles[pass - 1]), RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                           pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+            pContext->CopyTexture(CopyAttribs);
+            pContext->WaitForIdle();
+
+            MappedTextureSubresource MappedData;
+            pContext->MapTextureSubresource(pStagingTex, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+            ASSERT_NE(MappedData.pData, nullptr);
+            GetClearColor(pass - 1, ClearColor);
+            const auto* pTexel = static_cast<const Uint8*>(MappedData.pData);
+            EXPECT_NEAR(pTexel[0], ClearColor[0] * 255.f, 1.f) << "frame " << frame << ", pass " << pass;
+            EXPECT_EQ(pTexel[3], 255);
+            pContext->UnmapTextureSubresource(pStagingTex, 0, 0);
+        }
+    }
+
+    pContext->WaitForIdle();
+}
+
+} // namespace
@@ -0,0 +1,107 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "CommandQueueVk.h"
+#include "GPUTestingEnvironment.hpp"
+#include "Vulkan/TestBaseVk.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+using CommandQueueVkTest = TestBaseVk;
+
+// Submits empty batches to the immediate context queue from one and several threads and checks
+// that every submission gets its own fence value and that the values increase in submission order.
+TEST_F(CommandQueueVkTest, ConcurrentSubmits)
+{
+    GPUTestingEnvironment::ScopedReset EnvironmentAutoReset;
+
+    RefCntAutoPtr<ICommandQueueVk> pQueueVk{pContext->LockCommandQueue(), IID_CommandQueueVk};
+    ASSERT_NE(pQueueVk, nullptr);
+
+    constexpr Uint32 NumSubmits = 1024;
+
+    // Single thread
+    {
+        const Uint64 FirstFenceValue = pQueueVk->GetNextFenceValue();
+        for (Uint32 i = 0; i < NumSubmits; ++i)
+            EXPECT_EQ(pQueueVk->SubmitCmdBuffer(VK_NULL_HANDLE), FirstFenceValue + i);
+        EXPECT_EQ(pQueueVk->GetNextFenceValue(), FirstFenceValue + NumSubmits);
+    }
+
+    // Multiple threads submitting to the same queue
+    {
+        const Uint32 NumThreads       = std::max(std::min(std::thread::hardware_concurrency(), 8u), 2u);
+        const Uint32 SubmitsPerThread = NumSubmits / NumThreads;
+        const Uint32 TotalSubmits     = SubmitsPerThread * NumThreads;
+
+        const Uint64 FirstFenceValue = pQueueVk->GetNextFenceValue();
+
+        std::vector<std::vector<Uint64>> FenceValues(NumThreads);
+        std::vector<std::thread>         Threads;
+        for (Uint32 t = 0; t < NumThreads; ++t)
+        {
+            Threads.emplace_back([&, t]() {
+                FenceValues[t].reserve(SubmitsPerThread);
+                for (Uint32 i = 0; i < SubmitsPerThread; ++i)
+                    FenceValues[t].push_back(pQueueVk->SubmitCmdBuffer(VK_NULL_HANDLE));
+            });
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        EXPECT_EQ(pQueueVk->GetNextFenceValue(), FirstFenceValue + TotalSubmits);
+
+        std::vector<Uint64> AllValues;
+        for (const auto& ThreadValues : FenceValues)
+        {
+            EXPECT_TRUE(std::is_sorted(ThreadValues.begin(), ThreadValues.end())) << "Fence values of one thread must increase";
+            AllValues.insert(AllValues.end(), ThreadValues.begin(), ThreadValues.end());
+        }
+        std::sort(AllValues.begin(), AllValues.end());
+        ASSERT_EQ(AllValues.size(), size_t{TotalSubmits});
+        for (Uint32 i = 0; i < TotalSubmits; ++i)
+            ASSERT_EQ(AllValues[i], FirstFenceValue + i) << "Every submission must get a unique fence value";
+    }
+
+    const Uint64 IdleFenceValue = pQueueVk->WaitForIdle();
+    EXPECT_GE(pQueueVk->GetCompletedFenceValue(), IdleFenceValue);
+
+    pQueueVk.Release();
+    pContext->UnlockCommandQueue();
+}
+
+} // namespace
@@ -0,0 +1,339 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include "RenderDeviceVk.h"
+#include "DeviceContextVk.h"
+#include "GPUTestingEnvironment.hpp"
+#include "Vulkan/TestBaseVk.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+using DefragmentMemoryVkTest = TestBaseVk;
+
+namespace HLSL
+{
+
+// clang-format off
+const std::string DefragmentMemoryTest_VS{
+R"(
+struct VSOutput
+{
+    float4 Pos   : SV_Position;
+    float  Value : VALUE;
+};
+
+void main(in  float2   Pos   : ATTRIB0,
+          in  float    Value : ATTRIB1,
+          out VSOutput Out)
+{
+    Out.Pos   = float4(Pos, 0.0, 1.0);
+    Out.Value = Value;
+}
+)"
+};
+
+const std::string DefragmentMemoryTest_PS{
+R"(
+float4 main(in float4 Pos   : SV_Position,
+            in float  Value : VALUE) : SV_Target
+{
+    return float4(Value, 0.0, 0.0, 1.0);
+}
+)"
+};
+// clang-format on
+
+} // namespace HLSL
+
+struct Vertex
+{
+    float x, y;
+    float Value;
+};
+
+constexpr Uint32 NumQuadVerts = 6;
+
+// Every buffer starts with a full-screen quad whose vertices hold the buffer index
+// in the Value attribute. The rest of the buffer is filled with the index.
+void InitBufferData(Uint32 BufferIdx, std::vector<Uint32>& Data)
+{
+    std::fill(Data.begin(), Data.end(), BufferIdx);
+
+    const float Value = static_cast<float>(BufferIdx) / 255.f;
+
+    const Vertex Quad[NumQuadVerts] = {
+        {-1, -1, Value}, {-1, +1, Value}, {+1, +1, Value},
+        {-1, -1, Value}, {+1, +1, Value}, {+1, -1, Value} //
+    };
+    static_assert(sizeof(Quad) % sizeof(Uint32) == 0, "Quad size must be a multiple of 4");
+    memcpy(Data.data(), Quad, sizeof(Quad));
+}
+
+struct PageUsage
+{
+    Uint32 NumPages           = 0;
+    Uint32 NumNonEmptyPages   = 0;
+    Uint32 NumEvacuatingPages = 0;
+    Uint64 UsedSize           = 0;
+};
+
+PageUsage GetDeviceLocalPageUsage(IRenderDeviceVk* pDeviceVk)
+{
+    Uint32 NumPages = 0;
+    pDeviceVk->GetMemoryPageStats(NumPages, nullptr);
+    std::vector<MemoryPageStatsVk> PageStats(NumPages);
+    pDeviceVk->GetMemoryPageStats(NumPages, PageStats.data());
+
+    PageUsage Usage;
+    for (Uint32 i = 0; i < NumPages; ++i)
+    {
+        const auto& Page = PageStats[i];
+        EXPECT_LE(Page.UsedSize, Page.Size);
+        EXPECT_LE(Page.MaxFreeBlockSize, Page.Size - Page.UsedSize);
+        if (Page.IsHostVisible)
+            continue;
+
+        ++Usage.NumPages;
+        if (Page.UsedSize != 0)
+            ++Usage.NumNonEmptyPages;
+        if (Page.IsEvacuating)
+            ++Usage.NumEvacuatingPages;
+        Usage.UsedSize += Page.UsedSize;
+    }
+    return Usage;
+}
+
+TEST_F(DefragmentMemoryVkTest, MoveSparseBuffers)
+{
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    // Fill several 16 MB device memory pages and then release three out of
+    // every four buffers to leave the pages sparsely occupied.
+    constexpr Uint32 BufferSize = 256 << 10;
+    constexpr Uint32 NumBuffers = 256;
+
+    std::vector<Uint32> Data(BufferSize / sizeof(Uint32));
+
+    std::vector<RefCntAutoPtr<IBuffer>> Buffers(NumBuffers);
+    for (Uint32 i = 0; i < NumBuffers; ++i)
+    {
+        InitBufferData(i, Data);
+
+        BufferDesc BuffDesc;
+        BuffDesc.Name      = "Defragmentation test buffer";
+        BuffDesc.Usage     = USAGE_DEFAULT;
+        BuffDesc.BindFlags = BIND_VERTEX_BUFFER;
+        BuffDesc.Size      = BufferSize;
+
+        BufferData InitData{Data.data(), BufferSize};
+        pDevice->CreateBuffer(BuffDesc, &InitData, &Buffers[i]);
+        ASSERT_NE(Buffers[i], nullptr);
+    }
+    for (Uint32 i = 0; i < NumBuffers; ++i)
+    {
+        if (i % 4 != 0)
+            Buffers[i].Release();
+    }
+    pContext->Flush();
+    pDevice->IdleGPU();
+    pDevice->ReleaseStaleResources();
+
+    const auto UsageBefore = GetDeviceLocalPageUsage(pDeviceVk);
+
+    DefragmentMemoryAttribsVk Attribs;
+    Attribs.MaxPageOccupancy = 0.5f;
+    Attribs.MaxBytesToMove   = 4 * BufferSize;
+
+    Uint32 TotalMovedBuffers = 0;
+    for (Uint32 frame = 0; frame < 64; ++frame)
+    {
+        DefragmentMemoryStatsVk Stats;
+        pContextVk->DefragmentMemory(Attribs, &Stats);
+        EXPECT_LE(Stats.MovedBytes, std::max(Attribs.MaxBytesToMove, Uint64{BufferSize}));
+        TotalMovedBuffers += Stats.NumMovedBuffers;
+
+        pContext->Flush();
+        pContext->FinishFrame();
+        pDevice->ReleaseStaleResources();
+
+        if (Stats.RemainingBytes == 0)
+            break;
+    }
+    EXPECT_GT(TotalMovedBuffers, 0u);
+
+    pDevice->IdleGPU();
+    pDevice->ReleaseStaleResources();
+
+    // Every kept buffer occupies a quarter of its original page, so the buffers fit into fewer pages.
+    // Evacuated pages must become empty (or be destroyed if the memory manager exceeds its reserve size).
+    const auto UsageAfter = GetDeviceLocalPageUsage(pDeviceVk);
+    EXPECT_LT(UsageAfter.NumNonEmptyPages, UsageBefore.NumNonEmptyPages);
+    EXPECT_EQ(UsageAfter.NumEvacuatingPages, 0u);
+    // Moved buffers may require slightly different amount of memory due to alignment
+    EXPECT_LE(UsageAfter.UsedSize, UsageBefore.UsedSize + TotalMovedBuffers * 256);
+
+    // Draw with every kept buffer into its own texel of the render target. A buffer whose
+    // handle was not updated or whose contents were not copied will not produce the expected value.
+    constexpr Uint32 RTSize = 8;
+    static_assert(RTSize * RTSize == NumBuffers / 4, "Every kept buffer must have its own texel");
+
+    TextureDesc RTDesc;
+    RTDesc.Name      = "Defragmentation test render target";
+    RTDesc.Type      = RESOURCE_DIM_TEX_2D;
+    RTDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    RTDesc.Width     = RTSize;
+    RTDesc.Height    = RTSize;
+    RTDesc.MipLevels = 1;
+    RTDesc.BindFlags = BIND_RENDER_TARGET;
+
+    RefCntAutoPtr<ITexture> pRT;
+    pDevice->CreateTexture(RTDesc, nullptr, &pRT);
+    ASSERT_NE(pRT, nullptr);
+
+    TextureDesc StagingTexDesc    = RTDesc;
+    StagingTexDesc.Name           = "Defragmentation test staging texture";
+    StagingTexDesc.Usage          = USAGE_STAGING;
+    StagingTexDesc.BindFlags      = BIND_NONE;
+    StagingTexDesc.CPUAccessFlags = CPU_ACCESS_READ;
+
+    RefCntAutoPtr<ITexture> pStagingTex;
+    pDevice->CreateTexture(StagingTexDesc, nullptr, &pStagingTex);
+    ASSERT_NE(pStagingTex, nullptr);
+
+    RefCntAutoPtr<IPipelineState> pPSO;
+    {
+        ShaderCreateInfo ShaderCI;
+        ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_HLSL;
+        ShaderCI.ShaderCompiler = pEnv->GetDefaultCompiler(ShaderCI.SourceLanguage);
+        ShaderCI.EntryPoint     = "main";
+
+        RefCntAutoPtr<IShader> pVS;
+        ShaderCI.Desc   = {"Defragmentation test VS", SHADER_TYPE_VERTEX, true};
+        ShaderCI.Source = HLSL::DefragmentMemoryTest_VS.c_str();
+        pDevice->CreateShader(ShaderCI, &pVS);
+        ASSERT_NE(pVS, nullptr);
+
+        RefCntAutoPtr<IShader> pPS;
+        ShaderCI.Desc   = {"Defragmentation test PS", SHADER_TYPE_PIXEL, true};
+        ShaderCI.Source = HLSL::DefragmentMemoryTest_PS.c_str();
+        pDevice->CreateShader(ShaderCI, &pPS);
+        ASSERT_NE(pPS, nullptr);
+
+        GraphicsPipelineStateCreateInfo PSOCreateInfo;
+        PSOCreateInfo.PSODesc.Name = "Defragmentation test PSO";
+
+        auto& GraphicsPipeline                        = PSOCreateInfo.GraphicsPipeline;
+        GraphicsPipeline.NumRenderTargets             = 1;
+        GraphicsPipeline.RTVFormats[0]                = RTDesc.Format;
+        GraphicsPipeline.PrimitiveTopology            = PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        GraphicsPipeline.RasterizerDesc.CullMode      = CULL_MODE_NONE;
+        GraphicsPipeline.DepthStencilDesc.DepthEnable = False;
+
+        const LayoutElement Elements[] = {
+            LayoutElement{0, 0, 2, VT_FLOAT32, False},
+            LayoutElement{1, 0, 1, VT_FLOAT32, False} //
+        };
+        GraphicsPipeline.InputLayout.NumElements    = _countof(Elements);
+        GraphicsPipeline.InputLayout.LayoutElements = Elements;
+
+        PSOCreateInfo.pVS = pVS;
+        PSOCreateInfo.pPS = pPS;
+        pDevice->CreateGraphicsPipelineState(PSOCreateInfo, &pPSO);
+        ASSERT_NE(pPSO, nullptr);
+    }
+
+    ITextureView* pRTV = pRT->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+    pContext->SetRenderTargets(1, &pRTV, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    constexpr float ClearColor[] = {0, 0, 0, 0};
+    pContext->ClearRenderTarget(pRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+    pContext->SetPipelineState(pPSO);
+    for (Uint32 i = 0; i < NumBuffers; i += 4)
+    {
+        const Uint32   Texel = i / 4;
+        const Viewport VP{static_cast<float>(Texel % RTSize), static_cast<float>(Texel / RTSize), 1, 1};
+        pContext->SetViewports(1, &VP, RTSize, RTSize);
+
+        IBuffer* pVB = Buffers[i];
+        pContext->SetVertexBuffers(0, 1, &pVB, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, SET_VERTEX_BUFFERS_FLAG_RESET);
+        pContext->Draw(DrawAttribs{NumQuadVerts, DRAW_FLAG_VERIFY_ALL});
+    }
+
+    CopyTextureAttribs CopyAttribs{pRT, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                   pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+    pContext->CopyTexture(CopyAttribs);
+    pContext->WaitForIdle();
+
+    {
+        MappedTextureSubresource MappedData;
+        pContext->MapTextureSubresource(pStagingTex, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+        for (Uint32 i = 0; i < NumBuffers; i += 4)
+        {
+            const Uint32 Texel  = i / 4;
+            const auto*  pTexel = static_cast<const Uint8*>(MappedData.pData) + MappedData.Stride * (Texel / RTSize) + (Texel % RTSize) * 4;
+            EXPECT_NEAR(pTexel[0], i, 1) << "buffer " << i;
+            EXPECT_EQ(pTexel[3], 255) << "buffer " << i;
+        }
+        pContext->UnmapTextureSubresource(pStagingTex, 0, 0);
+    }
+
+    // Verify that the buffers have kept their contents
+    BufferDesc StagingDesc;
+    StagingDesc.Name           = "Defragmentation test staging buffer";
+    StagingDesc.Usage          = USAGE_STAGING;
+    StagingDesc.CPUAccessFlags = CPU_ACCESS_READ;
+    StagingDesc.Size           = BufferSize;
+
+    RefCntAutoPtr<IBuffer> pStagingBuffer;
+    pDevice->CreateBuffer(StagingDesc, nullptr, &pStagingBuffer);
+    ASSERT_NE(pStagingBuffer, nullptr);
+
+    for (Uint32 i = 0; i < NumBuffers; i += 4)
+    {
+        pContext->CopyBuffer(Buffers[i], 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                             pStagingBuffer, 0, BufferSize, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        pContext->WaitForIdle();
+
+        void* pMappedData = nullptr;
+        pContext->MapBuffer(pStagingBuffer, MAP_READ, MAP_FLAG_DO_NOT_WAIT, pMappedData);
+        ASSERT_NE(pMappedData, nullptr);
+        InitBufferData(i, Data);
+        EXPECT_EQ(memcmp(pMappedData, Data.data(), BufferSize), 0) << "buffer " << i;
+        pContext->UnmapBuffer(pStagingBuffer, MAP_READ);
+    }
+}
+
+} // namespace
@@ -0,0 +1,174 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+#include <vector>
+#include <thread>
+#include <string>
+
+#include "RenderDeviceVk.h"
+#include "GPUTestingEnvironment.hpp"
+#include "Vulkan/TestBaseVk.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+using DescriptorSetAllocatorVkTest = TestBaseVk;
+
+// clang-format off
+const std::string DescriptorSetRecyclingTest_CS{
+R"(
+cbuffer Constants
+{
+    float4 g_Value;
+};
+
+RWTexture2D</*format=rgba8*/ float4> g_Output;
+
+[numthreads(1, 1, 1)]
+void main()
+{
+    g_Output[uint2(0, 0)] = g_Value;
+}
+)"
+};
+// clang-format on
+
+// Creates shader resource bindings from several threads simultaneously, releases them,
+// and checks that the allocator reuses the released descriptor sets.
+TEST_F(DescriptorSetAllocatorVkTest, Recycling)
+{
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    RefCntAutoPtr<IPipelineState> pPSO;
+    {
+        ShaderCreateInfo ShaderCI;
+        ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_HLSL;
+        ShaderCI.ShaderCompiler = pEnv->GetDefaultCompiler(ShaderCI.SourceLanguage);
+        ShaderCI.EntryPoint     = "main";
+        ShaderCI.Desc           = {"Descriptor set recycling test CS", SHADER_TYPE_COMPUTE, true};
+        ShaderCI.Source         = DescriptorSetRecyclingTest_CS.c_str();
+
+        RefCntAutoPtr<IShader> pCS;
+        pDevice->CreateShader(ShaderCI, &pCS);
+        ASSERT_NE(pCS, nullptr);
+
+        ComputePipelineStateCreateInfo PSOCreateInfo;
+        PSOCreateInfo.PSODesc.Name         = "Descriptor set recycling test PSO";
+        PSOCreateInfo.PSODesc.PipelineType = PIPELINE_TYPE_COMPUTE;
+
+        PSOCreateInfo.PSODesc.ResourceLayout.DefaultVariableType = SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE;
+
+        PSOCreateInfo.pCS = pCS;
+        pDevice->CreateComputePipelineState(PSOCreateInfo, &pPSO);
+        ASSERT_NE(pPSO, nullptr);
+    }
+
+    constexpr Uint32 NumThreads       = 4;
+    constexpr Uint32 NumSRBsPerThread = 64;
+    constexpr Uint32 NumSRBs          = NumThreads * NumSRBsPerThread;
+
+    std::vector<RefCntAutoPtr<IShaderResourceBinding>> SRBs(NumSRBs);
+
+    auto CreateSRBs = [&](Uint32 NumThreadsToUse) {
+        std::vector<std::thread> Threads(NumThreadsToUse);
+        for (Uint32 t = 0; t < NumThreadsToUse; ++t)
+        {
+            Threads[t] = std::thread{[&, t]() {
+                for (Uint32 i = t; i < NumSRBs; i += NumThreadsToUse)
+                    pPSO->CreateShaderResourceBinding(&SRBs[i]);
+            }};
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        for (const auto& pSRB : SRBs)
+            EXPECT_NE(pSRB, nullptr);
+    };
+
+    auto ReleaseSRBs = [&]() {
+        std::vector<std::thread> Threads(NumThreads);
+        for (Uint32 t = 0; t < NumThreads; ++t)
+        {
+            Threads[t] = std::thread{[&, t]() {
+                for (Uint32 i = t; i < NumSRBs; i += NumThreads)
+                    SRBs[i].Release();
+            }};
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        // Released sets are recycled once the GPU is done with them
+        pDevice->IdleGPU();
+        pDevice->ReleaseStaleResources();
+    };
+
+    DescriptorSetAllocatorStatsVk Stats0;
+    pDeviceVk->GetDescriptorSetAllocatorStats(Stats0);
+
+    CreateSRBs(NumThreads);
+    DescriptorSetAllocatorStatsVk Stats1;
+    pDeviceVk->GetDescriptorSetAllocatorStats(Stats1);
+    EXPECT_EQ(Stats1.AllocationCount - Stats0.AllocationCount, NumSRBs);
+    EXPECT_EQ((Stats1.RecycledCount - Stats0.RecycledCount) + (Stats1.PoolAllocationCount - Stats0.PoolAllocationCount), NumSRBs);
+    EXPECT_GE(Stats1.PoolScanCount - Stats0.PoolScanCount, Stats1.PoolAllocationCount - Stats0.PoolAllocationCount);
+
+    ReleaseSRBs();
+    DescriptorSetAllocatorStatsVk Stats2;
+    pDeviceVk->GetDescriptorSetAllocatorStats(Stats2);
+    EXPECT_GE(Stats2.CachedSetCount, NumSRBs);
+
+    // Threads may skip free list stripes locked by other threads and allocate from the pools,
+    // but every allocation is served either way.
+    CreateSRBs(NumThreads);
+    DescriptorSetAllocatorStatsVk Stats3;
+    pDeviceVk->GetDescriptorSetAllocatorStats(Stats3);
+    EXPECT_EQ(Stats3.AllocationCount - Stats2.AllocationCount, NumSRBs);
+    EXPECT_GT(Stats3.RecycledCount, Stats2.RecycledCount);
+    EXPECT_EQ((Stats3.RecycledCount - Stats2.RecycledCount) + (Stats3.PoolAllocationCount - Stats2.PoolAllocationCount), NumSRBs);
+
+    ReleaseSRBs();
+    DescriptorSetAllocatorStatsVk Stats4;
+    pDeviceVk->GetDescriptorSetAllocatorStats(Stats4);
+    EXPECT_GE(Stats4.CachedSetCount, NumSRBs);
+
+    // A single thread never skips a stripe, so all sets must be reused
+    CreateSRBs(1);
+    DescriptorSetAllocatorStatsVk Stats5;
+    pDeviceVk->GetDescriptorSetAllocatorStats(Stats5);
+    EXPECT_EQ(Stats5.RecycledCount - Stats4.RecycledCount, NumSRBs);
+    EXPECT_EQ(Stats5.PoolAllocationCount, Stats4.PoolAllocationCount);
+    EXPECT_EQ(Stats5.NewPoolCount, Stats4.NewPoolCount);
+    EXPECT_EQ(Stats4.CachedSetCount - Stats5.CachedSetCount, NumSRBs);
+
+    ReleaseSRBs();
+}
+
+} // namespace
@@ -0,0 +1,272 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+#include <string>
+#include <cstring>
+
+#include "RenderDeviceVk.h"
+#include "GPUTestingEnvironment.hpp"
+#include "Vulkan/TestBaseVk.hpp"
+#include "MapHelper.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+using DynamicHeapVkTest = TestBaseVk;
+
+namespace HLSL
+{
+
+// clang-format off
+const std::string DynamicHeapTest_VS{
+R"(
+void main(in  uint   VertId : SV_VertexID,
+          out float4 Pos    : SV_Position)
+{
+    float2 UV = float2((VertId << 1) & 2, VertId & 2);
+    Pos = float4(UV * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+}
+)"
+};
+
+const std::string DynamicHeapTest_PS{
+R"(
+cbuffer Constants
+{
+    float4 g_Color;
+};
+
+float4 main(in float4 Pos : SV_Position) : SV_Target
+{
+    return g_Color;
+}
+)"
+};
+// clang-format on
+
+} // namespace HLSL
+
+TEST_F(DynamicHeapVkTest, GrowAndShrink)
+{
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    DynamicHeapStatsVk InitialStats;
+    pDeviceVk->GetDynamicHeapStats(InitialStats);
+    ASSERT_GE(InitialStats.BufferCount, 1u);
+    ASSERT_GT(InitialStats.CurrentSize, 0u);
+
+    constexpr Uint64 BufferSize = 64 << 10;
+
+    BufferDesc BuffDesc;
+    BuffDesc.Name           = "Dynamic heap growth test buffer";
+    BuffDesc.Usage          = USAGE_DYNAMIC;
+    BuffDesc.BindFlags      = BIND_UNIFORM_BUFFER;
+    BuffDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
+    BuffDesc.Size           = BufferSize;
+
+    RefCntAutoPtr<IBuffer> pBuffer;
+    pDevice->CreateBuffer(BuffDesc, nullptr, &pBuffer);
+    ASSERT_NE(pBuffer, nullptr);
+
+    // Allocate more dynamic memory in a single frame than the primary buffer can hold
+    const auto NumMaps = static_cast<Uint32>(InitialStats.CurrentSize / BufferSize) + 16;
+    for (Uint32 i = 0; i < NumMaps; ++i)
+    {
+        MapHelper<Uint32> Data{pContext, pBuffer, MAP_WRITE, MAP_FLAG_DISCARD};
+        ASSERT_NE(Data, nullptr);
+        Data[0] = i;
+    }
+
+    DynamicHeapStatsVk GrownStats;
+    pDeviceVk->GetDynamicHeapStats(GrownStats);
+    EXPECT_GT(GrownStats.GrowCount, InitialStats.GrowCount);
+    EXPECT_GT(GrownStats.BufferCount, 1u);
+    EXPECT_GT(GrownStats.CurrentSize, InitialStats.CurrentSize);
+    EXPECT_GE(GrownStats.PeakSize, GrownStats.CurrentSize);
+    EXPECT_GE(GrownStats.PeakUsedSize, NumMaps * BufferSize);
+    EXPECT_GE(GrownStats.PeakBufferCount, GrownStats.BufferCount);
+
+    // The primary buffer is exhausted in this frame, so the constant buffer below is
+    // suballocated from an overflow buffer, and the descriptor set that references the
+    // dynamic buffer must be repointed to it. Draw with two different colors into two
+    // texels and read them back.
+    constexpr Uint32 RTWidth = 2;
+
+    TextureDesc RTDesc;
+    RTDesc.Name      = "Dynamic heap test render target";
+    RTDesc.Type      = RESOURCE_DIM_TEX_2D;
+    RTDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    RTDesc.Width     = RTWidth;
+    RTDesc.Height    = 1;
+    RTDesc.MipLevels = 1;
+    RTDesc.BindFlags = BIND_RENDER_TARGET;
+
+    RefCntAutoPtr<ITexture> pRT;
+    pDevice->CreateTexture(RTDesc, nullptr, &pRT);
+    ASSERT_NE(pRT, nullptr);
+
+    TextureDesc StagingTexDesc    = RTDesc;
+    StagingTexDesc.Name           = "Dynamic heap test staging texture";
+    StagingTexDesc.Usage          = USAGE_STAGING;
+    StagingTexDesc.BindFlags      = BIND_NONE;
+    StagingTexDesc.CPUAccessFlags = CPU_ACCESS_READ;
+
+    RefCntAutoPtr<ITexture> pStagingTex;
+    pDevice->CreateTexture(StagingTexDesc, nullptr, &pStagingTex);
+    ASSERT_NE(pStagingTex, nullptr);
+
+    BufferDesc CBDesc;
+    CBDesc.Name           = "Dynamic heap test constant buffer";
+    CBDesc.Usage          = USAGE_DYNAMIC;
+    CBDesc.BindFlags      = BIND_UNIFORM_BUFFER;
+    CBDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
+    CBDesc.Size           = sizeof(float) * 4;
+
+    RefCntAutoPtr<IBuffer> pCB;
+    pDevice->CreateBuffer(CBDesc, nullptr, &pCB);
+    ASSERT_NE(pCB, nullptr);
+
+    RefCntAutoPtr<IPipelineState> pPSO;
+    {
+        ShaderCreateInfo ShaderCI;
+        ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_HLSL;
+        ShaderCI.ShaderCompiler = pEnv->GetDefaultCompiler(ShaderCI.SourceLanguage);
+        ShaderCI.EntryPoint     = "main";
+
+        RefCntAutoPtr<IShader> pVS;
+        ShaderCI.Desc   = {"Dynamic heap test VS", SHADER_TYPE_VERTEX, true};
+        ShaderCI.Source = HLSL::DynamicHeapTest_VS.c_str();
+        pDevice->CreateShader(ShaderCI, &pVS);
+        ASSERT_NE(pVS, nullptr);
+
+        RefCntAutoPtr<IShader> pPS;
+        ShaderCI.Desc   = {"Dynamic heap test PS", SHADER_TYPE_PIXEL, true};
+        ShaderCI.Source = HLSL::DynamicHeapTest_PS.c_str();
+        pDevice->CreateShader(ShaderCI, &pPS);
+        ASSERT_NE(pPS, nullptr);
+
+        GraphicsPipelineStateCreateInfo PSOCreateInfo;
+        PSOCreateInfo.PSODesc.Name = "Dynamic heap test PSO";
+
+        PSOCreateInfo.PSODesc.ResourceLayout.DefaultVariableType = SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE;
+
+        auto& GraphicsPipeline                        = PSOCreateInfo.GraphicsPipeline;
+        GraphicsPipeline.NumRenderTargets             = 1;
+        GraphicsPipeline.RTVFormats[0]                = RTDesc.Format;
+        GraphicsPipeline.PrimitiveTopology            = PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        GraphicsPipeline.RasterizerDesc.CullMode      = CULL_MODE_NONE;
+        GraphicsPipeline.DepthStencilDesc.DepthEnable = False;
+
+        PSOCreateInfo.pVS = pVS;
+        PSOCreateInfo.pPS = pPS;
+        pDevice->CreateGraphicsPipelineState(PSOCreateInfo, &pPSO);
+        ASSERT_NE(pPSO, nullptr);
+    }
+
+    RefCntAutoPtr<IShaderResourceBinding> pSRB;
+    pPSO->CreateShaderResourceBinding(&pSRB, true);
+    ASSERT_NE(pSRB, nullptr);
+    auto* pConstantsVar = pSRB->GetVariableByName(SHADER_TYPE_PIXEL, "Constants");
+    ASSERT_NE(pConstantsVar, nullptr);
+    pConstantsVar->Set(pCB);
+
+    constexpr float Colors[RTWidth][4] = {
+        {1, 0, 0, 1},
+        {0, 0, 1, 1} //
+    };
+
+    ITextureView* pRTV = pRT->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+    pContext->SetRenderTargets(1, &pRTV, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    constexpr float ClearColor[] = {0, 0, 0, 0};
+    pContext->ClearRenderTarget(pRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+    pContext->SetPipelineState(pPSO);
+    for (Uint32 i = 0; i < RTWidth; ++i)
+    {
+        {
+            MapHelper<float> CBData{pContext, pCB, MAP_WRITE, MAP_FLAG_DISCARD};
+            ASSERT_NE(CBData, nullptr);
+            memcpy(CBData, Colors[i], sizeof(Colors[i]));
+        }
+
+        const Viewport VP{static_cast<float>(i), 0, 1, 1};
+        pContext->SetViewports(1, &VP, RTWidth, 1);
+        pContext->CommitShaderResources(pSRB, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        pContext->Draw(DrawAttribs{3, DRAW_FLAG_VERIFY_ALL});
+    }
+
+    DynamicHeapStatsVk DrawStats;
+    pDeviceVk->GetDynamicHeapStats(DrawStats);
+    EXPECT_GT(DrawStats.BufferCount, 1u) << "Overflow buffers must still be alive in the current frame";
+
+    CopyTextureAttribs CopyAttribs{pRT, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                   pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+    pContext->CopyTexture(CopyAttribs);
+    pContext->WaitForIdle();
+
+    {
+        MappedTextureSubresource MappedData;
+        pContext->MapTextureSubresource(pStagingTex, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+        for (Uint32 i = 0; i < RTWidth; ++i)
+        {
+            const auto* pTexel = static_cast<const Uint8*>(MappedData.pData) + i * 4;
+            for (Uint32 c = 0; c < 4; ++c)
+                EXPECT_EQ(pTexel[c], static_cast<Uint8>(Colors[i][c] * 255.f)) << "texel " << i << ", component " << c;
+        }
+        pContext->UnmapTextureSubresource(pStagingTex, 0, 0);
+    }
+
+    pSRB.Release();
+    pPSO.Release();
+    pCB.Release();
+
+    // Overflow buffers are released after they have not been used for
+    // EngineVkCreateInfo::DynamicHeapShrinkDelay (120 by default) frames.
+    pContext->Flush();
+    pContext->FinishFrame();
+    pDevice->IdleGPU();
+    for (Uint32 frame = 0; frame < 256; ++frame)
+    {
+        pContext->FinishFrame();
+        pDevice->ReleaseStaleResources();
+    }
+
+    DynamicHeapStatsVk ShrunkStats;
+    pDeviceVk->GetDynamicHeapStats(ShrunkStats);
+    EXPECT_GT(ShrunkStats.ShrinkCount, InitialStats.ShrinkCount);
+    EXPECT_EQ(ShrunkStats.BufferCount, 1u);
+    EXPECT_EQ(ShrunkStats.CurrentSize, GrownStats.CurrentSize / GrownStats.BufferCount);
+    EXPECT_EQ(ShrunkStats.PeakSize, GrownStats.PeakSize);
+}
+
+} // namespace
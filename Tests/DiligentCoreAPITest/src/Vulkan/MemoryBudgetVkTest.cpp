@@ -0,0 +1,135 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <vector>
+
+#include "RenderDeviceVk.h"
+#include "GPUTestingEnvironment.hpp"
+#include "Vulkan/TestBaseVk.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+using MemoryBudgetVkTest = TestBaseVk;
+
+std::vector<MemoryHeapBudgetVk> GetMemoryBudget(IRenderDeviceVk* pDeviceVk)
+{
+    Uint32 NumHeaps = 0;
+    pDeviceVk->GetMemoryBudget(NumHeaps, nullptr);
+    std::vector<MemoryHeapBudgetVk> Budgets(NumHeaps);
+    pDeviceVk->GetMemoryBudget(NumHeaps, Budgets.data());
+    EXPECT_EQ(NumHeaps, Budgets.size());
+    return Budgets;
+}
+
+TEST_F(MemoryBudgetVkTest, GetMemoryBudget)
+{
+    const auto Budgets = GetMemoryBudget(pDeviceVk);
+    ASSERT_FALSE(Budgets.empty());
+
+    bool   HasDeviceLocalHeap = false;
+    Uint64 TotalAllocatedSize = 0;
+    for (const auto& Budget : Budgets)
+    {
+        EXPECT_GT(Budget.Size, 0u);
+        EXPECT_LE(Budget.AllocatedSize, Budget.Size);
+        if (!Budget.IsDriverReported)
+        {
+            EXPECT_LE(Budget.Budget, Budget.Size);
+            EXPECT_EQ(Budget.Usage, Budget.AllocatedSize);
+        }
+        HasDeviceLocalHeap = HasDeviceLocalHeap || Budget.IsDeviceLocal;
+        TotalAllocatedSize += Budget.AllocatedSize;
+    }
+    EXPECT_TRUE(HasDeviceLocalHeap);
+    // The testing environment creates resources at start-up
+    EXPECT_GT(TotalAllocatedSize, 0u);
+}
+
+struct MemoryPressureCallbackData
+{
+    Uint32 NumCalls = 0;
+    Uint32 NumHeaps = 0;
+};
+
+void DILIGENT_CALL_TYPE OnMemoryPressure(Uint32 HeapIndex, const MemoryHeapBudgetVk& Budget, void* pUserData)
+{
+    auto* pData = static_cast<MemoryPressureCallbackData*>(pUserData);
+    EXPECT_LT(HeapIndex, pData->NumHeaps);
+    EXPECT_GT(Budget.Usage, 0u);
+    ++pData->NumCalls;
+}
+
+TEST_F(MemoryBudgetVkTest, MemoryPressureCallback)
+{
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    BufferDesc BuffDesc;
+    BuffDesc.Name      = "Memory budget test buffer";
+    BuffDesc.Usage     = USAGE_DEFAULT;
+    BuffDesc.BindFlags = BIND_VERTEX_BUFFER;
+    BuffDesc.Size      = 1 << 20;
+
+    RefCntAutoPtr<IBuffer> pBuffer;
+    pDevice->CreateBuffer(BuffDesc, nullptr, &pBuffer);
+    ASSERT_NE(pBuffer, nullptr);
+
+    MemoryPressureCallbackData CallbackData;
+    CallbackData.NumHeaps = static_cast<Uint32>(GetMemoryBudget(pDeviceVk).size());
+
+    // Use a tiny watermark so that every heap that is in use triggers the callback
+    MemoryPressureCallbackAttribsVk Attribs;
+    Attribs.Callback      = OnMemoryPressure;
+    Attribs.pUserData     = &CallbackData;
+    Attribs.HighWatermark = 1e-6f;
+    Attribs.LowWatermark  = 0;
+    pDeviceVk->SetMemoryPressureCallback(Attribs);
+
+    const Uint32 Data[] = {1, 2, 3, 4};
+    pContext->UpdateBuffer(pBuffer, 0, sizeof(Data), Data, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    pContext->Flush();
+    EXPECT_GT(CallbackData.NumCalls, 0u);
+
+    // The callback must not be invoked again while the usage stays above the low watermark
+    const auto NumCalls = CallbackData.NumCalls;
+    for (Uint32 i = 0; i < 4; ++i)
+    {
+        pContext->UpdateBuffer(pBuffer, 0, sizeof(Data), Data, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        pContext->Flush();
+    }
+    EXPECT_EQ(CallbackData.NumCalls, NumCalls);
+
+    pDeviceVk->SetMemoryPressureCallback(MemoryPressureCallbackAttribsVk{});
+    pContext->WaitForIdle();
+}
+
+} // namespace
@@ -0,0 +1,200 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+#include <vector>
+
+#include "RenderDeviceVk.h"
+#include "GPUTestingEnvironment.hpp"
+#include "Vulkan/TestBaseVk.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+using ObjectCacheVkTest = TestBaseVk;
+
+// Creates render targets of different sizes, so that each one requires its own framebuffer
+void CreateRenderTargets(IRenderDevice* pDevice, Uint32 NumTargets, std::vector<RefCntAutoPtr<ITexture>>& Targets)
+{
+    Targets.resize(NumTargets);
+    for (Uint32 i = 0; i < NumTargets; ++i)
+    {
+        TextureDesc TexDesc;
+        TexDesc.Name      = "Dynamic resolution render target";
+        TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+        TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+        TexDesc.Width     = 16 + (i % 64);
+        TexDesc.Height    = 16 + (i / 64);
+        TexDesc.MipLevels = 1;
+        TexDesc.BindFlags = BIND_RENDER_TARGET;
+
+        pDevice->CreateTexture(TexDesc, nullptr, &Targets[i]);
+        ASSERT_NE(Targets[i], nullptr);
+    }
+}
+
+constexpr float ClearColor[] = {0.25f, 0.5f, 0.75f, 1.f};
+
+// Simulates dynamic resolution scaling: every frame renders into a render target
+// of a different size, so that every frame requires a new framebuffer.
+TEST_F(ObjectCacheVkTest, DynamicResolutionChurn)
+{
+    ObjectCacheStatsVk InitialFBStats;
+    pDeviceVk->GetFramebufferCacheStats(InitialFBStats);
+    if (InitialFBStats.MaxEntries == 0)
+        GTEST_SKIP() << "Framebuffer cache is unbounded";
+
+    ObjectCacheStatsVk InitialRPStats;
+    pDeviceVk->GetImplicitRenderPassCacheStats(InitialRPStats);
+
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    // Render targets are kept alive, so framebuffers can only be released by the eviction.
+    // Only one Vulkan device can exist at a time, so the test uses the limit of the testing
+    // environment's device rather than configuring its own.
+    const Uint32 NumTargets = InitialFBStats.MaxEntries + 64;
+
+    std::vector<RefCntAutoPtr<ITexture>> Targets;
+    CreateRenderTargets(pDevice, NumTargets, Targets);
+    if (HasFatalFailure())
+        return;
+
+    auto RenderFrame = [&](ITexture* pTarget) {
+        ITextureView* pRTV = pTarget->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+
+        pContext->SetRenderTargets(1, &pRTV, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        pContext->ClearRenderTarget(pRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        pContext->Flush();
+        pContext->FinishFrame();
+        pDevice->ReleaseStaleResources();
+    };
+
+    for (Uint32 i = 0; i < NumTargets; ++i)
+        RenderFrame(Targets[i]);
+
+    ObjectCacheStatsVk FBStats;
+    pDeviceVk->GetFramebufferCacheStats(FBStats);
+    EXPECT_GE(FBStats.NumMisses - InitialFBStats.NumMisses, NumTargets);
+    EXPECT_GE(FBStats.NumEvictions - InitialFBStats.NumEvictions, NumTargets - FBStats.MaxEntries);
+    EXPECT_LE(FBStats.NumEntries, FBStats.MaxEntries);
+
+    // All render targets use the same format, so only one render pass is needed
+    ObjectCacheStatsVk RPStats;
+    pDeviceVk->GetImplicitRenderPassCacheStats(RPStats);
+    EXPECT_LE(RPStats.NumMisses - InitialRPStats.NumMisses, 1u);
+    EXPECT_GE(RPStats.NumHits - InitialRPStats.NumHits, NumTargets - 1);
+
+    // Recently used framebuffers must remain in the cache
+    constexpr Uint32 NumRecentTargets = 8;
+    for (Uint32 i = NumTargets - NumRecentTargets; i < NumTargets; ++i)
+        RenderFrame(Targets[i]);
+
+    ObjectCacheStatsVk RecentFBStats;
+    pDeviceVk->GetFramebufferCacheStats(RecentFBStats);
+    EXPECT_EQ(RecentFBStats.NumMisses, FBStats.NumMisses);
+    EXPECT_GE(RecentFBStats.NumHits - FBStats.NumHits, NumRecentTargets);
+
+    // Releasing the render targets must release their framebuffers
+    pContext->SetRenderTargets(0, nullptr, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+    Targets.clear();
+    pDevice->IdleGPU();
+
+    ObjectCacheStatsVk FinalFBStats;
+    pDeviceVk->GetFramebufferCacheStats(FinalFBStats);
+    EXPECT_LE(FinalFBStats.NumEntries, InitialFBStats.NumEntries);
+}
+
+// Render targets that stay bound to one context for many frames must not be evicted
+// while another context churns through new framebuffers.
+TEST_F(ObjectCacheVkTest, BoundFramebufferIsNotEvicted)
+{
+    IDeviceContext* pChurnCtx = nullptr;
+    for (size_t i = 1; i < pEnv->GetNumImmediateContexts(); ++i)
+    {
+        auto* pCtx = pEnv->GetDeviceContext(i);
+        if ((pCtx->GetDesc().QueueType & COMMAND_QUEUE_TYPE_GRAPHICS) == COMMAND_QUEUE_TYPE_GRAPHICS)
+        {
+            pChurnCtx = pCtx;
+            break;
+        }
+    }
+    if (pChurnCtx == nullptr)
+        GTEST_SKIP() << "This test requires a second graphics context";
+
+    auto* pBoundCtx = pEnv->GetDeviceContext();
+
+    ObjectCacheStatsVk InitialFBStats;
+    pDeviceVk->GetFramebufferCacheStats(InitialFBStats);
+    if (InitialFBStats.MaxEntries == 0)
+        GTEST_SKIP() << "Framebuffer cache is unbounded";
+
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    const Uint32 NumTargets = InitialFBStats.MaxEntries + 64;
+
+    std::vector<RefCntAutoPtr<ITexture>> Targets;
+    CreateRenderTargets(pDevice, NumTargets + 1, Targets);
+    if (HasFatalFailure())
+        return;
+
+    // The render target is bound once and only cleared afterwards, so the context never
+    // calls SetRenderTargets() again and begins the render pass with the cached framebuffer.
+    ITextureView* pBoundRTV = Targets[NumTargets]->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+    pBoundCtx->SetRenderTargets(1, &pBoundRTV, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    for (Uint32 i = 0; i < NumTargets; ++i)
+    {
+        ITextureView* pRTV = Targets[i]->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+        pChurnCtx->SetRenderTargets(1, &pRTV, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        pChurnCtx->ClearRenderTarget(pRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        pChurnCtx->Flush();
+        pChurnCtx->FinishFrame();
+
+        pBoundCtx->ClearRenderTarget(pBoundRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        pBoundCtx->Flush();
+        pBoundCtx->FinishFrame();
+
+        pDevice->ReleaseStaleResources();
+    }
+
+    // Every churned render target misses once. The bound framebuffer is looked up every time
+    // its render pass is begun, so it stays in the cache and is never created again.
+    ObjectCacheStatsVk FBStats;
+    pDeviceVk->GetFramebufferCacheStats(FBStats);
+    EXPECT_EQ(FBStats.NumMisses - InitialFBStats.NumMisses, NumTargets + 1);
+    EXPECT_GT(FBStats.NumEvictions, InitialFBStats.NumEvictions);
+
+    pBoundCtx->SetRenderTargets(0, nullptr, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+    pChurnCtx->SetRenderTargets(0, nullptr, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+    Targets.clear();
+    pDevice->IdleGPU();
+}
+
+} // namespace
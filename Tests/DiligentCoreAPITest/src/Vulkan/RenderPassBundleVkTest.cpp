@@ -0,0 +1,429 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "DeviceContextVk.h"
+#include "GPUTestingEnvironment.hpp"
+#include "Vulkan/TestBaseVk.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+using RenderPassBundleVkTest = TestBaseVk;
+
+namespace HLSL
+{
+
+// clang-format off
+const std::string RenderPassBundleTest_VS{
+R"(
+float4 main(in float2 Pos : ATTRIB0) : SV_Position
+{
+    return float4(Pos, 0.0, 1.0);
+}
+)"
+};
+
+const std::string RenderPassBundleTest_PS{
+R"(
+cbuffer Constants
+{
+    float4 g_Color;
+};
+
+float4 main(in float4 Pos : SV_Position) : SV_Target
+{
+    return g_Color;
+}
+)"
+};
+// clang-format on
+
+} // namespace HLSL
+
+constexpr Uint32 RTSize = 128;
+
+struct RenderPassBundleTestResources
+{
+    RefCntAutoPtr<ITexture>     pTex;
+    RefCntAutoPtr<ITexture>     pStagingTex;
+    RefCntAutoPtr<IRenderPass>  pRenderPass;
+    RefCntAutoPtr<IFramebuffer> pFramebuffer;
+
+    ITextureView* pRTV = nullptr;
+};
+
+void CreateRenderPassBundleTestResources(IRenderDevice* pDevice, RenderPassBundleTestResources& Res)
+{
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Render pass bundle test texture";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.Width     = RTSize;
+    TexDesc.Height    = RTSize;
+    TexDesc.MipLevels = 1;
+    TexDesc.BindFlags = BIND_RENDER_TARGET;
+
+    pDevice->CreateTexture(TexDesc, nullptr, &Res.pTex);
+    ASSERT_NE(Res.pTex, nullptr);
+
+    TextureDesc StagingDesc    = TexDesc;
+    StagingDesc.Name           = "Render pass bundle test staging texture";
+    StagingDesc.Usage          = USAGE_STAGING;
+    StagingDesc.BindFlags      = BIND_NONE;
+    StagingDesc.CPUAccessFlags = CPU_ACCESS_READ;
+
+    pDevice->CreateTexture(StagingDesc, nullptr, &Res.pStagingTex);
+    ASSERT_NE(Res.pStagingTex, nullptr);
+
+    RenderPassAttachmentDesc Attachments[1];
+    Attachments[0].Format       = TexDesc.Format;
+    Attachments[0].InitialState = RESOURCE_STATE_RENDER_TARGET;
+    Attachments[0].FinalState   = RESOURCE_STATE_COPY_SOURCE;
+    Attachments[0].LoadOp       = ATTACHMENT_LOAD_OP_CLEAR;
+    Attachments[0].StoreOp      = ATTACHMENT_STORE_OP_STORE;
+
+    constexpr AttachmentReference RTAttachmentRef{0, RESOURCE_STATE_RENDER_TARGET};
+
+    SubpassDesc Subpass;
+    Subpass.RenderTargetAttachmentCount = 1;
+    Subpass.pRenderTargetAttachments    = &RTAttachmentRef;
+
+    RenderPassDesc RPDesc;
+    RPDesc.Name            = "Render pass bundle test render pass";
+    RPDesc.AttachmentCount = _countof(Attachments);
+    RPDesc.pAttachments    = Attachments;
+    RPDesc.SubpassCount    = 1;
+    RPDesc.pSubpasses      = &Subpass;
+
+    pDevice->CreateRenderPass(RPDesc, &Res.pRenderPass);
+    ASSERT_NE(Res.pRenderPass, nullptr);
+
+    Res.pRTV = Res.pTex->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+
+    FramebufferDesc FBDesc;
+    FBDesc.Name            = "Render pass bundle test framebuffer";
+    FBDesc.pRenderPass     = Res.pRenderPass;
+    FBDesc.AttachmentCount = 1;
+    FBDesc.ppAttachments   = &Res.pRTV;
+
+    pDevice->CreateFramebuffer(FBDesc, &Res.pFramebuffer);
+    ASSERT_NE(Res.pFramebuffer, nullptr);
+}
+
+// Executes the bundles in a render pass that clears the render target to ClearColor, and reads the result back
+void ExecuteBundles(IDeviceContextVk*                         pContextVk,
+                    RenderPassBundleTestResources&            Res,
+                    std::vector<RefCntAutoPtr<ICommandList>>& Bundles,
+                    const float                               ClearColor[],
+                    MappedTextureSubresource&                 MappedData)
+{
+    OptimizedClearValue ClearValue;
+    for (Uint32 i = 0; i < 4; ++i)
+        ClearValue.Color[i] = ClearColor[i];
+
+    BeginRenderPassAttribs BeginInfo;
+    BeginInfo.pRenderPass         = Res.pRenderPass;
+    BeginInfo.pFramebuffer        = Res.pFramebuffer;
+    BeginInfo.ClearValueCount     = 1;
+    BeginInfo.pClearValues        = &ClearValue;
+    BeginInfo.StateTransitionMode = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+    pContextVk->BeginRenderPassWithBundles(BeginInfo);
+
+    // Execute the first bundle separately to check that several calls in one subpass are allowed
+    std::vector<ICommandList*> ppBundles;
+    for (auto& pBundle : Bundles)
+        ppBundles.push_back(pBundle);
+    pContextVk->ExecuteRenderPassBundles(1, ppBundles.data());
+    pContextVk->ExecuteRenderPassBundles(static_cast<Uint32>(ppBundles.size() - 1), ppBundles.data() + 1);
+    pContextVk->EndRenderPass();
+    EXPECT_EQ(Res.pTex->GetState(), RESOURCE_STATE_COPY_SOURCE);
+
+    CopyTextureAttribs CopyAttribs{Res.pTex, RESOURCE_STATE_TRANSITION_MODE_VERIFY,
+                                   Res.pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+    pContextVk->CopyTexture(CopyAttribs);
+    pContextVk->WaitForIdle();
+
+    pContextVk->MapTextureSubresource(Res.pStagingTex, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+}
+
+const Uint8* GetTexel(const MappedTextureSubresource& MappedData, Uint32 x, Uint32 y)
+{
+    return static_cast<const Uint8*>(MappedData.pData) + MappedData.Stride * y + x * 4;
+}
+
+void CheckTexel(const MappedTextureSubresource& MappedData, Uint32 x, Uint32 y, const float Color[], Uint32 Frame)
+{
+    const auto* pTexel = GetTexel(MappedData, x, y);
+    EXPECT_NEAR(pTexel[0], Color[0] * 255.f, 1.f) << "frame " << Frame << ", x=" << x << ", y=" << y;
+    EXPECT_NEAR(pTexel[1], Color[1] * 255.f, 1.f) << "frame " << Frame << ", x=" << x << ", y=" << y;
+    EXPECT_NEAR(pTexel[2], Color[2] * 255.f, 1.f) << "frame " << Frame << ", x=" << x << ", y=" << y;
+    EXPECT_NEAR(pTexel[3], Color[3] * 255.f, 1.f) << "frame " << Frame << ", x=" << x << ", y=" << y;
+}
+
+TEST_F(RenderPassBundleVkTest, ExecuteInOrder)
+{
+    if (pEnv->GetNumDeferredContexts() == 0)
+        GTEST_SKIP() << "Deferred contexts are not supported by this device";
+
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    RenderPassBundleTestResources Res;
+    CreateRenderPassBundleTestResources(pDevice, Res);
+    if (HasFatalFailure())
+        return;
+
+    // Record more bundles than there are deferred contexts so that the order is
+    // meaningful even when only one deferred context is available.
+    const auto NumDeferredCtxs = static_cast<Uint32>(pEnv->GetNumDeferredContexts());
+    const auto NumBundles      = std::max(NumDeferredCtxs, Uint32{3});
+
+    std::vector<float> BundleColors(NumBundles * 4);
+    for (Uint32 i = 0; i < NumBundles; ++i)
+    {
+        BundleColors[i * 4 + 0] = static_cast<float>(i + 1) / static_cast<float>(NumBundles);
+        BundleColors[i * 4 + 1] = 0.25f;
+        BundleColors[i * 4 + 2] = static_cast<float>(NumBundles - i) / static_cast<float>(NumBundles);
+        BundleColors[i * 4 + 3] = 1.f;
+    }
+
+    constexpr float ClearColor[] = {0, 0, 0, 1};
+    for (Uint32 frame = 0; frame < 2; ++frame)
+    {
+        std::vector<RefCntAutoPtr<ICommandList>> Bundles(NumBundles);
+        for (Uint32 i = 0; i < NumBundles; ++i)
+        {
+            RefCntAutoPtr<IDeviceContextVk> pDeferredCtxVk{pEnv->GetDeferredContext(i % NumDeferredCtxs), IID_DeviceContextVk};
+            ASSERT_NE(pDeferredCtxVk, nullptr);
+
+            RenderPassBundleAttribsVk BundleAttribs;
+            BundleAttribs.pRenderPass  = Res.pRenderPass;
+            BundleAttribs.pFramebuffer = Res.pFramebuffer;
+            pDeferredCtxVk->BeginRenderPassBundle(BundleAttribs);
+            pDeferredCtxVk->ClearRenderTarget(Res.pRTV, &BundleColors[i * 4], RESOURCE_STATE_TRANSITION_MODE_NONE);
+            pDeferredCtxVk->FinishCommandList(&Bundles[i]);
+            ASSERT_NE(Bundles[i], nullptr);
+        }
+
+        MappedTextureSubresource MappedData;
+        ExecuteBundles(pContextVk, Res, Bundles, ClearColor, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+
+        // Every bundle clears the whole render target, so the one executed last must win
+        CheckTexel(MappedData, 0, 0, &BundleColors[(NumBundles - 1) * 4], frame);
+        CheckTexel(MappedData, RTSize - 1, RTSize - 1, &BundleColors[(NumBundles - 1) * 4], frame);
+        pContextVk->UnmapTextureSubresource(Res.pStagingTex, 0, 0);
+
+        for (Uint32 i = 0; i < NumDeferredCtxs; ++i)
+            pEnv->GetDeferredContext(i)->FinishFrame();
+    }
+}
+
+TEST_F(RenderPassBundleVkTest, Draw)
+{
+    if (pEnv->GetNumDeferredContexts() == 0)
+        GTEST_SKIP() << "Deferred contexts are not supported by this device";
+
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    RenderPassBundleTestResources Res;
+    CreateRenderPassBundleTestResources(pDevice, Res);
+    if (HasFatalFailure())
+        return;
+
+    RefCntAutoPtr<IPipelineState> pPSO;
+    {
+        ShaderCreateInfo ShaderCI;
+        ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_HLSL;
+        ShaderCI.ShaderCompiler = pEnv->GetDefaultCompiler(ShaderCI.SourceLanguage);
+        ShaderCI.EntryPoint     = "main";
+
+        RefCntAutoPtr<IShader> pVS;
+        ShaderCI.Desc   = {"Render pass bundle test VS", SHADER_TYPE_VERTEX, true};
+        ShaderCI.Source = HLSL::RenderPassBundleTest_VS.c_str();
+        pDevice->CreateShader(ShaderCI, &pVS);
+        ASSERT_NE(pVS, nullptr);
+
+        RefCntAutoPtr<IShader> pPS;
+        ShaderCI.Desc   = {"Render pass bundle test PS", SHADER_TYPE_PIXEL, true};
+        ShaderCI.Source = HLSL::RenderPassBundleTest_PS.c_str();
+        pDevice->CreateShader(ShaderCI, &pPS);
+        ASSERT_NE(pPS, nullptr);
+
+        GraphicsPipelineStateCreateInfo PSOCreateInfo;
+        PSOCreateInfo.PSODesc.Name = "Render pass bundle test PSO";
+
+        PSOCreateInfo.PSODesc.ResourceLayout.DefaultVariableType = SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE;
+
+        auto& GraphicsPipeline                        = PSOCreateInfo.GraphicsPipeline;
+        GraphicsPipeline.pRenderPass                  = Res.pRenderPass;
+        GraphicsPipeline.SubpassIndex                 = 0;
+        GraphicsPipeline.PrimitiveTopology            = PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        GraphicsPipeline.RasterizerDesc.CullMode      = CULL_MODE_NONE;
+        GraphicsPipeline.RasterizerDesc.ScissorEnable = True;
+        GraphicsPipeline.DepthStencilDesc.DepthEnable = False;
+
+        const LayoutElement Elements[] = {LayoutElement{0, 0, 2, VT_FLOAT32, False}};
+        GraphicsPipeline.InputLayout.NumElements    = _countof(Elements);
+        GraphicsPipeline.InputLayout.LayoutElements = Elements;
+
+        PSOCreateInfo.pVS = pVS;
+        PSOCreateInfo.pPS = pPS;
+        pDevice->CreateGraphicsPipelineState(PSOCreateInfo, &pPSO);
+        ASSERT_NE(pPSO, nullptr);
+    }
+
+    RefCntAutoPtr<IBuffer> pVB;
+    {
+        // Full-screen quad
+        constexpr float Verts[] = {
+            -1, -1, -1, +1, +1, +1,
+            -1, -1, +1, +1, +1, -1, //
+        };
+
+        BufferDesc BuffDesc;
+        BuffDesc.Name      = "Render pass bundle test vertex buffer";
+        BuffDesc.Usage     = USAGE_IMMUTABLE;
+        BuffDesc.BindFlags = BIND_VERTEX_BUFFER;
+        BuffDesc.Size      = sizeof(Verts);
+
+        BufferData InitData{Verts, sizeof(Verts)};
+        pDevice->CreateBuffer(BuffDesc, &InitData, &pVB);
+        ASSERT_NE(pVB, nullptr);
+    }
+
+    constexpr float ClearColor[]       = {0, 0, 0, 1};
+    constexpr float BundleColors[2][4] = {
+        {1, 0, 0, 1},
+        {0, 0, 1, 1},
+    };
+
+    RefCntAutoPtr<IShaderResourceBinding> pSRBs[2];
+    for (Uint32 i = 0; i < 2; ++i)
+    {
+        BufferDesc BuffDesc;
+        BuffDesc.Name      = "Render pass bundle test constant buffer";
+        BuffDesc.Usage     = USAGE_IMMUTABLE;
+        BuffDesc.BindFlags = BIND_UNIFORM_BUFFER;
+        BuffDesc.Size      = sizeof(BundleColors[i]);
+
+        RefCntAutoPtr<IBuffer> pCB;
+        BufferData             InitData{BundleColors[i], sizeof(BundleColors[i])};
+        pDevice->CreateBuffer(BuffDesc, &InitData, &pCB);
+        ASSERT_NE(pCB, nullptr);
+
+        StateTransitionDesc Barrier{pCB, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_CONSTANT_BUFFER, STATE_TRANSITION_FLAG_UPDATE_STATE};
+        pContext->TransitionResourceStates(1, &Barrier);
+
+        pPSO->CreateShaderResourceBinding(&pSRBs[i], true);
+        ASSERT_NE(pSRBs[i], nullptr);
+        pSRBs[i]->GetVariableByName(SHADER_TYPE_PIXEL, "Constants")->Set(pCB);
+    }
+
+    {
+        StateTransitionDesc Barrier{pVB, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_VERTEX_BUFFER, STATE_TRANSITION_FLAG_UPDATE_STATE};
+        pContext->TransitionResourceStates(1, &Barrier);
+    }
+
+    // Dynamic states of the immediate context must not leak into the bundles
+    {
+        const Viewport VP{0, 0, 1, 1, 0, 1};
+        pContext->SetViewports(1, &VP, RTSize, RTSize);
+        const Rect Scissor{0, 0, 1, 1};
+        pContext->SetScissorRects(1, &Scissor, RTSize, RTSize);
+    }
+
+    RefCntAutoPtr<IDeviceContextVk> pDeferredCtxVk{pEnv->GetDeferredContext(0), IID_DeviceContextVk};
+    ASSERT_NE(pDeferredCtxVk, nullptr);
+
+    for (Uint32 frame = 0; frame < 2; ++frame)
+    {
+        std::vector<RefCntAutoPtr<ICommandList>> Bundles(2);
+
+        RenderPassBundleAttribsVk BundleAttribs;
+        BundleAttribs.pRenderPass  = Res.pRenderPass;
+        BundleAttribs.pFramebuffer = Res.pFramebuffer;
+
+        IBuffer* ppVBs[] = {pVB};
+
+        // The first bundle draws into the left half with the default viewport.
+        // The scissor rect is set before the PSO, so it must be committed by SetPipelineState().
+        {
+            pDeferredCtxVk->BeginRenderPassBundle(BundleAttribs);
+            const Rect Scissor{0, 0, RTSize / 2, RTSize};
+            pDeferredCtxVk->SetScissorRects(1, &Scissor, RTSize, RTSize);
+            pDeferredCtxVk->SetPipelineState(pPSO);
+            pDeferredCtxVk->CommitShaderResources(pSRBs[0], RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+            pDeferredCtxVk->SetVertexBuffers(0, 1, ppVBs, nullptr, RESOURCE_STATE_TRANSITION_MODE_VERIFY, SET_VERTEX_BUFFERS_FLAG_RESET);
+            pDeferredCtxVk->Draw(DrawAttribs{6, DRAW_FLAG_VERIFY_ALL});
+            pDeferredCtxVk->FinishCommandList(&Bundles[0]);
+            ASSERT_NE(Bundles[0], nullptr);
+        }
+
+        // The second bundle is recorded by the same deferred context and draws into the top-right
+        // quadrant using an explicit viewport. The scissor rect is set after the PSO.
+        {
+            pDeferredCtxVk->BeginRenderPassBundle(BundleAttribs);
+            pDeferredCtxVk->SetPipelineState(pPSO);
+            const Viewport VP{RTSize / 2, 0, RTSize / 2, RTSize / 2, 0, 1};
+            pDeferredCtxVk->SetViewports(1, &VP, RTSize, RTSize);
+            const Rect Scissor{RTSize / 2, 0, RTSize, RTSize};
+            pDeferredCtxVk->SetScissorRects(1, &Scissor, RTSize, RTSize);
+            pDeferredCtxVk->CommitShaderResources(pSRBs[1], RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+            pDeferredCtxVk->SetVertexBuffers(0, 1, ppVBs, nullptr, RESOURCE_STATE_TRANSITION_MODE_VERIFY, SET_VERTEX_BUFFERS_FLAG_RESET);
+            pDeferredCtxVk->Draw(DrawAttribs{6, DRAW_FLAG_VERIFY_ALL});
+            pDeferredCtxVk->FinishCommandList(&Bundles[1]);
+            ASSERT_NE(Bundles[1], nullptr);
+        }
+
+        MappedTextureSubresource MappedData;
+        ExecuteBundles(pContextVk, Res, Bundles, ClearColor, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+
+        constexpr Uint32 Q = RTSize / 4;
+        // Left half
+        CheckTexel(MappedData, Q, Q, BundleColors[0], frame);
+        CheckTexel(MappedData, Q, Q * 3, BundleColors[0], frame);
+        // Top-right quadrant
+        CheckTexel(MappedData, Q * 3, Q, BundleColors[1], frame);
+        // Bottom-right quadrant is outside of the second bundle's viewport
+        CheckTexel(MappedData, Q * 3, Q * 3, ClearColor, frame);
+        pContextVk->UnmapTextureSubresource(Res.pStagingTex, 0, 0);
+
+        pDeferredCtxVk->FinishFrame();
+    }
+}
+
+} // namespace
@@ -0,0 +1,172 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "DeviceContextVk.h"
+#include "GPUTestingEnvironment.hpp"
+#include "Vulkan/TestBaseVk.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+using SubmitBatchingVkTest = TestBaseVk;
+
+TEST_F(SubmitBatchingVkTest, BatchedFlushes)
+{
+    GPUTestingEnvironment::ScopedReleaseResources AutoreleaseResources;
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "Submit batching test texture";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.Width     = 64;
+    TexDesc.Height    = 64;
+    TexDesc.MipLevels = 1;
+    TexDesc.BindFlags = BIND_RENDER_TARGET;
+
+    RefCntAutoPtr<ITexture> pTex;
+    pDevice->CreateTexture(TexDesc, nullptr, &pTex);
+    ASSERT_NE(pTex, nullptr);
+
+    TextureDesc StagingDesc    = TexDesc;
+    StagingDesc.Name           = "Submit batching test staging texture";
+    StagingDesc.Usage          = USAGE_STAGING;
+    StagingDesc.BindFlags      = BIND_NONE;
+    StagingDesc.CPUAccessFlags = CPU_ACCESS_READ;
+
+    RefCntAutoPtr<ITexture> pStagingTex;
+    pDevice->CreateTexture(StagingDesc, nullptr, &pStagingTex);
+    ASSERT_NE(pStagingTex, nullptr);
+
+    FenceDesc FenceCI;
+    FenceCI.Name = "Submit batching test fence";
+    FenceCI.Type = FENCE_TYPE_CPU_WAIT_ONLY;
+
+    RefCntAutoPtr<IFence> pFence;
+    pDevice->CreateFence(FenceCI, &pFence);
+    ASSERT_NE(pFence, nullptr);
+
+    ITextureView* pRTV = pTex->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+
+    constexpr Uint32 NumFlushes = 4;
+
+    const float Colors[NumFlushes][4] = {
+        {1.00f, 0.00f, 0.00f, 1.f},
+        {0.00f, 1.00f, 0.00f, 1.f},
+        {0.00f, 0.00f, 1.00f, 1.f},
+        {0.50f, 0.25f, 0.75f, 1.f},
+    };
+
+    // Every flush clears the texture with its own color, and the last flush copies the
+    // texture to the staging texture. Batched flushes must be executed in order.
+    auto RecordFlushes = [&](bool Reverse) {
+        for (Uint32 i = 0; i < NumFlushes; ++i)
+        {
+            const auto& Color = Colors[Reverse ? NumFlushes - 1 - i : i];
+            pContext->SetRenderTargets(1, &pRTV, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+            pContext->ClearRenderTarget(pRTV, Color, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+            if (i + 1 < NumFlushes)
+                pContext->Flush();
+        }
+        pContext->SetRenderTargets(0, nullptr, nullptr, RESOURCE_STATE_TRANSITION_MODE_NONE);
+        CopyTextureAttribs CopyAttribs{pTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                                       pStagingTex, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+        pContext->CopyTexture(CopyAttribs);
+    };
+
+    auto VerifyColor = [&](const float* ExpectedColor, const char* Frame) {
+        MappedTextureSubresource MappedData;
+        pContext->MapTextureSubresource(pStagingTex, 0, 0, MAP_READ, MAP_FLAG_DO_NOT_WAIT, nullptr, MappedData);
+        ASSERT_NE(MappedData.pData, nullptr);
+        const auto* pTexel = static_cast<const Uint8*>(MappedData.pData);
+        EXPECT_NEAR(pTexel[0], ExpectedColor[0] * 255.f, 1.f) << Frame;
+        EXPECT_NEAR(pTexel[1], ExpectedColor[1] * 255.f, 1.f) << Frame;
+        EXPECT_NEAR(pTexel[2], ExpectedColor[2] * 255.f, 1.f) << Frame;
+        pContext->UnmapTextureSubresource(pStagingTex, 0, 0);
+    };
+
+    // Start a new frame so that submissions made while creating the resources are not counted
+    pContext->Flush();
+    pContext->FinishFrame();
+
+    pContextVk->EnableSubmitBatching(true);
+
+    // Frame 0: the flush that signals the fence submits all batched flushes
+    {
+        RecordFlushes(false);
+        pContext->EnqueueSignal(pFence, 1);
+        pContext->Flush();
+        pFence->Wait(1);
+        VerifyColor(Colors[NumFlushes - 1], "frame 0");
+        pContext->FinishFrame();
+
+        const auto& Stats = pContextVk->GetSubmitStats();
+        EXPECT_EQ(Stats.NumFlushes, NumFlushes);
+        EXPECT_EQ(Stats.NumBatchedFlushes, NumFlushes - 1);
+        EXPECT_EQ(Stats.NumSubmits, 1u);
+    }
+
+    // Frame 1: batched flushes are submitted when the frame is finished
+    {
+        RecordFlushes(true);
+        pContext->Flush();
+        pContext->FinishFrame();
+
+        const auto& Stats = pContextVk->GetSubmitStats();
+        EXPECT_EQ(Stats.NumFlushes, NumFlushes);
+        EXPECT_EQ(Stats.NumBatchedFlushes, NumFlushes);
+        EXPECT_EQ(Stats.NumSubmits, 1u);
+
+        pContext->WaitForIdle();
+        VerifyColor(Colors[0], "frame 1");
+    }
+
+    pContextVk->EnableSubmitBatching(false);
+    pContext->Flush();
+    pContext->FinishFrame();
+
+    // Without batching, every flush is submitted separately
+    {
+        RecordFlushes(false);
+        pContext->Flush();
+        pContext->FinishFrame();
+
+        const auto& Stats = pContextVk->GetSubmitStats();
+        EXPECT_EQ(Stats.NumFlushes, NumFlushes);
+        EXPECT_EQ(Stats.NumBatchedFlushes, 0u);
+        EXPECT_EQ(Stats.NumSubmits, NumFlushes);
+
+        pContext->WaitForIdle();
+        VerifyColor(Colors[NumFlushes - 1], "frame 2");
+    }
+}
+
+} // namespace
@@ -0,0 +1 @@
+#define COLOR float4(0.0, 1.0, 0.0, 1.0)
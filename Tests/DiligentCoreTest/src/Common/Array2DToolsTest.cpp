@@ -27,10 +27,15 @@
 #include "Array2DTools.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
 
 #include "gtest/gtest.h"
 
 #include "FastRand.hpp"
+#include "ThreadPool.hpp"
+#include "Errors.hpp"
 
 using namespace Diligent;
 
@@ -111,4 +116,227 @@ TEST(Common_Array2DTools, GetArray2DMinMaxValue)
     }
 }
 
+std::vector<float> GenerateArray2D(Uint32 Width, Uint32 Height, size_t Stride, unsigned int Seed = 0)
+{
+    FastRandFloat      Rnd{Seed, -100, +100};
+    std::vector<float> Data(Stride * Height);
+    for (auto& Val : Data)
+        Val = Rnd();
+    return Data;
+}
+
+TEST(Common_Array2DTools, GetArray2DMinMaxValue_ThreadPool)
+{
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    for (Uint32 test = 0; test < 8; ++test)
+    {
+        const Uint32 Width  = 500 + test * 123;
+        const Uint32 Height = 700 + test * 311;
+        const size_t Stride = Width + test;
+
+        auto Data = GenerateArray2D(Width, Height, Stride, test);
+        // Place extreme values in different bands
+        Data[(test * 7919) % Width + (Height - 1 - test) * Stride] = -1000.f;
+        Data[(test * 104729) % Width + (Height / 2 + test) * Stride] = +1000.f;
+
+        float RefMin, RefMax;
+        GetArray2DMinMaxValue(Data.data(), Stride, Width, Height, RefMin, RefMax);
+        EXPECT_EQ(RefMin, -1000.f);
+        EXPECT_EQ(RefMax, +1000.f);
+
+        for (auto* pPool : {static_cast<IThreadPool*>(nullptr), pThreadPool.RawPtr()})
+        {
+            float Min = 0, Max = 0;
+            GetArray2DMinMaxValue(Data.data(), Stride, Width, Height, Min, Max, pPool);
+            EXPECT_EQ(Min, RefMin);
+            EXPECT_EQ(Max, RefMax);
+        }
+    }
+}
+
+TEST(Common_Array2DTools, GetArray2DSum)
+{
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    EXPECT_EQ(GetArray2DSum(nullptr, 0, 0, 0), 0.0);
+
+    for (Uint32 test = 0; test < 64; ++test)
+    {
+        const Uint32 Width  = 1 + test * 37;
+        const Uint32 Height = 1 + (test * 53) % 1500;
+        const size_t Stride = Width + test % 5;
+
+        const auto Data = GenerateArray2D(Width, Height, Stride, test);
+
+        double RefSum = 0;
+        double AbsSum = 0;
+        for (size_t row = 0; row < Height; ++row)
+        {
+            for (size_t col = 0; col < Width; ++col)
+            {
+                RefSum += Data[col + row * Stride];
+                AbsSum += std::abs(Data[col + row * Stride]);
+            }
+        }
+
+        const auto Sum = GetArray2DSum(Data.data(), Stride, Width, Height);
+        EXPECT_NEAR(Sum, RefSum, AbsSum * 1e-6);
+        // The result must not depend on the thread pool
+        EXPECT_EQ(GetArray2DSum(Data.data(), Stride, Width, Height, pThreadPool), Sum);
+    }
+}
+
+TEST(Common_Array2DTools, ComputeArray2DHistogram)
+{
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    constexpr Uint32 Width  = 1031;
+    constexpr Uint32 Height = 997;
+    constexpr size_t Stride = Width + 3;
+
+    auto Data = GenerateArray2D(Width, Height, Stride);
+    Data[10]  = std::numeric_limits<float>::quiet_NaN();
+    Data[20]  = std::numeric_limits<float>::infinity();
+    Data[30]  = -std::numeric_limits<float>::infinity();
+
+    for (Uint32 NumBins : {1u, 7u, 256u})
+    {
+        // Range is smaller than the data range to test clamping
+        constexpr float MinValue = -50;
+        constexpr float MaxValue = +75;
+
+        std::vector<Uint64> RefBins(NumBins);
+        for (size_t row = 0; row < Height; ++row)
+        {
+            for (size_t col = 0; col < Width; ++col)
+            {
+                const auto Val = Data[col + row * Stride];
+                if (std::isnan(Val))
+                    continue;
+                const auto Bin = std::floor((static_cast<double>(Val) - MinValue) / (MaxValue - MinValue) * NumBins);
+                ++RefBins[static_cast<size_t>(std::min(std::max(Bin, 0.0), NumBins - 1.0))];
+            }
+        }
+
+        for (auto* pPool : {static_cast<IThreadPool*>(nullptr), pThreadPool.RawPtr()})
+        {
+            std::vector<Uint64> Bins(NumBins, 12345);
+            ComputeArray2DHistogram(Data.data(), Stride, Width, Height, MinValue, MaxValue, NumBins, Bins.data(), pPool);
+
+            Uint64 Total = 0;
+            for (Uint32 i = 0; i < NumBins; ++i)
+            {
+                // Allow off-by-one differences at bin boundaries due to float rounding
+                EXPECT_NEAR(static_cast<double>(Bins[i]), static_cast<double>(RefBins[i]), 2.0) << "Bin " << i;
+                Total += Bins[i];
+            }
+            EXPECT_EQ(Total, Uint64{Width} * Height - 1);
+        }
+    }
+}
+
+TEST(Common_Array2DTools, ComputeArray2DMinMaxPyramid)
+{
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    EXPECT_TRUE(ComputeArray2DMinMaxPyramid(nullptr, 0, 0, 0, 16).Levels.empty());
+
+    for (Uint32 test = 0; test < 16; ++test)
+    {
+        const Uint32 Width    = 1 + test * 29;
+        const Uint32 Height   = 1 + test * 41 % 300;
+        const size_t Stride   = Width + test % 3;
+        const Uint32 TileSize = 1u << (test % 6);
+
+        const auto Data = GenerateArray2D(Width, Height, Stride, test);
+
+        for (auto* pPool : {static_cast<IThreadPool*>(nullptr), pThreadPool.RawPtr()})
+        {
+            const auto Pyramid = ComputeArray2DMinMaxPyramid(Data.data(), Stride, Width, Height, TileSize, pPool);
+            ASSERT_FALSE(Pyramid.Levels.empty());
+            EXPECT_EQ(Pyramid.TileSize, TileSize);
+            EXPECT_EQ(Pyramid.Levels.back().Width, 1u);
+            EXPECT_EQ(Pyramid.Levels.back().Height, 1u);
+
+            Uint32 LevelTileSize = TileSize;
+            for (const auto& Level : Pyramid.Levels)
+            {
+                ASSERT_EQ(Level.Width, (Width + LevelTileSize - 1) / LevelTileSize);
+                ASSERT_EQ(Level.Height, (Height + LevelTileSize - 1) / LevelTileSize);
+                for (Uint32 y = 0; y < Level.Height; ++y)
+                {
+                    for (Uint32 x = 0; x < Level.Width; ++x)
+                    {
+                        float RefMin = +std::numeric_limits<float>::max();
+                        float RefMax = -std::numeric_limits<float>::max();
+                        for (Uint32 row = y * LevelTileSize; row < std::min((y + 1) * LevelTileSize, Height); ++row)
+                        {
+                            for (Uint32 col = x * LevelTileSize; col < std::min((x + 1) * LevelTileSize, Width); ++col)
+                            {
+                                RefMin = std::min(RefMin, Data[col + row * Stride]);
+                                RefMax = std::max(RefMax, Data[col + row * Stride]);
+                            }
+                        }
+                        EXPECT_EQ(Level.GetMin(x, y), RefMin);
+                        EXPECT_EQ(Level.GetMax(x, y), RefMax);
+                    }
+                }
+                LevelTileSize *= 2;
+            }
+        }
+    }
+}
+
+TEST(Common_Array2DTools, ThreadCountIndependence)
+{
+    constexpr Uint32 Width  = 777;
+    constexpr Uint32 Height = 1531;
+    constexpr size_t Stride = Width + 5;
+
+    const auto Data = GenerateArray2D(Width, Height, Stride);
+
+    float RefMin = 0, RefMax = 0;
+    GetArray2DMinMaxValue(Data.data(), Stride, Width, Height, RefMin, RefMax);
+
+    const auto RefSum = GetArray2DSum(Data.data(), Stride, Width, Height);
+
+    std::vector<Uint64> RefBins(256);
+    ComputeArray2DHistogram(Data.data(), Stride, Width, Height, -50, +50, 256, RefBins.data());
+
+    const auto RefPyramid = ComputeArray2DMinMaxPyramid(Data.data(), Stride, Width, Height, 16);
+
+    // Work is split into bands that do not depend on the number of threads,
+    // so all results must be bitwise identical to the single-threaded ones.
+    for (Uint32 NumThreads : {1u, 3u, 8u})
+    {
+        auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{NumThreads});
+        ASSERT_TRUE(pThreadPool);
+
+        float Min = 0, Max = 0;
+        GetArray2DMinMaxValue(Data.data(), Stride, Width, Height, Min, Max, pThreadPool);
+        EXPECT_EQ(Min, RefMin) << NumThreads << " threads";
+        EXPECT_EQ(Max, RefMax) << NumThreads << " threads";
+
+        EXPECT_EQ(GetArray2DSum(Data.data(), Stride, Width, Height, pThreadPool), RefSum) << NumThreads << " threads";
+
+        std::vector<Uint64> Bins(256);
+        ComputeArray2DHistogram(Data.data(), Stride, Width, Height, -50, +50, 256, Bins.data(), pThreadPool);
+        EXPECT_EQ(Bins, RefBins) << NumThreads << " threads";
+
+        const auto Pyramid = ComputeArray2DMinMaxPyramid(Data.data(), Stride, Width, Height, 16, pThreadPool);
+        EXPECT_EQ(Pyramid.TileSize, RefPyramid.TileSize);
+        ASSERT_EQ(Pyramid.Levels.size(), RefPyramid.Levels.size()) << NumThreads << " threads";
+        for (size_t i = 0; i < Pyramid.Levels.size(); ++i)
+        {
+            EXPECT_EQ(Pyramid.Levels[i].MinValues, RefPyramid.Levels[i].MinValues) << "Level " << i << ", " << NumThreads << " threads";
+            EXPECT_EQ(Pyramid.Levels[i].MaxValues, RefPyramid.Levels[i].MaxValues) << "Level " << i << ", " << NumThreads << " threads";
+        }
+    }
+}
+
 } // namespace
@@ -27,6 +27,11 @@
 
 #include "FilteringTools.hpp"
 
+#include <vector>
+
+#include "FastRand.hpp"
+#include "Errors.hpp"
+
 #include "gtest/gtest.h"
 
 using namespace Diligent;
@@ -292,4 +297,150 @@ TEST(Common_FilteringTools, FilterTexture2DBilinear)
     }
 }
 
+template <typename SrcType, TEXTURE_ADDRESS_MODE AddressMode, bool IsNormalizedCoord>
+void TestFilterTexture2DBilinearBatch(Uint32 Width, Uint32 Height)
+{
+    const size_t Stride = Width + 3;
+
+    std::vector<SrcType> Data(Stride * Height);
+    FastRandInt          RndVal{static_cast<unsigned int>(Width * Height), 0, 255};
+    for (auto& Val : Data)
+        Val = static_cast<SrcType>(RndVal());
+
+    // Address modes other than UNKNOWN allow coordinates outside of the texture
+    const float   UScale = IsNormalizedCoord ? 1.f / static_cast<float>(Width) : 1.f;
+    const float   VScale = IsNormalizedCoord ? 1.f / static_cast<float>(Height) : 1.f;
+    FastRandFloat RndX{0, -2.f * Width, 3.f * Width};
+    FastRandFloat RndY{1, -2.f * Height, 3.f * Height};
+    // With UNKNOWN address mode, both taps must be inside the texture
+    FastRandFloat RndR{2, 0.f, 0.99f};
+
+    constexpr size_t   NumSamples = 1000;
+    std::vector<float> U(NumSamples), V(NumSamples);
+    for (size_t i = 0; i < NumSamples; ++i)
+    {
+        const float x = AddressMode == TEXTURE_ADDRESS_UNKNOWN ? 0.5f + RndR() * static_cast<float>(Width - 1) : RndX();
+        const float y = AddressMode == TEXTURE_ADDRESS_UNKNOWN ? 0.5f + RndR() * static_cast<float>(Height - 1) : RndY();
+
+        U[i] = x * UScale;
+        V[i] = y * VScale;
+    }
+
+    std::vector<float> Res(NumSamples + 1, -1.f);
+    FilterTexture2DBilinear<SrcType, float, AddressMode, AddressMode, IsNormalizedCoord>(Width, Height, Data.data(), Stride, NumSamples, U.data(), V.data(), Res.data());
+    for (size_t i = 0; i < NumSamples; ++i)
+    {
+        const auto Ref = FilterTexture2DBilinear<SrcType, float, AddressMode, AddressMode, IsNormalizedCoord>(Width, Height, Data.data(), Stride, U[i], V[i]);
+        EXPECT_EQ(Res[i], Ref) << "u=" << U[i] << " v=" << V[i];
+    }
+    EXPECT_EQ(Res[NumSamples], -1.f) << "Out of bounds write";
+
+    if (AddressMode != TEXTURE_ADDRESS_UNKNOWN)
+    {
+        constexpr Uint32 NumColumns = 77;
+        constexpr Uint32 NumRows    = 13;
+        constexpr size_t DstStride  = NumColumns + 5;
+
+        const float u0 = -0.75f * Width * UScale;
+        const float du = 2.5f * Width * UScale / NumColumns;
+        const float v0 = -0.5f * Height * VScale;
+        const float dv = 2.25f * Height * VScale / NumRows;
+
+        std::vector<float> Grid(DstStride * NumRows, -1.f);
+        FilterTexture2DBilinearGrid<SrcType, float, AddressMode, AddressMode, IsNormalizedCoord>(Width, Height, Data.data(), Stride, u0, du, NumColumns, v0, dv, NumRows, Grid.data(), DstStride);
+        for (Uint32 j = 0; j < NumRows; ++j)
+        {
+            for (Uint32 i = 0; i < NumColumns; ++i)
+            {
+                const float u   = u0 + static_cast<float>(i) * du;
+                const float v   = v0 + static_cast<float>(j) * dv;
+                const auto  Ref = FilterTexture2DBilinear<SrcType, float, AddressMode, AddressMode, IsNormalizedCoord>(Width, Height, Data.data(), Stride, u, v);
+                EXPECT_EQ(Grid[i + j * DstStride], Ref) << "u=" << u << " v=" << v;
+            }
+            for (size_t i = NumColumns; i < DstStride; ++i)
+                EXPECT_EQ(Grid[i + j * DstStride], -1.f) << "Out of bounds write";
+        }
+    }
+}
+
+template <TEXTURE_ADDRESS_MODE AddressMode>
+void TestFilterTexture2DBilinearBatch()
+{
+    // Sampling a 1-texel wide texture requires an address mode
+    for (Uint32 Size : {AddressMode == TEXTURE_ADDRESS_UNKNOWN ? 2u : 1u, 5u, 64u})
+    {
+        TestFilterTexture2DBilinearBatch<float, AddressMode, false>(Size, Size + 3);
+        TestFilterTexture2DBilinearBatch<float, AddressMode, true>(Size, Size + 3);
+        TestFilterTexture2DBilinearBatch<Uint8, AddressMode, true>(Size + 7, Size);
+    }
+}
+
+TEST(Common_FilteringTools, FilterTexture2DBilinear_Batch)
+{
+    TestFilterTexture2DBilinearBatch<TEXTURE_ADDRESS_CLAMP>();
+    TestFilterTexture2DBilinearBatch<TEXTURE_ADDRESS_WRAP>();
+    TestFilterTexture2DBilinearBatch<TEXTURE_ADDRESS_MIRROR>();
+    TestFilterTexture2DBilinearBatch<TEXTURE_ADDRESS_UNKNOWN>();
+
+    std::vector<float> U{0.25f, 0.5f, 0.75f};
+    std::vector<float> V{0.75f, 0.5f, 0.25f};
+    std::vector<float> Res(U.size());
+    const float        Data[] = {1, 2, 3, 4};
+    FilterTexture2DBilinearClamp(2, 2, Data, 2, U.size(), U.data(), V.data(), Res.data());
+    for (size_t i = 0; i < U.size(); ++i)
+        EXPECT_EQ(Res[i], (FilterTexture2DBilinearClamp<float, float>(2, 2, Data, 2, U[i], V[i])));
+}
+
+TEST(Common_FilteringTools, FilterTexture2DBilinear_BatchSize)
+{
+    constexpr Uint32 Width  = 37;
+    constexpr Uint32 Height = 29;
+
+    std::vector<float> Data(size_t{Width} * Height);
+    FastRandFloat      Rnd{0, 0, 1};
+    for (auto& Val : Data)
+        Val = Rnd();
+
+    constexpr size_t MaxSamples = BilinearFilterBatchSize * 3 + 1;
+
+    std::vector<float> U(MaxSamples), V(MaxSamples);
+    for (auto& u : U)
+        u = Rnd() * 1.5f - 0.25f;
+    for (auto& v : V)
+        v = Rnd() * 1.5f - 0.25f;
+
+    // Test counts around the batch size boundaries
+    for (size_t NumSamples : {size_t{0}, size_t{1},
+                              BilinearFilterBatchSize - 1, BilinearFilterBatchSize, BilinearFilterBatchSize + 1,
+                              BilinearFilterBatchSize * 2, MaxSamples})
+    {
+        std::vector<float> Res(NumSamples + 1, -1.f);
+        FilterTexture2DBilinearClamp(Width, Height, Data.data(), Width, NumSamples, U.data(), V.data(), Res.data());
+        for (size_t i = 0; i < NumSamples; ++i)
+            EXPECT_EQ(Res[i], (FilterTexture2DBilinearClamp<float, float>(Width, Height, Data.data(), Width, U[i], V[i]))) << "Sample " << i << " of " << NumSamples;
+        EXPECT_EQ(Res[NumSamples], -1.f) << "Out of bounds write";
+    }
+
+    // Grid rows that span several batches
+    for (Uint32 NumColumns : {1u, static_cast<Uint32>(BilinearFilterBatchSize), static_cast<Uint32>(BilinearFilterBatchSize * 2 + 3)})
+    {
+        constexpr Uint32 NumRows = 3;
+
+        const float du = 1.f / NumColumns;
+        const float dv = 1.f / NumRows;
+
+        std::vector<float> Grid(size_t{NumColumns} * NumRows);
+        FilterTexture2DBilinearGrid<float, float, TEXTURE_ADDRESS_CLAMP, TEXTURE_ADDRESS_CLAMP, true>(Width, Height, Data.data(), Width, 0.f, du, NumColumns, 0.f, dv, NumRows, Grid.data(), NumColumns);
+        for (Uint32 j = 0; j < NumRows; ++j)
+        {
+            for (Uint32 i = 0; i < NumColumns; ++i)
+            {
+                const float u = static_cast<float>(i) * du;
+                const float v = static_cast<float>(j) * dv;
+                EXPECT_EQ(Grid[i + j * NumColumns], (FilterTexture2DBilinearClamp<float, float>(Width, Height, Data.data(), Width, u, v))) << "u=" << u << " v=" << v;
+            }
+        }
+    }
+}
+
 } // namespace
@@ -0,0 +1,137 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include "LockFreeBoundedQueue.hpp"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+TEST(Common_LockFreeBoundedQueue, SingleThread)
+{
+    Threading::LockFreeBoundedQueue<int> Queue{5};
+    EXPECT_EQ(Queue.GetCapacity(), 8u);
+
+    int Item = -1;
+    EXPECT_FALSE(Queue.Dequeue(Item));
+
+    // Run several laps over the ring
+    for (int lap = 0; lap < 3; ++lap)
+    {
+        for (int i = 0; i < 8; ++i)
+            EXPECT_TRUE(Queue.Enqueue(lap * 8 + i));
+        EXPECT_FALSE(Queue.Enqueue(100)) << "The queue must be full";
+
+        for (int i = 0; i < 8; ++i)
+        {
+            EXPECT_TRUE(Queue.Dequeue(Item));
+            EXPECT_EQ(Item, lap * 8 + i);
+        }
+        EXPECT_FALSE(Queue.Dequeue(Item)) << "The queue must be empty";
+    }
+}
+
+TEST(Common_LockFreeBoundedQueue, MultipleProducersAndConsumers)
+{
+    constexpr size_t NumProducers        = 4;
+    constexpr size_t NumConsumers        = 4;
+    constexpr size_t NumItemsPerProducer = 4096;
+    constexpr size_t TotalItems          = NumProducers * NumItemsPerProducer;
+
+    // Small capacity makes producers run into a full queue and consumers into an empty one
+    Threading::LockFreeBoundedQueue<size_t> Queue{8};
+
+    std::vector<std::atomic<int>> Received(TotalItems);
+    for (auto& Cnt : Received)
+        Cnt.store(0);
+    std::atomic<size_t> NumReceived{0};
+    std::atomic<bool>   OrderOK{true};
+
+    std::vector<std::thread> Workers;
+    for (size_t p = 0; p < NumProducers; ++p)
+    {
+        Workers.emplace_back(
+            [&Queue, p] //
+            {
+                for (size_t i = 0; i < NumItemsPerProducer; ++i)
+                {
+                    while (!Queue.Enqueue(p * NumItemsPerProducer + i))
+                        std::this_thread::yield();
+                }
+            });
+    }
+
+    for (size_t c = 0; c < NumConsumers; ++c)
+    {
+        Workers.emplace_back(
+            [&] //
+            {
+                // The queue is FIFO, so every consumer must see the items of one producer in order
+                std::vector<size_t> NextItem(NumProducers, 0);
+                while (NumReceived.load() < TotalItems)
+                {
+                    size_t Item = 0;
+                    if (Queue.Dequeue(Item))
+                    {
+                        const auto Producer = Item / NumItemsPerProducer;
+                        const auto Idx      = Item % NumItemsPerProducer;
+                        if (Idx < NextItem[Producer])
+                            OrderOK.store(false);
+                        NextItem[Producer] = Idx + 1;
+
+                        Received[Item].fetch_add(1);
+                        NumReceived.fetch_add(1);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    for (auto& Worker : Workers)
+        Worker.join();
+
+    EXPECT_EQ(NumReceived.load(), TotalItems);
+    EXPECT_TRUE(OrderOK.load()) << "Items of one producer were dequeued out of order";
+    for (size_t i = 0; i < Received.size(); ++i)
+    {
+        ASSERT_EQ(Received[i].load(), 1) << "Item " << i << " was received " << Received[i].load() << " times";
+    }
+
+    size_t Item = 0;
+    EXPECT_FALSE(Queue.Dequeue(Item));
+}
+
+} // namespace
@@ -0,0 +1,203 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include "MappedFileStream.hpp"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "DataBlobImpl.hpp"
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+#include "TempDirectory.hpp"
+#include "TestingEnvironment.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+namespace
+{
+
+std::string WriteTestFile(const TempDirectory& TmpDir, const char* Name, const std::vector<Uint8>& Data)
+{
+    const auto FilePath = TmpDir.Get() + FileSystem::SlashSymbol + Name;
+
+    FileWrapper File{FilePath.c_str(), EFileAccessMode::Overwrite};
+    EXPECT_TRUE(File);
+    if (File && !Data.empty())
+    {
+        EXPECT_TRUE(File->Write(Data.data(), Data.size()));
+    }
+
+    return FilePath;
+}
+
+std::vector<Uint8> GenerateTestData(size_t Size)
+{
+    std::vector<Uint8> Data(Size);
+    for (size_t i = 0; i < Data.size(); ++i)
+        Data[i] = static_cast<Uint8>((i * 31u) ^ (i >> 8u));
+    return Data;
+}
+
+TEST(Common_MappedFileStream, DataBlob)
+{
+    TempDirectory TmpDir;
+
+    // Use a size that is not a multiple of the page size
+    const auto Data     = GenerateTestData(3 * 4096 + 123);
+    const auto FilePath = WriteTestFile(TmpDir, "MappedData.bin", Data);
+
+    for (auto Hint : {EFileMapAccessHint::Normal, EFileMapAccessHint::Sequential, EFileMapAccessHint::Random, EFileMapAccessHint::WillNeed})
+    {
+        auto pBlob = MappedDataBlob::Create(FilePath.c_str(), EFileMapMode::ReadOnly, Hint);
+        ASSERT_NE(pBlob, nullptr);
+        ASSERT_EQ(pBlob->GetSize(), Data.size());
+        EXPECT_EQ(memcmp(pBlob->GetConstDataPtr(), Data.data(), Data.size()), 0);
+
+        RefCntAutoPtr<IDataBlob> pDataBlob{pBlob, IID_DataBlob};
+        EXPECT_NE(pDataBlob, nullptr);
+
+        pBlob->Advise(4096 + 17, 100, EFileMapAccessHint::Random);
+    }
+}
+
+TEST(Common_MappedFileStream, CopyOnWrite)
+{
+    TempDirectory TmpDir;
+
+    const auto Data     = GenerateTestData(10000);
+    const auto FilePath = WriteTestFile(TmpDir, "CopyOnWrite.bin", Data);
+
+    {
+        auto pBlob = MappedDataBlob::Create(FilePath.c_str(), EFileMapMode::CopyOnWrite);
+        ASSERT_NE(pBlob, nullptr);
+        ASSERT_EQ(pBlob->GetSize(), Data.size());
+
+        auto* pData = static_cast<Uint8*>(pBlob->GetDataPtr());
+        for (size_t i = 0; i < Data.size(); ++i)
+            pData[i] = ~pData[i];
+        EXPECT_EQ(pData[10], static_cast<Uint8>(~Data[10]));
+    }
+
+    // Modifications must never be written back to the file
+    std::vector<Uint8> FileData;
+    ASSERT_TRUE(FileWrapper::ReadWholeFile(FilePath.c_str(), FileData));
+    EXPECT_EQ(FileData, Data);
+}
+
+TEST(Common_MappedFileStream, Resize)
+{
+    TempDirectory TmpDir;
+
+    const auto Data     = GenerateTestData(5000);
+    const auto FilePath = WriteTestFile(TmpDir, "Resize.bin", Data);
+
+    auto pBlob = MappedDataBlob::Create(FilePath.c_str());
+    ASSERT_NE(pBlob, nullptr);
+
+    pBlob->Resize(1000);
+    EXPECT_EQ(pBlob->GetSize(), size_t{1000});
+    EXPECT_EQ(memcmp(pBlob->GetConstDataPtr(), Data.data(), 1000), 0);
+
+    // Growing the blob copies the data into memory
+    pBlob->Resize(8000);
+    EXPECT_FALSE(pBlob->IsMapped());
+    ASSERT_EQ(pBlob->GetSize(), size_t{8000});
+    EXPECT_EQ(memcmp(pBlob->GetConstDataPtr(), Data.data(), 1000), 0);
+
+    // The memory is now writable
+    static_cast<Uint8*>(pBlob->GetDataPtr())[7999] = 1;
+}
+
+TEST(Common_MappedFileStream, EmptyFile)
+{
+    TempDirectory TmpDir;
+
+    const auto FilePath = WriteTestFile(TmpDir, "Empty.bin", {});
+
+    auto pBlob = MappedDataBlob::Create(FilePath.c_str());
+    ASSERT_NE(pBlob, nullptr);
+    EXPECT_EQ(pBlob->GetSize(), size_t{0});
+}
+
+TEST(Common_MappedFileStream, MissingFile)
+{
+    TestingEnvironment::ErrorScope ExpectedErrors{"Failed to open file"};
+
+    TempDirectory TmpDir;
+
+    const auto FilePath = TmpDir.Get() + FileSystem::SlashSymbol + "Missing.bin";
+    EXPECT_EQ(MappedDataBlob::Create(FilePath.c_str()), nullptr);
+}
+
+TEST(Common_MappedFileStream, Stream)
+{
+    TempDirectory TmpDir;
+
+    const auto Data     = GenerateTestData(20000);
+    const auto FilePath = WriteTestFile(TmpDir, "Stream.bin", Data);
+
+    {
+        auto pStream = MappedFileStream::Create(FilePath.c_str());
+        ASSERT_NE(pStream, nullptr);
+        ASSERT_TRUE(pStream->IsValid());
+        EXPECT_EQ(pStream->GetSize(), Data.size());
+
+        std::vector<Uint8> Header(100);
+        EXPECT_TRUE(pStream->Read(Header.data(), Header.size()));
+        EXPECT_TRUE(std::equal(Header.begin(), Header.end(), Data.begin()));
+
+        // ReadBlob reads the rest of the file
+        auto pRest = DataBlobImpl::Create();
+        pStream->ReadBlob(pRest);
+        ASSERT_EQ(pRest->GetSize(), Data.size() - Header.size());
+        EXPECT_EQ(memcmp(pRest->GetConstDataPtr(), Data.data() + Header.size(), pRest->GetSize()), 0);
+
+        EXPECT_FALSE(pStream->Read(Header.data(), 1));
+
+        // GetDataBlob gives access to the whole file without copying
+        auto* pBlob = pStream->GetDataBlob();
+        ASSERT_NE(pBlob, nullptr);
+        EXPECT_EQ(memcmp(pBlob->GetConstDataPtr(), Data.data(), Data.size()), 0);
+
+        TestingEnvironment::ErrorScope ExpectedErrors{"Writing to a read-only mapped file stream is not allowed"};
+        EXPECT_FALSE(pStream->Write(Data.data(), 1));
+    }
+
+    {
+        auto pStream = MappedFileStream::Create(FilePath.c_str(), EFileMapMode::CopyOnWrite);
+        ASSERT_NE(pStream, nullptr);
+
+        const Uint8 Value = 0xAB;
+        EXPECT_TRUE(pStream->Write(&Value, 1));
+        EXPECT_EQ(static_cast<const Uint8*>(pStream->GetDataBlob()->GetConstDataPtr())[0], Value);
+    }
+}
+
+} // namespace
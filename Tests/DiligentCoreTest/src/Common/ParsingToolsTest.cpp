@@ -26,6 +26,9 @@
 
 #include "ParsingTools.hpp"
 
+#include <vector>
+#include <random>
+
 #include "gtest/gtest.h"
 
 #include "TestingEnvironment.hpp"
@@ -567,12 +570,14 @@ struct TestToken
         return Literal == Str;
     }
 
-    bool CompareLiteral(const char* Start, const char* End) const
+    template <typename IteratorType>
+    bool CompareLiteral(const IteratorType& Start, const IteratorType& End) const
     {
         return Literal == std::string{Start, End};
     }
 
-    void ExtendLiteral(const char* Start, const char* End)
+    template <typename IteratorType>
+    void ExtendLiteral(const IteratorType& Start, const IteratorType& End)
     {
         Literal.append(Start, End);
     }
@@ -1288,4 +1293,160 @@ TEST(Common_ParsingTools, GetTokenContext)
     }
 }
 
+// Character pointers use vectorized kernels, while other iterator types, such as
+// std::vector<char>::const_iterator, use the scalar versions. The results must be identical.
+TEST(Common_ParsingTools, FindFunctions_ScalarEquivalence)
+{
+    static constexpr char Alphabet[] = {' ', '\t', '\r', '\n', '\0', '/', '*', '"', '_', '@', '[', '`', '{',
+                                        'a', 'z', 'A', 'Z', '0', '9', 'x', '1', '\x7F', '\x80', '\xFF'};
+
+    std::mt19937                          gen{0}; // Use fixed seed for reproducibility
+    std::uniform_int_distribution<size_t> CharDistr{0, sizeof(Alphabet) - 1};
+    std::uniform_int_distribution<size_t> RunDistr{1, 40};
+
+    for (Uint32 i = 0; i < 100; ++i)
+    {
+        // Generate runs of the same character class to exercise full vector blocks
+        std::vector<char> Str;
+        while (Str.size() < 256)
+        {
+            const auto RunLen = RunDistr(gen);
+            const auto c0     = Alphabet[CharDistr(gen)];
+            const auto c1     = Alphabet[CharDistr(gen)];
+            for (size_t j = 0; j < RunLen; ++j)
+                Str.push_back((j % 7) == 6 ? c1 : c0);
+        }
+
+        const char* const pStr = Str.data();
+        const char* const pEnd = Str.data() + Str.size();
+        for (size_t Start = 0; Start < Str.size(); ++Start)
+        {
+            const auto StartIt = Str.cbegin() + Start;
+            for (size_t End : {Start, Start + 1, Start + 15, Start + 16, Start + 17, Start + 33, Str.size()})
+            {
+                End = std::min(End, Str.size());
+
+                const auto EndIt = Str.cbegin() + End;
+
+                EXPECT_EQ(FindNewLineOrNull(pStr + Start, pStr + End) - pStr, FindNewLineOrNull(StartIt, EndIt) - Str.cbegin());
+                EXPECT_EQ(FindNonDelimiter(pStr + Start, pStr + End) - pStr, FindNonDelimiter(StartIt, EndIt) - Str.cbegin());
+                EXPECT_EQ(FindNonIdentifierChar(pStr + Start, pStr + End) - pStr, FindNonIdentifierChar(StartIt, EndIt) - Str.cbegin());
+                EXPECT_EQ(FindSymbolOrNull(pStr + Start, pStr + End, '"') - pStr, FindSymbolOrNull(StartIt, EndIt, '"') - Str.cbegin());
+                EXPECT_EQ(FindSymbolOrNull(pStr + Start, pStr + End, '*') - pStr, FindSymbolOrNull(StartIt, EndIt, '*') - Str.cbegin());
+            }
+
+            EXPECT_EQ(SkipLine(pStr + Start, pEnd, true) - pStr, SkipLine(StartIt, Str.cend(), true) - Str.cbegin());
+            EXPECT_EQ(SkipDelimiters(pStr + Start, pEnd) - pStr, SkipDelimiters(StartIt, Str.cend()) - Str.cbegin());
+            EXPECT_EQ(SkipIdentifier(pStr + Start, pEnd) - pStr, SkipIdentifier(StartIt, Str.cend()) - Str.cbegin());
+        }
+    }
+}
+
+// Generates a large shader-like source that contains all token types, long comments,
+// long identifiers and indentation runs.
+std::string GenerateLargeShaderSource(size_t MinSize)
+{
+    std::stringstream ss;
+    for (Uint32 i = 0; ss.tellp() < static_cast<std::streamoff>(MinSize); ++i)
+    {
+        ss << "/* Multi-line comment " << i << "\n"
+           << " * that spans several lines and is long enough to fill a few vector blocks\n"
+           << " */\n"
+           << "#include \"Include" << i << ".fxh\"\n"
+           << "cbuffer Constants" << i << "\n"
+           << "{\n"
+           << "    float4x4 g_WorldViewProjectionMatrixWithAVeryLongName" << i << ";\n"
+           << "    float4   g_Color" << i << ";\n"
+           << "};\n"
+           << "\n"
+           << "// Single-line comment\r\n"
+           << "void Function" << i << "(in float4 Pos : ATTRIB0, out float4 Color : SV_Target)\n"
+           << "{\n"
+           << "\tfloat  x = Pos.x * 2.5e-3 + -1.0;\n"
+           << "                        x += (x >= 0.5 && x != 1) ? g_Color" << i << ".y : -x;\n"
+           << "    Color = mul(float4(x, 1.0, 2.0, 3.0), g_WorldViewProjectionMatrixWithAVeryLongName" << i << ");\n"
+           << "    Keyword1 Keyword2 Keyword3; // Trailing comment\n"
+           << "}\n\n";
+    }
+    return ss.str();
+}
+
+TEST(Common_ParsingTools, Tokenizer_ScalarEquivalence)
+{
+    const auto Source = GenerateLargeShaderSource(1 << 20);
+
+    const auto* const pStart = Source.c_str();
+    const auto* const pEnd   = pStart + Source.length();
+
+    const auto Tokens = Tokenize<TestToken, std::vector<TestToken>>(pStart, pEnd, TestToken::Create, TestToken::FindType);
+    EXPECT_EQ(BuildSource(Tokens), Source);
+
+    const std::vector<char> SourceVec{Source.begin(), Source.end()};
+    using VecIterator = std::vector<char>::const_iterator;
+
+    const auto RefTokens = Tokenize<TestToken, std::vector<TestToken>>(
+        SourceVec.begin(), SourceVec.end(),
+        [](TestTokenType Type, const VecIterator& DelimStart, const VecIterator& DelimEnd, const VecIterator& LiteralStart, const VecIterator& LiteralEnd) {
+            return TestToken{Type, std::string{LiteralStart, LiteralEnd}, std::string{DelimStart, DelimEnd}};
+        },
+        [](const VecIterator& Start, const VecIterator& End) {
+            const std::string Identifier{Start, End};
+            return TestToken::FindType(Identifier.c_str(), Identifier.c_str() + Identifier.length());
+        });
+
+    ASSERT_EQ(Tokens.size(), RefTokens.size());
+    for (size_t i = 0; i < Tokens.size(); ++i)
+    {
+        EXPECT_EQ(Tokens[i].Type, RefTokens[i].Type) << "Token " << i;
+        EXPECT_EQ(Tokens[i].Literal, RefTokens[i].Literal) << "Token " << i;
+        EXPECT_EQ(Tokens[i].Delimiter, RefTokens[i].Delimiter) << "Token " << i;
+    }
+}
+
+TEST(Common_ParsingTools, SplitString_ScalarEquivalence)
+{
+    const auto Source = GenerateLargeShaderSource(64 << 10);
+
+    const auto* const pStart = Source.c_str();
+    const auto* const pEnd   = pStart + Source.length();
+
+    const std::vector<char> SourceVec{Source.begin(), Source.end()};
+
+    // Offsets of all items found by the vectorized and scalar versions
+    std::vector<size_t> Items;
+    SplitString(pStart, pEnd, [&](const char* DelimStart, const char*& Pos) {
+        Items.push_back(DelimStart - pStart);
+        Items.push_back(Pos - pStart);
+        Pos = SkipIdentifier(Pos, pEnd);
+        if (Pos != pEnd && !IsDelimiter(*Pos))
+            ++Pos;
+        return Pos != pEnd;
+    });
+    EXPECT_FALSE(Items.empty());
+
+    std::vector<size_t> RefItems;
+    SplitString(SourceVec.begin(), SourceVec.end(), [&](const std::vector<char>::const_iterator& DelimStart, std::vector<char>::const_iterator& Pos) {
+        RefItems.push_back(DelimStart - SourceVec.begin());
+        RefItems.push_back(Pos - SourceVec.begin());
+        Pos = SkipIdentifier(Pos, SourceVec.end());
+        if (Pos != SourceVec.end() && !IsDelimiter(*Pos))
+            ++Pos;
+        return Pos != SourceVec.end();
+    });
+
+    EXPECT_EQ(Items, RefItems);
+}
+
+TEST(Common_ParsingTools, FindNonIdentifierChar_NonASCII)
+{
+    // Characters outside of the ASCII range must not be passed to isalnum as negative values
+    const std::string Str = "Identifier\xE9\xFF";
+
+    const auto* const pStart = Str.c_str();
+    const auto* const pEnd   = pStart + Str.length();
+    EXPECT_EQ(FindNonIdentifierChar(pStart, pEnd), pStart + 10);
+    EXPECT_EQ(FindNonIdentifierChar(Str.begin(), Str.end()), Str.begin() + 10);
+    EXPECT_EQ(SkipIdentifier(pStart + 10, pEnd), pStart + 10);
+}
+
 } // namespace
@@ -0,0 +1,291 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "DynamicAtlasManager.hpp"
+#include "SkylineAtlasManager.hpp"
+#include "ShelfAtlasManager.hpp"
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "BasicMath.hpp"
+#include "FastRand.hpp"
+
+using namespace Diligent;
+
+namespace
+{
+
+using Region = AtlasRegion;
+
+enum ALLOCATOR_TYPE
+{
+    ALLOCATOR_TYPE_NODE_SPLIT,
+    ALLOCATOR_TYPE_SKYLINE,
+    ALLOCATOR_TYPE_SHELF,
+    ALLOCATOR_TYPE_COUNT
+};
+
+const char* GetAllocatorName(ALLOCATOR_TYPE Type)
+{
+    switch (Type)
+    {
+        case ALLOCATOR_TYPE_NODE_SPLIT: return "Node split";
+        case ALLOCATOR_TYPE_SKYLINE: return "Skyline";
+        case ALLOCATOR_TYPE_SHELF: return "Shelf";
+        default: return "Unknown";
+    }
+}
+
+std::unique_ptr<IAtlasRegionAllocator> CreateAllocator(ALLOCATOR_TYPE Type, Uint32 Width, Uint32 Height)
+{
+    switch (Type)
+    {
+        case ALLOCATOR_TYPE_NODE_SPLIT: return std::unique_ptr<IAtlasRegionAllocator>{new DynamicAtlasManager{Width, Height}};
+        case ALLOCATOR_TYPE_SKYLINE: return std::unique_ptr<IAtlasRegionAllocator>{new SkylineAtlasManager{Width, Height}};
+        case ALLOCATOR_TYPE_SHELF: return std::unique_ptr<IAtlasRegionAllocator>{new ShelfAtlasManager{Width, Height}};
+        default: return nullptr;
+    }
+}
+
+class OccupancyGrid
+{
+public:
+    OccupancyGrid(Uint32 Width, Uint32 Height) :
+        m_Width{Width},
+        m_Height{Height},
+        m_Cells(size_t{Width} * size_t{Height})
+    {}
+
+    // Returns false if the region is out of bounds or overlaps another region
+    bool Mark(const Region& R, bool Occupied)
+    {
+        if (R.x + R.width > m_Width || R.y + R.height > m_Height)
+            return false;
+
+        for (Uint32 y = R.y; y < R.y + R.height; ++y)
+        {
+            for (Uint32 x = R.x; x < R.x + R.width; ++x)
+            {
+                auto& Cell = m_Cells[size_t{y} * m_Width + x];
+                if ((Cell != 0) == Occupied)
+                    return false;
+                Cell = Occupied ? 1 : 0;
+            }
+        }
+        return true;
+    }
+
+private:
+    const Uint32       m_Width;
+    const Uint32       m_Height;
+    std::vector<Uint8> m_Cells;
+};
+
+TEST(GraphicsAccessories_AtlasRegionAllocator, AllocateFull)
+{
+    for (int Type = 0; Type < ALLOCATOR_TYPE_COUNT; ++Type)
+    {
+        auto pAllocator = CreateAllocator(static_cast<ALLOCATOR_TYPE>(Type), 64, 32);
+        EXPECT_TRUE(pAllocator->IsEmpty());
+        EXPECT_EQ(pAllocator->GetTotalFreeArea(), 64u * 32u);
+        EXPECT_EQ(pAllocator->GetLargestFreeRegionArea(), 64u * 32u);
+
+        EXPECT_TRUE(pAllocator->Allocate(65, 16).IsEmpty());
+        EXPECT_TRUE(pAllocator->Allocate(16, 33).IsEmpty());
+
+        auto R = pAllocator->Allocate(64, 32);
+        EXPECT_EQ(R, Region(0, 0, 64, 32));
+        EXPECT_FALSE(pAllocator->IsEmpty());
+        EXPECT_EQ(pAllocator->GetAllocatedRegionCount(), 1u);
+        EXPECT_EQ(pAllocator->GetTotalFreeArea(), 0u);
+        EXPECT_EQ(pAllocator->GetLargestFreeRegionArea(), 0u);
+        EXPECT_TRUE(pAllocator->Allocate(1, 1).IsEmpty());
+
+        pAllocator->Free(std::move(R));
+        EXPECT_TRUE(R.IsEmpty());
+        EXPECT_TRUE(pAllocator->IsEmpty());
+        EXPECT_EQ(pAllocator->GetLargestFreeRegionArea(), 64u * 32u);
+    }
+}
+
+TEST(GraphicsAccessories_AtlasRegionAllocator, AllocateRandom)
+{
+    constexpr Uint32 AtlasSize = 128;
+    for (int Type = 0; Type < ALLOCATOR_TYPE_COUNT; ++Type)
+    {
+        auto pAllocator = CreateAllocator(static_cast<ALLOCATOR_TYPE>(Type), AtlasSize, AtlasSize);
+
+        OccupancyGrid       Grid{AtlasSize, AtlasSize};
+        std::vector<Region> Regions;
+        FastRandInt         rnd{static_cast<unsigned int>(Type), 1, 24};
+
+        Uint64 AllocatedArea = 0;
+        for (Uint32 Iter = 0; Iter < 8; ++Iter)
+        {
+            for (Uint32 i = 0; i < 64; ++i)
+            {
+                auto R = pAllocator->Allocate(static_cast<Uint32>(rnd()), static_cast<Uint32>(rnd()));
+                if (R.IsEmpty())
+                    continue;
+                ASSERT_TRUE(Grid.Mark(R, true)) << GetAllocatorName(static_cast<ALLOCATOR_TYPE>(Type)) << " allocator returned overlapping region";
+                AllocatedArea += Uint64{R.width} * Uint64{R.height};
+                Regions.push_back(R);
+            }
+            EXPECT_EQ(pAllocator->GetAllocatedRegionCount(), Regions.size());
+            EXPECT_EQ(pAllocator->GetTotalFreeArea(), Uint64{AtlasSize} * AtlasSize - AllocatedArea);
+            EXPECT_LE(pAllocator->GetLargestFreeRegionArea(), pAllocator->GetTotalFreeArea());
+
+            // Release every other region
+            for (size_t i = 0; i < Regions.size(); i += 2)
+            {
+                ASSERT_TRUE(Grid.Mark(Regions[i], false));
+                AllocatedArea -= Uint64{Regions[i].width} * Uint64{Regions[i].height};
+                pAllocator->Free(std::move(Regions[i]));
+            }
+            Regions.erase(std::remove_if(Regions.begin(), Regions.end(), [](const Region& R) { return R.IsEmpty(); }), Regions.end());
+        }
+
+        for (auto& R : Regions)
+            pAllocator->Free(std::move(R));
+        EXPECT_TRUE(pAllocator->IsEmpty());
+        EXPECT_EQ(pAllocator->GetTotalFreeArea(), Uint64{AtlasSize} * AtlasSize);
+        EXPECT_EQ(pAllocator->GetLargestFreeRegionArea(), Uint64{AtlasSize} * AtlasSize);
+    }
+}
+
+// Allocates regions until the first failure and returns the fraction of the atlas area that is occupied.
+template <typename SizeGeneratorType>
+float MeasurePackingEfficiency(IAtlasRegionAllocator& Allocator, SizeGeneratorType&& GenerateSize)
+{
+    std::vector<Region> Regions;
+
+    Uint64 AllocatedArea = 0;
+    while (true)
+    {
+        const auto Size = GenerateSize();
+
+        auto R = Allocator.Allocate(Size.x, Size.y);
+        if (R.IsEmpty())
+            break;
+        AllocatedArea += Uint64{R.width} * Uint64{R.height};
+        Regions.push_back(R);
+    }
+
+    for (auto& R : Regions)
+        Allocator.Free(std::move(R));
+
+    return static_cast<float>(static_cast<double>(AllocatedArea) / (static_cast<double>(Allocator.GetWidth()) * static_cast<double>(Allocator.GetHeight())));
+}
+
+TEST(GraphicsAccessories_AtlasRegionAllocator, PackingEfficiency)
+{
+    constexpr Uint32 AtlasSize = 256;
+    for (int Type = 0; Type < ALLOCATOR_TYPE_COUNT; ++Type)
+    {
+        auto pAllocator = CreateAllocator(static_cast<ALLOCATOR_TYPE>(Type), AtlasSize, AtlasSize);
+
+        // Glyph-like regions of similar height
+        FastRandInt GlyphWidth{0, 4, 16};
+        FastRandInt GlyphHeight{1, 14, 18};
+        const auto  GlyphEfficiency = MeasurePackingEfficiency(*pAllocator, [&]() {
+            return uint2{static_cast<Uint32>(GlyphWidth()), static_cast<Uint32>(GlyphHeight())};
+        });
+        EXPECT_TRUE(pAllocator->IsEmpty());
+
+        // Regions of arbitrary sizes
+        FastRandInt RegionSize{2, 1, 32};
+        const auto  MixedEfficiency = MeasurePackingEfficiency(*pAllocator, [&]() {
+            return uint2{static_cast<Uint32>(RegionSize()), static_cast<Uint32>(RegionSize())};
+        });
+        EXPECT_TRUE(pAllocator->IsEmpty());
+
+        LOG_INFO_MESSAGE(GetAllocatorName(static_cast<ALLOCATOR_TYPE>(Type)), " packing efficiency: ",
+                         static_cast<int>(GlyphEfficiency * 100.f), "% (glyphs), ",
+                         static_cast<int>(MixedEfficiency * 100.f), "% (mixed sizes)");
+
+        // All allocators pack regions of similar height well.
+        // Shelf packing wastes a lot of space when region heights vary.
+        EXPECT_GT(GlyphEfficiency, 0.75f);
+        EXPECT_GT(MixedEfficiency, Type == ALLOCATOR_TYPE_SHELF ? 0.35f : 0.7f);
+    }
+}
+
+TEST(GraphicsAccessories_AtlasRegionAllocator, ReuseAfterFree)
+{
+    constexpr Uint32 AtlasSize  = 256;
+    constexpr Uint32 NumRegions = 512;
+
+    for (int Type = 0; Type < ALLOCATOR_TYPE_COUNT; ++Type)
+    {
+        const auto* Name       = GetAllocatorName(static_cast<ALLOCATOR_TYPE>(Type));
+        auto        pAllocator = CreateAllocator(static_cast<ALLOCATOR_TYPE>(Type), AtlasSize, AtlasSize);
+
+        std::vector<Region> Regions(NumRegions);
+
+        FastRandInt RegionWidth{0, 4, 16};
+        FastRandInt RegionHeight{1, 8, 16};
+        for (Uint32 Iter = 0; Iter < 4; ++Iter)
+        {
+            Uint32 NumAllocated = 0;
+            for (auto& R : Regions)
+            {
+                R = pAllocator->Allocate(static_cast<Uint32>(RegionWidth()), static_cast<Uint32>(RegionHeight()));
+                if (!R.IsEmpty())
+                    ++NumAllocated;
+            }
+            // The atlas must be filled to the same extent in every iteration
+            EXPECT_GT(NumAllocated, NumRegions / 2) << Name << " allocator, iteration " << Iter;
+            EXPECT_EQ(pAllocator->GetAllocatedRegionCount(), NumAllocated) << Name;
+
+            // Release regions in a different order than they were allocated
+            for (size_t i = 0; i < Regions.size(); i += 2)
+            {
+                if (!Regions[i].IsEmpty())
+                    pAllocator->Free(std::move(Regions[i]));
+            }
+            for (size_t i = 1; i < Regions.size(); i += 2)
+            {
+                if (!Regions[i].IsEmpty())
+                    pAllocator->Free(std::move(Regions[i]));
+            }
+            ASSERT_TRUE(pAllocator->IsEmpty()) << Name;
+
+            // Free space must be fully merged, so that the whole atlas can be allocated again
+            EXPECT_EQ(pAllocator->GetTotalFreeArea(), Uint64{AtlasSize} * AtlasSize) << Name;
+            EXPECT_EQ(pAllocator->GetLargestFreeRegionArea(), Uint64{AtlasSize} * AtlasSize) << Name;
+            auto Full = pAllocator->Allocate(AtlasSize, AtlasSize);
+            ASSERT_FALSE(Full.IsEmpty()) << Name << " allocator failed to allocate the whole atlas after releasing all regions";
+            pAllocator->Free(std::move(Full));
+        }
+    }
+}
+
+} // namespace
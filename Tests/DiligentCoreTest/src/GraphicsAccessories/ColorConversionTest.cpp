@@ -0,0 +1,227 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+#include "ColorConversion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "FastRand.hpp"
+#include "Errors.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Correctly rounded reference conversion computed in double precision
+Uint8 LinearToSRGB8Ref(float x)
+{
+    if (!(x > 0.f))
+        return 0;
+    if (x >= 1.f)
+        return 255;
+    const double Linear = x;
+    const double SRGB   = Linear <= 0.0031308 ? Linear * 12.92 : 1.055 * std::pow(Linear, 1.0 / 2.4) - 0.055;
+    return static_cast<Uint8>(std::floor(SRGB * 255.0 + 0.5));
+}
+
+TEST(GraphicsAccessories_ColorConversion, SRGB8ToLinear)
+{
+    std::vector<Uint8> SRGB(256 + 13);
+    for (size_t i = 0; i < SRGB.size(); ++i)
+        SRGB[i] = static_cast<Uint8>(i * 7);
+
+    // Test all counts to cover the remainder handling
+    for (size_t Count = 0; Count <= SRGB.size(); Count += (Count < 32 ? 1 : 37))
+    {
+        std::vector<float> Linear(Count + 1, -1.f);
+        SRGB8ToLinear(SRGB.data(), Linear.data(), Count);
+        for (size_t i = 0; i < Count; ++i)
+            EXPECT_EQ(Linear[i], SRGBToLinear(SRGB[i])) << i;
+        EXPECT_EQ(Linear[Count], -1.f) << "Out of bounds write";
+    }
+}
+
+TEST(GraphicsAccessories_ColorConversion, LinearToSRGB8_RoundTrip)
+{
+    std::vector<Uint8> SRGB(256);
+    for (Uint32 i = 0; i < 256; ++i)
+        SRGB[i] = static_cast<Uint8>(i);
+
+    std::vector<float> Linear(SRGB.size());
+    SRGB8ToLinear(SRGB.data(), Linear.data(), SRGB.size());
+
+    std::vector<Uint8> SRGB2(SRGB.size());
+    LinearToSRGB8(Linear.data(), SRGB2.data(), Linear.size());
+    EXPECT_EQ(SRGB, SRGB2);
+
+    for (Uint32 i = 0; i < 256; ++i)
+    {
+        Uint8 Res = 0;
+        LinearToSRGB8(&Linear[i], &Res, 1);
+        EXPECT_EQ(Res, i);
+    }
+}
+
+TEST(GraphicsAccessories_ColorConversion, LinearToSRGB8_Rounding)
+{
+    std::vector<float> Linear;
+
+    // Values around rounding thresholds
+    for (Uint32 k = 0; k < 255; ++k)
+    {
+        const double SRGB      = (k + 0.5) / 255.0;
+        const float  Threshold = static_cast<float>(SRGB <= 0.04045 ? SRGB / 12.92 : std::pow((SRGB + 0.055) / 1.055, 2.4));
+
+        float x = Threshold;
+        for (int i = 0; i < 3; ++i)
+            x = std::nextafter(x, 0.f);
+        for (int i = 0; i < 7; ++i)
+        {
+            Linear.push_back(x);
+            x = std::nextafter(x, 1.f);
+        }
+    }
+
+    // Special values
+    for (float x : {0.f, -0.f, 1.f, -1.f, 2.f, 1e-30f, -1e-30f,
+                    std::numeric_limits<float>::denorm_min(),
+                    std::numeric_limits<float>::infinity(),
+                    -std::numeric_limits<float>::infinity(),
+                    std::numeric_limits<float>::quiet_NaN(),
+                    std::nextafter(1.f, 0.f),
+                    std::nextafter(1.f, 2.f)})
+    {
+        Linear.push_back(x);
+    }
+
+    // Random values
+    FastRandFloat rnd{0, -0.1f, 1.1f};
+    for (size_t i = 0; i < 100000; ++i)
+        Linear.push_back(rnd());
+
+    std::vector<Uint8> SRGB(Linear.size());
+    LinearToSRGB8(Linear.data(), SRGB.data(), Linear.size());
+    for (size_t i = 0; i < Linear.size(); ++i)
+    {
+        EXPECT_EQ(SRGB[i], LinearToSRGB8Ref(Linear[i])) << "x = " << Linear[i];
+
+        Uint8 Res = 0;
+        LinearToSRGB8(&Linear[i], &Res, 1);
+        EXPECT_EQ(Res, SRGB[i]) << "x = " << Linear[i];
+    }
+}
+
+TEST(GraphicsAccessories_ColorConversion, RGBA)
+{
+    constexpr size_t NumPixels = 1027;
+
+    std::vector<Uint8> SRGBA(NumPixels * 4);
+    FastRandInt        rnd{0, 0, 255};
+    for (auto& c : SRGBA)
+        c = static_cast<Uint8>(rnd());
+
+    std::vector<float> LinearRGBA(NumPixels * 4);
+    SRGBA8ToLinearRGBA32F(SRGBA.data(), LinearRGBA.data(), NumPixels);
+    for (size_t i = 0; i < NumPixels * 4; ++i)
+    {
+        if (i % 4 < 3)
+            EXPECT_EQ(LinearRGBA[i], SRGBToLinear(SRGBA[i]));
+        else
+            EXPECT_EQ(LinearRGBA[i], static_cast<float>(SRGBA[i]) / 255.f);
+    }
+
+    std::vector<Uint8> SRGBA2(NumPixels * 4);
+    LinearRGBA32FToSRGBA8(LinearRGBA.data(), SRGBA2.data(), NumPixels);
+    EXPECT_EQ(SRGBA, SRGBA2);
+
+    // Out-of-range values
+    const float Pixels[] = {-1.f, 2.f, std::numeric_limits<float>::quiet_NaN(), -1.f,
+                            0.5f, 0.5f, 0.5f, 2.f,
+                            0.25f, 0.75f, 1.f, 0.5f};
+
+    Uint8 Res[12] = {};
+    LinearRGBA32FToSRGBA8(Pixels, Res, 3);
+    const Uint8 Ref[] = {0, 255, 0, 0,
+                         LinearToSRGB8Ref(0.5f), LinearToSRGB8Ref(0.5f), LinearToSRGB8Ref(0.5f), 255,
+                         LinearToSRGB8Ref(0.25f), LinearToSRGB8Ref(0.75f), 255, 128};
+    for (size_t i = 0; i < sizeof(Ref); ++i)
+        EXPECT_EQ(Res[i], Ref[i]) << i;
+}
+
+TEST(GraphicsAccessories_ColorConversion, UnalignedSpans)
+{
+    constexpr size_t MaxCount = 131;
+
+    std::vector<Uint8> SRGB(MaxCount + 16);
+    FastRandInt        rnd{0, 0, 255};
+    for (auto& c : SRGB)
+        c = static_cast<Uint8>(rnd());
+
+    // Bulk conversions must match the per-value results for any source and
+    // destination alignment and any count.
+    for (size_t Offset = 0; Offset < 16; ++Offset)
+    {
+        for (size_t Count = 0; Count <= MaxCount; Count += (Count < 16 ? 1 : 23))
+        {
+            std::vector<float> Linear(Offset + Count + 1, -1.f);
+            SRGB8ToLinear(&SRGB[Offset], &Linear[Offset], Count);
+            for (size_t i = 0; i < Count; ++i)
+                EXPECT_EQ(Linear[Offset + i], SRGBToLinear(SRGB[Offset + i])) << "Offset " << Offset << ", i " << i;
+            EXPECT_EQ(Linear[Offset + Count], -1.f) << "Out of bounds write";
+
+            std::vector<Uint8> SRGB2(Offset + Count + 1, 0xCD);
+            LinearToSRGB8(&Linear[Offset], &SRGB2[Offset], Count);
+            for (size_t i = 0; i < Count; ++i)
+                EXPECT_EQ(SRGB2[Offset + i], SRGB[Offset + i]) << "Offset " << Offset << ", i " << i;
+            EXPECT_EQ(SRGB2[Offset + Count], 0xCD) << "Out of bounds write";
+
+            const size_t NumPixels = Count / 4;
+
+            std::vector<float> LinearRGBA(Offset + NumPixels * 4 + 1, -1.f);
+            SRGBA8ToLinearRGBA32F(&SRGB[Offset], &LinearRGBA[Offset], NumPixels);
+            for (size_t i = 0; i < NumPixels * 4; ++i)
+            {
+                const Uint8 c = SRGB[Offset + i];
+                EXPECT_EQ(LinearRGBA[Offset + i], i % 4 < 3 ? SRGBToLinear(c) : static_cast<float>(c) / 255.f) << "Offset " << Offset << ", i " << i;
+            }
+            EXPECT_EQ(LinearRGBA[Offset + NumPixels * 4], -1.f) << "Out of bounds write";
+
+            std::vector<Uint8> SRGBA2(Offset + NumPixels * 4 + 1, 0xCD);
+            LinearRGBA32FToSRGBA8(&LinearRGBA[Offset], &SRGBA2[Offset], NumPixels);
+            for (size_t i = 0; i < NumPixels * 4; ++i)
+                EXPECT_EQ(SRGBA2[Offset + i], SRGB[Offset + i]) << "Offset " << Offset << ", i " << i;
+            EXPECT_EQ(SRGBA2[Offset + NumPixels * 4], 0xCD) << "Out of bounds write";
+        }
+    }
+}
+
+} // namespace
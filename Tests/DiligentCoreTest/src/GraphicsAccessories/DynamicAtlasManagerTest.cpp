@@ -465,4 +465,40 @@ TEST(GraphicsAccessories_DynamicAtlasManager, AllocateRandom)
     }
 }
 
+TEST(GraphicsAccessories_DynamicAtlasManager, FragmentationMetrics)
+{
+    DynamicAtlasManager Mgr{16, 16};
+    EXPECT_EQ(Mgr.GetAllocatedRegionCount(), 0u);
+    EXPECT_EQ(Mgr.GetLargestFreeRegionArea(), 16u * 16u);
+
+    std::vector<Region> Regions(16);
+    for (auto& R : Regions)
+    {
+        R = Mgr.Allocate(4, 4);
+        ASSERT_FALSE(R.IsEmpty());
+    }
+    EXPECT_EQ(Mgr.GetAllocatedRegionCount(), 16u);
+    EXPECT_EQ(Mgr.GetLargestFreeRegionArea(), 0u);
+    EXPECT_EQ(Mgr.GetTotalFreeArea(), 0u);
+
+    // Free every other region in a checkerboard pattern so that
+    // no two free regions can be merged.
+    for (auto& R : Regions)
+    {
+        if (((R.x / 4) + (R.y / 4)) % 2 == 0)
+            Mgr.Free(std::move(R));
+    }
+    EXPECT_EQ(Mgr.GetAllocatedRegionCount(), 8u);
+    EXPECT_EQ(Mgr.GetTotalFreeArea(), 8u * 4u * 4u);
+    EXPECT_EQ(Mgr.GetLargestFreeRegionArea(), 4u * 4u);
+
+    for (auto& R : Regions)
+    {
+        if (!R.IsEmpty())
+            Mgr.Free(std::move(R));
+    }
+    EXPECT_EQ(Mgr.GetAllocatedRegionCount(), 0u);
+    EXPECT_EQ(Mgr.GetLargestFreeRegionArea(), 16u * 16u);
+}
+
 } // namespace
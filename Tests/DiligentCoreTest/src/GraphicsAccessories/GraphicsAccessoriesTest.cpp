@@ -26,8 +26,12 @@
  */
 
 #include <array>
+#include <cstring>
+#include <vector>
 
 #include "GraphicsAccessories.hpp"
+#include "ThreadPool.hpp"
+#include "Errors.hpp"
 #include "../../../../Graphics/GraphicsEngine/include/PrivateConstants.h"
 
 #include "gtest/gtest.h"
@@ -1125,4 +1129,104 @@ TEST(GraphicsAccessories_GraphicsAccessories, GetAdapterTypeString)
     EXPECT_STREQ(GetAdapterTypeString(ADAPTER_TYPE_DISCRETE, true), "ADAPTER_TYPE_DISCRETE");
 }
 
+void ReferenceCopyTextureSubresource(const TextureSubResData& SrcSubres,
+                                     Uint32                   NumRows,
+                                     Uint32                   NumDepthSlices,
+                                     Uint64                   RowSize,
+                                     Uint8*                   pDstData,
+                                     Uint64                   DstRowStride,
+                                     Uint64                   DstDepthStride)
+{
+    for (Uint32 z = 0; z < NumDepthSlices; ++z)
+    {
+        for (Uint32 y = 0; y < NumRows; ++y)
+        {
+            memcpy(pDstData + DstDepthStride * z + DstRowStride * y,
+                   static_cast<const Uint8*>(SrcSubres.pData) + SrcSubres.DepthStride * z + SrcSubres.Stride * y,
+                   static_cast<size_t>(RowSize));
+        }
+    }
+}
+
+TEST(GraphicsAccessories_GraphicsAccessories, CopyTextureSubresource)
+{
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    struct TestCase
+    {
+        Uint32 RowSize;
+        Uint32 NumRows;
+        Uint32 NumDepthSlices;
+        Uint32 SrcRowPadding;
+        Uint32 SrcDepthPadding;
+        Uint32 DstRowPadding;
+        Uint32 DstDepthPadding;
+    };
+    const TestCase TestCases[] = {
+        // clang-format off
+        {  16,    1,   1,  0,   0,  0,   0},
+        {  12,    7,   1,  4,   0,  0,   0},
+        {  12,    7,   1,  0,   0, 20,   0},
+        {  64,    8,   4,  0,   0,  0,   0},
+        {  64,    8,   4, 16,  32, 16,  32},
+        {  64,    8,   4, 16,   0, 16,  64},
+        { 100,   33,   3,  0,  12,  4,   0},
+        // Large subresources use streaming stores and the thread pool
+        {4096,  512,   1,  0,   0,  0,   0},
+        {4096,  512,   1,  0,   0,  256, 0},
+        {1020,  256,   8,  4,   0,  0,  512},
+        {1024,  256,  16,  0,   0,  0,   0},
+        {4100, 2048,   1,  0,   0, 60,   0},
+        // clang-format on
+    };
+
+    for (const auto& Case : TestCases)
+    {
+        for (IThreadPool* pPool : {static_cast<IThreadPool*>(nullptr), pThreadPool.RawPtr()})
+        {
+            const Uint64 SrcRowStride   = Uint64{Case.RowSize} + Case.SrcRowPadding;
+            const Uint64 SrcDepthStride = SrcRowStride * Case.NumRows + Case.SrcDepthPadding;
+            const Uint64 DstRowStride   = Uint64{Case.RowSize} + Case.DstRowPadding;
+            const Uint64 DstDepthStride = DstRowStride * Case.NumRows + Case.DstDepthPadding;
+
+            // Add a few bytes after the end to detect out-of-bounds writes
+            std::vector<Uint8> Src(static_cast<size_t>(SrcDepthStride * Case.NumDepthSlices));
+            std::vector<Uint8> Dst(static_cast<size_t>(DstDepthStride * Case.NumDepthSlices + 16), Uint8{0xCD});
+            std::vector<Uint8> Ref(Dst);
+            for (size_t i = 0; i < Src.size(); ++i)
+                Src[i] = static_cast<Uint8>(i * 7 + (i >> 8));
+
+            const TextureSubResData SrcSubres{Src.data(), SrcRowStride, SrcDepthStride};
+            CopyTextureSubresource(SrcSubres, Case.NumRows, Case.NumDepthSlices, Case.RowSize, Dst.data(), DstRowStride, DstDepthStride, pPool);
+            ReferenceCopyTextureSubresource(SrcSubres, Case.NumRows, Case.NumDepthSlices, Case.RowSize, Ref.data(), DstRowStride, DstDepthStride);
+
+            for (Uint32 z = 0; z < Case.NumDepthSlices; ++z)
+            {
+                for (Uint32 y = 0; y < Case.NumRows; ++y)
+                {
+                    const size_t Offset = static_cast<size_t>(DstDepthStride * z + DstRowStride * y);
+                    EXPECT_EQ(memcmp(&Dst[Offset], &Ref[Offset], Case.RowSize), 0)
+                        << "z=" << z << " y=" << y << " RowSize=" << Case.RowSize << " NumRows=" << Case.NumRows;
+                }
+            }
+            // Row and depth padding in the destination must never be touched
+            for (size_t i = 0; i < Dst.size(); ++i)
+            {
+                const Uint64 z = i / DstDepthStride;
+                const Uint64 y = (i % DstDepthStride) / DstRowStride;
+                const Uint64 x = (i % DstDepthStride) % DstRowStride;
+                if (z < Case.NumDepthSlices && y < Case.NumRows && x < Case.RowSize)
+                    continue;
+                if (Dst[i] != Uint8{0xCD})
+                {
+                    ADD_FAILURE() << "Padding byte at offset " << i << " was overwritten. RowSize=" << Case.RowSize << " NumRows=" << Case.NumRows;
+                    break;
+                }
+            }
+            EXPECT_EQ(memcmp(&Dst[Dst.size() - 16], &Ref[Ref.size() - 16], 16), 0) << "Out of bounds write";
+        }
+    }
+}
+
 } // namespace
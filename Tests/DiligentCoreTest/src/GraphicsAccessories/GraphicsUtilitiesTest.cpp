@@ -28,6 +28,8 @@
 #include "GraphicsUtilities.h"
 #include "FastRand.hpp"
 #include "ColorConversion.h"
+#include "ThreadPool.hpp"
+#include "GraphicsAccessories.hpp"
 
 #include <vector>
 #include <array>
@@ -575,4 +577,241 @@ TEST(GraphicsTools_CalculateMipLevel, sRGB_BOX_AVE)
     EXPECT_TRUE(CoarseData == RefCoarseData);
 }
 
+// Straightforward scalar implementation of ComputeMipLevel that the optimized
+// ComputeMipLevel and ComputeMipChain are verified against.
+namespace RefMip
+{
+
+Uint8  Average(Uint8 c0, Uint8 c1, Uint8 c2, Uint8 c3) { return static_cast<Uint8>((Uint32{c0} + c1 + c2 + c3) / 4); }
+Uint16 Average(Uint16 c0, Uint16 c1, Uint16 c2, Uint16 c3) { return static_cast<Uint16>((Uint32{c0} + c1 + c2 + c3) / 4); }
+Uint32 Average(Uint32 c0, Uint32 c1, Uint32 c2, Uint32 c3) { return (c0 + c1 + c2 + c3) / 4; }
+Int8   Average(Int8 c0, Int8 c1, Int8 c2, Int8 c3) { return static_cast<Int8>((Int32{c0} + c1 + c2 + c3) / 4); }
+Int16  Average(Int16 c0, Int16 c1, Int16 c2, Int16 c3) { return static_cast<Int16>((Int32{c0} + c1 + c2 + c3) / 4); }
+Int32  Average(Int32 c0, Int32 c1, Int32 c2, Int32 c3) { return (c0 + c1 + c2 + c3) / 4; }
+float  Average(float c0, float c1, float c2, float c3) { return (c0 + c1 + c2 + c3) * 0.25f; }
+
+Uint8 SRGBAverage(Uint8 c0, Uint8 c1, Uint8 c2, Uint8 c3)
+{
+    auto ToLinear = [](Uint8 c) {
+        return FastSRGBToLinear(static_cast<float>(c) * (1.f / 255.f));
+    };
+
+    const float Linear = (ToLinear(c0) + ToLinear(c1) + ToLinear(c2) + ToLinear(c3)) * 0.25f;
+    return static_cast<Uint8>(std::min(std::max(FastLinearToSRGB(Linear) * 255.f, 0.f), 255.f));
+}
+
+template <typename T>
+T MostFrequent(T c0, T c1, T c2, T c3, Uint32 col, Uint32 row)
+{
+    // c0 and c1 are in the bottom row, c2 and c3 are in the top row
+    if (c0 == c1)
+        return (c2 != c3 || (row & 1) != 0) ? c0 : c2;
+    if (c0 == c2)
+        return (c1 != c3 || (col & 1) != 0) ? c0 : c1;
+    if (c0 == c3)
+        return (c1 != c2 || ((col + row) & 1) != 0) ? c0 : c1;
+    if (c1 == c2 || c1 == c3)
+        return c1;
+    if (c2 == c3)
+        return c2;
+
+    const T c[] = {c0, c1, c2, c3};
+    return c[(col + row) % 4];
+}
+
+template <typename T>
+void ComputeMipLevel(const ComputeMipLevelAttribs& Attribs)
+{
+    const auto& FmtAttribs  = GetTextureFormatAttribs(Attribs.Format);
+    const auto  NumChannels = Uint32{FmtAttribs.NumComponents};
+    const bool  IsSRGB      = FmtAttribs.ComponentType == COMPONENT_TYPE_UNORM_SRGB;
+    const bool  IsInteger   = FmtAttribs.ComponentType == COMPONENT_TYPE_UINT || FmtAttribs.ComponentType == COMPONENT_TYPE_SINT;
+
+    const bool UseMostFrequent =
+        Attribs.FilterType == MIP_FILTER_TYPE_MOST_FREQUENT ||
+        (Attribs.FilterType == MIP_FILTER_TYPE_DEFAULT && IsInteger);
+
+    const auto FineWidth    = Attribs.FineMipWidth;
+    const auto FineHeight   = Attribs.FineMipHeight;
+    const auto CoarseWidth  = std::max(FineWidth / 2, 1u);
+    const auto CoarseHeight = std::max(FineHeight / 2, 1u);
+
+    auto Fine = [&](Uint32 col, Uint32 row, Uint32 c) {
+        col = std::min(col, FineWidth - 1);
+        row = std::min(row, FineHeight - 1);
+        return reinterpret_cast<const T*>(static_cast<const Uint8*>(Attribs.pFineMipData) + row * Attribs.FineMipStride)[col * NumChannels + c];
+    };
+
+    for (Uint32 row = 0; row < CoarseHeight; ++row)
+    {
+        auto* pDstRow = reinterpret_cast<T*>(static_cast<Uint8*>(Attribs.pCoarseMipData) + row * Attribs.CoarseMipStride);
+        for (Uint32 col = 0; col < CoarseWidth; ++col)
+        {
+            for (Uint32 c = 0; c < NumChannels; ++c)
+            {
+                const T c0 = Fine(col * 2, row * 2, c);
+                const T c1 = Fine(col * 2 + 1, row * 2, c);
+                const T c2 = Fine(col * 2, row * 2 + 1, c);
+                const T c3 = Fine(col * 2 + 1, row * 2 + 1, c);
+
+                T& Dst = pDstRow[col * NumChannels + c];
+                if (UseMostFrequent)
+                    Dst = MostFrequent(c0, c1, c2, c3, col, row);
+                else
+                    Dst = IsSRGB ? static_cast<T>(SRGBAverage(static_cast<Uint8>(c0), static_cast<Uint8>(c1), static_cast<Uint8>(c2), static_cast<Uint8>(c3))) : Average(c0, c1, c2, c3);
+            }
+
+            if (Attribs.AlphaCutoff > 0)
+            {
+                // A_new = max(A_old, 1/3 * A_old + 2/3 * CutoffThreshold)
+                auto&       Alpha    = reinterpret_cast<Uint8&>(pDstRow[col * NumChannels + NumChannels - 1]);
+                const float AlphaNew = std::min((static_cast<float>(Alpha) + 2.f * (Attribs.AlphaCutoff * 255.f)) / 3.f, 255.f);
+                Alpha                = std::max(Alpha, static_cast<Uint8>(AlphaNew));
+            }
+        }
+    }
+}
+
+} // namespace RefMip
+
+void ComputeReferenceMipLevel(const ComputeMipLevelAttribs& Attribs)
+{
+    const auto& FmtAttribs = GetTextureFormatAttribs(Attribs.Format);
+    const bool  IsSigned   = FmtAttribs.ComponentType == COMPONENT_TYPE_SNORM || FmtAttribs.ComponentType == COMPONENT_TYPE_SINT;
+    if (FmtAttribs.ComponentType == COMPONENT_TYPE_FLOAT)
+    {
+        RefMip::ComputeMipLevel<float>(Attribs);
+        return;
+    }
+
+    switch (FmtAttribs.ComponentSize)
+    {
+        case 1:
+            IsSigned ? RefMip::ComputeMipLevel<Int8>(Attribs) : RefMip::ComputeMipLevel<Uint8>(Attribs);
+            break;
+
+        case 2:
+            IsSigned ? RefMip::ComputeMipLevel<Int16>(Attribs) : RefMip::ComputeMipLevel<Uint16>(Attribs);
+            break;
+
+        case 4:
+            IsSigned ? RefMip::ComputeMipLevel<Int32>(Attribs) : RefMip::ComputeMipLevel<Uint32>(Attribs);
+            break;
+
+        default:
+            UNEXPECTED("Unexpected component size");
+    }
+}
+
+void TestComputeMipChain(TEXTURE_FORMAT Fmt, Uint32 Width, Uint32 Height, MIP_FILTER_TYPE FilterType = MIP_FILTER_TYPE_DEFAULT, float AlphaCutoff = 0, IThreadPool* pThreadPool = nullptr)
+{
+    const auto& FmtAttribs = GetTextureFormatAttribs(Fmt);
+    const auto  TexelSize  = size_t{FmtAttribs.ComponentSize} * FmtAttribs.NumComponents;
+    const auto  MipLevels  = ComputeMipLevelsCount(Width, Height);
+
+    std::vector<std::vector<Uint8>> RefMips(MipLevels);
+    std::vector<std::vector<Uint8>> Mips(MipLevels);
+    std::vector<void*>              pMipData(MipLevels);
+    std::vector<size_t>             MipStrides(MipLevels);
+    for (Uint32 mip = 0; mip < MipLevels; ++mip)
+    {
+        const auto MipWidth  = std::max(Width >> mip, 1u);
+        const auto MipHeight = std::max(Height >> mip, 1u);
+        // Use padded strides to make sure they are respected
+        MipStrides[mip] = MipWidth * TexelSize + mip * 4;
+        RefMips[mip].resize(MipStrides[mip] * MipHeight);
+        Mips[mip].resize(MipStrides[mip] * MipHeight);
+        pMipData[mip] = Mips[mip].data();
+    }
+
+    FastRandInt rnd{static_cast<unsigned int>(Width * 31 + Height), 0, 255};
+    if (FmtAttribs.ComponentType == COMPONENT_TYPE_FLOAT)
+    {
+        for (size_t i = 0; i < RefMips[0].size() / sizeof(float); ++i)
+            reinterpret_cast<float*>(RefMips[0].data())[i] = static_cast<float>(rnd()) / 255.f;
+    }
+    else
+    {
+        for (auto& Byte : RefMips[0])
+            Byte = FilterType == MIP_FILTER_TYPE_MOST_FREQUENT ? static_cast<Uint8>(rnd() & 0x03) : static_cast<Uint8>(rnd());
+    }
+    Mips[0] = RefMips[0];
+
+    for (Uint32 mip = 1; mip < MipLevels; ++mip)
+    {
+        const ComputeMipLevelAttribs Attribs{Fmt, std::max(Width >> (mip - 1), 1u), std::max(Height >> (mip - 1), 1u),
+                                             RefMips[mip - 1].data(), MipStrides[mip - 1],
+                                             RefMips[mip].data(), MipStrides[mip],
+                                             FilterType, AlphaCutoff};
+        ComputeReferenceMipLevel(Attribs);
+
+        // Single level computed from the reference fine level
+        std::vector<Uint8> Mip(RefMips[mip].size());
+
+        ComputeMipLevelAttribs MipAttribs = Attribs;
+        MipAttribs.pCoarseMipData         = Mip.data();
+        ComputeMipLevel(MipAttribs);
+        EXPECT_TRUE(Mip == RefMips[mip]) << "ComputeMipLevel: " << GetTextureFormatAttribs(Fmt).Name << ' ' << Width << 'x' << Height << ", mip " << mip;
+    }
+
+    ComputeMipChain({Fmt, Width, Height, MipLevels, pMipData.data(), MipStrides.data(), FilterType, AlphaCutoff}, pThreadPool);
+
+    for (Uint32 mip = 1; mip < MipLevels; ++mip)
+    {
+        EXPECT_TRUE(Mips[mip] == RefMips[mip]) << "ComputeMipChain: " << GetTextureFormatAttribs(Fmt).Name << ' ' << Width << 'x' << Height << ", mip " << mip;
+    }
+}
+
+constexpr std::pair<Uint32, Uint32> MipChainTestSizes[] = {
+    {1, 1},
+    {1, 37},
+    {64, 1},
+    {2, 2},
+    {37, 19},
+    {64, 64},
+    {129, 67},
+    {256, 250},
+};
+
+TEST(GraphicsTools_ComputeMipChain, BoxAverage)
+{
+    for (auto Fmt : {TEX_FORMAT_R8_UNORM, TEX_FORMAT_RG8_UNORM, TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA8_UNORM_SRGB,
+                     TEX_FORMAT_R16_UNORM, TEX_FORMAT_RG16_SNORM, TEX_FORMAT_R32_FLOAT, TEX_FORMAT_RG32_FLOAT, TEX_FORMAT_RGBA32_FLOAT})
+    {
+        for (const auto& Size : MipChainTestSizes)
+            TestComputeMipChain(Fmt, Size.first, Size.second);
+    }
+}
+
+TEST(GraphicsTools_ComputeMipChain, MostFrequent)
+{
+    for (auto Fmt : {TEX_FORMAT_R8_UINT, TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_R32_SINT})
+    {
+        for (const auto& Size : MipChainTestSizes)
+            TestComputeMipChain(Fmt, Size.first, Size.second, MIP_FILTER_TYPE_MOST_FREQUENT);
+    }
+}
+
+TEST(GraphicsTools_ComputeMipChain, AlphaCutoff)
+{
+    for (auto Fmt : {TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA8_UNORM_SRGB})
+    {
+        for (const auto& Size : MipChainTestSizes)
+            TestComputeMipChain(Fmt, Size.first, Size.second, MIP_FILTER_TYPE_BOX_AVERAGE, 0.5f);
+    }
+}
+
+TEST(GraphicsTools_ComputeMipChain, ThreadPool)
+{
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_TRUE(pThreadPool);
+
+    for (auto Fmt : {TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_RGBA8_UNORM_SRGB, TEX_FORMAT_R32_FLOAT, TEX_FORMAT_R16_UINT})
+    {
+        for (const auto& Size : MipChainTestSizes)
+            TestComputeMipChain(Fmt, Size.first, Size.second, MIP_FILTER_TYPE_DEFAULT, 0, pThreadPool);
+    }
+    TestComputeMipChain(TEX_FORMAT_RGBA8_UNORM, 1024, 1000, MIP_FILTER_TYPE_BOX_AVERAGE, 0.25f, pThreadPool);
+}
+
 } // namespace
@@ -27,6 +27,10 @@
 #include "BytecodeCache.h"
 #include "DataBlobImpl.hpp"
 #include "DefaultShaderSourceStreamFactory.h"
+#include "FileWrapper.hpp"
+#include "FileSystem.hpp"
+#include "MappedFileStream.hpp"
+#include "TempDirectory.hpp"
 #include "gtest/gtest.h"
 
 using namespace Diligent;
@@ -72,6 +76,51 @@ TEST(BytecodeCacheTest, Basic)
     }
 }
 
+TEST(BytecodeCacheTest, LoadFromMappedFile)
+{
+    RefCntAutoPtr<IBytecodeCache> pCache;
+    CreateBytecodeCache({RENDER_DEVICE_TYPE_VULKAN}, &pCache);
+    ASSERT_NE(pCache, nullptr);
+
+    ShaderCreateInfo ShaderCI{};
+    ShaderCI.Desc.ShaderType = SHADER_TYPE_COMPUTE;
+    ShaderCI.Desc.Name       = "TestName";
+    ShaderCI.Source          = "SomeCode";
+
+    const std::string        Data{"TestString"};
+    RefCntAutoPtr<IDataBlob> pBytecodeSaved = DataBlobImpl::Create(Data.length(), Data.c_str());
+    pCache->AddBytecode(ShaderCI, pBytecodeSaved);
+
+    Testing::TempDirectory TmpDir;
+
+    const auto FilePath = TmpDir.Get() + FileSystem::SlashSymbol + "BytecodeCache.bin";
+    {
+        RefCntAutoPtr<IDataBlob> pCacheData;
+        pCache->Store(&pCacheData);
+        ASSERT_NE(pCacheData, nullptr);
+
+        FileWrapper File{FilePath.c_str(), EFileAccessMode::Overwrite};
+        ASSERT_TRUE(File);
+        ASSERT_TRUE(File->Write(pCacheData->GetConstDataPtr(), pCacheData->GetSize()));
+    }
+
+    pCache->Clear();
+
+    // Read-only mapping must be sufficient to load the cache
+    auto pMappedData = MappedDataBlob::Create(FilePath.c_str(), EFileMapMode::ReadOnly, EFileMapAccessHint::Sequential);
+    ASSERT_NE(pMappedData, nullptr);
+    EXPECT_TRUE(pCache->Load(pMappedData));
+
+    // The bytecode must be copied out of the mapping
+    pMappedData.Release();
+
+    RefCntAutoPtr<IDataBlob> pBytecodeLoaded;
+    pCache->GetBytecode(ShaderCI, &pBytecodeLoaded);
+    ASSERT_NE(pBytecodeLoaded, nullptr);
+    EXPECT_EQ(pBytecodeSaved->GetSize(), pBytecodeLoaded->GetSize());
+    EXPECT_EQ(memcmp(pBytecodeSaved->GetConstDataPtr(), pBytecodeLoaded->GetConstDataPtr(), pBytecodeLoaded->GetSize()), 0);
+}
+
 TEST(BytecodeCacheTest, RemoveBytecode)
 {
     RefCntAutoPtr<IBytecodeCache> pCache;
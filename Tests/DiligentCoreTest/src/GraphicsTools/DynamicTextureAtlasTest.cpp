@@ -0,0 +1,248 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "DynamicTextureAtlas.h"
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+#include "RefCntAutoPtr.hpp"
+#include "gtest/gtest.h"
+#include "FastRand.hpp"
+#include "Errors.hpp"
+
+using namespace Diligent;
+
+namespace
+{
+
+// The tests in this file only exercise the CPU-side allocation logic:
+// the atlas is created without a device and the texture is never requested.
+RefCntAutoPtr<IDynamicTextureAtlas> CreateTestAtlas(Uint32                             AtlasDim,
+                                                    Uint32                             MinAlignment,
+                                                    bool                               ScalableAllocation,
+                                                    DYNAMIC_TEXTURE_ATLAS_PACKING_MODE PackingMode = DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_NODE_SPLIT)
+{
+    DynamicTextureAtlasCreateInfo CI;
+    CI.ExtraSliceCount    = 1;
+    CI.MaxSliceCount      = 256;
+    CI.MinAlignment       = MinAlignment;
+    CI.ScalableAllocation = ScalableAllocation;
+    CI.PackingMode        = PackingMode;
+    CI.Desc.Format        = TEX_FORMAT_RGBA8_UNORM;
+    CI.Desc.Name          = "Dynamic Texture Atlas Test";
+    CI.Desc.Type          = RESOURCE_DIM_TEX_2D_ARRAY;
+    CI.Desc.BindFlags     = BIND_SHADER_RESOURCE;
+    CI.Desc.Width         = AtlasDim;
+    CI.Desc.Height        = AtlasDim;
+    CI.Desc.ArraySize     = 1;
+
+    RefCntAutoPtr<IDynamicTextureAtlas> pAtlas;
+    CreateDynamicTextureAtlas(nullptr, CI, &pAtlas);
+    return pAtlas;
+}
+
+bool Overlap(const ITextureAtlasSuballocation* pA, const ITextureAtlasSuballocation* pB)
+{
+    if (pA->GetSlice() != pB->GetSlice())
+        return false;
+
+    const auto OrgA  = pA->GetOrigin();
+    const auto OrgB  = pB->GetOrigin();
+    const auto SizeA = pA->GetSize();
+    const auto SizeB = pB->GetSize();
+    return OrgA.x < OrgB.x + SizeB.x && OrgB.x < OrgA.x + SizeA.x &&
+        OrgA.y < OrgB.y + SizeB.y && OrgB.y < OrgA.y + SizeA.y;
+}
+
+using AllocationsType = std::vector<std::vector<RefCntAutoPtr<ITextureAtlasSuballocation>>>;
+
+// Every thread allocates NumAllocations regions and then releases every other one
+void AllocateInParallel(IDynamicTextureAtlas* pAtlas, AllocationsType& Allocations, size_t NumAllocations)
+{
+    std::vector<std::thread> Threads(Allocations.size());
+    for (size_t t = 0; t < Threads.size(); ++t)
+    {
+        Threads[t] = std::thread{
+            [&](size_t thread_id) //
+            {
+                FastRandInt rnd{static_cast<unsigned int>(thread_id), 4, 32};
+
+                auto& Allocs = Allocations[thread_id];
+                Allocs.resize(NumAllocations);
+                for (auto& Alloc : Allocs)
+                {
+                    const auto Width  = static_cast<Uint32>(rnd());
+                    const auto Height = static_cast<Uint32>(rnd());
+                    pAtlas->Allocate(Width, Height, &Alloc);
+                }
+
+                for (size_t i = 0; i < Allocs.size(); i += 2)
+                    Allocs[i].Release();
+            },
+            t //
+        };
+    }
+
+    for (auto& Thread : Threads)
+        Thread.join();
+}
+
+void TestParallelAllocation(bool ScalableAllocation, DYNAMIC_TEXTURE_ATLAS_PACKING_MODE PackingMode = DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_NODE_SPLIT)
+{
+    auto pAtlas = CreateTestAtlas(512, 8, ScalableAllocation, PackingMode);
+    ASSERT_TRUE(pAtlas);
+
+    const size_t NumThreads = std::max(4u, std::thread::hardware_concurrency());
+
+    AllocationsType Allocations(NumThreads);
+    for (size_t iter = 0; iter < 4; ++iter)
+    {
+        AllocateInParallel(pAtlas, Allocations, 512);
+
+        std::vector<ITextureAtlasSuballocation*> AllAllocs;
+        for (auto& Allocs : Allocations)
+        {
+            for (auto& Alloc : Allocs)
+            {
+                if (Alloc)
+                    AllAllocs.push_back(Alloc);
+            }
+        }
+        EXPECT_EQ(AllAllocs.size(), NumThreads * 256);
+
+        std::sort(AllAllocs.begin(), AllAllocs.end(),
+                  [](const ITextureAtlasSuballocation* pA, const ITextureAtlasSuballocation* pB) {
+                      return pA->GetSlice() < pB->GetSlice();
+                  });
+        for (size_t i = 0; i < AllAllocs.size(); ++i)
+        {
+            for (size_t j = i + 1; j < AllAllocs.size() && AllAllocs[j]->GetSlice() == AllAllocs[i]->GetSlice(); ++j)
+            {
+                ASSERT_FALSE(Overlap(AllAllocs[i], AllAllocs[j]))
+                    << "Allocations " << i << " and " << j << " overlap in slice " << AllAllocs[i]->GetSlice();
+            }
+        }
+
+        DynamicTextureAtlasUsageStats Stats;
+        pAtlas->GetUsageStats(Stats);
+        EXPECT_EQ(Stats.AllocationCount, AllAllocs.size());
+    }
+
+    Allocations.clear();
+
+    DynamicTextureAtlasUsageStats Stats;
+    pAtlas->GetUsageStats(Stats);
+    EXPECT_EQ(Stats.AllocationCount, 0u);
+    EXPECT_EQ(Stats.AllocatedArea, 0u);
+    EXPECT_EQ(Stats.CommittedSliceCount, 0u);
+}
+
+TEST(GraphicsTools_DynamicTextureAtlas, ParallelAllocation)
+{
+    TestParallelAllocation(false);
+}
+
+TEST(GraphicsTools_DynamicTextureAtlas, ScalableParallelAllocation)
+{
+    TestParallelAllocation(true);
+}
+
+TEST(GraphicsTools_DynamicTextureAtlas, SkylinePacking)
+{
+    TestParallelAllocation(false, DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_SKYLINE);
+    TestParallelAllocation(true, DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_SKYLINE);
+}
+
+TEST(GraphicsTools_DynamicTextureAtlas, ShelfPacking)
+{
+    TestParallelAllocation(false, DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_SHELF);
+    TestParallelAllocation(true, DYNAMIC_TEXTURE_ATLAS_PACKING_MODE_SHELF);
+}
+
+void TestParallelFreeInOneSlice(bool ScalableAllocation)
+{
+    auto pAtlas = CreateTestAtlas(1024, 8, ScalableAllocation);
+    ASSERT_TRUE(pAtlas);
+
+    const size_t NumThreads = std::max(4u, std::thread::hardware_concurrency());
+
+    constexpr size_t NumAllocationsPerThread = 64;
+    for (size_t iter = 0; iter < 16; ++iter)
+    {
+        // All regions fit into the first slice
+        AllocationsType Allocations(NumThreads);
+        for (auto& Allocs : Allocations)
+        {
+            Allocs.resize(NumAllocationsPerThread);
+            for (auto& Alloc : Allocs)
+            {
+                pAtlas->Allocate(16, 16, &Alloc);
+                ASSERT_TRUE(Alloc);
+                ASSERT_EQ(Alloc->GetSlice(), 0u);
+            }
+        }
+
+        // Release all regions of the slice from multiple threads at the same time
+        std::atomic<size_t>      NumReadyThreads{0};
+        std::vector<std::thread> Threads(NumThreads);
+        for (size_t t = 0; t < Threads.size(); ++t)
+        {
+            Threads[t] = std::thread{
+                [&](size_t thread_id) //
+                {
+                    NumReadyThreads.fetch_add(1);
+                    while (NumReadyThreads.load() < NumThreads)
+                        std::this_thread::yield();
+
+                    for (auto& Alloc : Allocations[thread_id])
+                        Alloc.Release();
+                },
+                t //
+            };
+        }
+
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        DynamicTextureAtlasUsageStats Stats;
+        pAtlas->GetUsageStats(Stats);
+        ASSERT_EQ(Stats.AllocationCount, 0u);
+        ASSERT_EQ(Stats.AllocatedArea, 0u);
+        ASSERT_EQ(Stats.CommittedSliceCount, 0u);
+    }
+}
+
+TEST(GraphicsTools_DynamicTextureAtlas, ParallelFreeInOneSlice)
+{
+    TestParallelFreeInOneSlice(false);
+    TestParallelFreeInOneSlice(true);
+}
+
+} // namespace
@@ -0,0 +1,180 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "ShaderVariantManager.hpp"
+#include "DefaultShaderSourceStreamFactory.h"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+ShaderCreateInfo GetShaderCI(const char* Source, const ShaderMacro* Macros, SHADER_TYPE ShaderType = SHADER_TYPE_PIXEL)
+{
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.Desc.Name       = "Variant";
+    ShaderCI.Desc.ShaderType = ShaderType;
+    ShaderCI.SourceLanguage  = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.Source          = Source;
+    ShaderCI.Macros          = Macros;
+    return ShaderCI;
+}
+
+TEST(ShaderVariantManagerTest, UnusedMacros)
+{
+    ShaderVariantManager Mgr{ShaderVariantManagerCreateInfo{}};
+
+    constexpr char Source[] = R"(
+#if USE_FOG
+    float4 main() : SV_Target { return float4(1.0, 0.0, 0.0, 1.0); }
+#else
+    float4 main() : SV_Target { return float4(0.0, 1.0, 0.0, 1.0); }
+#endif
+)";
+
+    const ShaderMacro Macros0[] = {{"USE_FOG", "1"}, {"UNUSED", "0"}, {}};
+    const ShaderMacro Macros1[] = {{"UNUSED", "1"}, {"USE_FOG", "1"}, {}};
+    const ShaderMacro Macros2[] = {{"USE_FOG", "1"}, {}};
+    const ShaderMacro Macros3[] = {{"USE_FOG", "0"}, {"UNUSED", "0"}, {}};
+
+    const auto Var0 = Mgr.AddVariant(GetShaderCI(Source, Macros0));
+    const auto Var1 = Mgr.AddVariant(GetShaderCI(Source, Macros1));
+    const auto Var2 = Mgr.AddVariant(GetShaderCI(Source, Macros2));
+    const auto Var3 = Mgr.AddVariant(GetShaderCI(Source, Macros3));
+    const auto Var4 = Mgr.AddVariant(GetShaderCI(Source, nullptr));
+
+    EXPECT_EQ(Mgr.GetVariantCount(), 5u);
+    EXPECT_EQ(Mgr.GetUniqueVariantCount(), 3u);
+    EXPECT_EQ(Mgr.GetUniqueVariantIndex(Var0), Mgr.GetUniqueVariantIndex(Var1));
+    EXPECT_EQ(Mgr.GetUniqueVariantIndex(Var0), Mgr.GetUniqueVariantIndex(Var2));
+    EXPECT_NE(Mgr.GetUniqueVariantIndex(Var0), Mgr.GetUniqueVariantIndex(Var3));
+    EXPECT_NE(Mgr.GetUniqueVariantIndex(Var3), Mgr.GetUniqueVariantIndex(Var4));
+    EXPECT_EQ(Mgr.GetShader(Var0), nullptr);
+
+    const auto Stats = Mgr.GetStats();
+    EXPECT_EQ(Stats.NumVariants, 5u);
+    EXPECT_EQ(Stats.NumUniqueVariants, 3u);
+    EXPECT_EQ(Stats.NumCompiledVariants, 0u);
+
+    Mgr.Clear();
+    EXPECT_EQ(Mgr.GetVariantCount(), 0u);
+    EXPECT_EQ(Mgr.GetUniqueVariantCount(), 0u);
+}
+
+TEST(ShaderVariantManagerTest, NestedMacros)
+{
+    ShaderVariantManager Mgr{ShaderVariantManagerCreateInfo{}};
+
+    constexpr char Source[] = "float4 main() : SV_Target { return float4(SCALE, 0.0, 0.0, 1.0); }";
+
+    const ShaderMacro Macros0[] = {{"SCALE", "(FACTOR * 2.0)"}, {"FACTOR", "1.0"}, {}};
+    const ShaderMacro Macros1[] = {{"SCALE", "(FACTOR * 2.0)"}, {"FACTOR", "2.0"}, {}};
+    const ShaderMacro Macros2[] = {{"SCALE", "(FACTOR * 2.0)"}, {"FACTOR", "2.0"}, {"OTHER", "2.0"}, {}};
+
+    const auto Var0 = Mgr.AddVariant(GetShaderCI(Source, Macros0));
+    const auto Var1 = Mgr.AddVariant(GetShaderCI(Source, Macros1));
+    const auto Var2 = Mgr.AddVariant(GetShaderCI(Source, Macros2));
+
+    EXPECT_EQ(Mgr.GetUniqueVariantCount(), 2u);
+    EXPECT_NE(Mgr.GetUniqueVariantIndex(Var0), Mgr.GetUniqueVariantIndex(Var1));
+    EXPECT_EQ(Mgr.GetUniqueVariantIndex(Var1), Mgr.GetUniqueVariantIndex(Var2));
+}
+
+TEST(ShaderVariantManagerTest, CommentsAndWhitespaces)
+{
+    ShaderVariantManager Mgr{ShaderVariantManagerCreateInfo{}};
+
+    constexpr char Source0[] = "float4 main() : SV_Target\n{\n    return float4(0.0, 0.0, 0.0, 1.0);\n}\n";
+    constexpr char Source1[] = "float4  main()/* Entry point */: SV_Target\n{\n  // Return black\n  return float4(0.0, 0.0, 0.0, 1.0);\n}";
+    constexpr char Source2[] = "float4 main() : SV_Target\n{\n    return float4(0.0, 0.0, 0.0, 0.5);\n}\n";
+
+    const auto Var0 = Mgr.AddVariant(GetShaderCI(Source0, nullptr));
+    const auto Var1 = Mgr.AddVariant(GetShaderCI(Source1, nullptr));
+    const auto Var2 = Mgr.AddVariant(GetShaderCI(Source2, nullptr));
+    const auto Var3 = Mgr.AddVariant(GetShaderCI(Source0, nullptr, SHADER_TYPE_VERTEX));
+
+    EXPECT_EQ(Mgr.GetUniqueVariantCount(), 3u);
+    EXPECT_EQ(Mgr.GetUniqueVariantIndex(Var0), Mgr.GetUniqueVariantIndex(Var1));
+    EXPECT_NE(Mgr.GetUniqueVariantIndex(Var0), Mgr.GetUniqueVariantIndex(Var2));
+    EXPECT_NE(Mgr.GetUniqueVariantIndex(Var0), Mgr.GetUniqueVariantIndex(Var3));
+}
+
+TEST(ShaderVariantManagerTest, TokenPasting)
+{
+    ShaderVariantManager Mgr{ShaderVariantManagerCreateInfo{}};
+
+    constexpr char Source[] = R"(
+#define CONCAT(a, b) a##b
+float4 main() : SV_Target { return float4(CONCAT(USE_, FOG), 0.0, 0.0, 1.0); }
+)";
+
+    const ShaderMacro Macros0[] = {{"USE_FOG", "0.0"}, {}};
+    const ShaderMacro Macros1[] = {{"USE_FOG", "1.0"}, {}};
+
+    Mgr.AddVariant(GetShaderCI(Source, Macros0));
+    Mgr.AddVariant(GetShaderCI(Source, Macros1));
+
+    EXPECT_EQ(Mgr.GetUniqueVariantCount(), 2u);
+}
+
+TEST(ShaderVariantManagerTest, InlineSourceWithIncludes)
+{
+    ShaderVariantManager Mgr{ShaderVariantManagerCreateInfo{}};
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pRedFactory;
+    CreateDefaultShaderSourceStreamFactory("shaders/ShaderVariantManager/Red", &pRedFactory);
+    ASSERT_NE(pRedFactory, nullptr);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pGreenFactory;
+    CreateDefaultShaderSourceStreamFactory("shaders/ShaderVariantManager/Green", &pGreenFactory);
+    ASSERT_NE(pGreenFactory, nullptr);
+
+    // The same source text includes a different file with every factory
+    constexpr char Source[] = R"(
+#include "Color.hlsli"
+float4 main() : SV_Target { return COLOR; }
+)";
+
+    auto ShaderCI0 = GetShaderCI(Source, nullptr);
+    auto ShaderCI1 = GetShaderCI(Source, nullptr);
+    auto ShaderCI2 = GetShaderCI(Source, nullptr);
+
+    ShaderCI0.pShaderSourceStreamFactory = pRedFactory;
+    ShaderCI1.pShaderSourceStreamFactory = pGreenFactory;
+    ShaderCI2.pShaderSourceStreamFactory = pRedFactory;
+
+    const auto Var0 = Mgr.AddVariant(ShaderCI0);
+    const auto Var1 = Mgr.AddVariant(ShaderCI1);
+    const auto Var2 = Mgr.AddVariant(ShaderCI2);
+
+    EXPECT_EQ(Mgr.GetUniqueVariantCount(), 2u);
+    EXPECT_NE(Mgr.GetUniqueVariantIndex(Var0), Mgr.GetUniqueVariantIndex(Var1));
+    EXPECT_EQ(Mgr.GetUniqueVariantIndex(Var0), Mgr.GetUniqueVariantIndex(Var2));
+}
+
+} // namespace
@@ -0,0 +1,157 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "TransientResourceAllocator.hpp"
+
+#include <vector>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+#include "FastRand.hpp"
+
+using namespace Diligent;
+
+namespace
+{
+
+bool LifetimesOverlap(const TransientResourceLifetime& Res0, const TransientResourceLifetime& Res1)
+{
+    return Res0.FirstUse <= Res1.LastUse && Res1.FirstUse <= Res0.LastUse;
+}
+
+void VerifyPlan(const std::vector<TransientResourceLifetime>& Resources, const TransientMemoryPlanner& Plan)
+{
+    Uint64 UnaliasedSize = 0;
+    for (Uint32 i = 0; i < Resources.size(); ++i)
+    {
+        const auto& Res0    = Resources[i];
+        const auto  Offset0 = Plan.GetOffset(i);
+        EXPECT_EQ(Offset0 % Res0.Alignment, 0u);
+        EXPECT_LE(Offset0 + Res0.Size, Plan.GetMemorySize());
+        UnaliasedSize += Res0.Size;
+
+        const auto& Aliased = Plan.GetAliasedResources(i);
+        for (Uint32 j = 0; j < Resources.size(); ++j)
+        {
+            if (i == j)
+                continue;
+
+            const auto& Res1          = Resources[j];
+            const auto  Offset1       = Plan.GetOffset(j);
+            const auto  MemoryOverlap = Offset0 < Offset1 + Res1.Size && Offset1 < Offset0 + Res0.Size;
+            if (LifetimesOverlap(Res0, Res1))
+            {
+                EXPECT_FALSE(MemoryOverlap) << "Resources " << i << " and " << j << " are alive at the same time and share memory";
+            }
+
+            const auto IsAliased = std::find(Aliased.begin(), Aliased.end(), j) != Aliased.end();
+            EXPECT_EQ(IsAliased, MemoryOverlap) << "Resources " << i << " and " << j;
+        }
+    }
+    EXPECT_EQ(Plan.GetUnaliasedMemorySize(), UnaliasedSize);
+    EXPECT_LE(Plan.GetPeakWorkingSetSize(), Plan.GetMemorySize());
+    EXPECT_LE(Plan.GetMemorySize(), Plan.GetUnaliasedMemorySize());
+}
+
+TEST(GraphicsTools_TransientMemoryPlanner, Empty)
+{
+    TransientMemoryPlanner Plan;
+    Plan.Plan(nullptr, 0);
+    EXPECT_EQ(Plan.GetMemorySize(), 0u);
+    EXPECT_EQ(Plan.GetUnaliasedMemorySize(), 0u);
+    EXPECT_EQ(Plan.GetPeakWorkingSetSize(), 0u);
+}
+
+TEST(GraphicsTools_TransientMemoryPlanner, Chain)
+{
+    // Each pass reads the output of the previous one, so only two resources are alive at a time
+    constexpr Uint64 Size = 1 << 20;
+
+    std::vector<TransientResourceLifetime> Resources(8);
+    for (Uint32 i = 0; i < Resources.size(); ++i)
+    {
+        auto& Res     = Resources[i];
+        Res.Size      = Size;
+        Res.Alignment = 1 << 16;
+        Res.FirstUse  = i;
+        Res.LastUse   = i + 1;
+    }
+
+    TransientMemoryPlanner Plan;
+    Plan.Plan(Resources.data(), static_cast<Uint32>(Resources.size()));
+    VerifyPlan(Resources, Plan);
+
+    EXPECT_EQ(Plan.GetPeakWorkingSetSize(), 2 * Size);
+    EXPECT_EQ(Plan.GetMemorySize(), 2 * Size);
+    EXPECT_EQ(Plan.GetUnaliasedMemorySize(), Resources.size() * Size);
+
+    // Resource 0 shares memory with resources 2, 4, 6
+    const auto& Aliased = Plan.GetAliasedResources(0);
+    EXPECT_EQ(Aliased, (std::vector<Uint32>{2, 4, 6}));
+}
+
+TEST(GraphicsTools_TransientMemoryPlanner, Alignment)
+{
+    std::vector<TransientResourceLifetime> Resources(3);
+    Resources[0] = {100, 1, 0, 2};
+    Resources[1] = {64, 256, 1, 2};
+    Resources[2] = {1000, 1024, 3, 3};
+
+    TransientMemoryPlanner Plan;
+    Plan.Plan(Resources.data(), static_cast<Uint32>(Resources.size()));
+    VerifyPlan(Resources, Plan);
+
+    EXPECT_EQ(Plan.GetOffset(2), 0u);
+    EXPECT_EQ(Plan.GetOffset(0), 0u);
+    EXPECT_EQ(Plan.GetOffset(1), 256u);
+    EXPECT_EQ(Plan.GetMemorySize(), 1000u);
+}
+
+TEST(GraphicsTools_TransientMemoryPlanner, Random)
+{
+    FastRandInt Rnd{0, 0, 1 << 10};
+
+    for (Uint32 Iter = 0; Iter < 32; ++Iter)
+    {
+        constexpr Uint32 NumPasses = 32;
+
+        std::vector<TransientResourceLifetime> Resources(40);
+        for (auto& Res : Resources)
+        {
+            Res.Size      = Uint64{1 + static_cast<Uint32>(Rnd()) % 64} << 16;
+            Res.Alignment = 1 << 16;
+            Res.FirstUse  = static_cast<Uint32>(Rnd()) % NumPasses;
+            Res.LastUse   = std::min(Res.FirstUse + static_cast<Uint32>(Rnd()) % 4, NumPasses - 1);
+        }
+
+        TransientMemoryPlanner Plan;
+        Plan.Plan(Resources.data(), static_cast<Uint32>(Resources.size()));
+        VerifyPlan(Resources, Plan);
+    }
+}
+
+} // namespace